@@ -0,0 +1,93 @@
+#ifndef BASTIONX_BENCH_BENCHHARNESS_H
+#define BASTIONX_BENCH_BENCHHARNESS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bastionx {
+namespace bench {
+
+/**
+ * @brief Minimal benchmark registry (no external dependencies)
+ *
+ * Each benchmark is a plain function registered with BASTIONX_BENCH(name).
+ * bench_main runs every registered benchmark, or only those whose name
+ * contains the substring given as the first command-line argument.
+ */
+using BenchFn = void (*)();
+
+struct BenchCase {
+    const char* name;
+    BenchFn fn;
+};
+
+std::vector<BenchCase>& registry();
+
+struct Registrar {
+    Registrar(const char* name, BenchFn fn) { registry().push_back({name, fn}); }
+};
+
+#define BASTIONX_BENCH(name)                                                  \
+    static void name();                                                       \
+    static ::bastionx::bench::Registrar name##_registrar(#name, &name);       \
+    static void name()
+
+/**
+ * @brief Run fn `iterations` times and return the mean nanoseconds per call
+ */
+template<typename Fn>
+double time_per_op_ns(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+        static_cast<double>(iterations);
+}
+
+/**
+ * @brief Run fn once and return elapsed milliseconds
+ */
+template<typename Fn>
+double time_once_ms(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+/**
+ * @brief Keep a value observable so the optimizer cannot drop the work
+ */
+void do_not_optimize(const void* ptr);
+
+/**
+ * @brief Print one result row: "<bench>  <variant>  <value> <unit>"
+ */
+void report(const std::string& bench, const std::string& variant,
+            double value, const std::string& unit);
+
+/**
+ * @brief Peak resident set size of this process in bytes (0 if unknown)
+ */
+size_t peak_rss_bytes();
+
+/**
+ * @brief Bytes this process has passed to write() so far (0 if unknown)
+ */
+size_t bytes_written();
+
+/**
+ * @brief Create a fresh temporary directory for benchmark vaults
+ */
+std::string make_temp_dir(const std::string& prefix);
+
+}  // namespace bench
+}  // namespace bastionx
+
+#endif  // BASTIONX_BENCH_BENCHHARNESS_H
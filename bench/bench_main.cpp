@@ -0,0 +1,111 @@
+#include "BenchHarness.h"
+#include <sodium.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace bastionx {
+namespace bench {
+
+std::vector<BenchCase>& registry() {
+    static std::vector<BenchCase> cases;
+    return cases;
+}
+
+void do_not_optimize(const void* ptr) {
+    static volatile std::uintptr_t sink = 0;
+    sink = sink ^ reinterpret_cast<std::uintptr_t>(ptr);
+}
+
+void report(const std::string& bench, const std::string& variant,
+            double value, const std::string& unit) {
+    std::printf("%-40s %-24s %14.2f %s\n", bench.c_str(), variant.c_str(), value, unit.c_str());
+    std::fflush(stdout);
+}
+
+size_t peak_rss_bytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return static_cast<size_t>(pmc.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);          // bytes
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;   // kilobytes
+#endif
+#endif
+}
+
+size_t bytes_written() {
+#ifdef _WIN32
+    IO_COUNTERS io{};
+    if (GetProcessIoCounters(GetCurrentProcess(), &io)) {
+        return static_cast<size_t>(io.WriteTransferCount);
+    }
+    return 0;
+#elif defined(__linux__)
+    // "wchar": bytes handed to write()/pwrite(), before the page cache
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    size_t value = 0;
+    while (io >> key >> value) {
+        if (key == "wchar:") {
+            return value;
+        }
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
+
+std::string make_temp_dir(const std::string& prefix) {
+    unsigned char buf[8];
+    randombytes_buf(buf, sizeof(buf));
+    std::string suffix;
+    for (auto b : buf) {
+        char hex[3];
+        std::snprintf(hex, sizeof(hex), "%02x", b);
+        suffix += hex;
+    }
+    auto dir = std::filesystem::temp_directory_path() / (prefix + "_" + suffix);
+    std::filesystem::create_directories(dir);
+    return dir.string();
+}
+
+}  // namespace bench
+}  // namespace bastionx
+
+int main(int argc, char** argv) {
+    if (sodium_init() < 0) {
+        std::cerr << "FATAL: libsodium initialization failed\n";
+        return 1;
+    }
+
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    for (const auto& c : bastionx::bench::registry()) {
+        if (filter != nullptr && std::strstr(c.name, filter) == nullptr) {
+            continue;
+        }
+        std::printf("== %s\n", c.name);
+        c.fn();
+    }
+    return 0;
+}
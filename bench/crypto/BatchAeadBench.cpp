@@ -0,0 +1,67 @@
+#include "BenchHarness.h"
+#include "bastionx/crypto/CryptoService.h"
+#include "bastionx/util/ThreadPool.h"
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+using crypto::CryptoService;
+
+// Per-record encrypt()/decrypt_secure() loops versus encrypt_many()/
+// decrypt_many() on the same records (a scan-sized batch of notes)
+BASTIONX_BENCH(BatchAead) {
+    constexpr size_t kRecords = 256;  // NotesRepository scan batch size
+
+    crypto::SecureKey key(CryptoService::SUBKEY_BYTES);
+    randombytes_buf(key.data(), key.size());
+    const auto algorithm = CryptoService::preferred_algorithm();
+
+    report("Batch AEAD", "pool threads",
+           static_cast<double>(util::ThreadPool::shared().thread_count()), "threads");
+
+    for (size_t record_bytes : {512, 4096, 65536}) {
+        std::vector<std::vector<uint8_t>> plaintexts(kRecords,
+                                                     std::vector<uint8_t>(record_bytes, 0x42));
+        std::vector<std::vector<uint8_t>> aads;
+        for (size_t i = 0; i < kRecords; ++i) {
+            aads.push_back({static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0, 0});
+        }
+        std::vector<std::span<const uint8_t>> views(plaintexts.begin(), plaintexts.end());
+        std::string label = std::to_string(kRecords) + " x " + std::to_string(record_bytes) + "B";
+
+        double loop_enc = time_once_ms([&] {
+            for (size_t i = 0; i < kRecords; ++i) {
+                auto e = CryptoService::encrypt(views[i], key, aads[i], algorithm);
+                do_not_optimize(e.ciphertext.data());
+            }
+        });
+        double batch_enc = time_once_ms([&] {
+            auto b = CryptoService::encrypt_many(views, key, aads, algorithm);
+            do_not_optimize(b.arena.data());
+        });
+        report("Encrypt " + label, "encrypt() loop", loop_enc, "ms");
+        report("Encrypt " + label, "encrypt_many()", batch_enc, "ms");
+
+        auto batch = CryptoService::encrypt_many(views, key, aads, algorithm);
+        std::vector<CryptoService::EncryptedData> records;
+        for (size_t i = 0; i < kRecords; ++i) {
+            auto ct = batch.ciphertext(i);
+            records.push_back({{ct.begin(), ct.end()}, batch.nonces[i], batch.algorithm});
+        }
+
+        double loop_dec = time_once_ms([&] {
+            for (size_t i = 0; i < kRecords; ++i) {
+                auto pt = CryptoService::decrypt_secure(records[i], key, aads[i]);
+                do_not_optimize(pt->data());
+            }
+        });
+        double batch_dec = time_once_ms([&] {
+            auto d = CryptoService::decrypt_many(records, key, aads);
+            do_not_optimize(d.arena.data());
+        });
+        report("Decrypt " + label, "decrypt_secure() loop", loop_dec, "ms");
+        report("Decrypt " + label, "decrypt_many()", batch_dec, "ms");
+    }
+}
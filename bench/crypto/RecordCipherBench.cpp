@@ -0,0 +1,57 @@
+#include "BenchHarness.h"
+#include "bastionx/crypto/CryptoService.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+using crypto::CryptoService;
+
+// Encrypt/decrypt throughput of each record algorithm across note sizes.
+// Both paths include everything a real record pays for: nonce generation and,
+// for AES-256-GCM, the per-record BLAKE2b key derivation.
+BASTIONX_BENCH(RecordCipherThroughput) {
+    crypto::SecureKey key(CryptoService::SUBKEY_BYTES);
+    randombytes_buf(key.data(), key.size());
+    std::vector<uint8_t> aad = {1, 0, 0, 0};
+
+    struct Variant {
+        const char* name;
+        CryptoService::Algorithm algorithm;
+    };
+    std::vector<Variant> variants = {
+        {"XChaCha20-Poly1305", CryptoService::Algorithm::XChaCha20Poly1305},
+    };
+    if (CryptoService::aes256gcm_available()) {
+        variants.push_back({"AES-256-GCM", CryptoService::Algorithm::Aes256Gcm});
+    } else {
+        report("Record cipher", "AES-256-GCM", 0, "(unavailable on this CPU)");
+    }
+
+    for (size_t record_bytes : {256, 4096, 65536, 1024 * 1024}) {
+        std::vector<uint8_t> plaintext(record_bytes, 0x42);
+        size_t iterations = std::max<size_t>(16, (64 * 1024 * 1024) / record_bytes);
+        std::string size_label = std::to_string(record_bytes) + "B";
+
+        for (const auto& v : variants) {
+            double enc_ns = time_per_op_ns(iterations, [&] {
+                auto e = CryptoService::encrypt(plaintext, key, aad, v.algorithm);
+                do_not_optimize(e.ciphertext.data());
+            });
+
+            auto record = CryptoService::encrypt(plaintext, key, aad, v.algorithm);
+            double dec_ns = time_per_op_ns(iterations, [&] {
+                auto pt = CryptoService::decrypt_secure(record, key, aad);
+                do_not_optimize(pt->data());
+            });
+
+            // bytes per ns * 1e9 / 2^20 = MiB/s
+            auto mib_s = [&](double ns) {
+                return static_cast<double>(record_bytes) / ns * 1e9 / (1024.0 * 1024.0);
+            };
+            report("Encrypt " + size_label, v.name, mib_s(enc_ns), "MiB/s");
+            report("Decrypt " + size_label, v.name, mib_s(dec_ns), "MiB/s");
+        }
+    }
+}
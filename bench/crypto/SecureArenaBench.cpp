@@ -0,0 +1,65 @@
+#include "BenchHarness.h"
+#include "bastionx/crypto/CryptoService.h"
+#include "bastionx/crypto/SecureArena.h"
+#include "bastionx/crypto/SecureMemory.h"
+#include <string>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+using crypto::ArenaAllocator;
+using crypto::SecureArena;
+using crypto::SecureBuffer;
+using crypto::SodiumAllocator;
+
+namespace {
+
+template<typename Allocator>
+void alloc_release_single(const std::string& variant, size_t bytes) {
+    constexpr size_t kIterations = 20000;
+    double ns = time_per_op_ns(kIterations, [&] {
+        SecureBuffer<unsigned char, Allocator> buf(bytes);
+        do_not_optimize(buf.data());
+    });
+    report("SecureBuffer alloc+release " + std::to_string(bytes) + "B", variant, ns, "ns/op");
+}
+
+// Mimics change_password: a burst of live subkeys released together
+template<typename Allocator>
+void alloc_release_burst(const std::string& variant) {
+    constexpr size_t kIterations = 2000;
+    constexpr size_t kBurst = 8;
+    double ns = time_per_op_ns(kIterations, [&] {
+        std::vector<SecureBuffer<unsigned char, Allocator>> keys;
+        keys.reserve(kBurst);
+        for (size_t i = 0; i < kBurst; ++i) {
+            keys.emplace_back(crypto::CryptoService::SUBKEY_BYTES);
+        }
+        do_not_optimize(keys.back().data());
+    });
+    report("SecureBuffer burst of 8 x 32B", variant, ns, "ns/op");
+}
+
+}  // namespace
+
+BASTIONX_BENCH(SecureArenaAllocation) {
+    for (size_t bytes : {32, 64, 256, 1024}) {
+        alloc_release_single<SodiumAllocator>("sodium_malloc", bytes);
+        alloc_release_single<ArenaAllocator>("arena", bytes);
+    }
+    alloc_release_burst<SodiumAllocator>("sodium_malloc");
+    alloc_release_burst<ArenaAllocator>("arena");
+
+    // Locked-memory footprint of holding the five vault keys
+    {
+        std::vector<crypto::SecureKey> keys;
+        for (int i = 0; i < 5; ++i) {
+            keys.emplace_back(crypto::CryptoService::KEY_BYTES);
+        }
+        auto stats = SecureArena::instance().stats();
+        report("Locked bytes, 5 live vault keys", "arena region",
+               static_cast<double>(stats.locked_bytes()), "bytes");
+        report("Slab bytes in use, 5 live vault keys", "arena",
+               static_cast<double>(stats.slab_bytes_in_use), "bytes");
+    }
+}
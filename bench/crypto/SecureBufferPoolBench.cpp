@@ -0,0 +1,47 @@
+#include "BenchHarness.h"
+#include "bastionx/crypto/CryptoService.h"
+#include "bastionx/crypto/SecureBufferPool.h"
+#include <string>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+using crypto::CryptoService;
+using crypto::SecureBufferPool;
+
+// Simulates a full-vault scan: decrypt N records of typical note size,
+// once into std::vector (ordinary heap) and once into pooled locked memory
+BASTIONX_BENCH(SecureBufferPoolScan) {
+    constexpr size_t kRecords = 2000;
+
+    crypto::SecureKey key(CryptoService::SUBKEY_BYTES);
+    randombytes_buf(key.data(), key.size());
+    std::vector<uint8_t> aad = {1, 0, 0, 0};
+
+    for (size_t record_bytes : {2048, 8192, 65536}) {
+        std::vector<uint8_t> plaintext(record_bytes, 0x42);
+        std::vector<CryptoService::EncryptedData> records;
+        records.reserve(kRecords);
+        for (size_t i = 0; i < kRecords; ++i) {
+            records.push_back(CryptoService::encrypt(plaintext, key, aad));
+        }
+
+        std::string size_label = std::to_string(record_bytes) + "B";
+
+        double heap_ns = time_per_op_ns(kRecords, [&, i = size_t{0}]() mutable {
+            auto pt = CryptoService::decrypt(records[i++ % kRecords], key, aad);
+            do_not_optimize(pt->data());
+        });
+        report("Scan decrypt " + size_label, "std::vector", heap_ns, "ns/record");
+
+        auto before = SecureBufferPool::instance().stats();
+        double pooled_ns = time_per_op_ns(kRecords, [&, i = size_t{0}]() mutable {
+            auto pt = CryptoService::decrypt_secure(records[i++ % kRecords], key, aad);
+            do_not_optimize(pt->data());
+        });
+        auto after = SecureBufferPool::instance().stats();
+        report("Scan decrypt " + size_label, "SecureBytes (pooled)", pooled_ns, "ns/record");
+        report("Scan decrypt " + size_label, "fresh locked allocs",
+               static_cast<double>(after.fresh_allocs - before.fresh_allocs), "allocs");
+    }
+}
@@ -0,0 +1,83 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/AsyncNotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// How long the calling (GUI) thread is blocked by a list refresh of a
+// 1000-note vault and by an autosave: calling the repository directly
+// against posting to the storage thread, and how long the posted list
+// takes to come back.
+BASTIONX_BENCH(AsyncRepository) {
+    constexpr int kNotes = 1000;
+    constexpr int kRounds = 20;
+
+    std::string dir = make_temp_dir("bastionx_bench_async_repo_");
+    std::string path = (std::filesystem::path(dir) / "vault.db").string();
+    {
+        vault::VaultService vault(path);
+        vault.create("bench_password");
+        const auto* subkey = &vault.notes_subkey();
+        auto& writer = vault.connection_pool().writer();
+
+        storage::Note note;
+        for (int i = 0; i < kNotes; ++i) {
+            note.title = "Note " + std::to_string(i);
+            note.body = std::string(2000, 'b');
+            note.id = writer.create_note(note, *subkey);
+        }
+
+        double direct_list_ms = time_once_ms([&] {
+            for (int r = 0; r < kRounds; ++r) {
+                do_not_optimize(writer.list_notes(*subkey).data());
+            }
+        }) / kRounds;
+        double direct_save_ms = time_once_ms([&] {
+            for (int r = 0; r < kRounds; ++r) {
+                writer.update_note(note, *subkey);
+            }
+        }) / kRounds;
+
+        storage::AsyncNotesRepository async(writer);
+        using Kind = storage::AsyncNotesRepository::Kind;
+
+        double blocked_ms = 0.0;
+        double round_trip_ms = 0.0;
+        for (int r = 0; r < kRounds; ++r) {
+            std::atomic<bool> delivered{false};
+            round_trip_ms += time_once_ms([&] {
+                blocked_ms += time_once_ms([&] {
+                    async.post(Kind::kRead,
+                               [subkey](storage::NotesRepository& repo) { return repo.list_notes(*subkey); },
+                               [&](std::vector<storage::NoteSummary>) { delivered = true; });
+                });
+                while (!delivered) {
+                    std::this_thread::yield();
+                }
+            });
+        }
+
+        double save_blocked_ms = time_once_ms([&] {
+            for (int r = 0; r < kRounds; ++r) {
+                async.post(Kind::kWrite, [note, subkey](storage::NotesRepository& repo) {
+                    repo.update_note(note, *subkey);
+                });
+            }
+        }) / kRounds;
+        async.close();
+
+        report("List 1000 notes", "direct (caller blocked)", direct_list_ms, "ms");
+        report("List 1000 notes", "async (caller blocked)", blocked_ms / kRounds * 1000.0, "us");
+        report("List 1000 notes", "async (until callback)", round_trip_ms / kRounds, "ms");
+        report("Autosave", "direct (caller blocked)", direct_save_ms * 1000.0, "us");
+        report("Autosave", "async (caller blocked)", save_blocked_ms * 1000.0, "us");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
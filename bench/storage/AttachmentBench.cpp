@@ -0,0 +1,85 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/AttachmentStore.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <algorithm>
+#include <filesystem>
+#include <string>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// Attach, attach again (deduplicated) and stream back a 64 MiB file generated
+// on the fly, so the file itself never sits in memory. Peak RSS growth shows
+// whether any step holds the whole file.
+BASTIONX_BENCH(Attachment) {
+    constexpr uint64_t kFileBytes = 64ull * 1024 * 1024;
+    constexpr double kMiB = 1024.0 * 1024.0;
+
+    std::string dir = make_temp_dir("bastionx_bench_attach_");
+    std::string path = (std::filesystem::path(dir) / "vault.db").string();
+
+    {
+        vault::VaultService vault(path);
+        vault.create("bench_password");
+        const auto& subkey = vault.notes_subkey();
+
+        int64_t note_id = 0;
+        {
+            storage::NotesRepository repo(path, &vault.db_subkey());
+            storage::Note note;
+            note.title = "Has a video";
+            note_id = repo.create_note(note, subkey);
+        }
+        storage::AttachmentStore store(path, &vault.db_subkey());
+
+        auto source = [&] {
+            return [remaining = kFileBytes, x = uint32_t{12345}](std::span<uint8_t> buffer) mutable {
+                size_t n = static_cast<size_t>(std::min<uint64_t>(remaining, buffer.size()));
+                for (size_t i = 0; i < n; ++i) {
+                    x = x * 1664525u + 1013904223u;
+                    buffer[i] = static_cast<uint8_t>(x >> 24);
+                }
+                remaining -= n;
+                return n;
+            };
+        };
+
+        size_t baseline = peak_rss_bytes();
+        size_t written_before = bytes_written();
+        int64_t id = 0;
+        double attach_ms = time_once_ms([&] {
+            id = *store.attach(note_id, "video.mp4", "video/mp4", source(), subkey);
+        });
+        size_t after_attach = peak_rss_bytes();
+        report("Attachment 64 MiB", "attach", kFileBytes / kMiB / (attach_ms / 1000.0), "MiB/s");
+        report("Attachment 64 MiB", "attach bytes written",
+               static_cast<double>(bytes_written() - written_before) / kMiB, "MiB");
+        report("Attachment 64 MiB", "attach peak RSS growth",
+               static_cast<double>(after_attach - baseline) / kMiB, "MiB");
+
+        written_before = bytes_written();
+        double dedup_ms = time_once_ms([&] {
+            store.attach(note_id, "copy.mp4", "video/mp4", source(), subkey);
+        });
+        report("Attachment 64 MiB", "duplicate attach", dedup_ms, "ms");
+        report("Attachment 64 MiB", "duplicate stored attachments",
+               static_cast<double>(store.attachment_count()), "count");
+
+        uint64_t streamed = 0;
+        double read_ms = time_once_ms([&] {
+            store.read(id, subkey, [&](std::span<const uint8_t> piece) {
+                do_not_optimize(piece.data());
+                streamed += piece.size();
+            });
+        });
+        size_t after_read = peak_rss_bytes();
+        report("Attachment 64 MiB", "streamed read",
+               streamed / kMiB / (read_ms / 1000.0), "MiB/s");
+        report("Attachment 64 MiB", "streamed read peak RSS growth",
+               static_cast<double>(after_read - after_attach) / kMiB, "MiB");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
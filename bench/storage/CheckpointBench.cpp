@@ -0,0 +1,89 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/CheckpointManager.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/storage/SqliteEngine.h"
+#include "bastionx/vault/VaultService.h"
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// Autosave latency over 3000 saves of 8 KiB notes: SQLite checkpointing on
+// its own every 1000 pages, against a CheckpointManager that runs an idle
+// checkpoint after every 50 saves (a pause in typing) and only leaves the
+// safety net to SQLite. Reports the slowest and 99th-percentile save and the
+// -wal size left behind.
+BASTIONX_BENCH(Checkpoint) {
+    constexpr int kNotes = 200;
+    constexpr int kSaves = 3000;
+    constexpr int kSavesPerPause = 50;
+
+    for (bool managed : {false, true}) {
+        std::string dir = make_temp_dir("bastionx_bench_checkpoint_");
+        std::string path = (std::filesystem::path(dir) / "vault.db").string();
+        std::string label = managed ? "idle checkpoints" : "sqlite auto";
+
+        {
+            vault::VaultService vault(path);
+            vault.create("bench_password");
+            const auto& subkey = vault.notes_subkey();
+
+            auto owned = std::make_unique<storage::SqliteEngine>(
+                path, &vault.db_subkey(), vault.connection_profile());
+            auto* engine = owned.get();
+            storage::NotesRepository repo(std::move(owned));
+            std::unique_ptr<storage::CheckpointManager> checkpoints;
+            if (managed) {
+                checkpoints = std::make_unique<storage::CheckpointManager>(*engine);
+            }
+
+            std::mt19937 rng(3);
+            std::vector<storage::Note> notes(kNotes);
+            for (auto& note : notes) {
+                note.title = "Draft";
+                for (int i = 0; i < 8192; ++i) {
+                    note.body += static_cast<char>('a' + rng() % 26);
+                }
+                note.id = repo.create_note(note, subkey);
+            }
+            if (checkpoints) {
+                checkpoints->checkpoint(storage::CheckpointManager::Mode::kTruncate);
+            } else {
+                engine->checkpoint(storage::SqliteEngine::CheckpointMode::kTruncate);
+            }
+
+            std::vector<double> save_us;
+            save_us.reserve(kSaves);
+            for (int i = 0; i < kSaves; ++i) {
+                auto& note = notes[rng() % kNotes];
+                note.body[rng() % note.body.size()] = 'x';
+                save_us.push_back(time_once_ms([&] { repo.update_note(note, subkey); }) * 1000.0);
+                if (checkpoints && (i + 1) % kSavesPerPause == 0) {
+                    checkpoints->run_idle();
+                }
+            }
+            std::sort(save_us.begin(), save_us.end());
+
+            std::error_code ec;
+            auto wal = std::filesystem::file_size(path + "-wal", ec);
+
+            report("Autosave 3000 x 8 KiB", label + " save p99", save_us[kSaves * 99 / 100], "us");
+            report("Autosave 3000 x 8 KiB", label + " save max", save_us.back(), "us");
+            report("Autosave 3000 x 8 KiB", label + " wal size",
+                   ec ? 0.0 : static_cast<double>(wal) / 1024.0, "KiB");
+            if (checkpoints) {
+                const auto& stats = checkpoints->stats();
+                report("Autosave 3000 x 8 KiB", label + " longest checkpoint",
+                       static_cast<double>(stats.longest.count()), "us");
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+}
@@ -0,0 +1,80 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// A vault of 2000 short notes, first stored hot (one encrypted row each),
+// then all moved into cold-storage packs. Reports encrypted bytes stored,
+// the time to list the vault, and the time to open one packed note with
+// the pack cache cold and warm.
+BASTIONX_BENCH(ColdPack) {
+    constexpr int kNotes = 2000;
+
+    std::string dir = make_temp_dir("bastionx_bench_coldpack_");
+    std::string path = (std::filesystem::path(dir) / "vault.db").string();
+
+    {
+        vault::VaultService vault(path);
+        vault.create("bench_password");
+        const auto& subkey = vault.notes_subkey();
+
+        std::vector<int64_t> ids;
+        {
+            storage::NotesRepository repo(path, &vault.db_subkey());
+            std::mt19937 rng(11);
+            for (int i = 0; i < kNotes; ++i) {
+                storage::Note note;
+                note.title = "Meeting " + std::to_string(i);
+                note.body = "## Notes\n- follow up with team " + std::to_string(rng() % 40) +
+                            "\n- budget item " + std::to_string(rng() % 1000) +
+                            "\n- review on day " + std::to_string(rng() % 365) + "\n";
+                note.tags = {"work"};
+                ids.push_back(repo.create_note(note, subkey));
+            }
+        }
+
+        auto measure = [&](const char* label) {
+            storage::NotesRepository repo(path, &vault.db_subkey());
+            auto stats = repo.storage_stats();
+            report("Cold pack 2000 notes", std::string(label) + " stored",
+                   static_cast<double>(stats.record_bytes + stats.pack_bytes) / 1024.0, "KiB");
+            report("Cold pack 2000 notes", std::string(label) + " list",
+                   time_once_ms([&] {
+                       auto summaries = repo.list_notes(subkey);
+                       do_not_optimize(summaries.data());
+                   }), "ms");
+
+            // One note from the middle: the first read fills the pack cache
+            storage::NotesRepository fresh(path, &vault.db_subkey());
+            int64_t id = ids[kNotes / 2];
+            report("Cold pack 2000 notes", std::string(label) + " first read",
+                   time_once_ms([&] {
+                       auto note = fresh.read_note(id, subkey);
+                       do_not_optimize(&note);
+                   }), "ms");
+            report("Cold pack 2000 notes", std::string(label) + " next read",
+                   time_per_op_ns(200, [&] {
+                       auto note = fresh.read_note(id + 1, subkey);
+                       do_not_optimize(&note);
+                   }) / 1000.0, "us");
+        };
+
+        measure("hot");
+        {
+            // Negative age: every note counts as cold
+            storage::NotesRepository repo(path, &vault.db_subkey());
+            repo.pack_cold_notes(subkey, std::chrono::seconds(-60));
+        }
+        measure("packed");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
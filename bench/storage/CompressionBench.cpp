@@ -0,0 +1,107 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+namespace {
+
+constexpr size_t kNotes = 10000;
+
+// Markdown-ish notes of 100-1500 bytes from a small vocabulary, roughly the
+// shape of a personal vault (short notes dominate)
+storage::Note make_note(std::mt19937& rng, size_t i) {
+    static const std::vector<std::string> words = {
+        "meeting", "project", "review", "the", "and", "follow", "up", "with",
+        "deadline", "budget", "idea", "draft", "todo", "call", "email", "notes",
+        "client", "design", "release", "bug", "fix", "plan", "weekly", "status"};
+    static const std::vector<std::string> tags = {"work", "personal", "ideas", "journal", "todo"};
+
+    std::uniform_int_distribution<size_t> word(0, words.size() - 1);
+    std::uniform_int_distribution<size_t> length(100, 1500);
+
+    storage::Note note;
+    note.title = "Note " + std::to_string(i) + ": " + words[word(rng)] + " " + words[word(rng)];
+
+    std::string body = "## " + words[word(rng)] + "\n\n";
+    size_t target = length(rng);
+    while (body.size() < target) {
+        body += (rng() % 8 == 0) ? "\n- [ ] " : " ";
+        body += words[word(rng)];
+    }
+    note.body = body;
+    note.tags = {tags[i % tags.size()]};
+    return note;
+}
+
+double best_of_3_ms(const std::function<void()>& fn) {
+    double best = time_once_ms(fn);
+    for (int i = 0; i < 2; ++i) {
+        best = std::min(best, time_once_ms(fn));
+    }
+    return best;
+}
+
+}  // namespace
+
+// Stored size and list/search scan time for 10k notes: uncompressed records,
+// plain zstd, and zstd with a dictionary trained from the vault
+BASTIONX_BENCH(Compression) {
+    enum class Mode { kNone, kZstd, kZstdDictionary };
+    const std::pair<Mode, const char*> modes[] = {
+        {Mode::kNone, "uncompressed"},
+        {Mode::kZstd, "zstd"},
+        {Mode::kZstdDictionary, "zstd + dictionary"}};
+
+    double uncompressed_bytes = 0;
+    for (const auto& [mode, label] : modes) {
+        std::string dir = make_temp_dir("bastionx_bench_compress_");
+        std::string path = (std::filesystem::path(dir) / "vault.db").string();
+        {
+            vault::VaultService vault(path);
+            vault.create("bench_password");
+            storage::NotesRepository repo(path, &vault.db_subkey());
+            repo.set_compression_enabled(mode != Mode::kNone);
+
+            std::mt19937 rng(42);
+            for (size_t i = 0; i < kNotes; ++i) {
+                repo.create_note(make_note(rng, i), vault.notes_subkey());
+            }
+            if (mode == Mode::kZstdDictionary) {
+                double train_ms = time_once_ms([&] {
+                    repo.train_compression_dictionary(vault.notes_subkey());
+                });
+                report("Compression 10k notes", "train + recompress", train_ms, "ms");
+            }
+
+            double bytes = static_cast<double>(repo.storage_stats().record_bytes);
+            if (mode == Mode::kNone) {
+                uncompressed_bytes = bytes;
+            }
+            report("Compression 10k notes", std::string(label) + " stored", bytes / 1024.0, "KiB");
+            report("Compression 10k notes", std::string(label) + " ratio",
+                   uncompressed_bytes / bytes, "x");
+
+            double list_ms = best_of_3_ms([&] {
+                auto summaries = repo.list_notes(vault.notes_subkey());
+                do_not_optimize(summaries.data());
+            });
+            report("Compression 10k notes", std::string(label) + " list_notes", list_ms, "ms");
+
+            double search_ms = best_of_3_ms([&] {
+                auto hits = repo.search_notes(vault.notes_subkey(), "deadline budget");
+                do_not_optimize(hits.data());
+            });
+            report("Compression 10k notes", std::string(label) + " search_notes", search_ms, "ms");
+        }
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+}
@@ -0,0 +1,76 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/ConnectionProfile.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// Open, list, search and save latency on a 2000-note vault created with each
+// connection profile preset. Open includes SQLCipher's key derivation
+// (kdf_iter rounds), which every new connection pays.
+BASTIONX_BENCH(ConnectionProfile) {
+    constexpr int kNotes = 2000;
+    constexpr int kSaves = 200;
+
+    const std::pair<const char*, storage::ConnectionProfile> presets[] = {
+        {"paranoid", storage::ConnectionProfile::paranoid()},
+        {"balanced", storage::ConnectionProfile::balanced()},
+        {"throughput", storage::ConnectionProfile::throughput()},
+    };
+
+    for (const auto& [name, preset] : presets) {
+        std::string dir = make_temp_dir("bastionx_bench_profile_");
+        std::string path = (std::filesystem::path(dir) / "vault.db").string();
+        std::string label(name);
+
+        {
+            vault::VaultService vault(path, preset);
+            vault.create("bench_password");
+            const auto& subkey = vault.notes_subkey();
+            const auto& profile = vault.connection_profile();
+
+            std::vector<storage::Note> notes(kNotes);
+            {
+                storage::NotesRepository repo(path, &vault.db_subkey(), profile);
+                std::mt19937 rng(5);
+                for (int i = 0; i < kNotes; ++i) {
+                    notes[i].title = "Meeting notes " + std::to_string(i);
+                    for (int line = 0; line < 20; ++line) {
+                        notes[i].body += "item " + std::to_string(rng() % 100000) + " follow up\n";
+                    }
+                    notes[i].tags = {"work"};
+                    notes[i].id = repo.create_note(notes[i], subkey);
+                }
+            }
+
+            std::unique_ptr<storage::NotesRepository> repo;
+            double open_ms = time_once_ms([&] {
+                repo = std::make_unique<storage::NotesRepository>(path, &vault.db_subkey(), profile);
+                repo->list_notes(subkey);
+            });
+            double list_ms = time_once_ms([&] { repo->list_notes(subkey); });
+            double search_ms = time_once_ms([&] { repo->search_notes(subkey, "item 4242"); });
+
+            std::mt19937 rng(9);
+            double save_ns = time_per_op_ns(kSaves, [&] {
+                auto& note = notes[rng() % kNotes];
+                note.body += "x";
+                repo->update_note(note, subkey);
+            });
+
+            report("Profile 2000 notes", label + " open + first list", open_ms, "ms");
+            report("Profile 2000 notes", label + " list", list_ms, "ms");
+            report("Profile 2000 notes", label + " search", search_ms, "ms");
+            report("Profile 2000 notes", label + " save", save_ns / 1000.0, "us");
+        }
+
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+}
@@ -0,0 +1,84 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/ConnectionProfile.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// Saving 20 open tabs (as on lock or close-all): one update_note() commit
+// per note, against queue_update() for each and one flush_writes(). With
+// `paranoid` (synchronous=FULL) every commit is an fsync; with `balanced`
+// (NORMAL, in WAL) commits only append to the WAL.
+BASTIONX_BENCH(GroupCommit) {
+    constexpr int kTabs = 20;
+    constexpr int kRounds = 20;
+
+    const std::pair<const char*, storage::ConnectionProfile> presets[] = {
+        {"balanced", storage::ConnectionProfile::balanced()},
+        {"paranoid", storage::ConnectionProfile::paranoid()},
+    };
+
+    for (const auto& [name, preset] : presets) {
+        std::string dir = make_temp_dir("bastionx_bench_group_commit_");
+        std::string path = (std::filesystem::path(dir) / "vault.db").string();
+        std::string label(name);
+
+        {
+            vault::VaultService vault(path, preset);
+            vault.create("bench_password");
+            const auto& subkey = vault.notes_subkey();
+            storage::NotesRepository repo(path, &vault.db_subkey(), vault.connection_profile());
+            repo.set_revision_policy({false});
+
+            std::vector<storage::Note> notes(kTabs);
+            for (int i = 0; i < kTabs; ++i) {
+                notes[i].title = "Tab " + std::to_string(i);
+                notes[i].body = std::string(2000, 'n');
+                notes[i].id = repo.create_note(notes[i], subkey);
+            }
+
+            int round = 0;
+            auto edit = [&](storage::Note& note) {
+                note.body[round % note.body.size()] = static_cast<char>('a' + round % 26);
+            };
+
+            size_t written_before = bytes_written();
+            double each_ms = time_once_ms([&] {
+                for (round = 0; round < kRounds; ++round) {
+                    for (auto& note : notes) {
+                        edit(note);
+                        repo.update_note(note, subkey);
+                    }
+                }
+            }) / kRounds;
+            size_t each_bytes = (bytes_written() - written_before) / kRounds;
+
+            written_before = bytes_written();
+            double grouped_ms = time_once_ms([&] {
+                for (round = 0; round < kRounds; ++round) {
+                    for (auto& note : notes) {
+                        edit(note);
+                        repo.queue_update(note, subkey);
+                    }
+                    repo.flush_writes();
+                }
+            }) / kRounds;
+            size_t grouped_bytes = (bytes_written() - written_before) / kRounds;
+
+            report("Save 20 tabs", label + " commit each", each_ms, "ms");
+            report("Save 20 tabs", label + " group commit", grouped_ms, "ms");
+            report("Save 20 tabs", label + " commit each written",
+                   static_cast<double>(each_bytes) / 1024.0, "KiB");
+            report("Save 20 tabs", label + " group commit written",
+                   static_cast<double>(grouped_bytes) / 1024.0, "KiB");
+        }
+
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+}
@@ -0,0 +1,62 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <filesystem>
+#include <string>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// Save and load of a 50 MiB note through the chunked body path.
+// Peak RSS is a process-wide high-water mark, so growth is reported relative
+// to the peak reached after the source body itself was built.
+BASTIONX_BENCH(LargeNote) {
+    constexpr size_t kBodyBytes = 50 * 1024 * 1024;
+    constexpr double kMiB = 1024.0 * 1024.0;
+
+    std::string dir = make_temp_dir("bastionx_bench_large_");
+    std::string path = (std::filesystem::path(dir) / "vault.db").string();
+
+    {
+        vault::VaultService vault(path);
+        vault.create("bench_password");
+        storage::NotesRepository repo(path, &vault.db_subkey());
+
+        storage::Note note;
+        note.title = "Large note";
+        note.body.resize(kBodyBytes, 'x');
+        size_t baseline = peak_rss_bytes();
+
+        int64_t id = 0;
+        double save_ms = time_once_ms([&] { id = repo.create_note(note, vault.notes_subkey()); });
+        size_t after_save = peak_rss_bytes();
+        note = storage::Note();
+
+        report("Large note 50 MiB", "save", save_ms, "ms");
+        report("Large note 50 MiB", "save peak RSS growth",
+               static_cast<double>(after_save - baseline) / kMiB, "MiB");
+
+        size_t streamed = 0;
+        double stream_ms = time_once_ms([&] {
+            repo.read_note_streamed(id, vault.notes_subkey(), [&](std::string_view piece) {
+                streamed += piece.size();
+            });
+        });
+        size_t after_stream = peak_rss_bytes();
+        report("Large note 50 MiB", "streamed load", stream_ms, "ms");
+        report("Large note 50 MiB", "streamed load peak RSS growth",
+               static_cast<double>(after_stream - after_save) / kMiB, "MiB");
+
+        double load_ms = time_once_ms([&] {
+            auto read = repo.read_note(id, vault.notes_subkey());
+            do_not_optimize(read->body.data());
+        });
+        size_t after_load = peak_rss_bytes();
+        report("Large note 50 MiB", "full load (one body copy)", load_ms, "ms");
+        report("Large note 50 MiB", "full load peak RSS growth",
+               static_cast<double>(after_load - after_stream) / kMiB, "MiB");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
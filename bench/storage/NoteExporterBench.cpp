@@ -0,0 +1,61 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/NoteExporter.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <filesystem>
+#include <string>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// Incremental export of the same 20 edited notes from a small and a large
+// vault. The time should track the change set, not the number of notes;
+// the full first export is reported for comparison.
+BASTIONX_BENCH(NoteExporter) {
+    constexpr int kChanged = 20;
+
+    for (int vault_notes : {500, 5000}) {
+        std::string dir = make_temp_dir("bastionx_bench_export_");
+        std::string path = (std::filesystem::path(dir) / "vault.db").string();
+        std::string exports = (std::filesystem::path(dir) / "exports").string();
+        std::string label = std::to_string(vault_notes) + " notes";
+
+        {
+            vault::VaultService vault(path);
+            vault.create("bench_password");
+            const auto& subkey = vault.notes_subkey();
+            auto export_key = vault.export_key();
+            storage::NotesRepository repo(path, &vault.db_subkey());
+
+            std::vector<int64_t> ids;
+            for (int i = 0; i < vault_notes; ++i) {
+                storage::Note note;
+                note.title = "Note " + std::to_string(i);
+                note.body = std::string(1500, static_cast<char>('a' + i % 26));
+                ids.push_back(repo.create_note(note, subkey));
+            }
+
+            storage::NoteExporter exporter(repo, exports);
+            double full_ms = time_once_ms([&] { exporter.export_changes(subkey, export_key); });
+
+            for (int i = 0; i < kChanged; ++i) {
+                auto note = repo.read_note(ids[(i * 97) % ids.size()], subkey);
+                note->body += " edited";
+                repo.update_note(*note, subkey);
+            }
+            storage::NoteExporter::Result result;
+            double delta_ms = time_once_ms([&] {
+                result = exporter.export_changes(subkey, export_key);
+            });
+
+            report("Export", label + ": full", full_ms, "ms");
+            report("Export", label + ": 20 changed", delta_ms, "ms");
+            report("Export", label + ": 20 changed archive",
+                   static_cast<double>(std::filesystem::file_size(result.archive)) / 1024.0,
+                   "KiB");
+        }
+
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+}
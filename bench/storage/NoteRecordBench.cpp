@@ -0,0 +1,63 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/NoteRecord.h"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// Serialize/parse cost of one note: the version-1 JSON payload against the
+// binary NoteRecord, plus the header-only decode used by list views
+BASTIONX_BENCH(NoteRecord) {
+    constexpr size_t kIterations = 20000;
+    const std::string title = "Weekly review: release planning";
+    const std::vector<std::string> tags = {"work", "planning", "todo"};
+
+    for (size_t body_bytes : {size_t{256}, size_t{4096}, size_t{65536}}) {
+        std::string body;
+        while (body.size() < body_bytes) {
+            body += "- [ ] follow up with the \"client\" on the design draft\n";
+        }
+        body.resize(body_bytes);
+        const std::string size = std::to_string(body_bytes) + "B ";
+
+        nlohmann::json j;
+        j["title"] = title;
+        j["body"] = body;
+        j["tags"] = tags;
+        j["version"] = 1;
+        const std::string json = j.dump();
+        const auto record = storage::NoteRecord::encode(title, tags, body);
+
+        report("NoteRecord", size + "json encode", time_per_op_ns(kIterations, [&] {
+            nlohmann::json out;
+            out["title"] = title;
+            out["body"] = body;
+            out["tags"] = tags;
+            out["version"] = 1;
+            auto s = out.dump();
+            do_not_optimize(s.data());
+        }), "ns");
+        report("NoteRecord", size + "binary encode", time_per_op_ns(kIterations, [&] {
+            auto r = storage::NoteRecord::encode(title, tags, body);
+            do_not_optimize(r.data());
+        }), "ns");
+
+        report("NoteRecord", size + "json decode", time_per_op_ns(kIterations, [&] {
+            auto parsed = nlohmann::json::parse(json);
+            do_not_optimize(&parsed);
+        }), "ns");
+        report("NoteRecord", size + "binary decode", time_per_op_ns(kIterations, [&] {
+            auto view = storage::NoteRecord::decode(record);
+            do_not_optimize(&view);
+        }), "ns");
+        report("NoteRecord", size + "binary header-only", time_per_op_ns(kIterations, [&] {
+            auto view = storage::NoteRecord::decode(record, true);
+            do_not_optimize(&view);
+        }), "ns");
+
+        report("NoteRecord", size + "json bytes", static_cast<double>(json.size()), "B");
+        report("NoteRecord", size + "binary bytes", static_cast<double>(record.size()), "B");
+    }
+}
@@ -0,0 +1,91 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/AsyncNotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// Opening one of the 8 most recent notes of a 1000-note vault (16 KiB
+// bodies) right after unlock: cold, and once prefetch has warmed the note
+// cache. Then how long a foreground read waits when a full queue of
+// prefetches is waiting ahead of it.
+BASTIONX_BENCH(Prefetch) {
+    constexpr int kNotes = 1000;
+    constexpr size_t kRecent = 8;
+    constexpr int kRounds = 50;
+
+    std::string dir = make_temp_dir("bastionx_bench_prefetch_");
+    std::string path = (std::filesystem::path(dir) / "vault.db").string();
+    {
+        vault::VaultService vault(path);
+        vault.create("bench_password");
+        const auto* subkey = &vault.notes_subkey();
+        auto& writer = vault.connection_pool().writer();
+
+        std::vector<int64_t> ids;
+        storage::Note note;
+        for (int i = 0; i < kNotes; ++i) {
+            note.title = crypto::SecureString("Note " + std::to_string(i));
+            note.body = crypto::SecureString(std::string(16 * 1024, static_cast<char>('a' + i % 26)));
+            ids.push_back(writer.create_note(note, *subkey));
+        }
+        std::vector<int64_t> recent(ids.end() - kRecent, ids.end());
+
+        storage::AsyncNotesRepository async(writer);
+        using Kind = storage::AsyncNotesRepository::Kind;
+        auto open = [&](int64_t id) {
+            return async.submit(Kind::kRead, [id, subkey](storage::NotesRepository& repo) {
+                return repo.read_note(id, *subkey).has_value();
+            }).get();
+        };
+
+        double cold_ms = 0.0;
+        double warm_ms = 0.0;
+        for (int r = 0; r < kRounds; ++r) {
+            writer.clear_note_cache();
+            cold_ms += time_once_ms([&] { open(recent[r % kRecent]); });
+
+            writer.clear_note_cache();
+            for (int64_t id : recent) {
+                async.post(Kind::kPrefetch, [id, subkey](storage::NotesRepository& repo) {
+                    repo.prefetch_note(id, *subkey);
+                });
+            }
+            async.drain();
+            warm_ms += time_once_ms([&] { open(recent[r % kRecent]); });
+        }
+
+        // Foreground read with prefetches of uncached notes waiting
+        double idle_read_ms = 0.0;
+        double busy_read_ms = 0.0;
+        for (int r = 0; r < kRounds; ++r) {
+            int64_t id = ids[static_cast<size_t>(r)];
+            writer.clear_note_cache();
+            idle_read_ms += time_once_ms([&] { open(id); });
+
+            writer.clear_note_cache();
+            for (size_t p = 0; p < storage::AsyncNotesRepository::kMaxQueuedPrefetches; ++p) {
+                int64_t other = ids[kNotes / 2 + (r * 16 + p) % (kNotes / 2)];
+                async.post(Kind::kPrefetch, [other, subkey](storage::NotesRepository& repo) {
+                    repo.prefetch_note(other, *subkey);
+                });
+            }
+            busy_read_ms += time_once_ms([&] { open(id); });
+            async.cancel_prefetches();
+            async.drain();
+        }
+        async.close();
+
+        report("Open recent note", "cold", cold_ms / kRounds * 1000.0, "us");
+        report("Open recent note", "after warm prefetch", warm_ms / kRounds * 1000.0, "us");
+        report("Foreground read", "idle storage thread", idle_read_ms / kRounds * 1000.0, "us");
+        report("Foreground read", "16 prefetches queued", busy_read_ms / kRounds * 1000.0, "us");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
@@ -0,0 +1,81 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <sqlcipher/sqlite3.h>
+#include <filesystem>
+#include <random>
+#include <string>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// A 20 KiB note edited 100 times (a few words each, spread out so no save is
+// coalesced), all kept by the default policy. Reports history stored against keeping every version whole,
+// and the time to rebuild the newest and the worst-placed revision.
+BASTIONX_BENCH(Revision) {
+    constexpr int kEdits = 100;
+    constexpr double kKiB = 1024.0;
+
+    std::string dir = make_temp_dir("bastionx_bench_revision_");
+    std::string path = (std::filesystem::path(dir) / "vault.db").string();
+
+    {
+        vault::VaultService vault(path);
+        vault.create("bench_password");
+        const auto& subkey = vault.notes_subkey();
+        storage::NotesRepository repo(path, &vault.db_subkey());
+
+        // Backdate revisions between saves, as if edits were hours apart
+        sqlite3* db = nullptr;
+        sqlite3_open(path.c_str(), &db);
+        sqlite3_key(db, vault.db_subkey().data(), static_cast<int>(vault.db_subkey().size()));
+
+        std::mt19937 rng(5);
+        std::string body;
+        while (body.size() < 20 * 1024) {
+            body += "Item " + std::to_string(rng() % 1000) + ": details to follow up on. ";
+            if (rng() % 8 == 0) {
+                body += "\n\n";
+            }
+        }
+        storage::Note note;
+        note.title = "Project log";
+        note.body = body;
+        note.id = repo.create_note(note, subkey);
+
+        uint64_t full_copies = 0;
+        for (int i = 0; i < kEdits; ++i) {
+            full_copies += repo.storage_stats().record_bytes;
+            sqlite3_exec(db, "UPDATE note_revisions SET recorded_at = recorded_at - 3600;",
+                         nullptr, nullptr, nullptr);
+            body.insert(rng() % body.size(), " edit " + std::to_string(i) + " ");
+            note.body = body;
+            repo.update_note(note, subkey);
+        }
+        sqlite3_close(db);
+
+        auto stats = repo.storage_stats();
+        report("Revisions 20 KiB x 100", "history stored",
+               static_cast<double>(stats.revision_bytes) / kKiB, "KiB");
+        report("Revisions 20 KiB x 100", "as full copies",
+               static_cast<double>(full_copies) / kKiB, "KiB");
+
+        // Revision 2 is followed by 15 deltas before the keyframe at 17
+        auto revisions = repo.list_revisions(note.id);
+        int64_t newest = revisions.front().revision_id;
+        int64_t worst = revisions.back().revision_id + 1;
+        report("Revisions 20 KiB x 100", "rebuild newest",
+               time_per_op_ns(100, [&] {
+                   auto version = repo.read_revision(note.id, newest, subkey);
+                   do_not_optimize(&version);
+               }) / 1000.0, "us");
+        report("Revisions 20 KiB x 100", "rebuild longest chain",
+               time_per_op_ns(100, [&] {
+                   auto version = repo.read_revision(note.id, worst, subkey);
+                   do_not_optimize(&version);
+               }) / 1000.0, "us");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
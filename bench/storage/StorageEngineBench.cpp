@@ -0,0 +1,68 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/MemoryEngine.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/storage/SqliteEngine.h"
+#include "bastionx/vault/VaultService.h"
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// The same repository workload on the SQLCipher vault and on the in-memory
+// engine: the gap is what the database costs, the memory figures are
+// crypto and serialization alone
+BASTIONX_BENCH(StorageEngine) {
+    constexpr int kNotes = 2000;
+
+    std::string dir = make_temp_dir("bastionx_bench_engine_");
+    std::string path = (std::filesystem::path(dir) / "vault.db").string();
+
+    {
+        vault::VaultService vault(path);
+        vault.create("bench_password");
+        const auto& subkey = vault.notes_subkey();
+
+        auto run = [&](const char* label, std::unique_ptr<storage::StorageEngine> engine) {
+            storage::NotesRepository repo(std::move(engine));
+            std::mt19937 rng(5);
+            std::vector<int64_t> ids;
+
+            report("Storage engine 2000 notes", std::string(label) + " create",
+                   time_once_ms([&] {
+                       for (int i = 0; i < kNotes; ++i) {
+                           storage::Note note;
+                           note.title = "Entry " + std::to_string(i);
+                           note.body = "## Log\n- item " + std::to_string(rng() % 1000) +
+                                       "\n- owner " + std::to_string(rng() % 40) + "\n";
+                           note.tags = {"log"};
+                           ids.push_back(repo.create_note(note, subkey));
+                       }
+                   }), "ms");
+            report("Storage engine 2000 notes", std::string(label) + " list",
+                   time_once_ms([&] {
+                       auto summaries = repo.list_notes(subkey);
+                       do_not_optimize(summaries.data());
+                   }), "ms");
+            report("Storage engine 2000 notes", std::string(label) + " read",
+                   time_per_op_ns(kNotes, [&] {
+                       auto note = repo.read_note(ids[rng() % ids.size()], subkey);
+                       do_not_optimize(&note);
+                   }) / 1000.0, "us");
+            report("Storage engine 2000 notes", std::string(label) + " update",
+                   time_per_op_ns(500, [&] {
+                       auto note = repo.read_note(ids[rng() % ids.size()], subkey);
+                       note->body.append("edit\n");
+                       repo.update_note(*note, subkey);
+                   }) / 1000.0, "us");
+        };
+
+        run("sqlite", std::make_unique<storage::SqliteEngine>(path, &vault.db_subkey()));
+        run("memory", std::make_unique<storage::MemoryEngine>());
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
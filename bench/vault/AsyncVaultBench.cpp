@@ -0,0 +1,131 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/AsyncNotesRepository.h"
+#include "bastionx/vault/AsyncVault.h"
+#include "bastionx/vault/VaultService.h"
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+namespace {
+
+// Stands in for the Qt event loop: resumptions queue here and the bench
+// thread runs them
+class Loop {
+public:
+    util::Dispatcher dispatcher() {
+        return [this](std::function<void()> callback) {
+            std::lock_guard lock(mutex_);
+            queued_.push_back(std::move(callback));
+        };
+    }
+
+    void run_until(const std::atomic<bool>& done) {
+        while (!done) {
+            std::vector<std::function<void()>> callbacks;
+            {
+                std::lock_guard lock(mutex_);
+                callbacks.swap(queued_);
+            }
+            for (auto& callback : callbacks) {
+                callback();
+            }
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::function<void()>> queued_;
+};
+
+}  // namespace
+
+// How long the calling (GUI) thread is blocked by an unlock: calling
+// VaultService directly against co_await on AsyncVault. Then the cost of a
+// co_await round trip to the storage thread against post() with a
+// callback.
+BASTIONX_BENCH(AsyncVault) {
+    constexpr int kUnlocks = 3;
+    constexpr int kRounds = 200;
+
+    std::string dir = make_temp_dir("bastionx_bench_async_vault_");
+    std::string path = (std::filesystem::path(dir) / "vault.db").string();
+    {
+        vault::VaultService vault(path);
+        vault.create("bench_password");
+        vault.lock();
+
+        double direct_ms = 0.0;
+        for (int i = 0; i < kUnlocks; ++i) {
+            direct_ms += time_once_ms([&] { vault.unlock("bench_password"); });
+            vault.lock();
+        }
+
+        Loop loop;
+        vault::AsyncVault async(vault, loop.dispatcher());
+        double blocked_ms = 0.0;
+        double until_resumed_ms = 0.0;
+        for (int i = 0; i < kUnlocks; ++i) {
+            std::atomic<bool> done{false};
+            auto flow = [&]() -> util::Task {
+                co_await async.unlock("bench_password");
+                done = true;
+            };
+            until_resumed_ms += time_once_ms([&] {
+                blocked_ms += time_once_ms([&] { flow(); });
+                loop.run_until(done);
+            });
+            vault.lock();
+        }
+
+        vault.unlock("bench_password");
+        const auto* subkey = &vault.notes_subkey();
+        storage::AsyncNotesRepository storage(vault.connection_pool().writer(), loop.dispatcher());
+        using Kind = storage::AsyncNotesRepository::Kind;
+        auto count = [subkey](storage::NotesRepository& repo) {
+            return repo.list_notes(*subkey).size();
+        };
+
+        std::atomic<bool> posted_done{false};
+        double posted_ms = time_once_ms([&] {
+            std::function<void(int)> next = [&](int left) {
+                if (left == 0) {
+                    posted_done = true;
+                    return;
+                }
+                storage.post(Kind::kRead, count, [&, left](size_t) { next(left - 1); });
+            };
+            next(kRounds);
+            loop.run_until(posted_done);
+        }) / kRounds;
+
+        std::atomic<bool> awaited_done{false};
+        auto awaited = [&]() -> util::Task {
+            for (int r = 0; r < kRounds; ++r) {
+                co_await storage.run(Kind::kRead, count);
+            }
+            awaited_done = true;
+        };
+        double awaited_ms = time_once_ms([&] {
+            awaited();
+            loop.run_until(awaited_done);
+        }) / kRounds;
+        storage.close();
+
+        report("Unlock", "direct (caller blocked)", direct_ms / kUnlocks, "ms");
+        report("Unlock", "co_await (caller blocked)", blocked_ms / kUnlocks * 1000.0, "us");
+        report("Unlock", "co_await (until resumed)", until_resumed_ms / kUnlocks, "ms");
+        report("Storage round trip", "post + callback", posted_ms * 1000.0, "us");
+        report("Storage round trip", "co_await run()", awaited_ms * 1000.0, "us");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
@@ -0,0 +1,78 @@
+#include "BenchHarness.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/storage/SqliteEngine.h"
+#include "bastionx/vault/MaintenanceScheduler.h"
+#include "bastionx/vault/VaultService.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::bench;
+
+// Default maintenance tasks on a 2000-note vault after its older half was
+// deleted: total time, the longest slice (how long input can wait behind
+// maintenance), and the checkpointed file size before and after.
+BASTIONX_BENCH(Maintenance) {
+    constexpr int kNotes = 2000;
+
+    std::string dir = make_temp_dir("bastionx_bench_maintenance_");
+    std::string path = (std::filesystem::path(dir) / "vault.db").string();
+    {
+        vault::VaultService vault(path);
+        vault.create("bench_password");
+        const auto& subkey = vault.notes_subkey();
+
+        {
+            storage::NotesRepository repo(path, &vault.db_subkey(), vault.connection_profile());
+            std::mt19937 rng(11);
+            std::vector<int64_t> ids;
+            for (int i = 0; i < kNotes; ++i) {
+                storage::Note note;
+                note.title = "Note " + std::to_string(i);
+                for (int line = 0; line < 40; ++line) {
+                    note.body += "entry " + std::to_string(rng() % 100000) + " to review\n";
+                }
+                ids.push_back(repo.create_note(note, subkey));
+            }
+            for (int i = 0; i < kNotes / 2; ++i) {
+                repo.delete_note(ids[i], subkey);
+            }
+        }
+
+        // Size of the database file once the WAL is checkpointed into it
+        storage::SqliteEngine engine(path, &vault.db_subkey(), vault.connection_profile());
+        auto file_kib = [&] {
+            engine.checkpoint(storage::SqliteEngine::CheckpointMode::kTruncate);
+            return static_cast<double>(std::filesystem::file_size(path)) / 1024.0;
+        };
+        double before_kib = file_kib();
+
+        vault::MaintenanceScheduler scheduler(vault);
+        int slices = 0;
+        double longest_ms = 0.0;
+        double total_ms = time_once_ms([&] {
+            bool more = true;
+            while (more) {
+                longest_ms = std::max(longest_ms, time_once_ms([&] { more = scheduler.run_slice(); }));
+                ++slices;
+            }
+        });
+
+        report("Maintenance 2000 notes", "total", total_ms, "ms");
+        report("Maintenance 2000 notes", "slices", slices, "");
+        report("Maintenance 2000 notes", "longest slice", longest_ms, "ms");
+        for (const auto& entry : scheduler.log()) {
+            report("Maintenance 2000 notes", entry.task,
+                   static_cast<double>(entry.duration.count()) / 1000.0, "ms");
+        }
+        report("Maintenance 2000 notes", "file before", before_kib, "KiB");
+        report("Maintenance 2000 notes", "file after", file_kib(), "KiB");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
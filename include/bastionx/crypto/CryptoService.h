@@ -2,8 +2,10 @@
 #define BASTIONX_CRYPTO_CRYPTOSERVICE_H
 
 #include "bastionx/crypto/SecureMemory.h"
+#include "bastionx/crypto/SecureAllocator.h"
 #include <sodium.h>
 #include <array>
+#include <span>
 #include <vector>
 #include <string>
 #include <optional>
@@ -18,7 +20,7 @@ namespace crypto {
  * CryptoService provides all cryptographic operations for Bastionx:
  * - Key derivation from passwords (Argon2id)
  * - Subkey derivation for different purposes (KDF)
- * - Authenticated encryption (XChaCha20-Poly1305 AEAD)
+ * - Authenticated encryption (XChaCha20-Poly1305 or AES-256-GCM AEAD)
  * - Authenticated decryption with AAD validation
  *
  * All operations use libsodium primitives exclusively - no custom crypto.
@@ -57,6 +59,21 @@ public:
     /// Subkey context for full-database encryption (SQLCipher)
     static constexpr uint64_t SUBKEY_DATABASE = 4;
 
+    /// Subkey context for incremental export archives (NoteExporter)
+    static constexpr uint64_t SUBKEY_EXPORT = 5;
+
+    // === Record Algorithms ===
+
+    /**
+     * @brief AEAD algorithm identifier stored alongside each encrypted record
+     *
+     * Values are persisted (notes.alg column) and must never be renumbered.
+     */
+    enum class Algorithm : uint8_t {
+        XChaCha20Poly1305 = 0,   ///< Software XChaCha20-Poly1305 (default, always available)
+        Aes256Gcm = 1            ///< AES-256-GCM with per-record derived key (needs AES-NI)
+    };
+
     // === Data Structures ===
 
     /**
@@ -73,6 +90,44 @@ public:
     struct EncryptedData {
         std::vector<uint8_t> ciphertext;            ///< Ciphertext + MAC tag
         std::array<uint8_t, NONCE_BYTES> nonce;     ///< 24-byte random nonce
+        Algorithm algorithm = Algorithm::XChaCha20Poly1305;  ///< AEAD used for this record
+    };
+
+    /**
+     * @brief Output of encrypt_many(): all ciphertexts in one arena
+     *
+     * Record i occupies arena[offsets[i], offsets[i + 1]) and uses nonces[i].
+     */
+    struct EncryptedBatch {
+        std::vector<uint8_t> arena;                             ///< Ciphertext + tag, back to back
+        std::vector<size_t> offsets;                            ///< size() + 1 entries
+        std::vector<std::array<uint8_t, NONCE_BYTES>> nonces;   ///< One per record
+        Algorithm algorithm = Algorithm::XChaCha20Poly1305;     ///< Shared by all records
+
+        size_t size() const { return nonces.size(); }
+
+        std::span<const uint8_t> ciphertext(size_t i) const {
+            return {arena.data() + offsets[i], offsets[i + 1] - offsets[i]};
+        }
+    };
+
+    /**
+     * @brief Output of decrypt_many(): all plaintexts in one locked arena
+     *
+     * Record i occupies arena[offsets[i], offsets[i + 1]). Only records with
+     * ok[i] set hold plaintext; plaintext(i) is empty for failed records.
+     */
+    struct DecryptedBatch {
+        SecureBytes arena;                                      ///< Plaintext, back to back (locked)
+        std::vector<size_t> offsets;                            ///< size() + 1 entries
+        std::vector<uint8_t> ok;                                ///< 1 = authenticated, 0 = failed
+
+        size_t size() const { return ok.size(); }
+
+        std::span<const uint8_t> plaintext(size_t i) const {
+            if (!ok[i]) return {};
+            return {arena.data() + offsets[i], offsets[i + 1] - offsets[i]};
+        }
     };
 
     // === Key Derivation ===
@@ -118,31 +173,57 @@ public:
     // === Encryption / Decryption ===
 
     /**
-     * @brief Encrypt plaintext using XChaCha20-Poly1305 AEAD
+     * @brief Whether AES-256-GCM is usable on this CPU
+     *
+     * Wraps crypto_aead_aes256gcm_is_available() (AES-NI + PCLMUL on x86,
+     * ARMv8 crypto extensions on ARM). Records written with AES-256-GCM
+     * cannot be decrypted on a machine where this returns false.
+     */
+    static bool aes256gcm_available();
+
+    /**
+     * @brief Algorithm for new records: AES-256-GCM when hardware-accelerated,
+     *        XChaCha20-Poly1305 otherwise
+     */
+    static Algorithm preferred_algorithm();
+
+    /**
+     * @brief Encrypt plaintext using an AEAD (XChaCha20-Poly1305 by default)
      *
      * Uses libsodium's crypto_aead_xchacha20poly1305_ietf_encrypt():
      * - Algorithm: XChaCha20 stream cipher + Poly1305 MAC
      * - Nonce: 24 bytes (randomly generated per encryption)
      * - AAD: Additional authenticated data (not encrypted, but authenticated)
      *
+     * With Algorithm::Aes256Gcm the same 24-byte random nonce is split:
+     * - Bytes 0..15 derive a one-time record key:
+     *   BLAKE2b-256(key = subkey, "BXGCMv1" || nonce[0..15])
+     * - Bytes 16..23 (zero-padded to 12) are the 96-bit GCM nonce
+     * Every record therefore gets a fresh AES key, so the 2^32-message
+     * random-nonce limit of AES-GCM under one key never applies.
+     *
      * @param plaintext Data to encrypt (note payload, settings, etc)
      * @param subkey Subkey for this context (from derive_subkey)
      * @param associated_data AAD (e.g., note_id + timestamp) for ciphertext binding
-     * @return EncryptedData containing ciphertext+MAC and nonce
+     * @param algorithm AEAD to use (recorded in the result)
+     * @return EncryptedData containing ciphertext+MAC, nonce and algorithm
+     * @throws std::runtime_error if AES-256-GCM is requested but unavailable
      *
-     * @note Ciphertext size = plaintext size + 16 bytes (Poly1305 MAC tag)
+     * @note Ciphertext size = plaintext size + 16 bytes (MAC tag, both algorithms)
      * @note Nonce is randomly generated - never reuse keys without unique nonces
      */
     static EncryptedData encrypt(
-        const std::vector<uint8_t>& plaintext,
+        std::span<const uint8_t> plaintext,
         const SecureKey& subkey,
-        const std::vector<uint8_t>& associated_data
+        const std::vector<uint8_t>& associated_data,
+        Algorithm algorithm = Algorithm::XChaCha20Poly1305
     );
 
     /**
-     * @brief Decrypt ciphertext using XChaCha20-Poly1305 AEAD
+     * @brief Decrypt ciphertext with the AEAD recorded in `encrypted.algorithm`
      *
-     * Uses libsodium's crypto_aead_xchacha20poly1305_ietf_decrypt():
+     * Uses libsodium's crypto_aead_xchacha20poly1305_ietf_decrypt() (or
+     * crypto_aead_aes256gcm_decrypt() for AES-256-GCM records):
      * - Verifies MAC tag (authentication)
      * - Validates AAD matches (prevents ciphertext swapping)
      * - Decrypts ciphertext to plaintext
@@ -156,6 +237,7 @@ public:
      *       - MAC verification fails (wrong key, tampered ciphertext)
      *       - AAD mismatch (ciphertext swapped to different context)
      *       - Corrupted ciphertext
+     *       - AES-256-GCM record on hardware without AES-256-GCM support
      */
     static std::optional<std::vector<uint8_t>> decrypt(
         const EncryptedData& encrypted,
@@ -163,7 +245,93 @@ public:
         const std::vector<uint8_t>& associated_data
     );
 
+    /**
+     * @brief Decrypt directly into locked memory
+     *
+     * Same checks as decrypt(), but the plaintext is written into a
+     * SecureBytes buffer (SecureArena / SecureBufferPool) instead of the
+     * ordinary heap, so it is locked while alive and wiped when released.
+     *
+     * @return SecureBytes plaintext on success, nullopt on failure
+     */
+    static std::optional<SecureBytes> decrypt_secure(
+        const EncryptedData& encrypted,
+        const SecureKey& subkey,
+        const std::vector<uint8_t>& associated_data
+    );
+
+    // === Batch Encryption / Decryption ===
+
+    /// Batches smaller than this (total bytes) are processed on the calling thread
+    static constexpr size_t BATCH_PARALLEL_MIN_BYTES = 256 * 1024;
+
+    /**
+     * @brief Encrypt many records in one call
+     *
+     * Equivalent to calling encrypt() per record, but:
+     * - All nonces come from a single randombytes_buf() call
+     * - All ciphertexts are written into one preallocated arena
+     * - Batches of BATCH_PARALLEL_MIN_BYTES or more are split into
+     *   byte-balanced shards across util::ThreadPool::shared()
+     *
+     * @param plaintexts Records to encrypt
+     * @param subkey Subkey shared by every record
+     * @param associated_data One AAD per record (same order as plaintexts)
+     * @param algorithm AEAD for every record
+     * @throws std::invalid_argument if the AAD count does not match
+     * @throws std::runtime_error if AES-256-GCM is requested but unavailable
+     */
+    static EncryptedBatch encrypt_many(
+        std::span<const std::span<const uint8_t>> plaintexts,
+        const SecureKey& subkey,
+        std::span<const std::vector<uint8_t>> associated_data,
+        Algorithm algorithm = Algorithm::XChaCha20Poly1305
+    );
+
+    /**
+     * @brief Decrypt many records in one call (into locked memory)
+     *
+     * Each record is authenticated independently: a failure marks only that
+     * record (ok[i] == 0), matching the skip-on-failure behaviour of scans.
+     * Large batches are split across util::ThreadPool::shared().
+     *
+     * @param records Records to decrypt (each uses its own algorithm field)
+     * @param subkey Subkey shared by every record
+     * @param associated_data One AAD per record (same order as records)
+     * @throws std::invalid_argument if the AAD count does not match
+     */
+    static DecryptedBatch decrypt_many(
+        std::span<const EncryptedData> records,
+        const SecureKey& subkey,
+        std::span<const std::vector<uint8_t>> associated_data
+    );
+
 private:
+    // Shared AEAD encryption; `ciphertext` must hold plaintext + tag bytes
+    static void encrypt_into(
+        unsigned char* ciphertext,
+        std::span<const uint8_t> plaintext,
+        const std::array<uint8_t, NONCE_BYTES>& nonce,
+        const SecureKey& subkey,
+        const std::vector<uint8_t>& associated_data,
+        Algorithm algorithm
+    );
+
+    // Shared AEAD dispatch; `plaintext` must hold ciphertext - tag bytes
+    static bool decrypt_into(
+        unsigned char* plaintext,
+        unsigned long long* plaintext_len,
+        const EncryptedData& encrypted,
+        const SecureKey& subkey,
+        const std::vector<uint8_t>& associated_data
+    );
+
+    // One-time AES-256-GCM key for a record (see encrypt())
+    static SecureKey derive_record_key(
+        const SecureKey& subkey,
+        const std::array<uint8_t, NONCE_BYTES>& nonce
+    );
+
     // Static-only class - prevent instantiation
     CryptoService() = delete;
     ~CryptoService() = delete;
@@ -0,0 +1,100 @@
+#ifndef BASTIONX_CRYPTO_SECRETSTREAM_H
+#define BASTIONX_CRYPTO_SECRETSTREAM_H
+
+#include "bastionx/crypto/SecureMemory.h"
+#include <sodium.h>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bastionx {
+namespace crypto {
+
+/**
+ * @brief Chunked authenticated encryption (crypto_secretstream_xchacha20poly1305)
+ *
+ * Used for records too large to encrypt as one AEAD message. A stream is a
+ * 24-byte header followed by chunks, each authenticated together with its
+ * position in the stream, so chunks cannot be reordered, dropped, or
+ * truncated without detection (the last chunk carries TAG_FINAL).
+ *
+ * Stream state (which contains key material) lives in locked memory.
+ */
+class SecretStreamWriter {
+public:
+    static constexpr size_t HEADER_BYTES = crypto_secretstream_xchacha20poly1305_HEADERBYTES;
+    static constexpr size_t ABYTES = crypto_secretstream_xchacha20poly1305_ABYTES;
+
+    /**
+     * @brief Start a new stream under `key` (32 bytes); generates a random header
+     * @throws std::invalid_argument if the key size is wrong
+     */
+    explicit SecretStreamWriter(const SecureKey& key);
+
+    SecretStreamWriter(const SecretStreamWriter&) = delete;
+    SecretStreamWriter& operator=(const SecretStreamWriter&) = delete;
+
+    /// Header to store ahead of the first chunk
+    const std::array<uint8_t, HEADER_BYTES>& header() const { return header_; }
+
+    /**
+     * @brief Encrypt the next chunk
+     * @param chunk Plaintext chunk
+     * @param associated_data AAD bound to this chunk
+     * @param final True for the last chunk of the stream
+     * @param out Receives chunk + ABYTES bytes (resized; reuse it to avoid allocations)
+     */
+    void push(std::span<const uint8_t> chunk,
+              std::span<const uint8_t> associated_data,
+              bool final,
+              std::vector<uint8_t>& out);
+
+private:
+    SecureBuffer<unsigned char, ArenaAllocator> state_;
+    std::array<uint8_t, HEADER_BYTES> header_{};
+};
+
+/**
+ * @brief Reader counterpart of SecretStreamWriter
+ */
+class SecretStreamReader {
+public:
+    static constexpr size_t HEADER_BYTES = SecretStreamWriter::HEADER_BYTES;
+    static constexpr size_t ABYTES = SecretStreamWriter::ABYTES;
+
+    /**
+     * @brief Open a stream from its header
+     * @throws std::invalid_argument if the key or header is malformed
+     */
+    SecretStreamReader(const SecureKey& key, std::span<const uint8_t> header);
+
+    SecretStreamReader(const SecretStreamReader&) = delete;
+    SecretStreamReader& operator=(const SecretStreamReader&) = delete;
+
+    /**
+     * @brief Decrypt and authenticate the next chunk
+     * @param ciphertext Chunk ciphertext (plaintext + ABYTES)
+     * @param associated_data AAD the chunk was written with
+     * @param out Destination with room for ciphertext.size() - ABYTES bytes
+     * @param out_len Receives the plaintext length
+     * @return true on success; false on authentication failure (stream is dead)
+     */
+    bool pull(std::span<const uint8_t> ciphertext,
+              std::span<const uint8_t> associated_data,
+              unsigned char* out,
+              size_t* out_len);
+
+    /// True once a chunk tagged final has been pulled
+    bool finished() const { return finished_; }
+
+private:
+    SecureBuffer<unsigned char, ArenaAllocator> state_;
+    bool finished_ = false;
+    bool failed_ = false;
+};
+
+}  // namespace crypto
+}  // namespace bastionx
+
+#endif  // BASTIONX_CRYPTO_SECRETSTREAM_H
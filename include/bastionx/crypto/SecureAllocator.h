@@ -0,0 +1,131 @@
+#ifndef BASTIONX_CRYPTO_SECUREALLOCATOR_H
+#define BASTIONX_CRYPTO_SECUREALLOCATOR_H
+
+#include "bastionx/crypto/SecureArena.h"
+#include "bastionx/crypto/SecureBufferPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bastionx {
+namespace crypto {
+
+/**
+ * @brief Standard-library allocator backed by locked, wiped-on-free memory
+ *
+ * Routes each request by size:
+ * - Up to SecureArena::kMaxBlockBytes: SecureArena slab
+ * - Larger: SecureBufferPool (reusable locked blocks)
+ *
+ * Stateless, so all instances compare equal and containers can swap and
+ * move storage freely.
+ *
+ * @note std::basic_string keeps very short values (SSO) inside the object
+ *       itself; those bytes live wherever the string object lives.
+ */
+template<typename T>
+class SecureAllocator {
+public:
+    using value_type = T;
+
+    SecureAllocator() noexcept = default;
+
+    template<typename U>
+    SecureAllocator(const SecureAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        size_t bytes = n * sizeof(T);
+        if (bytes <= SecureArena::kMaxBlockBytes) {
+            return static_cast<T*>(SecureArena::instance().allocate(bytes == 0 ? 1 : bytes));
+        }
+        return static_cast<T*>(SecureBufferPool::instance().acquire(bytes));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        size_t bytes = n * sizeof(T);
+        if (bytes <= SecureArena::kMaxBlockBytes) {
+            SecureArena::instance().deallocate(ptr, bytes == 0 ? 1 : bytes);
+            return;
+        }
+        SecureBufferPool::instance().release(ptr, bytes);
+    }
+
+    template<typename U>
+    bool operator==(const SecureAllocator<U>&) const noexcept { return true; }
+};
+
+/// Byte buffer for decrypted plaintext
+using SecureBytes = std::vector<uint8_t, SecureAllocator<uint8_t>>;
+
+/**
+ * @brief std::string-compatible string whose heap storage is locked and wiped
+ *
+ * Thin wrapper over std::basic_string with SecureAllocator that adds
+ * conversions from (and comparisons with) std::string / string_view, so
+ * call sites that fill a Note from ordinary strings keep compiling.
+ * Converting back to std::string is intentionally explicit (str()).
+ */
+class SecureString
+    : public std::basic_string<char, std::char_traits<char>, SecureAllocator<char>> {
+public:
+    using Base = std::basic_string<char, std::char_traits<char>, SecureAllocator<char>>;
+    using Base::Base;
+
+    SecureString() = default;
+    SecureString(const Base& other) : Base(other) {}
+    SecureString(Base&& other) noexcept : Base(std::move(other)) {}
+    SecureString(std::string_view sv) : Base(sv.data(), sv.size()) {}
+    SecureString(const std::string& s) : Base(s.data(), s.size()) {}
+    SecureString(const char* s) : Base(s) {}
+
+    SecureString& operator=(std::string_view sv) {
+        Base::assign(sv.data(), sv.size());
+        return *this;
+    }
+    SecureString& operator=(const std::string& s) {
+        Base::assign(s.data(), s.size());
+        return *this;
+    }
+    SecureString& operator=(const char* s) {
+        Base::assign(s);
+        return *this;
+    }
+
+    /// View without copying
+    std::string_view view() const noexcept { return {data(), size()}; }
+
+    /// Explicit copy onto the ordinary heap (for APIs that require std::string)
+    std::string str() const { return std::string(data(), size()); }
+
+    friend bool operator==(const SecureString& a, const std::string& b) noexcept {
+        return a.view() == std::string_view(b);
+    }
+    friend bool operator==(const std::string& a, const SecureString& b) noexcept {
+        return std::string_view(a) == b.view();
+    }
+    friend bool operator==(const SecureString& a, const char* b) noexcept {
+        return a.view() == std::string_view(b);
+    }
+    friend bool operator==(const char* a, const SecureString& b) noexcept {
+        return std::string_view(a) == b.view();
+    }
+};
+
+}  // namespace crypto
+}  // namespace bastionx
+
+template<>
+struct std::hash<bastionx::crypto::SecureString> {
+    size_t operator()(const bastionx::crypto::SecureString& s) const noexcept {
+        return std::hash<std::string_view>{}(s.view());
+    }
+};
+
+#endif  // BASTIONX_CRYPTO_SECUREALLOCATOR_H
@@ -0,0 +1,135 @@
+#ifndef BASTIONX_CRYPTO_SECUREARENA_H
+#define BASTIONX_CRYPTO_SECUREARENA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace bastionx {
+namespace crypto {
+
+/**
+ * @brief Slab allocator for small secrets inside a single locked region
+ *
+ * Every sodium_malloc() call maps its own guard pages and mlock()s at least
+ * one page, which makes each 32-byte key cost several syscalls and 12+ KB of
+ * address space. SecureArena instead reserves one sodium_malloc'd region
+ * (locked, guard pages on both ends, canary) up front and carves it into
+ * fixed-size slabs, each serving a single power-of-two size class.
+ *
+ * - Requests up to kMaxBlockBytes are served from slabs
+ * - Larger requests (or requests when the region is exhausted) fall back to
+ *   a dedicated sodium_malloc() allocation
+ * - Every block is wiped with sodium_memzero() when it is released
+ * - Slabs that become empty are returned to the unassigned pool so any size
+ *   class can reuse them
+ *
+ * All methods are thread-safe. The process-wide instance is obtained with
+ * instance(); it must not be used before sodium_init() has succeeded.
+ */
+class SecureArena {
+public:
+    /// Bytes per slab (one page on all supported platforms)
+    static constexpr size_t kSlabBytes = 4096;
+
+    /// Smallest block handed out (also the block alignment)
+    static constexpr size_t kMinBlockBytes = 16;
+
+    /// Largest block served from slabs; bigger requests use sodium_malloc()
+    static constexpr size_t kMaxBlockBytes = 1024;
+
+    /// Slabs reserved by the process-wide instance (64 KiB of locked memory)
+    static constexpr size_t kDefaultSlabCount = 16;
+
+    /**
+     * @brief Allocation counters (snapshot)
+     */
+    struct Stats {
+        size_t region_bytes = 0;            ///< Locked bytes reserved by the slab region
+        size_t slab_bytes_in_use = 0;       ///< Block-rounded bytes handed out from slabs
+        size_t peak_slab_bytes_in_use = 0;  ///< High-water mark of slab_bytes_in_use
+        size_t fallback_bytes_in_use = 0;   ///< Page-rounded bytes held by fallback allocations
+        size_t live_allocations = 0;        ///< Blocks currently outstanding (slab + fallback)
+        uint64_t total_allocations = 0;     ///< Allocations served since construction
+        uint64_t fallback_allocations = 0;  ///< Allocations that bypassed the slabs
+
+        /// Total locked memory attributable to the arena right now
+        size_t locked_bytes() const { return region_bytes + fallback_bytes_in_use; }
+    };
+
+    /**
+     * @brief Get the process-wide arena
+     */
+    static SecureArena& instance();
+
+    /**
+     * @brief Reserve a locked region of slab_count slabs
+     * @param slab_count Number of kSlabBytes slabs (0 = fallback-only arena)
+     *
+     * @note If the region cannot be allocated the arena degrades to
+     *       fallback-only mode instead of throwing
+     */
+    explicit SecureArena(size_t slab_count = kDefaultSlabCount);
+    ~SecureArena();
+
+    SecureArena(const SecureArena&) = delete;
+    SecureArena& operator=(const SecureArena&) = delete;
+
+    /**
+     * @brief Allocate a block of at least `bytes` bytes
+     * @param bytes Requested size (must be > 0)
+     * @return Pointer to 16-byte aligned secure memory
+     * @throws std::runtime_error if the fallback allocation fails
+     */
+    void* allocate(size_t bytes);
+
+    /**
+     * @brief Wipe and release a block obtained from allocate()
+     * @param ptr Block pointer (nullptr is ignored)
+     * @param bytes The size originally passed to allocate()
+     */
+    void deallocate(void* ptr, size_t bytes) noexcept;
+
+    /**
+     * @brief Check whether ptr lies inside the slab region
+     */
+    bool owns(const void* ptr) const noexcept;
+
+    /**
+     * @brief Snapshot of the allocation counters
+     */
+    Stats stats() const;
+
+private:
+    static constexpr size_t kSizeClasses = 7;  // 16, 32, ..., 1024
+    static constexpr size_t kMaxBlocksPerSlab = kSlabBytes / kMinBlockBytes;
+    static constexpr size_t kBitmapWords = kMaxBlocksPerSlab / 64;
+    static constexpr int kUnassigned = -1;
+
+    struct Slab {
+        int size_class = kUnassigned;
+        size_t used_count = 0;
+        std::array<uint64_t, kBitmapWords> used{};  // One bit per block
+    };
+
+    static int size_class_for(size_t bytes) noexcept;
+    static size_t block_bytes(int size_class) noexcept;
+    static size_t fallback_footprint(size_t bytes) noexcept;
+
+    void* allocate_from_slab(int size_class);
+
+    unsigned char* region_ = nullptr;
+    size_t region_bytes_ = 0;
+    std::vector<Slab> slabs_;
+    std::array<size_t, kSizeClasses> hint_{};  // Last slab that served each class
+
+    mutable std::mutex mutex_;
+    Stats stats_;
+};
+
+}  // namespace crypto
+}  // namespace bastionx
+
+#endif  // BASTIONX_CRYPTO_SECUREARENA_H
@@ -0,0 +1,106 @@
+#ifndef BASTIONX_CRYPTO_SECUREBUFFERPOOL_H
+#define BASTIONX_CRYPTO_SECUREBUFFERPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace bastionx {
+namespace crypto {
+
+/**
+ * @brief Pool of reusable locked buffers for decrypted payloads
+ *
+ * Decrypted notes are too large for SecureArena slabs, and a full-vault scan
+ * would otherwise sodium_malloc()/sodium_free() (mmap + mlock + munlock +
+ * munmap) one buffer per row. SecureBufferPool keeps released blocks, already
+ * wiped, in power-of-two capacity buckets so the next acquire() of a similar
+ * size is served without any syscall.
+ *
+ * - Capacities are rounded up to a power of two >= kMinBlockBytes
+ * - Blocks larger than kMaxPooledBlockBytes are never retained
+ * - Idle blocks are capped by an idle-byte budget; excess is freed
+ * - release() always wipes the bytes the caller could have written
+ *
+ * All methods are thread-safe. Like SecureArena, the process-wide instance
+ * must not be used before sodium_init() has succeeded.
+ */
+class SecureBufferPool {
+public:
+    /// Smallest pooled capacity
+    static constexpr size_t kMinBlockBytes = 4096;
+
+    /// Largest capacity that is kept for reuse after release()
+    static constexpr size_t kMaxPooledBlockBytes = 16 * 1024 * 1024;
+
+    /// Default cap on wiped-but-retained memory
+    static constexpr size_t kDefaultIdleBudgetBytes = 8 * 1024 * 1024;
+
+    /**
+     * @brief Pool counters (snapshot)
+     */
+    struct Stats {
+        uint64_t acquires = 0;       ///< Total acquire() calls
+        uint64_t reuse_hits = 0;     ///< Served from an idle block (no syscall)
+        uint64_t fresh_allocs = 0;   ///< Served by a new sodium_malloc()
+        size_t live_bytes = 0;       ///< Capacity currently handed out
+        size_t idle_bytes = 0;       ///< Capacity retained for reuse
+        size_t idle_blocks = 0;      ///< Number of retained blocks
+    };
+
+    /**
+     * @brief Get the process-wide pool
+     */
+    static SecureBufferPool& instance();
+
+    /**
+     * @brief Create a pool that retains at most idle_budget_bytes of idle blocks
+     */
+    explicit SecureBufferPool(size_t idle_budget_bytes = kDefaultIdleBudgetBytes);
+    ~SecureBufferPool();
+
+    SecureBufferPool(const SecureBufferPool&) = delete;
+    SecureBufferPool& operator=(const SecureBufferPool&) = delete;
+
+    /**
+     * @brief Capacity actually reserved for a request of `bytes`
+     */
+    static size_t capacity_for(size_t bytes) noexcept;
+
+    /**
+     * @brief Get a locked block of at least `bytes` bytes
+     * @throws std::runtime_error if a fresh allocation fails
+     */
+    void* acquire(size_t bytes);
+
+    /**
+     * @brief Wipe the first `bytes` bytes and return the block to the pool
+     * @param ptr Block from acquire() (nullptr is ignored)
+     * @param bytes The size originally passed to acquire()
+     */
+    void release(void* ptr, size_t bytes) noexcept;
+
+    /**
+     * @brief Free every idle block (call when the vault locks)
+     */
+    void trim() noexcept;
+
+    /**
+     * @brief Snapshot of the pool counters
+     */
+    Stats stats() const;
+
+private:
+    size_t idle_budget_bytes_;
+    std::map<size_t, std::vector<void*>> idle_;  // capacity -> wiped blocks
+
+    mutable std::mutex mutex_;
+    Stats stats_;
+};
+
+}  // namespace crypto
+}  // namespace bastionx
+
+#endif  // BASTIONX_CRYPTO_SECUREBUFFERPOOL_H
@@ -1,6 +1,7 @@
 #ifndef BASTIONX_CRYPTO_SECUREMEMORY_H
 #define BASTIONX_CRYPTO_SECUREMEMORY_H
 
+#include "bastionx/crypto/SecureArena.h"
 #include <sodium.h>
 #include <cstddef>
 #include <span>
@@ -10,18 +11,52 @@
 namespace bastionx {
 namespace crypto {
 
+/**
+ * @brief Allocation policy: one sodium_malloc() per buffer
+ *
+ * Each buffer gets its own guard pages and canary. Best for large or
+ * long-lived buffers where per-allocation overflow detection matters.
+ */
+struct SodiumAllocator {
+    static void* allocate(size_t bytes) {
+        return sodium_malloc(bytes);
+    }
+
+    static void deallocate(void* ptr, size_t bytes) noexcept {
+        sodium_memzero(ptr, bytes);
+        sodium_free(ptr);
+    }
+};
+
+/**
+ * @brief Allocation policy: slab from the process-wide SecureArena
+ *
+ * Small buffers share one locked, guarded region; large ones transparently
+ * fall back to sodium_malloc(). Blocks are wiped on release either way.
+ */
+struct ArenaAllocator {
+    static void* allocate(size_t bytes) {
+        return SecureArena::instance().allocate(bytes);
+    }
+
+    static void deallocate(void* ptr, size_t bytes) noexcept {
+        SecureArena::instance().deallocate(ptr, bytes);
+    }
+};
+
 /**
  * @brief RAII wrapper for libsodium secure memory allocation
  *
  * SecureBuffer provides automatic memory management for sensitive data:
- * - Allocates memory using sodium_malloc() (locked, with guard pages)
+ * - Allocates locked memory through the Allocator policy
  * - Automatically zeros memory on destruction using sodium_memzero()
  * - Non-copyable to prevent accidental key duplication
  * - Movable for efficient transfer of ownership
  *
  * @tparam T The type of data to store (typically unsigned char)
+ * @tparam Allocator SodiumAllocator (default) or ArenaAllocator
  */
-template<typename T>
+template<typename T, typename Allocator = SodiumAllocator>
 class SecureBuffer {
 public:
     /**
@@ -37,8 +72,8 @@ public:
             return;
         }
 
-        // Allocate using sodium_malloc (locked memory with guard pages)
-        data_ = static_cast<T*>(sodium_malloc(count * sizeof(T)));
+        // Allocate locked memory through the policy
+        data_ = static_cast<T*>(Allocator::allocate(count * sizeof(T)));
 
         if (data_ == nullptr) {
             throw std::runtime_error("Failed to allocate secure memory");
@@ -50,9 +85,8 @@ public:
      */
     ~SecureBuffer() {
         if (data_ != nullptr) {
-            // Zero memory before freeing (critical for key material)
-            sodium_memzero(data_, size_ * sizeof(T));
-            sodium_free(data_);
+            // Policy zeros memory before freeing (critical for key material)
+            Allocator::deallocate(data_, size_ * sizeof(T));
             data_ = nullptr;
             size_ = 0;
         }
@@ -78,8 +112,7 @@ public:
         if (this != &other) {
             // Clean up existing data
             if (data_ != nullptr) {
-                sodium_memzero(data_, size_ * sizeof(T));
-                sodium_free(data_);
+                Allocator::deallocate(data_, size_ * sizeof(T));
             }
 
             // Transfer ownership
@@ -176,9 +209,10 @@ private:
  * @brief Type alias for cryptographic key material
  *
  * SecureKey is the primary type used throughout the application
- * for storing sensitive cryptographic keys in memory.
+ * for storing sensitive cryptographic keys in memory. Keys are small and
+ * short-lived, so they are served from the SecureArena slabs.
  */
-using SecureKey = SecureBuffer<unsigned char>;
+using SecureKey = SecureBuffer<unsigned char, ArenaAllocator>;
 
 }  // namespace crypto
 }  // namespace bastionx
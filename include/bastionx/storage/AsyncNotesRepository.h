@@ -0,0 +1,324 @@
+#ifndef BASTIONX_STORAGE_ASYNCNOTESREPOSITORY_H
+#define BASTIONX_STORAGE_ASYNCNOTESREPOSITORY_H
+
+#include "bastionx/storage/ConnectionPool.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/util/Coroutine.h"
+#include "bastionx/util/ThreadPool.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Runs every call on a NotesRepository on one dedicated thread
+ *
+ * The UI hands the writer repository to the facade and from then on only
+ * reaches it through submit() and post(), so decryption, JSON and SQLite
+ * I/O no longer add to input latency:
+ *
+ * - submit() queues a call and returns a std::future for its result;
+ * - post() queues a call and hands its result (or error message) to a
+ *   callback, run through the Dispatcher given at construction. The UI's
+ *   dispatcher queues it on the GUI thread's event loop;
+ * - run() queues a call for a coroutine to co_await; it resumes through
+ *   the same Dispatcher.
+ *
+ * Requests run one at a time in the order they were queued, so calls for
+ * the same note can never overtake each other and a read queued after a
+ * save sees that save.
+ *
+ * Each request is a kRead, a kWrite, a kSnapshot or a kPrefetch.
+ * cancel_reads() drops queued reads (loads, lists, searches, idle
+ * housekeeping) that nobody will look at any more.
+ *
+ * kSnapshot requests are reads that only need committed rows (lists,
+ * searches, exports). Built over a ConnectionPool, the facade runs them on
+ * leased readers, one reader thread per pool reader, so a long search no
+ * longer holds up the saves queued behind it. The storage thread first
+ * commits the repository's write-behind queue, so a snapshot still sees
+ * every save queued before it; it may also see later ones. Their results
+ * can arrive out of order with other requests'. Without a pool they run
+ * on the storage thread like kRead.
+ *
+ * kPrefetch requests are speculative reads (warming NotesRepository's note
+ * cache for notes the user may open next). They wait in their own queue
+ * and only run when no other request is queued, so they delay foreground
+ * work by at most the one prefetch already running. At most
+ * kMaxQueuedPrefetches wait at a time; queueing another drops the oldest.
+ * cancel_prefetches() and cancel_reads() drop them. close() is the lock barrier: it stops accepting requests,
+ * drains or cancels what is queued, flushes the repository's write-behind
+ * queue and joins the thread. Writes are never cancelled. No callback is
+ * delivered once close() has returned, even for requests it drained; their
+ * futures still hold the result.
+ *
+ * Work items must not call back into the facade and wait for the result
+ * (the thread would wait for itself), and must not touch Qt widgets.
+ */
+class AsyncNotesRepository {
+public:
+    /// Runs a callback on the thread that owns the facade
+    using Dispatcher = util::Dispatcher;
+    using ErrorHandler = std::function<void(const std::string&)>;
+
+    enum class Kind {
+        kRead,     ///< Result only matters to the caller: may be cancelled
+        kWrite,    ///< Changes the vault: always runs
+        kSnapshot, ///< Read of committed rows on a pool reader: may be cancelled
+        kPrefetch  ///< Speculative read: runs when idle, may be dropped
+    };
+
+    /// Prefetches kept waiting; queueing more drops the oldest
+    static constexpr size_t kMaxQueuedPrefetches = 16;
+
+    enum class CloseMode {
+        kDrain,        ///< Run everything still queued
+        kCancelReads   ///< Drop queued reads, run queued writes (locking)
+    };
+
+    /// Callback type for a result of type R (no argument for void)
+    template <typename R>
+    struct CallbackFor { using type = std::function<void(R)>; };
+    template <typename R>
+    using Callback = typename CallbackFor<R>::type;
+
+    /**
+     * @brief Start the storage thread
+     * @param repo Repository to own until close() (must outlive this);
+     *        no other thread may use it meanwhile
+     * @param dispatcher Delivers post() callbacks; empty = run them on the
+     *        storage thread
+     */
+    explicit AsyncNotesRepository(NotesRepository& repo, Dispatcher dispatcher = {});
+
+    /**
+     * @brief Start the storage thread over the pool's writer, and a reader
+     *        thread per pool reader for kSnapshot requests
+     * @param pool Pool to use until close() (must outlive this); no other
+     *        thread may use its writer meanwhile
+     * @param dispatcher As above
+     */
+    explicit AsyncNotesRepository(ConnectionPool& pool, Dispatcher dispatcher = {});
+
+    /**
+     * @brief close(CloseMode::kDrain)
+     */
+    ~AsyncNotesRepository();
+
+    AsyncNotesRepository(const AsyncNotesRepository&) = delete;
+    AsyncNotesRepository& operator=(const AsyncNotesRepository&) = delete;
+
+    /**
+     * @brief Queue `work` and get its result as a future
+     *
+     * The future rethrows whatever `work` threw, or a std::runtime_error
+     * if the request was cancelled.
+     *
+     * @throws std::runtime_error if the facade is closed
+     */
+    template <typename Work>
+    auto submit(Kind kind, Work work) -> std::future<std::invoke_result_t<Work&, NotesRepository&>>;
+
+    /**
+     * @brief Queue `work` and deliver its result through the dispatcher
+     *
+     * Exactly one of `on_done` and `on_error` (if set) is called, unless
+     * the request is cancelled or the facade closed first.
+     *
+     * @throws std::runtime_error if the facade is closed
+     */
+    template <typename Work>
+    void post(Kind kind, Work work,
+              Callback<std::invoke_result_t<Work&, NotesRepository&>> on_done = {},
+              ErrorHandler on_error = {});
+
+    /**
+     * @brief Queue `work` for a coroutine to co_await
+     *
+     * co_await returns the result or rethrows what `work` threw. It throws
+     * util::Cancelled if the request is cancelled or `token` is cancelled
+     * by the time the coroutine resumes. Unlike post() callbacks, the
+     * coroutine is resumed even after close(), so it can unwind.
+     *
+     * @throws std::runtime_error (from co_await) if the facade is closed
+     */
+    template <typename Work>
+    auto run(Kind kind, Work work, util::CancelToken token = {})
+        -> util::Awaitable<std::invoke_result_t<Work&, NotesRepository&>>;
+
+    /**
+     * @brief Drop every queued kRead, kSnapshot and kPrefetch request
+     * @return Number of requests dropped
+     */
+    size_t cancel_reads();
+
+    /**
+     * @brief Drop every queued kPrefetch request
+     * @return Number of requests dropped
+     */
+    size_t cancel_prefetches();
+
+    /**
+     * @brief Block until every request queued so far has run
+     */
+    void drain();
+
+    /**
+     * @brief Stop accepting requests, finish the queue, flush the
+     *        repository's write-behind queue and join the thread
+     *
+     * kCancelReads also interrupts the snapshots running on pool readers.
+     * A failed final flush leaves the saves queued in the repository,
+     * which retries them when it closes. No-op if already closed.
+     */
+    void close(CloseMode mode = CloseMode::kCancelReads);
+
+    bool is_open() const;
+
+    /// Requests queued or running
+    size_t pending() const;
+
+private:
+    // The repository a request runs on: the writer, or a reader leased on
+    // first use. Called inside the request's own error handling
+    using Source = std::function<NotesRepository&()>;
+
+    struct Request {
+        Kind kind = Kind::kRead;
+        uint64_t generation = 0;  // read_generation_ when queued
+        std::function<void(const Source&)> run;
+        std::function<void()> cancel;
+    };
+
+    void enqueue(Request request);
+    void deliver(std::function<void()> callback);
+    void worker_loop();
+    void run_on_writer(Request& request);
+    void start_snapshot(Request request);
+
+    NotesRepository& repo_;
+    ConnectionPool* pool_ = nullptr;
+    Dispatcher dispatcher_;
+    std::unique_ptr<util::ThreadPool> readers_;  // Runs kSnapshot requests
+
+    // Cleared by close(); callbacks already handed to the dispatcher check
+    // it before running
+    std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
+
+    std::deque<Request> queue_;
+    std::deque<Request> prefetch_queue_;  // Run only when queue_ is empty
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    bool running_ = false;
+    size_t snapshots_running_ = 0;  // Handed to readers_, not yet finished
+    uint64_t read_generation_ = 0;  // Bumped by cancel_reads()
+    bool closed_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+// === Template Implementation ===
+
+template <>
+struct AsyncNotesRepository::CallbackFor<void> { using type = std::function<void()>; };
+
+template <typename Work>
+auto AsyncNotesRepository::submit(Kind kind, Work work)
+    -> std::future<std::invoke_result_t<Work&, NotesRepository&>> {
+    using R = std::invoke_result_t<Work&, NotesRepository&>;
+
+    auto promise = std::make_shared<std::promise<R>>();
+    auto future = promise->get_future();
+
+    Request request;
+    request.kind = kind;
+    request.run = [promise, work = std::move(work)](const Source& source) mutable {
+        try {
+            if constexpr (std::is_void_v<R>) {
+                work(source());
+                promise->set_value();
+            } else {
+                promise->set_value(work(source()));
+            }
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    };
+    request.cancel = [promise] {
+        promise->set_exception(std::make_exception_ptr(std::runtime_error("Request cancelled")));
+    };
+    enqueue(std::move(request));
+    return future;
+}
+
+template <typename Work>
+void AsyncNotesRepository::post(Kind kind, Work work,
+                                Callback<std::invoke_result_t<Work&, NotesRepository&>> on_done,
+                                ErrorHandler on_error) {
+    using R = std::invoke_result_t<Work&, NotesRepository&>;
+
+    Request request;
+    request.kind = kind;
+    request.run = [this, work = std::move(work), on_done = std::move(on_done),
+                   on_error = std::move(on_error)](const Source& source) mutable {
+        try {
+            if constexpr (std::is_void_v<R>) {
+                work(source());
+                if (on_done) {
+                    deliver(std::move(on_done));
+                }
+            } else {
+                // Shared so the dispatcher may copy the callback, not the result
+                auto result = std::make_shared<R>(work(source()));
+                if (on_done) {
+                    deliver([on_done = std::move(on_done), result] { on_done(std::move(*result)); });
+                }
+            }
+        } catch (const std::exception& e) {
+            if (on_error) {
+                deliver([on_error = std::move(on_error), message = std::string(e.what())] {
+                    on_error(message);
+                });
+            }
+        }
+    };
+    request.cancel = [] {};
+    enqueue(std::move(request));
+}
+
+template <typename Work>
+auto AsyncNotesRepository::run(Kind kind, Work work, util::CancelToken token)
+    -> util::Awaitable<std::invoke_result_t<Work&, NotesRepository&>> {
+    using R = std::invoke_result_t<Work&, NotesRepository&>;
+
+    return util::Awaitable<R>(
+        [this, kind, work = std::move(work)](util::Completion<R> done) mutable {
+            Request request;
+            request.kind = kind;
+            request.run = [work, done](const Source& source) mutable {
+                done.run([&] { return work(source()); });
+            };
+            request.cancel = [done]() mutable { done.cancel(); };
+            enqueue(std::move(request));
+        },
+        dispatcher_, std::move(token));
+}
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_ASYNCNOTESREPOSITORY_H
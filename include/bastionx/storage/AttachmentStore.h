@@ -0,0 +1,155 @@
+#ifndef BASTIONX_STORAGE_ATTACHMENTSTORE_H
+#define BASTIONX_STORAGE_ATTACHMENTSTORE_H
+
+#include "bastionx/crypto/CryptoService.h"
+#include "bastionx/crypto/SecureMemory.h"
+#include "bastionx/crypto/SecureAllocator.h"
+#include "bastionx/storage/ConnectionProfile.h"
+#include <sqlcipher/sqlite3.h>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Attachment as listed for one note (name and type are per note)
+ */
+struct AttachmentInfo {
+    int64_t attachment_id = 0;
+    std::string name;                    ///< File name shown in the editor
+    std::string mime_type;
+    uint64_t size = 0;                   ///< Plaintext bytes
+    int64_t created_at = 0;              ///< When it was attached to this note
+};
+
+/**
+ * @brief Encrypted, deduplicated file attachments (images, PDFs, ...)
+ *
+ * File contents are streamed in and out in kChunkBytes pieces and never held
+ * whole in memory:
+ *
+ * - Each attachment has its own random key, stored wrapped (AEAD) under the
+ *   notes subkey. Contents are a crypto_secretstream under that key in
+ *   attachment_chunks, so chunks cannot be reordered, dropped or truncated.
+ * - Attachments are identified by a keyed BLAKE2b hash of their contents
+ *   (content ID). The hash key is random per vault and stored wrapped in
+ *   vault_keys, so equal files are stored once while the content ID reveals
+ *   nothing to anyone without the vault key.
+ * - attachment_refs links notes to attachments; each link carries the file
+ *   name and MIME type (encrypted). An attachment is deleted with its last
+ *   link, including when its note is deleted.
+ *
+ * A password change re-wraps the per-attachment keys and re-encrypts the
+ * links; the contents are not touched.
+ *
+ * Like NotesRepository, it owns its own SQLite connection and takes the
+ * notes subkey per call. Not thread-safe.
+ */
+class AttachmentStore {
+public:
+    /// Plaintext bytes per stream chunk
+    static constexpr size_t kChunkBytes = 64 * 1024;
+
+    /// Bytes of a content ID (keyed BLAKE2b-256)
+    static constexpr size_t kContentIdBytes = 32;
+
+    /// Fills `buffer` and returns the bytes written; 0 at end of input
+    using Source = std::function<size_t(std::span<uint8_t> buffer)>;
+
+    /// Receives decrypted contents in order, at most kChunkBytes per call
+    using Sink = std::function<void(std::span<const uint8_t>)>;
+
+    /**
+     * @brief Open an existing vault database for attachment operations
+     * @param db_path Path to the SQLite vault database (must already have schema)
+     * @param db_key Optional SQLCipher encryption key (nullptr for unencrypted)
+     * @param profile Connection settings (VaultService::connection_profile())
+     * @throws std::runtime_error if database cannot be opened
+     */
+    explicit AttachmentStore(const std::string& db_path,
+                             const crypto::SecureKey* db_key = nullptr,
+                             const ConnectionProfile& profile = ConnectionProfile::balanced());
+    ~AttachmentStore();
+
+    AttachmentStore(const AttachmentStore&) = delete;
+    AttachmentStore& operator=(const AttachmentStore&) = delete;
+
+    /**
+     * @brief Stream a file in and attach it to a note
+     *
+     * Contents identical to an existing attachment are linked to it and the
+     * new copy is discarded. Attaching the same contents to the same note
+     * again replaces the name and type.
+     *
+     * @return Attachment ID, or nullopt if the note does not exist
+     * @throws std::runtime_error on SQLite or encryption errors
+     */
+    std::optional<int64_t> attach(int64_t note_id, const std::string& name,
+                                  const std::string& mime_type, const Source& source,
+                                  const crypto::SecureKey& subkey);
+
+    /// attach() reading from a stream until EOF
+    std::optional<int64_t> attach(int64_t note_id, const std::string& name,
+                                  const std::string& mime_type, std::istream& in,
+                                  const crypto::SecureKey& subkey);
+
+    /**
+     * @brief Stream an attachment's contents to `sink`, one chunk at a time
+     *
+     * The sink may receive data before a later chunk fails authentication;
+     * the whole file is only verified (size and content ID) once this
+     * returns true.
+     *
+     * @return false if the attachment is missing or any check fails
+     */
+    bool read(int64_t attachment_id, const crypto::SecureKey& subkey, const Sink& sink);
+
+    /**
+     * @brief Attachments linked to a note, oldest link first
+     * @note Links that fail to decrypt are skipped
+     */
+    std::vector<AttachmentInfo> list(int64_t note_id, const crypto::SecureKey& subkey);
+
+    /**
+     * @brief Unlink an attachment from a note; deletes it with its last link
+     * @return true if the link existed
+     */
+    bool detach(int64_t note_id, int64_t attachment_id);
+
+    /// Number of stored (deduplicated) attachments
+    uint64_t attachment_count();
+
+    void close();
+    bool is_open() const;
+
+private:
+    sqlite3* db_;
+    std::string db_path_;
+
+    // Content ID hash key (loaded, or created, on first use)
+    std::optional<crypto::SecureKey> content_key_;
+
+    const crypto::SecureKey& content_key(const crypto::SecureKey& subkey);
+
+    // Unwrap an attachment's stream key
+    std::optional<crypto::SecureKey> unwrap_key(
+        int64_t attachment_id, const crypto::CryptoService::EncryptedData& wrapped,
+        const crypto::SecureKey& subkey);
+
+    // Link metadata plaintext: name_len (2 bytes LE) | name | MIME type
+    static crypto::SecureBytes encode_link(const std::string& name, const std::string& mime_type);
+    static std::optional<AttachmentInfo> decode_link(std::span<const uint8_t> plaintext);
+
+    static int64_t current_timestamp();
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_ATTACHMENTSTORE_H
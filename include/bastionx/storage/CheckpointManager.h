@@ -0,0 +1,105 @@
+#ifndef BASTIONX_STORAGE_CHECKPOINTMANAGER_H
+#define BASTIONX_STORAGE_CHECKPOINTMANAGER_H
+
+#include "bastionx/storage/SqliteEngine.h"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Schedules WAL checkpoints for idle time instead of mid-save
+ *
+ * SQLite checkpoints on its own after a commit once the WAL reaches 1000
+ * pages, so a save now and then pays for copying the whole log. The
+ * manager turns that down to a far-off safety net (Options) and lets the
+ * owner checkpoint when the user is idle:
+ *
+ * - run_idle() checkpoints PASSIVE, copying what no reader still needs
+ *   without waiting for anyone;
+ * - past Options::restart_bytes of -wal file it escalates to RESTART, so
+ *   the next save reuses the log from the start instead of growing it;
+ * - past Options::truncate_bytes, to TRUNCATE, which also cuts the file
+ *   back to zero.
+ *
+ * ConnectionPool::close() (and so VaultService::lock()) runs a final
+ * TRUNCATE. Each checkpoint's mode, duration and WAL size before and
+ * after are kept in stats().
+ *
+ * Runs on the engine's owner thread, like any other write.
+ */
+class CheckpointManager {
+public:
+    using Mode = SqliteEngine::CheckpointMode;
+
+    struct Options {
+        /// -wal size from which idle checkpoints RESTART
+        uint64_t restart_bytes = 4 * 1024 * 1024;
+        /// -wal size from which idle checkpoints TRUNCATE
+        uint64_t truncate_bytes = 16 * 1024 * 1024;
+        /// Safety net if the app is never idle: SQLite's own checkpoint
+        /// after this many pages (64 MiB at 4 KiB pages)
+        int auto_checkpoint_pages = 16384;
+    };
+
+    struct Result {
+        Mode mode = Mode::kPassive;
+        bool busy = false;                   ///< Stopped short by a reader or writer
+        int wal_frames = 0;
+        int checkpointed_frames = 0;
+        uint64_t wal_bytes_before = 0;
+        uint64_t wal_bytes_after = 0;
+        std::chrono::microseconds duration{0};
+    };
+
+    struct Stats {
+        uint64_t checkpoints = 0;
+        uint64_t busy = 0;                   ///< Of those, stopped short
+        std::chrono::microseconds total{0};
+        std::chrono::microseconds longest{0};
+        std::optional<Result> last;
+    };
+
+    /**
+     * @param engine Write connection to checkpoint through (must outlive this)
+     * @throws std::invalid_argument if restart_bytes > truncate_bytes
+     */
+    explicit CheckpointManager(SqliteEngine& engine, Options options);
+    explicit CheckpointManager(SqliteEngine& engine) : CheckpointManager(engine, Options{}) {}
+
+    CheckpointManager(const CheckpointManager&) = delete;
+    CheckpointManager& operator=(const CheckpointManager&) = delete;
+
+    /// Current size of the -wal file (0 if there is none)
+    uint64_t wal_bytes() const;
+
+    /// Mode run_idle() would use at the current WAL size
+    Mode idle_mode() const;
+
+    /**
+     * @brief Checkpoint for an idle moment, escalating with the WAL size
+     * @throws std::runtime_error on database errors
+     */
+    Result run_idle();
+
+    /**
+     * @brief Checkpoint in a given mode (e.g. kTruncate before closing)
+     * @throws std::runtime_error on database errors
+     */
+    Result checkpoint(Mode mode);
+
+    const Stats& stats() const { return stats_; }
+    const Options& options() const { return options_; }
+
+private:
+    SqliteEngine& engine_;
+    Options options_;
+    Stats stats_;
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_CHECKPOINTMANAGER_H
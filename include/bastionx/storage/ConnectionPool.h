@@ -0,0 +1,171 @@
+#ifndef BASTIONX_STORAGE_CONNECTIONPOOL_H
+#define BASTIONX_STORAGE_CONNECTIONPOOL_H
+
+#include "bastionx/crypto/SecureMemory.h"
+#include "bastionx/storage/CheckpointManager.h"
+#include "bastionx/storage/ConnectionProfile.h"
+#include "bastionx/storage/NotesRepository.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief One write connection and up to N read-only connections to a vault
+ *
+ * Each connection is a keyed SQLCipher handle with its own
+ * NotesRepository. The writer is opened up front and belongs to one thread
+ * at a time (in the UI, the storage thread of an AsyncNotesRepository).
+ * Readers are opened by the first lease that needs one, so a session that
+ * never borrows one pays for no idle connections; the pool keeps a copy of
+ * the key in secure memory for them until close(). In the UI, the
+ * AsyncNotesRepository runs lists and searches (kSnapshot requests) on
+ * leased readers.
+ * Any thread may borrow a reader with read(): the lease holds a read
+ * transaction, so in WAL mode scans, searches and exports see one
+ * snapshot of the vault while saves go on through the writer, and neither
+ * waits for the other.
+ *
+ * checkpoints() schedules WAL checkpoints through the writer.
+ *
+ * close() (VaultService::lock() via wipe_keys()) interrupts reads in
+ * progress, waits for their leases to be returned, runs a final TRUNCATE
+ * checkpoint and closes every connection. A thread must not hold a lease
+ * while closing the pool.
+ */
+class ConnectionPool {
+public:
+    /// Read-only connections opened by default
+    static constexpr size_t DEFAULT_READERS = 2;
+
+    /**
+     * @brief A reader borrowed from the pool; returns it when destroyed
+     *
+     * Readers are read-only: writes through them throw.
+     */
+    class ReadLease {
+    public:
+        ReadLease(ReadLease&& other) noexcept;
+        ReadLease& operator=(ReadLease&&) = delete;
+        ReadLease(const ReadLease&) = delete;
+        ReadLease& operator=(const ReadLease&) = delete;
+        ~ReadLease();
+
+        NotesRepository& repo() const;
+        NotesRepository* operator->() const { return &repo(); }
+
+    private:
+        friend class ConnectionPool;
+        ReadLease(ConnectionPool* pool, size_t index) : pool_(pool), index_(index) {}
+
+        ConnectionPool* pool_;
+        size_t index_;
+    };
+
+    /**
+     * @brief Open the writer; up to `readers` read-only connections open on
+     *        demand
+     * @param db_path Vault database (must already have schema, in WAL mode)
+     * @param db_key SQLCipher key for every connection
+     * @param profile Connection settings (VaultService::connection_profile())
+     * @param readers Most read-only connections (at least 1)
+     * @throws std::invalid_argument if readers is 0
+     * @throws std::runtime_error if the writer cannot be opened
+     */
+    ConnectionPool(const std::string& db_path, const crypto::SecureKey& db_key,
+                   const ConnectionProfile& profile = ConnectionProfile::balanced(),
+                   size_t readers = DEFAULT_READERS);
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    /**
+     * @brief The read-write repository (owner thread only)
+     * @throws std::runtime_error if the pool is closed
+     */
+    NotesRepository& writer();
+
+    /**
+     * @brief WAL checkpoints through the writer (owner thread only)
+     * @throws std::runtime_error if the pool is closed
+     */
+    CheckpointManager& checkpoints();
+
+    /**
+     * @brief Borrow a reader, waiting while all are in use
+     * @throws std::runtime_error if the pool is or becomes closed, or a
+     *         reader cannot be opened
+     */
+    ReadLease read();
+
+    /**
+     * @brief Borrow a reader if one is free right now
+     * @throws std::runtime_error if a reader cannot be opened
+     */
+    std::optional<ReadLease> try_read();
+
+    /**
+     * @brief Wipe what every connection has decrypted and cached
+     *        (NotesRepository::clear_caches()), keeping them open
+     *
+     * Owner thread only, with no reader leased.
+     * @throws std::runtime_error if the pool is closed
+     */
+    void clear_caches();
+
+    /**
+     * @brief Interrupt the statements leased readers are running
+     *
+     * The interrupted reads throw; the pool stays open.
+     */
+    void interrupt_reads();
+
+    /**
+     * @brief Interrupt reads, wait for leases, truncate the WAL and close
+     *        every connection (no-op if already closed)
+     */
+    void close();
+
+    bool is_open() const;
+
+    /// Most readers the pool opens
+    size_t reader_count() const;
+
+    /// Readers opened so far
+    size_t open_reader_count() const;
+
+private:
+    struct Reader {
+        SqliteEngine* engine = nullptr;          // Owned by repo; null until opened
+        std::unique_ptr<NotesRepository> repo;
+        bool leased = false;
+    };
+
+    std::string db_path_;
+    crypto::SecureKey db_key_;                   // Opens readers; wiped by close()
+    ConnectionProfile profile_;
+
+    std::unique_ptr<NotesRepository> writer_;
+    std::unique_ptr<CheckpointManager> checkpoints_;   // Uses writer_'s engine
+    std::vector<Reader> readers_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable returned_;
+    bool closed_ = false;
+
+    // With mutex_ held: a free reader's index, marked leased
+    std::optional<size_t> take_free();
+    ReadLease start_lease(size_t index);
+    void release(size_t index);
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_CONNECTIONPOOL_H
@@ -0,0 +1,107 @@
+#ifndef BASTIONX_STORAGE_CONNECTIONPROFILE_H
+#define BASTIONX_STORAGE_CONNECTIONPROFILE_H
+
+#include <sqlcipher/sqlite3.h>
+#include <cstdint>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief SQLCipher and SQLite settings applied to every vault connection
+ *
+ * Two kinds of settings:
+ *
+ * - Connection settings (memory security, synchronous, cache size, temp
+ *   store, secure delete) only affect the connection they are applied to
+ *   and may differ between opens. The note cache budget is applied by
+ *   ConnectionPool to its writer's NotesRepository.
+ * - File format settings (cipher_page_size, kdf_iter) are fixed when the
+ *   vault is created: every connection must use the values the file was
+ *   written with or it cannot be read. VaultService records them next to
+ *   the salt and applies them whatever preset it was given.
+ *
+ * Every profile uses WAL: VaultBackup relies on its long read not blocking
+ * saves. SQLCipher's cipher_memory_security is process-wide; the last
+ * connection opened decides it.
+ *
+ * bastionx_bench ConnectionProfile measures list, search and save latency
+ * for each preset.
+ */
+struct ConnectionProfile {
+    enum class Synchronous { kOff = 0, kNormal = 1, kFull = 2 };
+
+    // === Connection Settings ===
+
+    /// Wipe and lock every allocation SQLCipher makes (costly on hot paths)
+    bool memory_security = true;
+    /// kNormal is durable up to the last checkpoint in WAL mode
+    Synchronous synchronous = Synchronous::kNormal;
+    /// Page cache per connection
+    int cache_size_kib = 8 * 1024;
+    /// Keep temporary tables and indexes in memory, never in plaintext files
+    bool temp_store_memory = true;
+    /// Overwrite deleted content with zeros
+    bool secure_delete = false;
+    /// Decrypted notes the pool's writer keeps in locked memory (0 = none)
+    int note_cache_kib = 4 * 1024;
+    /// How long a statement retries while another connection (the storage
+    /// thread, maintenance, a backup, settings) holds the write lock
+    int busy_timeout_ms = 5000;
+
+    // === File Format (fixed at vault creation) ===
+
+    int cipher_page_size = 4096;
+    /// PBKDF2 rounds over the key; the key is already an Argon2id-derived
+    /// subkey, so these only delay every open
+    int kdf_iter = 256000;
+
+    /**
+     * @brief Memory security, full sync, secure delete, no note cache;
+     *        SQLCipher's format
+     */
+    static ConnectionProfile paranoid();
+
+    /**
+     * @brief The default: memory security, normal sync in WAL, 8 MiB cache,
+     *        4 MiB note cache; SQLCipher's format (that of every vault created before profiles)
+     */
+    static ConnectionProfile balanced();
+
+    /**
+     * @brief No memory security, 32 MiB cache, 16 MiB note cache, 16 KiB
+     *        pages, a single KDF round
+     */
+    static ConnectionProfile throughput();
+
+    /// File format of vaults that predate profiles (SQLCipher 4 defaults)
+    static ConnectionProfile legacy_format() { return balanced(); }
+
+    /// Whether files written with `other` can be read with this profile
+    bool same_format(const ConnectionProfile& other) const {
+        return cipher_page_size == other.cipher_page_size && kdf_iter == other.kdf_iter;
+    }
+
+    /// This profile's connection settings with `other`'s file format
+    ConnectionProfile with_format_of(const ConnectionProfile& other) const {
+        ConnectionProfile profile = *this;
+        profile.cipher_page_size = other.cipher_page_size;
+        profile.kdf_iter = other.kdf_iter;
+        return profile;
+    }
+
+    /**
+     * @brief Apply to a connection right after sqlite3_key() (or open)
+     *
+     * The file format settings must precede the first read, and are
+     * skipped on unkeyed connections.
+     * @throws std::runtime_error if a statement fails, including the first
+     *         read with a wrong key
+     */
+    void apply(sqlite3* db, bool keyed) const;
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_CONNECTIONPROFILE_H
@@ -0,0 +1,48 @@
+#ifndef BASTIONX_STORAGE_CONTENTCHUNKER_H
+#define BASTIONX_STORAGE_CONTENTCHUNKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Content-defined chunking of note bodies (FastCDC-style gear hash)
+ *
+ * A boundary is placed where a rolling hash of the preceding ~64 bytes
+ * matches a mask, so boundaries depend on local content rather than on
+ * offsets. An edit moves only the boundaries next to it: the text before
+ * and after splits into the same chunks as before, and a save only has to
+ * write the chunks that actually changed.
+ *
+ * Normalized chunking keeps sizes between kMinChunkBytes and kMaxChunkBytes,
+ * clustered around kAvgChunkBytes. Boundaries are a pure function of the
+ * bytes; the gear table is fixed so they stay stable across versions.
+ */
+class ContentChunker {
+public:
+    static constexpr size_t kMinChunkBytes = 4 * 1024;
+    static constexpr size_t kAvgChunkBytes = 16 * 1024;
+    static constexpr size_t kMaxChunkBytes = 64 * 1024;
+
+    /**
+     * @brief Length of the first chunk of `data`
+     * @return Boundary offset in (0, kMaxChunkBytes]; data.size() if shorter
+     *         than kMinChunkBytes
+     */
+    static size_t next_boundary(std::span<const uint8_t> data);
+
+    /**
+     * @brief Split `data` into consecutive chunks
+     * @return Chunk lengths, summing to data.size() (empty for empty input)
+     */
+    static std::vector<size_t> split(std::span<const uint8_t> data);
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_CONTENTCHUNKER_H
@@ -0,0 +1,195 @@
+#ifndef BASTIONX_STORAGE_LOGENGINE_H
+#define BASTIONX_STORAGE_LOGENGINE_H
+
+#include "bastionx/crypto/SecureMemory.h"
+#include "bastionx/storage/StorageEngine.h"
+#include <array>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Append-only StorageEngine for write-heavy (autosave) workloads
+ *
+ * Every put or erase is appended to the newest segment file in a
+ * directory; nothing is rewritten in place. An in-memory index maps each
+ * key to the offset of its latest record. Each record is encrypted
+ * separately with the database key, bound to its segment and offset:
+ *
+ * ```
+ * frame:  length (4) | alg (1) | nonce (24) | ciphertext
+ * AAD:    "BXLOGRv1" || segment_id (8 bytes LE) || offset (8 bytes LE)
+ * ```
+ *
+ * A segment is sealed once it reaches `segment_bytes`, or on close. Sealing
+ * appends a footer record listing the segment's entries and a fixed
+ * trailer pointing at it, so opening a vault reads footers, not every
+ * record. The unsealed segment left by a crash is scanned instead. Writes
+ * after its last committed record (a torn frame or an unfinished
+ * transaction) are cut off.
+ *
+ * Overwritten and erased records stay on disk until compaction. Compaction
+ * copies the live records of the oldest segment to the head of the log,
+ * then deletes that segment. It always takes the oldest segment, so the
+ * erase markers it drops never hide an older record. A background thread
+ * compacts whenever dead records pass `garbage_ratio` of the sealed bytes.
+ *
+ * Only one engine may have a directory open at a time. Commits are flushed
+ * to the OS, but not fsync'd: they survive a process crash, and a power
+ * loss can lose the newest commits without corrupting older ones. Before
+ * compaction deletes a segment, every newer segment and the directory are
+ * fsync'd, so a power loss never takes the copies with the original.
+ */
+class LogEngine : public StorageEngine {
+public:
+    struct Options {
+        size_t segment_bytes = 4 * 1024 * 1024;  ///< Seal a segment past this size
+        double garbage_ratio = 0.5;              ///< Compact above this dead share
+        bool background_compaction = true;       ///< Off: compact() only
+    };
+
+    /**
+     * @brief Disk use of the log
+     */
+    struct LogStats {
+        size_t segments = 0;
+        uint64_t disk_bytes = 0;      ///< All segment files
+        uint64_t live_bytes = 0;      ///< Records the index still points at
+        uint64_t appended_bytes = 0;  ///< Written by this engine since open
+    };
+
+    /**
+     * @brief Open (or create) the log in directory `dir`
+     * @param key Database key; every record is encrypted with it
+     * @throws std::runtime_error if the directory cannot be used, or a
+     *         sealed segment fails authentication
+     */
+    LogEngine(const std::string& dir, const crypto::SecureKey& key);
+    LogEngine(const std::string& dir, const crypto::SecureKey& key, const Options& options);
+    ~LogEngine() override;
+
+    LogEngine(const LogEngine&) = delete;
+    LogEngine& operator=(const LogEngine&) = delete;
+
+    void begin() override;
+    void commit() override;
+    void rollback() override;
+
+    std::optional<Row> get(Table table, const RowKey& key,
+                           const Projection& columns = {}) override;
+    void put(Table table, const RowKey& key, const Row& row) override;
+    int64_t insert(Table table, const Row& row) override;
+    bool erase(Table table, const RowKey& key) override;
+    size_t erase_range(Table table, const KeyRange& range) override;
+    void scan(Table table, const KeyRange& range, const Visitor& visit,
+              const Projection& columns = {},
+              ScanOrder order = ScanOrder::kAscending) override;
+    uint64_t count_matching(Table table, size_t column, int64_t value) override;
+    void scan_by(Table table, size_t column, const Visitor& visit,
+                 const Projection& columns = {},
+                 ScanOrder order = ScanOrder::kAscending) override;
+    void scan_subkey(Table table, int64_t b, const Visitor& visit,
+                     const Projection& columns = {}) override;
+    TableUsage usage(Table table, size_t blob_column) override;
+
+    void close() override;
+    bool is_open() const override;
+
+    /**
+     * @brief Compact until dead records are below `garbage_ratio` of the
+     *        sealed bytes (or there is nothing left to compact)
+     * @return Segments removed
+     */
+    size_t compact();
+
+    LogStats stats() const;
+
+private:
+    struct Location {
+        uint64_t segment = 0;
+        uint64_t offset = 0;
+        uint32_t length = 0;  ///< Whole frame
+    };
+
+    // One put or erase in a segment, in log order (footer contents)
+    struct Entry {
+        uint8_t kind = 0;
+        Table table = Table::kNotes;
+        RowKey key;
+        Location location;
+    };
+
+    struct Segment {
+        uint64_t id = 0;
+        std::string path;
+        std::fstream file;
+        uint64_t size = 0;  ///< Append position
+        uint64_t live = 0;  ///< Bytes of records the index points at
+        bool sealed = false;
+        bool synced = false;  ///< fsync'd since the last append
+    };
+
+    struct Undo {
+        Table table;
+        RowKey key;
+        std::optional<Location> before;
+    };
+
+    std::string dir_;
+    crypto::SecureKey key_;
+    Options options_;
+
+    mutable std::recursive_mutex mutex_;
+    bool open_ = false;
+    std::map<uint64_t, std::unique_ptr<Segment>> segments_;
+    std::array<std::map<RowKey, Location>, kTableCount> index_;
+    std::array<int64_t, kTableCount> last_id_{};
+    std::vector<Entry> entries_;  ///< Committed entries of the active segment
+    uint64_t appended_bytes_ = 0;
+
+    bool in_transaction_ = false;
+    std::vector<Entry> pending_;  ///< Entries of the open transaction
+    std::vector<Undo> undo_;
+
+    std::thread compactor_;
+    std::condition_variable_any wake_;
+    bool stopping_ = false;
+
+    Segment& active();
+    void require_open() const;
+
+    // Segment files
+    void load();
+    void open_segment(uint64_t id);
+    void seal_active();
+    void roll_if_full();
+    bool load_footer(Segment& segment);
+    void replay(Segment& segment, bool last);
+
+    // Records
+    Location append(uint8_t kind, bool commits, std::span<const uint8_t> body);
+    std::optional<std::vector<uint8_t>> read(const Location& location);
+    Row read_row(Table table, const Location& location);
+    void write_entry(uint8_t kind, Table table, const RowKey& key, const Row* row);
+    void apply(const Entry& entry);
+    void flush();
+    void sync_segments();
+
+    // Compaction
+    bool needs_compaction() const;
+    bool compact_oldest();
+    void compaction_loop();
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_LOGENGINE_H
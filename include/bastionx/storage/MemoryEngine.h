@@ -0,0 +1,87 @@
+#ifndef BASTIONX_STORAGE_MEMORYENGINE_H
+#define BASTIONX_STORAGE_MEMORYENGINE_H
+
+#include "bastionx/storage/StorageEngine.h"
+#include <array>
+#include <map>
+#include <memory>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief StorageEngine keeping every table in a std::map, for tests and
+ *        benchmarks
+ *
+ * Nothing is persisted. The tables live in a Store that engines can share,
+ * so a repository reopened on the same Store sees what an earlier one
+ * wrote, as it would reopening the same database file. Only one engine
+ * may have a transaction open on a Store at a time.
+ *
+ * Like the SQLite backend it holds only the repository's ciphertext; there
+ * is no at-rest encryption of the whole database on top.
+ */
+class MemoryEngine : public StorageEngine {
+public:
+    /**
+     * @brief The tables (one map per Table) and their last assigned keys
+     */
+    struct Store {
+        std::array<std::map<RowKey, Row>, kTableCount> tables;
+        std::array<int64_t, kTableCount> last_id{};
+    };
+
+    /// Engine over a new, empty Store
+    MemoryEngine();
+
+    /// Engine over an existing Store
+    explicit MemoryEngine(std::shared_ptr<Store> store);
+
+    std::shared_ptr<Store> store() const { return store_; }
+
+    void begin() override;
+    void commit() override;
+    void rollback() override;
+
+    std::optional<Row> get(Table table, const RowKey& key,
+                           const Projection& columns = {}) override;
+    void put(Table table, const RowKey& key, const Row& row) override;
+    int64_t insert(Table table, const Row& row) override;
+    bool erase(Table table, const RowKey& key) override;
+    size_t erase_range(Table table, const KeyRange& range) override;
+    void scan(Table table, const KeyRange& range, const Visitor& visit,
+              const Projection& columns = {},
+              ScanOrder order = ScanOrder::kAscending) override;
+    uint64_t count_matching(Table table, size_t column, int64_t value) override;
+    void scan_by(Table table, size_t column, const Visitor& visit,
+                 const Projection& columns = {},
+                 ScanOrder order = ScanOrder::kAscending) override;
+    void scan_subkey(Table table, int64_t b, const Visitor& visit,
+                     const Projection& columns = {}) override;
+    TableUsage usage(Table table, size_t blob_column) override;
+
+    void close() override;
+    bool is_open() const override;
+
+private:
+    std::shared_ptr<Store> store_;
+    bool in_transaction_ = false;
+
+    // Prior state of each row written in the open transaction, oldest first
+    struct Undo {
+        Table table;
+        RowKey key;
+        std::optional<Row> before;
+    };
+    std::vector<Undo> undo_;
+
+    std::map<RowKey, Row>& rows(Table table);
+
+    // Record the row's current state before it changes
+    void remember(Table table, const RowKey& key);
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_MEMORYENGINE_H
@@ -0,0 +1,118 @@
+#ifndef BASTIONX_STORAGE_NOTECACHE_H
+#define BASTIONX_STORAGE_NOTECACHE_H
+
+#include "bastionx/crypto/SecureAllocator.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief LRU cache of decrypted note records under a byte budget
+ *
+ * Holds each note as its serialized record (NoteRecord, version 2) in a
+ * SecureBytes buffer, so cached plaintext stays in locked memory and is
+ * wiped when evicted, erased or cleared. Rebuilding a Note from a record
+ * is a copy out of the buffer; the SQLite read, the AEAD decrypt and any
+ * decompression are skipped.
+ *
+ * - Entries are charged their record size against the budget; the least
+ *   recently used go first once it is exceeded
+ * - A record larger than a quarter of the budget is not cached
+ * - A budget of 0 disables the cache
+ *
+ * NotesRepository owns one and invalidates entries on every write. Not
+ * thread-safe: it belongs to the thread that owns its repository.
+ */
+class NoteCache {
+public:
+    /**
+     * @brief A cached note: its record and the timestamps kept beside it
+     */
+    struct Entry {
+        crypto::SecureBytes record;
+        int64_t created_at = 0;
+        int64_t updated_at = 0;
+    };
+
+    /**
+     * @brief Cache counters (snapshot)
+     */
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;      ///< Dropped to stay within the budget
+        uint64_t invalidations = 0;  ///< Dropped by a write or delete
+        size_t entries = 0;
+        size_t bytes = 0;            ///< Record bytes held
+        size_t budget_bytes = 0;
+
+        /// hits / (hits + misses), 0 before any lookup
+        double hit_rate() const {
+            uint64_t lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+    };
+
+    explicit NoteCache(size_t budget_bytes = 0);
+
+    NoteCache(const NoteCache&) = delete;
+    NoteCache& operator=(const NoteCache&) = delete;
+
+    /**
+     * @brief Change the budget, evicting down to it (0 clears and disables)
+     */
+    void set_budget(size_t budget_bytes);
+    size_t budget() const { return budget_bytes_; }
+    bool enabled() const { return budget_bytes_ > 0; }
+
+    /**
+     * @brief The note's entry, now most recently used; nullptr on a miss
+     *
+     * The pointer is valid until the next call that modifies the cache.
+     */
+    const Entry* find(int64_t note_id);
+
+    /// Whether the note is cached (not counted as a lookup, order unchanged)
+    bool contains(int64_t note_id) const { return index_.count(note_id) > 0; }
+
+    /**
+     * @brief Insert or replace a note's entry
+     * @return false if the record is too large to cache (or the cache is off)
+     */
+    bool put(int64_t note_id, Entry entry);
+
+    /**
+     * @brief Drop a note's entry (after it was written or deleted)
+     */
+    void erase(int64_t note_id);
+
+    /**
+     * @brief Wipe and drop every entry (counters are kept)
+     */
+    void clear();
+
+    Stats stats() const;
+
+private:
+    struct Node {
+        int64_t note_id = 0;
+        Entry entry;
+    };
+
+    // Evict least recently used entries until `incoming` more bytes fit
+    void make_room(size_t incoming);
+
+    size_t budget_bytes_;
+    std::list<Node> lru_;  // Most recently used first
+    std::unordered_map<int64_t, std::list<Node>::iterator> index_;
+    Stats stats_;
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_NOTECACHE_H
@@ -0,0 +1,120 @@
+#ifndef BASTIONX_STORAGE_NOTECOMPRESSOR_H
+#define BASTIONX_STORAGE_NOTECOMPRESSOR_H
+
+#include "bastionx/crypto/SecureAllocator.h"
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <vector>
+
+// zstd handles (opaque here; see <zstd.h>)
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Payload codec recorded per note record (`notes.codec`)
+ *
+ * Compression is applied to the serialized note before encryption. A zstd
+ * frame records the ID of the dictionary it was compressed with (0 = none),
+ * so one codec value covers both cases.
+ */
+enum class Codec : uint8_t {
+    kNone = 0,  ///< Payload stored as serialized
+    kZstd = 1   ///< zstd frame, optionally against a trained dictionary
+};
+
+/**
+ * @brief zstd compression of note payloads with optional trained dictionaries
+ *
+ * Small notes compress poorly on their own, so a dictionary is trained from
+ * the vault's own payloads (ZDICT) and stored encrypted in the vault by
+ * NotesRepository. Several dictionaries can be loaded (older records keep
+ * referencing the dictionary they were written with); new payloads use the
+ * most recently added one.
+ *
+ * All zstd contexts and dictionaries are allocated with sodium_malloc(), so
+ * window buffers holding plaintext are locked and wiped on release.
+ *
+ * Not thread-safe: one compression and one decompression context are reused.
+ */
+class NoteCompressor {
+public:
+    /// zstd compression level for note payloads
+    static constexpr int kLevel = 3;
+
+    /// Target size of a trained dictionary
+    static constexpr size_t kDictionaryBytes = 16 * 1024;
+
+    /// Upper bound on a decompressed payload (rejects decompression bombs)
+    static constexpr size_t kMaxPayloadBytes = 64 * 1024 * 1024;
+
+    NoteCompressor();
+    ~NoteCompressor();
+
+    NoteCompressor(const NoteCompressor&) = delete;
+    NoteCompressor& operator=(const NoteCompressor&) = delete;
+
+    /**
+     * @brief Compress a payload (against the active dictionary, if any)
+     * @return zstd frame in locked memory, or nullopt if compression would not
+     *         make the payload smaller (store it with Codec::kNone)
+     */
+    std::optional<crypto::SecureBytes> compress(std::span<const uint8_t> payload);
+
+    /**
+     * @brief Decompress a zstd frame produced by compress()
+     * @return Payload in locked memory, or nullopt if the frame is malformed,
+     *         references an unloaded dictionary, or exceeds kMaxPayloadBytes
+     */
+    std::optional<crypto::SecureBytes> decompress(std::span<const uint8_t> frame);
+
+    /**
+     * @brief Load a dictionary and make it the one used by compress()
+     * @param dictionary Dictionary from train_dictionary()
+     * @return The dictionary's ID (as recorded in zstd frames)
+     * @throws std::invalid_argument if the buffer is not a zstd dictionary
+     */
+    uint32_t add_dictionary(std::span<const uint8_t> dictionary);
+
+    /// ID of the dictionary compress() uses (0 = none)
+    uint32_t active_dictionary_id() const { return active_id_; }
+
+    /// Drop all dictionaries (compress() reverts to plain zstd)
+    void clear_dictionaries();
+
+    /**
+     * @brief Train a dictionary from sample payloads (ZDICT_trainFromBuffer)
+     * @param samples Serialized note payloads
+     * @param dictionary_bytes Maximum dictionary size
+     * @return Dictionary in locked memory
+     * @throws std::runtime_error if training fails (e.g. too few samples)
+     */
+    static crypto::SecureBytes train_dictionary(
+        const std::vector<crypto::SecureBytes>& samples,
+        size_t dictionary_bytes = kDictionaryBytes);
+
+    /// Dictionary ID stored in a zstd dictionary buffer (0 if not a dictionary)
+    static uint32_t dictionary_id(std::span<const uint8_t> dictionary);
+
+private:
+    struct Dictionary {
+        ZSTD_CDict_s* cdict = nullptr;
+        ZSTD_DDict_s* ddict = nullptr;
+    };
+
+    ZSTD_CCtx_s* cctx_ = nullptr;
+    ZSTD_DCtx_s* dctx_ = nullptr;
+    std::map<uint32_t, Dictionary> dictionaries_;
+    uint32_t active_id_ = 0;
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_NOTECOMPRESSOR_H
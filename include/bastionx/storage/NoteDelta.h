@@ -0,0 +1,55 @@
+#ifndef BASTIONX_STORAGE_NOTEDELTA_H
+#define BASTIONX_STORAGE_NOTEDELTA_H
+
+#include "bastionx/crypto/SecureAllocator.h"
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Binary diff between two serialized note records
+ *
+ * A delta rebuilds `target` from `base` with copy and insert operations.
+ * Blocks of kBlockBytes of the base are indexed by a rolling hash, so text
+ * moved, inserted or deleted anywhere in the note costs only the changed
+ * bytes plus a few bytes per edit. Integers are unsigned LEB128 varints:
+ *
+ * ```
+ * version (1 byte, = 1) | target length | op*
+ * op = (length << 1 | 1) | base offset      copy from base
+ *    | (length << 1)     | length bytes     insert literal bytes
+ * ```
+ *
+ * Used for note revision history, where each stored revision is the delta
+ * from the next newer version back to it.
+ */
+class NoteDelta {
+public:
+    static constexpr uint8_t kVersion = 1;
+
+    /// Shortest run of the base a copy is looked up for
+    static constexpr size_t kBlockBytes = 16;
+
+    /**
+     * @brief Delta that turns `base` into `target`
+     * @return Delta in locked memory
+     */
+    static crypto::SecureBytes encode(std::span<const uint8_t> base,
+                                      std::span<const uint8_t> target);
+
+    /**
+     * @brief Rebuild the target of `delta` from `base`
+     * @return Target in locked memory, or nullopt if the delta is malformed
+     *         or does not fit `base`
+     */
+    static std::optional<crypto::SecureBytes> apply(std::span<const uint8_t> base,
+                                                    std::span<const uint8_t> delta);
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_NOTEDELTA_H
@@ -0,0 +1,111 @@
+#ifndef BASTIONX_STORAGE_NOTEEXPORTER_H
+#define BASTIONX_STORAGE_NOTEEXPORTER_H
+
+#include "bastionx/crypto/SecureMemory.h"
+#include "bastionx/storage/NotesRepository.h"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief One change read back from an export archive
+ */
+struct ExportEntry {
+    int64_t seq = 0;                     ///< Change-log sequence number
+    int64_t note_id = 0;
+    bool deleted = false;                ///< Tombstone; `note` is empty
+    std::optional<Note> note;            ///< The note as of this change
+};
+
+/**
+ * @brief Incremental, encrypted export of changed notes to a directory
+ *
+ * Each export_changes() call writes the notes created, updated or deleted
+ * since the previous export into a new archive, then advances a watermark
+ * (the last change-log sequence number exported) stored beside the
+ * archives. Only the change log after the watermark is read, so an export
+ * costs time in the number of changes, not in the size of the vault.
+ *
+ * Archives are named "changes-<from>-<to>.bxexp" (sequence numbers,
+ * zero-padded so names sort in order) and hold a crypto_secretstream under
+ * the export key (VaultService::export_key()): one message per note or
+ * tombstone, then a final message with the counts. Messages cannot be
+ * reordered, dropped or truncated, and the header is bound to every message
+ * as associated data, so an archive cannot be passed off as another range.
+ *
+ * The archive is written to a ".part" file and renamed before the watermark
+ * is replaced (also by rename), so after a crash the watermark never points
+ * past an archive on disk; at worst the next export repeats some changes.
+ *
+ * Not thread-safe; uses the repository's engine like any other caller.
+ * It only reads the repository, so it can run on a pool reader (a kSnapshot
+ * request to AsyncNotesRepository) and export one snapshot of the vault.
+ */
+class NoteExporter {
+public:
+    /// File extension of export archives
+    static constexpr const char* kArchiveExtension = ".bxexp";
+
+    struct Result {
+        size_t notes = 0;                ///< Notes written
+        size_t deletions = 0;            ///< Tombstones written
+        std::string archive;             ///< Empty when nothing had changed
+        int64_t watermark = 0;           ///< Watermark after this export
+    };
+
+    using Visitor = std::function<void(const ExportEntry&)>;
+
+    /**
+     * @param repo Repository to export from
+     * @param export_dir Directory for archives and the watermark (created
+     *                   on first export)
+     */
+    NoteExporter(NotesRepository& repo, std::string export_dir);
+
+    /**
+     * @brief Last sequence number exported to this directory (0 if none)
+     * @throws std::runtime_error if the watermark file is unreadable
+     */
+    int64_t watermark() const;
+
+    /**
+     * @brief Export the changes since the watermark and advance it
+     * @param notes_subkey Subkey the notes are encrypted under
+     * @param export_key Archive key (32 bytes)
+     * @throws std::runtime_error on I/O errors (the watermark is unchanged)
+     */
+    Result export_changes(const crypto::SecureKey& notes_subkey,
+                          const crypto::SecureKey& export_key);
+
+    /**
+     * @brief Archives in the export directory, oldest first
+     */
+    std::vector<std::string> archives() const;
+
+    /**
+     * @brief Decrypt an archive, passing each entry to `visit` in order
+     *
+     * Entries are authenticated one at a time as they are read; a truncated
+     * or modified archive throws once the damage is reached.
+     * @throws std::runtime_error if the archive is malformed, truncated or
+     *         fails authentication
+     */
+    static void read_archive(const std::string& path, const crypto::SecureKey& export_key,
+                             const Visitor& visit);
+
+private:
+    NotesRepository& repo_;
+    std::string export_dir_;
+
+    void store_watermark(int64_t watermark);
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_NOTEEXPORTER_H
@@ -0,0 +1,63 @@
+#ifndef BASTIONX_STORAGE_NOTEPACK_H
+#define BASTIONX_STORAGE_NOTEPACK_H
+
+#include "bastionx/crypto/SecureAllocator.h"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Plaintext layout of a cold-storage pack (many note records in one)
+ *
+ * A pack is compressed and encrypted as a single record in note_packs, so
+ * old notes share one nonce, MAC and B-tree row and compress against each
+ * other. All integers are little-endian:
+ *
+ * ```
+ * off  size  field
+ *  0    1    version (= 1)
+ *  1    3    reserved (0)
+ *  4    4    count
+ *  8         count x (note_id (8) | length (4)) | payloads, back to back
+ * ```
+ *
+ * Each payload is a serialized NoteRecord, exactly as it would be stored
+ * (uncompressed) in a notes row.
+ */
+class NotePack {
+public:
+    static constexpr uint8_t kVersion = 1;
+    static constexpr size_t kHeaderBytes = 8;
+    static constexpr size_t kEntryBytes = 12;
+
+    /**
+     * @brief One note in a pack; `payload` points into the pack buffer
+     * (decode) or the caller's buffer (encode)
+     */
+    struct Entry {
+        int64_t note_id = 0;
+        std::span<const uint8_t> payload;
+    };
+
+    /**
+     * @brief Encode entries into a pack
+     * @return Pack in locked memory
+     * @throws std::invalid_argument if a payload exceeds 4 GiB
+     */
+    static crypto::SecureBytes encode(const std::vector<Entry>& entries);
+
+    /**
+     * @brief Decode a pack's index
+     * @return Entries in pack order, or nullopt if the pack is malformed
+     */
+    static std::optional<std::vector<Entry>> decode(std::span<const uint8_t> pack);
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_NOTEPACK_H
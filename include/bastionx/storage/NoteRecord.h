@@ -0,0 +1,117 @@
+#ifndef BASTIONX_STORAGE_NOTERECORD_H
+#define BASTIONX_STORAGE_NOTERECORD_H
+
+#include "bastionx/crypto/SecureAllocator.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Binary plaintext layout of a note record (format version 2)
+ *
+ * Replaces the version-1 JSON payload. All integers are little-endian:
+ *
+ * ```
+ * off  size  field
+ *  0    1    version (= 2; JSON records start with '{')
+ *  1    1    flags (bit 0: body stored in chunks; bit 1: chunk manifest follows)
+ *  2    2    tag_count
+ *  4    4    title_len
+ *  8    4    tags_len      (bytes of the tags section)
+ * 12    4    preview_len   (<= kPreviewBytes)
+ * 16    8    body_bytes
+ * 24    8    body_chunks   (0 = body inline)
+ * 32         title | tags (u16 len + bytes, each) | preview | body or manifest
+ * ```
+ *
+ * The preview is the body's first kPreviewBytes bytes, cut back to a UTF-8
+ * code point boundary, so list views can decode the header alone and never
+ * touch the body (or its chunks).
+ *
+ * A chunked body is either a content-defined chunk list (the manifest:
+ * body_chunks ChunkRef entries of kChunkRefBytes) or, for records written
+ * before content-defined chunking, a secretstream in note_chunks (no
+ * manifest; read-only).
+ */
+class NoteRecord {
+public:
+    static constexpr uint8_t kVersion = 2;
+    static constexpr size_t kHeaderBytes = 32;
+
+    /// Body bytes copied into the preview field
+    static constexpr size_t kPreviewBytes = 128;
+
+    /// Flag bit: body is stored outside the record
+    static constexpr uint8_t kFlagChunked = 0x01;
+
+    /// Flag bit: a content-defined chunk manifest follows the preview
+    static constexpr uint8_t kFlagManifest = 0x02;
+
+    /// BLAKE2b digest size identifying a chunk's plaintext
+    static constexpr size_t kChunkHashBytes = 32;
+
+    /**
+     * @brief One content-defined chunk of a body, in body order
+     */
+    struct ChunkRef {
+        uint64_t chunk_id = 0;                          ///< content_chunks row (per note)
+        uint32_t size = 0;                              ///< Plaintext bytes
+        std::array<uint8_t, kChunkHashBytes> hash{};    ///< BLAKE2b-256 of the plaintext
+    };
+
+    /// Encoded size of a ChunkRef: chunk_id (8) | size (4) | hash (32)
+    static constexpr size_t kChunkRefBytes = 8 + 4 + kChunkHashBytes;
+
+    /**
+     * @brief Decoded record; views point into the buffer passed to decode()
+     */
+    struct View {
+        std::string_view title;
+        std::vector<std::string_view> tags;
+        std::string_view preview;
+        uint64_t body_bytes = 0;
+        uint64_t body_chunks = 0;          ///< 0 = body inline
+        std::string_view body;             ///< Empty when chunked or header-only
+        std::vector<ChunkRef> chunks;      ///< Manifest (empty if none or header-only)
+    };
+
+    /**
+     * @brief Encode a note
+     * @param body Full body; only its size and preview are stored when
+     *             `chunks` is non-empty
+     * @param chunks Manifest of the chunks holding the body (empty = inline)
+     * @return Record in locked memory
+     * @throws std::invalid_argument if a field exceeds its length prefix or
+     *         the chunk sizes do not add up to the body
+     */
+    static crypto::SecureBytes encode(std::string_view title,
+                                      const std::vector<std::string>& tags,
+                                      std::string_view body,
+                                      std::span<const ChunkRef> chunks = {});
+
+    /**
+     * @brief Decode a record
+     * @param record Record bytes (with header_only, may end after the preview)
+     * @param header_only Skip the body; View::body is left empty
+     * @return View, or nullopt if the record is malformed or not version 2
+     */
+    static std::optional<View> decode(std::span<const uint8_t> record,
+                                      bool header_only = false);
+
+    /// Whether `record` is in this format (as opposed to version-1 JSON)
+    static bool is_binary(std::span<const uint8_t> record) {
+        return !record.empty() && record[0] == kVersion;
+    }
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_NOTERECORD_H
@@ -3,10 +3,27 @@
 
 #include "bastionx/crypto/CryptoService.h"
 #include "bastionx/crypto/SecureMemory.h"
-#include <sqlcipher/sqlite3.h>
+#include "bastionx/crypto/SecureAllocator.h"
+#include "bastionx/storage/ConnectionProfile.h"
+#include "bastionx/storage/ContentChunker.h"
+#include "bastionx/storage/NoteCache.h"
+#include "bastionx/storage/NoteCompressor.h"
+#include "bastionx/storage/NoteDelta.h"
+#include "bastionx/storage/NotePack.h"
+#include "bastionx/storage/NoteRecord.h"
+#include "bastionx/storage/StorageEngine.h"
 #include <string>
 #include <vector>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <functional>
+#include <array>
 #include <optional>
+#include <span>
+#include <string_view>
 #include <cstdint>
 
 namespace bastionx {
@@ -14,11 +31,14 @@ namespace storage {
 
 /**
  * @brief Decrypted note representation (in memory only, never persisted as plaintext)
+ *
+ * Title and body live in locked memory (SecureString) from decryption until
+ * the Note is destroyed, at which point their storage is wiped.
  */
 struct Note {
     int64_t id = 0;                      ///< DB primary key (0 = unsaved)
-    std::string title;
-    std::string body;
+    crypto::SecureString title;
+    crypto::SecureString body;
     std::vector<std::string> tags;
     int64_t created_at = 0;              ///< UNIX timestamp
     int64_t updated_at = 0;              ///< UNIX timestamp
@@ -36,13 +56,75 @@ struct NoteSummary {
 };
 
 /**
- * @brief Encrypted CRUD operations for notes backed by SQLite
+ * @brief An earlier version of a note, as listed in its history
+ */
+struct NoteRevision {
+    int64_t revision_id = 0;             ///< Increases with each recorded version
+    int64_t saved_at = 0;                ///< updated_at of that version
+    bool keyframe = false;               ///< Stored whole rather than as a delta
+    uint64_t stored_bytes = 0;           ///< Ciphertext size
+};
+
+/**
+ * @brief The newest change to a note, as kept in the change log
+ */
+struct NoteChange {
+    int64_t seq = 0;                     ///< Increases with every save and delete
+    int64_t note_id = 0;
+    bool deleted = false;                ///< Tombstone: the note was deleted
+};
+
+/**
+ * @brief Encrypted CRUD operations for notes over a StorageEngine
+ *
+ * NotesRepository owns a storage engine (by default a SqliteEngine on the
+ * vault database) and provides create/read/update/delete operations on
+ * encrypted notes. It only ever hands the engine ciphertext.
  *
- * NotesRepository owns a persistent SQLite connection and provides
- * create/read/update/delete operations on encrypted notes.
+ * All note payloads are serialized as NoteRecord (a length-prefixed binary
+ * layout; version-1 JSON records are still read and are converted when
+ * rewritten), encrypted using CryptoService, and stored as blob columns. Each row records
+ * its AEAD (`alg`); writes use CryptoService::preferred_algorithm().
  *
- * All note payloads are serialized to JSON (via nlohmann-json), encrypted
- * using CryptoService, and stored as BLOB columns in SQLite.
+ * Payloads are zstd-compressed before encryption (`codec`), against a
+ * dictionary trained from the vault's own notes once there are enough of
+ * them (ensure_compression_dictionary()). Dictionaries are stored encrypted
+ * under the notes subkey in compression_dicts.
+ *
+ * Bodies of kChunkedBodyThresholdBytes or more are split at content-defined
+ * boundaries (ContentChunker) and each chunk is encrypted as its own row in
+ * content_chunks. The note record lists the chunks with their BLAKE2b
+ * hashes, so a save re-encrypts and writes only chunks whose content
+ * changed. Loading never holds more than one chunk of ciphertext at a time.
+ * Bodies written before that as a crypto_secretstream in note_chunks are
+ * still read, and move to content_chunks when next saved.
+ *
+ * Notes untouched for a long time can be moved into cold-storage packs
+ * (pack_cold_notes()): many records compressed and encrypted together as
+ * one note_packs row (NotePack). Their notes rows keep only ID, pack ID and
+ * timestamps. Packed notes read, list and search like any other, through a
+ * small cache of decompressed packs; saving one moves it back to its row.
+ *
+ * update_note() keeps the version it replaces in note_revisions as a
+ * reverse delta (NoteDelta) against the next newer version, with a full
+ * keyframe every kRevisionKeyframeInterval revisions so a rebuild applies
+ * few deltas. Chunked bodies are kept by manifest: chunk rows a revision
+ * still references stay (marked released_by that revision) until it is
+ * pruned. Saves within kRevisionCoalesceSeconds of the newest revision
+ * fold into it. RevisionPolicy bounds how many revisions are kept, and for
+ * how long.
+ *
+ * Every create, update and delete also moves the note to the end of a
+ * change log (note_changes, keyed by a sequence number), replacing its
+ * previous entry; deletes leave a tombstone. changes_since() reads the log
+ * from a watermark for incremental export (NoteExporter).
+ *
+ * read_note() and read_note_streamed() can serve notes from a NoteCache of
+ * decrypted records in locked memory (off unless set_note_cache_budget()
+ * gives it a budget). Only notes with inline bodies are cached. Every write
+ * to a note drops its entry, close() wipes the cache, and a read with a
+ * different subkey empties it first, so a cached note is never returned
+ * for a key that could not decrypt it.
  *
  * The subkey is passed per-call rather than stored, keeping key material
  * ownership explicit and confined to VaultService.
@@ -53,16 +135,74 @@ public:
      * @brief Open an existing vault database for note operations
      * @param db_path Path to the SQLite vault database (must already have schema)
      * @param db_key Optional SQLCipher encryption key (nullptr for unencrypted)
+     * @param profile Connection settings (VaultService::connection_profile())
      * @throws std::runtime_error if database cannot be opened
      */
     explicit NotesRepository(const std::string& db_path,
-                             const crypto::SecureKey* db_key = nullptr);
+                             const crypto::SecureKey* db_key = nullptr,
+                             const ConnectionProfile& profile = ConnectionProfile::balanced());
+
+    /**
+     * @brief Run on another storage engine (e.g. a MemoryEngine in tests)
+     * @throws std::invalid_argument if `engine` is null
+     */
+    explicit NotesRepository(std::unique_ptr<StorageEngine> engine);
     ~NotesRepository();
 
-    // Non-copyable (owns sqlite3* handle)
+    // Non-copyable (owns its engine)
     NotesRepository(const NotesRepository&) = delete;
     NotesRepository& operator=(const NotesRepository&) = delete;
 
+    /// Largest plaintext chunk of a chunked body
+    static constexpr size_t kBodyChunkBytes = ContentChunker::kMaxChunkBytes;
+
+    /// Bodies at least this large are stored chunked
+    static constexpr size_t kChunkedBodyThresholdBytes = 128 * 1024;
+
+    /// Notes required before a compression dictionary is trained
+    static constexpr size_t kDictionaryMinNotes = 64;
+
+    /// Most payloads sampled when training a dictionary
+    static constexpr size_t kDictionaryMaxSamples = 4096;
+
+    /// Serialized note bytes gathered into one cold-storage pack
+    static constexpr size_t kPackTargetBytes = 256 * 1024;
+
+    /// Fewest notes worth writing a pack for
+    static constexpr size_t kPackMinNotes = 8;
+
+    /// Decompressed packs kept in memory for reads
+    static constexpr size_t kPackCacheEntries = 4;
+
+    /// Revisions between keyframes (bounds the deltas applied per rebuild)
+    static constexpr int64_t kRevisionKeyframeInterval = 16;
+
+    /// Saves this soon after the newest revision replace it instead of adding one
+    static constexpr int64_t kRevisionCoalesceSeconds = 5 * 60;
+
+    /**
+     * @brief Which revisions update_note() records and keeps
+     */
+    struct RevisionPolicy {
+        bool enabled = true;
+        size_t max_revisions = 100;      ///< Per note; the oldest go first
+        std::chrono::seconds max_age = std::chrono::hours(24 * 30);
+    };
+
+    /**
+     * @brief Sizes of stored (encrypted) note data, for diagnostics
+     */
+    struct StorageStats {
+        uint64_t note_count = 0;
+        uint64_t record_bytes = 0;       ///< Sum of notes.ciphertext sizes
+        uint64_t chunk_bytes = 0;        ///< Sum of chunk ciphertext sizes
+        uint64_t packed_note_count = 0;  ///< Notes held in cold-storage packs
+        uint64_t pack_count = 0;
+        uint64_t pack_bytes = 0;         ///< Sum of note_packs.ciphertext sizes
+        uint64_t revision_count = 0;
+        uint64_t revision_bytes = 0;     ///< Sum of note_revisions.ciphertext sizes
+    };
+
     // === CRUD Operations ===
 
     /**
@@ -70,7 +210,7 @@ public:
      * @param note Note data (id field is ignored, assigned by DB)
      * @param subkey Notes subkey from VaultService
      * @return Assigned note ID (> 0)
-     * @throws std::runtime_error on SQLite or encryption errors
+     * @throws std::runtime_error on storage or encryption errors
      */
     int64_t create_note(const Note& note, const crypto::SecureKey& subkey);
 
@@ -82,6 +222,30 @@ public:
      */
     std::optional<Note> read_note(int64_t id, const crypto::SecureKey& subkey);
 
+    /**
+     * @brief Read a note, delivering the body incrementally
+     *
+     * Chunked bodies are decrypted one chunk at a time and passed to
+     * `body_sink` (chunk boundaries may split UTF-8 sequences); small bodies
+     * are passed in one call. The returned Note has an empty body.
+     *
+     * @return Note metadata, or nullopt if not found or any chunk fails
+     *         authentication (the sink may already have received data)
+     */
+    std::optional<Note> read_note_streamed(
+        int64_t id, const crypto::SecureKey& subkey,
+        const std::function<void(std::string_view)>& body_sink);
+
+    /**
+     * @brief Read a note only if its body is stored inline
+     *
+     * For speculative reads: a chunked body (kChunkedBodyThresholdBytes or
+     * more) is never read, only the record that says it is chunked.
+     *
+     * @return Decrypted Note, or nullopt if not found, unreadable or chunked
+     */
+    std::optional<Note> read_note_if_inline(int64_t id, const crypto::SecureKey& subkey);
+
     /**
      * @brief List all notes (decrypted titles for sidebar)
      * @param subkey Notes subkey from VaultService
@@ -102,6 +266,10 @@ public:
 
     /**
      * @brief Update an existing note (re-encrypts with fresh nonce)
+     *
+     * Runs in a transaction; for a chunked body only chunks whose content
+     * changed are re-encrypted and written. The replaced version is kept as
+     * a revision per the RevisionPolicy.
      * @param note Note with id set and updated fields
      * @param subkey Notes subkey from VaultService
      * @return true if note was found and updated, false if not found
@@ -110,26 +278,416 @@ public:
 
     /**
      * @brief Delete a note by ID
+     *
+     * A packed note's pack is rewritten without its record (or deleted if
+     * it held no other live note), so no copy of the note survives.
      * @param id Note ID to delete
+     * @param subkey Notes subkey (needed to rewrite a pack)
      * @return true if note was found and deleted, false if not found
+     * @throws std::runtime_error if the note's pack cannot be rewritten
+     */
+    bool delete_note(int64_t id, const crypto::SecureKey& subkey);
+
+    // === Write-Behind Saves ===
+
+    /**
+     * @brief Queue a save of an existing note for the next flush_writes()
+     *
+     * Queued saves are written together, in one transaction (one commit,
+     * one fsync), however many notes they cover. A later save of the same
+     * note replaces the queued one; updated_at is the time of the last save.
+     * Every other operation on this repository flushes the queue first, so
+     * reads through it always see queued saves; other connections see them
+     * once flushed. Saves still queued when the repository is closed are
+     * written then if possible, but failures there go unreported: call
+     * flush_writes() (the barrier) before closing.
+     * @param note Note with id set and updated fields
+     * @param subkey Notes subkey; copied (into secure memory) with the save
+     */
+    void queue_update(const Note& note, const crypto::SecureKey& subkey);
+
+    /**
+     * @brief Write every queued save in one transaction
+     * @return Saves written (notes deleted meanwhile are skipped)
+     * @throws std::runtime_error on storage errors; the saves stay queued
      */
-    bool delete_note(int64_t id);
+    size_t flush_writes();
+
+    /// Saves queued and not yet flushed
+    size_t pending_writes() const { return pending_.size(); }
+
+    // === Note Cache ===
+
+    /**
+     * @brief Bytes of decrypted records the note cache may hold (0 = off)
+     *
+     * Only enable it on a connection that sees every write to the vault
+     * (ConnectionPool's writer): the cache is not told about writes made
+     * through other connections.
+     */
+    void set_note_cache_budget(size_t bytes);
+
+    /**
+     * @brief Read a note into the note cache ahead of a likely read_note()
+     *
+     * Does nothing if the note is already cached. Not counted in the hit
+     * rate.
+     * @return false if the cache is off, or the note is missing,
+     *         unreadable or has a chunked body (never cached)
+     */
+    bool prefetch_note(int64_t id, const crypto::SecureKey& subkey);
+
+    /// Note cache counters, including its hit rate
+    NoteCache::Stats note_cache_stats() const { return note_cache_.stats(); }
+
+    /// Wipe every cached note
+    void clear_note_cache() { note_cache_.clear(); }
+
+    /**
+     * @brief Wipe everything decrypted that is kept between calls
+     *
+     * The note cache, the pack cache and the compression dictionaries; each
+     * refills on demand. Saves still queued are kept (flush them first).
+     */
+    void clear_caches();
+
+    // === Revision History ===
+
+    /**
+     * @brief Recorded earlier versions of a note, newest first
+     */
+    std::vector<NoteRevision> list_revisions(int64_t note_id);
+
+    /**
+     * @brief Rebuild an earlier version of a note
+     *
+     * Decrypts the nearest newer keyframe (or the current note) and applies
+     * at most kRevisionKeyframeInterval - 1 deltas.
+     *
+     * @return The version with updated_at = saved_at, or nullopt if the
+     *         revision does not exist or any record in its chain fails
+     *         authentication
+     */
+    std::optional<Note> read_revision(int64_t note_id, int64_t revision_id,
+                                      const crypto::SecureKey& subkey);
+
+    /**
+     * @brief Make an earlier version current again (via update_note(), so
+     *        the version it replaces is kept too)
+     * @return false if the revision cannot be rebuilt
+     */
+    bool restore_revision(int64_t note_id, int64_t revision_id,
+                          const crypto::SecureKey& subkey);
+
+    void set_revision_policy(const RevisionPolicy& policy);
+
+    /**
+     * @brief Drop revisions of every note that fall outside the policy
+     * @return Number of revisions deleted
+     * @throws std::runtime_error on storage errors
+     */
+    size_t prune_revisions();
+
+    // === Change Log ===
+
+    /**
+     * @brief Changes after sequence number `since`, oldest first
+     *
+     * Each note appears at most once, with its newest change: a note saved
+     * many times since then is listed once, a deleted one as a tombstone.
+     * Reads only the log entries after `since`, however large the vault.
+     */
+    std::vector<NoteChange> changes_since(int64_t since);
+
+    /// Sequence number of the newest change (0 if none was ever recorded)
+    int64_t last_change_seq();
+
+    // === Compression ===
+
+    /**
+     * @brief Train a dictionary if none exists yet and the vault is big enough
+     *
+     * Runs train_compression_dictionary() when the vault has no dictionary and
+     * at least kDictionaryMinNotes notes; otherwise does nothing.
+     *
+     * @return true if a dictionary was trained
+     * @throws std::runtime_error on storage errors
+     */
+    bool ensure_compression_dictionary(const crypto::SecureKey& subkey);
+
+    /**
+     * @brief Train a new dictionary from the current notes and recompress
+     *
+     * Samples up to kDictionaryMaxSamples payloads, stores the dictionary
+     * (encrypted) in compression_dicts, and rewrites every inline record with
+     * it in one transaction. Older dictionaries are kept; records are never
+     * left referencing a dictionary that is missing.
+     *
+     * @return true on success, false if there are too few notes to train
+     * @throws std::runtime_error on storage or encryption errors
+     */
+    bool train_compression_dictionary(const crypto::SecureKey& subkey);
+
+    /**
+     * @brief Enable or disable compression of newly written payloads
+     *
+     * On by default; existing compressed records stay readable either way.
+     */
+    void set_compression_enabled(bool enabled);
+
+    // === Cold Storage ===
+
+    /**
+     * @brief Move notes not updated within `min_age` into cold-storage packs
+     *
+     * Inline notes (chunked bodies stay hot) are gathered oldest first into
+     * packs of about kPackTargetBytes; groups smaller than kPackMinNotes are
+     * left alone. Packs shrunk below kPackMinNotes (by saves and deletes,
+     * which rewrite a pack without the note that left it) are repacked
+     * with them. Each pack is written in its own transaction.
+     *
+     * @param max_packs Most packs to write (bounds one background step)
+     * @return Number of notes packed
+     * @throws std::runtime_error on storage or encryption errors
+     */
+    size_t pack_cold_notes(const crypto::SecureKey& subkey, std::chrono::seconds min_age,
+                           size_t max_packs = SIZE_MAX);
+
+    /**
+     * @brief Count notes and the bytes their encrypted records occupy
+     */
+    StorageStats storage_stats();
 
     // === Database Management ===
 
     void close();
     bool is_open() const;
 
+    /// The engine underneath (for tests and maintenance tools)
+    StorageEngine& engine();
+
 private:
-    sqlite3* db_;
-    std::string db_path_;
+    std::unique_ptr<StorageEngine> engine_;
+
+    // Payload compression (dictionaries loaded on first use with the subkey)
+    NoteCompressor compressor_;
+    bool dictionaries_loaded_ = false;
+    bool compression_enabled_ = true;
+
+    RevisionPolicy revision_policy_;
+
+    // Saves queued by queue_update(), in first-queued order (one per note)
+    struct PendingWrite {
+        Note note;
+        crypto::SecureKey subkey;  // Copy: the caller's may be rotated first
+        int64_t saved_at = 0;
+    };
+    std::vector<PendingWrite> pending_;
+
+    // Write queued saves before an operation that could observe them
+    void flush_pending() {
+        if (!pending_.empty()) flush_writes();
+    }
+
+    // Decompressed cold-storage packs, most recently used first
+    struct CachedPack {
+        int64_t pack_id = 0;
+        crypto::SecureBytes plaintext;
+        std::array<uint8_t, 32> digest{};  ///< BLAKE2b-256 of plaintext
+        std::unordered_map<int64_t, std::span<const uint8_t>> payloads;  ///< Into plaintext
+    };
+    std::list<CachedPack> pack_cache_;
+
+    // Decrypted inline notes, and a keyed hash of the subkey that filled it
+    NoteCache note_cache_;
+    std::array<uint8_t, 16> note_cache_key_tag_{};
+
+    // The cached copy of a note if it was filled with `subkey` (a cache
+    // filled with another key is cleared)
+    std::optional<Note> read_cached_note(int64_t id, const crypto::SecureKey& subkey);
+
+    // Cache a note just read with `subkey` (inline bodies only)
+    void cache_note(const Note& note, const crypto::SecureKey& subkey);
+
+    // Empty the cache if it was filled with a key other than `subkey`
+    void bind_note_cache(const crypto::SecureKey& subkey);
+
+    // Size of a chunked body, stored in its (small) note record
+    struct ChunkInfo {
+        uint64_t body_bytes = 0;
+        uint64_t body_chunks = 0;            ///< 0 = body is inline in the record
+        std::vector<NoteRecord::ChunkRef> manifest;  ///< Empty = legacy stream
+    };
+
+    // Rows decrypted per CryptoService::decrypt_many() call during scans
+    static constexpr size_t kScanBatchRows = 256;
+
+    // Decrypt every note (newest first) in batches; rows that fail to
+    // decrypt or parse are skipped. `visit` receives id/updated_at populated.
+    // Chunked bodies are read only up to `body_limit` bytes; binary records
+    // whose stored preview covers `body_limit` are decoded header-only.
+    void scan_notes(const crypto::SecureKey& subkey,
+                    const std::function<void(Note&)>& visit,
+                    size_t body_limit = SIZE_MAX);
+
+    // Note IDs that have at least one row in `table` (keyed by note ID)
+    std::set<int64_t> notes_with_rows_in(Table table);
+
+    // Decrypt the notes row; chunked notes come back without a body
+    std::optional<Note> read_note_record(
+        int64_t id, const crypto::SecureKey& subkey, ChunkInfo& info,
+        std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& nonce);
+
+    // Encrypt `note` into its existing row (and content_chunks if large)
+    // and return its serialized record (a chunked body as its manifest).
+    // Chunk rows the note no longer uses are appended to `released`.
+    // Caller owns the transaction.
+    crypto::SecureBytes store_note(int64_t note_id, const Note& note,
+                                   const crypto::SecureKey& subkey,
+                                   std::optional<int64_t> updated_at,
+                                   std::vector<int64_t>& released);
+
+    // Replace a note with `note`, keeping the stored version as a revision.
+    // Caller owns the transaction.
+    void save_note(const Note& note, const crypto::SecureKey& subkey, int64_t saved_at);
+
+    // Chunked body of either kind, up to `max_bytes`; false if any chunk is
+    // missing or fails authentication
+    bool read_body(
+        int64_t note_id,
+        const std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& record_nonce,
+        const ChunkInfo& info, const crypto::SecureKey& subkey, size_t max_bytes,
+        const std::function<void(std::string_view)>& sink);
+
+    // Content-defined chunks: write those not already stored for this note
+    // (per its current manifest), append the current rows no longer
+    // referenced to `released`, and return the new manifest
+    std::vector<NoteRecord::ChunkRef> write_content_chunks(
+        int64_t note_id, std::string_view body, const crypto::SecureKey& subkey,
+        std::vector<int64_t>& released);
+    bool read_content_chunks(
+        int64_t note_id, const ChunkInfo& info, const crypto::SecureKey& subkey,
+        size_t max_bytes, const std::function<void(std::string_view)>& sink);
+
+    // Legacy body stream (seq 0 = secretstream header, 1..N = chunks)
+    bool read_body_chunks(
+        int64_t note_id,
+        const std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& record_nonce,
+        const ChunkInfo& info, const crypto::SecureKey& subkey, size_t max_bytes,
+        const std::function<void(std::string_view)>& sink);
+
+    // A decrypted, decompressed pack (via pack_cache_, now most recent);
+    // nullptr if it is missing or fails to decrypt. Valid until the next
+    // pack_cache_ change.
+    const CachedPack* load_pack(int64_t pack_id, const crypto::SecureKey& subkey);
+
+    // Serialized record of the packed note in `row`; nullopt unless the
+    // row's pack reference authenticates and names this exact pack version
+    std::optional<std::span<const uint8_t>> read_packed_payload(
+        int64_t note_id, const Row& row, const crypto::SecureKey& subkey);
+
+    // Decrypted, decompressed record of a notes row, hot or packed
+    std::optional<crypto::SecureBytes> read_stored_record(
+        int64_t note_id, const Row& row, const crypto::SecureKey& subkey);
+
+    // Serialized (version 2) record of an inline note, hot or packed;
+    // nullopt if unreadable or the body is chunked
+    std::optional<crypto::SecureBytes> read_inline_payload(
+        int64_t note_id, const crypto::SecureKey& subkey);
+
+    // Pack `ids` (with their serialized records) into a new note_packs row;
+    // each row's record becomes its pack reference, and packs the notes
+    // came from are rewritten without them. Caller owns the transaction.
+    void write_pack(const std::vector<int64_t>& ids,
+                    const std::vector<crypto::SecureBytes>& payloads,
+                    const crypto::SecureKey& subkey);
+
+    // Rewrite a pack to hold only the notes whose rows still point at it,
+    // deleting it when none do. Caller owns the transaction.
+    // @throws std::runtime_error if the pack does not decrypt
+    void rewrite_pack(int64_t pack_id, const crypto::SecureKey& subkey);
+
+    // Newest revision of a note, without decrypting it
+    struct RevisionMeta {
+        int64_t revision_id = 0;
+        bool keyframe = false;
+        int64_t saved_at = 0;
+        int64_t recorded_at = 0;
+    };
+
+    // What a save does with the version it replaces, decided before the save
+    struct RevisionPlan {
+        bool record = false;                  ///< Policy enabled
+        std::optional<RevisionMeta> newest;
+        bool coalesce = false;                ///< Within kRevisionCoalesceSeconds of newest
+        std::optional<crypto::SecureBytes> previous;  ///< Replaced record, when needed
+        int64_t previous_saved_at = 0;
+    };
+
+    // Read what record_revision() will need: revision metadata, and the
+    // stored record unless the save folds into a keyframe. Never the body
+    // chunks.
+    RevisionPlan plan_revision(int64_t note_id, const crypto::SecureKey& subkey);
+
+    // Keep the replaced version (per `plan`) now that `next_record` is
+    // stored, and hand its released chunk rows to the revision that still
+    // references them (or delete them). Caller owns the transaction.
+    void record_revision(int64_t note_id, RevisionPlan& plan,
+                         const crypto::SecureBytes& next_record,
+                         const std::vector<int64_t>& released,
+                         const crypto::SecureKey& subkey);
+
+    // Stored record of a note as revisions keep it (chunked bodies by
+    // manifest; a legacy body stream inline); nullopt if unreadable
+    std::optional<crypto::SecureBytes> read_version_record(
+        int64_t note_id, const crypto::SecureKey& subkey, int64_t& updated_at);
+
+    // Mark chunk rows as referenced only by revision `holder` (nullopt:
+    // by nothing, so delete them)
+    void release_chunks(int64_t note_id, const std::vector<int64_t>& chunk_ids,
+                        std::optional<int64_t> holder);
+
+    // Append a change for the note to the log, dropping its previous entry
+    // (`previous`, the notes row's change_seq); returns the new sequence number
+    int64_t record_change(int64_t note_id, std::optional<int64_t> previous, bool deleted);
+
+    // Decrypt and decode one revision row (a serialized record or a delta)
+    std::optional<crypto::SecureBytes> read_revision_data(
+        int64_t note_id, int64_t revision_id, const crypto::SecureKey& subkey);
+
+    // Encrypt `data` (compressed when that helps) into a revision row
+    void write_revision(int64_t note_id, int64_t revision_id, bool keyframe,
+                        crypto::SecureBytes data, int64_t saved_at, int64_t recorded_at,
+                        const crypto::SecureKey& subkey);
+
+    // Delete revisions outside the policy (all notes when note_id is nullopt)
+    size_t prune_revisions(std::optional<int64_t> note_id);
+
+    // Load (decrypt) all stored dictionaries into compressor_ once
+    void load_dictionaries(const crypto::SecureKey& subkey);
+
+    // Compress a serialized payload if that makes it smaller
+    Codec encode_payload(crypto::SecureBytes& payload);
+
+    // View of the serialized payload for a stored record; `inflated` owns the
+    // buffer when the record was compressed. nullopt if decompression fails.
+    std::optional<std::span<const uint8_t>> decode_payload(
+        int codec, std::span<const uint8_t> stored,
+        std::optional<crypto::SecureBytes>& inflated);
 
-    // Serialization helpers
-    static std::vector<uint8_t> serialize_note(const Note& note);
-    static std::optional<Note> deserialize_note(const std::vector<uint8_t>& json_bytes);
+    // Re-encode every inline record with the active dictionary
+    void recompress_notes(const crypto::SecureKey& subkey);
 
-    // AAD construction (4 bytes little-endian note_id)
-    static std::vector<uint8_t> build_aad(int64_t note_id);
+    // Serialization helpers (plaintext stays in locked memory). Records are
+    // written as NoteRecord (binary, version 2); deserialize_note() also
+    // reads version-1 JSON. With `chunks`, the body is left out and the
+    // chunk count recorded instead.
+    static crypto::SecureBytes serialize_note(const Note& note,
+                                              const ChunkInfo* chunks = nullptr);
+    static std::optional<Note> deserialize_note(std::span<const uint8_t> payload,
+                                                ChunkInfo* chunks = nullptr);
+    static std::optional<Note> deserialize_json_note(std::span<const uint8_t> json_bytes,
+                                                     ChunkInfo* chunks);
 
     // Current UNIX timestamp
     static int64_t current_timestamp();
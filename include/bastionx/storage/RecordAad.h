@@ -0,0 +1,67 @@
+#ifndef BASTIONX_STORAGE_RECORDAAD_H
+#define BASTIONX_STORAGE_RECORDAAD_H
+
+#include "bastionx/crypto/CryptoService.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Associated data of every record encrypted with the notes subkey
+ *
+ * NotesRepository and AttachmentStore write these records and
+ * VaultService::change_password() re-encrypts them in place, so all three
+ * build their AAD here: a builder that drifted would make password change
+ * fail (or worse, write records nothing can read). Integers are
+ * little-endian; the 8-byte prefixes keep each record kind's AAD distinct.
+ * Formats are persisted and must never change for an existing prefix.
+ */
+class RecordAad {
+public:
+    /// Note record: 4-byte note_id
+    static std::vector<uint8_t> note(int64_t note_id);
+
+    /// Legacy body stream chunk: 4-byte note_id || record nonce
+    static std::vector<uint8_t> stream_chunk(
+        int64_t note_id,
+        const std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& record_nonce);
+
+    /// Content-defined body chunk: 4-byte note_id || 8-byte chunk_id
+    static std::vector<uint8_t> content_chunk(int64_t note_id, uint64_t chunk_id);
+
+    /// Compression dictionary: "BXDICTv1" || 4-byte dict_id
+    static std::vector<uint8_t> dictionary(uint32_t dict_id);
+
+    /// Cold-storage pack: "BXPACKv1" || 8-byte pack_id
+    static std::vector<uint8_t> pack(int64_t pack_id);
+
+    /// Pack reference of a packed note's row: "BXPREFv1" || 8-byte note_id
+    static std::vector<uint8_t> pack_ref(int64_t note_id);
+
+    /// Note revision: "BXREVSv1" || 8-byte note_id || 8-byte revision_id
+    static std::vector<uint8_t> revision(int64_t note_id, int64_t revision_id);
+
+    /// Wrapped attachment stream key: "BXAKEYv1" || 8-byte attachment_id
+    static std::vector<uint8_t> attachment_key(int64_t attachment_id);
+
+    /// Attachment link: "BXAREFv1" || 8-byte note_id || 8-byte attachment_id
+    static std::vector<uint8_t> attachment_link(int64_t note_id, int64_t attachment_id);
+
+    /// Attachment stream chunk: 8-byte attachment_id
+    static std::vector<uint8_t> attachment_chunk(int64_t attachment_id);
+
+    /// Vault-wide key (vault_keys row): "BXVKEYv1" || purpose
+    static std::vector<uint8_t> vault_key(std::string_view purpose);
+
+    // Static-only class - prevent instantiation
+    RecordAad() = delete;
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_RECORDAAD_H
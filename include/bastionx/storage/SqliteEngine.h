@@ -0,0 +1,123 @@
+#ifndef BASTIONX_STORAGE_SQLITEENGINE_H
+#define BASTIONX_STORAGE_SQLITEENGINE_H
+
+#include "bastionx/crypto/SecureMemory.h"
+#include "bastionx/storage/ConnectionProfile.h"
+#include "bastionx/storage/StorageEngine.h"
+#include <sqlcipher/sqlite3.h>
+#include <string>
+#include <unordered_map>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief StorageEngine over a SQLCipher vault database (the default)
+ *
+ * Owns one connection, set up by a ConnectionProfile (always WAL). Point operations run through prepared
+ * statements cached per SQL text; scans prepare their own, so a visitor
+ * may call get() while the scan is running. Scans and range deletes walk
+ * the primary key index.
+ */
+class SqliteEngine : public StorageEngine {
+public:
+    /// sqlite3_wal_checkpoint_v2() modes
+    enum class CheckpointMode {
+        kPassive = SQLITE_CHECKPOINT_PASSIVE,    ///< Copy what no reader still needs
+        kRestart = SQLITE_CHECKPOINT_RESTART,    ///< All of it; next write starts the WAL over
+        kTruncate = SQLITE_CHECKPOINT_TRUNCATE   ///< As kRestart, and cut the -wal file to 0
+    };
+
+    struct CheckpointResult {
+        int wal_frames = 0;              ///< Frames in the WAL
+        int checkpointed_frames = 0;     ///< Of those, copied into the database
+        bool busy = false;               ///< A reader or writer kept it from finishing
+    };
+
+    /**
+     * @brief Open an existing vault database
+     * @param db_path Path to the SQLite vault database (must already have schema)
+     * @param db_key Optional SQLCipher encryption key (nullptr for unencrypted)
+     * @param profile Connection settings (VaultService::connection_profile())
+     * @param read_only Open SQLITE_OPEN_READONLY (writes then throw)
+     * @throws std::runtime_error if database cannot be opened
+     */
+    explicit SqliteEngine(const std::string& db_path,
+                          const crypto::SecureKey* db_key = nullptr,
+                          const ConnectionProfile& profile = ConnectionProfile::balanced(),
+                          bool read_only = false);
+    ~SqliteEngine() override;
+
+    // Non-copyable (owns sqlite3* handle)
+    SqliteEngine(const SqliteEngine&) = delete;
+    SqliteEngine& operator=(const SqliteEngine&) = delete;
+
+    void begin() override;
+    void commit() override;
+    void rollback() override;
+
+    std::optional<Row> get(Table table, const RowKey& key,
+                           const Projection& columns = {}) override;
+    void put(Table table, const RowKey& key, const Row& row) override;
+    int64_t insert(Table table, const Row& row) override;
+    bool erase(Table table, const RowKey& key) override;
+    size_t erase_range(Table table, const KeyRange& range) override;
+    void scan(Table table, const KeyRange& range, const Visitor& visit,
+              const Projection& columns = {},
+              ScanOrder order = ScanOrder::kAscending) override;
+    uint64_t count_matching(Table table, size_t column, int64_t value) override;
+    void scan_by(Table table, size_t column, const Visitor& visit,
+                 const Projection& columns = {},
+                 ScanOrder order = ScanOrder::kAscending) override;
+    void scan_subkey(Table table, int64_t b, const Visitor& visit,
+                     const Projection& columns = {}) override;
+    TableUsage usage(Table table, size_t blob_column) override;
+
+    void close() override;
+    bool is_open() const override;
+
+    /**
+     * @brief Make the statement running on this connection fail soon with
+     *        SQLITE_INTERRUPT (safe from any thread while the engine is open)
+     */
+    void interrupt();
+
+    /**
+     * @brief Checkpoint the WAL into the database file
+     * @throws std::runtime_error on errors other than SQLITE_BUSY
+     */
+    CheckpointResult checkpoint(CheckpointMode mode);
+
+    /**
+     * @brief Pages after which a commit checkpoints on its own (0 = never)
+     */
+    void set_auto_checkpoint(int pages);
+
+    const std::string& path() const { return db_path_; }
+
+private:
+    sqlite3* db_;
+    std::string db_path_;
+
+    // Prepared point statements by SQL text (finalized on close)
+    std::unordered_map<std::string, sqlite3_stmt*> statements_;
+
+    sqlite3* handle() const;
+
+    // Cached statement, reset with bindings cleared
+    sqlite3_stmt* cached(const std::string& sql);
+
+    void exec(const char* sql);
+
+    // Step a statement that returns no rows; returns sqlite3_changes()
+    int step_done(sqlite3_stmt* stmt, const char* what, Table table);
+
+    // Step a scan selecting the key columns then `indexes`, visiting each row
+    void visit_rows(sqlite3_stmt* stmt, Table table, const std::vector<size_t>& indexes,
+                    const Visitor& visit);
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_SQLITEENGINE_H
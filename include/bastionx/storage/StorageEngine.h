@@ -0,0 +1,269 @@
+#ifndef BASTIONX_STORAGE_STORAGEENGINE_H
+#define BASTIONX_STORAGE_STORAGEENGINE_H
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace bastionx {
+namespace storage {
+
+/**
+ * @brief Tables NotesRepository keeps its (encrypted) note data in
+ */
+enum class Table {
+    kNotes,
+    kNoteChunks,
+    kContentChunks,
+    kCompressionDicts,
+    kNotePacks,
+    kNoteRevisions,
+    kAttachmentRefs,
+    kAttachments,
+    kAttachmentChunks,
+    kNoteChanges,
+};
+
+inline constexpr size_t kTableCount = 10;
+
+/**
+ * @brief Value columns of each table, in row order
+ *
+ * Tables holding an AEAD record keep (nonce, ciphertext, alg) as their first
+ * three columns, followed by codec where the payload may be compressed.
+ */
+namespace col {
+struct Notes {
+    enum : size_t { kNonce, kCiphertext, kAlg, kCodec, kCreatedAt, kUpdatedAt, kPackId,
+                    kChangeSeq };
+};
+struct NoteChunks {
+    enum : size_t { kData };
+};
+struct ContentChunks {
+    enum : size_t { kNonce, kCiphertext, kAlg, kReleasedBy };
+};
+struct CompressionDicts {
+    enum : size_t { kNonce, kCiphertext, kAlg, kCreatedAt };
+};
+struct NotePacks {
+    enum : size_t { kNonce, kCiphertext, kAlg, kCodec, kNoteCount, kCreatedAt };
+};
+struct NoteRevisions {
+    enum : size_t { kNonce, kCiphertext, kAlg, kCodec, kKeyframe, kSavedAt, kRecordedAt };
+};
+struct AttachmentRefs {
+    enum : size_t { kNonce, kCiphertext, kAlg, kCreatedAt };
+};
+struct Attachments {
+    enum : size_t { kNonce, kCiphertext, kAlg, kContentId, kHeader, kSize, kChunkCount,
+                    kCreatedAt };
+};
+struct AttachmentChunks {
+    enum : size_t { kData };
+};
+struct NoteChanges {
+    enum : size_t { kNoteId, kDeleted };
+};
+}  // namespace col
+
+/**
+ * @brief Layout of a table: one or two integer key columns, then values
+ */
+struct TableSpec {
+    const char* name;
+    const char* key;                     ///< First key column
+    const char* subkey;                  ///< Second key column, or nullptr
+    std::vector<const char*> columns;    ///< Value columns, in col:: order
+    bool auto_id;                        ///< Keys assigned by insert()
+};
+
+/// Spec of `table` (the schema itself is owned by VaultService)
+const TableSpec& table_spec(Table table);
+
+/**
+ * @brief Primary key; `b` is 0 for tables with a single key column
+ */
+struct RowKey {
+    int64_t a = 0;
+    int64_t b = 0;
+
+    auto operator<=>(const RowKey&) const = default;
+};
+
+/**
+ * @brief Inclusive range of keys, compared as (a, b)
+ */
+struct KeyRange {
+    RowKey first{std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min()};
+    RowKey last{std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max()};
+
+    static KeyRange all() { return {}; }
+
+    /// Every key whose first column is `a`
+    static KeyRange prefix(int64_t a) {
+        return {{a, std::numeric_limits<int64_t>::min()},
+                {a, std::numeric_limits<int64_t>::max()}};
+    }
+};
+
+/**
+ * @brief The value columns of one row
+ */
+struct Row {
+    using Value = std::variant<std::monostate, int64_t, std::vector<uint8_t>>;
+
+    std::vector<Value> values;
+
+    Row() = default;
+
+    /// All-null row with `table`'s columns
+    explicit Row(Table table) : values(table_spec(table).columns.size()) {}
+
+    bool is_null(size_t col) const {
+        return std::holds_alternative<std::monostate>(values[col]);
+    }
+
+    /// Integer column; 0 when null
+    int64_t integer(size_t col) const {
+        const auto* v = std::get_if<int64_t>(&values[col]);
+        return v != nullptr ? *v : 0;
+    }
+
+    /// Blob column; empty when null
+    std::span<const uint8_t> blob(size_t col) const {
+        const auto* v = std::get_if<std::vector<uint8_t>>(&values[col]);
+        return v != nullptr ? std::span<const uint8_t>(*v) : std::span<const uint8_t>();
+    }
+
+    void set(size_t col, int64_t value) { values[col] = value; }
+    void set(size_t col, std::span<const uint8_t> blob) {
+        values[col] = std::vector<uint8_t>(blob.begin(), blob.end());
+    }
+    void set(size_t col, std::vector<uint8_t>&& blob) { values[col] = std::move(blob); }
+    void set_null(size_t col) { values[col] = std::monostate{}; }
+};
+
+/**
+ * @brief Value columns a read fills in; the others come back null
+ */
+struct Projection {
+    std::optional<std::vector<size_t>> only;  ///< nullopt = every column
+
+    Projection() = default;
+    Projection(std::initializer_list<size_t> columns) : only(std::vector<size_t>(columns)) {}
+
+    static Projection all() { return {}; }
+
+    /// Keys only
+    static Projection none() {
+        Projection p;
+        p.only.emplace();
+        return p;
+    }
+};
+
+enum class ScanOrder { kAscending, kDescending };
+
+/**
+ * @brief Row storage under NotesRepository
+ *
+ * A small key/row interface: point get/put/erase by primary key, scans in
+ * key order over a key range, and transactions. Two queries a backend can
+ * answer from an index are calls too: rows ordered by a value column
+ * (scan_by()) and rows by their second key column (scan_subkey()). Joins
+ * and filters the repository does itself over these calls.
+ *
+ * The engine never sees plaintext: every blob it holds is already
+ * encrypted by the repository (or is a key or a secretstream chunk).
+ *
+ * Backends: SqliteEngine (SQLCipher; the default, used by the app) and
+ * MemoryEngine (std::map; for tests and benchmarks).
+ *
+ * Writes inside begin()/commit() are applied together or, after
+ * rollback(), not at all; outside a transaction each write stands alone.
+ * Transactions do not nest. Engines are not thread-safe.
+ *
+ * @throws std::runtime_error from any call when the backend fails
+ */
+class StorageEngine {
+public:
+    /// Receives rows in key order; return false to stop. Must not write
+    /// to the engine.
+    using Visitor = std::function<bool(const RowKey& key, const Row& row)>;
+
+    /**
+     * @brief Row count and total size of one blob column, for diagnostics
+     */
+    struct TableUsage {
+        uint64_t rows = 0;
+        uint64_t bytes = 0;
+    };
+
+    virtual ~StorageEngine() = default;
+
+    virtual void begin() = 0;
+    virtual void commit() = 0;
+    virtual void rollback() = 0;
+
+    /// Row by key, or nullopt if there is none
+    virtual std::optional<Row> get(Table table, const RowKey& key,
+                                   const Projection& columns = {}) = 0;
+
+    /// Insert or replace the row at `key` (every column is written)
+    virtual void put(Table table, const RowKey& key, const Row& row) = 0;
+
+    /**
+     * @brief Insert a row under a new key above every key used so far
+     * @return The key's first column
+     * @throws std::invalid_argument if the table's keys are not auto-assigned
+     */
+    virtual int64_t insert(Table table, const Row& row) = 0;
+
+    /// @return true if the row existed
+    virtual bool erase(Table table, const RowKey& key) = 0;
+
+    /// @return Number of rows deleted
+    virtual size_t erase_range(Table table, const KeyRange& range) = 0;
+
+    virtual void scan(Table table, const KeyRange& range, const Visitor& visit,
+                      const Projection& columns = {},
+                      ScanOrder order = ScanOrder::kAscending) = 0;
+
+    /// Rows whose integer `column` equals `value` (indexed where the backend
+    /// has an index on it)
+    virtual uint64_t count_matching(Table table, size_t column, int64_t value) = 0;
+
+    /**
+     * @brief Every row, ordered by integer `column`, ties in ascending key
+     *        order (indexed where the backend has an index on it)
+     *
+     * `column` must not hold nulls.
+     */
+    virtual void scan_by(Table table, size_t column, const Visitor& visit,
+                         const Projection& columns = {},
+                         ScanOrder order = ScanOrder::kAscending) = 0;
+
+    /**
+     * @brief Rows whose second key column is `b`, in key order (indexed
+     *        where the backend has an index on it)
+     * @throws std::invalid_argument if the table has a single-column key
+     */
+    virtual void scan_subkey(Table table, int64_t b, const Visitor& visit,
+                             const Projection& columns = {}) = 0;
+
+    virtual TableUsage usage(Table table, size_t blob_column) = 0;
+
+    virtual void close() = 0;
+    virtual bool is_open() const = 0;
+};
+
+}  // namespace storage
+}  // namespace bastionx
+
+#endif  // BASTIONX_STORAGE_STORAGEENGINE_H
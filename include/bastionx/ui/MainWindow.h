@@ -8,9 +8,14 @@
 #include <QLabel>
 #include <QToolBar>
 #include <memory>
+#include <string>
+#include "bastionx/util/Coroutine.h"
+#include "bastionx/vault/AsyncVault.h"
+#include "bastionx/vault/MaintenanceScheduler.h"
+#include "bastionx/vault/VaultBackup.h"
 #include "bastionx/vault/VaultService.h"
 #include "bastionx/vault/VaultSettings.h"
-#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/storage/AsyncNotesRepository.h"
 
 namespace bastionx {
 namespace ui {
@@ -35,6 +40,13 @@ private slots:
     void onCreateRequested(const QString& password);
     void onLockRequested();
     void onInactivityTimeout();
+    void onQuickUnlockRequested(const QString& pin);
+    void onPasswordFallbackRequested();
+    void onQuickUnlockExpired();
+    void onColdPackTimeout();
+    void onBackupTimeout();
+    void onCheckpointTimeout();
+    void onMaintenanceTimeout();
     void onSettingsRequested();
     void onSettingsChanged(const vault::VaultSettings& settings);
     void onPasswordChangeRequested(const QString& current_pw,
@@ -42,10 +54,27 @@ private slots:
 
 private:
     void showUnlockScreen();
-    void showNotesPanel();
+    util::Task unlockVault(std::string password);
+    util::Task quickUnlockVault(std::string pin);
+    util::Task createVault(std::string password);
+    util::Task changePassword(std::string current_pw, std::string new_pw);
+    util::Task showNotesPanel();
     void resetInactivityTimer();
     void setupToolbar();
-    void loadAndApplySettings();
+    void applySettings(const std::string& json);
+    void applyRevisionPolicy();
+    void applyBackupSettings();
+    void scheduleBackup(int delay_ms);
+    void promptQuickUnlockPin();
+    // Saves open notes, then stops background work and the storage thread.
+    // False (session kept) if the saves failed, unless `discard_unsaved`
+    bool closeSession(bool discard_unsaved = false);
+    void reportSaveFailure();
+    void openStorage();
+    void closeStorage();
+    util::Dispatcher eventLoopDispatcher();
+    // Clears vault_busy_ and queues a close held back while it was set
+    void releaseVault();
 
     // UI
     QStackedWidget* stack_ = nullptr;
@@ -57,7 +86,19 @@ private:
 
     // Backend
     std::unique_ptr<vault::VaultService>      vault_;
-    std::unique_ptr<storage::NotesRepository> repo_;
+    // Owns the writer of vault_'s connection pool on the storage thread
+    std::unique_ptr<storage::AsyncNotesRepository> storage_;
+
+    // Vault operations for coroutines (run on a worker, resume on the event
+    // loop). While one is in flight nothing else may use vault_, and
+    // closing the window waits for it
+    std::unique_ptr<vault::AsyncVault> async_vault_;
+    bool vault_busy_ = false;
+    bool close_pending_ = false;
+
+    // Cancelled when storage_ closes (lock, password change), ending the
+    // session's coroutines at their next co_await
+    util::CancelToken session_;
 
     // Settings & Clipboard
     vault::VaultSettings settings_;
@@ -65,6 +106,31 @@ private:
 
     // Inactivity
     QTimer* inactivity_timer_ = nullptr;
+
+    // Quick relock (wipes the PIN-wrapped key when its lifetime ends)
+    QTimer* quick_unlock_timer_ = nullptr;
+
+    // Cold-storage packing, one pack per step while the vault is unlocked
+    QTimer* cold_pack_timer_ = nullptr;
+    static constexpr int kColdPackDelayMs = 30 * 1000;   // After unlock
+    static constexpr int kColdPackStepMs = 2 * 1000;     // Between packs
+
+    // Vault snapshots, copied a few pages per step while the user is idle;
+    // any input pushes the next step back by kBackupIdleMs
+    std::unique_ptr<vault::VaultBackup> backup_;
+    QTimer* backup_timer_ = nullptr;
+    static constexpr int kBackupIdleMs = 60 * 1000;      // Idle before a step
+    static constexpr int kBackupStepMs = 50;             // Between steps
+
+    // WAL checkpoints once input stops, so autosaves never pay for one
+    QTimer* checkpoint_timer_ = nullptr;
+    static constexpr int kCheckpointIdleMs = 5 * 1000;   // Idle before a checkpoint
+
+    // Vault housekeeping on the scheduler's thread while the user is idle;
+    // any input pauses it and pushes the next run back by kMaintenanceIdleMs
+    std::unique_ptr<vault::MaintenanceScheduler> maintenance_;
+    QTimer* maintenance_timer_ = nullptr;
+    static constexpr int kMaintenanceIdleMs = 2 * 60 * 1000;  // Idle before a run
     static constexpr int kDefaultTimeoutMs = 5 * 60 * 1000;
 };
 
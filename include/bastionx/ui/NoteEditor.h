@@ -8,7 +8,7 @@
 #include <QLabel>
 #include <QTimer>
 #include <QTextDocument>
-#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/storage/AsyncNotesRepository.h"
 #include "bastionx/crypto/SecureMemory.h"
 
 namespace bastionx {
@@ -26,7 +26,7 @@ public:
 
     void loadNote(const storage::Note& note);
     bool saveCurrentNote();
-    void setBackend(storage::NotesRepository* repo, const crypto::SecureKey* subkey);
+    void setBackend(storage::AsyncNotesRepository* storage, const crypto::SecureKey* subkey);
     void clearEditor();
     bool hasUnsavedChanges() const;
     int64_t currentNoteId() const;
@@ -71,8 +71,9 @@ private:
 
     int64_t current_note_id_ = 0;
     bool modified_ = false;
+    uint64_t edits_ = 0;  // Bumped by setModified(): a save in flight is stale
 
-    storage::NotesRepository* repo_ = nullptr;
+    storage::AsyncNotesRepository* storage_ = nullptr;
     const crypto::SecureKey*  subkey_ = nullptr;
 
     static constexpr int kAutoSaveDelayMs = 2000;
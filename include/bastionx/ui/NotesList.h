@@ -23,9 +23,12 @@ public:
 signals:
     void noteSelected(int64_t note_id);
     void newNoteRequested();
+    /// The pointer moved onto a row (for prefetching)
+    void noteHovered(int64_t note_id);
 
 private slots:
     void onItemClicked(QListWidgetItem* item);
+    void onItemEntered(QListWidgetItem* item);
     void onFilterChanged(const QString& text);
 
 private:
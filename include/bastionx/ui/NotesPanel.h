@@ -4,8 +4,12 @@
 #include <QWidget>
 #include <QSplitter>
 #include <QTextDocument>
+#include <QTimer>
+#include <cstdint>
 #include <map>
-#include "bastionx/storage/NotesRepository.h"
+#include <set>
+#include <vector>
+#include "bastionx/storage/AsyncNotesRepository.h"
 #include "bastionx/crypto/SecureMemory.h"
 
 namespace bastionx {
@@ -23,8 +27,27 @@ class NotesPanel : public QWidget {
 public:
     explicit NotesPanel(QWidget* parent = nullptr);
 
-    void loadNotes(storage::NotesRepository* repo, const crypto::SecureKey* subkey);
-    void prepareForLock();
+    /// Attach the backend; the list is filled by showNotes() or refreshList()
+    void loadNotes(storage::AsyncNotesRepository* storage, const crypto::SecureKey* subkey);
+    /// Save every modified tab, then close the tabs and detach the backend.
+    /// False (tabs kept, failure shown) if the saves could not be written,
+    /// unless `discard_unsaved`
+    bool prepareForLock(bool discard_unsaved = false);
+
+    /// Re-read the notes list on the storage thread
+    void refreshList();
+    /// Show a notes list the caller has already read
+    void showNotes(const std::vector<storage::NoteSummary>& summaries);
+    /// Open a note in a tab (read on the storage thread) and select it
+    void openNote(int64_t note_id);
+    /// Warm the note cache with the kWarmPrefetchNotes most recently
+    /// updated notes (`summaries` newest first), while the storage thread
+    /// is otherwise idle
+    void prefetchRecent(const std::vector<storage::NoteSummary>& summaries);
+
+    /// Write every queued save now and wait for it (barrier before locking
+    /// or exiting). False if the write failed; the saves stay queued
+    bool flushPendingSaves();
 
 signals:
     void settingsRequested();
@@ -38,13 +61,21 @@ private slots:
     void onNoteDeleted(int64_t note_id);
     void onEditorContentChanged();
     void onSearchRequested(const QString& query);
+    void onFlushTimeout();
+    void onNoteHovered(int64_t note_id);
+    void onHoverTimeout();
 
 private:
-    void refreshList();
     void openNoteInTab(int64_t note_id);
+    void showLoadedNote(int64_t note_id, storage::Note note, QTextDocument* doc);
+    void prefetchForOpen(int64_t note_id);
+    void dropPrefetched(int64_t note_id);
+    void clearPrefetched();
+    void queueSave(const storage::Note& note);
     void cacheCurrentEditorState();
     void switchToTab(int64_t note_id);
     void updateStatusBar();
+    void scheduleFlush();
 
     // In-memory cache of open notes (per-tab QTextDocument for undo history)
     struct OpenNote {
@@ -65,9 +96,36 @@ private:
     std::map<int64_t, OpenNote> open_notes_;
     int64_t active_note_id_ = 0;
 
-    // Backend
-    storage::NotesRepository* repo_ = nullptr;
+    // Backend: every call runs on the storage thread, results come back
+    // through the event loop
+    storage::AsyncNotesRepository* storage_ = nullptr;
     const crypto::SecureKey* subkey_ = nullptr;
+
+    // Notes being read for a new tab (a second click does not read again)
+    std::set<int64_t> loading_notes_;
+
+    // Notes read, and their documents built, while the pointer rested on
+    // their row; openNoteInTab() takes them instead of reading. Oldest first
+    struct PrefetchedNote {
+        int64_t id = 0;
+        storage::Note note;
+        QTextDocument* document = nullptr;
+    };
+    std::vector<PrefetchedNote> prefetched_;
+    QTimer* hover_timer_ = nullptr;
+    int64_t hovered_note_id_ = 0;
+    static constexpr int kHoverPrefetchDelayMs = 150;
+    static constexpr size_t kMaxPrefetchedNotes = 3;
+    static constexpr size_t kWarmPrefetchNotes = 8;
+    // Only the latest search's results, and the latest list, are shown
+    // (snapshot reads can finish out of order)
+    uint64_t search_seq_ = 0;
+    uint64_t list_seq_ = 0;
+
+    // Saves are queued in the repository and committed together once the
+    // first has waited kWriteWindowMs
+    QTimer* flush_timer_ = nullptr;
+    static constexpr int kWriteWindowMs = 500;
 };
 
 }  // namespace ui
@@ -42,11 +42,23 @@ private:
 
     // Auto-Lock
     QSpinBox* auto_lock_spin_ = nullptr;
+    QCheckBox* quick_unlock_enabled_ = nullptr;
+    QSpinBox* quick_unlock_minutes_spin_ = nullptr;
 
     // Clipboard
     QCheckBox* clipboard_enabled_ = nullptr;
     QSpinBox* clipboard_seconds_spin_ = nullptr;
 
+    // Storage
+    QCheckBox* cold_pack_enabled_ = nullptr;
+    QSpinBox* cold_pack_days_spin_ = nullptr;
+    QSpinBox* revision_days_spin_ = nullptr;
+
+    // Backups
+    QCheckBox* backup_enabled_ = nullptr;
+    QSpinBox* backup_interval_spin_ = nullptr;
+    QSpinBox* backup_keep_spin_ = nullptr;
+
     // Password change
     QLineEdit* current_pw_ = nullptr;
     QLineEdit* new_pw_ = nullptr;
@@ -24,6 +24,7 @@ public:
 
 signals:
     void noteSelected(int64_t note_id);
+    void noteHovered(int64_t note_id);
     void newNoteRequested();
     void settingsRequested();
     void searchRequested(const QString& query);
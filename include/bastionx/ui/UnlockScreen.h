@@ -20,9 +20,14 @@ public:
     void reset();
     void setSubmitBusy(bool busy);
 
+    /// Ask for the quick-unlock PIN instead of the master password
+    void setQuickUnlockMode(bool enabled);
+
 signals:
     void unlockRequested(const QString& password);
     void createRequested(const QString& password);
+    void quickUnlockRequested(const QString& pin);
+    void passwordFallbackRequested();
 
 public slots:
     void showError(const QString& message);
@@ -37,9 +42,11 @@ private:
     QLabel*      status_label_ = nullptr;
     QLineEdit*   password_input_ = nullptr;
     QPushButton* submit_button_ = nullptr;
+    QPushButton* fallback_button_ = nullptr;
     QLabel*      error_label_ = nullptr;
 
     vault::VaultState current_state_ = vault::VaultState::kLocked;
+    bool quick_mode_ = false;
 };
 
 }  // namespace ui
@@ -0,0 +1,205 @@
+#ifndef BASTIONX_UTIL_COROUTINE_H
+#define BASTIONX_UTIL_COROUTINE_H
+
+#include "bastionx/util/ThreadPool.h"
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace bastionx {
+namespace util {
+
+/**
+ * @brief Runs a callback on the thread that owns an object (for the UI,
+ *        by queueing it on the Qt event loop); empty = run it in place
+ */
+using Dispatcher = std::function<void(std::function<void()>)>;
+
+/**
+ * @brief Thrown from co_await once the operation's CancelToken is cancelled
+ */
+class Cancelled : public std::runtime_error {
+public:
+    Cancelled() : std::runtime_error("Operation cancelled") {}
+};
+
+/**
+ * @brief Cancellation flag shared by copies; cancelled once, for good
+ *
+ * VaultService::session_token() hands out one per unlocked session and
+ * cancels it when the vault locks.
+ */
+class CancelToken {
+public:
+    CancelToken() : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() { cancelled_->store(true); }
+    bool cancelled() const { return cancelled_->load(); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+/**
+ * @brief Fire-and-forget coroutine return type
+ *
+ * Starts running when called and frees itself when it finishes. A
+ * Cancelled exception ends it quietly; any other exception leaves the
+ * coroutine towards whoever resumed it, so catch what you expect.
+ */
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() {
+            try {
+                throw;
+            } catch (const Cancelled&) {
+                // The vault locked while this was waiting
+            }
+        }
+    };
+};
+
+/**
+ * @brief Completes the operation a coroutine is waiting on
+ *
+ * The first of run() and cancel() stores the outcome and resumes the
+ * coroutine through its Dispatcher; later calls do nothing. May be copied
+ * and called from any thread.
+ */
+template <typename T>
+class Completion {
+public:
+    using Value = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    struct State {
+        std::optional<Value> value;
+        std::exception_ptr error;
+        std::coroutine_handle<> handle;
+        std::atomic<bool> done{false};
+    };
+
+    Completion(std::shared_ptr<State> state, Dispatcher resume)
+        : state_(std::move(state)), resume_(std::move(resume)) {}
+
+    /// Store what `fn` returns, or the exception it throws
+    template <typename Fn>
+    void run(Fn&& fn) {
+        if (state_->done.load()) {
+            return;
+        }
+        try {
+            if constexpr (std::is_void_v<T>) {
+                fn();
+                state_->value.emplace();
+            } else {
+                state_->value.emplace(fn());
+            }
+        } catch (...) {
+            state_->error = std::current_exception();
+        }
+        finish();
+    }
+
+    /// Resume with Cancelled (the operation will not run)
+    void cancel() {
+        if (state_->done.load()) {
+            return;
+        }
+        state_->error = std::make_exception_ptr(Cancelled());
+        finish();
+    }
+
+private:
+    void finish() {
+        if (state_->done.exchange(true)) {
+            return;
+        }
+        auto state = state_;
+        if (resume_) {
+            resume_([state] { state->handle.resume(); });
+        } else {
+            state->handle.resume();
+        }
+    }
+
+    std::shared_ptr<State> state_;
+    Dispatcher resume_;
+};
+
+/**
+ * @brief co_await-able result of an operation running elsewhere
+ *
+ * `start` is called when the coroutine suspends and must eventually
+ * complete the Completion it is given, on any thread; the coroutine is then
+ * resumed through `resume`. Once `token` is cancelled, co_await throws
+ * Cancelled instead of returning, even if the operation finished: the
+ * coroutine must not carry on into a locked vault.
+ */
+template <typename T>
+class [[nodiscard]] Awaitable {
+public:
+    using Start = std::function<void(Completion<T>)>;
+
+    Awaitable(Start start, Dispatcher resume, CancelToken token = {})
+        : start_(std::move(start)), resume_(std::move(resume)), token_(std::move(token)),
+          state_(std::make_shared<typename Completion<T>::State>()) {}
+
+    bool await_ready() const noexcept { return token_.cancelled(); }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        state_->handle = handle;
+        start_(Completion<T>(state_, resume_));
+    }
+
+    T await_resume() {
+        if (token_.cancelled()) {
+            throw Cancelled();
+        }
+        if (state_->error) {
+            std::rethrow_exception(state_->error);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*state_->value);
+        }
+    }
+
+private:
+    Start start_;
+    Dispatcher resume_;
+    CancelToken token_;
+    std::shared_ptr<typename Completion<T>::State> state_;
+};
+
+/**
+ * @brief Run `fn` on the shared ThreadPool and resume through `resume`
+ *
+ * For blocking work with no thread of its own (key derivation, one-off
+ * vault reads). `fn` runs once the coroutine awaits.
+ */
+template <typename Fn>
+auto run_async(Fn fn, Dispatcher resume, CancelToken token = {})
+    -> Awaitable<std::invoke_result_t<Fn&>> {
+    using R = std::invoke_result_t<Fn&>;
+    return Awaitable<R>(
+        [fn = std::move(fn)](Completion<R> done) mutable {
+            ThreadPool::shared().post([fn = std::move(fn), done]() mutable { done.run(fn); });
+        },
+        std::move(resume), std::move(token));
+}
+
+}  // namespace util
+}  // namespace bastionx
+
+#endif  // BASTIONX_UTIL_COROUTINE_H
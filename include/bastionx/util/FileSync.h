@@ -0,0 +1,30 @@
+#ifndef BASTIONX_UTIL_FILESYNC_H
+#define BASTIONX_UTIL_FILESYNC_H
+
+#include <filesystem>
+
+namespace bastionx {
+namespace util {
+
+/**
+ * @brief fsync() a file's data and metadata to stable storage
+ *
+ * Streams only hand writes to the OS; call this once they are flushed (or
+ * closed) and before anything depends on the file surviving a power loss.
+ *
+ * @throws std::runtime_error if the file cannot be opened or synced
+ */
+void sync_file(const std::filesystem::path& path);
+
+/**
+ * @brief fsync() a directory, making entries created, renamed or removed
+ *        in it durable
+ *
+ * @throws std::runtime_error if the directory cannot be opened or synced
+ */
+void sync_directory(const std::filesystem::path& dir);
+
+}  // namespace util
+}  // namespace bastionx
+
+#endif  // BASTIONX_UTIL_FILESYNC_H
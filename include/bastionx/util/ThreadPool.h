@@ -0,0 +1,83 @@
+#ifndef BASTIONX_UTIL_THREADPOOL_H
+#define BASTIONX_UTIL_THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bastionx {
+namespace util {
+
+/**
+ * @brief Fixed-size worker pool for CPU-bound batch work (crypto, parsing)
+ *
+ * Work is submitted as a blocking parallel_for(): the calling thread runs
+ * tasks alongside the workers and returns once every task has finished, so
+ * a nested parallel_for() from inside a task can never deadlock (the caller
+ * drains whatever the busy workers do not pick up). post() queues a single
+ * job without waiting (util::run_async()).
+ *
+ * Tasks must not touch Qt objects; the pool is part of the core library.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Create a pool with `thread_count` workers
+     * @param thread_count Number of workers; 0 = hardware_concurrency() - 1
+     *        (the caller is the remaining thread), minimum 1
+     */
+    explicit ThreadPool(size_t thread_count = 0);
+
+    /**
+     * @brief Stop accepting work, finish queued jobs and join all workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Process-wide pool shared by the core library
+     */
+    static ThreadPool& shared();
+
+    /**
+     * @brief Number of worker threads (excluding callers)
+     */
+    size_t thread_count() const { return workers_.size(); }
+
+    /**
+     * @brief Run task(i) for every i in [0, task_count) and wait for completion
+     *
+     * Tasks are claimed dynamically, so uneven task sizes balance out.
+     * If any task throws, the remaining unclaimed tasks are skipped and the
+     * first exception is rethrown to the caller after in-flight tasks finish.
+     */
+    void parallel_for(size_t task_count, const std::function<void(size_t)>& task);
+
+    /**
+     * @brief Queue `job` for a worker and return at once
+     *
+     * The job must not throw. Jobs still queued when the pool is destroyed
+     * are run first.
+     */
+    void post(std::function<void()> job);
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+}  // namespace util
+}  // namespace bastionx
+
+#endif  // BASTIONX_UTIL_THREADPOOL_H
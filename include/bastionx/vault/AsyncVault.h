@@ -0,0 +1,66 @@
+#ifndef BASTIONX_VAULT_ASYNCVAULT_H
+#define BASTIONX_VAULT_ASYNCVAULT_H
+
+#include "bastionx/util/Coroutine.h"
+#include "bastionx/vault/VaultService.h"
+#include <string>
+
+namespace bastionx {
+namespace vault {
+
+/**
+ * @brief co_await-able VaultService operations
+ *
+ * Each call runs the VaultService operation on the shared ThreadPool (key
+ * derivation takes around a second) and resumes the awaiting coroutine
+ * through the Dispatcher; the UI's dispatcher queues it on the Qt event
+ * loop. Passwords and PINs are wiped once the operation has used them.
+ *
+ * VaultService is not thread-safe: while a coroutine waits on one of these,
+ * nothing else may call the vault other than state() and is_unlocked().
+ * Operations on an unlocked vault are tied to its session_token(): once
+ * the vault locks, co_await throws util::Cancelled.
+ */
+class AsyncVault {
+public:
+    /**
+     * @param vault Vault to operate on (must outlive every operation)
+     * @param resume Resumes coroutines on the owner's thread
+     */
+    AsyncVault(VaultService& vault, util::Dispatcher resume);
+
+    util::Awaitable<bool> create(std::string password);
+    util::Awaitable<bool> unlock(std::string password);
+    util::Awaitable<bool> quick_unlock(std::string pin);
+
+    /**
+     * @brief VaultService::change_password() (ends the current session)
+     */
+    util::Awaitable<bool> change_password(std::string current_password,
+                                          std::string new_password);
+
+    /**
+     * @brief VaultService::load_settings(), cancelled with the session
+     * @throws std::runtime_error (from co_await) if the vault is locked
+     */
+    util::Awaitable<std::string> load_settings();
+
+    /**
+     * @brief VaultService::save_settings(), cancelled with the session
+     * @throws std::runtime_error (from co_await) if the vault is locked
+     */
+    util::Awaitable<void> save_settings(std::string json_str);
+
+private:
+    // Token of the current session (a fresh one if the vault is locked:
+    // the operation then throws)
+    util::CancelToken session();
+
+    VaultService& vault_;
+    util::Dispatcher resume_;
+};
+
+}  // namespace vault
+}  // namespace bastionx
+
+#endif  // BASTIONX_VAULT_ASYNCVAULT_H
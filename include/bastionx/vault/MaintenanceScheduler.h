@@ -0,0 +1,152 @@
+#ifndef BASTIONX_VAULT_MAINTENANCESCHEDULER_H
+#define BASTIONX_VAULT_MAINTENANCESCHEDULER_H
+
+#include <sqlcipher/sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bastionx {
+namespace vault {
+
+class VaultService;
+
+/**
+ * @brief Housekeeping for an unlocked vault, run in small slices while idle
+ *
+ * Each task has an interval; a task is due when it has never run or last
+ * ran longer ago than that. run_slice() works through the due tasks one
+ * step at a time until its budget is spent, so the caller can run a slice
+ * whenever the user is idle and simply stop calling when input arrives: a
+ * task carries on from its next step at the following slice.
+ *
+ * default_tasks() keeps the query planner's statistics fresh (PRAGMA
+ * optimize, ANALYZE one table per step), returns free pages to the file
+ * system (PRAGMA incremental_vacuum, on vaults created with auto_vacuum =
+ * INCREMENTAL) and checks the vault (PRAGMA quick_check, one table per
+ * step).
+ *
+ * Tasks run on a connection of their own, keyed with the database subkey
+ * and opened at the first slice. When each task finishes, how long it took
+ * (its steps only), when it ran and whether it succeeded are recorded in
+ * the maintenance log, stored encrypted in the vault
+ * (VaultService::save_maintenance_log()). A task that throws is logged as
+ * failed and retried at its next interval.
+ *
+ * A single step is not bounded (quick_check of a large table can take
+ * seconds), so the UI does not run slices itself: resume() runs them on
+ * the scheduler's own thread until nothing is due or pause() is called.
+ * run_slice(), due() and log() are for the owner thread while that thread
+ * is idle. Destroying the scheduler interrupts a running step (it reruns
+ * next time) and joins the thread; destroy it before the vault locks or
+ * changes its password.
+ */
+class MaintenanceScheduler {
+public:
+    /// Budget of one run_slice() by default
+    static constexpr std::chrono::milliseconds DEFAULT_SLICE{20};
+
+    struct Task {
+        std::string name;
+        std::chrono::seconds interval;
+        /// One step of the task; `step` counts from 0 within a run.
+        /// Returns true when the task is finished.
+        std::function<bool(sqlite3* db, size_t step)> run;
+    };
+
+    struct LogEntry {
+        std::string task;
+        std::chrono::system_clock::time_point last_run;    ///< When it finished
+        std::chrono::microseconds duration{0};             ///< Time spent in its steps
+        uint64_t runs = 0;
+        bool ok = true;
+        std::string error;                                  ///< If !ok
+    };
+
+    /**
+     * @param vault Unlocked vault (must outlive this)
+     * @param tasks Tasks in the order they run when due
+     * @throws std::runtime_error if the vault is locked
+     */
+    explicit MaintenanceScheduler(VaultService& vault,
+                                  std::vector<Task> tasks = default_tasks());
+    ~MaintenanceScheduler();
+
+    MaintenanceScheduler(const MaintenanceScheduler&) = delete;
+    MaintenanceScheduler& operator=(const MaintenanceScheduler&) = delete;
+
+    /**
+     * @brief Run steps of due tasks until `budget` is spent (at least one step)
+     * @return true if due work remains
+     * @throws std::runtime_error if the vault cannot be opened or the log saved
+     */
+    bool run_slice(std::chrono::milliseconds budget = DEFAULT_SLICE);
+
+    /**
+     * @brief Run slices on the scheduler's thread until no work is due or
+     *        pause() is called
+     *
+     * A slice that throws (vault file unavailable, log not saved) ends the
+     * run; the next resume() retries.
+     */
+    void resume();
+
+    /**
+     * @brief Stop the background run after the step in progress
+     */
+    void pause();
+
+    /// Background run in progress
+    bool running() const;
+
+    /// Names of the tasks due now, in run order
+    std::vector<std::string> due() const;
+
+    /// The maintenance log, one entry per task that has run
+    const std::vector<LogEntry>& log() const { return log_; }
+
+    /**
+     * @brief PRAGMA optimize (daily), ANALYZE (weekly), incremental vacuum
+     *        (daily) and quick_check (weekly)
+     */
+    static std::vector<Task> default_tasks();
+
+private:
+    VaultService& vault_;
+    std::vector<Task> tasks_;
+    std::vector<LogEntry> log_;
+    sqlite3* db_ = nullptr;
+
+    // Task being run, across slices
+    std::optional<size_t> current_;
+    size_t step_ = 0;
+    std::chrono::microseconds spent_{0};
+
+    // Background runs (resume()/pause())
+    std::thread worker_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    bool active_ = false;
+    bool running_ = false;
+    std::atomic<bool> stopping_{false};  // Also interrupts the running step
+
+    std::optional<size_t> next_due() const;
+    bool is_due(const Task& task) const;
+    LogEntry* entry_for(const std::string& task);
+    void finish(bool ok, const std::string& error);
+    void open();
+    void save_log();
+    void worker_loop();
+};
+
+}  // namespace vault
+}  // namespace bastionx
+
+#endif  // BASTIONX_VAULT_MAINTENANCESCHEDULER_H
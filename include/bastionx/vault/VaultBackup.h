@@ -0,0 +1,120 @@
+#ifndef BASTIONX_VAULT_VAULTBACKUP_H
+#define BASTIONX_VAULT_VAULTBACKUP_H
+
+#include "bastionx/crypto/SecureMemory.h"
+#include "bastionx/storage/ConnectionProfile.h"
+#include <sqlcipher/sqlite3.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace bastionx {
+namespace vault {
+
+/**
+ * @brief Online snapshots of an open vault through the SQLite backup API
+ *
+ * A backup copies the vault database a few pages per step() into a new
+ * file in the backup directory, so the caller can spread it over idle time
+ * and keep saving notes in between. The source connection holds one read
+ * transaction for the whole backup: in WAL mode this does not block
+ * writers, and the snapshot is the vault as of start(), never a mix of
+ * before and after a save. The WAL cannot be checkpointed past that point
+ * until the backup finishes or is cancelled.
+ *
+ * The copy is keyed with the same database key, so it is encrypted
+ * exactly like the vault. The salt sidecar is copied beside it, and a
+ * snapshot opens with VaultService and the password in use when it was
+ * taken. Snapshots are named "<stem>-YYYYMMDDTHHMMSSZ.db" (UTC); only the
+ * newest `keep` are kept.
+ */
+class VaultBackup {
+public:
+    /// Pages copied per step() by default (64 pages = 256 KiB at 4 KiB pages)
+    static constexpr int DEFAULT_PAGES_PER_STEP = 64;
+
+    enum class StepResult {
+        kMore,  ///< Pages remain; call step() again
+        kBusy,  ///< The vault was locked by a writer; retry later
+        kDone   ///< Snapshot written, older snapshots pruned
+    };
+
+    struct Snapshot {
+        std::string path;
+        std::chrono::system_clock::time_point created;
+    };
+
+    /**
+     * @param vault_path Vault database to back up
+     * @param backup_dir Directory for snapshots (created on first backup)
+     * @param keep Snapshots to keep (at least 1)
+     * @throws std::invalid_argument if keep is 0
+     */
+    VaultBackup(const std::string& vault_path, const std::string& backup_dir, size_t keep);
+    ~VaultBackup();
+
+    VaultBackup(const VaultBackup&) = delete;
+    VaultBackup& operator=(const VaultBackup&) = delete;
+
+    /**
+     * @brief Open the vault and a new snapshot file and start copying
+     * @param db_key Database key of the vault (also keys the snapshot)
+     * @param profile The vault's connection profile; the snapshot gets the
+     *        same file format
+     * @throws std::runtime_error if a backup is already running, or the
+     *         vault or backup directory cannot be opened
+     */
+    void start(const crypto::SecureKey& db_key,
+               const storage::ConnectionProfile& profile = storage::ConnectionProfile::balanced());
+
+    /**
+     * @brief Copy up to `pages` more pages
+     * @throws std::runtime_error on I/O errors (the backup is cancelled)
+     */
+    StepResult step(int pages = DEFAULT_PAGES_PER_STEP);
+
+    /**
+     * @brief Stop the running backup and delete its partial file (no-op if none)
+     */
+    void cancel();
+
+    bool in_progress() const;
+
+    /**
+     * @brief Share of pages copied so far, 0.0 to 1.0
+     */
+    double progress() const;
+
+    /**
+     * @brief Finished snapshots in the backup directory, oldest first
+     */
+    std::vector<Snapshot> snapshots() const;
+
+    void set_keep(size_t keep);
+
+    /**
+     * @brief Default backup directory: "backups" next to the vault
+     */
+    static std::string default_backup_dir(const std::string& vault_path);
+
+private:
+    std::string vault_path_;
+    std::string backup_dir_;
+    size_t keep_;
+
+    // Running backup
+    sqlite3* source_ = nullptr;
+    sqlite3* dest_ = nullptr;
+    sqlite3_backup* backup_ = nullptr;
+    std::string partial_path_;
+    std::string snapshot_path_;
+
+    void finish();
+    void close_handles();
+    void prune();
+};
+
+}  // namespace vault
+}  // namespace bastionx
+
+#endif  // BASTIONX_VAULT_VAULTBACKUP_H
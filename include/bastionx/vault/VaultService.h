@@ -3,9 +3,15 @@
 
 #include "bastionx/crypto/CryptoService.h"
 #include "bastionx/crypto/SecureMemory.h"
+#include "bastionx/storage/ConnectionPool.h"
+#include "bastionx/storage/ConnectionProfile.h"
+#include "bastionx/util/Coroutine.h"
 #include <sqlcipher/sqlite3.h>
 #include <string>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <optional>
 #include <cstdint>
 
@@ -32,6 +38,27 @@ enum class VaultState {
  *
  * Key material is stored in std::optional<SecureKey>. Locking resets these
  * optionals, which triggers SecureBuffer's destructor (sodium_memzero + sodium_free).
+ *
+ * Optionally, a short PIN can arm "quick relock": quick_lock() then wipes the
+ * plaintext keys but keeps the master key wrapped under a PIN-derived key, so
+ * quick_unlock() skips the full Argon2id derivation. It also keeps the
+ * connection pool open (its caches wiped), so quick_unlock() does not
+ * re-key the connections either. The wrapped key, and with it the pool, is
+ * destroyed after too many wrong PINs, when its lifetime ends, on lock(),
+ * and on password change.
+ *
+ * Every connection VaultService opens uses its ConnectionProfile. The
+ * profile's file format (page size, KDF rounds) is stored in the salt
+ * sidecar when the vault is created and wins over the preset on unlock;
+ * connection_profile() is what other connections to the vault should use.
+ *
+ * connection_pool() opens the vault's reader/writer pool on first use. Like
+ * the keys, it is closed by lock() and change_password(), and by a
+ * quick_lock() that falls back to lock(); all three cancel session_token().
+ *
+ * Not thread-safe: calls must come from one thread at a time (AsyncVault
+ * moves them to a worker while the owner waits). state() and
+ * is_unlocked() may be read from any thread.
  */
 class VaultService {
 public:
@@ -39,11 +66,23 @@ public:
     static constexpr char VERIFY_MARKER[33] = "BASTIONX_VAULT_VERIFY_OK_MARKER";
     static constexpr size_t VERIFY_MARKER_SIZE = 32;
 
+    /// Shortest accepted quick-unlock PIN
+    static constexpr size_t QUICK_UNLOCK_MIN_PIN_LENGTH = 4;
+    /// Default number of wrong PINs before the wrapped key is destroyed
+    static constexpr int QUICK_UNLOCK_MAX_ATTEMPTS = 3;
+    /// Argon2id cost for the PIN key (libsodium's "interactive" preset)
+    static constexpr uint64_t QUICK_UNLOCK_OPSLIMIT = crypto_pwhash_OPSLIMIT_INTERACTIVE;
+    static constexpr size_t QUICK_UNLOCK_MEMLIMIT = crypto_pwhash_MEMLIMIT_INTERACTIVE;
+
     /**
      * @brief Construct VaultService for a given vault file path
      * @param vault_path Path to the SQLite vault database file
+     * @param profile Connection settings; its file format only applies to
+     *        vaults created by this instance
      */
-    explicit VaultService(const std::string& vault_path);
+    explicit VaultService(const std::string& vault_path,
+                          const storage::ConnectionProfile& profile =
+                              storage::ConnectionProfile::balanced());
     ~VaultService();
 
     // Non-copyable, non-movable (owns sensitive key material)
@@ -88,11 +127,82 @@ public:
      */
     void lock();
 
+    // === Quick Relock ===
+
+    /**
+     * @brief Keep the master key wrapped under a PIN for fast re-unlock
+     *
+     * Derives a wrapping key from the PIN (Argon2id at interactive cost with
+     * a fresh random salt, then keyed with a random per-arming secret that
+     * only exists in locked memory) and stores the master key encrypted under
+     * it. Without that secret the wrapped key cannot be attacked offline, even
+     * with a 4-digit PIN. Replaces any previously armed PIN.
+     *
+     * @param pin Short PIN (at least QUICK_UNLOCK_MIN_PIN_LENGTH characters)
+     * @param lifetime How long the wrapped key may be used, from now
+     * @param max_attempts Consecutive wrong PINs before the wrapped key is wiped
+     * @throws std::runtime_error if vault is locked
+     * @throws std::invalid_argument if the PIN is too short or max_attempts < 1
+     */
+    void arm_quick_unlock(const std::string& pin,
+                          std::chrono::seconds lifetime,
+                          int max_attempts = QUICK_UNLOCK_MAX_ATTEMPTS);
+
+    /**
+     * @brief Lock, keeping the PIN-wrapped master key if quick relock is armed
+     *
+     * Plaintext key material is wiped exactly as in lock(). The connection
+     * pool stays open with its caches wiped (ConnectionPool::clear_caches())
+     * until quick_unlock() or disarm_quick_unlock(); its connections hold the
+     * database key, not the note keys. Falls back to a full lock() when quick
+     * relock is not armed or has expired, or the queued saves cannot be
+     * written. Every reader lease must have been returned.
+     *
+     * @note Transitions state: kUnlocked → kLocked
+     */
+    void quick_lock();
+
+    /**
+     * @brief Unlock with the quick-relock PIN instead of the master password
+     *
+     * @param pin PIN given to arm_quick_unlock()
+     * @return true if unlocked; false on a wrong PIN or if quick relock is not
+     *         available. The last allowed wrong PIN destroys the wrapped key.
+     *
+     * @note Transitions state: kLocked → kUnlocked
+     */
+    bool quick_unlock(const std::string& pin);
+
+    /**
+     * @brief Whether a PIN-wrapped key is held and still usable
+     *
+     * Wipes the wrapped key if its lifetime has ended.
+     */
+    bool quick_unlock_available();
+
+    /**
+     * @brief Destroy the PIN-wrapped master key (no-op if not armed)
+     *
+     * While quick-locked, also closes the connection pool quick_lock() kept.
+     */
+    void disarm_quick_unlock();
+
     // === State Queries ===
 
     VaultState state() const;
     bool is_unlocked() const;
 
+    /**
+     * @brief Token cancelled when this unlocked session ends
+     *
+     * Cancelled by lock(), quick_lock() and change_password(); the next
+     * call after unlocking again returns a fresh token. Work started for
+     * the session (util::Awaitable) stops at its next co_await once the
+     * session ends.
+     * @throws std::runtime_error if vault is locked
+     */
+    util::CancelToken session_token();
+
     // === Key Access ===
 
     /**
@@ -116,6 +226,24 @@ public:
      */
     const crypto::SecureKey& db_subkey() const;
 
+    /**
+     * @brief Derive the key for incremental export archives (NoteExporter)
+     *
+     * Derived from the master key on each call rather than kept unlocked.
+     * Archives written before a password change need the old password.
+     * @throws std::runtime_error if vault is locked
+     */
+    crypto::SecureKey export_key() const;
+
+    /**
+     * @brief The vault's connection pool (opened on first call)
+     *
+     * Its writer is the repository for the UI thread; background work
+     * borrows readers. Closed, interrupting reads, when the keys are wiped.
+     * @throws std::runtime_error if vault is locked or a connection fails
+     */
+    storage::ConnectionPool& connection_pool();
+
     // === Settings Persistence ===
 
     /**
@@ -132,6 +260,20 @@ public:
      */
     std::string load_settings();
 
+    /**
+     * @brief Save the maintenance log (MaintenanceScheduler), encrypted
+     *        under the settings subkey
+     * @throws std::runtime_error if vault is locked or on SQLite errors
+     */
+    void save_maintenance_log(const std::string& json_str);
+
+    /**
+     * @brief Load and decrypt the maintenance log
+     * @return JSON string, or empty string if none is stored
+     * @throws std::runtime_error if vault is locked or on SQLite errors
+     */
+    std::string load_maintenance_log();
+
     // === Password Change ===
 
     /**
@@ -154,9 +296,27 @@ public:
      */
     const std::string& vault_path() const;
 
+    /**
+     * @brief Profile for connections to this vault: the preset's connection
+     *        settings with the vault's file format (known once unlocked)
+     */
+    const storage::ConnectionProfile& connection_profile() const { return profile_; }
+
+    /**
+     * @brief Path of the salt sidecar file kept next to a vault database
+     *
+     * The salt is needed to derive the key before the database can be
+     * opened, so it is stored outside it ("<stem>.salt").
+     */
+    static std::string salt_path(const std::string& vault_path);
+
 private:
     std::string vault_path_;
-    VaultState state_;
+    std::atomic<VaultState> state_;
+    storage::ConnectionProfile profile_;
+
+    // Current unlocked session (cancelled with the pool)
+    util::CancelToken session_;
 
     // Key material (only valid when state_ == kUnlocked)
     std::optional<crypto::SecureKey> master_key_;
@@ -165,6 +325,20 @@ private:
     std::optional<crypto::SecureKey> settings_subkey_;
     std::optional<crypto::SecureKey> db_subkey_;
 
+    // Keyed connections (closed before the keys are wiped)
+    std::unique_ptr<storage::ConnectionPool> pool_;
+
+    // Quick relock: master key wrapped under a PIN-derived key
+    struct QuickUnlock {
+        std::array<uint8_t, crypto::CryptoService::SALT_BYTES> salt{};
+        crypto::SecureKey session_secret{crypto::CryptoService::KEY_BYTES};  // Never persisted
+        crypto::CryptoService::EncryptedData wrapped;
+        std::chrono::steady_clock::time_point expires_at;
+        int max_attempts = QUICK_UNLOCK_MAX_ATTEMPTS;
+        int attempts_left = QUICK_UNLOCK_MAX_ATTEMPTS;
+    };
+    std::optional<QuickUnlock> quick_unlock_;
+
     // Cached vault metadata
     std::array<uint8_t, crypto::CryptoService::SALT_BYTES> salt_{};
     uint64_t kdf_opslimit_ = 0;
@@ -172,6 +346,9 @@ private:
 
     // Internal helpers
     void wipe_keys();
+    void wipe_key_material();  // wipe_keys() without closing the pool
+    void derive_subkeys_from_master();
+    static crypto::SecureKey derive_pin_key(const std::string& pin, const QuickUnlock& quick);
     bool verify_password();
     void create_schema(sqlite3* db);
     void migrate_schema(sqlite3* db);
@@ -182,8 +359,7 @@ private:
                            std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& nonce,
                            std::vector<uint8_t>& ciphertext);
 
-    // Salt sidecar file helpers
-    static std::string salt_path(const std::string& vault_path);
+    // Salt sidecar file helpers (the sidecar also holds profile_'s file format)
     void write_salt_file(const std::array<uint8_t, crypto::CryptoService::SALT_BYTES>& salt);
     bool read_salt_file(std::array<uint8_t, crypto::CryptoService::SALT_BYTES>& salt);
 
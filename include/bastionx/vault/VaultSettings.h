@@ -15,6 +15,14 @@ struct VaultSettings {
     int auto_lock_minutes = 5;           // Range: 1-60
     bool clipboard_clear_enabled = true;
     int clipboard_clear_seconds = 30;    // Range: 10-120
+    bool quick_unlock_enabled = false;   // Offer a PIN for re-unlock after auto-lock
+    int quick_unlock_minutes = 60;       // Range: 5-480 (lifetime of the PIN-wrapped key)
+    bool cold_pack_enabled = true;       // Pack long-untouched notes into cold storage
+    int cold_pack_days = 90;             // Range: 30-3650 (age before a note is packed)
+    int revision_keep_days = 30;         // Range: 1-3650 (how long note history is kept)
+    bool backup_enabled = true;          // Snapshot the vault while the user is idle
+    int backup_interval_hours = 24;      // Range: 1-168 (time between snapshots)
+    int backup_keep = 5;                 // Range: 1-50 (snapshots kept)
 
     /// Serialize to JSON string
     std::string to_json() const;
@@ -1,4 +1,6 @@
 #include "bastionx/crypto/CryptoService.h"
+#include "bastionx/util/ThreadPool.h"
+#include <algorithm>
 #include <stdexcept>
 #include <cstring>
 
@@ -75,47 +77,171 @@ SecureKey CryptoService::derive_subkey(
     return subkey;
 }
 
+// === Algorithm Selection ===
+
+// Domain separator for per-record AES-256-GCM keys (see derive_record_key)
+static constexpr unsigned char kGcmRecordKeyLabel[] = {'B', 'X', 'G', 'C', 'M', 'v', '1'};
+
+// Nonce bytes feeding the record key; the remaining 8 form the GCM nonce
+static constexpr size_t kGcmKeyNonceBytes = 16;
+
+static_assert(crypto_aead_aes256gcm_ABYTES == crypto_aead_xchacha20poly1305_ietf_ABYTES,
+              "Both record algorithms must have the same tag size");
+
+bool CryptoService::aes256gcm_available() {
+    // Result is fixed for the process lifetime (CPU feature detection)
+    static const bool available = crypto_aead_aes256gcm_is_available() == 1;
+    return available;
+}
+
+CryptoService::Algorithm CryptoService::preferred_algorithm() {
+    return aes256gcm_available() ? Algorithm::Aes256Gcm : Algorithm::XChaCha20Poly1305;
+}
+
+SecureKey CryptoService::derive_record_key(
+    const SecureKey& subkey,
+    const std::array<uint8_t, NONCE_BYTES>& nonce
+) {
+    unsigned char input[sizeof(kGcmRecordKeyLabel) + kGcmKeyNonceBytes];
+    std::memcpy(input, kGcmRecordKeyLabel, sizeof(kGcmRecordKeyLabel));
+    std::memcpy(input + sizeof(kGcmRecordKeyLabel), nonce.data(), kGcmKeyNonceBytes);
+
+    SecureKey record_key(crypto_aead_aes256gcm_KEYBYTES);
+    crypto_generichash(
+        record_key.data(), record_key.size(),
+        input, sizeof(input),
+        subkey.data(), subkey.size()
+    );
+    return record_key;
+}
+
+// 96-bit GCM nonce: trailing 8 random nonce bytes, zero-padded
+static std::array<uint8_t, crypto_aead_aes256gcm_NPUBBYTES> gcm_nonce(
+    const std::array<uint8_t, CryptoService::NONCE_BYTES>& nonce
+) {
+    std::array<uint8_t, crypto_aead_aes256gcm_NPUBBYTES> out{};
+    std::memcpy(out.data(), nonce.data() + kGcmKeyNonceBytes,
+                CryptoService::NONCE_BYTES - kGcmKeyNonceBytes);
+    return out;
+}
+
 // === Encryption Implementation ===
 
 CryptoService::EncryptedData CryptoService::encrypt(
-    const std::vector<uint8_t>& plaintext,
+    std::span<const uint8_t> plaintext,
     const SecureKey& subkey,
-    const std::vector<uint8_t>& associated_data
+    const std::vector<uint8_t>& associated_data,
+    Algorithm algorithm
 ) {
+    if (algorithm == Algorithm::Aes256Gcm && !aes256gcm_available()) {
+        throw std::runtime_error("AES-256-GCM is not available on this CPU");
+    }
+
     EncryptedData result;
+    result.algorithm = algorithm;
 
-    // Generate random nonce (24 bytes for XChaCha20-Poly1305)
+    // Generate random nonce (24 bytes for both algorithms, see header)
     randombytes_buf(result.nonce.data(), NONCE_BYTES);
 
     // Allocate ciphertext buffer
-    // Size = plaintext + MAC tag (16 bytes for Poly1305)
+    // Size = plaintext + MAC tag (16 bytes for Poly1305 and GCM)
     result.ciphertext.resize(
         plaintext.size() + crypto_aead_xchacha20poly1305_ietf_ABYTES
     );
 
-    unsigned long long ciphertext_len;
-
-    // Encrypt using XChaCha20-Poly1305 AEAD
-    crypto_aead_xchacha20poly1305_ietf_encrypt(
-        result.ciphertext.data(),           // output: ciphertext + tag
-        &ciphertext_len,                    // output: actual ciphertext length
-        plaintext.data(),                   // input: plaintext
-        plaintext.size(),                   // input: plaintext length
-        associated_data.data(),             // AAD: additional authenticated data
-        associated_data.size(),             // AAD length
-        nullptr,                            // nsec (not used in this variant)
-        result.nonce.data(),                // nonce (24 bytes, random)
-        subkey.data()                       // key (32 bytes)
-    );
-
-    // Resize to actual length (should match allocated size)
-    result.ciphertext.resize(ciphertext_len);
+    encrypt_into(result.ciphertext.data(), plaintext, result.nonce,
+                 subkey, associated_data, algorithm);
 
     return result;
 }
 
+void CryptoService::encrypt_into(
+    unsigned char* ciphertext,
+    std::span<const uint8_t> plaintext,
+    const std::array<uint8_t, NONCE_BYTES>& nonce,
+    const SecureKey& subkey,
+    const std::vector<uint8_t>& associated_data,
+    Algorithm algorithm
+) {
+    if (algorithm == Algorithm::Aes256Gcm) {
+        // Fresh key per record: nonce reuse under one AES key is impossible
+        SecureKey record_key = derive_record_key(subkey, nonce);
+        auto short_nonce = gcm_nonce(nonce);
+
+        crypto_aead_aes256gcm_encrypt(
+            ciphertext,
+            nullptr,                            // length is always plaintext + tag
+            plaintext.data(),
+            plaintext.size(),
+            associated_data.data(),
+            associated_data.size(),
+            nullptr,
+            short_nonce.data(),
+            record_key.data()
+        );
+    } else {
+        // Encrypt using XChaCha20-Poly1305 AEAD
+        crypto_aead_xchacha20poly1305_ietf_encrypt(
+            ciphertext,                         // output: ciphertext + tag
+            nullptr,                            // length is always plaintext + tag
+            plaintext.data(),                   // input: plaintext
+            plaintext.size(),                   // input: plaintext length
+            associated_data.data(),             // AAD: additional authenticated data
+            associated_data.size(),             // AAD length
+            nullptr,                            // nsec (not used in this variant)
+            nonce.data(),                       // nonce (24 bytes, random)
+            subkey.data()                       // key (32 bytes)
+        );
+    }
+}
+
 // === Decryption Implementation ===
 
+bool CryptoService::decrypt_into(
+    unsigned char* plaintext,
+    unsigned long long* plaintext_len,
+    const EncryptedData& encrypted,
+    const SecureKey& subkey,
+    const std::vector<uint8_t>& associated_data
+) {
+    switch (encrypted.algorithm) {
+    case Algorithm::XChaCha20Poly1305:
+        // Decrypt using XChaCha20-Poly1305 AEAD
+        return crypto_aead_xchacha20poly1305_ietf_decrypt(
+            plaintext,                          // output: plaintext
+            plaintext_len,                      // output: actual plaintext length
+            nullptr,                            // nsec (not used in this variant)
+            encrypted.ciphertext.data(),        // input: ciphertext + tag
+            encrypted.ciphertext.size(),        // input: ciphertext length
+            associated_data.data(),             // AAD: must match encryption AAD
+            associated_data.size(),             // AAD length
+            encrypted.nonce.data(),             // nonce (must match encryption nonce)
+            subkey.data()                       // key (must match encryption key)
+        ) == 0;
+
+    case Algorithm::Aes256Gcm: {
+        if (!aes256gcm_available()) {
+            return false;  // Record written on AES-NI hardware; unreadable here
+        }
+        SecureKey record_key = derive_record_key(subkey, encrypted.nonce);
+        auto nonce = gcm_nonce(encrypted.nonce);
+        return crypto_aead_aes256gcm_decrypt(
+            plaintext,
+            plaintext_len,
+            nullptr,
+            encrypted.ciphertext.data(),
+            encrypted.ciphertext.size(),
+            associated_data.data(),
+            associated_data.size(),
+            nonce.data(),
+            record_key.data()
+        ) == 0;
+    }
+    }
+
+    return false;  // Unknown algorithm identifier
+}
+
 std::optional<std::vector<uint8_t>> CryptoService::decrypt(
     const EncryptedData& encrypted,
     const SecureKey& subkey,
@@ -126,24 +252,12 @@ std::optional<std::vector<uint8_t>> CryptoService::decrypt(
     std::vector<uint8_t> plaintext(encrypted.ciphertext.size());
     unsigned long long plaintext_len;
 
-    // Decrypt using XChaCha20-Poly1305 AEAD
-    int rc = crypto_aead_xchacha20poly1305_ietf_decrypt(
-        plaintext.data(),                   // output: plaintext
-        &plaintext_len,                     // output: actual plaintext length
-        nullptr,                            // nsec (not used in this variant)
-        encrypted.ciphertext.data(),        // input: ciphertext + tag
-        encrypted.ciphertext.size(),        // input: ciphertext length
-        associated_data.data(),             // AAD: must match encryption AAD
-        associated_data.size(),             // AAD length
-        encrypted.nonce.data(),             // nonce (must match encryption nonce)
-        subkey.data()                       // key (must match encryption key)
-    );
-
-    if (rc != 0) {
+    if (!decrypt_into(plaintext.data(), &plaintext_len, encrypted, subkey, associated_data)) {
         // Decryption failed - either:
         // 1. MAC verification failed (wrong key or tampered ciphertext)
         // 2. AAD mismatch (ciphertext swapped to different context)
         // 3. Corrupted ciphertext
+        // 4. Algorithm unavailable or unknown
         return std::nullopt;
     }
 
@@ -153,5 +267,151 @@ std::optional<std::vector<uint8_t>> CryptoService::decrypt(
     return plaintext;
 }
 
+std::optional<SecureBytes> CryptoService::decrypt_secure(
+    const EncryptedData& encrypted,
+    const SecureKey& subkey,
+    const std::vector<uint8_t>& associated_data
+) {
+    if (encrypted.ciphertext.size() < crypto_aead_xchacha20poly1305_ietf_ABYTES) {
+        return std::nullopt;
+    }
+
+    // Exact plaintext size up front: no reallocation, no stray heap copy
+    SecureBytes plaintext(
+        encrypted.ciphertext.size() - crypto_aead_xchacha20poly1305_ietf_ABYTES);
+    unsigned long long plaintext_len;
+
+    if (!decrypt_into(plaintext.data(), &plaintext_len, encrypted, subkey, associated_data)) {
+        return std::nullopt;  // Buffer is wiped by SecureAllocator on release
+    }
+
+    plaintext.resize(plaintext_len);
+    return plaintext;
+}
+
+// === Batch Implementation ===
+
+// Run fn(begin, end) over [0, count), split into byte-balanced shards on the
+// shared pool when the batch is large enough to be worth the hand-off.
+// `byte_offsets` has count + 1 cumulative entries.
+template<typename Fn>
+static void run_sharded(const std::vector<size_t>& byte_offsets, size_t count, Fn&& fn) {
+    auto& pool = util::ThreadPool::shared();
+    size_t total = byte_offsets[count];
+
+    if (count < 2 || total < CryptoService::BATCH_PARALLEL_MIN_BYTES) {
+        fn(size_t{0}, count);
+        return;
+    }
+
+    // A few shards per thread so one large record does not stall the batch
+    size_t shard_count = std::min(count, (pool.thread_count() + 1) * 4);
+    std::vector<size_t> bounds{0};
+    for (size_t s = 1; s < shard_count; ++s) {
+        size_t target = total / shard_count * s;
+        size_t i = bounds.back();
+        while (i < count && byte_offsets[i] < target) {
+            ++i;
+        }
+        if (i > bounds.back() && i < count) {
+            bounds.push_back(i);
+        }
+    }
+    bounds.push_back(count);
+
+    pool.parallel_for(bounds.size() - 1, [&](size_t shard) {
+        fn(bounds[shard], bounds[shard + 1]);
+    });
+}
+
+CryptoService::EncryptedBatch CryptoService::encrypt_many(
+    std::span<const std::span<const uint8_t>> plaintexts,
+    const SecureKey& subkey,
+    std::span<const std::vector<uint8_t>> associated_data,
+    Algorithm algorithm
+) {
+    if (associated_data.size() != plaintexts.size()) {
+        throw std::invalid_argument("encrypt_many: one AAD per record required");
+    }
+    if (algorithm == Algorithm::Aes256Gcm && !aes256gcm_available()) {
+        throw std::runtime_error("AES-256-GCM is not available on this CPU");
+    }
+
+    const size_t count = plaintexts.size();
+    EncryptedBatch batch;
+    batch.algorithm = algorithm;
+
+    // Layout: every ciphertext is plaintext + tag, so offsets are known up front
+    batch.offsets.resize(count + 1);
+    batch.offsets[0] = 0;
+    for (size_t i = 0; i < count; ++i) {
+        batch.offsets[i + 1] = batch.offsets[i] + plaintexts[i].size() +
+                               crypto_aead_xchacha20poly1305_ietf_ABYTES;
+    }
+    batch.arena.resize(batch.offsets[count]);
+
+    // One CSPRNG call for every nonce in the batch
+    batch.nonces.resize(count);
+    if (count > 0) {
+        randombytes_buf(batch.nonces.data(), count * NONCE_BYTES);
+    }
+
+    run_sharded(batch.offsets, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            encrypt_into(batch.arena.data() + batch.offsets[i], plaintexts[i],
+                         batch.nonces[i], subkey, associated_data[i], algorithm);
+        }
+    });
+
+    return batch;
+}
+
+CryptoService::DecryptedBatch CryptoService::decrypt_many(
+    std::span<const EncryptedData> records,
+    const SecureKey& subkey,
+    std::span<const std::vector<uint8_t>> associated_data
+) {
+    if (associated_data.size() != records.size()) {
+        throw std::invalid_argument("decrypt_many: one AAD per record required");
+    }
+
+    const size_t count = records.size();
+    constexpr size_t tag = crypto_aead_xchacha20poly1305_ietf_ABYTES;
+
+    DecryptedBatch batch;
+    batch.ok.assign(count, 0);
+
+    // Exact plaintext sizes up front; too-short records get an empty slot
+    batch.offsets.resize(count + 1);
+    batch.offsets[0] = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t ct = records[i].ciphertext.size();
+        batch.offsets[i + 1] = batch.offsets[i] + (ct >= tag ? ct - tag : 0);
+    }
+    batch.arena.resize(batch.offsets[count]);
+
+    run_sharded(batch.offsets, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (records[i].ciphertext.size() < tag) {
+                continue;
+            }
+            unsigned long long plaintext_len;
+            bool ok = decrypt_into(batch.arena.data() + batch.offsets[i], &plaintext_len,
+                                   records[i], subkey, associated_data[i]);
+            batch.ok[i] = ok ? 1 : 0;
+        }
+    });
+
+    // Never expose partially written output of a record that failed to verify
+    for (size_t i = 0; i < count; ++i) {
+        if (!batch.ok[i]) {
+            sodium_memzero(batch.arena.data() + batch.offsets[i],
+                           batch.offsets[i + 1] - batch.offsets[i]);
+        }
+    }
+
+    return batch;
+}
+
 }  // namespace crypto
 }  // namespace bastionx
@@ -0,0 +1,81 @@
+#include "bastionx/crypto/SecretStream.h"
+#include <stdexcept>
+
+namespace bastionx {
+namespace crypto {
+
+using stream_state = crypto_secretstream_xchacha20poly1305_state;
+
+static stream_state* as_state(SecureBuffer<unsigned char, ArenaAllocator>& buf) {
+    return reinterpret_cast<stream_state*>(buf.data());
+}
+
+// === SecretStreamWriter ===
+
+SecretStreamWriter::SecretStreamWriter(const SecureKey& key)
+    : state_(sizeof(stream_state)) {
+    if (key.size() != crypto_secretstream_xchacha20poly1305_KEYBYTES) {
+        throw std::invalid_argument("SecretStreamWriter: invalid key size");
+    }
+    crypto_secretstream_xchacha20poly1305_init_push(as_state(state_), header_.data(), key.data());
+}
+
+void SecretStreamWriter::push(std::span<const uint8_t> chunk,
+                              std::span<const uint8_t> associated_data,
+                              bool final,
+                              std::vector<uint8_t>& out) {
+    out.resize(chunk.size() + ABYTES);
+    crypto_secretstream_xchacha20poly1305_push(
+        as_state(state_),
+        out.data(), nullptr,
+        chunk.data(), chunk.size(),
+        associated_data.data(), associated_data.size(),
+        final ? crypto_secretstream_xchacha20poly1305_TAG_FINAL
+              : crypto_secretstream_xchacha20poly1305_TAG_MESSAGE
+    );
+}
+
+// === SecretStreamReader ===
+
+SecretStreamReader::SecretStreamReader(const SecureKey& key, std::span<const uint8_t> header)
+    : state_(sizeof(stream_state)) {
+    if (key.size() != crypto_secretstream_xchacha20poly1305_KEYBYTES) {
+        throw std::invalid_argument("SecretStreamReader: invalid key size");
+    }
+    if (header.size() != HEADER_BYTES ||
+        crypto_secretstream_xchacha20poly1305_init_pull(
+            as_state(state_), header.data(), key.data()) != 0) {
+        throw std::invalid_argument("SecretStreamReader: invalid stream header");
+    }
+}
+
+bool SecretStreamReader::pull(std::span<const uint8_t> ciphertext,
+                              std::span<const uint8_t> associated_data,
+                              unsigned char* out,
+                              size_t* out_len) {
+    // Nothing may follow the final chunk, and a failed stream stays failed
+    if (failed_ || finished_ || ciphertext.size() < ABYTES) {
+        failed_ = true;
+        return false;
+    }
+
+    unsigned long long len = 0;
+    unsigned char tag = 0;
+    int rc = crypto_secretstream_xchacha20poly1305_pull(
+        as_state(state_),
+        out, &len, &tag,
+        ciphertext.data(), ciphertext.size(),
+        associated_data.data(), associated_data.size()
+    );
+    if (rc != 0) {
+        failed_ = true;
+        return false;
+    }
+
+    finished_ = (tag == crypto_secretstream_xchacha20poly1305_TAG_FINAL);
+    *out_len = static_cast<size_t>(len);
+    return true;
+}
+
+}  // namespace crypto
+}  // namespace bastionx
@@ -0,0 +1,204 @@
+#include "bastionx/crypto/SecureArena.h"
+#include <sodium.h>
+#include <bit>
+#include <stdexcept>
+
+namespace bastionx {
+namespace crypto {
+
+// Page granularity used to estimate the locked footprint of fallback blocks
+static constexpr size_t kPageBytes = 4096;
+
+// === Construction ===
+
+SecureArena& SecureArena::instance() {
+    static SecureArena arena;
+    return arena;
+}
+
+SecureArena::SecureArena(size_t slab_count) {
+    if (slab_count == 0) {
+        return;
+    }
+
+    // One sodium_malloc for the whole region: locked, guard pages, canary
+    region_bytes_ = slab_count * kSlabBytes;
+    region_ = static_cast<unsigned char*>(sodium_malloc(region_bytes_));
+
+    if (region_ == nullptr) {
+        // Degrade to fallback-only mode rather than failing every allocation
+        region_bytes_ = 0;
+        return;
+    }
+
+    sodium_memzero(region_, region_bytes_);
+    slabs_.resize(slab_count);
+    stats_.region_bytes = region_bytes_;
+}
+
+SecureArena::~SecureArena() {
+    if (region_ != nullptr) {
+        sodium_memzero(region_, region_bytes_);
+        sodium_free(region_);
+        region_ = nullptr;
+    }
+}
+
+// === Allocation ===
+
+void* SecureArena::allocate(size_t bytes) {
+    if (bytes == 0) {
+        throw std::invalid_argument("SecureArena: zero-size allocation");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int size_class = size_class_for(bytes);
+    if (size_class >= 0 && region_ != nullptr) {
+        void* block = allocate_from_slab(size_class);
+        if (block != nullptr) {
+            size_t rounded = block_bytes(size_class);
+            stats_.slab_bytes_in_use += rounded;
+            if (stats_.slab_bytes_in_use > stats_.peak_slab_bytes_in_use) {
+                stats_.peak_slab_bytes_in_use = stats_.slab_bytes_in_use;
+            }
+            stats_.live_allocations++;
+            stats_.total_allocations++;
+            return block;
+        }
+    }
+
+    // Too large for a slab, or region exhausted: dedicated guarded allocation
+    void* block = sodium_malloc(bytes);
+    if (block == nullptr) {
+        throw std::runtime_error("Failed to allocate secure memory");
+    }
+
+    stats_.fallback_bytes_in_use += fallback_footprint(bytes);
+    stats_.live_allocations++;
+    stats_.total_allocations++;
+    stats_.fallback_allocations++;
+    return block;
+}
+
+void SecureArena::deallocate(void* ptr, size_t bytes) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!owns(ptr)) {
+        sodium_memzero(ptr, bytes);
+        sodium_free(ptr);
+        stats_.fallback_bytes_in_use -= fallback_footprint(bytes);
+        stats_.live_allocations--;
+        return;
+    }
+
+    size_t offset = static_cast<size_t>(static_cast<unsigned char*>(ptr) - region_);
+    Slab& slab = slabs_[offset / kSlabBytes];
+    size_t rounded = block_bytes(slab.size_class);
+    size_t index = (offset % kSlabBytes) / rounded;
+
+    // Wipe the whole block, not just the bytes the caller asked for
+    sodium_memzero(ptr, rounded);
+
+    slab.used[index / 64] &= ~(uint64_t{1} << (index % 64));
+    slab.used_count--;
+    if (slab.used_count == 0) {
+        // Hand the empty slab back so any size class can claim it
+        slab.size_class = kUnassigned;
+    }
+
+    stats_.slab_bytes_in_use -= rounded;
+    stats_.live_allocations--;
+}
+
+bool SecureArena::owns(const void* ptr) const noexcept {
+    if (region_ == nullptr || ptr == nullptr) {
+        return false;
+    }
+    auto p = reinterpret_cast<std::uintptr_t>(ptr);
+    auto base = reinterpret_cast<std::uintptr_t>(region_);
+    return p >= base && p < base + region_bytes_;
+}
+
+SecureArena::Stats SecureArena::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// === Private Helpers ===
+
+void* SecureArena::allocate_from_slab(int size_class) {
+    size_t rounded = block_bytes(size_class);
+    size_t blocks_per_slab = kSlabBytes / rounded;
+
+    // Prefer a partially used slab of the same class, starting at the hint,
+    // then claim an unassigned one
+    size_t candidate = slabs_.size();
+    for (size_t n = 0; n < slabs_.size(); ++n) {
+        size_t i = (hint_[size_class] + n) % slabs_.size();
+        if (slabs_[i].size_class == size_class && slabs_[i].used_count < blocks_per_slab) {
+            candidate = i;
+            break;
+        }
+    }
+    if (candidate == slabs_.size()) {
+        for (size_t i = 0; i < slabs_.size(); ++i) {
+            if (slabs_[i].size_class == kUnassigned) {
+                slabs_[i].size_class = size_class;
+                candidate = i;
+                break;
+            }
+        }
+    }
+    if (candidate == slabs_.size()) {
+        return nullptr;  // Region exhausted
+    }
+
+    Slab& slab = slabs_[candidate];
+    hint_[size_class] = candidate;
+
+    // First clear bit; bits past blocks_per_slab are never set, and the
+    // used_count check above guarantees one exists below that bound
+    for (size_t w = 0; w < kBitmapWords; ++w) {
+        if (slab.used[w] != ~uint64_t{0}) {
+            size_t b = w * 64 + static_cast<size_t>(std::countr_one(slab.used[w]));
+            if (b >= blocks_per_slab) {
+                break;
+            }
+            slab.used[w] |= uint64_t{1} << (b % 64);
+            slab.used_count++;
+            return region_ + candidate * kSlabBytes + b * rounded;
+        }
+    }
+    return nullptr;  // Unreachable: used_count said a block was free
+}
+
+int SecureArena::size_class_for(size_t bytes) noexcept {
+    if (bytes > kMaxBlockBytes) {
+        return -1;
+    }
+    int size_class = 0;
+    size_t block = kMinBlockBytes;
+    while (block < bytes) {
+        block <<= 1;
+        size_class++;
+    }
+    return size_class;
+}
+
+size_t SecureArena::block_bytes(int size_class) noexcept {
+    return kMinBlockBytes << size_class;
+}
+
+size_t SecureArena::fallback_footprint(size_t bytes) noexcept {
+    // sodium_malloc locks the user pages (data + canary), rounded to a page
+    size_t with_canary = bytes + 16;
+    return ((with_canary + kPageBytes - 1) / kPageBytes) * kPageBytes;
+}
+
+}  // namespace crypto
+}  // namespace bastionx
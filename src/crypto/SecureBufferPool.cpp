@@ -0,0 +1,111 @@
+#include "bastionx/crypto/SecureBufferPool.h"
+#include <sodium.h>
+#include <stdexcept>
+
+namespace bastionx {
+namespace crypto {
+
+SecureBufferPool& SecureBufferPool::instance() {
+    static SecureBufferPool pool;
+    return pool;
+}
+
+SecureBufferPool::SecureBufferPool(size_t idle_budget_bytes)
+    : idle_budget_bytes_(idle_budget_bytes) {
+}
+
+SecureBufferPool::~SecureBufferPool() {
+    trim();
+}
+
+size_t SecureBufferPool::capacity_for(size_t bytes) noexcept {
+    if (bytes > kMaxPooledBlockBytes) {
+        return bytes;  // Not pooled: exact size
+    }
+    size_t capacity = kMinBlockBytes;
+    while (capacity < bytes) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+void* SecureBufferPool::acquire(size_t bytes) {
+    size_t capacity = capacity_for(bytes);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.acquires++;
+
+        auto it = idle_.find(capacity);
+        if (it != idle_.end() && !it->second.empty()) {
+            void* block = it->second.back();
+            it->second.pop_back();
+            stats_.reuse_hits++;
+            stats_.idle_bytes -= capacity;
+            stats_.idle_blocks--;
+            stats_.live_bytes += capacity;
+            return block;
+        }
+    }
+
+    // Miss: allocate outside the lock (sodium_malloc is several syscalls)
+    void* block = sodium_malloc(capacity);
+    if (block == nullptr) {
+        throw std::runtime_error("Failed to allocate secure memory");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.fresh_allocs++;
+    stats_.live_bytes += capacity;
+    return block;
+}
+
+void SecureBufferPool::release(void* ptr, size_t bytes) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    // Every byte the caller could have touched is wiped before reuse
+    sodium_memzero(ptr, bytes);
+
+    size_t capacity = capacity_for(bytes);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.live_bytes -= capacity;
+
+        if (capacity <= kMaxPooledBlockBytes &&
+            stats_.idle_bytes + capacity <= idle_budget_bytes_) {
+            idle_[capacity].push_back(ptr);
+            stats_.idle_bytes += capacity;
+            stats_.idle_blocks++;
+            return;
+        }
+    }
+
+    sodium_free(ptr);
+}
+
+void SecureBufferPool::trim() noexcept {
+    std::map<size_t, std::vector<void*>> drained;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drained.swap(idle_);
+        stats_.idle_bytes = 0;
+        stats_.idle_blocks = 0;
+    }
+
+    // Idle blocks were wiped on release; sodium_free wipes again anyway
+    for (auto& [capacity, blocks] : drained) {
+        for (void* block : blocks) {
+            sodium_free(block);
+        }
+    }
+}
+
+SecureBufferPool::Stats SecureBufferPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace crypto
+}  // namespace bastionx
@@ -0,0 +1,226 @@
+#include "bastionx/storage/AsyncNotesRepository.h"
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace bastionx {
+namespace storage {
+
+AsyncNotesRepository::AsyncNotesRepository(NotesRepository& repo, Dispatcher dispatcher)
+    : repo_(repo), dispatcher_(std::move(dispatcher))
+{
+    thread_ = std::thread([this] { worker_loop(); });
+}
+
+AsyncNotesRepository::AsyncNotesRepository(ConnectionPool& pool, Dispatcher dispatcher)
+    : repo_(pool.writer()), pool_(&pool), dispatcher_(std::move(dispatcher)),
+      readers_(std::make_unique<util::ThreadPool>(pool.reader_count()))
+{
+    thread_ = std::thread([this] { worker_loop(); });
+}
+
+AsyncNotesRepository::~AsyncNotesRepository() {
+    close(CloseMode::kDrain);
+}
+
+void AsyncNotesRepository::enqueue(Request request) {
+    std::optional<Request> dropped;
+    {
+        std::lock_guard lock(mutex_);
+        if (closed_) {
+            throw std::runtime_error("Storage thread is closed");
+        }
+        request.generation = read_generation_;
+        if (request.kind == Kind::kPrefetch) {
+            if (prefetch_queue_.size() >= kMaxQueuedPrefetches) {
+                dropped = std::move(prefetch_queue_.front());
+                prefetch_queue_.pop_front();
+            }
+            prefetch_queue_.push_back(std::move(request));
+        } else {
+            queue_.push_back(std::move(request));
+        }
+    }
+    wake_.notify_one();
+    if (dropped.has_value()) {
+        dropped->cancel();
+    }
+}
+
+void AsyncNotesRepository::deliver(std::function<void()> callback) {
+    auto guarded = [alive = alive_, callback = std::move(callback)] {
+        if (*alive) {
+            callback();
+        }
+    };
+    if (dispatcher_) {
+        dispatcher_(std::move(guarded));
+    } else {
+        guarded();
+    }
+}
+
+void AsyncNotesRepository::worker_loop() {
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait(lock, [this] {
+                return stopping_ || !queue_.empty() || !prefetch_queue_.empty();
+            });
+            // Foreground requests first; a prefetch only when none is waiting
+            auto& source = !queue_.empty() ? queue_ : prefetch_queue_;
+            if (source.empty()) {
+                return;  // stopping_ and nothing left to run
+            }
+            request = std::move(source.front());
+            source.pop_front();
+            running_ = true;
+        }
+
+        if (request.kind == Kind::kSnapshot && readers_) {
+            start_snapshot(std::move(request));
+        } else {
+            run_on_writer(request);
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            running_ = false;
+        }
+        idle_.notify_all();
+    }
+}
+
+void AsyncNotesRepository::run_on_writer(Request& request) {
+    request.run([this]() -> NotesRepository& { return repo_; });
+}
+
+void AsyncNotesRepository::start_snapshot(Request request) {
+    // Readers only see committed rows: commit the saves queued before this
+    try {
+        repo_.flush_writes();
+    } catch (const std::runtime_error&) {
+        // The saves are still queued in the writer, which reads past them
+        run_on_writer(request);
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        ++snapshots_running_;
+    }
+    readers_->post([this, request = std::move(request)]() mutable {
+        bool cancelled;
+        {
+            std::lock_guard lock(mutex_);
+            cancelled = request.generation != read_generation_;
+        }
+        if (cancelled) {
+            request.cancel();  // cancel_reads() while it waited for a reader
+        } else {
+            std::optional<ConnectionPool::ReadLease> lease;
+            request.run([this, &lease]() -> NotesRepository& {
+                lease.emplace(pool_->read());
+                return lease->repo();
+            });
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            --snapshots_running_;
+        }
+        idle_.notify_all();
+    });
+}
+
+size_t AsyncNotesRepository::cancel_reads() {
+    std::vector<Request> dropped;
+    {
+        std::lock_guard lock(mutex_);
+        ++read_generation_;
+        std::move(prefetch_queue_.begin(), prefetch_queue_.end(), std::back_inserter(dropped));
+        prefetch_queue_.clear();
+        for (auto it = queue_.begin(); it != queue_.end();) {
+            if (it->kind == Kind::kRead || it->kind == Kind::kSnapshot) {
+                dropped.push_back(std::move(*it));
+                it = queue_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    // Outside the lock: a cancelled future may have a waiter to wake
+    for (auto& request : dropped) {
+        request.cancel();
+    }
+    return dropped.size();
+}
+
+size_t AsyncNotesRepository::cancel_prefetches() {
+    std::deque<Request> dropped;
+    {
+        std::lock_guard lock(mutex_);
+        dropped.swap(prefetch_queue_);
+    }
+    for (auto& request : dropped) {
+        request.cancel();
+    }
+    return dropped.size();
+}
+
+void AsyncNotesRepository::drain() {
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this] {
+        return queue_.empty() && prefetch_queue_.empty() && !running_ &&
+               snapshots_running_ == 0;
+    });
+}
+
+void AsyncNotesRepository::close(CloseMode mode) {
+    {
+        std::lock_guard lock(mutex_);
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+    }
+
+    if (mode == CloseMode::kCancelReads) {
+        cancel_reads();
+        if (pool_ != nullptr) {
+            pool_->interrupt_reads();
+        }
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+    readers_.reset();  // Waits for the snapshots handed to reader threads
+
+    // The thread is gone; the repository is the caller's again
+    try {
+        repo_.flush_writes();
+    } catch (const std::runtime_error&) {
+        // Still queued in the repository, which retries when it closes
+    }
+    *alive_ = false;
+}
+
+bool AsyncNotesRepository::is_open() const {
+    std::lock_guard lock(mutex_);
+    return !closed_;
+}
+
+size_t AsyncNotesRepository::pending() const {
+    std::lock_guard lock(mutex_);
+    return queue_.size() + prefetch_queue_.size() + (running_ ? 1 : 0) + snapshots_running_;
+}
+
+}  // namespace storage
+}  // namespace bastionx
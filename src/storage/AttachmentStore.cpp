@@ -0,0 +1,540 @@
+#include "bastionx/storage/AttachmentStore.h"
+#include "bastionx/crypto/SecretStream.h"
+#include "bastionx/storage/RecordAad.h"
+#include <sodium.h>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace bastionx {
+namespace storage {
+
+// vault_keys purpose of the content ID hash key
+static constexpr char kContentKeyPurpose[] = "attachment-content-id";
+
+// === RAII wrapper for sqlite3_stmt* ===
+
+class ScopedStmt {
+public:
+    ScopedStmt(sqlite3* db, const std::string& sql) : stmt_(nullptr) {
+        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt_, nullptr);
+        if (rc != SQLITE_OK) {
+            throw std::runtime_error(
+                "Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
+        }
+    }
+
+    ~ScopedStmt() {
+        if (stmt_) sqlite3_finalize(stmt_);
+    }
+
+    ScopedStmt(const ScopedStmt&) = delete;
+    ScopedStmt& operator=(const ScopedStmt&) = delete;
+
+    sqlite3_stmt* get() const { return stmt_; }
+
+private:
+    sqlite3_stmt* stmt_;
+};
+
+static void exec_sql(sqlite3* db, const std::string& sql) {
+    char* err_msg = nullptr;
+    int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &err_msg);
+    if (rc != SQLITE_OK) {
+        std::string err = err_msg ? err_msg : "unknown error";
+        sqlite3_free(err_msg);
+        throw std::runtime_error("SQL error: " + err);
+    }
+}
+
+static void step_done(sqlite3* db, sqlite3_stmt* stmt, const char* what) {
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        throw std::runtime_error(std::string(what) + ": " + sqlite3_errmsg(db));
+    }
+}
+
+// Read an encrypted record from columns (nonce, ciphertext, alg) starting at
+// `first_col`. Returns nullopt for malformed rows.
+static std::optional<crypto::CryptoService::EncryptedData> read_encrypted_columns(
+    sqlite3_stmt* stmt, int first_col)
+{
+    const void* nonce_blob = sqlite3_column_blob(stmt, first_col);
+    int nonce_size = sqlite3_column_bytes(stmt, first_col);
+    const void* ct_blob = sqlite3_column_blob(stmt, first_col + 1);
+    int ct_size = sqlite3_column_bytes(stmt, first_col + 1);
+    if (nonce_size != static_cast<int>(crypto::CryptoService::NONCE_BYTES) || !nonce_blob ||
+        ct_size <= 0 || !ct_blob) {
+        return std::nullopt;
+    }
+
+    crypto::CryptoService::EncryptedData encrypted;
+    std::memcpy(encrypted.nonce.data(), nonce_blob, crypto::CryptoService::NONCE_BYTES);
+    encrypted.ciphertext.assign(
+        static_cast<const uint8_t*>(ct_blob),
+        static_cast<const uint8_t*>(ct_blob) + ct_size);
+    encrypted.algorithm = static_cast<crypto::CryptoService::Algorithm>(
+        sqlite3_column_int(stmt, first_col + 2));
+    return encrypted;
+}
+
+static void bind_encrypted(sqlite3_stmt* stmt, int first_col,
+                           const crypto::CryptoService::EncryptedData& encrypted)
+{
+    sqlite3_bind_blob(stmt, first_col, encrypted.nonce.data(),
+                      static_cast<int>(encrypted.nonce.size()), SQLITE_STATIC);
+    sqlite3_bind_blob(stmt, first_col + 1, encrypted.ciphertext.data(),
+                      static_cast<int>(encrypted.ciphertext.size()), SQLITE_STATIC);
+    sqlite3_bind_int(stmt, first_col + 2, static_cast<int>(encrypted.algorithm));
+}
+
+// === AttachmentStore Implementation ===
+
+AttachmentStore::AttachmentStore(const std::string& db_path, const crypto::SecureKey* db_key,
+                                 const ConnectionProfile& profile)
+    : db_(nullptr), db_path_(db_path) {
+    int rc = sqlite3_open(db_path.c_str(), &db_);
+    if (rc != SQLITE_OK) {
+        std::string err = db_ ? sqlite3_errmsg(db_) : "unknown error";
+        if (db_) sqlite3_close(db_);
+        db_ = nullptr;
+        throw std::runtime_error("Failed to open database: " + err);
+    }
+
+    if (db_key) {
+        rc = sqlite3_key(db_, db_key->data(), static_cast<int>(db_key->size()));
+        if (rc != SQLITE_OK) {
+            std::string err = sqlite3_errmsg(db_);
+            sqlite3_close(db_);
+            db_ = nullptr;
+            throw std::runtime_error("Failed to set encryption key: " + err);
+        }
+    }
+
+    try {
+        profile.apply(db_, db_key != nullptr);
+    } catch (...) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+        throw;
+    }
+}
+
+AttachmentStore::~AttachmentStore() {
+    close();
+}
+
+void AttachmentStore::close() {
+    content_key_.reset();
+    if (db_) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+    }
+}
+
+bool AttachmentStore::is_open() const {
+    return db_ != nullptr;
+}
+
+std::optional<int64_t> AttachmentStore::attach(int64_t note_id, const std::string& name,
+                                               const std::string& mime_type,
+                                               const Source& source,
+                                               const crypto::SecureKey& subkey)
+{
+    if (name.size() > std::numeric_limits<uint16_t>::max()) {
+        throw std::invalid_argument("Attachment name too long");
+    }
+    const crypto::SecureKey& hash_key = content_key(subkey);
+
+    exec_sql(db_, "BEGIN TRANSACTION;");
+    try {
+        {
+            ScopedStmt stmt(db_, "SELECT 1 FROM notes WHERE id = ?");
+            sqlite3_bind_int64(stmt.get(), 1, note_id);
+            if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+                exec_sql(db_, "ROLLBACK;");
+                return std::nullopt;
+            }
+        }
+
+        // Placeholder row for the ID the AADs need (content ID unknown yet)
+        {
+            ScopedStmt stmt(db_,
+                "INSERT INTO attachments (content_id, nonce, ciphertext, header, size, "
+                "chunk_count, created_at) "
+                "VALUES (randomblob(32), zeroblob(24), zeroblob(1), zeroblob(1), 0, 0, ?)");
+            sqlite3_bind_int64(stmt.get(), 1, current_timestamp());
+            step_done(db_, stmt.get(), "Failed to insert attachment");
+        }
+        int64_t attachment_id = sqlite3_last_insert_rowid(db_);
+
+        crypto::SecureKey stream_key(crypto_secretstream_xchacha20poly1305_KEYBYTES);
+        randombytes_buf(stream_key.data(), stream_key.size());
+        crypto::SecretStreamWriter writer(stream_key);
+        auto chunk_aad = RecordAad::attachment_chunk(attachment_id);
+
+        crypto_generichash_state hash;
+        crypto_generichash_init(&hash, hash_key.data(), hash_key.size(), kContentIdBytes);
+
+        ScopedStmt insert_stmt(db_,
+            "INSERT INTO attachment_chunks (attachment_id, seq, data) VALUES (?, ?, ?)");
+
+        // Read one chunk ahead, so the last one can be tagged final
+        auto fill = [&](crypto::SecureBytes& buffer) {
+            buffer.resize(kChunkBytes);
+            size_t filled = 0;
+            while (filled < buffer.size()) {
+                size_t n = source(std::span<uint8_t>(buffer).subspan(filled));
+                if (n == 0) {
+                    break;
+                }
+                filled += n;
+            }
+            buffer.resize(filled);
+        };
+
+        crypto::SecureBytes current;
+        crypto::SecureBytes next;
+        std::vector<uint8_t> ciphertext;
+        uint64_t size = 0;
+        int64_t seq = 0;
+        fill(current);
+        while (true) {
+            bool final = current.size() < kChunkBytes;
+            if (!final) {
+                fill(next);
+                final = next.empty();
+            }
+
+            crypto_generichash_update(&hash, current.data(), current.size());
+            writer.push(current, chunk_aad, final, ciphertext);
+            size += current.size();
+
+            sqlite3_reset(insert_stmt.get());
+            sqlite3_bind_int64(insert_stmt.get(), 1, attachment_id);
+            sqlite3_bind_int64(insert_stmt.get(), 2, seq++);
+            sqlite3_bind_blob(insert_stmt.get(), 3, ciphertext.data(),
+                              static_cast<int>(ciphertext.size()), SQLITE_STATIC);
+            step_done(db_, insert_stmt.get(), "Failed to store attachment chunk");
+
+            if (final) {
+                break;
+            }
+            std::swap(current, next);
+        }
+
+        std::array<uint8_t, kContentIdBytes> content_id{};
+        crypto_generichash_final(&hash, content_id.data(), content_id.size());
+
+        // Same contents already stored: link to those and drop this copy
+        std::optional<int64_t> existing;
+        {
+            ScopedStmt stmt(db_, "SELECT attachment_id FROM attachments WHERE content_id = ?");
+            sqlite3_bind_blob(stmt.get(), 1, content_id.data(),
+                              static_cast<int>(content_id.size()), SQLITE_STATIC);
+            if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+                existing = sqlite3_column_int64(stmt.get(), 0);
+            }
+        }
+
+        if (existing.has_value()) {
+            for (const char* sql : {"DELETE FROM attachment_chunks WHERE attachment_id = ?",
+                                    "DELETE FROM attachments WHERE attachment_id = ?"}) {
+                ScopedStmt stmt(db_, sql);
+                sqlite3_bind_int64(stmt.get(), 1, attachment_id);
+                step_done(db_, stmt.get(), "Failed to drop duplicate attachment");
+            }
+            attachment_id = *existing;
+        } else {
+            auto wrapped = crypto::CryptoService::encrypt(
+                stream_key.span(), subkey, RecordAad::attachment_key(attachment_id),
+                crypto::CryptoService::preferred_algorithm());
+            ScopedStmt stmt(db_,
+                "UPDATE attachments SET content_id = ?, nonce = ?, ciphertext = ?, alg = ?, "
+                "header = ?, size = ?, chunk_count = ? WHERE attachment_id = ?");
+            sqlite3_bind_blob(stmt.get(), 1, content_id.data(),
+                              static_cast<int>(content_id.size()), SQLITE_STATIC);
+            bind_encrypted(stmt.get(), 2, wrapped);
+            sqlite3_bind_blob(stmt.get(), 5, writer.header().data(),
+                              static_cast<int>(writer.header().size()), SQLITE_STATIC);
+            sqlite3_bind_int64(stmt.get(), 6, static_cast<int64_t>(size));
+            sqlite3_bind_int64(stmt.get(), 7, seq);
+            sqlite3_bind_int64(stmt.get(), 8, attachment_id);
+            step_done(db_, stmt.get(), "Failed to store attachment");
+        }
+
+        // Link (name and type are per note)
+        auto link = crypto::CryptoService::encrypt(
+            encode_link(name, mime_type), subkey, RecordAad::attachment_link(note_id, attachment_id),
+            crypto::CryptoService::preferred_algorithm());
+        {
+            ScopedStmt stmt(db_,
+                "INSERT OR REPLACE INTO attachment_refs "
+                "(note_id, attachment_id, nonce, ciphertext, alg, created_at) "
+                "VALUES (?, ?, ?, ?, ?, ?)");
+            sqlite3_bind_int64(stmt.get(), 1, note_id);
+            sqlite3_bind_int64(stmt.get(), 2, attachment_id);
+            bind_encrypted(stmt.get(), 3, link);
+            sqlite3_bind_int64(stmt.get(), 6, current_timestamp());
+            step_done(db_, stmt.get(), "Failed to link attachment");
+        }
+
+        exec_sql(db_, "COMMIT;");
+        return attachment_id;
+
+    } catch (...) {
+        exec_sql(db_, "ROLLBACK;");
+        throw;
+    }
+}
+
+std::optional<int64_t> AttachmentStore::attach(int64_t note_id, const std::string& name,
+                                               const std::string& mime_type, std::istream& in,
+                                               const crypto::SecureKey& subkey)
+{
+    return attach(note_id, name, mime_type, [&](std::span<uint8_t> buffer) -> size_t {
+        in.read(reinterpret_cast<char*>(buffer.data()),
+                static_cast<std::streamsize>(buffer.size()));
+        return static_cast<size_t>(in.gcount());
+    }, subkey);
+}
+
+bool AttachmentStore::read(int64_t attachment_id, const crypto::SecureKey& subkey,
+                           const Sink& sink)
+{
+    std::array<uint8_t, kContentIdBytes> content_id{};
+    std::vector<uint8_t> header;
+    uint64_t size = 0;
+    int64_t chunk_count = 0;
+    std::optional<crypto::SecureKey> stream_key;
+    {
+        ScopedStmt stmt(db_,
+            "SELECT content_id, nonce, ciphertext, alg, header, size, chunk_count "
+            "FROM attachments WHERE attachment_id = ?");
+        sqlite3_bind_int64(stmt.get(), 1, attachment_id);
+        if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+            return false;
+        }
+        if (sqlite3_column_bytes(stmt.get(), 0) != static_cast<int>(kContentIdBytes)) {
+            return false;
+        }
+        std::memcpy(content_id.data(), sqlite3_column_blob(stmt.get(), 0), kContentIdBytes);
+
+        auto wrapped = read_encrypted_columns(stmt.get(), 1);
+        if (!wrapped.has_value()) {
+            return false;
+        }
+        stream_key = unwrap_key(attachment_id, *wrapped, subkey);
+        if (!stream_key.has_value()) {
+            return false;
+        }
+
+        const auto* h = static_cast<const uint8_t*>(sqlite3_column_blob(stmt.get(), 4));
+        header.assign(h, h + sqlite3_column_bytes(stmt.get(), 4));
+        size = static_cast<uint64_t>(sqlite3_column_int64(stmt.get(), 5));
+        chunk_count = sqlite3_column_int64(stmt.get(), 6);
+    }
+    if (header.size() != crypto::SecretStreamReader::HEADER_BYTES) {
+        return false;
+    }
+
+    crypto::SecretStreamReader reader(*stream_key, header);
+    auto chunk_aad = RecordAad::attachment_chunk(attachment_id);
+    crypto_generichash_state hash;
+    const crypto::SecureKey& hash_key = content_key(subkey);
+    crypto_generichash_init(&hash, hash_key.data(), hash_key.size(), kContentIdBytes);
+
+    // One chunk of ciphertext (SQLite's row buffer) and plaintext at a time
+    ScopedStmt stmt(db_,
+        "SELECT seq, data FROM attachment_chunks WHERE attachment_id = ? ORDER BY seq");
+    sqlite3_bind_int64(stmt.get(), 1, attachment_id);
+    crypto::SecureBytes plaintext(kChunkBytes);
+    uint64_t total = 0;
+    int64_t expected_seq = 0;
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        if (sqlite3_column_int64(stmt.get(), 0) != expected_seq++) {
+            return false;
+        }
+        const auto* data = static_cast<const uint8_t*>(sqlite3_column_blob(stmt.get(), 1));
+        auto ciphertext = std::span<const uint8_t>(data, sqlite3_column_bytes(stmt.get(), 1));
+        if (ciphertext.size() > kChunkBytes + crypto::SecretStreamReader::ABYTES) {
+            return false;
+        }
+
+        size_t len = 0;
+        if (!reader.pull(ciphertext, chunk_aad, plaintext.data(), &len)) {
+            return false;  // Tampered, reordered, or data after the final chunk
+        }
+        auto piece = std::span<const uint8_t>(plaintext.data(), len);
+        crypto_generichash_update(&hash, piece.data(), piece.size());
+        total += len;
+        sink(piece);
+    }
+
+    std::array<uint8_t, kContentIdBytes> computed{};
+    crypto_generichash_final(&hash, computed.data(), computed.size());
+    return reader.finished() && expected_seq == chunk_count && total == size &&
+           sodium_memcmp(computed.data(), content_id.data(), kContentIdBytes) == 0;
+}
+
+std::vector<AttachmentInfo> AttachmentStore::list(int64_t note_id,
+                                                  const crypto::SecureKey& subkey)
+{
+    std::vector<AttachmentInfo> result;
+    ScopedStmt stmt(db_,
+        "SELECT r.attachment_id, r.nonce, r.ciphertext, r.alg, r.created_at, a.size "
+        "FROM attachment_refs r JOIN attachments a ON a.attachment_id = r.attachment_id "
+        "WHERE r.note_id = ? ORDER BY r.created_at, r.rowid");
+    sqlite3_bind_int64(stmt.get(), 1, note_id);
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        int64_t attachment_id = sqlite3_column_int64(stmt.get(), 0);
+        auto encrypted = read_encrypted_columns(stmt.get(), 1);
+        if (!encrypted.has_value()) {
+            continue;
+        }
+        auto plaintext = crypto::CryptoService::decrypt_secure(
+            *encrypted, subkey, RecordAad::attachment_link(note_id, attachment_id));
+        if (!plaintext.has_value()) {
+            continue;
+        }
+        auto info = decode_link(*plaintext);
+        if (!info.has_value()) {
+            continue;
+        }
+        info->attachment_id = attachment_id;
+        info->created_at = sqlite3_column_int64(stmt.get(), 4);
+        info->size = static_cast<uint64_t>(sqlite3_column_int64(stmt.get(), 5));
+        result.push_back(std::move(*info));
+    }
+    return result;
+}
+
+bool AttachmentStore::detach(int64_t note_id, int64_t attachment_id) {
+    exec_sql(db_, "BEGIN TRANSACTION;");
+    try {
+        bool removed = false;
+        {
+            ScopedStmt stmt(db_,
+                "DELETE FROM attachment_refs WHERE note_id = ? AND attachment_id = ?");
+            sqlite3_bind_int64(stmt.get(), 1, note_id);
+            sqlite3_bind_int64(stmt.get(), 2, attachment_id);
+            step_done(db_, stmt.get(), "Failed to unlink attachment");
+            removed = sqlite3_changes(db_) > 0;
+        }
+
+        // Last link gone: delete the contents
+        for (const char* sql : {
+                 "DELETE FROM attachment_chunks WHERE attachment_id = ?1 AND NOT EXISTS "
+                 "(SELECT 1 FROM attachment_refs WHERE attachment_id = ?1)",
+                 "DELETE FROM attachments WHERE attachment_id = ?1 AND NOT EXISTS "
+                 "(SELECT 1 FROM attachment_refs WHERE attachment_id = ?1)"}) {
+            ScopedStmt stmt(db_, sql);
+            sqlite3_bind_int64(stmt.get(), 1, attachment_id);
+            step_done(db_, stmt.get(), "Failed to delete attachment");
+        }
+
+        exec_sql(db_, "COMMIT;");
+        return removed;
+
+    } catch (...) {
+        exec_sql(db_, "ROLLBACK;");
+        throw;
+    }
+}
+
+uint64_t AttachmentStore::attachment_count() {
+    ScopedStmt stmt(db_, "SELECT COUNT(*) FROM attachments");
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+        return 0;
+    }
+    return static_cast<uint64_t>(sqlite3_column_int64(stmt.get(), 0));
+}
+
+const crypto::SecureKey& AttachmentStore::content_key(const crypto::SecureKey& subkey) {
+    if (content_key_.has_value()) {
+        return *content_key_;
+    }
+
+    auto aad = RecordAad::vault_key(kContentKeyPurpose);
+    {
+        ScopedStmt stmt(db_, "SELECT nonce, ciphertext, alg FROM vault_keys WHERE purpose = ?");
+        sqlite3_bind_text(stmt.get(), 1, kContentKeyPurpose, -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            auto encrypted = read_encrypted_columns(stmt.get(), 0);
+            auto key = encrypted.has_value()
+                ? crypto::CryptoService::decrypt_secure(*encrypted, subkey, aad)
+                : std::nullopt;
+            if (!key.has_value() || key->size() != crypto_generichash_KEYBYTES) {
+                // Content IDs could no longer be checked or matched
+                throw std::runtime_error("Attachment content key is corrupted");
+            }
+            content_key_.emplace(key->size());
+            std::memcpy(content_key_->data(), key->data(), key->size());
+            return *content_key_;
+        }
+    }
+
+    // First attachment in this vault: create the key
+    crypto::SecureKey key(crypto_generichash_KEYBYTES);
+    randombytes_buf(key.data(), key.size());
+    auto wrapped = crypto::CryptoService::encrypt(
+        key.span(), subkey, aad, crypto::CryptoService::preferred_algorithm());
+    ScopedStmt stmt(db_,
+        "INSERT INTO vault_keys (purpose, nonce, ciphertext, alg) VALUES (?, ?, ?, ?)");
+    sqlite3_bind_text(stmt.get(), 1, kContentKeyPurpose, -1, SQLITE_STATIC);
+    bind_encrypted(stmt.get(), 2, wrapped);
+    step_done(db_, stmt.get(), "Failed to store attachment content key");
+
+    content_key_.emplace(std::move(key));
+    return *content_key_;
+}
+
+std::optional<crypto::SecureKey> AttachmentStore::unwrap_key(
+    int64_t attachment_id, const crypto::CryptoService::EncryptedData& wrapped,
+    const crypto::SecureKey& subkey)
+{
+    auto key = crypto::CryptoService::decrypt_secure(wrapped, subkey, RecordAad::attachment_key(attachment_id));
+    if (!key.has_value() || key->size() != crypto_secretstream_xchacha20poly1305_KEYBYTES) {
+        return std::nullopt;
+    }
+    crypto::SecureKey stream_key(key->size());
+    std::memcpy(stream_key.data(), key->data(), key->size());
+    return stream_key;
+}
+
+crypto::SecureBytes AttachmentStore::encode_link(const std::string& name,
+                                                 const std::string& mime_type)
+{
+    crypto::SecureBytes link(2 + name.size() + mime_type.size());
+    auto name_len = static_cast<uint16_t>(name.size());
+    std::memcpy(link.data(), &name_len, 2);  // Little-endian on x64
+    std::memcpy(link.data() + 2, name.data(), name.size());
+    std::memcpy(link.data() + 2 + name.size(), mime_type.data(), mime_type.size());
+    return link;
+}
+
+std::optional<AttachmentInfo> AttachmentStore::decode_link(std::span<const uint8_t> plaintext) {
+    if (plaintext.size() < 2) {
+        return std::nullopt;
+    }
+    uint16_t name_len = 0;
+    std::memcpy(&name_len, plaintext.data(), 2);
+    if (2u + name_len > plaintext.size()) {
+        return std::nullopt;
+    }
+    const char* text = reinterpret_cast<const char*>(plaintext.data());
+    AttachmentInfo info;
+    info.name.assign(text + 2, name_len);
+    info.mime_type.assign(text + 2 + name_len, plaintext.size() - 2 - name_len);
+    return info;
+}
+
+int64_t AttachmentStore::current_timestamp() {
+    auto now = std::chrono::system_clock::now();
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        now.time_since_epoch()).count();
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -0,0 +1,65 @@
+#include "bastionx/storage/CheckpointManager.h"
+#include <filesystem>
+#include <stdexcept>
+
+namespace bastionx {
+namespace storage {
+
+namespace fs = std::filesystem;
+
+CheckpointManager::CheckpointManager(SqliteEngine& engine, Options options)
+    : engine_(engine), options_(options) {
+    if (options_.restart_bytes > options_.truncate_bytes) {
+        throw std::invalid_argument("Checkpoint restart threshold exceeds truncate threshold");
+    }
+    engine_.set_auto_checkpoint(options_.auto_checkpoint_pages);
+}
+
+uint64_t CheckpointManager::wal_bytes() const {
+    std::error_code ec;
+    auto size = fs::file_size(engine_.path() + "-wal", ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+}
+
+CheckpointManager::Mode CheckpointManager::idle_mode() const {
+    uint64_t size = wal_bytes();
+    if (size >= options_.truncate_bytes) {
+        return Mode::kTruncate;
+    }
+    if (size >= options_.restart_bytes) {
+        return Mode::kRestart;
+    }
+    return Mode::kPassive;
+}
+
+CheckpointManager::Result CheckpointManager::run_idle() {
+    return checkpoint(idle_mode());
+}
+
+CheckpointManager::Result CheckpointManager::checkpoint(Mode mode) {
+    Result result;
+    result.mode = mode;
+    result.wal_bytes_before = wal_bytes();
+
+    auto start = std::chrono::steady_clock::now();
+    auto outcome = engine_.checkpoint(mode);
+    result.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    result.busy = outcome.busy;
+    result.wal_frames = outcome.wal_frames;
+    result.checkpointed_frames = outcome.checkpointed_frames;
+    result.wal_bytes_after = wal_bytes();
+
+    ++stats_.checkpoints;
+    if (result.busy) {
+        ++stats_.busy;
+    }
+    stats_.total += result.duration;
+    stats_.longest = std::max(stats_.longest, result.duration);
+    stats_.last = result;
+    return result;
+}
+
+}  // namespace storage
+}  // namespace bastionx
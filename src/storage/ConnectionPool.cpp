@@ -0,0 +1,219 @@
+#include "bastionx/storage/ConnectionPool.h"
+#include "bastionx/storage/SqliteEngine.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace bastionx {
+namespace storage {
+
+// === ReadLease ===
+
+ConnectionPool::ReadLease::ReadLease(ReadLease&& other) noexcept
+    : pool_(other.pool_), index_(other.index_) {
+    other.pool_ = nullptr;
+}
+
+ConnectionPool::ReadLease::~ReadLease() {
+    if (pool_ != nullptr) {
+        pool_->release(index_);
+    }
+}
+
+NotesRepository& ConnectionPool::ReadLease::repo() const {
+    return *pool_->readers_[index_].repo;
+}
+
+// === ConnectionPool Implementation ===
+
+ConnectionPool::ConnectionPool(const std::string& db_path, const crypto::SecureKey& db_key,
+                               const ConnectionProfile& profile, size_t readers)
+    : db_path_(db_path), db_key_(db_key.size()), profile_(profile)
+{
+    if (readers == 0) {
+        throw std::invalid_argument("Connection pool needs at least one reader");
+    }
+    std::memcpy(db_key_.data(), db_key.data(), db_key.size());
+
+    // Writer first: it switches a new vault to WAL, which readers cannot do
+    auto write_engine = std::make_unique<SqliteEngine>(db_path, &db_key, profile);
+    checkpoints_ = std::make_unique<CheckpointManager>(*write_engine);
+    writer_ = std::make_unique<NotesRepository>(std::move(write_engine));
+    // Only the writer caches notes: it sees every save, readers would go stale
+    writer_->set_note_cache_budget(static_cast<size_t>(profile.note_cache_kib) * 1024);
+
+    readers_.resize(readers);
+}
+
+ConnectionPool::~ConnectionPool() {
+    close();
+}
+
+NotesRepository& ConnectionPool::writer() {
+    if (!writer_) {
+        throw std::runtime_error("Connection pool is closed");
+    }
+    return *writer_;
+}
+
+CheckpointManager& ConnectionPool::checkpoints() {
+    if (!checkpoints_) {
+        throw std::runtime_error("Connection pool is closed");
+    }
+    return *checkpoints_;
+}
+
+std::optional<size_t> ConnectionPool::take_free() {
+    for (size_t i = 0; i < readers_.size(); ++i) {
+        if (!readers_[i].leased) {
+            readers_[i].leased = true;
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+ConnectionPool::ReadLease ConnectionPool::read() {
+    std::optional<size_t> index;
+    {
+        std::unique_lock lock(mutex_);
+        returned_.wait(lock, [&] { return closed_ || (index = take_free()).has_value(); });
+        if (closed_) {
+            throw std::runtime_error("Connection pool is closed");
+        }
+    }
+    return start_lease(*index);
+}
+
+std::optional<ConnectionPool::ReadLease> ConnectionPool::try_read() {
+    std::optional<size_t> index;
+    {
+        std::lock_guard lock(mutex_);
+        if (closed_ || !(index = take_free()).has_value()) {
+            return std::nullopt;
+        }
+    }
+    return start_lease(*index);
+}
+
+ConnectionPool::ReadLease ConnectionPool::start_lease(size_t index) {
+    ReadLease lease(this, index);
+    if (readers_[index].engine == nullptr) {
+        // First use of this slot: open it outside the lock (keying takes a
+        // while); the slot is leased, so no one else touches it meanwhile
+        auto engine = std::make_unique<SqliteEngine>(db_path_, &db_key_, profile_, true);
+        SqliteEngine* opened = engine.get();
+        auto repo = std::make_unique<NotesRepository>(std::move(engine));
+
+        std::lock_guard lock(mutex_);
+        if (closed_) {
+            throw std::runtime_error("Connection pool is closed");  // Lease returns the slot
+        }
+        readers_[index].engine = opened;
+        readers_[index].repo = std::move(repo);
+    }
+    // One snapshot for the whole lease, taken at its first read
+    readers_[index].engine->begin();
+    return lease;
+}
+
+void ConnectionPool::release(size_t index) {
+    Reader& reader = readers_[index];
+    if (reader.engine == nullptr) {
+        // Opening it failed
+        std::lock_guard lock(mutex_);
+        reader.leased = false;
+        returned_.notify_all();
+        return;
+    }
+    try {
+        reader.engine->commit();
+    } catch (const std::runtime_error&) {
+        // begin() failed, or an interrupted read already ended the transaction
+        try {
+            reader.engine->rollback();
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    std::lock_guard lock(mutex_);
+    reader.leased = false;
+    returned_.notify_all();
+}
+
+void ConnectionPool::clear_caches() {
+    writer().clear_caches();
+    std::lock_guard lock(mutex_);
+    for (auto& reader : readers_) {
+        if (reader.repo) {
+            reader.repo->clear_caches();
+        }
+    }
+}
+
+void ConnectionPool::interrupt_reads() {
+    std::lock_guard lock(mutex_);
+    for (auto& reader : readers_) {
+        if (reader.leased && reader.engine != nullptr) {
+            reader.engine->interrupt();
+        }
+    }
+}
+
+void ConnectionPool::close() {
+    std::unique_lock lock(mutex_);
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    for (auto& reader : readers_) {
+        if (reader.leased && reader.engine != nullptr) {
+            reader.engine->interrupt();
+        }
+    }
+    returned_.notify_all();  // Waiting read() calls give up
+    returned_.wait(lock, [&] {
+        for (const auto& reader : readers_) {
+            if (reader.leased) return false;
+        }
+        return true;
+    });
+
+    // SQLCipher wipes each connection's key material as it closes
+    for (auto& reader : readers_) {
+        reader.engine = nullptr;
+        reader.repo.reset();
+    }
+
+    // Leave an empty -wal behind; another process holding the vault open
+    // keeps the checkpoint from finishing, which is harmless
+    try {
+        checkpoints_->checkpoint(CheckpointManager::Mode::kTruncate);
+    } catch (const std::runtime_error&) {
+    }
+    checkpoints_.reset();
+    writer_.reset();
+    db_key_ = crypto::SecureKey(0);  // Frees (and wipes) the reader key
+}
+
+bool ConnectionPool::is_open() const {
+    std::lock_guard lock(mutex_);
+    return !closed_;
+}
+
+size_t ConnectionPool::reader_count() const {
+    return readers_.size();
+}
+
+size_t ConnectionPool::open_reader_count() const {
+    std::lock_guard lock(mutex_);
+    size_t opened = 0;
+    for (const auto& reader : readers_) {
+        if (reader.engine != nullptr) {
+            ++opened;
+        }
+    }
+    return opened;
+}
+
+}  // namespace storage
+}  // namespace bastionx
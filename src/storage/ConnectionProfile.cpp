@@ -0,0 +1,74 @@
+#include "bastionx/storage/ConnectionProfile.h"
+#include <stdexcept>
+#include <string>
+
+namespace bastionx {
+namespace storage {
+
+static void exec_pragma(sqlite3* db, const std::string& sql) {
+    char* err_msg = nullptr;
+    int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &err_msg);
+    if (rc != SQLITE_OK) {
+        std::string err = err_msg ? err_msg : sqlite3_errmsg(db);
+        sqlite3_free(err_msg);
+        throw std::runtime_error("SQL error: " + err);
+    }
+}
+
+// === Presets ===
+
+ConnectionProfile ConnectionProfile::paranoid() {
+    ConnectionProfile profile;
+    profile.memory_security = true;
+    profile.synchronous = Synchronous::kFull;
+    profile.cache_size_kib = 2 * 1024;
+    profile.temp_store_memory = true;
+    profile.secure_delete = true;
+    profile.note_cache_kib = 0;
+    return profile;
+}
+
+ConnectionProfile ConnectionProfile::balanced() {
+    return ConnectionProfile{};
+}
+
+ConnectionProfile ConnectionProfile::throughput() {
+    ConnectionProfile profile;
+    profile.memory_security = false;
+    profile.synchronous = Synchronous::kNormal;
+    profile.cache_size_kib = 32 * 1024;
+    profile.temp_store_memory = true;
+    profile.secure_delete = false;
+    profile.note_cache_kib = 16 * 1024;
+    profile.cipher_page_size = 16384;
+    profile.kdf_iter = 1;
+    return profile;
+}
+
+// === Apply ===
+
+void ConnectionProfile::apply(sqlite3* db, bool keyed) const {
+    if (keyed) {
+        // Format first: SQLCipher reads them when the first page is decrypted
+        exec_pragma(db, "PRAGMA cipher_page_size = " + std::to_string(cipher_page_size) + ";");
+        exec_pragma(db, "PRAGMA kdf_iter = " + std::to_string(kdf_iter) + ";");
+        exec_pragma(db, std::string("PRAGMA cipher_memory_security = ") +
+                            (memory_security ? "ON;" : "OFF;"));
+    }
+
+    // Before the first statement that can meet another connection's lock
+    sqlite3_busy_timeout(db, busy_timeout_ms);
+
+    // First read of the file (fails here on a wrong key)
+    exec_pragma(db, "PRAGMA journal_mode=WAL;");
+
+    exec_pragma(db, "PRAGMA synchronous = " +
+                        std::to_string(static_cast<int>(synchronous)) + ";");
+    exec_pragma(db, "PRAGMA cache_size = -" + std::to_string(cache_size_kib) + ";");
+    exec_pragma(db, std::string("PRAGMA temp_store = ") +
+                        (temp_store_memory ? "MEMORY;" : "DEFAULT;"));
+    exec_pragma(db, std::string("PRAGMA secure_delete = ") + (secure_delete ? "ON;" : "OFF;"));
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -0,0 +1,69 @@
+#include "bastionx/storage/ContentChunker.h"
+#include <algorithm>
+#include <array>
+
+namespace bastionx {
+namespace storage {
+
+// Gear table: 256 fixed pseudo-random words (splitmix64, fixed seed).
+// Changing it moves every boundary, so it must never change.
+static constexpr std::array<uint64_t, 256> make_gear_table() {
+    std::array<uint64_t, 256> table{};
+    uint64_t state = 0x6258'6173'7469'6f6eULL;  // "bastion"
+    for (auto& entry : table) {
+        state += 0x9e37'79b9'7f4a'7c15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xbf58'476d'1ce4'e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d0'49bb'1331'11ebULL;
+        entry = z ^ (z >> 31);
+    }
+    return table;
+}
+
+static constexpr std::array<uint64_t, 256> kGear = make_gear_table();
+
+// The gear hash shifts left once per byte, so its top bits cover the last
+// ~64 bytes. Below the average size a 16-bit mask makes boundaries rarer;
+// past it a 12-bit mask makes them likelier (normalized chunking).
+static constexpr uint64_t kMaskHard = 0xFFFF'0000'0000'0000ULL;
+static constexpr uint64_t kMaskEasy = 0xFFF0'0000'0000'0000ULL;
+
+size_t ContentChunker::next_boundary(std::span<const uint8_t> data) {
+    if (data.size() <= kMinChunkBytes) {
+        return data.size();
+    }
+
+    size_t limit = std::min(data.size(), kMaxChunkBytes);
+    size_t normal = std::min(limit, kAvgChunkBytes);
+    uint64_t hash = 0;
+
+    // No boundary can fall inside the minimum, so hashing starts there
+    size_t i = kMinChunkBytes;
+    for (; i < normal; ++i) {
+        hash = (hash << 1) + kGear[data[i]];
+        if ((hash & kMaskHard) == 0) {
+            return i + 1;
+        }
+    }
+    for (; i < limit; ++i) {
+        hash = (hash << 1) + kGear[data[i]];
+        if ((hash & kMaskEasy) == 0) {
+            return i + 1;
+        }
+    }
+    return limit;
+}
+
+std::vector<size_t> ContentChunker::split(std::span<const uint8_t> data) {
+    std::vector<size_t> lengths;
+    lengths.reserve(data.size() / kAvgChunkBytes + 1);
+    while (!data.empty()) {
+        size_t len = next_boundary(data);
+        lengths.push_back(len);
+        data = data.subspan(len);
+    }
+    return lengths;
+}
+
+}  // namespace storage
+}  // namespace bastionx
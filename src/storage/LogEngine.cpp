@@ -0,0 +1,966 @@
+#include "bastionx/storage/LogEngine.h"
+#include "bastionx/crypto/CryptoService.h"
+#include "bastionx/util/FileSync.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace bastionx {
+namespace storage {
+
+// Record kinds (first plaintext byte of every frame)
+static constexpr uint8_t kPut = 1;
+static constexpr uint8_t kErase = 2;
+static constexpr uint8_t kCommit = 3;    // Ends a transaction
+static constexpr uint8_t kAbort = 4;     // Discards the open transaction
+static constexpr uint8_t kMeta = 5;      // Last assigned IDs, first in a segment
+static constexpr uint8_t kFooter = 6;    // Entries of a sealed segment
+
+// Second plaintext byte: the record ends a committed batch
+static constexpr uint8_t kCommits = 0x01;
+
+static constexpr size_t kFrameHeaderBytes = 4 + 1 + crypto::CryptoService::NONCE_BYTES;
+static constexpr size_t kKeyBytes = 1 + 8 + 8;               // table | a | b
+static constexpr size_t kFooterEntryBytes = 1 + kKeyBytes + 8 + 4;
+static constexpr size_t kTrailerBytes = 8 + 4 + 8;           // offset | length | magic
+static constexpr char kTrailerMagic[8] = {'B', 'X', 'L', 'O', 'G', 'E', 'N', 'D'};
+static constexpr const char* kSegmentExtension = ".bxlog";
+
+// Segment copies per compaction step, between which writers get the lock
+static constexpr size_t kCompactBatchRecords = 256;
+
+// Little-endian on x64 (same convention as NoteRecord)
+template <typename T>
+static void put_int(std::vector<uint8_t>& out, T value) {
+    size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+template <typename T>
+static T get_int(const uint8_t* src) {
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return value;
+}
+
+static std::vector<uint8_t> build_record_aad(uint64_t segment, uint64_t offset) {
+    static constexpr char kPrefix[] = "BXLOGRv1";
+    std::vector<uint8_t> aad(8 + 8 + 8);
+    std::memcpy(aad.data(), kPrefix, 8);
+    std::memcpy(aad.data() + 8, &segment, 8);
+    std::memcpy(aad.data() + 16, &offset, 8);
+    return aad;
+}
+
+static void encode_key(std::vector<uint8_t>& out, Table table, const RowKey& key) {
+    out.push_back(static_cast<uint8_t>(table));
+    put_int<int64_t>(out, key.a);
+    put_int<int64_t>(out, key.b);
+}
+
+// Column count, then per column: 0 (null) | 1 + int64 | 2 + length (4) + bytes
+static void encode_row(std::vector<uint8_t>& out, const Row& row) {
+    out.push_back(static_cast<uint8_t>(row.values.size()));
+    for (const auto& value : row.values) {
+        if (const auto* integer = std::get_if<int64_t>(&value)) {
+            out.push_back(1);
+            put_int<int64_t>(out, *integer);
+        } else if (const auto* blob = std::get_if<std::vector<uint8_t>>(&value)) {
+            out.push_back(2);
+            put_int<uint32_t>(out, static_cast<uint32_t>(blob->size()));
+            out.insert(out.end(), blob->begin(), blob->end());
+        } else {
+            out.push_back(0);
+        }
+    }
+}
+
+static std::optional<Row> decode_row(Table table, std::span<const uint8_t> in) {
+    Row row(table);
+    if (in.empty() || in[0] != row.values.size()) {
+        return std::nullopt;
+    }
+    size_t pos = 1;
+    for (auto& value : row.values) {
+        if (pos >= in.size()) {
+            return std::nullopt;
+        }
+        uint8_t tag = in[pos++];
+        if (tag == 1) {
+            if (in.size() - pos < 8) {
+                return std::nullopt;
+            }
+            value = get_int<int64_t>(in.data() + pos);
+            pos += 8;
+        } else if (tag == 2) {
+            if (in.size() - pos < 4) {
+                return std::nullopt;
+            }
+            uint32_t length = get_int<uint32_t>(in.data() + pos);
+            pos += 4;
+            if (in.size() - pos < length) {
+                return std::nullopt;
+            }
+            value = std::vector<uint8_t>(in.begin() + pos, in.begin() + pos + length);
+            pos += length;
+        } else if (tag != 0) {
+            return std::nullopt;
+        }
+    }
+    if (pos != in.size()) {
+        return std::nullopt;
+    }
+    return row;
+}
+
+// Keys of single-column tables always have b = 0
+static RowKey normalize(Table table, RowKey key) {
+    if (table_spec(table).subkey == nullptr) {
+        key.b = 0;
+    }
+    return key;
+}
+
+// Copy of `row` with only the projected columns set
+static Row project(Table table, Row row, const Projection& columns) {
+    if (!columns.only.has_value()) {
+        return row;
+    }
+    Row projected(table);
+    for (size_t i : *columns.only) {
+        projected.values.at(i) = std::move(row.values[i]);
+    }
+    return projected;
+}
+
+// === LogEngine Implementation ===
+
+LogEngine::LogEngine(const std::string& dir, const crypto::SecureKey& key)
+    : LogEngine(dir, key, Options{}) {}
+
+LogEngine::LogEngine(const std::string& dir, const crypto::SecureKey& key,
+                     const Options& options)
+    : dir_(dir), key_(key.size()), options_(options)
+{
+    std::memcpy(key_.data(), key.data(), key.size());
+
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (!fs::is_directory(dir_)) {
+        throw std::runtime_error("Failed to open log directory: " + dir_);
+    }
+
+    load();
+    open_ = true;
+
+    if (options_.background_compaction) {
+        compactor_ = std::thread([this] { compaction_loop(); });
+    }
+}
+
+LogEngine::~LogEngine() {
+    close();
+}
+
+void LogEngine::close() {
+    {
+        std::lock_guard lock(mutex_);
+        if (!open_) {
+            return;
+        }
+        if (in_transaction_) {
+            rollback();
+        }
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (compactor_.joinable()) {
+        compactor_.join();
+    }
+
+    std::lock_guard lock(mutex_);
+    // An active segment with no entries is left unsealed: reopening
+    // continues it instead of starting another file
+    if (!entries_.empty()) {
+        seal_active();
+    }
+    segments_.clear();
+    for (auto& table : index_) {
+        table.clear();
+    }
+    entries_.clear();
+    open_ = false;
+}
+
+bool LogEngine::is_open() const {
+    std::lock_guard lock(mutex_);
+    return open_;
+}
+
+void LogEngine::require_open() const {
+    if (!open_) {
+        throw std::runtime_error("Database is closed");
+    }
+}
+
+LogEngine::Segment& LogEngine::active() {
+    return *segments_.rbegin()->second;
+}
+
+// === Segment Files ===
+
+void LogEngine::load() {
+    std::map<uint64_t, std::string> found;
+    for (const auto& file : fs::directory_iterator(dir_)) {
+        if (file.path().extension() != kSegmentExtension) {
+            continue;
+        }
+        try {
+            found.emplace(std::stoull(file.path().stem().string(), nullptr, 16),
+                          file.path().string());
+        } catch (const std::exception&) {
+            continue;  // Not one of ours
+        }
+    }
+
+    if (found.empty()) {
+        open_segment(1);
+        return;
+    }
+
+    for (const auto& [id, path] : found) {
+        auto segment = std::make_unique<Segment>();
+        segment->id = id;
+        segment->path = path;
+        segment->size = fs::file_size(path);
+        segment->file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!segment->file) {
+            throw std::runtime_error("Failed to open log segment: " + path);
+        }
+        Segment& loaded = *segment;
+        segments_.emplace(id, std::move(segment));
+
+        bool last = id == found.rbegin()->first;
+        if (!load_footer(loaded)) {
+            if (!last) {
+                throw std::runtime_error("Log segment is damaged: " + path);
+            }
+            replay(loaded, true);
+        }
+    }
+
+    if (active().sealed) {
+        open_segment(active().id + 1);
+    }
+}
+
+void LogEngine::open_segment(uint64_t id) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 "%s", id, kSegmentExtension);
+
+    auto segment = std::make_unique<Segment>();
+    segment->id = id;
+    segment->path = (fs::path(dir_) / name).string();
+    {
+        std::ofstream create(segment->path, std::ios::binary | std::ios::trunc);
+        if (!create) {
+            throw std::runtime_error("Failed to create log segment: " + segment->path);
+        }
+    }
+    segment->file.open(segment->path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!segment->file) {
+        throw std::runtime_error("Failed to open log segment: " + segment->path);
+    }
+    segments_.emplace(id, std::move(segment));
+    entries_.clear();
+
+    // Assigned IDs survive compaction of the segments that assigned them
+    std::vector<uint8_t> meta;
+    for (int64_t id_value : last_id_) {
+        put_int<int64_t>(meta, id_value);
+    }
+    append(kMeta, true, meta);
+    flush();
+}
+
+void LogEngine::seal_active() {
+    Segment& segment = active();
+
+    std::vector<uint8_t> footer;
+    put_int<uint32_t>(footer, static_cast<uint32_t>(entries_.size()));
+    for (const auto& entry : entries_) {
+        footer.push_back(entry.kind);
+        encode_key(footer, entry.table, entry.key);
+        put_int<uint64_t>(footer, entry.location.offset);
+        put_int<uint32_t>(footer, entry.location.length);
+    }
+    for (int64_t id : last_id_) {
+        put_int<int64_t>(footer, id);
+    }
+    Location location = append(kFooter, true, footer);
+
+    std::vector<uint8_t> trailer;
+    put_int<uint64_t>(trailer, location.offset);
+    put_int<uint32_t>(trailer, location.length);
+    trailer.insert(trailer.end(), kTrailerMagic, kTrailerMagic + sizeof(kTrailerMagic));
+    segment.file.clear();
+    segment.file.seekp(static_cast<std::streamoff>(segment.size));
+    segment.file.write(reinterpret_cast<const char*>(trailer.data()),
+                       static_cast<std::streamsize>(trailer.size()));
+    segment.size += trailer.size();
+    appended_bytes_ += trailer.size();
+    flush();
+    segment.sealed = true;
+}
+
+void LogEngine::roll_if_full() {
+    if (!in_transaction_ && active().size >= options_.segment_bytes) {
+        uint64_t next = active().id + 1;
+        seal_active();
+        open_segment(next);
+    }
+}
+
+bool LogEngine::load_footer(Segment& segment) {
+    if (segment.size < kTrailerBytes) {
+        return false;
+    }
+    uint8_t trailer[kTrailerBytes];
+    segment.file.clear();
+    segment.file.seekg(static_cast<std::streamoff>(segment.size - kTrailerBytes));
+    segment.file.read(reinterpret_cast<char*>(trailer), kTrailerBytes);
+    if (segment.file.gcount() != static_cast<std::streamsize>(kTrailerBytes) ||
+        std::memcmp(trailer + 12, kTrailerMagic, sizeof(kTrailerMagic)) != 0) {
+        return false;
+    }
+
+    Location location{segment.id, get_int<uint64_t>(trailer), get_int<uint32_t>(trailer + 8)};
+    if (location.offset + location.length != segment.size - kTrailerBytes) {
+        return false;
+    }
+    auto footer = read(location);
+    if (!footer.has_value() || footer->size() < 2 + 4 || (*footer)[0] != kFooter) {
+        return false;
+    }
+
+    const uint8_t* p = footer->data() + 2;
+    uint64_t count = get_int<uint32_t>(p);
+    if (footer->size() != 2 + 4 + count * kFooterEntryBytes + kTableCount * 8) {
+        return false;
+    }
+    p += 4;
+    for (uint64_t i = 0; i < count; ++i, p += kFooterEntryBytes) {
+        Entry entry;
+        entry.kind = p[0];
+        if (p[1] >= kTableCount || (entry.kind != kPut && entry.kind != kErase)) {
+            return false;
+        }
+        entry.table = static_cast<Table>(p[1]);
+        entry.key = RowKey{get_int<int64_t>(p + 2), get_int<int64_t>(p + 10)};
+        entry.location = Location{segment.id, get_int<uint64_t>(p + 18),
+                                  get_int<uint32_t>(p + 26)};
+        apply(entry);
+    }
+    for (size_t t = 0; t < kTableCount; ++t, p += 8) {
+        last_id_[t] = std::max(last_id_[t], get_int<int64_t>(p));
+    }
+    segment.sealed = true;
+    return true;
+}
+
+void LogEngine::replay(Segment& segment, bool last) {
+    std::vector<Entry> pending;
+    uint64_t committed_end = 0;
+    uint64_t pos = 0;
+
+    while (segment.size - pos >= kFrameHeaderBytes) {
+        uint8_t length_bytes[4];
+        segment.file.clear();
+        segment.file.seekg(static_cast<std::streamoff>(pos));
+        segment.file.read(reinterpret_cast<char*>(length_bytes), 4);
+        uint64_t frame = 4 + static_cast<uint64_t>(get_int<uint32_t>(length_bytes));
+        if (frame > segment.size - pos) {
+            break;  // Torn write
+        }
+
+        Location location{segment.id, pos, static_cast<uint32_t>(frame)};
+        auto record = read(location);
+        if (!record.has_value() || record->size() < 2) {
+            break;
+        }
+        uint8_t kind = (*record)[0];
+        if (kind == kFooter) {
+            break;  // Sealing was cut short; everything before it is intact
+        }
+
+        if (kind == kPut || kind == kErase) {
+            if (record->size() < 2 + kKeyBytes || (*record)[2] >= kTableCount) {
+                break;
+            }
+            const uint8_t* p = record->data() + 2;
+            pending.push_back(Entry{kind, static_cast<Table>(p[0]),
+                                    RowKey{get_int<int64_t>(p + 1), get_int<int64_t>(p + 9)},
+                                    location});
+        } else if (kind == kAbort) {
+            pending.clear();
+        } else if (kind == kMeta && record->size() == 2 + kTableCount * 8) {
+            for (size_t t = 0; t < kTableCount; ++t) {
+                last_id_[t] = std::max(last_id_[t], get_int<int64_t>(record->data() + 2 + t * 8));
+            }
+        }
+
+        pos += frame;
+        if (((*record)[1] & kCommits) != 0) {
+            for (const auto& entry : pending) {
+                apply(entry);
+                entries_.push_back(entry);
+            }
+            pending.clear();
+            committed_end = pos;
+        }
+    }
+
+    if (last && committed_end < segment.size) {
+        // Drop the torn or uncommitted tail so appends continue after the
+        // last commit
+        segment.file.close();
+        fs::resize_file(segment.path, committed_end);
+        segment.file.open(segment.path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!segment.file) {
+            throw std::runtime_error("Failed to open log segment: " + segment.path);
+        }
+        segment.size = committed_end;
+    }
+    if (segment.size == 0) {
+        std::vector<uint8_t> meta;
+        for (int64_t id : last_id_) {
+            put_int<int64_t>(meta, id);
+        }
+        append(kMeta, true, meta);
+        flush();
+    }
+}
+
+// === Records ===
+
+LogEngine::Location LogEngine::append(uint8_t kind, bool commits,
+                                      std::span<const uint8_t> body)
+{
+    Segment& segment = active();
+
+    std::vector<uint8_t> plaintext;
+    plaintext.reserve(2 + body.size());
+    plaintext.push_back(kind);
+    plaintext.push_back(commits ? kCommits : 0);
+    plaintext.insert(plaintext.end(), body.begin(), body.end());
+
+    auto encrypted = crypto::CryptoService::encrypt(
+        plaintext, key_, build_record_aad(segment.id, segment.size),
+        crypto::CryptoService::preferred_algorithm());
+
+    std::vector<uint8_t> frame;
+    frame.reserve(kFrameHeaderBytes + encrypted.ciphertext.size());
+    put_int<uint32_t>(frame, static_cast<uint32_t>(
+        kFrameHeaderBytes - 4 + encrypted.ciphertext.size()));
+    frame.push_back(static_cast<uint8_t>(encrypted.algorithm));
+    frame.insert(frame.end(), encrypted.nonce.begin(), encrypted.nonce.end());
+    frame.insert(frame.end(), encrypted.ciphertext.begin(), encrypted.ciphertext.end());
+
+    segment.synced = false;
+    segment.file.clear();
+    segment.file.seekp(static_cast<std::streamoff>(segment.size));
+    segment.file.write(reinterpret_cast<const char*>(frame.data()),
+                       static_cast<std::streamsize>(frame.size()));
+    if (!segment.file) {
+        throw std::runtime_error("Failed to write log segment: " + segment.path);
+    }
+
+    Location location{segment.id, segment.size, static_cast<uint32_t>(frame.size())};
+    segment.size += frame.size();
+    appended_bytes_ += frame.size();
+    return location;
+}
+
+std::optional<std::vector<uint8_t>> LogEngine::read(const Location& location) {
+    auto it = segments_.find(location.segment);
+    if (it == segments_.end() || location.length <= kFrameHeaderBytes) {
+        return std::nullopt;
+    }
+    Segment& segment = *it->second;
+
+    std::vector<uint8_t> frame(location.length);
+    segment.file.clear();
+    segment.file.seekg(static_cast<std::streamoff>(location.offset));
+    segment.file.read(reinterpret_cast<char*>(frame.data()),
+                      static_cast<std::streamsize>(frame.size()));
+    if (segment.file.gcount() != static_cast<std::streamsize>(frame.size()) ||
+        get_int<uint32_t>(frame.data()) != location.length - 4) {
+        return std::nullopt;
+    }
+
+    crypto::CryptoService::EncryptedData encrypted;
+    encrypted.algorithm = static_cast<crypto::CryptoService::Algorithm>(frame[4]);
+    std::memcpy(encrypted.nonce.data(), frame.data() + 5, encrypted.nonce.size());
+    encrypted.ciphertext.assign(frame.begin() + kFrameHeaderBytes, frame.end());
+    return crypto::CryptoService::decrypt(
+        encrypted, key_, build_record_aad(location.segment, location.offset));
+}
+
+Row LogEngine::read_row(Table table, const Location& location) {
+    auto record = read(location);
+    if (!record.has_value() || record->size() < 2 + kKeyBytes || (*record)[0] != kPut) {
+        throw std::runtime_error("Log record failed authentication");
+    }
+    auto row = decode_row(table, std::span<const uint8_t>(*record).subspan(2 + kKeyBytes));
+    if (!row.has_value()) {
+        throw std::runtime_error("Log record is malformed");
+    }
+    return std::move(*row);
+}
+
+void LogEngine::write_entry(uint8_t kind, Table table, const RowKey& key, const Row* row) {
+    std::vector<uint8_t> body;
+    encode_key(body, table, key);
+    if (row != nullptr) {
+        encode_row(body, *row);
+    }
+
+    Entry entry{kind, table, key, append(kind, !in_transaction_, body)};
+    if (in_transaction_) {
+        auto& rows = index_[static_cast<size_t>(table)];
+        auto it = rows.find(key);
+        undo_.push_back(Undo{table, key,
+                             it != rows.end() ? std::optional<Location>(it->second) : std::nullopt});
+        pending_.push_back(entry);
+        apply(entry);
+        return;
+    }
+
+    apply(entry);
+    entries_.push_back(entry);
+    flush();
+    roll_if_full();
+    wake_.notify_one();
+}
+
+void LogEngine::apply(const Entry& entry) {
+    auto& rows = index_[static_cast<size_t>(entry.table)];
+    auto it = rows.find(entry.key);
+    if (it != rows.end()) {
+        segments_.at(it->second.segment)->live -= it->second.length;
+    }
+
+    if (entry.kind == kErase) {
+        if (it != rows.end()) {
+            rows.erase(it);
+        }
+        return;
+    }
+
+    rows[entry.key] = entry.location;
+    segments_.at(entry.location.segment)->live += entry.location.length;
+    int64_t& last_id = last_id_[static_cast<size_t>(entry.table)];
+    if (table_spec(entry.table).auto_id && entry.key.a > last_id) {
+        last_id = entry.key.a;
+    }
+}
+
+void LogEngine::flush() {
+    Segment& segment = active();
+    segment.file.flush();
+    if (!segment.file) {
+        throw std::runtime_error("Failed to write log segment: " + segment.path);
+    }
+}
+
+// fsync every segment written since its last sync, then the directory (so
+// segments created since are found after a power loss)
+void LogEngine::sync_segments() {
+    flush();
+    for (auto& [id, segment] : segments_) {
+        if (!segment->synced) {
+            util::sync_file(segment->path);
+            segment->synced = true;
+        }
+    }
+    util::sync_directory(dir_);
+}
+
+// === Transactions ===
+
+void LogEngine::begin() {
+    std::lock_guard lock(mutex_);
+    require_open();
+    if (in_transaction_) {
+        throw std::runtime_error("SQL error: cannot start a transaction within a transaction");
+    }
+    in_transaction_ = true;
+}
+
+void LogEngine::commit() {
+    std::lock_guard lock(mutex_);
+    if (!in_transaction_) {
+        throw std::runtime_error("SQL error: cannot commit - no transaction is active");
+    }
+    append(kCommit, true, {});
+    entries_.insert(entries_.end(), pending_.begin(), pending_.end());
+    pending_.clear();
+    undo_.clear();
+    in_transaction_ = false;
+    flush();
+    roll_if_full();
+    wake_.notify_one();
+}
+
+void LogEngine::rollback() {
+    std::lock_guard lock(mutex_);
+    if (!in_transaction_) {
+        throw std::runtime_error("SQL error: cannot rollback - no transaction is active");
+    }
+    // Newest change first, so each key ends at its location before begin()
+    for (auto it = undo_.rbegin(); it != undo_.rend(); ++it) {
+        auto& rows = index_[static_cast<size_t>(it->table)];
+        auto current = rows.find(it->key);
+        if (current != rows.end()) {
+            segments_.at(current->second.segment)->live -= current->second.length;
+            rows.erase(current);
+        }
+        if (it->before.has_value()) {
+            rows[it->key] = *it->before;
+            segments_.at(it->before->segment)->live += it->before->length;
+        }
+    }
+    append(kAbort, true, {});
+    pending_.clear();
+    undo_.clear();
+    in_transaction_ = false;
+    flush();
+    wake_.notify_one();
+}
+
+// === Row Operations ===
+
+std::optional<Row> LogEngine::get(Table table, const RowKey& key, const Projection& columns) {
+    std::lock_guard lock(mutex_);
+    require_open();
+    auto& rows = index_[static_cast<size_t>(table)];
+    auto it = rows.find(normalize(table, key));
+    if (it == rows.end()) {
+        return std::nullopt;
+    }
+    if (columns.only.has_value() && columns.only->empty()) {
+        return Row(table);  // Keys only: no need to touch the disk
+    }
+    return project(table, read_row(table, it->second), columns);
+}
+
+void LogEngine::put(Table table, const RowKey& key, const Row& row) {
+    const TableSpec& spec = table_spec(table);
+    if (row.values.size() != spec.columns.size()) {
+        throw std::invalid_argument(std::string("Wrong column count for ") + spec.name);
+    }
+    std::lock_guard lock(mutex_);
+    require_open();
+    write_entry(kPut, table, normalize(table, key), &row);
+}
+
+int64_t LogEngine::insert(Table table, const Row& row) {
+    const TableSpec& spec = table_spec(table);
+    if (!spec.auto_id) {
+        throw std::invalid_argument(std::string("Keys of ") + spec.name + " are not assigned");
+    }
+    std::lock_guard lock(mutex_);
+    require_open();
+    int64_t id = last_id_[static_cast<size_t>(table)] + 1;
+    put(table, RowKey{id}, row);
+    return id;
+}
+
+bool LogEngine::erase(Table table, const RowKey& key) {
+    std::lock_guard lock(mutex_);
+    require_open();
+    RowKey k = normalize(table, key);
+    if (index_[static_cast<size_t>(table)].count(k) == 0) {
+        return false;
+    }
+    write_entry(kErase, table, k, nullptr);
+    return true;
+}
+
+size_t LogEngine::erase_range(Table table, const KeyRange& range) {
+    std::lock_guard lock(mutex_);
+    require_open();
+    KeyRange r{normalize(table, range.first), normalize(table, range.last)};
+    if (r.last < r.first) {
+        return 0;
+    }
+    auto& rows = index_[static_cast<size_t>(table)];
+    std::vector<RowKey> keys;
+    for (auto it = rows.lower_bound(r.first); it != rows.upper_bound(r.last); ++it) {
+        keys.push_back(it->first);
+    }
+    if (keys.empty()) {
+        return 0;
+    }
+
+    // One commit for the whole range
+    bool implicit = !in_transaction_;
+    if (implicit) {
+        begin();
+    }
+    try {
+        for (const auto& key : keys) {
+            write_entry(kErase, table, key, nullptr);
+        }
+    } catch (...) {
+        if (implicit) {
+            rollback();
+        }
+        throw;
+    }
+    if (implicit) {
+        commit();
+    }
+    return keys.size();
+}
+
+void LogEngine::scan(Table table, const KeyRange& range, const Visitor& visit,
+                     const Projection& columns, ScanOrder order)
+{
+    std::lock_guard lock(mutex_);
+    require_open();
+    KeyRange r{normalize(table, range.first), normalize(table, range.last)};
+    if (r.last < r.first) {
+        return;
+    }
+    auto& rows = index_[static_cast<size_t>(table)];
+    auto first = rows.lower_bound(r.first);
+    auto last = rows.upper_bound(r.last);
+    bool keys_only = columns.only.has_value() && columns.only->empty();
+
+    auto emit = [&](const std::pair<const RowKey, Location>& entry) {
+        if (keys_only) {
+            return visit(entry.first, Row(table));
+        }
+        return visit(entry.first, project(table, read_row(table, entry.second), columns));
+    };
+
+    if (order == ScanOrder::kAscending) {
+        for (auto it = first; it != last; ++it) {
+            if (!emit(*it)) {
+                return;
+            }
+        }
+    } else {
+        for (auto it = std::make_reverse_iterator(last); it != std::make_reverse_iterator(first);
+             ++it) {
+            if (!emit(*it)) {
+                return;
+            }
+        }
+    }
+}
+
+uint64_t LogEngine::count_matching(Table table, size_t column, int64_t value) {
+    uint64_t count = 0;
+    scan(table, KeyRange::all(), [&](const RowKey&, const Row& row) {
+        const auto* v = std::get_if<int64_t>(&row.values.at(column));
+        if (v != nullptr && *v == value) {
+            ++count;
+        }
+        return true;
+    }, {column});
+    return count;
+}
+
+void LogEngine::scan_by(Table table, size_t column, const Visitor& visit,
+                        const Projection& columns, ScanOrder order)
+{
+    std::lock_guard lock(mutex_);
+    std::vector<std::pair<int64_t, RowKey>> sorted;
+    scan(table, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+        sorted.emplace_back(row.integer(column), key);
+        return true;
+    }, {column});
+    std::stable_sort(sorted.begin(), sorted.end(), [&](const auto& x, const auto& y) {
+        return order == ScanOrder::kDescending ? x.first > y.first : x.first < y.first;
+    });
+    for (const auto& [value, key] : sorted) {
+        auto row = get(table, key, columns);
+        if (row.has_value() && !visit(key, *row)) {
+            return;
+        }
+    }
+}
+
+void LogEngine::scan_subkey(Table table, int64_t b, const Visitor& visit,
+                            const Projection& columns)
+{
+    if (table_spec(table).subkey == nullptr) {
+        throw std::invalid_argument(std::string("No second key column in ") +
+                                    table_spec(table).name);
+    }
+    std::lock_guard lock(mutex_);
+    std::vector<RowKey> matches;
+    scan(table, KeyRange::all(), [&](const RowKey& key, const Row&) {
+        if (key.b == b) {
+            matches.push_back(key);
+        }
+        return true;
+    }, Projection::none());
+    for (const auto& key : matches) {
+        auto row = get(table, key, columns);
+        if (row.has_value() && !visit(key, *row)) {
+            return;
+        }
+    }
+}
+
+StorageEngine::TableUsage LogEngine::usage(Table table, size_t blob_column) {
+    TableUsage result;
+    scan(table, KeyRange::all(), [&](const RowKey&, const Row& row) {
+        ++result.rows;
+        result.bytes += row.blob(blob_column).size();
+        return true;
+    }, {blob_column});
+    return result;
+}
+
+// === Compaction ===
+
+LogEngine::LogStats LogEngine::stats() const {
+    std::lock_guard lock(mutex_);
+    LogStats stats;
+    stats.segments = segments_.size();
+    for (const auto& [id, segment] : segments_) {
+        stats.disk_bytes += segment->size;
+        stats.live_bytes += segment->live;
+    }
+    stats.appended_bytes = appended_bytes_;
+    return stats;
+}
+
+bool LogEngine::needs_compaction() const {
+    if (segments_.size() < 2) {
+        return false;
+    }
+    uint64_t total = 0;
+    uint64_t live = 0;
+    for (const auto& [id, segment] : segments_) {
+        if (segment->sealed) {
+            total += segment->size;
+            live += segment->live;
+        }
+    }
+    return total > 0 &&
+           static_cast<double>(total - live) > options_.garbage_ratio * static_cast<double>(total);
+}
+
+// Copy up to a batch of the oldest segment's live records to the head of
+// the log; deletes the segment once none are left. False if there is no
+// sealed segment to work on.
+bool LogEngine::compact_oldest() {
+    if (segments_.size() < 2 || in_transaction_) {
+        return false;
+    }
+    Segment& oldest = *segments_.begin()->second;
+    if (!oldest.sealed) {
+        return false;
+    }
+
+    std::vector<Entry> live;
+    for (size_t t = 0; t < kTableCount && live.size() < kCompactBatchRecords; ++t) {
+        for (const auto& [key, location] : index_[t]) {
+            if (location.segment == oldest.id) {
+                live.push_back(Entry{kPut, static_cast<Table>(t), key, location});
+                if (live.size() == kCompactBatchRecords) {
+                    break;
+                }
+            }
+        }
+    }
+
+    if (live.empty()) {
+        // The copies must be on disk before the only other copy goes. Its
+        // erase markers go too: nothing older is left for them to hide
+        sync_segments();
+        oldest.file.close();
+        std::error_code ec;
+        fs::remove(oldest.path, ec);
+        segments_.erase(segments_.begin());
+        return true;
+    }
+
+    for (auto& entry : live) {
+        auto record = read(entry.location);
+        if (!record.has_value() || record->size() < 2 || (*record)[0] != kPut) {
+            throw std::runtime_error("Log record failed authentication");
+        }
+        entry.location = append(kPut, true, std::span<const uint8_t>(*record).subspan(2));
+        apply(entry);
+        entries_.push_back(entry);
+    }
+    flush();
+    roll_if_full();
+    return true;
+}
+
+size_t LogEngine::compact() {
+    std::lock_guard lock(mutex_);
+    require_open();
+    size_t removed = 0;
+    // Each segment is taken at most once per call, so copying live records
+    // forward cannot go round in circles
+    size_t budget = segments_.size() - 1;
+    while (removed < budget && needs_compaction()) {
+        uint64_t oldest = segments_.begin()->first;
+        while (!segments_.empty() && segments_.begin()->first == oldest) {
+            if (!compact_oldest()) {
+                return removed;
+            }
+        }
+        ++removed;
+    }
+    return removed;
+}
+
+void LogEngine::compaction_loop() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [&] {
+            return stopping_ || (!in_transaction_ && needs_compaction());
+        });
+        if (stopping_) {
+            return;
+        }
+        // Same bound as compact(): each segment at most once per pass
+        size_t budget = segments_.size() - 1;
+        size_t removed = 0;
+        while (!stopping_ && removed < budget && !in_transaction_ && needs_compaction()) {
+            size_t before = segments_.size();
+            if (!compact_oldest()) {
+                break;
+            }
+            if (segments_.size() < before) {
+                ++removed;
+            }
+            // Let readers and writers in between batches
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+        }
+        if (removed == 0 && !stopping_) {
+            // No progress; wait for more writes before looking again
+            wake_.wait(lock);
+        }
+    }
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -0,0 +1,263 @@
+#include "bastionx/storage/MemoryEngine.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace bastionx {
+namespace storage {
+
+// Keys of single-column tables always have b = 0
+static RowKey normalize(Table table, RowKey key) {
+    if (table_spec(table).subkey == nullptr) {
+        key.b = 0;
+    }
+    return key;
+}
+
+static KeyRange normalize(Table table, KeyRange range) {
+    if (table_spec(table).subkey == nullptr) {
+        range.first.b = 0;
+        range.last.b = 0;
+    }
+    return range;
+}
+
+// Copy of `row` with only the projected columns set
+static Row project(Table table, const Row& row, const Projection& columns) {
+    if (!columns.only.has_value()) {
+        return row;
+    }
+    Row projected(table);
+    for (size_t i : *columns.only) {
+        projected.values.at(i) = row.values[i];
+    }
+    return projected;
+}
+
+// === MemoryEngine Implementation ===
+
+MemoryEngine::MemoryEngine() : store_(std::make_shared<Store>()) {}
+
+MemoryEngine::MemoryEngine(std::shared_ptr<Store> store) : store_(std::move(store)) {
+    if (!store_) {
+        throw std::invalid_argument("MemoryEngine needs a store");
+    }
+}
+
+void MemoryEngine::close() {
+    if (in_transaction_) {
+        rollback();
+    }
+    store_.reset();
+}
+
+bool MemoryEngine::is_open() const {
+    return store_ != nullptr;
+}
+
+std::map<RowKey, Row>& MemoryEngine::rows(Table table) {
+    if (!store_) {
+        throw std::runtime_error("Database is closed");
+    }
+    return store_->tables[static_cast<size_t>(table)];
+}
+
+void MemoryEngine::remember(Table table, const RowKey& key) {
+    if (!in_transaction_) {
+        return;
+    }
+    auto& table_rows = rows(table);
+    auto it = table_rows.find(key);
+    undo_.push_back(Undo{table, key,
+                         it != table_rows.end() ? std::optional<Row>(it->second) : std::nullopt});
+}
+
+void MemoryEngine::begin() {
+    if (!store_) {
+        throw std::runtime_error("Database is closed");
+    }
+    if (in_transaction_) {
+        throw std::runtime_error("SQL error: cannot start a transaction within a transaction");
+    }
+    in_transaction_ = true;
+}
+
+void MemoryEngine::commit() {
+    if (!in_transaction_) {
+        throw std::runtime_error("SQL error: cannot commit - no transaction is active");
+    }
+    undo_.clear();
+    in_transaction_ = false;
+}
+
+void MemoryEngine::rollback() {
+    if (!in_transaction_) {
+        throw std::runtime_error("SQL error: cannot rollback - no transaction is active");
+    }
+    // Newest change first, so each row ends at its state before begin()
+    for (auto it = undo_.rbegin(); it != undo_.rend(); ++it) {
+        auto& table_rows = rows(it->table);
+        if (it->before.has_value()) {
+            table_rows[it->key] = std::move(*it->before);
+        } else {
+            table_rows.erase(it->key);
+        }
+    }
+    undo_.clear();
+    in_transaction_ = false;
+}
+
+std::optional<Row> MemoryEngine::get(Table table, const RowKey& key, const Projection& columns) {
+    auto& table_rows = rows(table);
+    auto it = table_rows.find(normalize(table, key));
+    if (it == table_rows.end()) {
+        return std::nullopt;
+    }
+    return project(table, it->second, columns);
+}
+
+void MemoryEngine::put(Table table, const RowKey& key, const Row& row) {
+    const TableSpec& spec = table_spec(table);
+    if (row.values.size() != spec.columns.size()) {
+        throw std::invalid_argument(std::string("Wrong column count for ") + spec.name);
+    }
+    RowKey k = normalize(table, key);
+    remember(table, k);
+    rows(table)[k] = row;
+
+    // Keys written explicitly are never handed out by insert() either
+    int64_t& last_id = store_->last_id[static_cast<size_t>(table)];
+    if (spec.auto_id && k.a > last_id) {
+        last_id = k.a;
+    }
+}
+
+int64_t MemoryEngine::insert(Table table, const Row& row) {
+    const TableSpec& spec = table_spec(table);
+    if (!spec.auto_id) {
+        throw std::invalid_argument(std::string("Keys of ") + spec.name + " are not assigned");
+    }
+    rows(table);  // Throws when closed
+    int64_t id = store_->last_id[static_cast<size_t>(table)] + 1;
+    put(table, RowKey{id}, row);
+    return id;
+}
+
+bool MemoryEngine::erase(Table table, const RowKey& key) {
+    RowKey k = normalize(table, key);
+    auto& table_rows = rows(table);
+    auto it = table_rows.find(k);
+    if (it == table_rows.end()) {
+        return false;
+    }
+    remember(table, k);
+    table_rows.erase(it);
+    return true;
+}
+
+size_t MemoryEngine::erase_range(Table table, const KeyRange& range) {
+    KeyRange r = normalize(table, range);
+    auto& table_rows = rows(table);
+    if (r.last < r.first) {
+        return 0;
+    }
+    auto first = table_rows.lower_bound(r.first);
+    auto last = table_rows.upper_bound(r.last);
+    size_t erased = 0;
+    for (auto it = first; it != last; ++erased) {
+        remember(table, it->first);
+        it = table_rows.erase(it);
+    }
+    return erased;
+}
+
+void MemoryEngine::scan(Table table, const KeyRange& range, const Visitor& visit,
+                        const Projection& columns, ScanOrder order)
+{
+    KeyRange r = normalize(table, range);
+    if (r.last < r.first) {
+        return;
+    }
+    auto& table_rows = rows(table);
+    auto first = table_rows.lower_bound(r.first);
+    auto last = table_rows.upper_bound(r.last);
+
+    auto emit = [&](const std::pair<const RowKey, Row>& entry) {
+        if (!columns.only.has_value()) {
+            return visit(entry.first, entry.second);  // No copy
+        }
+        return visit(entry.first, project(table, entry.second, columns));
+    };
+
+    if (order == ScanOrder::kAscending) {
+        for (auto it = first; it != last; ++it) {
+            if (!emit(*it)) {
+                return;
+            }
+        }
+    } else {
+        for (auto it = std::make_reverse_iterator(last); it != std::make_reverse_iterator(first);
+             ++it) {
+            if (!emit(*it)) {
+                return;
+            }
+        }
+    }
+}
+
+uint64_t MemoryEngine::count_matching(Table table, size_t column, int64_t value) {
+    uint64_t count = 0;
+    for (const auto& [key, row] : rows(table)) {
+        const auto* v = std::get_if<int64_t>(&row.values.at(column));
+        if (v != nullptr && *v == value) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void MemoryEngine::scan_by(Table table, size_t column, const Visitor& visit,
+                           const Projection& columns, ScanOrder order)
+{
+    // No index: sort the rows (key order already breaks ties)
+    std::vector<const std::pair<const RowKey, Row>*> sorted;
+    for (const auto& entry : rows(table)) {
+        sorted.push_back(&entry);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [&](const auto* x, const auto* y) {
+        int64_t vx = x->second.integer(column);
+        int64_t vy = y->second.integer(column);
+        return order == ScanOrder::kDescending ? vx > vy : vx < vy;
+    });
+    for (const auto* entry : sorted) {
+        if (!visit(entry->first, project(table, entry->second, columns))) {
+            return;
+        }
+    }
+}
+
+void MemoryEngine::scan_subkey(Table table, int64_t b, const Visitor& visit,
+                               const Projection& columns)
+{
+    if (table_spec(table).subkey == nullptr) {
+        throw std::invalid_argument(std::string("No second key column in ") +
+                                    table_spec(table).name);
+    }
+    for (const auto& [key, row] : rows(table)) {
+        if (key.b == b && !visit(key, project(table, row, columns))) {
+            return;
+        }
+    }
+}
+
+StorageEngine::TableUsage MemoryEngine::usage(Table table, size_t blob_column) {
+    TableUsage result;
+    for (const auto& [key, row] : rows(table)) {
+        ++result.rows;
+        result.bytes += row.blob(blob_column).size();
+    }
+    return result;
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -0,0 +1,85 @@
+#include "bastionx/storage/NoteCache.h"
+
+namespace bastionx {
+namespace storage {
+
+NoteCache::NoteCache(size_t budget_bytes)
+    : budget_bytes_(budget_bytes) {
+}
+
+void NoteCache::set_budget(size_t budget_bytes) {
+    budget_bytes_ = budget_bytes;
+    if (budget_bytes_ == 0) {
+        clear();
+        return;
+    }
+    make_room(0);
+}
+
+const NoteCache::Entry* NoteCache::find(int64_t note_id) {
+    auto it = index_.find(note_id);
+    if (it == index_.end()) {
+        stats_.misses++;
+        return nullptr;
+    }
+    stats_.hits++;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return &it->second->entry;
+}
+
+bool NoteCache::put(int64_t note_id, Entry entry) {
+    auto existing = index_.find(note_id);
+    if (existing != index_.end()) {
+        stats_.bytes -= existing->second->entry.record.size();
+        lru_.erase(existing->second);
+        index_.erase(existing);
+    }
+
+    size_t bytes = entry.record.size();
+    if (budget_bytes_ == 0 || bytes > budget_bytes_ / 4) {
+        return false;
+    }
+
+    make_room(bytes);
+    lru_.push_front(Node{note_id, std::move(entry)});
+    index_[note_id] = lru_.begin();
+    stats_.bytes += bytes;
+    return true;
+}
+
+void NoteCache::erase(int64_t note_id) {
+    auto it = index_.find(note_id);
+    if (it == index_.end()) {
+        return;
+    }
+    stats_.bytes -= it->second->entry.record.size();
+    stats_.invalidations++;
+    lru_.erase(it->second);  // SecureBytes wipes on free
+    index_.erase(it);
+}
+
+void NoteCache::clear() {
+    lru_.clear();
+    index_.clear();
+    stats_.bytes = 0;
+}
+
+NoteCache::Stats NoteCache::stats() const {
+    Stats stats = stats_;
+    stats.entries = lru_.size();
+    stats.budget_bytes = budget_bytes_;
+    return stats;
+}
+
+void NoteCache::make_room(size_t incoming) {
+    while (!lru_.empty() && stats_.bytes + incoming > budget_bytes_) {
+        auto& oldest = lru_.back();
+        stats_.bytes -= oldest.entry.record.size();
+        stats_.evictions++;
+        index_.erase(oldest.note_id);
+        lru_.pop_back();
+    }
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -0,0 +1,159 @@
+#define ZSTD_STATIC_LINKING_ONLY  // ZSTD_customMem / *_advanced allocators
+#include "bastionx/storage/NoteCompressor.h"
+#include <sodium.h>
+#include <zstd.h>
+#include <zdict.h>
+#include <stdexcept>
+
+namespace bastionx {
+namespace storage {
+
+// zstd allocates its windows and dictionary tables through these, so
+// plaintext it buffers sits in locked memory and is wiped by sodium_free()
+static void* secure_zstd_alloc(void*, size_t size) {
+    return sodium_malloc(size);
+}
+
+static void secure_zstd_free(void*, void* ptr) {
+    sodium_free(ptr);  // Accepts nullptr
+}
+
+static const ZSTD_customMem kSecureMem = {secure_zstd_alloc, secure_zstd_free, nullptr};
+
+NoteCompressor::NoteCompressor() {
+    cctx_ = ZSTD_createCCtx_advanced(kSecureMem);
+    dctx_ = ZSTD_createDCtx_advanced(kSecureMem);
+    if (cctx_ == nullptr || dctx_ == nullptr) {
+        ZSTD_freeCCtx(cctx_);
+        ZSTD_freeDCtx(dctx_);
+        throw std::runtime_error("Failed to allocate compression context");
+    }
+    ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel, kLevel);
+    ZSTD_CCtx_setParameter(cctx_, ZSTD_c_checksumFlag, 0);  // AEAD already authenticates
+}
+
+NoteCompressor::~NoteCompressor() {
+    clear_dictionaries();
+    ZSTD_freeCCtx(cctx_);
+    ZSTD_freeDCtx(dctx_);
+}
+
+std::optional<crypto::SecureBytes> NoteCompressor::compress(std::span<const uint8_t> payload) {
+    crypto::SecureBytes frame(ZSTD_compressBound(payload.size()));
+
+    size_t size;
+    auto it = dictionaries_.find(active_id_);
+    if (it != dictionaries_.end()) {
+        size = ZSTD_compress_usingCDict(cctx_, frame.data(), frame.size(),
+                                        payload.data(), payload.size(), it->second.cdict);
+    } else {
+        size = ZSTD_compress2(cctx_, frame.data(), frame.size(),
+                              payload.data(), payload.size());
+    }
+
+    if (ZSTD_isError(size) || size >= payload.size()) {
+        return std::nullopt;  // Incompressible: store as-is
+    }
+    frame.resize(size);
+    return frame;
+}
+
+std::optional<crypto::SecureBytes> NoteCompressor::decompress(std::span<const uint8_t> frame) {
+    unsigned long long content_size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+    if (content_size == ZSTD_CONTENTSIZE_ERROR ||
+        content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        content_size > kMaxPayloadBytes) {
+        return std::nullopt;
+    }
+
+    const ZSTD_DDict_s* ddict = nullptr;
+    uint32_t dict_id = ZSTD_getDictID_fromFrame(frame.data(), frame.size());
+    if (dict_id != 0) {
+        auto it = dictionaries_.find(dict_id);
+        if (it == dictionaries_.end()) {
+            return std::nullopt;  // Dictionary not loaded
+        }
+        ddict = it->second.ddict;
+    }
+
+    crypto::SecureBytes payload(static_cast<size_t>(content_size));
+    size_t size = ZSTD_decompress_usingDDict(dctx_, payload.data(), payload.size(),
+                                             frame.data(), frame.size(), ddict);
+    if (ZSTD_isError(size) || size != payload.size()) {
+        return std::nullopt;
+    }
+    return payload;
+}
+
+uint32_t NoteCompressor::add_dictionary(std::span<const uint8_t> dictionary) {
+    uint32_t id = dictionary_id(dictionary);
+    if (id == 0) {
+        throw std::invalid_argument("Not a zstd dictionary");
+    }
+
+    if (dictionaries_.find(id) == dictionaries_.end()) {
+        Dictionary dict;
+        dict.cdict = ZSTD_createCDict_advanced(
+            dictionary.data(), dictionary.size(), ZSTD_dlm_byCopy, ZSTD_dct_fullDict,
+            ZSTD_getCParams(kLevel, 0, dictionary.size()), kSecureMem);
+        dict.ddict = ZSTD_createDDict_advanced(
+            dictionary.data(), dictionary.size(), ZSTD_dlm_byCopy, ZSTD_dct_fullDict,
+            kSecureMem);
+        if (dict.cdict == nullptr || dict.ddict == nullptr) {
+            ZSTD_freeCDict(dict.cdict);
+            ZSTD_freeDDict(dict.ddict);
+            throw std::invalid_argument("Failed to load zstd dictionary");
+        }
+        dictionaries_.emplace(id, dict);
+    }
+
+    active_id_ = id;
+    return id;
+}
+
+void NoteCompressor::clear_dictionaries() {
+    for (auto& [id, dict] : dictionaries_) {
+        ZSTD_freeCDict(dict.cdict);
+        ZSTD_freeDDict(dict.ddict);
+    }
+    dictionaries_.clear();
+    active_id_ = 0;
+}
+
+crypto::SecureBytes NoteCompressor::train_dictionary(
+    const std::vector<crypto::SecureBytes>& samples, size_t dictionary_bytes)
+{
+    // ZDICT wants all samples back to back plus their sizes
+    size_t total = 0;
+    for (const auto& sample : samples) {
+        total += sample.size();
+    }
+    crypto::SecureBytes joined;
+    joined.reserve(total);
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        joined.insert(joined.end(), sample.begin(), sample.end());
+        sizes.push_back(sample.size());
+    }
+
+    // Note: ZDICT's own working tables come from malloc(); training runs once
+    // per vault, and those buffers are freed before this returns
+    crypto::SecureBytes dictionary(dictionary_bytes);
+    size_t size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(),
+                                        joined.data(), sizes.data(),
+                                        static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size)) {
+        throw std::runtime_error(std::string("Dictionary training failed: ") +
+                                 ZDICT_getErrorName(size));
+    }
+    dictionary.resize(size);
+    return dictionary;
+}
+
+uint32_t NoteCompressor::dictionary_id(std::span<const uint8_t> dictionary) {
+    return ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -0,0 +1,166 @@
+#include "bastionx/storage/NoteDelta.h"
+#include <cstring>
+#include <unordered_map>
+
+namespace bastionx {
+namespace storage {
+
+// Rabin-Karp polynomial hash over kBlockBytes, mod 2^64
+static constexpr uint64_t kHashBase = 0x100000001B3ull;
+
+static uint64_t block_hash(const uint8_t* p) {
+    uint64_t h = 0;
+    for (size_t i = 0; i < NoteDelta::kBlockBytes; ++i) {
+        h = h * kHashBase + p[i];
+    }
+    return h;
+}
+
+static uint64_t hash_base_pow() {
+    uint64_t pow = 1;
+    for (size_t i = 0; i < NoteDelta::kBlockBytes; ++i) {
+        pow *= kHashBase;
+    }
+    return pow;
+}
+
+static void put_varint(crypto::SecureBytes& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool get_varint(std::span<const uint8_t> in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) {
+            return false;
+        }
+        uint8_t byte = in[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+crypto::SecureBytes NoteDelta::encode(std::span<const uint8_t> base,
+                                      std::span<const uint8_t> target)
+{
+    crypto::SecureBytes delta;
+    delta.reserve(16 + target.size() / 8);
+    delta.push_back(kVersion);
+    put_varint(delta, target.size());
+
+    auto emit_insert = [&](size_t from, size_t to) {
+        if (to > from) {
+            put_varint(delta, static_cast<uint64_t>(to - from) << 1);
+            delta.insert(delta.end(), target.begin() + from, target.begin() + to);
+        }
+    };
+
+    if (base.size() < kBlockBytes || target.size() < kBlockBytes) {
+        emit_insert(0, target.size());
+        return delta;
+    }
+
+    // Block-aligned base offsets by hash (first occurrence wins)
+    std::unordered_map<uint64_t, size_t> index;
+    index.reserve(base.size() / kBlockBytes);
+    for (size_t off = 0; off + kBlockBytes <= base.size(); off += kBlockBytes) {
+        index.emplace(block_hash(base.data() + off), off);
+    }
+
+    // Slide over every target offset so shifted text still lines up
+    const uint64_t pow = hash_base_pow();
+    size_t literal = 0;
+    size_t pos = 0;
+    uint64_t h = block_hash(target.data());
+    while (pos + kBlockBytes <= target.size()) {
+        auto it = index.find(h);
+        if (it != index.end() &&
+            std::memcmp(base.data() + it->second, target.data() + pos, kBlockBytes) == 0) {
+            size_t off = it->second;
+            size_t start = pos;
+            while (start > literal && off > 0 && base[off - 1] == target[start - 1]) {
+                --start;
+                --off;
+            }
+            size_t len = pos - start + kBlockBytes;
+            while (start + len < target.size() && off + len < base.size() &&
+                   base[off + len] == target[start + len]) {
+                ++len;
+            }
+
+            emit_insert(literal, start);
+            put_varint(delta, (static_cast<uint64_t>(len) << 1) | 1);
+            put_varint(delta, off);
+            pos = start + len;
+            literal = pos;
+            if (pos + kBlockBytes <= target.size()) {
+                h = block_hash(target.data() + pos);
+            }
+            continue;
+        }
+
+        if (pos + kBlockBytes < target.size()) {
+            h = h * kHashBase + target[pos + kBlockBytes] - pow * target[pos];
+        }
+        ++pos;
+    }
+    emit_insert(literal, target.size());
+    return delta;
+}
+
+std::optional<crypto::SecureBytes> NoteDelta::apply(std::span<const uint8_t> base,
+                                                    std::span<const uint8_t> delta)
+{
+    if (delta.empty() || delta[0] != kVersion) {
+        return std::nullopt;
+    }
+    size_t pos = 1;
+    uint64_t target_size = 0;
+    // A copy or insert adds at most as many bytes as the delta or base holds
+    // per op, so larger claims are malformed
+    if (!get_varint(delta, pos, target_size) ||
+        target_size > (base.size() + 1) * delta.size()) {
+        return std::nullopt;
+    }
+
+    crypto::SecureBytes target;
+    target.reserve(target_size);
+    while (pos < delta.size()) {
+        uint64_t op = 0;
+        if (!get_varint(delta, pos, op)) {
+            return std::nullopt;
+        }
+        uint64_t len = op >> 1;
+        if (len == 0 || len > target_size - target.size()) {
+            return std::nullopt;
+        }
+        if (op & 1) {
+            uint64_t off = 0;
+            if (!get_varint(delta, pos, off) || off > base.size() || len > base.size() - off) {
+                return std::nullopt;
+            }
+            target.insert(target.end(), base.begin() + off, base.begin() + off + len);
+        } else {
+            if (len > delta.size() - pos) {
+                return std::nullopt;
+            }
+            target.insert(target.end(), delta.begin() + pos, delta.begin() + pos + len);
+            pos += len;
+        }
+    }
+
+    if (target.size() != target_size) {
+        return std::nullopt;
+    }
+    return target;
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -0,0 +1,310 @@
+#include "bastionx/storage/NoteExporter.h"
+#include "bastionx/crypto/SecretStream.h"
+#include "bastionx/storage/NoteRecord.h"
+#include "bastionx/util/FileSync.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace bastionx {
+namespace storage {
+
+namespace fs = std::filesystem;
+
+// Archive header: magic || from_seq || to_seq || secretstream header.
+// The first 24 bytes are the associated data of every message.
+static constexpr char kArchiveMagic[8] = {'B', 'X', 'E', 'X', 'P', 'v', '1', '\0'};
+static constexpr size_t kBindingBytes = 8 + 8 + 8;
+static constexpr size_t kHeaderBytes = kBindingBytes + crypto::SecretStreamWriter::HEADER_BYTES;
+
+// Message kinds (first plaintext byte)
+static constexpr uint8_t kKindEnd = 0;
+static constexpr uint8_t kKindNote = 1;
+static constexpr uint8_t kKindDeletion = 2;
+
+// kind || note_id || seq, then for notes created_at || updated_at || record
+static constexpr size_t kEntryBytes = 1 + 8 + 8;
+static constexpr size_t kNoteBytes = kEntryBytes + 8 + 8;
+
+static constexpr const char* kWatermarkFile = "watermark";
+
+// Little-endian on x64 (same convention as NoteRecord)
+template <typename T, typename Buffer>
+static void put_int(Buffer& out, T value) {
+    size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+template <typename T>
+static T get_int(const uint8_t* src) {
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return value;
+}
+
+static std::string archive_name(int64_t from, int64_t to) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "changes-%020lld-%020lld",
+                  static_cast<long long>(from), static_cast<long long>(to));
+    return std::string(buf) + NoteExporter::kArchiveExtension;
+}
+
+// === NoteExporter Implementation ===
+
+NoteExporter::NoteExporter(NotesRepository& repo, std::string export_dir)
+    : repo_(repo), export_dir_(std::move(export_dir)) {}
+
+int64_t NoteExporter::watermark() const {
+    fs::path path = fs::path(export_dir_) / kWatermarkFile;
+    std::error_code ec;
+    if (!fs::exists(path, ec)) {
+        return 0;
+    }
+    std::ifstream in(path);
+    long long value = -1;
+    if (!(in >> value) || value < 0) {
+        throw std::runtime_error("Unreadable export watermark: " + path.string());
+    }
+    return value;
+}
+
+void NoteExporter::store_watermark(int64_t watermark) {
+    fs::path path = fs::path(export_dir_) / kWatermarkFile;
+    fs::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        out << watermark << '\n';
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Failed to write export watermark: " + temp.string());
+        }
+    }
+    util::sync_file(temp);
+    fs::rename(temp, path);
+    util::sync_directory(export_dir_);
+}
+
+NoteExporter::Result NoteExporter::export_changes(const crypto::SecureKey& notes_subkey,
+                                                  const crypto::SecureKey& export_key)
+{
+    Result result;
+    int64_t since = watermark();
+    result.watermark = since;
+
+    auto changes = repo_.changes_since(since);
+    if (changes.empty()) {
+        return result;
+    }
+    int64_t to = changes.back().seq;
+
+    std::error_code ec;
+    fs::create_directories(export_dir_, ec);
+    if (!fs::is_directory(export_dir_)) {
+        throw std::runtime_error("Failed to create export directory: " + export_dir_);
+    }
+    fs::path archive = fs::path(export_dir_) / archive_name(since, to);
+    fs::path partial = archive;
+    partial += ".part";
+
+    try {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Failed to create export archive: " + partial.string());
+        }
+
+        crypto::SecretStreamWriter stream(export_key);
+        std::vector<uint8_t> header;
+        header.reserve(kHeaderBytes);
+        header.insert(header.end(), kArchiveMagic, kArchiveMagic + 8);
+        put_int<int64_t>(header, since);
+        put_int<int64_t>(header, to);
+        header.insert(header.end(), stream.header().begin(), stream.header().end());
+        out.write(reinterpret_cast<const char*>(header.data()),
+                  static_cast<std::streamsize>(header.size()));
+        std::span<const uint8_t> binding(header.data(), kBindingBytes);
+
+        crypto::SecureBytes message;
+        std::vector<uint8_t> ciphertext;
+        auto write_message = [&](bool final) {
+            stream.push(message, binding, final, ciphertext);
+            std::vector<uint8_t> length;
+            put_int<uint32_t>(length, static_cast<uint32_t>(ciphertext.size()));
+            out.write(reinterpret_cast<const char*>(length.data()), 4);
+            out.write(reinterpret_cast<const char*>(ciphertext.data()),
+                      static_cast<std::streamsize>(ciphertext.size()));
+        };
+
+        for (const auto& change : changes) {
+            message.clear();
+            if (change.deleted) {
+                put_int<uint8_t>(message, kKindDeletion);
+                put_int<int64_t>(message, change.note_id);
+                put_int<int64_t>(message, change.seq);
+                ++result.deletions;
+            } else {
+                auto note = repo_.read_note(change.note_id, notes_subkey);
+                if (!note.has_value()) {
+                    throw std::runtime_error("Changed note could not be read: " +
+                                             std::to_string(change.note_id));
+                }
+                auto record = NoteRecord::encode(note->title.view(), note->tags,
+                                                 note->body.view());
+                put_int<uint8_t>(message, kKindNote);
+                put_int<int64_t>(message, change.note_id);
+                put_int<int64_t>(message, change.seq);
+                put_int<int64_t>(message, note->created_at);
+                put_int<int64_t>(message, note->updated_at);
+                message.insert(message.end(), record.begin(), record.end());
+                ++result.notes;
+            }
+            write_message(false);
+        }
+
+        message.clear();
+        put_int<uint8_t>(message, kKindEnd);
+        put_int<uint64_t>(message, result.notes);
+        put_int<uint64_t>(message, result.deletions);
+        write_message(true);
+
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Failed to write export archive: " + partial.string());
+        }
+        out.close();
+
+        // Archive first, then the watermark: a crash in between repeats
+        // these changes next time rather than skipping them. Both renames
+        // are made durable in that order, or a power loss could keep the
+        // new watermark but lose the archive it covers
+        util::sync_file(partial);
+        fs::rename(partial, archive);
+        util::sync_directory(export_dir_);
+        store_watermark(to);
+    } catch (const fs::filesystem_error& e) {
+        fs::remove(partial, ec);
+        throw std::runtime_error(std::string("Failed to save export: ") + e.what());
+    } catch (...) {
+        fs::remove(partial, ec);
+        throw;
+    }
+
+    result.archive = archive.string();
+    result.watermark = to;
+    return result;
+}
+
+std::vector<std::string> NoteExporter::archives() const {
+    std::vector<std::string> found;
+    std::error_code ec;
+    if (!fs::is_directory(export_dir_, ec)) {
+        return found;
+    }
+    for (const auto& entry : fs::directory_iterator(export_dir_, ec)) {
+        if (entry.path().extension() == kArchiveExtension) {
+            found.push_back(entry.path().string());
+        }
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+void NoteExporter::read_archive(const std::string& path, const crypto::SecureKey& export_key,
+                                const Visitor& visit)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open export archive: " + path);
+    }
+
+    uint8_t header[kHeaderBytes];
+    in.read(reinterpret_cast<char*>(header), kHeaderBytes);
+    if (in.gcount() != static_cast<std::streamsize>(kHeaderBytes) ||
+        std::memcmp(header, kArchiveMagic, 8) != 0) {
+        throw std::runtime_error("Not an export archive: " + path);
+    }
+    std::span<const uint8_t> binding(header, kBindingBytes);
+    crypto::SecretStreamReader stream(
+        export_key, std::span<const uint8_t>(header + kBindingBytes,
+                                             crypto::SecretStreamReader::HEADER_BYTES));
+
+    std::vector<uint8_t> ciphertext;
+    crypto::SecureBytes message;
+    uint64_t notes = 0, deletions = 0;
+    while (!stream.finished()) {
+        uint8_t length_bytes[4];
+        in.read(reinterpret_cast<char*>(length_bytes), 4);
+        if (in.gcount() != 4) {
+            throw std::runtime_error("Export archive is truncated: " + path);
+        }
+        uint32_t length = get_int<uint32_t>(length_bytes);
+        if (length < crypto::SecretStreamReader::ABYTES + 1) {
+            throw std::runtime_error("Export archive is corrupt: " + path);
+        }
+        ciphertext.resize(length);
+        in.read(reinterpret_cast<char*>(ciphertext.data()), length);
+        if (in.gcount() != static_cast<std::streamsize>(length)) {
+            throw std::runtime_error("Export archive is truncated: " + path);
+        }
+
+        message.resize(length - crypto::SecretStreamReader::ABYTES);
+        size_t message_len = 0;
+        if (!stream.pull(ciphertext, binding, message.data(), &message_len)) {
+            throw std::runtime_error("Export archive failed authentication: " + path);
+        }
+        message.resize(message_len);
+
+        const uint8_t* p = message.data();
+        uint8_t kind = message_len > 0 ? p[0] : 0xFF;
+        if (kind == kKindEnd) {
+            if (message_len != 1 + 8 + 8 || !stream.finished() ||
+                get_int<uint64_t>(p + 1) != notes || get_int<uint64_t>(p + 9) != deletions) {
+                throw std::runtime_error("Export archive is corrupt: " + path);
+            }
+            break;
+        }
+        if (stream.finished() || message_len < kEntryBytes ||
+            (kind != kKindNote && kind != kKindDeletion)) {
+            throw std::runtime_error("Export archive is corrupt: " + path);
+        }
+
+        ExportEntry entry;
+        entry.note_id = get_int<int64_t>(p + 1);
+        entry.seq = get_int<int64_t>(p + 9);
+        entry.deleted = (kind == kKindDeletion);
+        if (kind == kKindNote) {
+            auto view = message_len >= kNoteBytes
+                ? NoteRecord::decode(std::span<const uint8_t>(p + kNoteBytes,
+                                                              message_len - kNoteBytes))
+                : std::nullopt;
+            if (!view.has_value() || view->body_chunks > 0) {
+                throw std::runtime_error("Export archive is corrupt: " + path);
+            }
+            Note note;
+            note.id = entry.note_id;
+            note.title = view->title;
+            note.body = view->body;
+            for (auto tag : view->tags) {
+                note.tags.emplace_back(tag);
+            }
+            note.created_at = get_int<int64_t>(p + kEntryBytes);
+            note.updated_at = get_int<int64_t>(p + kEntryBytes + 8);
+            entry.note = std::move(note);
+            ++notes;
+        } else {
+            ++deletions;
+        }
+        visit(entry);
+    }
+
+    if (in.peek() != std::ifstream::traits_type::eof()) {
+        throw std::runtime_error("Export archive has trailing data: " + path);
+    }
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -0,0 +1,84 @@
+#include "bastionx/storage/NotePack.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace bastionx {
+namespace storage {
+
+// Little-endian on x64 (same convention as NoteRecord)
+template <typename T>
+static void put(uint8_t* dst, T value) {
+    std::memcpy(dst, &value, sizeof(T));
+}
+
+template <typename T>
+static T get(const uint8_t* src) {
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return value;
+}
+
+crypto::SecureBytes NotePack::encode(const std::vector<Entry>& entries) {
+    if (entries.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Too many notes for one pack");
+    }
+
+    size_t payload_bytes = 0;
+    for (const auto& entry : entries) {
+        if (entry.payload.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::invalid_argument("Note too large for a pack");
+        }
+        payload_bytes += entry.payload.size();
+    }
+
+    crypto::SecureBytes pack(kHeaderBytes + entries.size() * kEntryBytes + payload_bytes);
+    uint8_t* p = pack.data();
+    p[0] = kVersion;
+    put<uint32_t>(p + 4, static_cast<uint32_t>(entries.size()));
+
+    uint8_t* index = p + kHeaderBytes;
+    uint8_t* data = index + entries.size() * kEntryBytes;
+    for (const auto& entry : entries) {
+        put<int64_t>(index, entry.note_id);
+        put<uint32_t>(index + 8, static_cast<uint32_t>(entry.payload.size()));
+        index += kEntryBytes;
+        std::memcpy(data, entry.payload.data(), entry.payload.size());
+        data += entry.payload.size();
+    }
+    return pack;
+}
+
+std::optional<std::vector<NotePack::Entry>> NotePack::decode(std::span<const uint8_t> pack) {
+    if (pack.size() < kHeaderBytes || pack[0] != kVersion) {
+        return std::nullopt;
+    }
+
+    uint64_t count = get<uint32_t>(pack.data() + 4);
+    uint64_t offset = kHeaderBytes + count * kEntryBytes;
+    if (offset > pack.size()) {
+        return std::nullopt;
+    }
+
+    std::vector<Entry> entries(count);
+    const uint8_t* index = pack.data() + kHeaderBytes;
+    for (auto& entry : entries) {
+        uint64_t length = get<uint32_t>(index + 8);
+        if (offset + length > pack.size()) {
+            return std::nullopt;
+        }
+        entry.note_id = get<int64_t>(index);
+        entry.payload = pack.subspan(offset, length);
+        offset += length;
+        index += kEntryBytes;
+    }
+
+    // Payloads fill the rest of the pack exactly
+    if (offset != pack.size()) {
+        return std::nullopt;
+    }
+    return entries;
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -0,0 +1,203 @@
+#include "bastionx/storage/NoteRecord.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace bastionx {
+namespace storage {
+
+// Little-endian on x64 (same convention as the AAD builders)
+template <typename T>
+static void put(uint8_t* dst, T value) {
+    std::memcpy(dst, &value, sizeof(T));
+}
+
+template <typename T>
+static T get(const uint8_t* src) {
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return value;
+}
+
+// Longest prefix of `text` of at most `max_bytes` that does not end inside
+// a UTF-8 sequence (backs off over continuation bytes at the cut)
+static std::string_view utf8_prefix(std::string_view text, size_t max_bytes) {
+    if (text.size() <= max_bytes) {
+        return text;
+    }
+    size_t end = max_bytes;
+    for (size_t back = 0; back < 3 && end > 0; ++back) {
+        if ((static_cast<uint8_t>(text[end]) & 0xC0) != 0x80) {
+            break;  // `end` starts a code point
+        }
+        --end;
+    }
+    if ((static_cast<uint8_t>(text[end]) & 0xC0) == 0x80) {
+        end = max_bytes;  // Not valid UTF-8 here anyway; cut at the limit
+    }
+    return text.substr(0, end);
+}
+
+crypto::SecureBytes NoteRecord::encode(std::string_view title,
+                                       const std::vector<std::string>& tags,
+                                       std::string_view body,
+                                       std::span<const ChunkRef> chunks)
+{
+    constexpr size_t kMaxU32 = std::numeric_limits<uint32_t>::max();
+    constexpr size_t kMaxU16 = std::numeric_limits<uint16_t>::max();
+
+    size_t tags_len = 0;
+    for (const auto& tag : tags) {
+        if (tag.size() > kMaxU16) {
+            throw std::invalid_argument("Tag too long for note record");
+        }
+        tags_len += 2 + tag.size();
+    }
+    if (title.size() > kMaxU32 || tags.size() > kMaxU16 || tags_len > kMaxU32) {
+        throw std::invalid_argument("Note too large for note record");
+    }
+
+    uint64_t chunked_bytes = 0;
+    for (const auto& chunk : chunks) {
+        chunked_bytes += chunk.size;
+    }
+    if (!chunks.empty() && chunked_bytes != body.size()) {
+        throw std::invalid_argument("Chunk manifest does not cover the body");
+    }
+
+    std::string_view preview = utf8_prefix(body, kPreviewBytes);
+    std::string_view inline_body = chunks.empty() ? body : std::string_view();
+
+    crypto::SecureBytes record(kHeaderBytes + title.size() + tags_len + preview.size() +
+                               inline_body.size() + chunks.size() * kChunkRefBytes);
+    uint8_t* p = record.data();
+
+    p[0] = kVersion;
+    p[1] = chunks.empty() ? 0 : (kFlagChunked | kFlagManifest);
+    put<uint16_t>(p + 2, static_cast<uint16_t>(tags.size()));
+    put<uint32_t>(p + 4, static_cast<uint32_t>(title.size()));
+    put<uint32_t>(p + 8, static_cast<uint32_t>(tags_len));
+    put<uint32_t>(p + 12, static_cast<uint32_t>(preview.size()));
+    put<uint64_t>(p + 16, body.size());
+    put<uint64_t>(p + 24, chunks.size());
+    p += kHeaderBytes;
+
+    std::memcpy(p, title.data(), title.size());
+    p += title.size();
+    for (const auto& tag : tags) {
+        put<uint16_t>(p, static_cast<uint16_t>(tag.size()));
+        std::memcpy(p + 2, tag.data(), tag.size());
+        p += 2 + tag.size();
+    }
+    std::memcpy(p, preview.data(), preview.size());
+    p += preview.size();
+    std::memcpy(p, inline_body.data(), inline_body.size());
+    p += inline_body.size();
+    for (const auto& chunk : chunks) {
+        put<uint64_t>(p, chunk.chunk_id);
+        put<uint32_t>(p + 8, chunk.size);
+        std::memcpy(p + 12, chunk.hash.data(), kChunkHashBytes);
+        p += kChunkRefBytes;
+    }
+
+    return record;
+}
+
+std::optional<NoteRecord::View> NoteRecord::decode(std::span<const uint8_t> record,
+                                                   bool header_only)
+{
+    if (record.size() < kHeaderBytes || record[0] != kVersion) {
+        return std::nullopt;
+    }
+
+    const uint8_t* p = record.data();
+    uint8_t flags = p[1];
+    uint16_t tag_count = get<uint16_t>(p + 2);
+    uint64_t title_len = get<uint32_t>(p + 4);
+    uint64_t tags_len = get<uint32_t>(p + 8);
+    uint64_t preview_len = get<uint32_t>(p + 12);
+
+    View view;
+    view.body_bytes = get<uint64_t>(p + 16);
+    view.body_chunks = get<uint64_t>(p + 24);
+
+    bool chunked = (flags & kFlagChunked) != 0;
+    bool manifest = (flags & kFlagManifest) != 0;
+    if ((flags & ~(kFlagChunked | kFlagManifest)) != 0 || (manifest && !chunked) ||
+        chunked != (view.body_chunks > 0) || preview_len > kPreviewBytes ||
+        preview_len > view.body_bytes) {
+        return std::nullopt;
+    }
+
+    // All lengths are at most 32 bits, so these sums cannot overflow
+    uint64_t header_end = kHeaderBytes + title_len + tags_len + preview_len;
+    if (header_end > record.size()) {
+        return std::nullopt;
+    }
+
+    auto text = [&](uint64_t offset, uint64_t len) {
+        return std::string_view(reinterpret_cast<const char*>(p + offset), len);
+    };
+
+    uint64_t off = kHeaderBytes;
+    view.title = text(off, title_len);
+    off += title_len;
+
+    uint64_t tags_end = off + tags_len;
+    view.tags.reserve(tag_count);
+    for (uint16_t i = 0; i < tag_count; ++i) {
+        if (off + 2 > tags_end) {
+            return std::nullopt;
+        }
+        uint16_t len = get<uint16_t>(p + off);
+        if (off + 2 + len > tags_end) {
+            return std::nullopt;
+        }
+        view.tags.push_back(text(off + 2, len));
+        off += 2 + len;
+    }
+    if (off != tags_end) {
+        return std::nullopt;
+    }
+
+    view.preview = text(off, preview_len);
+    off += preview_len;
+
+    if (header_only) {
+        return view;
+    }
+
+    if (manifest) {
+        // The manifest fills the rest of the record exactly, and its chunk
+        // sizes add up to the body
+        uint64_t remaining = record.size() - off;
+        if (remaining / kChunkRefBytes != view.body_chunks ||
+            remaining % kChunkRefBytes != 0) {
+            return std::nullopt;
+        }
+        uint64_t total = 0;
+        view.chunks.resize(view.body_chunks);
+        for (auto& chunk : view.chunks) {
+            chunk.chunk_id = get<uint64_t>(p + off);
+            chunk.size = get<uint32_t>(p + off + 8);
+            std::memcpy(chunk.hash.data(), p + off + 12, kChunkHashBytes);
+            total += chunk.size;
+            off += kChunkRefBytes;
+        }
+        if (total != view.body_bytes) {
+            return std::nullopt;
+        }
+        return view;
+    }
+
+    // Inline body fills the rest of the record exactly
+    uint64_t expected_body = chunked ? 0 : view.body_bytes;
+    if (record.size() - off != expected_body) {
+        return std::nullopt;
+    }
+    view.body = text(off, expected_body);
+    return view;
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -1,76 +1,93 @@
 #include "bastionx/storage/NotesRepository.h"
+#include "bastionx/crypto/SecretStream.h"
+#include "bastionx/storage/NotePack.h"
+#include "bastionx/storage/NoteRecord.h"
+#include "bastionx/storage/RecordAad.h"
+#include "bastionx/storage/SqliteEngine.h"
 #include <nlohmann/json.hpp>
+#include <sodium.h>
+#include <algorithm>
 #include <stdexcept>
 #include <cstring>
 #include <chrono>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string_view>
 
 namespace bastionx {
 namespace storage {
 
-using json = nlohmann::json;
-
-// === RAII wrapper for sqlite3_stmt* ===
+// JSON DOM whose strings, arrays and objects (and the lexer's token buffer)
+// are all allocated through SecureAllocator, so parsing a decrypted
+// version-1 payload never spills plaintext onto the ordinary heap
+using secure_json = nlohmann::basic_json<
+    std::map, std::vector, crypto::SecureString, bool,
+    std::int64_t, std::uint64_t, double, crypto::SecureAllocator>;
+
+// Sidebar preview: `len` bytes of body starting at `start`, with ellipses
+// marking truncation on either side
+static std::string make_preview(std::string_view body, size_t start, size_t len) {
+    size_t end = std::min(body.size(), start + len);
+    std::string preview(body.substr(start, end - start));
+    if (start > 0) preview = "..." + preview;
+    if (end < body.size()) preview += "...";
+    return preview;
+}
 
-class ScopedStmt {
-public:
-    ScopedStmt(sqlite3* db, const std::string& sql) : stmt_(nullptr) {
-        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt_, nullptr);
-        if (rc != SQLITE_OK) {
-            throw std::runtime_error(
-                "Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
-        }
+// Read the encrypted record of a row: every encrypted table keeps (nonce,
+// ciphertext, alg) as its first three columns. Returns nullopt for
+// malformed rows.
+static std::optional<crypto::CryptoService::EncryptedData> read_encrypted(const Row& row) {
+    auto nonce = row.blob(col::Notes::kNonce);
+    if (nonce.size() != crypto::CryptoService::NONCE_BYTES) {
+        return std::nullopt;
     }
 
-    ~ScopedStmt() {
-        if (stmt_) sqlite3_finalize(stmt_);
+    auto ciphertext = row.blob(col::Notes::kCiphertext);
+    if (ciphertext.empty()) {
+        return std::nullopt;
     }
 
-    ScopedStmt(const ScopedStmt&) = delete;
-    ScopedStmt& operator=(const ScopedStmt&) = delete;
+    crypto::CryptoService::EncryptedData encrypted;
+    std::memcpy(encrypted.nonce.data(), nonce.data(), crypto::CryptoService::NONCE_BYTES);
+    encrypted.ciphertext.assign(ciphertext.begin(), ciphertext.end());
+    encrypted.algorithm = static_cast<crypto::CryptoService::Algorithm>(
+        row.integer(col::Notes::kAlg));
+    return encrypted;
+}
 
-    sqlite3_stmt* get() const { return stmt_; }
+static void set_encrypted(Row& row, std::span<const uint8_t> nonce,
+                          std::span<const uint8_t> ciphertext,
+                          crypto::CryptoService::Algorithm algorithm)
+{
+    row.set(col::Notes::kNonce, nonce);
+    row.set(col::Notes::kCiphertext, ciphertext);
+    row.set(col::Notes::kAlg, static_cast<int64_t>(algorithm));
+}
 
-private:
-    sqlite3_stmt* stmt_;
-};
+static void set_encrypted(Row& row, const crypto::CryptoService::EncryptedData& encrypted) {
+    set_encrypted(row, encrypted.nonce, encrypted.ciphertext, encrypted.algorithm);
+}
 
-// Helper to execute a simple SQL statement
-static void exec_sql(sqlite3* db, const std::string& sql) {
-    char* err_msg = nullptr;
-    int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &err_msg);
-    if (rc != SQLITE_OK) {
-        std::string err = err_msg ? err_msg : "unknown error";
-        sqlite3_free(err_msg);
-        throw std::runtime_error("SQL error: " + err);
-    }
+// Placeholder record for a row whose key the real record's AAD needs
+static void set_placeholder(Row& row) {
+    row.set(col::Notes::kNonce, std::vector<uint8_t>(crypto::CryptoService::NONCE_BYTES, 0));
+    row.set(col::Notes::kCiphertext, std::vector<uint8_t>(1, 0));
+    row.set(col::Notes::kAlg, int64_t{0});
 }
 
 // === NotesRepository Implementation ===
 
-NotesRepository::NotesRepository(const std::string& db_path, const crypto::SecureKey* db_key)
-    : db_(nullptr), db_path_(db_path) {
-    int rc = sqlite3_open(db_path.c_str(), &db_);
-    if (rc != SQLITE_OK) {
-        std::string err = db_ ? sqlite3_errmsg(db_) : "unknown error";
-        if (db_) sqlite3_close(db_);
-        db_ = nullptr;
-        throw std::runtime_error("Failed to open database: " + err);
-    }
+NotesRepository::NotesRepository(const std::string& db_path, const crypto::SecureKey* db_key,
+                                 const ConnectionProfile& profile)
+    : engine_(std::make_unique<SqliteEngine>(db_path, db_key, profile)) {}
 
-    // Set SQLCipher encryption key if provided
-    if (db_key) {
-        rc = sqlite3_key(db_, db_key->data(), static_cast<int>(db_key->size()));
-        if (rc != SQLITE_OK) {
-            std::string err = sqlite3_errmsg(db_);
-            sqlite3_close(db_);
-            db_ = nullptr;
-            throw std::runtime_error("Failed to set encryption key: " + err);
-        }
-        exec_sql(db_, "PRAGMA cipher_memory_security = ON;");
+NotesRepository::NotesRepository(std::unique_ptr<StorageEngine> engine)
+    : engine_(std::move(engine)) {
+    if (!engine_) {
+        throw std::invalid_argument("NotesRepository needs a storage engine");
     }
-
-    // Enable WAL mode (after keying)
-    exec_sql(db_, "PRAGMA journal_mode=WAL;");
 }
 
 NotesRepository::~NotesRepository() {
@@ -78,14 +95,34 @@ NotesRepository::~NotesRepository() {
 }
 
 void NotesRepository::close() {
-    if (db_) {
-        sqlite3_close(db_);
-        db_ = nullptr;
+    if (!pending_.empty() && engine_ && engine_->is_open()) {
+        try {
+            flush_writes();
+        } catch (const std::runtime_error&) {
+            // Nothing to report to from here; flush_writes() is the barrier
+        }
     }
+    pending_.clear();
+    pack_cache_.clear();
+    note_cache_.clear();
+    if (engine_) {
+        engine_->close();
+    }
+}
+
+void NotesRepository::clear_caches() {
+    pack_cache_.clear();
+    note_cache_.clear();
+    compressor_.clear_dictionaries();
+    dictionaries_loaded_ = false;
 }
 
 bool NotesRepository::is_open() const {
-    return db_ != nullptr;
+    return engine_ && engine_->is_open();
+}
+
+StorageEngine& NotesRepository::engine() {
+    return *engine_;
 }
 
 // === CRUD Operations ===
@@ -94,103 +131,224 @@ int64_t NotesRepository::create_note(const Note& note, const crypto::SecureKey&
     int64_t now = current_timestamp();
 
     // Use a transaction: insert placeholder, get ID, encrypt with AAD, update
-    exec_sql(db_, "BEGIN TRANSACTION;");
+    engine_->begin();
 
     try {
         // Insert placeholder row to get the auto-generated ID
-        {
-            ScopedStmt stmt(db_,
-                "INSERT INTO notes (nonce, ciphertext, created_at, updated_at) "
-                "VALUES (zeroblob(24), zeroblob(1), ?, ?)");
-            sqlite3_bind_int64(stmt.get(), 1, now);
-            sqlite3_bind_int64(stmt.get(), 2, now);
+        Row placeholder(Table::kNotes);
+        set_placeholder(placeholder);
+        placeholder.set(col::Notes::kCodec, int64_t{0});
+        placeholder.set(col::Notes::kCreatedAt, now);
+        placeholder.set(col::Notes::kUpdatedAt, now);
+        int64_t note_id = engine_->insert(Table::kNotes, placeholder);
+
+        // Serialize and encrypt with the real ID as AAD (body chunked if large)
+        std::vector<int64_t> released;
+        store_note(note_id, note, subkey, std::nullopt, released);
+
+        engine_->commit();
+        return note_id;
 
-            int rc = sqlite3_step(stmt.get());
-            if (rc != SQLITE_DONE) {
-                throw std::runtime_error(
-                    "Failed to insert placeholder: " + std::string(sqlite3_errmsg(db_)));
-            }
-        }
+    } catch (...) {
+        engine_->rollback();
+        throw;
+    }
+}
+
+std::optional<Note> NotesRepository::read_note(int64_t id, const crypto::SecureKey& subkey) {
+    flush_pending();
+    if (auto cached = read_cached_note(id, subkey)) {
+        return cached;
+    }
 
-        int64_t note_id = sqlite3_last_insert_rowid(db_);
+    ChunkInfo info;
+    std::array<uint8_t, crypto::CryptoService::NONCE_BYTES> nonce{};
+    auto note = read_note_record(id, subkey, info, nonce);
+    if (!note.has_value()) {
+        return std::nullopt;
+    }
+    if (info.body_chunks == 0) {
+        cache_note(*note, subkey);
+    }
 
-        // Serialize and encrypt with the real ID as AAD
-        auto plaintext = serialize_note(note);
-        auto aad = build_aad(note_id);
-        auto encrypted = crypto::CryptoService::encrypt(plaintext, subkey, aad);
+    // Large body: decrypt chunk by chunk straight into its final buffer
+    if (info.body_chunks > 0) {
+        note->body.reserve(info.body_bytes);
+        bool ok = read_body(id, nonce, info, subkey, SIZE_MAX,
+            [&](std::string_view piece) { note->body.append(piece); });
+        if (!ok) {
+            return std::nullopt;  // Missing, reordered or tampered chunk
+        }
+    }
 
-        // Update with real encrypted data
-        {
-            ScopedStmt stmt(db_,
-                "UPDATE notes SET nonce = ?, ciphertext = ? WHERE id = ?");
-            sqlite3_bind_blob(stmt.get(), 1, encrypted.nonce.data(),
-                              static_cast<int>(encrypted.nonce.size()), SQLITE_STATIC);
-            sqlite3_bind_blob(stmt.get(), 2, encrypted.ciphertext.data(),
-                              static_cast<int>(encrypted.ciphertext.size()), SQLITE_STATIC);
-            sqlite3_bind_int64(stmt.get(), 3, note_id);
+    return note;
+}
 
-            int rc = sqlite3_step(stmt.get());
-            if (rc != SQLITE_DONE) {
-                throw std::runtime_error(
-                    "Failed to update note: " + std::string(sqlite3_errmsg(db_)));
-            }
+std::optional<Note> NotesRepository::read_note_streamed(
+    int64_t id, const crypto::SecureKey& subkey,
+    const std::function<void(std::string_view)>& body_sink)
+{
+    flush_pending();
+    ChunkInfo info;
+    std::array<uint8_t, crypto::CryptoService::NONCE_BYTES> nonce{};
+    auto note = read_cached_note(id, subkey);
+    if (!note.has_value()) {
+        note = read_note_record(id, subkey, info, nonce);
+        if (!note.has_value()) {
+            return std::nullopt;
+        }
+        if (info.body_chunks == 0) {
+            cache_note(*note, subkey);
         }
+    }
 
-        exec_sql(db_, "COMMIT;");
-        return note_id;
+    if (info.body_chunks == 0) {
+        // Small note: the whole body is already decrypted
+        body_sink(note->body.view());
+        note->body = crypto::SecureString();
+        return note;
+    }
 
-    } catch (...) {
-        exec_sql(db_, "ROLLBACK;");
-        throw;
+    if (!read_body(id, nonce, info, subkey, SIZE_MAX, body_sink)) {
+        return std::nullopt;
     }
+    return note;
 }
 
-std::optional<Note> NotesRepository::read_note(int64_t id, const crypto::SecureKey& subkey) {
-    ScopedStmt stmt(db_,
-        "SELECT id, nonce, ciphertext, created_at, updated_at FROM notes WHERE id = ?");
-    sqlite3_bind_int64(stmt.get(), 1, id);
+std::optional<Note> NotesRepository::read_note_if_inline(int64_t id,
+                                                         const crypto::SecureKey& subkey) {
+    flush_pending();
+    if (auto cached = read_cached_note(id, subkey)) {
+        return cached;  // Only inline bodies are cached
+    }
 
-    int rc = sqlite3_step(stmt.get());
-    if (rc != SQLITE_ROW) {
-        return std::nullopt;  // Not found
+    ChunkInfo info;
+    std::array<uint8_t, crypto::CryptoService::NONCE_BYTES> nonce{};
+    auto note = read_note_record(id, subkey, info, nonce);
+    if (!note.has_value() || info.body_chunks > 0) {
+        return std::nullopt;
     }
+    cache_note(*note, subkey);
+    return note;
+}
+
+// === Note Cache ===
+
+void NotesRepository::set_note_cache_budget(size_t bytes) {
+    note_cache_.set_budget(bytes);
+}
 
-    // Extract nonce
-    const void* nonce_blob = sqlite3_column_blob(stmt.get(), 1);
-    int nonce_size = sqlite3_column_bytes(stmt.get(), 1);
-    if (nonce_size != static_cast<int>(crypto::CryptoService::NONCE_BYTES) || nonce_blob == nullptr) {
+std::optional<Note> NotesRepository::read_cached_note(int64_t id,
+                                                      const crypto::SecureKey& subkey) {
+    if (!note_cache_.enabled()) {
+        return std::nullopt;
+    }
+    bind_note_cache(subkey);
+    const auto* entry = note_cache_.find(id);
+    if (entry == nullptr) {
+        return std::nullopt;
+    }
+    auto note = deserialize_note(entry->record);
+    if (!note.has_value()) {
+        note_cache_.erase(id);
         return std::nullopt;
     }
+    note->id = id;
+    note->created_at = entry->created_at;
+    note->updated_at = entry->updated_at;
+    return note;
+}
+
+bool NotesRepository::prefetch_note(int64_t id, const crypto::SecureKey& subkey) {
+    if (!note_cache_.enabled()) {
+        return false;
+    }
+    flush_pending();
+    bind_note_cache(subkey);
+    if (note_cache_.contains(id)) {
+        return true;
+    }
 
+    ChunkInfo info;
     std::array<uint8_t, crypto::CryptoService::NONCE_BYTES> nonce{};
-    std::memcpy(nonce.data(), nonce_blob, crypto::CryptoService::NONCE_BYTES);
+    auto note = read_note_record(id, subkey, info, nonce);
+    if (!note.has_value() || info.body_chunks > 0) {
+        return false;
+    }
+    cache_note(*note, subkey);
+    return true;
+}
 
-    // Extract ciphertext
-    const void* ct_blob = sqlite3_column_blob(stmt.get(), 2);
-    int ct_size = sqlite3_column_bytes(stmt.get(), 2);
-    if (ct_size <= 0 || ct_blob == nullptr) {
-        return std::nullopt;
+void NotesRepository::cache_note(const Note& note, const crypto::SecureKey& subkey) {
+    if (!note_cache_.enabled()) {
+        return;
+    }
+    bind_note_cache(subkey);
+    note_cache_.put(note.id, NoteCache::Entry{serialize_note(note), note.created_at,
+                                              note.updated_at});
+}
+
+void NotesRepository::bind_note_cache(const crypto::SecureKey& subkey) {
+    static constexpr unsigned char kLabel[] = "BXNCACHE";
+    std::array<uint8_t, 16> tag{};
+    crypto_generichash(tag.data(), tag.size(), kLabel, sizeof(kLabel) - 1,
+                       subkey.data(), subkey.size());
+    if (sodium_memcmp(tag.data(), note_cache_key_tag_.data(), tag.size()) != 0) {
+        note_cache_.clear();
+        note_cache_key_tag_ = tag;
+    }
+}
+
+std::optional<Note> NotesRepository::read_note_record(
+    int64_t id, const crypto::SecureKey& subkey, ChunkInfo& info,
+    std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& nonce)
+{
+    auto row = engine_->get(Table::kNotes, RowKey{id});
+    if (!row.has_value()) {
+        return std::nullopt;  // Not found
     }
 
-    std::vector<uint8_t> ciphertext(
-        static_cast<const uint8_t*>(ct_blob),
-        static_cast<const uint8_t*>(ct_blob) + ct_size);
+    // Extract codec and timestamps
+    int codec = static_cast<int>(row->integer(col::Notes::kCodec));
+    int64_t created_at = row->integer(col::Notes::kCreatedAt);
+    int64_t updated_at = row->integer(col::Notes::kUpdatedAt);
+
+    load_dictionaries(subkey);
+    std::optional<crypto::SecureBytes> plaintext;
+    std::optional<crypto::SecureBytes> inflated;
+    std::optional<std::span<const uint8_t>> payload;
+
+    if (!row->is_null(col::Notes::kPackId)) {
+        // Cold-storage note: the record lives in its pack (never chunked)
+        payload = read_packed_payload(id, *row, subkey);
+        if (!payload.has_value()) {
+            return std::nullopt;
+        }
+    } else {
+        // Extract nonce, ciphertext and algorithm
+        auto encrypted = read_encrypted(*row);
+        if (!encrypted.has_value()) {
+            return std::nullopt;
+        }
 
-    // Extract timestamps
-    int64_t created_at = sqlite3_column_int64(stmt.get(), 3);
-    int64_t updated_at = sqlite3_column_int64(stmt.get(), 4);
+        // Decrypt
+        auto aad = RecordAad::note(id);
+        plaintext = crypto::CryptoService::decrypt_secure(*encrypted, subkey, aad);
 
-    // Decrypt
-    auto aad = build_aad(id);
-    crypto::CryptoService::EncryptedData encrypted{std::move(ciphertext), nonce};
-    auto plaintext = crypto::CryptoService::decrypt(encrypted, subkey, aad);
+        if (!plaintext.has_value()) {
+            return std::nullopt;  // Decryption failed (tampered or wrong key)
+        }
 
-    if (!plaintext.has_value()) {
-        return std::nullopt;  // Decryption failed (tampered or wrong key)
+        // Decompress (if the record was stored compressed)
+        payload = decode_payload(codec, *plaintext, inflated);
+        if (!payload.has_value()) {
+            return std::nullopt;
+        }
+        nonce = encrypted->nonce;
     }
 
     // Deserialize
-    auto note = deserialize_note(*plaintext);
+    auto note = deserialize_note(*payload, &info);
     if (!note.has_value()) {
         return std::nullopt;  // JSON parse failed
     }
@@ -203,64 +361,136 @@ std::optional<Note> NotesRepository::read_note(int64_t id, const crypto::SecureK
     return note;
 }
 
-std::vector<NoteSummary> NotesRepository::list_notes(const crypto::SecureKey& subkey) {
-    std::vector<NoteSummary> summaries;
-
-    ScopedStmt stmt(db_,
-        "SELECT id, nonce, ciphertext, updated_at FROM notes ORDER BY updated_at DESC");
-
-    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        int64_t id = sqlite3_column_int64(stmt.get(), 0);
+void NotesRepository::scan_notes(
+    const crypto::SecureKey& subkey, const std::function<void(Note&)>& visit,
+    size_t body_limit)
+{
+    load_dictionaries(subkey);
 
-        // Extract nonce
-        const void* nonce_blob = sqlite3_column_blob(stmt.get(), 1);
-        int nonce_size = sqlite3_column_bytes(stmt.get(), 1);
-        if (nonce_size != static_cast<int>(crypto::CryptoService::NONCE_BYTES) || nonce_blob == nullptr) {
-            continue;  // Skip corrupted row
+    struct RowMeta {
+        int64_t id;
+        int64_t updated_at;
+        int codec;
+    };
+    std::vector<crypto::CryptoService::EncryptedData> records;
+    std::vector<std::vector<uint8_t>> aads;
+    std::vector<RowMeta> meta;
+    records.reserve(kScanBatchRows);
+    aads.reserve(kScanBatchRows);
+    meta.reserve(kScanBatchRows);
+
+    // Deserialize one payload and visit it
+    auto emit = [&](int64_t id, int64_t updated_at, std::span<const uint8_t> payload,
+                    const std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& nonce) {
+        // Binary records carry a body preview; when that covers
+        // `body_limit`, decode the header alone and skip the body. (The
+        // preview can stop up to 3 bytes short, at a code point boundary.)
+        std::optional<NoteRecord::View> view;
+        if (body_limit <= NoteRecord::kPreviewBytes && NoteRecord::is_binary(payload)) {
+            view = NoteRecord::decode(payload, true);
+            if (!view.has_value()) {
+                return;
+            }
+        }
+        if (view.has_value() &&
+            (view->preview.size() >= body_limit || view->preview.size() == view->body_bytes)) {
+            Note note;
+            note.title = crypto::SecureString(view->title);
+            note.body = crypto::SecureString(view->preview.substr(0, body_limit));
+            note.tags.assign(view->tags.begin(), view->tags.end());
+            note.id = id;
+            note.updated_at = updated_at;
+            visit(note);
+            return;
         }
 
-        std::array<uint8_t, crypto::CryptoService::NONCE_BYTES> nonce{};
-        std::memcpy(nonce.data(), nonce_blob, crypto::CryptoService::NONCE_BYTES);
+        ChunkInfo info;
+        auto note = deserialize_note(payload, &info);
+        if (!note.has_value()) {
+            return;
+        }
+        if (info.body_chunks > 0) {
+            // Chunked body: decrypt only as much as the caller needs
+            note->body.reserve(std::min<uint64_t>(info.body_bytes, body_limit));
+            bool ok = read_body(id, nonce, info, subkey, body_limit,
+                [&](std::string_view piece) { note->body.append(piece); });
+            if (!ok) {
+                return;
+            }
+        }
+        note->id = id;
+        note->updated_at = updated_at;
+        visit(*note);
+    };
 
-        // Extract ciphertext
-        const void* ct_blob = sqlite3_column_blob(stmt.get(), 2);
-        int ct_size = sqlite3_column_bytes(stmt.get(), 2);
-        if (ct_size <= 0 || ct_blob == nullptr) {
-            continue;  // Skip corrupted row
+    // Decrypt a batch in one call (parallel for large batches), then
+    // deserialize and visit in row order
+    auto flush = [&]() {
+        auto batch = crypto::CryptoService::decrypt_many(records, subkey, aads);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!batch.ok[i]) {
+                continue;  // Skip rows that fail to decrypt
+            }
+            std::optional<crypto::SecureBytes> inflated;
+            auto payload = decode_payload(meta[i].codec, batch.plaintext(i), inflated);
+            if (payload.has_value()) {
+                emit(meta[i].id, meta[i].updated_at, *payload, records[i].nonce);
+            }
         }
+        records.clear();
+        aads.clear();
+        meta.clear();
+    };
 
-        std::vector<uint8_t> ciphertext(
-            static_cast<const uint8_t*>(ct_blob),
-            static_cast<const uint8_t*>(ct_blob) + ct_size);
+    // Newest first (ties in ID order), straight off the updated_at index
+    engine_->scan_by(Table::kNotes, col::Notes::kUpdatedAt, [&](const RowKey& key, const Row& row) {
+        int64_t id = key.a;
+        int64_t updated_at = row.integer(col::Notes::kUpdatedAt);
+
+        if (!row.is_null(col::Notes::kPackId)) {
+            // Packed note: visit after the rows before it, to keep row order.
+            // Packed notes are the oldest, so they mostly sit at the end.
+            flush();
+            auto payload = read_packed_payload(id, row, subkey);
+            if (payload.has_value()) {
+                emit(id, updated_at, *payload, {});
+            }
+            return true;
+        }
 
-        int64_t updated_at = sqlite3_column_int64(stmt.get(), 3);
+        // Extract nonce, ciphertext and algorithm
+        auto encrypted = read_encrypted(row);
+        if (!encrypted.has_value()) {
+            return true;  // Skip corrupted row
+        }
 
-        // Decrypt
-        auto aad = build_aad(id);
-        crypto::CryptoService::EncryptedData encrypted{std::move(ciphertext), nonce};
-        auto plaintext = crypto::CryptoService::decrypt(encrypted, subkey, aad);
+        records.push_back(std::move(*encrypted));
+        aads.push_back(RecordAad::note(id));
+        meta.push_back(RowMeta{id, updated_at, static_cast<int>(row.integer(col::Notes::kCodec))});
 
-        if (!plaintext.has_value()) {
-            continue;  // Skip rows that fail to decrypt
+        if (records.size() == kScanBatchRows) {
+            flush();
         }
+        return true;
+    }, {}, ScanOrder::kDescending);
+    flush();
+}
 
-        // Deserialize and extract title only
-        auto note = deserialize_note(*plaintext);
-        if (!note.has_value()) {
-            continue;
-        }
+std::vector<NoteSummary> NotesRepository::list_notes(const crypto::SecureKey& subkey) {
+    flush_pending();
+    std::vector<NoteSummary> summaries;
+
+    // Only the preview is needed from each body
+    constexpr size_t kPreviewBytes = 80;
 
+    scan_notes(subkey, [&](Note& note) {
         // Extract preview (first ~80 chars of body)
-        std::string preview;
-        if (!note->body.empty()) {
-            preview = note->body.substr(0, 80);
-            if (note->body.size() > 80) preview += "...";
-        }
+        std::string preview = make_preview(note.body.view(), 0, kPreviewBytes);
 
         summaries.push_back(NoteSummary{
-            id, std::move(note->title), std::move(preview),
-            std::move(note->tags), updated_at});
-    }
+            note.id, note.title.str(), std::move(preview),
+            std::move(note.tags), note.updated_at});
+    }, kPreviewBytes + 1);
 
     return summaries;
 }
@@ -268,53 +498,24 @@ std::vector<NoteSummary> NotesRepository::list_notes(const crypto::SecureKey& su
 std::vector<NoteSummary> NotesRepository::search_notes(
     const crypto::SecureKey& subkey, const std::string& query)
 {
+    flush_pending();
     if (query.size() < 2) return {};
 
-    // Build lowercase query for case-insensitive matching
-    auto to_lower = [](const std::string& s) {
-        std::string r;
+    // Build lowercase copies for case-insensitive matching (kept in locked
+    // memory, since they are copies of decrypted note content)
+    auto to_lower = [](std::string_view s) {
+        crypto::SecureString r;
         r.reserve(s.size());
         for (char c : s) r += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
         return r;
     };
 
-    std::string lower_query = to_lower(query);
+    crypto::SecureString lower_query = to_lower(query);
     std::vector<NoteSummary> results;
 
-    ScopedStmt stmt(db_,
-        "SELECT id, nonce, ciphertext, updated_at FROM notes ORDER BY updated_at DESC");
-
-    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        int64_t id = sqlite3_column_int64(stmt.get(), 0);
-
-        const void* nonce_blob = sqlite3_column_blob(stmt.get(), 1);
-        int nonce_size = sqlite3_column_bytes(stmt.get(), 1);
-        if (nonce_size != static_cast<int>(crypto::CryptoService::NONCE_BYTES) || !nonce_blob)
-            continue;
-
-        std::array<uint8_t, crypto::CryptoService::NONCE_BYTES> nonce{};
-        std::memcpy(nonce.data(), nonce_blob, crypto::CryptoService::NONCE_BYTES);
-
-        const void* ct_blob = sqlite3_column_blob(stmt.get(), 2);
-        int ct_size = sqlite3_column_bytes(stmt.get(), 2);
-        if (ct_size <= 0 || !ct_blob) continue;
-
-        std::vector<uint8_t> ciphertext(
-            static_cast<const uint8_t*>(ct_blob),
-            static_cast<const uint8_t*>(ct_blob) + ct_size);
-
-        int64_t updated_at = sqlite3_column_int64(stmt.get(), 3);
-
-        auto aad = build_aad(id);
-        crypto::CryptoService::EncryptedData encrypted{std::move(ciphertext), nonce};
-        auto plaintext = crypto::CryptoService::decrypt(encrypted, subkey, aad);
-        if (!plaintext.has_value()) continue;
-
-        auto note = deserialize_note(*plaintext);
-        if (!note.has_value()) continue;
-
-        std::string lower_title = to_lower(note->title);
-        std::string lower_body = to_lower(note->body);
+    scan_notes(subkey, [&](Note& note) {
+        crypto::SecureString lower_title = to_lower(note.title.view());
+        crypto::SecureString lower_body = to_lower(note.body.view());
 
         bool matched = false;
         std::string preview;
@@ -322,8 +523,7 @@ std::vector<NoteSummary> NotesRepository::search_notes(
         // Check title
         if (lower_title.find(lower_query) != std::string::npos) {
             matched = true;
-            preview = note->body.substr(0, 80);
-            if (note->body.size() > 80) preview += "...";
+            preview = make_preview(note.body.view(), 0, 80);
         }
 
         // Check body — extract context snippet around first match
@@ -332,20 +532,16 @@ std::vector<NoteSummary> NotesRepository::search_notes(
             if (pos != std::string::npos) {
                 matched = true;
                 size_t start = (pos > 30) ? pos - 30 : 0;
-                size_t end = std::min(note->body.size(), start + 80);
-                preview = note->body.substr(start, end - start);
-                if (start > 0) preview = "..." + preview;
-                if (end < note->body.size()) preview += "...";
+                preview = make_preview(note.body.view(), start, 80);
             }
         }
 
         // Check tags
         if (!matched) {
-            for (const auto& tag : note->tags) {
+            for (const auto& tag : note.tags) {
                 if (to_lower(tag).find(lower_query) != std::string::npos) {
                     matched = true;
-                    preview = note->body.substr(0, 80);
-                    if (note->body.size() > 80) preview += "...";
+                    preview = make_preview(note.body.view(), 0, 80);
                     break;
                 }
             }
@@ -353,95 +549,1543 @@ std::vector<NoteSummary> NotesRepository::search_notes(
 
         if (matched) {
             results.push_back(NoteSummary{
-                id, std::move(note->title), std::move(preview),
-                std::move(note->tags), updated_at});
+                note.id, note.title.str(), std::move(preview),
+                std::move(note.tags), note.updated_at});
         }
-    }
+    });
 
     return results;
 }
 
 bool NotesRepository::update_note(const Note& note, const crypto::SecureKey& subkey) {
-    // Verify note exists
-    {
-        ScopedStmt check(db_, "SELECT id FROM notes WHERE id = ?");
-        sqlite3_bind_int64(check.get(), 1, note.id);
-        if (sqlite3_step(check.get()) != SQLITE_ROW) {
+    flush_pending();
+    engine_->begin();
+
+    try {
+        // Verify note exists
+        if (!engine_->get(Table::kNotes, RowKey{note.id}, Projection::none()).has_value()) {
+            engine_->rollback();
             return false;  // Note not found
         }
+
+        // Keep the version being replaced, then serialize and encrypt with
+        // fresh nonce
+        save_note(note, subkey, current_timestamp());
+
+        engine_->commit();
+        return true;
+
+    } catch (...) {
+        engine_->rollback();
+        throw;
     }
+}
 
-    int64_t now = current_timestamp();
+bool NotesRepository::delete_note(int64_t id, const crypto::SecureKey& subkey) {
+    flush_pending();
+    engine_->begin();
+
+    try {
+        auto row = engine_->get(Table::kNotes, RowKey{id},
+                                {col::Notes::kPackId, col::Notes::kChangeSeq});
+        std::optional<int64_t> pack_id;
+        if (row.has_value() && !row->is_null(col::Notes::kPackId)) {
+            pack_id = row->integer(col::Notes::kPackId);
+        }
+
+        // Attachments only this note links to go with it (see AttachmentStore)
+        std::vector<int64_t> linked;
+        engine_->scan(Table::kAttachmentRefs, KeyRange::prefix(id),
+            [&](const RowKey& key, const Row&) {
+                linked.push_back(key.b);
+                return true;
+            }, Projection::none());
+        for (int64_t attachment_id : linked) {
+            // Shared if any other note links it (attachment_id is indexed)
+            bool shared = false;
+            engine_->scan_subkey(Table::kAttachmentRefs, attachment_id,
+                [&](const RowKey& key, const Row&) {
+                    shared = key.a != id;
+                    return !shared;
+                }, Projection::none());
+            if (!shared) {
+                engine_->erase_range(Table::kAttachmentChunks, KeyRange::prefix(attachment_id));
+                engine_->erase(Table::kAttachments, RowKey{attachment_id});
+            }
+            engine_->erase(Table::kAttachmentRefs, RowKey{id, attachment_id});
+        }
+
+        note_cache_.erase(id);
+        for (Table table : {Table::kNoteChunks, Table::kContentChunks, Table::kNoteRevisions}) {
+            engine_->erase_range(table, KeyRange::prefix(id));
+        }
 
-    // Serialize and encrypt with fresh nonce
-    auto plaintext = serialize_note(note);
-    auto aad = build_aad(note.id);
-    auto encrypted = crypto::CryptoService::encrypt(plaintext, subkey, aad);
+        bool deleted = engine_->erase(Table::kNotes, RowKey{id});
+        if (pack_id.has_value()) {
+            rewrite_pack(*pack_id, subkey);
+        }
+        if (deleted) {
+            std::optional<int64_t> previous_change;
+            if (!row->is_null(col::Notes::kChangeSeq)) {
+                previous_change = row->integer(col::Notes::kChangeSeq);
+            }
+            record_change(id, previous_change, true);
+        }
 
-    // Update in DB
-    ScopedStmt stmt(db_,
-        "UPDATE notes SET nonce = ?, ciphertext = ?, updated_at = ? WHERE id = ?");
-    sqlite3_bind_blob(stmt.get(), 1, encrypted.nonce.data(),
-                      static_cast<int>(encrypted.nonce.size()), SQLITE_STATIC);
-    sqlite3_bind_blob(stmt.get(), 2, encrypted.ciphertext.data(),
-                      static_cast<int>(encrypted.ciphertext.size()), SQLITE_STATIC);
-    sqlite3_bind_int64(stmt.get(), 3, now);
-    sqlite3_bind_int64(stmt.get(), 4, note.id);
+        engine_->commit();
+        return deleted;
 
-    int rc = sqlite3_step(stmt.get());
-    if (rc != SQLITE_DONE) {
-        throw std::runtime_error(
-            "Failed to update note: " + std::string(sqlite3_errmsg(db_)));
+    } catch (...) {
+        engine_->rollback();
+        throw;
     }
+}
 
-    return true;
+// === Write-Behind Saves ===
+
+void NotesRepository::queue_update(const Note& note, const crypto::SecureKey& subkey) {
+    int64_t now = current_timestamp();
+    crypto::SecureKey key(subkey.size());
+    std::memcpy(key.data(), subkey.data(), subkey.size());
+    for (auto& pending : pending_) {
+        if (pending.note.id == note.id) {
+            pending.note = note;
+            pending.subkey = std::move(key);
+            pending.saved_at = now;
+            return;
+        }
+    }
+    pending_.push_back(PendingWrite{note, std::move(key), now});
 }
 
-bool NotesRepository::delete_note(int64_t id) {
-    ScopedStmt stmt(db_, "DELETE FROM notes WHERE id = ?");
-    sqlite3_bind_int64(stmt.get(), 1, id);
+size_t NotesRepository::flush_writes() {
+    if (pending_.empty()) {
+        return 0;
+    }
+
+    // Taken off the queue first: the writes below go through operations
+    // that would otherwise flush again
+    std::vector<PendingWrite> batch;
+    batch.swap(pending_);
 
-    int rc = sqlite3_step(stmt.get());
-    if (rc != SQLITE_DONE) {
-        throw std::runtime_error(
-            "Failed to delete note: " + std::string(sqlite3_errmsg(db_)));
+    size_t written = 0;
+    engine_->begin();
+    try {
+        for (const auto& pending : batch) {
+            const Note& note = pending.note;
+            if (!engine_->get(Table::kNotes, RowKey{note.id}, Projection::none()).has_value()) {
+                continue;  // Deleted since it was queued
+            }
+            save_note(note, pending.subkey, pending.saved_at);
+            ++written;
+        }
+        engine_->commit();
+    } catch (...) {
+        engine_->rollback();
+        batch.swap(pending_);  // Still queued for the next flush
+        throw;
     }
+    return written;
+}
 
-    return sqlite3_changes(db_) > 0;
+// === Change Log ===
+
+std::vector<NoteChange> NotesRepository::changes_since(int64_t since) {
+    flush_pending();
+    std::vector<NoteChange> changes;
+    KeyRange range;
+    range.first = RowKey{since + 1, 0};
+    engine_->scan(Table::kNoteChanges, range, [&](const RowKey& key, const Row& row) {
+        changes.push_back(NoteChange{key.a, row.integer(col::NoteChanges::kNoteId),
+                                     row.integer(col::NoteChanges::kDeleted) != 0});
+        return true;
+    });
+    return changes;
 }
 
-// === Serialization Helpers ===
+int64_t NotesRepository::last_change_seq() {
+    flush_pending();
+    int64_t last = 0;
+    engine_->scan(Table::kNoteChanges, KeyRange::all(), [&](const RowKey& key, const Row&) {
+        last = key.a;
+        return false;
+    }, Projection::none(), ScanOrder::kDescending);
+    return last;
+}
 
-std::vector<uint8_t> NotesRepository::serialize_note(const Note& note) {
-    json j;
-    j["title"] = note.title;
-    j["body"] = note.body;
-    j["tags"] = note.tags;
-    j["version"] = 1;
+int64_t NotesRepository::record_change(int64_t note_id, std::optional<int64_t> previous,
+                                       bool deleted)
+{
+    if (previous.has_value()) {
+        engine_->erase(Table::kNoteChanges, RowKey{*previous});
+    }
+    Row change(Table::kNoteChanges);
+    change.set(col::NoteChanges::kNoteId, note_id);
+    change.set(col::NoteChanges::kDeleted, int64_t{deleted ? 1 : 0});
+    return engine_->insert(Table::kNoteChanges, change);
+}
 
-    std::string json_str = j.dump();
-    return std::vector<uint8_t>(json_str.begin(), json_str.end());
+// === Revision History ===
+
+std::vector<NoteRevision> NotesRepository::list_revisions(int64_t note_id) {
+    flush_pending();
+    std::vector<NoteRevision> revisions;
+    engine_->scan(Table::kNoteRevisions, KeyRange::prefix(note_id),
+        [&](const RowKey& key, const Row& row) {
+            NoteRevision revision;
+            revision.revision_id = key.b;
+            revision.saved_at = row.integer(col::NoteRevisions::kSavedAt);
+            revision.keyframe = row.integer(col::NoteRevisions::kKeyframe) != 0;
+            revision.stored_bytes = row.blob(col::NoteRevisions::kCiphertext).size();
+            revisions.push_back(revision);
+            return true;
+        },
+        {col::NoteRevisions::kSavedAt, col::NoteRevisions::kKeyframe,
+         col::NoteRevisions::kCiphertext},
+        ScanOrder::kDescending);
+    return revisions;
 }
 
-std::optional<Note> NotesRepository::deserialize_note(const std::vector<uint8_t>& json_bytes) {
-    std::string json_str(json_bytes.begin(), json_bytes.end());
-    auto j = json::parse(json_str, nullptr, false);
-    if (j.is_discarded()) {
+std::optional<Note> NotesRepository::read_revision(int64_t note_id, int64_t revision_id,
+                                                   const crypto::SecureKey& subkey)
+{
+    flush_pending();
+    // The revision and the newer ones up to the nearest keyframe. Revisions
+    // are contiguous: pruning only ever removes the oldest.
+    std::vector<int64_t> chain;
+    bool from_keyframe = false;
+    bool contiguous = true;
+    int64_t saved_at = 0;
+    int64_t newest_id = 0;
+    engine_->scan(Table::kNoteRevisions,
+        KeyRange{{note_id, revision_id}, {note_id, std::numeric_limits<int64_t>::max()}},
+        [&](const RowKey& key, const Row& row) {
+            if (key.b != revision_id + static_cast<int64_t>(chain.size())) {
+                contiguous = false;
+                return false;
+            }
+            if (chain.empty()) {
+                saved_at = row.integer(col::NoteRevisions::kSavedAt);
+            }
+            chain.push_back(key.b);
+            if (row.integer(col::NoteRevisions::kKeyframe) != 0) {
+                from_keyframe = true;
+                return false;
+            }
+            return chain.size() < static_cast<size_t>(kRevisionKeyframeInterval);
+        },
+        {col::NoteRevisions::kKeyframe, col::NoteRevisions::kSavedAt});
+    if (!contiguous) {
+        return std::nullopt;
+    }
+    if (chain.empty()) {
         return std::nullopt;
     }
+    engine_->scan(Table::kNoteRevisions, KeyRange::prefix(note_id),
+        [&](const RowKey& key, const Row&) {
+            newest_id = key.b;
+            return false;
+        }, Projection::none(), ScanOrder::kDescending);
+
+    std::optional<crypto::SecureBytes> record;
+    int64_t created_at = 0;
+    if (from_keyframe) {
+        record = read_revision_data(note_id, chain.back(), subkey);
+        chain.pop_back();
+        auto row = engine_->get(Table::kNotes, RowKey{note_id}, {col::Notes::kCreatedAt});
+        if (row.has_value()) {
+            created_at = row->integer(col::Notes::kCreatedAt);
+        }
+    } else {
+        // No keyframe above: the newest revision is a delta against the
+        // current version
+        if (chain.back() != newest_id) {
+            return std::nullopt;
+        }
+        int64_t updated_at = 0;
+        record = read_version_record(note_id, subkey, updated_at);
+        auto row = engine_->get(Table::kNotes, RowKey{note_id}, {col::Notes::kCreatedAt});
+        if (row.has_value()) {
+            created_at = row->integer(col::Notes::kCreatedAt);
+        }
+    }
 
-    Note note;
-    note.title = j.value("title", "");
-    note.body = j.value("body", "");
-    note.tags = j.value("tags", std::vector<std::string>{});
+    for (auto it = chain.rbegin(); it != chain.rend() && record.has_value(); ++it) {
+        auto delta = read_revision_data(note_id, *it, subkey);
+        if (!delta.has_value()) {
+            return std::nullopt;
+        }
+        record = NoteDelta::apply(*record, *delta);
+    }
+    if (!record.has_value()) {
+        return std::nullopt;
+    }
+
+    ChunkInfo info;
+    auto note = deserialize_note(*record, &info);
+    if (!note.has_value()) {
+        return std::nullopt;
+    }
+    if (info.body_chunks > 0) {
+        // Kept by manifest: the chunk rows stay while this revision does
+        note->body = crypto::SecureString();
+        note->body.reserve(info.body_bytes);
+        if (info.manifest.empty() ||
+            !read_content_chunks(note_id, info, subkey, SIZE_MAX,
+                [&](std::string_view piece) { note->body.append(piece); })) {
+            return std::nullopt;
+        }
+    }
+    note->id = note_id;
+    note->created_at = created_at;
+    note->updated_at = saved_at;
     return note;
 }
 
-std::vector<uint8_t> NotesRepository::build_aad(int64_t note_id) {
-    std::vector<uint8_t> aad(4);
-    uint32_t id32 = static_cast<uint32_t>(note_id);
-    std::memcpy(aad.data(), &id32, 4);  // Little-endian on x64
-    return aad;
+bool NotesRepository::restore_revision(int64_t note_id, int64_t revision_id,
+                                       const crypto::SecureKey& subkey)
+{
+    auto note = read_revision(note_id, revision_id, subkey);
+    if (!note.has_value()) {
+        return false;
+    }
+    return update_note(*note, subkey);
+}
+
+void NotesRepository::set_revision_policy(const RevisionPolicy& policy) {
+    revision_policy_ = policy;
+}
+
+size_t NotesRepository::prune_revisions() {
+    flush_pending();
+    return prune_revisions(std::nullopt);
+}
+
+size_t NotesRepository::prune_revisions(std::optional<int64_t> note_id) {
+    // Everything up to the newest revision that is too old or too far back
+    // goes, so what remains is still contiguous
+    int64_t cutoff = current_timestamp() - revision_policy_.max_age.count();
+    struct History {
+        int64_t newest = 0;
+        int64_t newest_expired = std::numeric_limits<int64_t>::min();
+    };
+    std::map<int64_t, History> notes;
+    engine_->scan(Table::kNoteRevisions,
+        note_id.has_value() ? KeyRange::prefix(*note_id) : KeyRange::all(),
+        [&](const RowKey& key, const Row& row) {
+            History& history = notes[key.a];
+            history.newest = key.b;  // Ascending, so the last one seen
+            if (row.integer(col::NoteRevisions::kSavedAt) < cutoff) {
+                history.newest_expired = key.b;
+            }
+            return true;
+        }, {col::NoteRevisions::kSavedAt});
+
+    size_t pruned = 0;
+    for (const auto& [id, history] : notes) {
+        int64_t drop_through = std::max(
+            history.newest_expired,
+            history.newest - static_cast<int64_t>(revision_policy_.max_revisions));
+        size_t dropped = engine_->erase_range(Table::kNoteRevisions,
+            KeyRange{{id, std::numeric_limits<int64_t>::min()}, {id, drop_through}});
+        if (dropped == 0) {
+            continue;
+        }
+        pruned += dropped;
+
+        // Chunk rows whose newest referencing revision is gone
+        std::vector<int64_t> unused;
+        engine_->scan(Table::kContentChunks, KeyRange::prefix(id),
+            [&](const RowKey& key, const Row& row) {
+                if (!row.is_null(col::ContentChunks::kReleasedBy) &&
+                    row.integer(col::ContentChunks::kReleasedBy) <= drop_through) {
+                    unused.push_back(key.b);
+                }
+                return true;
+            }, {col::ContentChunks::kReleasedBy});
+        release_chunks(id, unused, std::nullopt);
+    }
+    return pruned;
+}
+
+NotesRepository::RevisionPlan NotesRepository::plan_revision(
+    int64_t note_id, const crypto::SecureKey& subkey)
+{
+    RevisionPlan plan;
+    plan.record = revision_policy_.enabled;
+    if (!plan.record) {
+        return plan;
+    }
+
+    engine_->scan(Table::kNoteRevisions, KeyRange::prefix(note_id),
+        [&](const RowKey& key, const Row& row) {
+            plan.newest = RevisionMeta{key.b,
+                                       row.integer(col::NoteRevisions::kKeyframe) != 0,
+                                       row.integer(col::NoteRevisions::kSavedAt),
+                                       row.integer(col::NoteRevisions::kRecordedAt)};
+            return false;
+        },
+        {col::NoteRevisions::kKeyframe, col::NoteRevisions::kSavedAt,
+         col::NoteRevisions::kRecordedAt},
+        ScanOrder::kDescending);
+
+    plan.coalesce = plan.newest.has_value() &&
+                    current_timestamp() - plan.newest->recorded_at < kRevisionCoalesceSeconds;
+    if (plan.coalesce && plan.newest->keyframe) {
+        return plan;  // The replaced version will not be kept
+    }
+    plan.previous = read_version_record(note_id, subkey, plan.previous_saved_at);
+    return plan;
+}
+
+void NotesRepository::record_revision(int64_t note_id, RevisionPlan& plan,
+                                      const crypto::SecureBytes& next_record,
+                                      const std::vector<int64_t>& released,
+                                      const crypto::SecureKey& subkey)
+{
+    // Released chunks that `version` (kept as `revision_id`) references
+    // stay with it; the rest go
+    auto keep_with = [&](int64_t revision_id, std::span<const uint8_t> version) {
+        std::set<int64_t> referenced;
+        ChunkInfo info;
+        if (!version.empty() && deserialize_note(version, &info).has_value()) {
+            for (const auto& chunk : info.manifest) {
+                referenced.insert(static_cast<int64_t>(chunk.chunk_id));
+            }
+        }
+        std::vector<int64_t> held;
+        std::vector<int64_t> unused;
+        for (int64_t chunk_id : released) {
+            (referenced.count(chunk_id) > 0 ? held : unused).push_back(chunk_id);
+        }
+        release_chunks(note_id, held, revision_id);
+        release_chunks(note_id, unused, std::nullopt);
+    };
+
+    if (!plan.record) {
+        release_chunks(note_id, released, std::nullopt);
+        return;
+    }
+
+    int64_t now = current_timestamp();
+    if (plan.coalesce && plan.newest->keyframe) {
+        // Autosave burst: the version being replaced is not kept, and a
+        // keyframe stands alone
+        std::optional<crypto::SecureBytes> keyframe;
+        if (!released.empty()) {
+            keyframe = read_revision_data(note_id, plan.newest->revision_id, subkey);
+        }
+        keep_with(plan.newest->revision_id,
+                  keyframe.has_value() ? std::span<const uint8_t>(*keyframe)
+                                       : std::span<const uint8_t>());
+        return;
+    }
+
+    if (!plan.previous.has_value()) {
+        release_chunks(note_id, released, std::nullopt);
+        return;  // An unreadable version cannot be kept; the save goes ahead
+    }
+    crypto::SecureBytes& old_record = *plan.previous;
+    if (old_record == next_record) {
+        return;  // Timestamp-only save (same manifest, so nothing released)
+    }
+
+    if (plan.coalesce) {
+        // Autosave burst: a delta is rebased onto the new version
+        auto delta = read_revision_data(note_id, plan.newest->revision_id, subkey);
+        auto version = delta.has_value() ? NoteDelta::apply(old_record, *delta) : std::nullopt;
+        if (version.has_value()) {
+            keep_with(plan.newest->revision_id, *version);
+            auto rebased = NoteDelta::encode(next_record, *version);
+            bool keyframe = rebased.size() >= version->size();
+            write_revision(note_id, plan.newest->revision_id, keyframe,
+                           keyframe ? std::move(*version) : std::move(rebased),
+                           plan.newest->saved_at, plan.newest->recorded_at, subkey);
+            return;
+        }
+        // Unreadable newest revision: keep the replaced version on its own
+    }
+
+    int64_t revision_id = plan.newest.has_value() ? plan.newest->revision_id + 1 : 1;
+    bool keyframe = (revision_id - 1) % kRevisionKeyframeInterval == 0;
+    crypto::SecureBytes data;
+    if (!keyframe) {
+        data = NoteDelta::encode(next_record, old_record);
+        keyframe = data.size() >= old_record.size();
+    }
+    if (keyframe) {
+        data = std::move(old_record);
+    }
+    write_revision(note_id, revision_id, keyframe, std::move(data),
+                   plan.previous_saved_at, now, subkey);
+    release_chunks(note_id, released, revision_id);
+    prune_revisions(note_id);
+}
+
+std::optional<crypto::SecureBytes> NotesRepository::read_version_record(
+    int64_t note_id, const crypto::SecureKey& subkey, int64_t& updated_at)
+{
+    auto row = engine_->get(Table::kNotes, RowKey{note_id});
+    if (!row.has_value()) {
+        return std::nullopt;
+    }
+    updated_at = row->integer(col::Notes::kUpdatedAt);
+    load_dictionaries(subkey);
+    auto record = read_stored_record(note_id, *row, subkey);
+    if (!record.has_value()) {
+        return std::nullopt;
+    }
+
+    // Version-2 records as stored: a chunked body is just its manifest
+    if (NoteRecord::is_binary(*record)) {
+        auto view = NoteRecord::decode(*record);
+        if (!view.has_value()) {
+            return std::nullopt;
+        }
+        if (view->body_chunks == 0 || !view->chunks.empty()) {
+            return record;
+        }
+    }
+
+    // JSON records and legacy body streams (bound to the record nonce, so
+    // not kept as is): the whole note, inline
+    auto note = read_note(note_id, subkey);
+    if (!note.has_value()) {
+        return std::nullopt;
+    }
+    return serialize_note(*note);
+}
+
+void NotesRepository::release_chunks(int64_t note_id, const std::vector<int64_t>& chunk_ids,
+                                     std::optional<int64_t> holder)
+{
+    for (int64_t chunk_id : chunk_ids) {
+        if (!holder.has_value()) {
+            engine_->erase(Table::kContentChunks, RowKey{note_id, chunk_id});
+            continue;
+        }
+        auto row = engine_->get(Table::kContentChunks, RowKey{note_id, chunk_id});
+        if (row.has_value()) {
+            row->set(col::ContentChunks::kReleasedBy, *holder);
+            engine_->put(Table::kContentChunks, RowKey{note_id, chunk_id}, *row);
+        }
+    }
+}
+
+std::optional<crypto::SecureBytes> NotesRepository::read_revision_data(
+    int64_t note_id, int64_t revision_id, const crypto::SecureKey& subkey)
+{
+    auto row = engine_->get(Table::kNoteRevisions, RowKey{note_id, revision_id});
+    if (!row.has_value()) {
+        return std::nullopt;
+    }
+    auto encrypted = read_encrypted(*row);
+    if (!encrypted.has_value()) {
+        return std::nullopt;
+    }
+    auto plaintext = crypto::CryptoService::decrypt_secure(
+        *encrypted, subkey, RecordAad::revision(note_id, revision_id));
+    if (!plaintext.has_value()) {
+        return std::nullopt;
+    }
+
+    load_dictionaries(subkey);
+    std::optional<crypto::SecureBytes> inflated;
+    auto data = decode_payload(static_cast<int>(row->integer(col::NoteRevisions::kCodec)),
+                               *plaintext, inflated);
+    if (!data.has_value()) {
+        return std::nullopt;
+    }
+    if (inflated.has_value()) {
+        return std::move(*inflated);
+    }
+    return std::move(*plaintext);
+}
+
+void NotesRepository::write_revision(int64_t note_id, int64_t revision_id, bool keyframe,
+                                     crypto::SecureBytes data, int64_t saved_at,
+                                     int64_t recorded_at, const crypto::SecureKey& subkey)
+{
+    load_dictionaries(subkey);
+    Codec codec = encode_payload(data);
+    auto encrypted = crypto::CryptoService::encrypt(
+        data, subkey, RecordAad::revision(note_id, revision_id),
+        crypto::CryptoService::preferred_algorithm());
+
+    Row row(Table::kNoteRevisions);
+    set_encrypted(row, encrypted);
+    row.set(col::NoteRevisions::kCodec, static_cast<int64_t>(codec));
+    row.set(col::NoteRevisions::kKeyframe, int64_t{keyframe ? 1 : 0});
+    row.set(col::NoteRevisions::kSavedAt, saved_at);
+    row.set(col::NoteRevisions::kRecordedAt, recorded_at);
+    engine_->put(Table::kNoteRevisions, RowKey{note_id, revision_id}, row);
+}
+
+// === Compression ===
+
+bool NotesRepository::ensure_compression_dictionary(const crypto::SecureKey& subkey) {
+    if (engine_->usage(Table::kCompressionDicts, col::CompressionDicts::kCiphertext).rows > 0) {
+        return false;  // Already trained
+    }
+    if (storage_stats().note_count < kDictionaryMinNotes) {
+        return false;
+    }
+    return train_compression_dictionary(subkey);
+}
+
+bool NotesRepository::train_compression_dictionary(const crypto::SecureKey& subkey) {
+    flush_pending();
+    load_dictionaries(subkey);
+
+    // Sample the serialized (uncompressed) payloads of the newest notes
+    std::vector<crypto::SecureBytes> samples;
+    size_t sampled = 0;
+    engine_->scan_by(Table::kNotes, col::Notes::kUpdatedAt, [&](const RowKey& key, const Row& row) {
+        if (!row.is_null(col::Notes::kPackId)) {
+            return true;  // Packed notes are cold; they would not use it
+        }
+        ++sampled;
+        auto encrypted = read_encrypted(row);
+        if (encrypted.has_value()) {
+            auto plaintext = crypto::CryptoService::decrypt_secure(*encrypted, subkey, RecordAad::note(key.a));
+            if (plaintext.has_value()) {
+                std::optional<crypto::SecureBytes> inflated;
+                auto payload = decode_payload(static_cast<int>(row.integer(col::Notes::kCodec)),
+                                              *plaintext, inflated);
+                if (payload.has_value()) {
+                    samples.emplace_back(payload->begin(), payload->end());
+                }
+            }
+        }
+        return sampled < kDictionaryMaxSamples;
+    }, {}, ScanOrder::kDescending);
+    if (samples.size() < kDictionaryMinNotes) {
+        return false;
+    }
+
+    crypto::SecureBytes dictionary;
+    try {
+        dictionary = NoteCompressor::train_dictionary(samples);
+    } catch (const std::runtime_error&) {
+        return false;  // Samples too uniform or too small to train on
+    }
+    samples.clear();
+
+    uint32_t dict_id = NoteCompressor::dictionary_id(dictionary);
+    auto encrypted = crypto::CryptoService::encrypt(
+        dictionary, subkey, RecordAad::dictionary(dict_id),
+        crypto::CryptoService::preferred_algorithm());
+
+    engine_->begin();
+    try {
+        Row row(Table::kCompressionDicts);
+        set_encrypted(row, encrypted);
+        row.set(col::CompressionDicts::kCreatedAt, current_timestamp());
+        engine_->put(Table::kCompressionDicts, RowKey{static_cast<int64_t>(dict_id)}, row);
+
+        compressor_.add_dictionary(dictionary);
+        recompress_notes(subkey);
+
+        engine_->commit();
+    } catch (...) {
+        engine_->rollback();
+        // The in-memory dictionary set no longer matches the database
+        compressor_.clear_dictionaries();
+        dictionaries_loaded_ = false;
+        throw;
+    }
+    return true;
+}
+
+void NotesRepository::set_compression_enabled(bool enabled) {
+    compression_enabled_ = enabled;
+}
+
+NotesRepository::StorageStats NotesRepository::storage_stats() {
+    flush_pending();
+    StorageStats stats;
+    auto notes = engine_->usage(Table::kNotes, col::Notes::kCiphertext);
+    stats.note_count = notes.rows;
+    stats.record_bytes = notes.bytes;
+    stats.chunk_bytes =
+        engine_->usage(Table::kNoteChunks, col::NoteChunks::kData).bytes +
+        engine_->usage(Table::kContentChunks, col::ContentChunks::kCiphertext).bytes;
+
+    engine_->scan(Table::kNotes, KeyRange::all(), [&](const RowKey&, const Row& row) {
+        stats.packed_note_count += row.is_null(col::Notes::kPackId) ? 0 : 1;
+        return true;
+    }, {col::Notes::kPackId});
+    auto packs = engine_->usage(Table::kNotePacks, col::NotePacks::kCiphertext);
+    stats.pack_count = packs.rows;
+    stats.pack_bytes = packs.bytes;
+
+    auto revisions = engine_->usage(Table::kNoteRevisions, col::NoteRevisions::kCiphertext);
+    stats.revision_count = revisions.rows;
+    stats.revision_bytes = revisions.bytes;
+    return stats;
+}
+
+void NotesRepository::load_dictionaries(const crypto::SecureKey& subkey) {
+    if (dictionaries_loaded_) {
+        return;
+    }
+
+    // Oldest first, so the newest dictionary ends up active
+    std::vector<std::pair<int64_t, int64_t>> order;  // (created_at, dict_id)
+    engine_->scan(Table::kCompressionDicts, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+        order.emplace_back(row.integer(col::CompressionDicts::kCreatedAt), key.a);
+        return true;
+    }, {col::CompressionDicts::kCreatedAt});
+    std::sort(order.begin(), order.end());
+
+    for (const auto& [created_at, id] : order) {
+        auto row = engine_->get(Table::kCompressionDicts, RowKey{id});
+        if (!row.has_value()) {
+            continue;
+        }
+        auto dict_id = static_cast<uint32_t>(id);
+        auto encrypted = read_encrypted(*row);
+        if (!encrypted.has_value()) {
+            continue;
+        }
+        auto dictionary = crypto::CryptoService::decrypt_secure(
+            *encrypted, subkey, RecordAad::dictionary(dict_id));
+        if (!dictionary.has_value() || NoteCompressor::dictionary_id(*dictionary) != dict_id) {
+            continue;  // Records using it fail to decode, like any tampered row
+        }
+        compressor_.add_dictionary(*dictionary);
+    }
+    dictionaries_loaded_ = true;
+}
+
+Codec NotesRepository::encode_payload(crypto::SecureBytes& payload) {
+    if (!compression_enabled_) {
+        return Codec::kNone;
+    }
+    auto frame = compressor_.compress(payload);
+    if (!frame.has_value()) {
+        return Codec::kNone;
+    }
+    payload = std::move(*frame);
+    return Codec::kZstd;
+}
+
+std::optional<std::span<const uint8_t>> NotesRepository::decode_payload(
+    int codec, std::span<const uint8_t> stored,
+    std::optional<crypto::SecureBytes>& inflated)
+{
+    switch (static_cast<Codec>(codec)) {
+        case Codec::kNone:
+            return stored;
+        case Codec::kZstd:
+            inflated = compressor_.decompress(stored);
+            if (!inflated.has_value()) {
+                return std::nullopt;
+            }
+            return std::span<const uint8_t>(*inflated);
+    }
+    return std::nullopt;  // Unknown codec
+}
+
+std::set<int64_t> NotesRepository::notes_with_rows_in(Table table) {
+    std::set<int64_t> ids;
+    engine_->scan(table, KeyRange::all(), [&](const RowKey& key, const Row&) {
+        ids.insert(key.a);
+        return true;
+    }, Projection::none());
+    return ids;
+}
+
+void NotesRepository::recompress_notes(const crypto::SecureKey& subkey) {
+    // Chunked notes are skipped: their small record is bound to the body
+    // stream by its nonce, and compressing it gains nothing. Packs keep the
+    // dictionary they were written with until they are repacked.
+    auto streamed = notes_with_rows_in(Table::kNoteChunks);
+
+    std::vector<int64_t> ids;
+    std::vector<crypto::CryptoService::EncryptedData> records;
+    std::vector<int> codecs;
+    std::vector<std::pair<int64_t, int64_t>> timestamps;  // (created_at, updated_at)
+    std::vector<Row::Value> change_seqs;
+    std::vector<std::vector<uint8_t>> aads;
+    engine_->scan(Table::kNotes, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+        if (!row.is_null(col::Notes::kPackId) || streamed.count(key.a) > 0) {
+            return true;
+        }
+        auto encrypted = read_encrypted(row);
+        if (!encrypted.has_value()) {
+            return true;  // Corrupted rows are left as they are
+        }
+        ids.push_back(key.a);
+        records.push_back(std::move(*encrypted));
+        codecs.push_back(static_cast<int>(row.integer(col::Notes::kCodec)));
+        timestamps.emplace_back(row.integer(col::Notes::kCreatedAt),
+                                row.integer(col::Notes::kUpdatedAt));
+        change_seqs.push_back(row.values[col::Notes::kChangeSeq]);
+        aads.push_back(RecordAad::note(key.a));
+        return true;
+    });
+
+    for (size_t first = 0; first < records.size(); first += kScanBatchRows) {
+        size_t n = std::min(kScanBatchRows, records.size() - first);
+        std::span<const crypto::CryptoService::EncryptedData> batch_records(
+            records.data() + first, n);
+        std::span<const std::vector<uint8_t>> batch_aads(aads.data() + first, n);
+
+        auto plain = crypto::CryptoService::decrypt_many(batch_records, subkey, batch_aads);
+
+        // Re-encode each payload with the active dictionary
+        std::vector<crypto::SecureBytes> encoded;
+        std::vector<Codec> new_codecs;
+        std::vector<size_t> rows;  // Index within the batch
+        for (size_t i = 0; i < n; ++i) {
+            if (!plain.ok[i]) {
+                continue;
+            }
+            std::optional<crypto::SecureBytes> inflated;
+            auto payload = decode_payload(codecs[first + i], plain.plaintext(i), inflated);
+            if (!payload.has_value()) {
+                continue;
+            }
+            // Rewriting is also when version-1 JSON records become binary
+            crypto::SecureBytes bytes;
+            if (NoteRecord::is_binary(*payload)) {
+                bytes.assign(payload->begin(), payload->end());
+            } else {
+                auto note = deserialize_note(*payload);
+                if (!note.has_value()) {
+                    continue;
+                }
+                bytes = serialize_note(*note);
+            }
+            new_codecs.push_back(encode_payload(bytes));
+            encoded.push_back(std::move(bytes));
+            rows.push_back(i);
+        }
+
+        std::vector<std::span<const uint8_t>> plaintexts(encoded.begin(), encoded.end());
+        std::vector<std::vector<uint8_t>> enc_aads;
+        enc_aads.reserve(rows.size());
+        for (size_t i : rows) {
+            enc_aads.push_back(aads[first + i]);
+        }
+        auto enc = crypto::CryptoService::encrypt_many(
+            plaintexts, subkey, enc_aads, crypto::CryptoService::preferred_algorithm());
+
+        for (size_t k = 0; k < rows.size(); ++k) {
+            size_t index = first + rows[k];
+            Row row(Table::kNotes);
+            set_encrypted(row, enc.nonces[k], enc.ciphertext(k), enc.algorithm);
+            row.set(col::Notes::kCodec, static_cast<int64_t>(new_codecs[k]));
+            row.set(col::Notes::kCreatedAt, timestamps[index].first);
+            row.set(col::Notes::kUpdatedAt, timestamps[index].second);
+            row.values[col::Notes::kChangeSeq] = change_seqs[index];  // Not a change
+            engine_->put(Table::kNotes, RowKey{ids[index]}, row);
+        }
+    }
+}
+
+// === Cold Storage ===
+
+size_t NotesRepository::pack_cold_notes(const crypto::SecureKey& subkey,
+                                        std::chrono::seconds min_age, size_t max_packs)
+{
+    flush_pending();
+    load_dictionaries(subkey);
+    int64_t cutoff = current_timestamp() - static_cast<int64_t>(min_age.count());
+
+    // Oldest first: cold notes still in their rows, plus the notes of packs
+    // that saves and deletes have shrunk below kPackMinNotes
+    std::vector<int64_t> candidates;
+    {
+        struct Cold {
+            int64_t updated_at;
+            int64_t id;
+            std::optional<int64_t> pack_id;
+        };
+        std::vector<Cold> cold;
+        engine_->scan(Table::kNotes, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+            std::optional<int64_t> pack_id;
+            if (!row.is_null(col::Notes::kPackId)) {
+                pack_id = row.integer(col::Notes::kPackId);
+            }
+            int64_t updated_at = row.integer(col::Notes::kUpdatedAt);
+            if (updated_at < cutoff) {
+                cold.push_back(Cold{updated_at, key.a, pack_id});
+            }
+            return true;
+        }, {col::Notes::kUpdatedAt, col::Notes::kPackId});
+
+        std::set<int64_t> small_packs;
+        engine_->scan(Table::kNotePacks, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+            if (row.integer(col::NotePacks::kNoteCount) < static_cast<int64_t>(kPackMinNotes)) {
+                small_packs.insert(key.a);
+            }
+            return true;
+        }, {col::NotePacks::kNoteCount});
+
+        auto streamed = notes_with_rows_in(Table::kNoteChunks);
+        auto chunked = notes_with_rows_in(Table::kContentChunks);
+        std::sort(cold.begin(), cold.end(), [](const Cold& x, const Cold& y) {
+            return std::tie(x.updated_at, x.id) < std::tie(y.updated_at, y.id);
+        });
+        for (const auto& note : cold) {
+            bool eligible = note.pack_id.has_value()
+                ? small_packs.count(*note.pack_id) > 0
+                : streamed.count(note.id) == 0 && chunked.count(note.id) == 0;
+            if (eligible) {
+                candidates.push_back(note.id);
+            }
+        }
+    }
+
+    size_t packed = 0;
+    size_t packs_written = 0;
+    size_t next = 0;
+    while (next < candidates.size() && packs_written < max_packs) {
+        std::vector<int64_t> ids;
+        std::vector<crypto::SecureBytes> payloads;
+        size_t bytes = 0;
+        for (; next < candidates.size() && bytes < kPackTargetBytes; ++next) {
+            auto payload = read_inline_payload(candidates[next], subkey);
+            if (!payload.has_value()) {
+                continue;  // Unreadable or chunked: left where it is
+            }
+            bytes += payload->size();
+            ids.push_back(candidates[next]);
+            payloads.push_back(std::move(*payload));
+        }
+        if (ids.size() < kPackMinNotes) {
+            break;
+        }
+
+        engine_->begin();
+        try {
+            write_pack(ids, payloads, subkey);
+            engine_->commit();
+        } catch (...) {
+            engine_->rollback();
+            throw;
+        }
+        packed += ids.size();
+        ++packs_written;
+    }
+    return packed;
+}
+
+void NotesRepository::write_pack(const std::vector<int64_t>& ids,
+                                 const std::vector<crypto::SecureBytes>& payloads,
+                                 const crypto::SecureKey& subkey)
+{
+    std::vector<NotePack::Entry> entries;
+    entries.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        entries.push_back(NotePack::Entry{ids[i], payloads[i]});
+    }
+    crypto::SecureBytes plaintext = NotePack::encode(entries);
+
+    // Rows reference this exact pack content. Password change re-encrypts
+    // the pack but leaves its plaintext, and so the digest, unchanged.
+    std::array<uint8_t, 32> digest{};
+    crypto_generichash(digest.data(), digest.size(),
+                       plaintext.data(), plaintext.size(), nullptr, 0);
+    Codec codec = encode_payload(plaintext);
+
+    // Placeholder row for the pack ID the AAD needs
+    Row pack(Table::kNotePacks);
+    set_placeholder(pack);
+    pack.set(col::NotePacks::kCodec, int64_t{0});
+    pack.set(col::NotePacks::kNoteCount, static_cast<int64_t>(ids.size()));
+    pack.set(col::NotePacks::kCreatedAt, current_timestamp());
+    int64_t pack_id = engine_->insert(Table::kNotePacks, pack);
+
+    auto encrypted = crypto::CryptoService::encrypt(
+        plaintext, subkey, RecordAad::pack(pack_id),
+        crypto::CryptoService::preferred_algorithm());
+    set_encrypted(pack, encrypted);
+    pack.set(col::NotePacks::kCodec, static_cast<int64_t>(codec));
+    engine_->put(Table::kNotePacks, RowKey{pack_id}, pack);
+
+    // Point the notes at the pack; their records become pack references
+    std::vector<uint8_t> ref(8 + digest.size());
+    std::memcpy(ref.data(), &pack_id, 8);
+    std::memcpy(ref.data() + 8, digest.data(), digest.size());
+    std::set<int64_t> old_packs;
+    for (int64_t id : ids) {
+        auto row = engine_->get(Table::kNotes, RowKey{id});
+        if (!row.has_value()) {
+            continue;
+        }
+        if (!row->is_null(col::Notes::kPackId)) {
+            old_packs.insert(row->integer(col::Notes::kPackId));
+        }
+        row->set(col::Notes::kPackId, pack_id);
+        set_encrypted(*row, crypto::CryptoService::encrypt(
+            ref, subkey, RecordAad::pack_ref(id),
+            crypto::CryptoService::preferred_algorithm()));
+        row->set(col::Notes::kCodec, int64_t{0});
+        engine_->put(Table::kNotes, RowKey{id}, *row);
+    }
+
+    // The packs they came from must not keep a copy
+    for (int64_t old_pack : old_packs) {
+        rewrite_pack(old_pack, subkey);
+    }
+}
+
+const NotesRepository::CachedPack* NotesRepository::load_pack(
+    int64_t pack_id, const crypto::SecureKey& subkey)
+{
+    for (auto it = pack_cache_.begin(); it != pack_cache_.end(); ++it) {
+        if (it->pack_id == pack_id) {
+            pack_cache_.splice(pack_cache_.begin(), pack_cache_, it);  // Most recent
+            return &pack_cache_.front();
+        }
+    }
+
+    // Miss: decrypt and decompress the whole pack once
+    auto row = engine_->get(Table::kNotePacks, RowKey{pack_id});
+    if (!row.has_value()) {
+        return nullptr;
+    }
+    auto encrypted = read_encrypted(*row);
+    if (!encrypted.has_value()) {
+        return nullptr;
+    }
+    auto plaintext = crypto::CryptoService::decrypt_secure(
+        *encrypted, subkey, RecordAad::pack(pack_id));
+    if (!plaintext.has_value()) {
+        return nullptr;  // Tampered, swapped or wrong key
+    }
+
+    load_dictionaries(subkey);
+    std::optional<crypto::SecureBytes> inflated;
+    if (!decode_payload(static_cast<int>(row->integer(col::NotePacks::kCodec)),
+                        *plaintext, inflated).has_value()) {
+        return nullptr;
+    }
+
+    // Index into the cached buffer itself (list nodes never move)
+    CachedPack& pack = pack_cache_.emplace_front();
+    pack.pack_id = pack_id;
+    pack.plaintext = inflated.has_value() ? std::move(*inflated) : std::move(*plaintext);
+    crypto_generichash(pack.digest.data(), pack.digest.size(),
+                       pack.plaintext.data(), pack.plaintext.size(), nullptr, 0);
+    auto entries = NotePack::decode(pack.plaintext);
+    if (!entries.has_value()) {
+        pack_cache_.pop_front();
+        return nullptr;
+    }
+    for (const auto& entry : *entries) {
+        pack.payloads.emplace(entry.note_id, entry.payload);
+    }
+    while (pack_cache_.size() > kPackCacheEntries) {
+        pack_cache_.pop_back();
+    }
+    return &pack;
+}
+
+std::optional<std::span<const uint8_t>> NotesRepository::read_packed_payload(
+    int64_t note_id, const Row& row, const crypto::SecureKey& subkey)
+{
+    // The row's reference must name the pack it points at, with the content
+    // the note was packed into; an older pack restored under the same ID
+    // does not match
+    auto encrypted = read_encrypted(row);
+    if (!encrypted.has_value()) {
+        return std::nullopt;
+    }
+    auto ref = crypto::CryptoService::decrypt_secure(
+        *encrypted, subkey, RecordAad::pack_ref(note_id));
+    if (!ref.has_value() || ref->size() != 8 + 32) {
+        return std::nullopt;
+    }
+    int64_t pack_id = row.integer(col::Notes::kPackId);
+    int64_t ref_pack_id = 0;
+    std::memcpy(&ref_pack_id, ref->data(), 8);
+    if (ref_pack_id != pack_id) {
+        return std::nullopt;
+    }
+
+    const CachedPack* pack = load_pack(pack_id, subkey);
+    if (pack == nullptr ||
+        sodium_memcmp(pack->digest.data(), ref->data() + 8, pack->digest.size()) != 0) {
+        return std::nullopt;
+    }
+    auto it = pack->payloads.find(note_id);
+    if (it == pack->payloads.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::optional<crypto::SecureBytes> NotesRepository::read_stored_record(
+    int64_t note_id, const Row& row, const crypto::SecureKey& subkey)
+{
+    crypto::SecureBytes serialized;
+    if (!row.is_null(col::Notes::kPackId)) {
+        auto payload = read_packed_payload(note_id, row, subkey);
+        if (!payload.has_value()) {
+            return std::nullopt;
+        }
+        serialized.assign(payload->begin(), payload->end());
+        return serialized;
+    }
+
+    auto encrypted = read_encrypted(row);
+    if (!encrypted.has_value()) {
+        return std::nullopt;
+    }
+    auto plaintext = crypto::CryptoService::decrypt_secure(
+        *encrypted, subkey, RecordAad::note(note_id));
+    if (!plaintext.has_value()) {
+        return std::nullopt;
+    }
+    std::optional<crypto::SecureBytes> inflated;
+    auto payload = decode_payload(static_cast<int>(row.integer(col::Notes::kCodec)),
+                                  *plaintext, inflated);
+    if (!payload.has_value()) {
+        return std::nullopt;
+    }
+    if (inflated.has_value()) {
+        return std::move(*inflated);
+    }
+    return std::move(*plaintext);
+}
+
+std::optional<crypto::SecureBytes> NotesRepository::read_inline_payload(
+    int64_t note_id, const crypto::SecureKey& subkey)
+{
+    auto row = engine_->get(Table::kNotes, RowKey{note_id});
+    if (!row.has_value()) {
+        return std::nullopt;
+    }
+    load_dictionaries(subkey);
+    auto stored = read_stored_record(note_id, *row, subkey);
+    if (!stored.has_value()) {
+        return std::nullopt;
+    }
+    crypto::SecureBytes serialized = std::move(*stored);
+
+    // Packs hold version-2 records with the body inline
+    if (NoteRecord::is_binary(serialized)) {
+        auto view = NoteRecord::decode(serialized, true);
+        if (!view.has_value() || view->body_chunks > 0) {
+            return std::nullopt;
+        }
+        return serialized;
+    }
+    ChunkInfo info;
+    auto note = deserialize_note(serialized, &info);
+    if (!note.has_value() || info.body_chunks > 0) {
+        return std::nullopt;
+    }
+    return serialize_note(*note);
+}
+
+void NotesRepository::rewrite_pack(int64_t pack_id, const crypto::SecureKey& subkey) {
+    auto drop = [&] {
+        engine_->erase(Table::kNotePacks, RowKey{pack_id});
+        pack_cache_.remove_if([&](const CachedPack& pack) { return pack.pack_id == pack_id; });
+    };
+    if (engine_->count_matching(Table::kNotes, col::Notes::kPackId, pack_id) == 0) {
+        drop();
+        return;
+    }
+
+    const CachedPack* pack = load_pack(pack_id, subkey);
+    if (pack == nullptr) {
+        throw std::runtime_error("Failed to rewrite pack " + std::to_string(pack_id) +
+                                 ": pack does not decrypt");
+    }
+
+    // Keep the notes whose rows still point here, in ID order (payloads are
+    // copied: the cache entry goes with the pack)
+    std::vector<int64_t> members;
+    for (const auto& entry : pack->payloads) {
+        members.push_back(entry.first);
+    }
+    std::sort(members.begin(), members.end());
+    std::vector<int64_t> ids;
+    std::vector<crypto::SecureBytes> payloads;
+    for (int64_t note_id : members) {
+        auto row = engine_->get(Table::kNotes, RowKey{note_id}, {col::Notes::kPackId});
+        if (row.has_value() && !row->is_null(col::Notes::kPackId) &&
+            row->integer(col::Notes::kPackId) == pack_id) {
+            auto payload = pack->payloads.at(note_id);
+            ids.push_back(note_id);
+            payloads.emplace_back(payload.begin(), payload.end());
+        }
+    }
+    if (ids.size() == members.size()) {
+        return;  // Nothing left the pack
+    }
+
+    drop();
+    write_pack(ids, payloads, subkey);
+}
+
+// === Record / Chunk Storage ===
+
+crypto::SecureBytes NotesRepository::store_note(int64_t note_id, const Note& note,
+                                                const crypto::SecureKey& subkey,
+                                                std::optional<int64_t> updated_at,
+                                                std::vector<int64_t>& released)
+{
+    note_cache_.erase(note_id);  // Even if the transaction rolls back
+    auto aad = RecordAad::note(note_id);
+    auto current = engine_->get(Table::kNotes, RowKey{note_id},
+                                {col::Notes::kCreatedAt, col::Notes::kUpdatedAt,
+                                 col::Notes::kPackId, col::Notes::kChangeSeq});
+    if (!current.has_value()) {
+        throw std::runtime_error("Failed to update note: no row for note " +
+                                 std::to_string(note_id));
+    }
+    std::optional<int64_t> old_pack;
+    if (!current->is_null(col::Notes::kPackId)) {
+        old_pack = current->integer(col::Notes::kPackId);
+    }
+
+    // Large bodies go to content_chunks; the record keeps title/tags and
+    // the chunk manifest
+    ChunkInfo info;
+    bool chunked = note.body.size() >= kChunkedBodyThresholdBytes;
+    if (chunked) {
+        info.body_bytes = note.body.size();
+        info.manifest = write_content_chunks(note_id, note.body.view(), subkey, released);
+        info.body_chunks = info.manifest.size();
+    } else {
+        engine_->scan(Table::kContentChunks, KeyRange::prefix(note_id),
+            [&](const RowKey& key, const Row& row) {
+                if (row.is_null(col::ContentChunks::kReleasedBy)) {
+                    released.push_back(key.b);
+                }
+                return true;
+            }, {col::ContentChunks::kReleasedBy});
+    }
+
+    auto record = serialize_note(note, chunked ? &info : nullptr);
+    auto plaintext = record;
+    load_dictionaries(subkey);
+    Codec codec = encode_payload(plaintext);
+    auto encrypted = crypto::CryptoService::encrypt(
+        plaintext, subkey, aad, crypto::CryptoService::preferred_algorithm());
+
+    Row row(Table::kNotes);
+    set_encrypted(row, encrypted);
+    row.set(col::Notes::kCodec, static_cast<int64_t>(codec));
+    row.set(col::Notes::kCreatedAt, current->integer(col::Notes::kCreatedAt));
+    row.set(col::Notes::kUpdatedAt,
+            updated_at.value_or(current->integer(col::Notes::kUpdatedAt)));
+    std::optional<int64_t> previous_change;
+    if (!current->is_null(col::Notes::kChangeSeq)) {
+        previous_change = current->integer(col::Notes::kChangeSeq);
+    }
+    row.set(col::Notes::kChangeSeq, record_change(note_id, previous_change, false));
+    engine_->put(Table::kNotes, RowKey{note_id}, row);
+
+    // A packed note now lives in its row again; its old version must not
+    // stay readable in the pack
+    if (old_pack.has_value()) {
+        rewrite_pack(*old_pack, subkey);
+    }
+
+    // Any legacy body stream is stale (bound to the old record nonce)
+    engine_->erase_range(Table::kNoteChunks, KeyRange::prefix(note_id));
+    return record;
+}
+
+void NotesRepository::save_note(const Note& note, const crypto::SecureKey& subkey,
+                                int64_t saved_at)
+{
+    auto plan = plan_revision(note.id, subkey);
+    std::vector<int64_t> released;
+    auto record = store_note(note.id, note, subkey, saved_at, released);
+    record_revision(note.id, plan, record, released, subkey);
+}
+
+std::vector<NoteRecord::ChunkRef> NotesRepository::write_content_chunks(
+    int64_t note_id, std::string_view body, const crypto::SecureKey& subkey,
+    std::vector<int64_t>& released)
+{
+    using Hash = std::array<uint8_t, NoteRecord::kChunkHashBytes>;
+
+    // Chunks already stored for this note, by content hash (none for a new
+    // note or one whose body was inline or a legacy stream)
+    std::map<Hash, NoteRecord::ChunkRef> stored;
+    {
+        ChunkInfo current;
+        std::array<uint8_t, crypto::CryptoService::NONCE_BYTES> nonce{};
+        if (read_note_record(note_id, subkey, current, nonce).has_value()) {
+            for (const auto& chunk : current.manifest) {
+                stored.emplace(chunk.hash, chunk);
+            }
+        }
+    }
+
+    // New chunks get IDs above every existing row, so any row below
+    // `first_new_id` that the new manifest does not reference is garbage
+    uint64_t first_new_id = 1;
+    engine_->scan(Table::kContentChunks, KeyRange::prefix(note_id),
+        [&](const RowKey& key, const Row&) {
+            first_new_id = static_cast<uint64_t>(key.b) + 1;
+            return false;
+        }, Projection::none(), ScanOrder::kDescending);
+    uint64_t next_id = first_new_id;
+
+    auto bytes = std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t*>(body.data()), body.size());
+    std::vector<NoteRecord::ChunkRef> manifest;
+    size_t offset = 0;
+
+    for (size_t len : ContentChunker::split(bytes)) {
+        auto piece = bytes.subspan(offset, len);
+        offset += len;
+
+        NoteRecord::ChunkRef ref;
+        ref.size = static_cast<uint32_t>(len);
+        crypto_generichash(ref.hash.data(), ref.hash.size(),
+                           piece.data(), piece.size(), nullptr, 0);
+
+        auto it = stored.find(ref.hash);
+        if (it != stored.end() && it->second.size == ref.size) {
+            ref.chunk_id = it->second.chunk_id;  // Unchanged: keep the stored row
+            manifest.push_back(ref);
+            continue;
+        }
+
+        // Changed (or new) chunk: encrypt one at a time
+        ref.chunk_id = next_id++;
+        auto encrypted = crypto::CryptoService::encrypt(
+            piece, subkey, RecordAad::content_chunk(note_id, ref.chunk_id),
+            crypto::CryptoService::preferred_algorithm());
+
+        Row row(Table::kContentChunks);
+        set_encrypted(row, encrypted);
+        engine_->put(Table::kContentChunks,
+                     RowKey{note_id, static_cast<int64_t>(ref.chunk_id)}, row);
+
+        stored[ref.hash] = ref;  // Repeats later in this body share the row
+        manifest.push_back(ref);
+    }
+
+    // Current rows the new manifest no longer references (rows released
+    // earlier belong to revisions)
+    std::set<uint64_t> referenced;
+    for (const auto& chunk : manifest) {
+        referenced.insert(chunk.chunk_id);
+    }
+    engine_->scan(Table::kContentChunks,
+        KeyRange{{note_id, std::numeric_limits<int64_t>::min()},
+                 {note_id, static_cast<int64_t>(first_new_id) - 1}},
+        [&](const RowKey& key, const Row& row) {
+            if (row.is_null(col::ContentChunks::kReleasedBy) &&
+                referenced.count(static_cast<uint64_t>(key.b)) == 0) {
+                released.push_back(key.b);
+            }
+            return true;
+        }, {col::ContentChunks::kReleasedBy});
+
+    return manifest;
+}
+
+bool NotesRepository::read_content_chunks(
+    int64_t note_id, const ChunkInfo& info, const crypto::SecureKey& subkey,
+    size_t max_bytes, const std::function<void(std::string_view)>& sink)
+{
+    uint64_t delivered = 0;
+
+    for (const auto& chunk : info.manifest) {
+        auto row = engine_->get(Table::kContentChunks,
+                                RowKey{note_id, static_cast<int64_t>(chunk.chunk_id)});
+        if (!row.has_value()) {
+            return false;  // Missing chunk
+        }
+        auto encrypted = read_encrypted(*row);
+        if (!encrypted.has_value()) {
+            return false;
+        }
+
+        auto plaintext = crypto::CryptoService::decrypt_secure(
+            *encrypted, subkey, RecordAad::content_chunk(note_id, chunk.chunk_id));
+        if (!plaintext.has_value() || plaintext->size() != chunk.size) {
+            return false;
+        }
+
+        // The manifest is authenticated with the record, so the hash pins
+        // each chunk to the content this version of the note expects
+        std::array<uint8_t, NoteRecord::kChunkHashBytes> hash;
+        crypto_generichash(hash.data(), hash.size(),
+                           plaintext->data(), plaintext->size(), nullptr, 0);
+        if (sodium_memcmp(hash.data(), chunk.hash.data(), hash.size()) != 0) {
+            return false;
+        }
+
+        sink(std::string_view(reinterpret_cast<const char*>(plaintext->data()),
+                              plaintext->size()));
+        delivered += plaintext->size();
+        if (delivered >= max_bytes) {
+            return true;  // Caller needs no more (e.g. list preview)
+        }
+    }
+
+    return delivered == info.body_bytes;
+}
+
+bool NotesRepository::read_body(
+    int64_t note_id,
+    const std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& record_nonce,
+    const ChunkInfo& info, const crypto::SecureKey& subkey, size_t max_bytes,
+    const std::function<void(std::string_view)>& sink)
+{
+    if (!info.manifest.empty()) {
+        return read_content_chunks(note_id, info, subkey, max_bytes, sink);
+    }
+    return read_body_chunks(note_id, record_nonce, info, subkey, max_bytes, sink);
+}
+
+// Bodies saved before content-defined chunking: one secretstream per record
+// version, bound to the record nonce
+bool NotesRepository::read_body_chunks(
+    int64_t note_id,
+    const std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& record_nonce,
+    const ChunkInfo& info, const crypto::SecureKey& subkey, size_t max_bytes,
+    const std::function<void(std::string_view)>& sink)
+{
+    auto ad = RecordAad::stream_chunk(note_id, record_nonce);
+    crypto::SecureBytes plaintext(kBodyChunkBytes);  // Reused, locked
+    std::optional<crypto::SecretStreamReader> reader;
+    uint64_t next_seq = 1;
+    uint64_t delivered = 0;
+    bool ok = true;
+    bool enough = false;
+
+    engine_->scan(Table::kNoteChunks, KeyRange::prefix(note_id),
+        [&](const RowKey& key, const Row& row) {
+            auto data = row.blob(col::NoteChunks::kData);
+
+            // Stream header
+            if (!reader.has_value()) {
+                if (key.b != 0) {
+                    ok = false;
+                    return false;
+                }
+                try {
+                    reader.emplace(subkey, data);  // Streams are keyed with the subkey itself
+                } catch (const std::invalid_argument&) {
+                    ok = false;
+                }
+                return ok;
+            }
+
+            if (static_cast<uint64_t>(key.b) != next_seq) {
+                ok = false;  // Gap in the chunk sequence
+                return false;
+            }
+            if (data.empty() ||
+                data.size() > kBodyChunkBytes + crypto::SecretStreamReader::ABYTES) {
+                ok = false;
+                return false;
+            }
+
+            size_t len = 0;
+            if (!reader->pull(data, ad, plaintext.data(), &len)) {
+                ok = false;
+                return false;
+            }
+
+            sink(std::string_view(reinterpret_cast<const char*>(plaintext.data()), len));
+            delivered += len;
+            next_seq++;
+
+            if (delivered >= max_bytes) {
+                enough = true;  // Caller needs no more (e.g. list preview)
+                return false;
+            }
+            return true;
+        });
+
+    if (!ok || !reader.has_value()) {
+        return false;
+    }
+    if (enough) {
+        return true;
+    }
+
+    // Whole stream: must end on the final tag with the recorded size
+    return reader->finished() &&
+           next_seq - 1 == info.body_chunks &&
+           delivered == info.body_bytes;
+}
+
+// === Serialization Helpers ===
+
+crypto::SecureBytes NotesRepository::serialize_note(const Note& note,
+                                                   const ChunkInfo* chunks) {
+    // With `chunks`, only the body's size, preview and manifest go into the record
+    if (chunks == nullptr) {
+        return NoteRecord::encode(note.title.view(), note.tags, note.body.view());
+    }
+    return NoteRecord::encode(note.title.view(), note.tags, note.body.view(), chunks->manifest);
+}
+
+std::optional<Note> NotesRepository::deserialize_note(std::span<const uint8_t> payload,
+                                                     ChunkInfo* chunks) {
+    if (!NoteRecord::is_binary(payload)) {
+        return deserialize_json_note(payload, chunks);
+    }
+
+    auto view = NoteRecord::decode(payload);
+    if (!view.has_value()) {
+        return std::nullopt;
+    }
+
+    Note note;
+    note.title = crypto::SecureString(view->title);
+    note.body = crypto::SecureString(view->body);
+    note.tags.assign(view->tags.begin(), view->tags.end());
+    if (chunks != nullptr) {
+        chunks->body_bytes = view->body_chunks > 0 ? view->body_bytes : 0;
+        chunks->body_chunks = view->body_chunks;
+        chunks->manifest = std::move(view->chunks);
+    }
+    return note;
+}
+
+std::optional<Note> NotesRepository::deserialize_json_note(std::span<const uint8_t> json_bytes,
+                                                          ChunkInfo* chunks) {
+    // Parse straight from the decrypted buffer; no intermediate std::string
+    auto j = secure_json::parse(json_bytes.begin(), json_bytes.end(), nullptr, false);
+    if (j.is_discarded() || !j.is_object()) {
+        return std::nullopt;
+    }
+
+    // Move strings out of the DOM so the Note holds the only copy
+    Note note;
+    if (auto it = j.find("title"); it != j.end() && it->is_string()) {
+        note.title = std::move(it->get_ref<crypto::SecureString&>());
+    }
+    if (auto it = j.find("body"); it != j.end() && it->is_string()) {
+        note.body = std::move(it->get_ref<crypto::SecureString&>());
+    }
+    if (chunks != nullptr) {
+        *chunks = ChunkInfo{};
+        auto bytes = j.find("body_bytes");
+        auto count = j.find("body_chunks");
+        if (bytes != j.end() && bytes->is_number_unsigned() &&
+            count != j.end() && count->is_number_unsigned()) {
+            chunks->body_bytes = bytes->get<uint64_t>();
+            chunks->body_chunks = count->get<uint64_t>();
+        }
+    }
+    if (auto it = j.find("tags"); it != j.end() && it->is_array()) {
+        for (const auto& tag : *it) {
+            if (tag.is_string()) {
+                note.tags.push_back(tag.get_ref<const crypto::SecureString&>().str());
+            }
+        }
+    }
+    return note;
 }
 
 int64_t NotesRepository::current_timestamp() {
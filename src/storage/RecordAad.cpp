@@ -0,0 +1,95 @@
+#include "bastionx/storage/RecordAad.h"
+#include <cstring>
+
+namespace bastionx {
+namespace storage {
+
+// "prefix || fields", each field copied as its in-memory bytes
+// (little-endian on x64)
+template <size_t N>
+static std::vector<uint8_t> prefixed(const char (&prefix)[N], size_t field_bytes) {
+    std::vector<uint8_t> aad(N - 1 + field_bytes);
+    std::memcpy(aad.data(), prefix, N - 1);
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::note(int64_t note_id) {
+    std::vector<uint8_t> aad(4);
+    uint32_t id32 = static_cast<uint32_t>(note_id);
+    std::memcpy(aad.data(), &id32, 4);
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::stream_chunk(
+    int64_t note_id,
+    const std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& record_nonce)
+{
+    // Binds every chunk to its note and to this exact version of the record
+    std::vector<uint8_t> aad = note(note_id);
+    aad.insert(aad.end(), record_nonce.begin(), record_nonce.end());
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::content_chunk(int64_t note_id, uint64_t chunk_id) {
+    // Chunks outlive record versions, so they are bound to note and chunk ID;
+    // the manifest hash ties them to a version
+    std::vector<uint8_t> aad = note(note_id);
+    aad.resize(4 + 8);
+    std::memcpy(aad.data() + 4, &chunk_id, 8);
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::dictionary(uint32_t dict_id) {
+    auto aad = prefixed("BXDICTv1", 4);
+    std::memcpy(aad.data() + 8, &dict_id, 4);
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::pack(int64_t pack_id) {
+    auto aad = prefixed("BXPACKv1", 8);
+    std::memcpy(aad.data() + 8, &pack_id, 8);
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::pack_ref(int64_t note_id) {
+    auto aad = prefixed("BXPREFv1", 8);
+    std::memcpy(aad.data() + 8, &note_id, 8);
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::revision(int64_t note_id, int64_t revision_id) {
+    auto aad = prefixed("BXREVSv1", 16);
+    std::memcpy(aad.data() + 8, &note_id, 8);
+    std::memcpy(aad.data() + 16, &revision_id, 8);
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::attachment_key(int64_t attachment_id) {
+    auto aad = prefixed("BXAKEYv1", 8);
+    std::memcpy(aad.data() + 8, &attachment_id, 8);
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::attachment_link(int64_t note_id, int64_t attachment_id) {
+    auto aad = prefixed("BXAREFv1", 16);
+    std::memcpy(aad.data() + 8, &note_id, 8);
+    std::memcpy(aad.data() + 16, &attachment_id, 8);
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::attachment_chunk(int64_t attachment_id) {
+    // The stream key is per attachment; this only guards against a stream
+    // being paired with another attachment's row
+    std::vector<uint8_t> aad(8);
+    std::memcpy(aad.data(), &attachment_id, 8);
+    return aad;
+}
+
+std::vector<uint8_t> RecordAad::vault_key(std::string_view purpose) {
+    auto aad = prefixed("BXVKEYv1", purpose.size());
+    std::memcpy(aad.data() + 8, purpose.data(), purpose.size());
+    return aad;
+}
+
+}  // namespace storage
+}  // namespace bastionx
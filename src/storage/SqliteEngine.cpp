@@ -0,0 +1,459 @@
+#include "bastionx/storage/SqliteEngine.h"
+#include <stdexcept>
+
+namespace bastionx {
+namespace storage {
+
+// === RAII wrapper for sqlite3_stmt* ===
+
+class ScopedStmt {
+public:
+    ScopedStmt(sqlite3* db, const std::string& sql) : stmt_(nullptr) {
+        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt_, nullptr);
+        if (rc != SQLITE_OK) {
+            throw std::runtime_error(
+                "Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
+        }
+    }
+
+    ~ScopedStmt() {
+        if (stmt_) sqlite3_finalize(stmt_);
+    }
+
+    ScopedStmt(const ScopedStmt&) = delete;
+    ScopedStmt& operator=(const ScopedStmt&) = delete;
+
+    sqlite3_stmt* get() const { return stmt_; }
+
+private:
+    sqlite3_stmt* stmt_;
+};
+
+// === SQL Construction ===
+
+// "id" or "note_id, seq"
+static std::string key_columns(const TableSpec& spec) {
+    std::string sql = spec.key;
+    if (spec.subkey != nullptr) {
+        sql += std::string(", ") + spec.subkey;
+    }
+    return sql;
+}
+
+// Selected value columns, in the order column_indexes() lists them
+static std::vector<size_t> column_indexes(const TableSpec& spec, const Projection& columns) {
+    if (columns.only.has_value()) {
+        return *columns.only;
+    }
+    std::vector<size_t> all(spec.columns.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        all[i] = i;
+    }
+    return all;
+}
+
+static std::string select_list(const TableSpec& spec, const std::vector<size_t>& indexes) {
+    std::string sql;
+    for (size_t i : indexes) {
+        sql += sql.empty() ? "" : ", ";
+        sql += spec.columns.at(i);
+    }
+    return sql.empty() ? "1" : sql;
+}
+
+// Key equality on ?1 (and ?2)
+static std::string key_match(const TableSpec& spec) {
+    std::string sql = std::string(spec.key) + " = ?1";
+    if (spec.subkey != nullptr) {
+        sql += std::string(" AND ") + spec.subkey + " = ?2";
+    }
+    return sql;
+}
+
+// Key range on ?1..?4 (first.a, first.b, last.a, last.b). The leading
+// BETWEEN on the first column lets SQLite bound the index scan.
+static std::string range_match(const TableSpec& spec) {
+    std::string sql = std::string(spec.key) + " BETWEEN ?1 AND ?3";
+    if (spec.subkey != nullptr) {
+        sql += " AND (" + key_columns(spec) + ") BETWEEN (?1, ?2) AND (?3, ?4)";
+    }
+    return sql;
+}
+
+static void bind_key(sqlite3_stmt* stmt, const TableSpec& spec, const RowKey& key) {
+    sqlite3_bind_int64(stmt, 1, key.a);
+    if (spec.subkey != nullptr) {
+        sqlite3_bind_int64(stmt, 2, key.b);
+    }
+}
+
+static void bind_range(sqlite3_stmt* stmt, const KeyRange& range) {
+    sqlite3_bind_int64(stmt, 1, range.first.a);
+    sqlite3_bind_int64(stmt, 2, range.first.b);
+    sqlite3_bind_int64(stmt, 3, range.last.a);
+    sqlite3_bind_int64(stmt, 4, range.last.b);
+}
+
+static void bind_value(sqlite3_stmt* stmt, int index, const Row::Value& value) {
+    if (const auto* i = std::get_if<int64_t>(&value)) {
+        sqlite3_bind_int64(stmt, index, *i);
+    } else if (const auto* blob = std::get_if<std::vector<uint8_t>>(&value)) {
+        if (blob->empty()) {
+            sqlite3_bind_zeroblob(stmt, index, 0);  // A null pointer would bind NULL
+        } else {
+            sqlite3_bind_blob(stmt, index, blob->data(), static_cast<int>(blob->size()),
+                              SQLITE_STATIC);
+        }
+    } else {
+        sqlite3_bind_null(stmt, index);
+    }
+}
+
+static Row::Value column_value(sqlite3_stmt* stmt, int index) {
+    switch (sqlite3_column_type(stmt, index)) {
+        case SQLITE_NULL:
+            return std::monostate{};
+        case SQLITE_INTEGER:
+        case SQLITE_FLOAT:
+            return static_cast<int64_t>(sqlite3_column_int64(stmt, index));
+        default: {
+            auto* data = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, index));
+            int size = sqlite3_column_bytes(stmt, index);
+            if (data == nullptr || size <= 0) {
+                return std::vector<uint8_t>();
+            }
+            return std::vector<uint8_t>(data, data + size);
+        }
+    }
+}
+
+// Value columns from result column `first` on into their row positions
+static Row read_row(sqlite3_stmt* stmt, Table table, const std::vector<size_t>& indexes,
+                    int first)
+{
+    Row row(table);
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        row.values[indexes[i]] = column_value(stmt, first + static_cast<int>(i));
+    }
+    return row;
+}
+
+// === SqliteEngine Implementation ===
+
+SqliteEngine::SqliteEngine(const std::string& db_path, const crypto::SecureKey* db_key,
+                           const ConnectionProfile& profile, bool read_only)
+    : db_(nullptr), db_path_(db_path) {
+    int flags = read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+    int rc = sqlite3_open_v2(db_path.c_str(), &db_, flags, nullptr);
+    if (rc != SQLITE_OK) {
+        std::string err = db_ ? sqlite3_errmsg(db_) : "unknown error";
+        if (db_) sqlite3_close(db_);
+        db_ = nullptr;
+        throw std::runtime_error("Failed to open database: " + err);
+    }
+
+    // Set SQLCipher encryption key if provided
+    if (db_key) {
+        rc = sqlite3_key(db_, db_key->data(), static_cast<int>(db_key->size()));
+        if (rc != SQLITE_OK) {
+            std::string err = sqlite3_errmsg(db_);
+            sqlite3_close(db_);
+            db_ = nullptr;
+            throw std::runtime_error("Failed to set encryption key: " + err);
+        }
+    }
+
+    try {
+        profile.apply(db_, db_key != nullptr);
+    } catch (...) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+        throw;
+    }
+}
+
+SqliteEngine::~SqliteEngine() {
+    close();
+}
+
+void SqliteEngine::close() {
+    for (auto& [sql, stmt] : statements_) {
+        sqlite3_finalize(stmt);
+    }
+    statements_.clear();
+    if (db_) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+    }
+}
+
+bool SqliteEngine::is_open() const {
+    return db_ != nullptr;
+}
+
+void SqliteEngine::interrupt() {
+    if (db_ != nullptr) {
+        sqlite3_interrupt(db_);
+    }
+}
+
+SqliteEngine::CheckpointResult SqliteEngine::checkpoint(CheckpointMode mode) {
+    CheckpointResult result;
+    int rc = sqlite3_wal_checkpoint_v2(handle(), nullptr, static_cast<int>(mode),
+                                       &result.wal_frames, &result.checkpointed_frames);
+    if (rc != SQLITE_OK && rc != SQLITE_BUSY) {
+        throw std::runtime_error("Checkpoint failed: " + std::string(sqlite3_errmsg(db_)));
+    }
+    // A passive checkpoint stops short at readers' snapshots instead
+    result.busy = rc == SQLITE_BUSY || result.checkpointed_frames < result.wal_frames;
+    return result;
+}
+
+void SqliteEngine::set_auto_checkpoint(int pages) {
+    if (sqlite3_wal_autocheckpoint(handle(), pages) != SQLITE_OK) {
+        throw std::runtime_error("Failed to set auto-checkpoint: " +
+                                 std::string(sqlite3_errmsg(db_)));
+    }
+}
+
+sqlite3* SqliteEngine::handle() const {
+    if (db_ == nullptr) {
+        throw std::runtime_error("Database is closed");
+    }
+    return db_;
+}
+
+sqlite3_stmt* SqliteEngine::cached(const std::string& sql) {
+    auto it = statements_.find(sql);
+    if (it == statements_.end()) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(handle(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            throw std::runtime_error(
+                "Failed to prepare statement: " + std::string(sqlite3_errmsg(db_)));
+        }
+        it = statements_.emplace(sql, stmt).first;
+    }
+    sqlite3_reset(it->second);
+    sqlite3_clear_bindings(it->second);
+    return it->second;
+}
+
+void SqliteEngine::exec(const char* sql) {
+    char* err_msg = nullptr;
+    int rc = sqlite3_exec(handle(), sql, nullptr, nullptr, &err_msg);
+    if (rc != SQLITE_OK) {
+        std::string err = err_msg ? err_msg : "unknown error";
+        sqlite3_free(err_msg);
+        throw std::runtime_error("SQL error: " + err);
+    }
+}
+
+int SqliteEngine::step_done(sqlite3_stmt* stmt, const char* what, Table table) {
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);  // Release blobs bound SQLITE_STATIC
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Failed to ") + what + " " +
+                                 table_spec(table).name + ": " + sqlite3_errmsg(db_));
+    }
+    return sqlite3_changes(db_);
+}
+
+void SqliteEngine::begin() {
+    exec("BEGIN TRANSACTION;");
+}
+
+void SqliteEngine::commit() {
+    exec("COMMIT;");
+}
+
+void SqliteEngine::rollback() {
+    exec("ROLLBACK;");
+}
+
+std::optional<Row> SqliteEngine::get(Table table, const RowKey& key, const Projection& columns) {
+    const TableSpec& spec = table_spec(table);
+    auto indexes = column_indexes(spec, columns);
+    sqlite3_stmt* stmt = cached("SELECT " + select_list(spec, indexes) + " FROM " + spec.name +
+                                " WHERE " + key_match(spec));
+    bind_key(stmt, spec, key);
+
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_ROW) {
+        sqlite3_reset(stmt);
+        if (rc != SQLITE_DONE) {
+            throw std::runtime_error(std::string("Failed to read ") + spec.name + ": " +
+                                     sqlite3_errmsg(db_));
+        }
+        return std::nullopt;
+    }
+    Row row = read_row(stmt, table, indexes, 0);
+    sqlite3_reset(stmt);
+    return row;
+}
+
+void SqliteEngine::put(Table table, const RowKey& key, const Row& row) {
+    const TableSpec& spec = table_spec(table);
+    if (row.values.size() != spec.columns.size()) {
+        throw std::invalid_argument(std::string("Wrong column count for ") + spec.name);
+    }
+
+    // Upsert rather than INSERT OR REPLACE, which deletes the row first
+    int keys = spec.subkey != nullptr ? 2 : 1;
+    std::string names = key_columns(spec);
+    std::string params = keys == 2 ? "?, ?" : "?";
+    std::string updates;
+    for (const char* column : spec.columns) {
+        names += std::string(", ") + column;
+        params += ", ?";
+        updates += updates.empty() ? "" : ", ";
+        updates += std::string(column) + " = excluded." + column;
+    }
+    sqlite3_stmt* stmt = cached("INSERT INTO " + std::string(spec.name) + " (" + names +
+                                ") VALUES (" + params + ") ON CONFLICT (" + key_columns(spec) +
+                                ") DO UPDATE SET " + updates);
+    bind_key(stmt, spec, key);
+    for (size_t i = 0; i < row.values.size(); ++i) {
+        bind_value(stmt, keys + 1 + static_cast<int>(i), row.values[i]);
+    }
+    step_done(stmt, "write", table);
+}
+
+int64_t SqliteEngine::insert(Table table, const Row& row) {
+    const TableSpec& spec = table_spec(table);
+    if (!spec.auto_id) {
+        throw std::invalid_argument(std::string("Keys of ") + spec.name + " are not assigned");
+    }
+    if (row.values.size() != spec.columns.size()) {
+        throw std::invalid_argument(std::string("Wrong column count for ") + spec.name);
+    }
+
+    std::string names;
+    std::string params;
+    for (const char* column : spec.columns) {
+        names += names.empty() ? "" : ", ";
+        names += column;
+        params += params.empty() ? "?" : ", ?";
+    }
+    sqlite3_stmt* stmt = cached("INSERT INTO " + std::string(spec.name) + " (" + names +
+                                ") VALUES (" + params + ")");
+    for (size_t i = 0; i < row.values.size(); ++i) {
+        bind_value(stmt, 1 + static_cast<int>(i), row.values[i]);
+    }
+    step_done(stmt, "insert into", table);
+    return sqlite3_last_insert_rowid(db_);
+}
+
+bool SqliteEngine::erase(Table table, const RowKey& key) {
+    const TableSpec& spec = table_spec(table);
+    sqlite3_stmt* stmt = cached("DELETE FROM " + std::string(spec.name) + " WHERE " +
+                                key_match(spec));
+    bind_key(stmt, spec, key);
+    return step_done(stmt, "delete from", table) > 0;
+}
+
+size_t SqliteEngine::erase_range(Table table, const KeyRange& range) {
+    const TableSpec& spec = table_spec(table);
+    sqlite3_stmt* stmt = cached("DELETE FROM " + std::string(spec.name) + " WHERE " +
+                                range_match(spec));
+    bind_range(stmt, range);
+    return static_cast<size_t>(step_done(stmt, "delete from", table));
+}
+
+void SqliteEngine::scan(Table table, const KeyRange& range, const Visitor& visit,
+                        const Projection& columns, ScanOrder order)
+{
+    const TableSpec& spec = table_spec(table);
+    auto indexes = column_indexes(spec, columns);
+    std::string direction = order == ScanOrder::kDescending ? " DESC" : "";
+    std::string order_by = std::string(spec.key) + direction;
+    if (spec.subkey != nullptr) {
+        order_by += std::string(", ") + spec.subkey + direction;
+    }
+    std::string values = indexes.empty() ? "" : ", " + select_list(spec, indexes);
+
+    // Own statement: the visitor may run point queries meanwhile
+    ScopedStmt stmt(handle(), "SELECT " + key_columns(spec) + values + " FROM " + spec.name +
+                              " WHERE " + range_match(spec) + " ORDER BY " + order_by);
+    bind_range(stmt.get(), range);
+    visit_rows(stmt.get(), table, indexes, visit);
+}
+
+void SqliteEngine::scan_by(Table table, size_t column, const Visitor& visit,
+                           const Projection& columns, ScanOrder order)
+{
+    const TableSpec& spec = table_spec(table);
+    auto indexes = column_indexes(spec, columns);
+    std::string order_by = std::string(spec.columns.at(column)) +
+                           (order == ScanOrder::kDescending ? " DESC, " : ", ") +
+                           key_columns(spec);
+    std::string values = indexes.empty() ? "" : ", " + select_list(spec, indexes);
+
+    ScopedStmt stmt(handle(), "SELECT " + key_columns(spec) + values + " FROM " + spec.name +
+                              " ORDER BY " + order_by);
+    visit_rows(stmt.get(), table, indexes, visit);
+}
+
+void SqliteEngine::scan_subkey(Table table, int64_t b, const Visitor& visit,
+                               const Projection& columns)
+{
+    const TableSpec& spec = table_spec(table);
+    if (spec.subkey == nullptr) {
+        throw std::invalid_argument(std::string("No second key column in ") + spec.name);
+    }
+    auto indexes = column_indexes(spec, columns);
+    std::string values = indexes.empty() ? "" : ", " + select_list(spec, indexes);
+
+    ScopedStmt stmt(handle(), "SELECT " + key_columns(spec) + values + " FROM " + spec.name +
+                              " WHERE " + spec.subkey + " = ?1 ORDER BY " + key_columns(spec));
+    sqlite3_bind_int64(stmt.get(), 1, b);
+    visit_rows(stmt.get(), table, indexes, visit);
+}
+
+void SqliteEngine::visit_rows(sqlite3_stmt* stmt, Table table,
+                              const std::vector<size_t>& indexes, const Visitor& visit)
+{
+    const TableSpec& spec = table_spec(table);
+    int first = spec.subkey != nullptr ? 2 : 1;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        RowKey key{sqlite3_column_int64(stmt, 0),
+                   spec.subkey != nullptr ? sqlite3_column_int64(stmt, 1) : 0};
+        if (!visit(key, read_row(stmt, table, indexes, first))) {
+            return;
+        }
+    }
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Failed to scan ") + spec.name + ": " +
+                                 sqlite3_errmsg(db_));
+    }
+}
+
+uint64_t SqliteEngine::count_matching(Table table, size_t column, int64_t value) {
+    const TableSpec& spec = table_spec(table);
+    sqlite3_stmt* stmt = cached("SELECT COUNT(*) FROM " + std::string(spec.name) + " WHERE " +
+                                spec.columns.at(column) + " = ?");
+    sqlite3_bind_int64(stmt, 1, value);
+    uint64_t count = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        count = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+    }
+    sqlite3_reset(stmt);
+    return count;
+}
+
+StorageEngine::TableUsage SqliteEngine::usage(Table table, size_t blob_column) {
+    const TableSpec& spec = table_spec(table);
+    sqlite3_stmt* stmt = cached("SELECT COUNT(*), COALESCE(SUM(LENGTH(" +
+                                std::string(spec.columns.at(blob_column)) + ")), 0) FROM " +
+                                spec.name);
+    TableUsage result;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        result.rows = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+        result.bytes = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+    }
+    sqlite3_reset(stmt);
+    return result;
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -0,0 +1,34 @@
+#include "bastionx/storage/StorageEngine.h"
+#include <array>
+
+namespace bastionx {
+namespace storage {
+
+const TableSpec& table_spec(Table table) {
+    // Same order as Table; column names as in VaultService's schema
+    static const std::array<TableSpec, kTableCount> kSpecs = {{
+        {"notes", "id", nullptr,
+         {"nonce", "ciphertext", "alg", "codec", "created_at", "updated_at", "pack_id",
+          "change_seq"}, true},
+        {"note_chunks", "note_id", "seq", {"data"}, false},
+        {"content_chunks", "note_id", "chunk_id", {"nonce", "ciphertext", "alg", "released_by"},
+         false},
+        {"compression_dicts", "dict_id", nullptr,
+         {"nonce", "ciphertext", "alg", "created_at"}, false},
+        {"note_packs", "pack_id", nullptr,
+         {"nonce", "ciphertext", "alg", "codec", "note_count", "created_at"}, true},
+        {"note_revisions", "note_id", "revision_id",
+         {"nonce", "ciphertext", "alg", "codec", "keyframe", "saved_at", "recorded_at"}, false},
+        {"attachment_refs", "note_id", "attachment_id",
+         {"nonce", "ciphertext", "alg", "created_at"}, false},
+        {"attachments", "attachment_id", nullptr,
+         {"nonce", "ciphertext", "alg", "content_id", "header", "size", "chunk_count",
+          "created_at"}, true},
+        {"attachment_chunks", "attachment_id", "seq", {"data"}, false},
+        {"note_changes", "seq", nullptr, {"note_id", "deleted"}, true},
+    }};
+    return kSpecs[static_cast<size_t>(table)];
+}
+
+}  // namespace storage
+}  // namespace bastionx
@@ -6,7 +6,14 @@
 #include <QApplication>
 #include <QCloseEvent>
 #include <QHBoxLayout>
+#include <QInputDialog>
 #include <QMessageBox>
+#include <QScopeGuard>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <vector>
 
 namespace bastionx {
 namespace ui {
@@ -15,6 +22,7 @@ MainWindow::MainWindow(const std::string& vault_path, QWidget* parent)
     : QMainWindow(parent)
 {
     vault_ = std::make_unique<vault::VaultService>(vault_path);
+    async_vault_ = std::make_unique<vault::AsyncVault>(*vault_, eventLoopDispatcher());
 
     // Toolbar
     setupToolbar();
@@ -33,6 +41,10 @@ MainWindow::MainWindow(const std::string& vault_path, QWidget* parent)
             this, &MainWindow::onUnlockRequested);
     connect(unlock_screen_, &UnlockScreen::createRequested,
             this, &MainWindow::onCreateRequested);
+    connect(unlock_screen_, &UnlockScreen::quickUnlockRequested,
+            this, &MainWindow::onQuickUnlockRequested);
+    connect(unlock_screen_, &UnlockScreen::passwordFallbackRequested,
+            this, &MainWindow::onPasswordFallbackRequested);
 
     // Settings from NotesPanel activity bar
     connect(notes_panel_, &NotesPanel::settingsRequested,
@@ -44,6 +56,36 @@ MainWindow::MainWindow(const std::string& vault_path, QWidget* parent)
     connect(inactivity_timer_, &QTimer::timeout,
             this, &MainWindow::onInactivityTimeout);
 
+    // Quick-unlock lifetime timer
+    quick_unlock_timer_ = new QTimer(this);
+    quick_unlock_timer_->setSingleShot(true);
+    connect(quick_unlock_timer_, &QTimer::timeout,
+            this, &MainWindow::onQuickUnlockExpired);
+
+    // Cold-storage packing (background, in small steps)
+    cold_pack_timer_ = new QTimer(this);
+    cold_pack_timer_->setSingleShot(true);
+    connect(cold_pack_timer_, &QTimer::timeout,
+            this, &MainWindow::onColdPackTimeout);
+
+    // Idle-time vault backups
+    backup_timer_ = new QTimer(this);
+    backup_timer_->setSingleShot(true);
+    connect(backup_timer_, &QTimer::timeout,
+            this, &MainWindow::onBackupTimeout);
+
+    // Idle-time WAL checkpoints
+    checkpoint_timer_ = new QTimer(this);
+    checkpoint_timer_->setSingleShot(true);
+    connect(checkpoint_timer_, &QTimer::timeout,
+            this, &MainWindow::onCheckpointTimeout);
+
+    // Idle-time vault maintenance
+    maintenance_timer_ = new QTimer(this);
+    maintenance_timer_->setSingleShot(true);
+    connect(maintenance_timer_, &QTimer::timeout,
+            this, &MainWindow::onMaintenanceTimeout);
+
     // Clipboard guard
     clipboard_guard_ = new ClipboardGuard(this);
 
@@ -80,23 +122,90 @@ void MainWindow::setupToolbar() {
 
 void MainWindow::showUnlockScreen() {
     unlock_screen_->setVaultState(vault_->state());
+    unlock_screen_->setQuickUnlockMode(vault_->quick_unlock_available());
     unlock_screen_->reset();
     stack_->setCurrentIndex(0);
     lock_button_->hide();
     inactivity_timer_->stop();
 }
 
-void MainWindow::showNotesPanel() {
-    repo_ = std::make_unique<storage::NotesRepository>(vault_->vault_path(), &vault_->db_subkey());
-    notes_panel_->loadNotes(repo_.get(), &vault_->notes_subkey());
+util::Task MainWindow::showNotesPanel() {
+    unlock_screen_->setSubmitBusy(true);
+    openStorage();
+    auto session = session_;
+
+    // Settings are read on a worker while the unlock screen stays up (the
+    // vault is busy until they are in, so nothing can lock it meanwhile)
+    std::string json;
+    {
+        vault_busy_ = true;
+        auto release = qScopeGuard([this] { releaseVault(); });  // Even if cancelled
+        try {
+            json = co_await async_vault_->load_settings();
+        } catch (const util::Cancelled&) {
+            throw;
+        } catch (const std::runtime_error&) {
+            // Unreadable settings row: run with the defaults
+        }
+    }
+    if (close_pending_) {
+        co_return;  // Closing once the event loop gets to it
+    }
+    applySettings(json);
+
+    // One-time: train the compression dictionary once the vault is big enough
+    const auto* subkey = &vault_->notes_subkey();
+    storage_->post(storage::AsyncNotesRepository::Kind::kWrite,
+                   [subkey](storage::NotesRepository& repo) {
+                       repo.ensure_compression_dictionary(*subkey);
+                   });
+
+    notes_panel_->loadNotes(storage_.get(), subkey);
     stack_->setCurrentIndex(1);
     lock_button_->show();
-    loadAndApplySettings();
+    backup_ = std::make_unique<vault::VaultBackup>(
+        vault_->vault_path(), vault::VaultBackup::default_backup_dir(vault_->vault_path()),
+        static_cast<size_t>(settings_.backup_keep));
+    maintenance_ = std::make_unique<vault::MaintenanceScheduler>(*vault_);
     resetInactivityTimer();
+
+    if (settings_.cold_pack_enabled) {
+        cold_pack_timer_->start(kColdPackDelayMs);
+    }
+
+    // Then the list and the last edited note. If the vault locks before
+    // the list is in, co_await throws util::Cancelled and this ends there
+    std::vector<storage::NoteSummary> summaries;
+    try {
+        summaries = co_await storage_->run(
+            storage::AsyncNotesRepository::Kind::kSnapshot,
+            [subkey](storage::NotesRepository& repo) { return repo.list_notes(*subkey); },
+            session);
+    } catch (const util::Cancelled&) {
+        throw;
+    } catch (const std::runtime_error& e) {
+        // Anything else escaping a Task would end the app; the vault stays
+        // unlocked and the list fills on the next refresh
+        QMessageBox::warning(this, "Notes Unavailable",
+                             QString("The note list could not be read: %1").arg(e.what()));
+        co_return;
+    }
+    notes_panel_->showNotes(summaries);
+    auto latest = std::max_element(summaries.begin(), summaries.end(),
+                                   [](const auto& a, const auto& b) {
+                                       return a.updated_at < b.updated_at;
+                                   });
+    if (latest != summaries.end()) {
+        notes_panel_->openNote(latest->id);
+    }
+    notes_panel_->prefetchRecent(summaries);  // Runs after the note above
+
+    if (settings_.quick_unlock_enabled && !vault_->quick_unlock_available()) {
+        promptQuickUnlockPin();
+    }
 }
 
-void MainWindow::loadAndApplySettings() {
-    std::string json = vault_->load_settings();
+void MainWindow::applySettings(const std::string& json) {
     if (json.empty()) {
         settings_ = vault::VaultSettings::defaults();
     } else {
@@ -109,19 +218,66 @@ void MainWindow::loadAndApplySettings() {
     // Apply clipboard guard settings
     clipboard_guard_->setEnabled(settings_.clipboard_clear_enabled);
     clipboard_guard_->setClearSeconds(settings_.clipboard_clear_seconds);
+
+    applyRevisionPolicy();
+    applyBackupSettings();
+}
+
+void MainWindow::applyRevisionPolicy() {
+    if (!storage_) {
+        return;
+    }
+    storage::NotesRepository::RevisionPolicy policy;
+    policy.max_age = std::chrono::hours(24) * settings_.revision_keep_days;
+    storage_->post(storage::AsyncNotesRepository::Kind::kWrite,
+                   [policy](storage::NotesRepository& repo) {
+                       repo.set_revision_policy(policy);
+                       try {
+                           repo.prune_revisions();
+                       } catch (const std::runtime_error&) {
+                           // Old revisions stay until the next attempt
+                       }
+                   });
 }
 
 void MainWindow::onUnlockRequested(const QString& password) {
+    unlockVault(password.toStdString());
+}
+
+util::Task MainWindow::unlockVault(std::string password) {
     unlock_screen_->setSubmitBusy(true);
-    QApplication::processEvents();
 
-    bool ok = vault_->unlock(password.toStdString());
+    // Key derivation runs on a worker; the window keeps painting meanwhile
+    bool ok = false;
+    {
+        vault_busy_ = true;
+        auto release = qScopeGuard([this] { releaseVault(); });  // Even if cancelled
+        try {
+            ok = co_await async_vault_->unlock(std::move(password));
+        } catch (const util::Cancelled&) {
+            throw;
+        } catch (const std::runtime_error&) {
+            ok = false;  // Unreadable vault file: reported like a wrong password
+        }
+    }
 
-    if (ok) {
-        showNotesPanel();
-    } else {
+    if (close_pending_) {
+        co_return;  // Closing once the event loop gets to it
+    }
+    if (!ok) {
         unlock_screen_->showError("Wrong password");
         unlock_screen_->setSubmitBusy(false);
+        co_return;
+    }
+    showNotesPanel();
+}
+
+void MainWindow::releaseVault() {
+    vault_busy_ = false;
+    if (close_pending_) {
+        // Closing was held back until the vault was free. Queued: this runs
+        // from a coroutine, possibly while it unwinds
+        QMetaObject::invokeMethod(this, [this] { close(); }, Qt::QueuedConnection);
     }
 }
 
@@ -131,11 +287,29 @@ void MainWindow::onCreateRequested(const QString& password) {
         return;
     }
 
+    createVault(password.toStdString());
+}
+
+util::Task MainWindow::createVault(std::string password) {
     unlock_screen_->setSubmitBusy(true);
-    QApplication::processEvents();
 
-    bool ok = vault_->create(password.toStdString());
+    // Key derivation and the new schema run on a worker
+    bool ok = false;
+    {
+        vault_busy_ = true;
+        auto release = qScopeGuard([this] { releaseVault(); });  // Even if cancelled
+        try {
+            ok = co_await async_vault_->create(std::move(password));
+        } catch (const util::Cancelled&) {
+            throw;
+        } catch (const std::runtime_error&) {
+            ok = false;
+        }
+    }
 
+    if (close_pending_) {
+        co_return;  // Closing once the event loop gets to it
+    }
     if (ok) {
         showNotesPanel();
     } else {
@@ -145,18 +319,266 @@ void MainWindow::onCreateRequested(const QString& password) {
 }
 
 void MainWindow::onLockRequested() {
-    // Clear clipboard if we own it
-    clipboard_guard_->clearNow();
-
-    notes_panel_->prepareForLock();
-    repo_.reset();
+    if (!closeSession()) {
+        reportSaveFailure();
+        return;
+    }
+    quick_unlock_timer_->stop();
     vault_->lock();
     showUnlockScreen();
 }
 
 void MainWindow::onInactivityTimeout() {
-    if (vault_ && vault_->is_unlocked()) {
-        onLockRequested();
+    if (vault_ && vault_->is_unlocked() && !vault_busy_) {
+        // Auto-lock keeps the PIN-wrapped key (if armed); manual lock does not
+        if (!closeSession()) {
+            reportSaveFailure();
+            return;  // Stays unlocked; the next idle period tries again
+        }
+        vault_->quick_lock();
+        showUnlockScreen();
+    }
+}
+
+void MainWindow::onQuickUnlockRequested(const QString& pin) {
+    quickUnlockVault(pin.toStdString());
+}
+
+util::Task MainWindow::quickUnlockVault(std::string pin) {
+    unlock_screen_->setSubmitBusy(true);
+
+    // The PIN's Argon2id run is on a worker too
+    bool ok = false;
+    {
+        vault_busy_ = true;
+        auto release = qScopeGuard([this] { releaseVault(); });  // Even if cancelled
+        try {
+            ok = co_await async_vault_->quick_unlock(std::move(pin));
+        } catch (const util::Cancelled&) {
+            throw;
+        } catch (const std::runtime_error&) {
+            ok = false;  // The PIN key could not be derived: counted as no unlock
+        }
+    }
+
+    if (close_pending_) {
+        co_return;  // Closing once the event loop gets to it
+    }
+    if (ok) {
+        showNotesPanel();
+        co_return;
+    }
+
+    unlock_screen_->setSubmitBusy(false);
+
+    if (vault_->quick_unlock_available()) {
+        unlock_screen_->showError("Wrong PIN");
+    } else {
+        // Attempts exhausted or expired: the wrapped key is gone
+        quick_unlock_timer_->stop();
+        showUnlockScreen();
+        unlock_screen_->showError("Quick unlock disabled, enter master password");
+    }
+}
+
+void MainWindow::onPasswordFallbackRequested() {
+    if (vault_busy_) {
+        return;  // A PIN is being checked
+    }
+    quick_unlock_timer_->stop();
+    vault_->disarm_quick_unlock();
+    showUnlockScreen();
+}
+
+void MainWindow::onQuickUnlockExpired() {
+    if (vault_busy_) {
+        return;  // quick_unlock_available() wipes it once the vault is free
+    }
+    vault_->disarm_quick_unlock();
+    if (!vault_->is_unlocked()) {
+        showUnlockScreen();
+    }
+}
+
+void MainWindow::onColdPackTimeout() {
+    if (!storage_ || !vault_->is_unlocked() || !settings_.cold_pack_enabled) {
+        return;
+    }
+
+    // One pack per step keeps saves from waiting behind it; continue while
+    // work remains. Skipped on lock, like any other read
+    // (notes stay hot; retried after the next unlock)
+    const auto* subkey = &vault_->notes_subkey();
+    auto min_age = std::chrono::hours(24) * settings_.cold_pack_days;
+    storage_->post(storage::AsyncNotesRepository::Kind::kRead,
+                   [subkey, min_age](storage::NotesRepository& repo) {
+                       return repo.pack_cold_notes(*subkey, min_age, 1);
+                   },
+                   [this](size_t packed) {
+                       if (packed > 0) {
+                           cold_pack_timer_->start(kColdPackStepMs);
+                       }
+                   });
+}
+
+void MainWindow::onCheckpointTimeout() {
+    if (!storage_ || !vault_->is_unlocked()) {
+        return;
+    }
+
+    // PASSIVE unless the WAL has grown large; runs again after the next input.
+    // Through the writer, so on the storage thread; skipped on lock, which
+    // truncates regardless
+    auto* pool = &vault_->connection_pool();
+    storage_->post(storage::AsyncNotesRepository::Kind::kRead,
+                   [pool](storage::NotesRepository&) {
+                       try {
+                           pool->checkpoints().run_idle();
+                       } catch (const std::runtime_error&) {
+                           // Retried at the next idle moment
+                       }
+                   });
+}
+
+void MainWindow::onMaintenanceTimeout() {
+    if (!maintenance_ || !vault_->is_unlocked()) {
+        return;
+    }
+
+    // Off the GUI thread (a quick_check step can take seconds) until the
+    // due tasks are done or input pauses it
+    maintenance_->resume();
+}
+
+void MainWindow::applyBackupSettings() {
+    if (!backup_) {
+        return;
+    }
+    backup_->set_keep(static_cast<size_t>(settings_.backup_keep));
+    if (!settings_.backup_enabled) {
+        backup_timer_->stop();
+        backup_->cancel();
+    } else {
+        scheduleBackup(kBackupIdleMs);
+    }
+}
+
+void MainWindow::scheduleBackup(int delay_ms) {
+    if (backup_ && settings_.backup_enabled && vault_->is_unlocked() && !vault_busy_) {
+        backup_timer_->start(delay_ms);
+    }
+}
+
+void MainWindow::onBackupTimeout() {
+    if (!backup_ || !vault_->is_unlocked() || !settings_.backup_enabled) {
+        return;
+    }
+
+    try {
+        if (!backup_->in_progress()) {
+            auto snapshots = backup_->snapshots();
+            auto interval = std::chrono::hours(settings_.backup_interval_hours);
+            auto age = std::chrono::system_clock::now() -
+                       (snapshots.empty() ? std::chrono::system_clock::time_point{}
+                                          : snapshots.back().created);
+            if (age < interval) {
+                // Not due yet; look again when it is (or after the next input)
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::min<std::chrono::system_clock::duration>(interval - age, interval));
+                scheduleBackup(static_cast<int>(wait.count()) + kBackupIdleMs);
+                return;
+            }
+            backup_->start(vault_->db_subkey(), vault_->connection_profile());
+        }
+
+        switch (backup_->step()) {
+            case vault::VaultBackup::StepResult::kMore:
+                scheduleBackup(kBackupStepMs);
+                break;
+            case vault::VaultBackup::StepResult::kBusy:
+                scheduleBackup(kBackupIdleMs);  // A save holds the vault; back off
+                break;
+            case vault::VaultBackup::StepResult::kDone:
+                scheduleBackup(kBackupIdleMs);  // Re-arms for the next interval
+                break;
+        }
+    } catch (const std::runtime_error&) {
+        backup_->cancel();  // Retried after the next idle period
+    }
+}
+
+void MainWindow::promptQuickUnlockPin() {
+    bool ok = false;
+    QString pin = QInputDialog::getText(
+        this, "Quick Unlock",
+        QString("Choose a PIN (at least %1 characters) to re-unlock after auto-lock.\n"
+                "It expires after %2 minutes or %3 wrong attempts.")
+            .arg(vault::VaultService::QUICK_UNLOCK_MIN_PIN_LENGTH)
+            .arg(settings_.quick_unlock_minutes)
+            .arg(vault::VaultService::QUICK_UNLOCK_MAX_ATTEMPTS),
+        QLineEdit::Password, QString(), &ok);
+    if (!ok || pin.isEmpty()) {
+        return;
+    }
+
+    try {
+        auto lifetime = std::chrono::minutes(settings_.quick_unlock_minutes);
+        vault_->arm_quick_unlock(pin.toStdString(), lifetime);
+        quick_unlock_timer_->start(
+            static_cast<int>(std::chrono::milliseconds(lifetime).count()));
+    } catch (const std::invalid_argument&) {
+        QMessageBox::warning(this, "Quick Unlock", "PIN is too short.");
+    }
+}
+
+bool MainWindow::closeSession(bool discard_unsaved) {
+    // Unsaved edits first: if they cannot be written, the session stays
+    if (!notes_panel_->prepareForLock(discard_unsaved)) {
+        return false;
+    }
+
+    // Clear clipboard if we own it
+    clipboard_guard_->clearNow();
+
+    cold_pack_timer_->stop();
+    backup_timer_->stop();
+    checkpoint_timer_->stop();
+    maintenance_timer_->stop();
+    backup_.reset();  // Drops a partial snapshot
+    maintenance_.reset();  // Interrupts and joins it; unfinished tasks rerun later
+    closeStorage();  // The pool itself closes when the vault locks
+    return true;
+}
+
+void MainWindow::reportSaveFailure() {
+    QMessageBox::warning(this, "Save Failed",
+                         "Your changes could not be written to the vault, so it stays "
+                         "unlocked with your notes open. Free some disk space or check "
+                         "the vault file, then try again.");
+}
+
+util::Dispatcher MainWindow::eventLoopDispatcher() {
+    return [this](std::function<void()> callback) {
+        QMetaObject::invokeMethod(this, std::move(callback), Qt::QueuedConnection);
+    };
+}
+
+void MainWindow::openStorage() {
+    // Callbacks come back through the event loop; none is delivered once
+    // closeStorage() has returned. Lists and searches run on pool readers
+    storage_ = std::make_unique<storage::AsyncNotesRepository>(
+        vault_->connection_pool(), eventLoopDispatcher());
+    session_ = vault_->session_token();
+}
+
+void MainWindow::closeStorage() {
+    // Ends the session's coroutines even if the vault stays unlocked (a
+    // password change); the vault hands out a fresh token afterwards
+    session_.cancel();
+    if (storage_) {
+        // Queued loads and searches are dropped; queued saves are written
+        storage_->close(storage::AsyncNotesRepository::CloseMode::kCancelReads);
+        storage_.reset();
     }
 }
 
@@ -173,6 +595,12 @@ void MainWindow::onSettingsRequested() {
 }
 
 void MainWindow::onSettingsChanged(const vault::VaultSettings& settings) {
+    if (vault_busy_) {
+        QMessageBox::warning(this, "Settings Not Saved",
+                             "The password is still being changed; save the settings "
+                             "again once it is done.");
+        return;
+    }
     settings_ = settings;
     vault_->save_settings(settings_.to_json());
 
@@ -180,38 +608,103 @@ void MainWindow::onSettingsChanged(const vault::VaultSettings& settings) {
     clipboard_guard_->setEnabled(settings_.clipboard_clear_enabled);
     clipboard_guard_->setClearSeconds(settings_.clipboard_clear_seconds);
     resetInactivityTimer();
+    applyRevisionPolicy();
+    applyBackupSettings();
+
+    if (!settings_.cold_pack_enabled) {
+        cold_pack_timer_->stop();
+    } else if (!cold_pack_timer_->isActive()) {
+        cold_pack_timer_->start(kColdPackDelayMs);
+    }
+
+    if (!settings_.quick_unlock_enabled) {
+        quick_unlock_timer_->stop();
+        vault_->disarm_quick_unlock();
+    } else if (!vault_->quick_unlock_available()) {
+        promptQuickUnlockPin();
+    }
 }
 
 void MainWindow::onPasswordChangeRequested(const QString& current_pw,
                                            const QString& new_pw) {
-    // Close repo before password change (re-encryption needs exclusive DB access)
-    notes_panel_->prepareForLock();
-    repo_.reset();
-
-    QApplication::processEvents();
+    if (vault_busy_) {
+        return;  // A change is already running
+    }
+    changePassword(current_pw.toStdString(), new_pw.toStdString());
+}
 
-    bool ok = vault_->change_password(current_pw.toStdString(), new_pw.toStdString());
+util::Task MainWindow::changePassword(std::string current_pw, std::string new_pw) {
+    // Let go of the repo before password change; the vault closes its pool
+    // (re-encryption needs exclusive DB access)
+    if (!notes_panel_->prepareForLock()) {
+        reportSaveFailure();
+        co_return;
+    }
+    backup_timer_->stop();
+    checkpoint_timer_->stop();
+    maintenance_timer_->stop();
+    if (backup_) {
+        backup_->cancel();
+    }
+    maintenance_.reset();
+    closeStorage();
+    inactivity_timer_->stop();  // Nothing may lock the vault meanwhile
+
+    // Re-encryption runs on a worker; input restarts no timer until it is done
+    bool ok = false;
+    QString failure = "Current password is incorrect.";
+    {
+        vault_busy_ = true;
+        auto release = qScopeGuard([this] { releaseVault(); });  // Even if cancelled
+        try {
+            ok = co_await async_vault_->change_password(std::move(current_pw),
+                                                        std::move(new_pw));
+        } catch (const util::Cancelled&) {
+            throw;
+        } catch (const std::runtime_error& e) {
+            // Rolled back: the vault keeps the old password
+            failure = QString("The password could not be changed: %1").arg(e.what());
+        }
+    }
+    if (close_pending_) {
+        co_return;  // Closing once the event loop gets to it
+    }
+    maintenance_ = std::make_unique<vault::MaintenanceScheduler>(*vault_);
+    resetInactivityTimer();
 
     if (ok) {
         QMessageBox::information(this, "Password Changed",
                                  "Your master password has been changed successfully.");
         // Reopen repo with new subkey (db_subkey also changed)
-        repo_ = std::make_unique<storage::NotesRepository>(vault_->vault_path(), &vault_->db_subkey());
-        notes_panel_->loadNotes(repo_.get(), &vault_->notes_subkey());
+        openStorage();
+        notes_panel_->loadNotes(storage_.get(), &vault_->notes_subkey());
+        notes_panel_->refreshList();
+
+        // The old PIN-wrapped key was discarded with the old master key
+        quick_unlock_timer_->stop();
+        if (settings_.quick_unlock_enabled) {
+            promptQuickUnlockPin();
+        }
     } else {
-        QMessageBox::warning(this, "Password Change Failed",
-                             "Current password is incorrect.");
+        QMessageBox::warning(this, "Password Change Failed", failure);
         // Reopen repo with existing subkey
-        repo_ = std::make_unique<storage::NotesRepository>(vault_->vault_path(), &vault_->db_subkey());
-        notes_panel_->loadNotes(repo_.get(), &vault_->notes_subkey());
+        openStorage();
+        notes_panel_->loadNotes(storage_.get(), &vault_->notes_subkey());
+        notes_panel_->refreshList();
     }
 }
 
 void MainWindow::resetInactivityTimer() {
-    if (vault_ && vault_->is_unlocked()) {
+    if (vault_ && vault_->is_unlocked() && !vault_busy_) {
         int timeout_ms = settings_.auto_lock_minutes * 60 * 1000;
         inactivity_timer_->start(timeout_ms);
+        checkpoint_timer_->start(kCheckpointIdleMs);
+        if (maintenance_) {
+            maintenance_->pause();
+            maintenance_timer_->start(kMaintenanceIdleMs);
+        }
     }
+    scheduleBackup(kBackupIdleMs);
 }
 
 bool MainWindow::eventFilter(QObject* obj, QEvent* event) {
@@ -229,11 +722,26 @@ bool MainWindow::eventFilter(QObject* obj, QEvent* event) {
 }
 
 void MainWindow::closeEvent(QCloseEvent* event) {
-    if (vault_ && vault_->is_unlocked()) {
-        clipboard_guard_->clearNow();
-        notes_panel_->prepareForLock();
-        repo_.reset();
-        vault_->lock();
+    if (vault_busy_) {
+        // A worker is inside the vault; close once it is done
+        close_pending_ = true;
+        event->ignore();
+        return;
+    }
+    if (vault_ && vault_->is_unlocked() && !closeSession()) {
+        // Nothing queued is lost on exit unless the user says so
+        auto choice = QMessageBox::question(
+            this, "Quit Without Saving?",
+            "Quit anyway and lose the changes that could not be saved?",
+            QMessageBox::Discard | QMessageBox::Cancel, QMessageBox::Cancel);
+        if (choice != QMessageBox::Discard) {
+            event->ignore();
+            return;
+        }
+        closeSession(true);
+    }
+    if (vault_) {
+        vault_->lock();  // Also destroys any PIN-wrapped key
     }
     event->accept();
 }
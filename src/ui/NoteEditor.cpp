@@ -3,6 +3,7 @@
 #include "bastionx/ui/TagsWidget.h"
 #include "bastionx/ui/FindBar.h"
 #include "bastionx/ui/UIConstants.h"
+#include "SecureText.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMessageBox>
@@ -107,8 +108,8 @@ void NoteEditor::loadNote(const storage::Note& note) {
     body_input_->blockSignals(true);
 
     current_note_id_ = note.id;
-    title_input_->setText(QString::fromStdString(note.title));
-    body_input_->setMarkdown(QString::fromStdString(note.body));
+    title_input_->setText(toQString(note.title));
+    body_input_->setMarkdown(toQString(note.body));
     tags_widget_->setTags(note.tags);
 
     title_input_->blockSignals(false);
@@ -119,25 +120,39 @@ void NoteEditor::loadNote(const storage::Note& note) {
 }
 
 bool NoteEditor::saveCurrentNote() {
-    if (current_note_id_ == 0 || !repo_ || !subkey_ || !modified_) {
+    if (current_note_id_ == 0 || !storage_ || !subkey_ || !modified_) {
         return false;
     }
 
     storage::Note note;
     note.id = current_note_id_;
-    note.title = title_input_->text().toStdString();
-    note.body = body_input_->toMarkdown().toStdString();
+    note.title = toSecureString(title_input_->text());
+    note.body = toSecureString(body_input_->toMarkdown());
     note.tags = tags_widget_->tags();
 
-    bool ok = repo_->update_note(note, *subkey_);
-    if (ok) {
-        setModified(false);
-    }
-    return ok;
+    // Written with other queued saves by NotesPanel's flush. Still
+    // modified until the repository holds the save, and afterwards too if
+    // it was edited (or another note loaded) meanwhile
+    const auto* subkey = subkey_;
+    uint64_t edits = edits_;
+    storage_->post(storage::AsyncNotesRepository::Kind::kWrite,
+                   [note = std::move(note), subkey](storage::NotesRepository& repo) {
+                       repo.queue_update(note, *subkey);
+                   },
+                   [this, edits]() {
+                       if (edits == edits_) {
+                           setModified(false);
+                           emit noteSaved();
+                       }
+                   },
+                   [this](const std::string&) {
+                       autosave_timer_->start(kAutoSaveDelayMs);  // Try again
+                   });
+    return true;
 }
 
-void NoteEditor::setBackend(storage::NotesRepository* repo, const crypto::SecureKey* subkey) {
-    repo_ = repo;
+void NoteEditor::setBackend(storage::AsyncNotesRepository* storage, const crypto::SecureKey* subkey) {
+    storage_ = storage;
     subkey_ = subkey;
 }
 
@@ -158,7 +173,7 @@ void NoteEditor::clearEditor() {
     tags_widget_->clear();
     find_bar_->hideBar();
     current_note_id_ = 0;
-    modified_ = false;
+    setModified(false);
 
     title_input_->blockSignals(false);
     body_input_->blockSignals(false);
@@ -239,13 +254,11 @@ void NoteEditor::onContentChanged() {
 }
 
 void NoteEditor::onAutoSave() {
-    if (saveCurrentNote()) {
-        emit noteSaved();
-    }
+    saveCurrentNote();  // noteSaved once the repository holds it
 }
 
 void NoteEditor::onDeleteClicked() {
-    if (current_note_id_ == 0 || !repo_) return;
+    if (current_note_id_ == 0 || !storage_) return;
 
     auto result = QMessageBox::warning(
         this,
@@ -257,7 +270,12 @@ void NoteEditor::onDeleteClicked() {
 
     if (result == QMessageBox::Yes) {
         int64_t id = current_note_id_;
-        repo_->delete_note(id);
+        const auto* subkey = subkey_;
+        // Queued ahead of the list refresh noteDeleted triggers
+        storage_->post(storage::AsyncNotesRepository::Kind::kWrite,
+                       [id, subkey](storage::NotesRepository& repo) {
+                           repo.delete_note(id, *subkey);
+                       });
         clearEditor();
         emit noteDeleted(id);
     }
@@ -265,6 +283,7 @@ void NoteEditor::onDeleteClicked() {
 
 void NoteEditor::setModified(bool modified) {
     modified_ = modified;
+    ++edits_;
 }
 
 void NoteEditor::setEditorEnabled(bool enabled) {
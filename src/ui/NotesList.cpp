@@ -28,12 +28,15 @@ void NotesList::setupUi() {
     layout->addWidget(new_button_);
 
     list_widget_ = new QListWidget(this);
+    list_widget_->setMouseTracking(true);  // itemEntered on hover
     layout->addWidget(list_widget_);
 
     connect(new_button_, &QPushButton::clicked,
             this, &NotesList::newNoteRequested);
     connect(list_widget_, &QListWidget::itemClicked,
             this, &NotesList::onItemClicked);
+    connect(list_widget_, &QListWidget::itemEntered,
+            this, &NotesList::onItemEntered);
     connect(filter_input_, &QLineEdit::textChanged,
             this, &NotesList::onFilterChanged);
 }
@@ -92,6 +95,10 @@ void NotesList::onItemClicked(QListWidgetItem* item) {
     emit noteSelected(id);
 }
 
+void NotesList::onItemEntered(QListWidgetItem* item) {
+    emit noteHovered(item->data(Qt::UserRole).toLongLong());
+}
+
 void NotesList::onFilterChanged(const QString& text) {
     for (int i = 0; i < list_widget_->count(); ++i) {
         auto* item = list_widget_->item(i);
@@ -5,13 +5,70 @@
 #include "bastionx/ui/SearchPanel.h"
 #include "bastionx/ui/TabBar.h"
 #include "bastionx/ui/StatusBar.h"
+#include "SecureText.h"
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QRegularExpression>
+#include <QStringDecoder>
+#include <algorithm>
+#include <memory>
 
 namespace bastionx {
 namespace ui {
 
+using Kind = storage::AsyncNotesRepository::Kind;
+
+namespace {
+
+// A note read on the storage thread for a new tab. The body is decoded
+// there too; whichever thread drops the last reference wipes it, so a
+// load cancelled by locking leaves no plaintext behind
+struct LoadedNote {
+    std::optional<storage::Note> note;
+    QString body;
+
+    ~LoadedNote() { body.fill(QChar(0)); }
+};
+
+// Read a note for a tab: on the storage thread, decoding the body into a
+// QString chunk by chunk (large notes never exist as one decrypted UTF-8
+// copy)
+std::shared_ptr<LoadedNote> loadNote(storage::NotesRepository& repo, int64_t note_id,
+                                     const crypto::SecureKey& subkey) {
+    auto loaded = std::make_shared<LoadedNote>();
+    QStringDecoder decoder(QStringDecoder::Utf8);
+    loaded->note = repo.read_note_streamed(note_id, subkey, [&](std::string_view piece) {
+        loaded->body += decoder.decode(
+            QByteArrayView(piece.data(), static_cast<qsizetype>(piece.size())));
+    });
+    return loaded;
+}
+
+// Read a note speculatively: only if its body is inline (under
+// kChunkedBodyThresholdBytes), so a prefetch never decrypts a large body
+// or builds its document on the GUI thread. Chunked notes load on open
+std::shared_ptr<LoadedNote> prefetchNote(storage::NotesRepository& repo, int64_t note_id,
+                                         const crypto::SecureKey& subkey) {
+    auto loaded = std::make_shared<LoadedNote>();
+    loaded->note = repo.read_note_if_inline(note_id, subkey);
+    if (loaded->note.has_value()) {
+        loaded->body = toQString(loaded->note->body);
+        loaded->note->body = crypto::SecureString();
+    }
+    return loaded;
+}
+
+// Per-tab document with the Markdown body (the body is wiped)
+QTextDocument* makeDocument(QString& body) {
+    auto* doc = new QTextDocument();
+    doc->setMarkdown(body);
+    body.fill(QChar(0));
+    body.clear();
+    return doc;
+}
+
+}  // namespace
+
 NotesPanel::NotesPanel(QWidget* parent)
     : QWidget(parent)
 {
@@ -55,6 +112,8 @@ NotesPanel::NotesPanel(QWidget* parent)
     // Sidebar -> open note in tab
     connect(sidebar_, &Sidebar::noteSelected,
             this, &NotesPanel::onNoteSelected);
+    connect(sidebar_, &Sidebar::noteHovered,
+            this, &NotesPanel::onNoteHovered);
     connect(sidebar_, &Sidebar::newNoteRequested,
             this, &NotesPanel::onNewNoteRequested);
     connect(sidebar_, &Sidebar::settingsRequested,
@@ -79,26 +138,40 @@ NotesPanel::NotesPanel(QWidget* parent)
     // Track content changes for tab modified indicator
     connect(note_editor_, &NoteEditor::contentChanged,
             this, &NotesPanel::onEditorContentChanged);
+
+    // Group commit of queued saves
+    flush_timer_ = new QTimer(this);
+    flush_timer_->setSingleShot(true);
+    connect(flush_timer_, &QTimer::timeout,
+            this, &NotesPanel::onFlushTimeout);
+
+    // Prefetch a row the pointer rests on (not every row it crosses)
+    hover_timer_ = new QTimer(this);
+    hover_timer_->setSingleShot(true);
+    connect(hover_timer_, &QTimer::timeout,
+            this, &NotesPanel::onHoverTimeout);
 }
 
-void NotesPanel::loadNotes(storage::NotesRepository* repo, const crypto::SecureKey* subkey) {
-    repo_ = repo;
+void NotesPanel::loadNotes(storage::AsyncNotesRepository* storage, const crypto::SecureKey* subkey) {
+    storage_ = storage;
     subkey_ = subkey;
-    note_editor_->setBackend(repo, subkey);
+    note_editor_->setBackend(storage, subkey);
     status_bar_->setEncryptionIndicator(true);
-    refreshList();
 }
 
-void NotesPanel::prepareForLock() {
-    // Save all modified open notes
+bool NotesPanel::prepareForLock(bool discard_unsaved) {
+    // Save all modified open notes, in one transaction
     for (auto& [id, open_note] : open_notes_) {
-        if (open_note.modified && repo_ && subkey_) {
+        if (open_note.modified && storage_ && subkey_) {
             if (id == active_note_id_) {
                 cacheCurrentEditorState();
             }
-            repo_->update_note(open_note.note, *subkey_);
+            queueSave(open_note.note);
         }
     }
+    if (!flushPendingSaves() && !discard_unsaved) {
+        return false;  // Keep every tab: nothing may be lost to the lock
+    }
 
     note_editor_->clearEditor();
     tab_bar_->closeAllTabs();
@@ -109,13 +182,18 @@ void NotesPanel::prepareForLock() {
         open_note.document = nullptr;
     }
     open_notes_.clear();
+    loading_notes_.clear();
+    hover_timer_->stop();
+    hovered_note_id_ = 0;
+    clearPrefetched();
     active_note_id_ = 0;
     sidebar_->notesList()->clear();
     sidebar_->searchPanel()->clear();
     status_bar_->clear();
     note_editor_->setBackend(nullptr, nullptr);
-    repo_ = nullptr;
+    storage_ = nullptr;
     subkey_ = nullptr;
+    return true;
 }
 
 void NotesPanel::onNoteSelected(int64_t note_id) {
@@ -123,7 +201,7 @@ void NotesPanel::onNoteSelected(int64_t note_id) {
 }
 
 void NotesPanel::onNewNoteRequested() {
-    if (!repo_ || !subkey_) return;
+    if (!storage_ || !subkey_) return;
 
     // Save current note before creating new one
     if (active_note_id_ > 0) {
@@ -134,14 +212,22 @@ void NotesPanel::onNewNoteRequested() {
         }
     }
 
-    storage::Note blank;
-    blank.title = "";
-    blank.body = "";
-    int64_t new_id = repo_->create_note(blank, *subkey_);
-
-    refreshList();
-    openNoteInTab(new_id);
-    sidebar_->notesList()->selectNote(new_id);
+    const auto* subkey = subkey_;
+    storage_->post(Kind::kWrite,
+                   [subkey](storage::NotesRepository& repo) {
+                       storage::Note blank;
+                       blank.title = "";
+                       blank.body = "";
+                       return repo.create_note(blank, *subkey);
+                   },
+                   [this](int64_t new_id) {
+                       refreshList();
+                       openNoteInTab(new_id);
+                       sidebar_->notesList()->selectNote(new_id);
+                   },
+                   [this](const std::string&) {
+                       status_bar_->setSaveState("Could not create note");
+                   });
 }
 
 void NotesPanel::onTabSelected(int64_t note_id) {
@@ -155,11 +241,12 @@ void NotesPanel::onTabCloseRequested(int64_t note_id) {
 
     auto it = open_notes_.find(note_id);
     if (it != open_notes_.end()) {
-        if (it->second.modified && repo_ && subkey_) {
+        if (it->second.modified && storage_ && subkey_) {
             if (note_id == active_note_id_) {
                 cacheCurrentEditorState();
             }
-            repo_->update_note(it->second.note, *subkey_);
+            queueSave(it->second.note);
+            scheduleFlush();
         }
         // Store document pointer for later deletion
         doc_to_delete = it->second.document;
@@ -181,7 +268,7 @@ void NotesPanel::onTabCloseRequested(int64_t note_id) {
             auto jt = open_notes_.find(active_note_id_);
             if (jt != open_notes_.end()) {
                 note_editor_->setDocument(jt->second.document);
-                note_editor_->setTitle(QString::fromStdString(jt->second.note.title));
+                note_editor_->setTitle(toQString(jt->second.note.title));
                 note_editor_->setTags(jt->second.note.tags);
                 status_bar_->setSaveState(jt->second.modified ? "Modified" : "Saved");
                 updateStatusBar();
@@ -192,7 +279,9 @@ void NotesPanel::onTabCloseRequested(int64_t note_id) {
     // CRITICAL FIX: Delete document AFTER all editor operations are complete
     delete doc_to_delete;
 
-    refreshList();
+    if (!flush_timer_->isActive()) {
+        refreshList();  // Otherwise refreshed once the save is written
+    }
 }
 
 void NotesPanel::onNoteSaved() {
@@ -200,8 +289,8 @@ void NotesPanel::onNoteSaved() {
         auto it = open_notes_.find(active_note_id_);
         if (it != open_notes_.end()) {
             it->second.modified = false;
-            it->second.note.title = note_editor_->currentTitle().toStdString();
-            it->second.note.body = note_editor_->currentBody().toStdString();
+            it->second.note.title = toSecureString(note_editor_->currentTitle());
+            it->second.note.body = toSecureString(note_editor_->currentBody());
             it->second.note.tags = note_editor_->currentTags();
         }
 
@@ -209,10 +298,56 @@ void NotesPanel::onNoteSaved() {
         tab_bar_->setTabTitle(active_note_id_, note_editor_->currentTitle());
         status_bar_->setSaveState("Saved");
     }
-    refreshList();
+    scheduleFlush();  // The list is refreshed once the save is written
+}
+
+void NotesPanel::scheduleFlush() {
+    // Not restarted by later saves, so none waits longer than the window
+    if (!flush_timer_->isActive()) {
+        flush_timer_->start(kWriteWindowMs);
+    }
+}
+
+void NotesPanel::queueSave(const storage::Note& note) {
+    dropPrefetched(note.id);
+    const auto* subkey = subkey_;
+    storage_->post(Kind::kWrite, [note, subkey](storage::NotesRepository& repo) {
+        repo.queue_update(note, *subkey);
+    });
+}
+
+bool NotesPanel::flushPendingSaves() {
+    flush_timer_->stop();
+    if (!storage_) {
+        return true;
+    }
+    try {
+        // Queued behind every save posted so far
+        storage_->submit(Kind::kWrite, [](storage::NotesRepository& repo) {
+            return repo.flush_writes();
+        }).get();
+    } catch (const std::exception&) {
+        status_bar_->setSaveState("Save failed");
+        return false;
+    }
+    return true;
+}
+
+void NotesPanel::onFlushTimeout() {
+    if (!storage_) return;
+
+    storage_->post(Kind::kWrite,
+                   [](storage::NotesRepository& repo) { return repo.flush_writes(); },
+                   [this](size_t) { refreshList(); },
+                   [this](const std::string&) {
+                       // Still queued; retried at the next window and before locking
+                       status_bar_->setSaveState("Save failed");
+                       scheduleFlush();
+                   });
 }
 
 void NotesPanel::onNoteDeleted(int64_t note_id) {
+    dropPrefetched(note_id);
     auto it = open_notes_.find(note_id);
     if (it != open_notes_.end()) {
         delete it->second.document;
@@ -230,7 +365,7 @@ void NotesPanel::onNoteDeleted(int64_t note_id) {
             auto jt = open_notes_.find(active_note_id_);
             if (jt != open_notes_.end()) {
                 note_editor_->setDocument(jt->second.document);
-                note_editor_->setTitle(QString::fromStdString(jt->second.note.title));
+                note_editor_->setTitle(toQString(jt->second.note.title));
                 note_editor_->setTags(jt->second.note.tags);
                 status_bar_->setSaveState(jt->second.modified ? "Modified" : "Saved");
                 updateStatusBar();
@@ -253,19 +388,46 @@ void NotesPanel::onEditorContentChanged() {
 }
 
 void NotesPanel::onSearchRequested(const QString& query) {
-    if (!repo_ || !subkey_) return;
-    auto results = repo_->search_notes(*subkey_, query.toStdString());
-    sidebar_->searchPanel()->setResults(results);
+    if (!storage_ || !subkey_) return;
+
+    uint64_t seq = ++search_seq_;
+    const auto* subkey = subkey_;
+    storage_->post(Kind::kSnapshot,
+                   [subkey, text = query.toStdString()](storage::NotesRepository& repo) {
+                       return repo.search_notes(*subkey, text);
+                   },
+                   [this, seq](std::vector<storage::NoteSummary> results) {
+                       if (seq == search_seq_) {
+                           sidebar_->searchPanel()->setResults(results);
+                       }
+                   });
 }
 
 void NotesPanel::refreshList() {
-    if (!repo_ || !subkey_) return;
-    auto summaries = repo_->list_notes(*subkey_);
+    if (!storage_ || !subkey_) return;
+    uint64_t seq = ++list_seq_;
+    const auto* subkey = subkey_;
+    storage_->post(Kind::kSnapshot,
+                   [subkey](storage::NotesRepository& repo) { return repo.list_notes(*subkey); },
+                   [this, seq](std::vector<storage::NoteSummary> summaries) {
+                       if (seq == list_seq_) {
+                           sidebar_->notesList()->setSummaries(summaries);
+                       }
+                   });
+}
+
+void NotesPanel::showNotes(const std::vector<storage::NoteSummary>& summaries) {
+    ++list_seq_;  // Newer than any list still being read
     sidebar_->notesList()->setSummaries(summaries);
 }
 
+void NotesPanel::openNote(int64_t note_id) {
+    openNoteInTab(note_id);
+    sidebar_->notesList()->selectNote(note_id);
+}
+
 void NotesPanel::openNoteInTab(int64_t note_id) {
-    if (!repo_ || !subkey_) return;
+    if (!storage_ || !subkey_) return;
 
     // If already open, just switch to it
     if (tab_bar_->hasTab(note_id)) {
@@ -276,31 +438,131 @@ void NotesPanel::openNoteInTab(int64_t note_id) {
         return;
     }
 
-    // Cache current editor before switching
+    // Prefetched while the pointer rested on its row: nothing to read
+    auto prefetched = std::find_if(prefetched_.begin(), prefetched_.end(),
+                                   [note_id](const auto& p) { return p.id == note_id; });
+    if (prefetched != prefetched_.end()) {
+        auto note = std::move(prefetched->note);
+        auto* doc = prefetched->document;
+        prefetched_.erase(prefetched);
+        showLoadedNote(note_id, std::move(note), doc);
+        return;
+    }
+
+    if (!loading_notes_.insert(note_id).second) {
+        return;  // Already being read
+    }
+
+    const auto* subkey = subkey_;
+    storage_->post(Kind::kRead,
+                   [note_id, subkey](storage::NotesRepository& repo) {
+                       return loadNote(repo, note_id, *subkey);
+                   },
+                   [this, note_id](std::shared_ptr<LoadedNote> loaded) {
+                       loading_notes_.erase(note_id);
+                       // No note: a chunk failed to verify (the partial body
+                       // is wiped with `loaded`)
+                       if (loaded->note.has_value() && storage_ && !tab_bar_->hasTab(note_id)) {
+                           showLoadedNote(note_id, std::move(*loaded->note),
+                                          makeDocument(loaded->body));
+                       }
+                   },
+                   [this, note_id](const std::string&) { loading_notes_.erase(note_id); });
+}
+
+void NotesPanel::prefetchRecent(const std::vector<storage::NoteSummary>& summaries) {
+    if (!storage_ || !subkey_) return;
+
+    const auto* subkey = subkey_;
+    size_t count = std::min(summaries.size(), kWarmPrefetchNotes);
+    for (size_t i = 0; i < count; ++i) {
+        int64_t note_id = summaries[i].id;
+        storage_->post(Kind::kPrefetch, [note_id, subkey](storage::NotesRepository& repo) {
+            repo.prefetch_note(note_id, *subkey);
+        });
+    }
+}
+
+void NotesPanel::onNoteHovered(int64_t note_id) {
+    hovered_note_id_ = note_id;
+    hover_timer_->start(kHoverPrefetchDelayMs);
+}
+
+void NotesPanel::onHoverTimeout() {
+    prefetchForOpen(hovered_note_id_);
+}
+
+void NotesPanel::prefetchForOpen(int64_t note_id) {
+    if (!storage_ || !subkey_ || note_id == 0) return;
+    if (tab_bar_->hasTab(note_id) || loading_notes_.count(note_id) > 0) return;
+    if (std::any_of(prefetched_.begin(), prefetched_.end(),
+                    [note_id](const auto& p) { return p.id == note_id; })) {
+        return;
+    }
+
+    // Read (and decode) when the storage thread is idle; the document is
+    // built only if the pointer is still on the row by then. Chunked notes
+    // come back empty and are left to openNoteInTab()
+    const auto* subkey = subkey_;
+    storage_->post(Kind::kPrefetch,
+                   [note_id, subkey](storage::NotesRepository& repo) {
+                       return prefetchNote(repo, note_id, *subkey);
+                   },
+                   [this, note_id](std::shared_ptr<LoadedNote> loaded) {
+                       if (!loaded->note.has_value() || !storage_ ||
+                           note_id != hovered_note_id_ || tab_bar_->hasTab(note_id) ||
+                           loading_notes_.count(note_id) > 0) {
+                           return;
+                       }
+                       dropPrefetched(note_id);
+                       if (prefetched_.size() >= kMaxPrefetchedNotes) {
+                           delete prefetched_.front().document;
+                           prefetched_.erase(prefetched_.begin());
+                       }
+                       prefetched_.push_back(PrefetchedNote{
+                           note_id, std::move(*loaded->note), makeDocument(loaded->body)});
+                   });
+}
+
+void NotesPanel::dropPrefetched(int64_t note_id) {
+    auto it = std::find_if(prefetched_.begin(), prefetched_.end(),
+                           [note_id](const auto& p) { return p.id == note_id; });
+    if (it != prefetched_.end()) {
+        delete it->document;
+        prefetched_.erase(it);
+    }
+}
+
+void NotesPanel::clearPrefetched() {
+    for (auto& prefetched : prefetched_) {
+        delete prefetched.document;
+    }
+    prefetched_.clear();
+}
+
+void NotesPanel::showLoadedNote(int64_t note_id, storage::Note note, QTextDocument* doc) {
+    // Cache current editor before switching (it may have changed while
+    // the note was being read)
     if (active_note_id_ > 0) {
         cacheCurrentEditorState();
     }
 
-    // Load note from DB
-    auto note = repo_->read_note(note_id, *subkey_);
-    if (!note.has_value()) return;
-
-    // Create per-tab QTextDocument with Markdown content
-    auto* doc = new QTextDocument();
-    doc->setMarkdown(QString::fromStdString(note->body));
+    QString raw_title = toQString(note.title);
+    std::vector<std::string> tags = note.tags;
 
-    storage::Note loaded_note = *note;
-    loaded_note.id = note_id;
-    open_notes_[note_id] = OpenNote{loaded_note, false, doc};
+    // Cache title/tags for the tab; the body lives only in the QTextDocument
+    // until the editor state is cached on switch or save
+    note.id = note_id;
+    open_notes_[note_id] = OpenNote{std::move(note), false, doc};
 
-    QString title = QString::fromStdString(note->title);
+    QString title = raw_title;
     if (title.trimmed().isEmpty()) title = "(Untitled)";
     tab_bar_->addTab(note_id, title);
 
     active_note_id_ = note_id;
-    note_editor_->setBackend(repo_, subkey_);
+    note_editor_->setBackend(storage_, subkey_);
     note_editor_->setDocument(doc);
-    note_editor_->switchToNote(note_id, QString::fromStdString(note->title), note->tags);
+    note_editor_->switchToNote(note_id, raw_title, tags);
     status_bar_->setSaveState("Saved");
     updateStatusBar();
 }
@@ -310,8 +572,8 @@ void NotesPanel::cacheCurrentEditorState() {
 
     auto it = open_notes_.find(active_note_id_);
     if (it != open_notes_.end()) {
-        it->second.note.title = note_editor_->currentTitle().toStdString();
-        it->second.note.body = note_editor_->currentBody().toStdString();
+        it->second.note.title = toSecureString(note_editor_->currentTitle());
+        it->second.note.body = toSecureString(note_editor_->currentBody());
         it->second.note.tags = note_editor_->currentTags();
     }
 }
@@ -329,7 +591,7 @@ void NotesPanel::switchToTab(int64_t note_id) {
 
     // Swap document (preserves per-tab undo history) and set metadata
     note_editor_->setDocument(it->second.document);
-    note_editor_->switchToNote(note_id, QString::fromStdString(it->second.note.title),
+    note_editor_->switchToNote(note_id, toQString(it->second.note.title),
                                 it->second.note.tags);
 
     status_bar_->setSaveState(it->second.modified ? "Modified" : "Saved");
@@ -0,0 +1,30 @@
+#ifndef BASTIONX_UI_SECURETEXT_H
+#define BASTIONX_UI_SECURETEXT_H
+
+#include <QByteArray>
+#include <QString>
+#include <sodium.h>
+#include "bastionx/crypto/SecureAllocator.h"
+
+namespace bastionx {
+namespace ui {
+
+// Conversions between Qt strings and locked-memory note fields.
+// QString::fromStdString / toStdString would round-trip through an ordinary
+// std::string; these go straight to/from UTF-8 and wipe the temporary.
+
+inline QString toQString(const crypto::SecureString& s) {
+    return QString::fromUtf8(s.data(), static_cast<qsizetype>(s.size()));
+}
+
+inline crypto::SecureString toSecureString(const QString& s) {
+    QByteArray utf8 = s.toUtf8();
+    crypto::SecureString out(utf8.constData(), static_cast<size_t>(utf8.size()));
+    sodium_memzero(utf8.data(), static_cast<size_t>(utf8.size()));
+    return out;
+}
+
+}  // namespace ui
+}  // namespace bastionx
+
+#endif  // BASTIONX_UI_SECURETEXT_H
@@ -22,6 +22,14 @@ vault::VaultSettings SettingsDialog::currentSettings() const {
     s.auto_lock_minutes = auto_lock_spin_->value();
     s.clipboard_clear_enabled = clipboard_enabled_->isChecked();
     s.clipboard_clear_seconds = clipboard_seconds_spin_->value();
+    s.quick_unlock_enabled = quick_unlock_enabled_->isChecked();
+    s.quick_unlock_minutes = quick_unlock_minutes_spin_->value();
+    s.cold_pack_enabled = cold_pack_enabled_->isChecked();
+    s.cold_pack_days = cold_pack_days_spin_->value();
+    s.revision_keep_days = revision_days_spin_->value();
+    s.backup_enabled = backup_enabled_->isChecked();
+    s.backup_interval_hours = backup_interval_spin_->value();
+    s.backup_keep = backup_keep_spin_->value();
     return s;
 }
 
@@ -39,6 +47,20 @@ void SettingsDialog::setupUi(const vault::VaultSettings& current) {
     auto_lock_spin_->setValue(current.auto_lock_minutes);
     lock_layout->addRow("Lock after inactivity:", auto_lock_spin_);
 
+    quick_unlock_enabled_ = new QCheckBox("Re-unlock with a PIN after auto-lock", lock_group);
+    quick_unlock_enabled_->setChecked(current.quick_unlock_enabled);
+    lock_layout->addRow(quick_unlock_enabled_);
+
+    quick_unlock_minutes_spin_ = new QSpinBox(lock_group);
+    quick_unlock_minutes_spin_->setRange(5, 480);
+    quick_unlock_minutes_spin_->setSuffix(" min");
+    quick_unlock_minutes_spin_->setValue(current.quick_unlock_minutes);
+    lock_layout->addRow("PIN valid for:", quick_unlock_minutes_spin_);
+
+    connect(quick_unlock_enabled_, &QCheckBox::toggled,
+            quick_unlock_minutes_spin_, &QSpinBox::setEnabled);
+    quick_unlock_minutes_spin_->setEnabled(current.quick_unlock_enabled);
+
     main_layout->addWidget(lock_group);
 
     // === Clipboard Group ===
@@ -61,6 +83,60 @@ void SettingsDialog::setupUi(const vault::VaultSettings& current) {
 
     main_layout->addWidget(clip_group);
 
+    // === Storage Group ===
+    auto* storage_group = new QGroupBox("Storage", this);
+    auto* storage_layout = new QFormLayout(storage_group);
+
+    cold_pack_enabled_ = new QCheckBox("Pack old notes into cold storage", storage_group);
+    cold_pack_enabled_->setChecked(current.cold_pack_enabled);
+    storage_layout->addRow(cold_pack_enabled_);
+
+    cold_pack_days_spin_ = new QSpinBox(storage_group);
+    cold_pack_days_spin_->setRange(30, 3650);
+    cold_pack_days_spin_->setSuffix(" days");
+    cold_pack_days_spin_->setValue(current.cold_pack_days);
+    storage_layout->addRow("Pack notes untouched for:", cold_pack_days_spin_);
+
+    connect(cold_pack_enabled_, &QCheckBox::toggled,
+            cold_pack_days_spin_, &QSpinBox::setEnabled);
+    cold_pack_days_spin_->setEnabled(current.cold_pack_enabled);
+
+    revision_days_spin_ = new QSpinBox(storage_group);
+    revision_days_spin_->setRange(1, 3650);
+    revision_days_spin_->setSuffix(" days");
+    revision_days_spin_->setValue(current.revision_keep_days);
+    storage_layout->addRow("Keep note history for:", revision_days_spin_);
+
+    main_layout->addWidget(storage_group);
+
+    // === Backup Group ===
+    auto* backup_group = new QGroupBox("Backups", this);
+    auto* backup_layout = new QFormLayout(backup_group);
+
+    backup_enabled_ = new QCheckBox("Back up the vault while idle", backup_group);
+    backup_enabled_->setChecked(current.backup_enabled);
+    backup_layout->addRow(backup_enabled_);
+
+    backup_interval_spin_ = new QSpinBox(backup_group);
+    backup_interval_spin_->setRange(1, 168);
+    backup_interval_spin_->setSuffix(" h");
+    backup_interval_spin_->setValue(current.backup_interval_hours);
+    backup_layout->addRow("Back up every:", backup_interval_spin_);
+
+    backup_keep_spin_ = new QSpinBox(backup_group);
+    backup_keep_spin_->setRange(1, 50);
+    backup_keep_spin_->setValue(current.backup_keep);
+    backup_layout->addRow("Snapshots to keep:", backup_keep_spin_);
+
+    connect(backup_enabled_, &QCheckBox::toggled,
+            backup_interval_spin_, &QSpinBox::setEnabled);
+    connect(backup_enabled_, &QCheckBox::toggled,
+            backup_keep_spin_, &QSpinBox::setEnabled);
+    backup_interval_spin_->setEnabled(current.backup_enabled);
+    backup_keep_spin_->setEnabled(current.backup_enabled);
+
+    main_layout->addWidget(backup_group);
+
     // === Password Change Group ===
     auto* pw_group = new QGroupBox("Change Password", this);
     auto* pw_layout = new QFormLayout(pw_group);
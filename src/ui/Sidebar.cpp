@@ -44,6 +44,8 @@ Sidebar::Sidebar(QWidget* parent)
     // Forward signals from NotesList
     connect(notes_list_, &NotesList::noteSelected,
             this, &Sidebar::noteSelected);
+    connect(notes_list_, &NotesList::noteHovered,
+            this, &Sidebar::noteHovered);
     connect(notes_list_, &NotesList::newNoteRequested,
             this, &Sidebar::newNoteRequested);
 
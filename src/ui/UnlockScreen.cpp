@@ -42,6 +42,11 @@ void UnlockScreen::setupUi() {
     submit_button_->setObjectName("submitButton");
     layout->addWidget(submit_button_);
 
+    fallback_button_ = new QPushButton("USE PASSWORD", form);
+    fallback_button_->setObjectName("cancelButton");
+    fallback_button_->hide();
+    layout->addWidget(fallback_button_);
+
     error_label_ = new QLabel("", form);
     error_label_->setObjectName("errorLabel");
     error_label_->setAlignment(Qt::AlignCenter);
@@ -52,6 +57,8 @@ void UnlockScreen::setupUi() {
 
     connect(submit_button_, &QPushButton::clicked, this, &UnlockScreen::onSubmit);
     connect(password_input_, &QLineEdit::returnPressed, this, &UnlockScreen::onSubmit);
+    connect(fallback_button_, &QPushButton::clicked,
+            this, &UnlockScreen::passwordFallbackRequested);
 }
 
 void UnlockScreen::setVaultState(vault::VaultState state) {
@@ -65,6 +72,18 @@ void UnlockScreen::setVaultState(vault::VaultState state) {
     }
 }
 
+void UnlockScreen::setQuickUnlockMode(bool enabled) {
+    quick_mode_ = enabled && current_state_ == vault::VaultState::kLocked;
+    if (quick_mode_) {
+        status_label_->setText("Enter quick-unlock PIN");
+        password_input_->setPlaceholderText("PIN");
+    } else {
+        setVaultState(current_state_);
+        password_input_->setPlaceholderText("Password");
+    }
+    fallback_button_->setVisible(quick_mode_);
+}
+
 void UnlockScreen::reset() {
     password_input_->clear();
     error_label_->hide();
@@ -101,6 +120,8 @@ void UnlockScreen::onSubmit() {
 
     if (current_state_ == vault::VaultState::kNoVault) {
         emit createRequested(password);
+    } else if (quick_mode_) {
+        emit quickUnlockRequested(password);
     } else {
         emit unlockRequested(password);
     }
@@ -0,0 +1,32 @@
+#include "bastionx/util/FileSync.h"
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+namespace bastionx {
+namespace util {
+
+static void sync_path(const std::filesystem::path& path, int flags, const char* what) {
+    int fd = ::open(path.c_str(), flags | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("Failed to open ") + what + " for sync: " +
+                                 path.string());
+    }
+    int rc = ::fsync(fd);
+    ::close(fd);
+    if (rc != 0) {
+        throw std::runtime_error(std::string("Failed to sync ") + what + ": " + path.string());
+    }
+}
+
+void sync_file(const std::filesystem::path& path) {
+    sync_path(path, O_RDONLY, "file");
+}
+
+void sync_directory(const std::filesystem::path& dir) {
+    sync_path(dir, O_RDONLY | O_DIRECTORY, "directory");
+}
+
+}  // namespace util
+}  // namespace bastionx
@@ -0,0 +1,134 @@
+#include "bastionx/util/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace bastionx {
+namespace util {
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    if (thread_count == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        thread_count = hw > 1 ? hw - 1 : 1;
+    }
+
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::worker_loop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;  // stopping_ and nothing left to run
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+void ThreadPool::post(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::parallel_for(size_t task_count, const std::function<void(size_t)>& task) {
+    if (task_count == 0) {
+        return;
+    }
+    if (task_count == 1) {
+        task(0);
+        return;
+    }
+
+    // Shared with helper jobs, which may start after this call has returned
+    // (if the workers were busy) and must then find nothing left to claim
+    struct State {
+        std::function<void(size_t)> task;
+        size_t count;
+        std::atomic<size_t> next{0};
+        std::atomic<bool> failed{false};
+        size_t finished = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto state = std::make_shared<State>();
+    state->task = task;
+    state->count = task_count;
+
+    auto drain = [](State& s) {
+        for (;;) {
+            size_t i = s.next.fetch_add(1);
+            if (i >= s.count) {
+                return;
+            }
+
+            std::exception_ptr error;
+            if (!s.failed.load()) {
+                try {
+                    s.task(i);
+                } catch (...) {
+                    error = std::current_exception();
+                    s.failed.store(true);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(s.mutex);
+            if (error && !s.error) {
+                s.error = error;
+            }
+            if (++s.finished == s.count) {
+                s.done.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(workers_.size(), task_count - 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t h = 0; h < helpers; ++h) {
+            jobs_.emplace_back([state, drain] { drain(*state); });
+        }
+    }
+    cv_.notify_all();
+
+    // The caller works too, then waits for tasks claimed by workers
+    drain(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&] { return state->finished == state->count; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+}  // namespace util
+}  // namespace bastionx
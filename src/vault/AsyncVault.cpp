@@ -0,0 +1,70 @@
+#include "bastionx/vault/AsyncVault.h"
+#include <sodium.h>
+#include <utility>
+
+namespace bastionx {
+namespace vault {
+
+namespace {
+
+// Wipes a password copy when the operation is done with it, even if it throws
+struct WipeOnExit {
+    std::string& secret;
+    ~WipeOnExit() {
+        sodium_memzero(secret.data(), secret.size());
+        secret.clear();
+    }
+};
+
+}  // namespace
+
+AsyncVault::AsyncVault(VaultService& vault, util::Dispatcher resume)
+    : vault_(vault), resume_(std::move(resume)) {}
+
+util::CancelToken AsyncVault::session() {
+    return vault_.is_unlocked() ? vault_.session_token() : util::CancelToken();
+}
+
+util::Awaitable<bool> AsyncVault::create(std::string password) {
+    return util::run_async([this, password = std::move(password)]() mutable {
+        WipeOnExit wipe{password};
+        return vault_.create(password);
+    }, resume_);
+}
+
+util::Awaitable<bool> AsyncVault::unlock(std::string password) {
+    return util::run_async([this, password = std::move(password)]() mutable {
+        WipeOnExit wipe{password};
+        return vault_.unlock(password);
+    }, resume_);
+}
+
+util::Awaitable<bool> AsyncVault::quick_unlock(std::string pin) {
+    return util::run_async([this, pin = std::move(pin)]() mutable {
+        WipeOnExit wipe{pin};
+        return vault_.quick_unlock(pin);
+    }, resume_);
+}
+
+util::Awaitable<bool> AsyncVault::change_password(std::string current_password,
+                                                  std::string new_password) {
+    return util::run_async([this, current_password = std::move(current_password),
+                            new_password = std::move(new_password)]() mutable {
+        WipeOnExit wipe_current{current_password};
+        WipeOnExit wipe_new{new_password};
+        return vault_.change_password(current_password, new_password);
+    }, resume_);
+}
+
+util::Awaitable<std::string> AsyncVault::load_settings() {
+    return util::run_async([this] { return vault_.load_settings(); }, resume_, session());
+}
+
+util::Awaitable<void> AsyncVault::save_settings(std::string json_str) {
+    return util::run_async([this, json_str = std::move(json_str)] {
+        vault_.save_settings(json_str);
+    }, resume_, session());
+}
+
+}  // namespace vault
+}  // namespace bastionx
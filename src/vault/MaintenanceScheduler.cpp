@@ -0,0 +1,342 @@
+#include "bastionx/vault/MaintenanceScheduler.h"
+#include "bastionx/vault/VaultService.h"
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+namespace bastionx {
+namespace vault {
+
+using std::chrono::steady_clock;
+using std::chrono::system_clock;
+
+// === SQL Helpers ===
+
+static void exec(sqlite3* db, const std::string& sql) {
+    char* err = nullptr;
+    if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &err) != SQLITE_OK) {
+        std::string msg = err ? err : "unknown error";
+        sqlite3_free(err);
+        throw std::runtime_error("Maintenance failed: " + msg);
+    }
+}
+
+// Every row's first column, as text
+static std::vector<std::string> query_column(sqlite3* db, const std::string& sql) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Maintenance failed: " + std::string(sqlite3_errmsg(db)));
+    }
+    std::vector<std::string> values;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        const auto* text = sqlite3_column_text(stmt, 0);
+        values.emplace_back(text ? reinterpret_cast<const char*>(text) : "");
+    }
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error("Maintenance failed: " + std::string(sqlite3_errmsg(db)));
+    }
+    return values;
+}
+
+static int64_t query_int(sqlite3* db, const std::string& sql) {
+    auto values = query_column(db, sql);
+    return values.empty() ? 0 : std::stoll(values.front());
+}
+
+static std::vector<std::string> user_tables(sqlite3* db) {
+    return query_column(db, "SELECT name FROM sqlite_master WHERE type = 'table' "
+                            "AND name NOT LIKE 'sqlite_%' ORDER BY name;");
+}
+
+static std::string quote_identifier(const std::string& name) {
+    std::string out = "\"";
+    for (char c : name) {
+        out += c;
+        if (c == '"') out += '"';
+    }
+    return out + "\"";
+}
+
+// === Default Tasks ===
+
+std::vector<MaintenanceScheduler::Task> MaintenanceScheduler::default_tasks() {
+    using std::chrono::hours;
+    constexpr int kVacuumPagesPerStep = 256;
+
+    return {
+        {"optimize", hours(24), [](sqlite3* db, size_t) {
+            exec(db, "PRAGMA optimize;");
+            return true;
+        }},
+        {"analyze", hours(24 * 7), [](sqlite3* db, size_t step) {
+            auto tables = user_tables(db);
+            if (step < tables.size()) {
+                exec(db, "ANALYZE " + quote_identifier(tables[step]) + ";");
+            }
+            return step + 1 >= tables.size();
+        }},
+        // Only vaults created with auto_vacuum = INCREMENTAL (2) can give
+        // pages back without a full VACUUM
+        {"incremental_vacuum", hours(24), [](sqlite3* db, size_t) {
+            if (query_int(db, "PRAGMA auto_vacuum;") != 2) {
+                return true;
+            }
+            exec(db, "PRAGMA incremental_vacuum(" + std::to_string(kVacuumPagesPerStep) + ");");
+            return query_int(db, "PRAGMA freelist_count;") == 0;
+        }},
+        {"quick_check", hours(24 * 7), [](sqlite3* db, size_t step) {
+            auto tables = user_tables(db);
+            if (step < tables.size()) {
+                auto result = query_column(db, "PRAGMA quick_check(" + quote_identifier(tables[step]) + ");");
+                if (result.size() != 1 || result.front() != "ok") {
+                    throw std::runtime_error("quick_check failed on " + tables[step] + ": " +
+                                             (result.empty() ? "no result" : result.front()));
+                }
+            }
+            return step + 1 >= tables.size();
+        }},
+    };
+}
+
+// === Maintenance Log ===
+
+static std::string log_to_json(const std::vector<MaintenanceScheduler::LogEntry>& log) {
+    nlohmann::json tasks = nlohmann::json::array();
+    for (const auto& entry : log) {
+        tasks.push_back({
+            {"name", entry.task},
+            {"last_run", std::chrono::duration_cast<std::chrono::seconds>(
+                             entry.last_run.time_since_epoch()).count()},
+            {"duration_us", entry.duration.count()},
+            {"runs", entry.runs},
+            {"ok", entry.ok},
+            {"error", entry.error},
+        });
+    }
+    return nlohmann::json{{"tasks", tasks}}.dump();
+}
+
+static std::vector<MaintenanceScheduler::LogEntry> log_from_json(const std::string& json_str) {
+    std::vector<MaintenanceScheduler::LogEntry> log;
+    if (json_str.empty()) {
+        return log;
+    }
+    try {
+        auto j = nlohmann::json::parse(json_str);
+        for (const auto& task : j.at("tasks")) {
+            MaintenanceScheduler::LogEntry entry;
+            entry.task = task.at("name").get<std::string>();
+            entry.last_run = system_clock::time_point(
+                std::chrono::seconds(task.at("last_run").get<int64_t>()));
+            entry.duration = std::chrono::microseconds(task.at("duration_us").get<int64_t>());
+            entry.runs = task.at("runs").get<uint64_t>();
+            entry.ok = task.at("ok").get<bool>();
+            entry.error = task.at("error").get<std::string>();
+            log.push_back(std::move(entry));
+        }
+    } catch (const nlohmann::json::exception&) {
+        log.clear();  // Unreadable log: every task is due again
+    }
+    return log;
+}
+
+// === MaintenanceScheduler Implementation ===
+
+MaintenanceScheduler::MaintenanceScheduler(VaultService& vault, std::vector<Task> tasks)
+    : vault_(vault), tasks_(std::move(tasks)) {
+    for (const auto& task : tasks_) {
+        if (task.interval <= std::chrono::seconds::zero()) {
+            throw std::invalid_argument("Maintenance task interval must be positive: " + task.name);
+        }
+    }
+    log_ = log_from_json(vault_.load_maintenance_log());
+}
+
+MaintenanceScheduler::~MaintenanceScheduler() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    if (db_ != nullptr) {
+        sqlite3_close(db_);
+    }
+}
+
+void MaintenanceScheduler::resume() {
+    {
+        std::lock_guard lock(mutex_);
+        active_ = true;
+        if (!worker_.joinable()) {
+            worker_ = std::thread([this] { worker_loop(); });
+        }
+    }
+    wake_.notify_one();
+}
+
+void MaintenanceScheduler::pause() {
+    std::lock_guard lock(mutex_);
+    active_ = false;
+}
+
+bool MaintenanceScheduler::running() const {
+    std::lock_guard lock(mutex_);
+    return active_ || running_;
+}
+
+void MaintenanceScheduler::worker_loop() {
+    std::unique_lock lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return stopping_ || active_; });
+        if (stopping_) {
+            return;
+        }
+        running_ = true;
+        lock.unlock();
+
+        bool more = false;
+        try {
+            more = run_slice();
+        } catch (const std::runtime_error&) {
+            // Retried at the next resume()
+        }
+
+        lock.lock();
+        running_ = false;
+        if (!more) {
+            active_ = false;
+        }
+    }
+}
+
+void MaintenanceScheduler::open() {
+    if (db_ != nullptr) {
+        return;
+    }
+    const auto& key = vault_.db_subkey();
+    if (sqlite3_open_v2(vault_.vault_path().c_str(), &db_, SQLITE_OPEN_READWRITE,
+                        nullptr) != SQLITE_OK) {
+        std::string err = db_ ? sqlite3_errmsg(db_) : "unknown error";
+        sqlite3_close(db_);
+        db_ = nullptr;
+        throw std::runtime_error("Failed to open database: " + err);
+    }
+    try {
+        if (sqlite3_key(db_, key.data(), static_cast<int>(key.size())) != SQLITE_OK) {
+            throw std::runtime_error("Failed to set encryption key: " +
+                                     std::string(sqlite3_errmsg(db_)));
+        }
+        vault_.connection_profile().apply(db_, true);
+        // Destruction interrupts a step in progress
+        sqlite3_progress_handler(db_, 1000, [](void* stopping) {
+            return static_cast<std::atomic<bool>*>(stopping)->load() ? 1 : 0;
+        }, &stopping_);
+    } catch (...) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+        throw;
+    }
+}
+
+MaintenanceScheduler::LogEntry* MaintenanceScheduler::entry_for(const std::string& task) {
+    for (auto& entry : log_) {
+        if (entry.task == task) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool MaintenanceScheduler::is_due(const Task& task) const {
+    for (const auto& entry : log_) {
+        if (entry.task == task.name) {
+            return system_clock::now() - entry.last_run >= task.interval;
+        }
+    }
+    return true;
+}
+
+std::optional<size_t> MaintenanceScheduler::next_due() const {
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+        if (is_due(tasks_[i])) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<std::string> MaintenanceScheduler::due() const {
+    std::vector<std::string> names;
+    for (const auto& task : tasks_) {
+        if (is_due(task)) {
+            names.push_back(task.name);
+        }
+    }
+    return names;
+}
+
+bool MaintenanceScheduler::run_slice(std::chrono::milliseconds budget) {
+    auto start = steady_clock::now();
+    do {
+        if (!current_) {
+            current_ = next_due();
+            if (!current_) {
+                return false;
+            }
+            step_ = 0;
+            spent_ = std::chrono::microseconds(0);
+        }
+        open();
+
+        const Task& task = tasks_[*current_];
+        auto step_start = steady_clock::now();
+        bool done = false;
+        bool ok = true;
+        std::string error;
+        try {
+            done = task.run(db_, step_++);
+        } catch (const std::exception& e) {
+            if (stopping_) {
+                return false;  // Interrupted: not a failure, reruns next time
+            }
+            done = true;
+            ok = false;
+            error = e.what();
+        }
+        spent_ += std::chrono::duration_cast<std::chrono::microseconds>(
+            steady_clock::now() - step_start);
+        if (done) {
+            finish(ok, error);
+        }
+    } while (steady_clock::now() - start < budget && !stopping_);
+
+    return current_.has_value() || next_due().has_value();
+}
+
+void MaintenanceScheduler::finish(bool ok, const std::string& error) {
+    const Task& task = tasks_[*current_];
+    LogEntry* entry = entry_for(task.name);
+    if (entry == nullptr) {
+        log_.emplace_back();
+        log_.back().task = task.name;
+        entry = &log_.back();
+    }
+    entry->last_run = system_clock::now();
+    entry->duration = spent_;
+    entry->ok = ok;
+    entry->error = error;
+    ++entry->runs;
+    current_.reset();
+    save_log();
+}
+
+void MaintenanceScheduler::save_log() {
+    vault_.save_maintenance_log(log_to_json(log_));
+}
+
+}  // namespace vault
+}  // namespace bastionx
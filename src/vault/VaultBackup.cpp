@@ -0,0 +1,289 @@
+#include "bastionx/vault/VaultBackup.h"
+#include "bastionx/vault/VaultService.h"
+#include "bastionx/util/FileSync.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+
+namespace bastionx {
+namespace vault {
+
+namespace fs = std::filesystem;
+using std::chrono::system_clock;
+
+// === Snapshot Names ===
+
+// "20261018T093000Z"
+static std::string format_utc(system_clock::time_point time) {
+    auto secs = std::chrono::floor<std::chrono::seconds>(time);
+    auto day = std::chrono::floor<std::chrono::days>(secs);
+    std::chrono::year_month_day ymd{day};
+    std::chrono::hh_mm_ss hms{secs - day};
+
+    char buf[20];
+    std::snprintf(buf, sizeof(buf), "%04d%02u%02uT%02d%02d%02dZ",
+                  static_cast<int>(ymd.year()),
+                  static_cast<unsigned>(ymd.month()),
+                  static_cast<unsigned>(ymd.day()),
+                  static_cast<int>(hms.hours().count()),
+                  static_cast<int>(hms.minutes().count()),
+                  static_cast<int>(hms.seconds().count()));
+    return buf;
+}
+
+static std::optional<system_clock::time_point> parse_utc(const std::string& text) {
+    int year = 0;
+    unsigned month = 0, day = 0;
+    int hour = 0, minute = 0, second = 0;
+    char zone = 0;
+    if (text.size() != 16 ||
+        std::sscanf(text.c_str(), "%4d%2u%2uT%2d%2d%2d%c",
+                    &year, &month, &day, &hour, &minute, &second, &zone) != 7 ||
+        zone != 'Z') {
+        return std::nullopt;
+    }
+    std::chrono::year_month_day ymd{std::chrono::year{year}, std::chrono::month{month},
+                                    std::chrono::day{day}};
+    if (!ymd.ok() || hour > 23 || minute > 59 || second > 59) {
+        return std::nullopt;
+    }
+    return std::chrono::sys_days{ymd} + std::chrono::hours(hour) +
+           std::chrono::minutes(minute) + std::chrono::seconds(second);
+}
+
+static void remove_database_files(const std::string& path) {
+    std::error_code ec;
+    for (const char* suffix : {"", "-journal", "-wal", "-shm"}) {
+        fs::remove(path + suffix, ec);
+    }
+}
+
+// === VaultBackup Implementation ===
+
+VaultBackup::VaultBackup(const std::string& vault_path, const std::string& backup_dir,
+                         size_t keep)
+    : vault_path_(vault_path), backup_dir_(backup_dir), keep_(keep) {
+    if (keep == 0) {
+        throw std::invalid_argument("Backups must keep at least one snapshot");
+    }
+}
+
+VaultBackup::~VaultBackup() {
+    cancel();
+}
+
+std::string VaultBackup::default_backup_dir(const std::string& vault_path) {
+    return (fs::path(vault_path).parent_path() / "backups").string();
+}
+
+void VaultBackup::set_keep(size_t keep) {
+    if (keep == 0) {
+        throw std::invalid_argument("Backups must keep at least one snapshot");
+    }
+    keep_ = keep;
+}
+
+bool VaultBackup::in_progress() const {
+    return backup_ != nullptr;
+}
+
+double VaultBackup::progress() const {
+    if (backup_ == nullptr) {
+        return 0.0;
+    }
+    int total = sqlite3_backup_pagecount(backup_);
+    if (total <= 0) {
+        return 0.0;  // Not known until the first step
+    }
+    int remaining = sqlite3_backup_remaining(backup_);
+    return static_cast<double>(total - remaining) / total;
+}
+
+void VaultBackup::start(const crypto::SecureKey& db_key,
+                        const storage::ConnectionProfile& profile) {
+    if (backup_ != nullptr) {
+        throw std::runtime_error("A backup is already running");
+    }
+
+    std::error_code ec;
+    fs::create_directories(backup_dir_, ec);
+    if (!fs::is_directory(backup_dir_)) {
+        throw std::runtime_error("Failed to create backup directory: " + backup_dir_);
+    }
+
+    // Names sort by time; a second snapshot within the same second moves on
+    // to the next one rather than replacing the first
+    auto created = std::chrono::floor<std::chrono::seconds>(system_clock::now());
+    auto existing = snapshots();
+    if (!existing.empty() && existing.back().created >= created) {
+        created = std::chrono::floor<std::chrono::seconds>(existing.back().created) +
+                  std::chrono::seconds(1);
+    }
+    std::string stem = fs::path(vault_path_).stem().string();
+    snapshot_path_ = (fs::path(backup_dir_) / (stem + "-" + format_utc(created) + ".db")).string();
+    partial_path_ = snapshot_path_ + ".part";
+
+    auto open = [&](const std::string& path, int flags) {
+        sqlite3* db = nullptr;
+        if (sqlite3_open_v2(path.c_str(), &db, flags, nullptr) != SQLITE_OK) {
+            std::string err = db ? sqlite3_errmsg(db) : "unknown error";
+            if (db) sqlite3_close(db);
+            throw std::runtime_error("Failed to open database: " + err);
+        }
+        if (sqlite3_key(db, db_key.data(), static_cast<int>(db_key.size())) != SQLITE_OK) {
+            std::string err = sqlite3_errmsg(db);
+            sqlite3_close(db);
+            throw std::runtime_error("Failed to set encryption key: " + err);
+        }
+        try {
+            profile.apply(db, true);
+        } catch (...) {
+            sqlite3_close(db);
+            throw;
+        }
+        return db;
+    };
+
+    try {
+        // Read-write only so WAL files can be opened; nothing is written
+        source_ = open(vault_path_, SQLITE_OPEN_READWRITE);
+
+        // Pin one read snapshot for the whole backup (also checks the key)
+        char* err = nullptr;
+        if (sqlite3_exec(source_, "BEGIN; SELECT count(*) FROM sqlite_master;",
+                         nullptr, nullptr, &err) != SQLITE_OK) {
+            std::string msg = err ? err : "unknown error";
+            sqlite3_free(err);
+            throw std::runtime_error("Failed to read vault: " + msg);
+        }
+
+        remove_database_files(partial_path_);
+        dest_ = open(partial_path_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+        backup_ = sqlite3_backup_init(dest_, "main", source_, "main");
+        if (backup_ == nullptr) {
+            throw std::runtime_error("Failed to start backup: " +
+                                     std::string(sqlite3_errmsg(dest_)));
+        }
+    } catch (...) {
+        close_handles();
+        remove_database_files(partial_path_);
+        throw;
+    }
+}
+
+VaultBackup::StepResult VaultBackup::step(int pages) {
+    if (backup_ == nullptr) {
+        throw std::runtime_error("No backup is running");
+    }
+
+    int rc = sqlite3_backup_step(backup_, pages);
+    switch (rc) {
+        case SQLITE_OK:
+            return StepResult::kMore;
+        case SQLITE_BUSY:
+        case SQLITE_LOCKED:
+            return StepResult::kBusy;
+        case SQLITE_DONE:
+            finish();
+            return StepResult::kDone;
+        default: {
+            std::string err = sqlite3_errmsg(dest_);
+            cancel();
+            throw std::runtime_error("Backup failed: " + err);
+        }
+    }
+}
+
+void VaultBackup::finish() {
+    int rc = sqlite3_backup_finish(backup_);
+    backup_ = nullptr;
+    if (rc != SQLITE_OK) {
+        std::string err = sqlite3_errmsg(dest_);
+        cancel();
+        throw std::runtime_error("Backup failed: " + err);
+    }
+    close_handles();
+
+    try {
+        // The salt goes first: a snapshot is only listed once it can be opened
+        std::string salt = VaultService::salt_path(vault_path_);
+        if (fs::exists(salt)) {
+            fs::copy_file(salt, VaultService::salt_path(snapshot_path_),
+                          fs::copy_options::overwrite_existing);
+            util::sync_file(VaultService::salt_path(snapshot_path_));
+        }
+        // Durable before it is named, and named before older snapshots go:
+        // a power loss must never leave fewer complete snapshots than before
+        util::sync_file(partial_path_);
+        fs::rename(partial_path_, snapshot_path_);
+        util::sync_directory(backup_dir_);
+    } catch (const std::runtime_error& e) {  // Includes fs::filesystem_error
+        remove_database_files(partial_path_);
+        throw std::runtime_error(std::string("Failed to save snapshot: ") + e.what());
+    }
+
+    prune();
+}
+
+void VaultBackup::cancel() {
+    if (backup_ != nullptr) {
+        sqlite3_backup_finish(backup_);
+        backup_ = nullptr;
+    }
+    if (source_ == nullptr && dest_ == nullptr) {
+        return;
+    }
+    close_handles();
+    remove_database_files(partial_path_);
+}
+
+void VaultBackup::close_handles() {
+    if (source_) {
+        sqlite3_exec(source_, "COMMIT;", nullptr, nullptr, nullptr);
+        sqlite3_close(source_);
+        source_ = nullptr;
+    }
+    if (dest_) {
+        sqlite3_close(dest_);
+        dest_ = nullptr;
+    }
+}
+
+std::vector<VaultBackup::Snapshot> VaultBackup::snapshots() const {
+    std::vector<Snapshot> found;
+    std::error_code ec;
+    if (!fs::is_directory(backup_dir_, ec)) {
+        return found;
+    }
+
+    std::string prefix = fs::path(vault_path_).stem().string() + "-";
+    for (const auto& entry : fs::directory_iterator(backup_dir_, ec)) {
+        std::string name = entry.path().filename().string();
+        if (entry.path().extension() != ".db" || name.size() != prefix.size() + 19 ||
+            name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        auto created = parse_utc(name.substr(prefix.size(), 16));
+        if (created.has_value()) {
+            found.push_back(Snapshot{entry.path().string(), *created});
+        }
+    }
+    std::sort(found.begin(), found.end(), [](const Snapshot& a, const Snapshot& b) {
+        return a.created < b.created;
+    });
+    return found;
+}
+
+void VaultBackup::prune() {
+    auto found = snapshots();
+    for (size_t i = 0; i + keep_ < found.size(); ++i) {
+        remove_database_files(found[i].path);
+        std::error_code ec;
+        fs::remove(VaultService::salt_path(found[i].path), ec);
+    }
+}
+
+}  // namespace vault
+}  // namespace bastionx
@@ -1,9 +1,17 @@
 #include "bastionx/vault/VaultService.h"
+#include "bastionx/crypto/SecretStream.h"
+#include "bastionx/crypto/SecureBufferPool.h"
+#include "bastionx/storage/RecordAad.h"
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <stdexcept>
 #include <cstring>
 #include <ctime>
+#include <optional>
+#include <span>
+#include <string_view>
 
 namespace bastionx {
 namespace vault {
@@ -17,7 +25,9 @@ static void exec_sql(sqlite3* db, const std::string& sql);
 
 class ScopedDb {
 public:
-    explicit ScopedDb(const std::string& path, const crypto::SecureKey* db_key = nullptr) : db_(nullptr) {
+    explicit ScopedDb(const std::string& path, const crypto::SecureKey* db_key = nullptr,
+                      const storage::ConnectionProfile& profile =
+                          storage::ConnectionProfile::balanced()) : db_(nullptr) {
         int rc = sqlite3_open(path.c_str(), &db_);
         if (rc != SQLITE_OK) {
             std::string err = db_ ? sqlite3_errmsg(db_) : "unknown error";
@@ -33,7 +43,13 @@ public:
                 db_ = nullptr;
                 throw std::runtime_error("Failed to set encryption key: " + err);
             }
-            exec_sql(db_, "PRAGMA cipher_memory_security = ON;");
+            try {
+                profile.apply(db_, true);
+            } catch (...) {
+                sqlite3_close(db_);
+                db_ = nullptr;
+                throw;
+            }
         }
     }
 
@@ -86,14 +102,185 @@ static void exec_sql(sqlite3* db, const std::string& sql) {
     }
 }
 
+// Helper to check whether a table has a given column (for ALTER TABLE migrations)
+static bool column_exists(sqlite3* db, const std::string& table, const std::string& column) {
+    ScopedStmt stmt(db, "PRAGMA table_info(" + table + ")");
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        const unsigned char* name = sqlite3_column_text(stmt.get(), 1);
+        if (name && column == reinterpret_cast<const char*>(name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Maintenance log AAD: keeps the log and the settings (same subkey) apart
+static const std::vector<uint8_t> kMaintenanceLogAad = {'B', 'X', 'M', 'L', 'O', 'G', 'v', '1'};
+
+// Re-encrypt the (nonce, ciphertext, alg) records of `table`, `batch_rows`
+// rows at a time (batch AEAD, bounded locked memory). `columns` are selected
+// after them and `aad_of` builds each row's AAD from the statement (record
+// columns are 1..3, `columns` start at 4).
+static void reencrypt_records(
+    sqlite3* db, const std::string& table, const std::string& columns,
+    const std::function<std::vector<uint8_t>(sqlite3_stmt*)>& aad_of,
+    const crypto::SecureKey& old_key, const crypto::SecureKey& new_key,
+    int64_t batch_rows = 64)
+{
+    ScopedStmt select_stmt(db,
+        "SELECT rowid, nonce, ciphertext, alg, " + columns + " FROM " + table +
+        " WHERE rowid > ? ORDER BY rowid LIMIT ?");
+    ScopedStmt update_stmt(db,
+        "UPDATE " + table + " SET nonce = ?, ciphertext = ?, alg = ? WHERE rowid = ?");
+
+    int64_t last_rowid = 0;
+    while (true) {
+        std::vector<int64_t> rowids;
+        std::vector<crypto::CryptoService::EncryptedData> records;
+        std::vector<std::vector<uint8_t>> aads;
+
+        sqlite3_reset(select_stmt.get());
+        sqlite3_bind_int64(select_stmt.get(), 1, last_rowid);
+        sqlite3_bind_int64(select_stmt.get(), 2, batch_rows);
+        while (sqlite3_step(select_stmt.get()) == SQLITE_ROW) {
+            const void* nonce_blob = sqlite3_column_blob(select_stmt.get(), 1);
+            int nonce_size = sqlite3_column_bytes(select_stmt.get(), 1);
+            const void* ct_blob = sqlite3_column_blob(select_stmt.get(), 2);
+            int ct_size = sqlite3_column_bytes(select_stmt.get(), 2);
+            if (nonce_size != static_cast<int>(crypto::CryptoService::NONCE_BYTES) ||
+                !nonce_blob || ct_size <= 0 || !ct_blob) {
+                throw std::runtime_error("Corrupted " + table + " row during password change");
+            }
+
+            crypto::CryptoService::EncryptedData record;
+            std::memcpy(record.nonce.data(), nonce_blob, crypto::CryptoService::NONCE_BYTES);
+            record.ciphertext.assign(
+                static_cast<const uint8_t*>(ct_blob),
+                static_cast<const uint8_t*>(ct_blob) + ct_size);
+            record.algorithm = static_cast<crypto::CryptoService::Algorithm>(
+                sqlite3_column_int(select_stmt.get(), 3));
+
+            rowids.push_back(sqlite3_column_int64(select_stmt.get(), 0));
+            aads.push_back(aad_of(select_stmt.get()));
+            records.push_back(std::move(record));
+        }
+        sqlite3_reset(select_stmt.get());
+        if (rowids.empty()) {
+            break;
+        }
+        last_rowid = rowids.back();
+
+        auto plain = crypto::CryptoService::decrypt_many(records, old_key, aads);
+        std::vector<std::span<const uint8_t>> plaintexts;
+        plaintexts.reserve(rowids.size());
+        for (size_t i = 0; i < rowids.size(); ++i) {
+            if (!plain.ok[i]) {
+                throw std::runtime_error("Failed to decrypt " + table + " row " +
+                                         std::to_string(rowids[i]) + " during password change");
+            }
+            plaintexts.push_back(plain.plaintext(i));
+        }
+        auto enc = crypto::CryptoService::encrypt_many(
+            plaintexts, new_key, aads, crypto::CryptoService::preferred_algorithm());
+
+        for (size_t i = 0; i < rowids.size(); ++i) {
+            auto ct = enc.ciphertext(i);
+            sqlite3_reset(update_stmt.get());
+            sqlite3_bind_blob(update_stmt.get(), 1, enc.nonces[i].data(),
+                              static_cast<int>(enc.nonces[i].size()), SQLITE_STATIC);
+            sqlite3_bind_blob(update_stmt.get(), 2, ct.data(),
+                              static_cast<int>(ct.size()), SQLITE_STATIC);
+            sqlite3_bind_int(update_stmt.get(), 3, static_cast<int>(enc.algorithm));
+            sqlite3_bind_int64(update_stmt.get(), 4, rowids[i]);
+            if (sqlite3_step(update_stmt.get()) != SQLITE_DONE) {
+                throw std::runtime_error("Failed to re-encrypt " + table + " row " +
+                                         std::to_string(rowids[i]));
+            }
+        }
+    }
+}
+
+// Re-encrypt a note's body stream (if it has one) under a new key and the new
+// record nonce, one chunk at a time
+static void restream_note_chunks(
+    sqlite3* db, int64_t note_id,
+    const std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& old_nonce,
+    const std::array<uint8_t, crypto::CryptoService::NONCE_BYTES>& new_nonce,
+    const crypto::SecureKey& old_key, const crypto::SecureKey& new_key)
+{
+    ScopedStmt select_stmt(db, "SELECT data FROM note_chunks WHERE note_id = ? AND seq = ?");
+    ScopedStmt update_stmt(db, "UPDATE note_chunks SET data = ? WHERE note_id = ? AND seq = ?");
+
+    // Copy out chunk `seq` (the statement is reset before the row is updated)
+    auto load = [&](int64_t seq) -> std::optional<std::vector<uint8_t>> {
+        sqlite3_reset(select_stmt.get());
+        sqlite3_bind_int64(select_stmt.get(), 1, note_id);
+        sqlite3_bind_int64(select_stmt.get(), 2, seq);
+        if (sqlite3_step(select_stmt.get()) != SQLITE_ROW) {
+            return std::nullopt;
+        }
+        auto* blob = static_cast<const uint8_t*>(sqlite3_column_blob(select_stmt.get(), 0));
+        int size = sqlite3_column_bytes(select_stmt.get(), 0);
+        std::vector<uint8_t> data(blob, blob + size);
+        sqlite3_reset(select_stmt.get());
+        return data;
+    };
+    auto store = [&](int64_t seq, const std::vector<uint8_t>& data) {
+        sqlite3_reset(update_stmt.get());
+        sqlite3_bind_blob(update_stmt.get(), 1, data.data(),
+                          static_cast<int>(data.size()), SQLITE_STATIC);
+        sqlite3_bind_int64(update_stmt.get(), 2, note_id);
+        sqlite3_bind_int64(update_stmt.get(), 3, seq);
+        if (sqlite3_step(update_stmt.get()) != SQLITE_DONE) {
+            throw std::runtime_error("Failed to re-encrypt chunk of note " + std::to_string(note_id));
+        }
+    };
+
+    auto header = load(0);
+    if (!header.has_value()) {
+        return;  // Body is inline in the note record
+    }
+
+    // Keyed with the notes subkey itself, as the stream format was written
+    crypto::SecretStreamReader reader(old_key, *header);
+    crypto::SecretStreamWriter writer(new_key);
+    auto old_ad = storage::RecordAad::stream_chunk(note_id, old_nonce);
+    auto new_ad = storage::RecordAad::stream_chunk(note_id, new_nonce);
+
+    store(0, std::vector<uint8_t>(writer.header().begin(), writer.header().end()));
+
+    std::vector<uint8_t> ciphertext;
+    for (int64_t seq = 1; !reader.finished(); ++seq) {
+        auto chunk = load(seq);
+        if (!chunk.has_value() || chunk->size() < crypto::SecretStreamReader::ABYTES) {
+            throw std::runtime_error("Missing chunk of note " + std::to_string(note_id) +
+                                     " during password change");
+        }
+
+        crypto::SecureBytes plaintext(chunk->size() - crypto::SecretStreamReader::ABYTES);
+        size_t len = 0;
+        if (!reader.pull(*chunk, old_ad, plaintext.data(), &len)) {
+            throw std::runtime_error("Failed to decrypt chunk of note " +
+                                     std::to_string(note_id) + " during password change");
+        }
+
+        writer.push(std::span<const uint8_t>(plaintext.data(), len), new_ad,
+                    reader.finished(), ciphertext);
+        store(seq, ciphertext);
+    }
+}
+
 // === VaultService Implementation ===
 
-VaultService::VaultService(const std::string& vault_path)
+VaultService::VaultService(const std::string& vault_path,
+                           const storage::ConnectionProfile& profile)
     : vault_path_(vault_path)
-    , state_(fs::exists(vault_path) ? VaultState::kLocked : VaultState::kNoVault) {
+    , state_(fs::exists(vault_path) ? VaultState::kLocked : VaultState::kNoVault)
+    , profile_(profile) {
 }
 
 VaultService::~VaultService() {
+    disarm_quick_unlock();
     wipe_keys();
 }
 
@@ -113,11 +300,15 @@ bool VaultService::create(const std::string& password) {
     auto db_key = crypto::CryptoService::derive_subkey(
         derived.master_key, crypto::CryptoService::SUBKEY_DATABASE);
 
-    // Open SQLite with encryption — DB is encrypted from birth
-    ScopedDb db(vault_path_, &db_key);
+    // Open SQLite with encryption — DB is encrypted from birth (and in WAL
+    // mode, like every profile)
+    ScopedDb db(vault_path_, &db_key, profile_);
 
-    // Enable WAL mode (after keying)
-    exec_sql(db.get(), "PRAGMA journal_mode=WAL;");
+    // Lets idle maintenance return free pages without a full VACUUM. The
+    // switch to WAL already wrote the header, so the (still empty) file is
+    // rebuilt for the setting to take effect
+    exec_sql(db.get(), "PRAGMA auto_vacuum = INCREMENTAL;");
+    exec_sql(db.get(), "VACUUM;");
 
     create_schema(db.get());
 
@@ -179,7 +370,7 @@ bool VaultService::unlock(const std::string& password) {
     // Wrong password → wrong db_key → SQLCipher throws on first query
     std::unique_ptr<ScopedDb> db_ptr;
     try {
-        db_ptr = std::make_unique<ScopedDb>(vault_path_, &db_key);
+        db_ptr = std::make_unique<ScopedDb>(vault_path_, &db_key, profile_);
         if (!load_vault_meta(db_ptr->get())) {
             state_ = VaultState::kLocked;
             return false;
@@ -243,7 +434,11 @@ bool VaultService::unlock(const std::string& password) {
 }
 
 void VaultService::lock() {
+    disarm_quick_unlock();
     wipe_keys();
+
+    // Release idle decrypted-payload buffers (already wiped) back to the OS
+    crypto::SecureBufferPool::instance().trim();
     if (fs::exists(vault_path_)) {
         state_ = VaultState::kLocked;
     } else {
@@ -251,6 +446,114 @@ void VaultService::lock() {
     }
 }
 
+// AAD binding the wrapped master key to its purpose
+static const std::vector<uint8_t> kQuickUnlockAad = {'B', 'X', 'Q', 'U', 'v', '1'};
+
+void VaultService::arm_quick_unlock(const std::string& pin,
+                                    std::chrono::seconds lifetime,
+                                    int max_attempts) {
+    if (state_ != VaultState::kUnlocked || !master_key_.has_value()) {
+        throw std::runtime_error("Vault is locked");
+    }
+    if (pin.size() < QUICK_UNLOCK_MIN_PIN_LENGTH) {
+        throw std::invalid_argument("Quick-unlock PIN is too short");
+    }
+    if (max_attempts < 1) {
+        throw std::invalid_argument("Quick-unlock attempts must be at least 1");
+    }
+
+    QuickUnlock quick;
+    randombytes_buf(quick.salt.data(), quick.salt.size());
+    randombytes_buf(quick.session_secret.data(), quick.session_secret.size());
+    auto pin_key = derive_pin_key(pin, quick);
+    quick.wrapped = crypto::CryptoService::encrypt(master_key_->span(), pin_key, kQuickUnlockAad);
+    quick.expires_at = std::chrono::steady_clock::now() + lifetime;
+    quick.max_attempts = max_attempts;
+    quick.attempts_left = max_attempts;
+
+    quick_unlock_ = std::move(quick);
+}
+
+void VaultService::quick_lock() {
+    if (state_ != VaultState::kUnlocked) {
+        return;
+    }
+    if (!quick_unlock_available()) {
+        lock();
+        return;
+    }
+
+    // Same wipe as lock(), but the wrapped master key survives, and so does
+    // the pool: keying its connections again is most of an unlock's cost.
+    // It keeps only the database key; what it decrypted is wiped
+    session_.cancel();
+    if (pool_) {
+        try {
+            pool_->writer().flush_writes();
+            pool_->clear_caches();
+        } catch (const std::runtime_error&) {
+            lock();  // Closing the pool retries the saves
+            return;
+        }
+    }
+    wipe_key_material();
+    crypto::SecureBufferPool::instance().trim();
+    state_ = VaultState::kLocked;
+}
+
+bool VaultService::quick_unlock(const std::string& pin) {
+    if (state_ == VaultState::kUnlocked) {
+        return true;  // Already unlocked
+    }
+    if (!quick_unlock_available() || !fs::exists(vault_path_)) {
+        disarm_quick_unlock();
+        return false;
+    }
+
+    auto pin_key = derive_pin_key(pin, *quick_unlock_);
+    auto master = crypto::CryptoService::decrypt_secure(
+        quick_unlock_->wrapped, pin_key, kQuickUnlockAad);
+
+    if (!master.has_value() || master->size() != crypto::CryptoService::KEY_BYTES) {
+        // Wrong PIN: the wrapped key is destroyed once the attempts run out
+        if (--quick_unlock_->attempts_left <= 0) {
+            disarm_quick_unlock();
+        }
+        return false;
+    }
+
+    master_key_.emplace(crypto::CryptoService::KEY_BYTES);
+    std::memcpy(master_key_->data(), master->data(), crypto::CryptoService::KEY_BYTES);
+    derive_subkeys_from_master();  // connection_pool() is the one quick_lock() kept
+
+    quick_unlock_->attempts_left = quick_unlock_->max_attempts;
+    state_ = VaultState::kUnlocked;
+    return true;
+}
+
+bool VaultService::quick_unlock_available() {
+    if (!quick_unlock_.has_value()) {
+        return false;
+    }
+    if (std::chrono::steady_clock::now() >= quick_unlock_->expires_at) {
+        disarm_quick_unlock();
+        return false;
+    }
+    return true;
+}
+
+void VaultService::disarm_quick_unlock() {
+    if (quick_unlock_.has_value()) {
+        // Ciphertext only, but wipe it anyway so nothing lingers on the heap
+        sodium_memzero(quick_unlock_->wrapped.ciphertext.data(),
+                       quick_unlock_->wrapped.ciphertext.size());
+        quick_unlock_.reset();
+    }
+    if (state_ != VaultState::kUnlocked) {
+        pool_.reset();  // Kept by quick_lock() for quick_unlock() only
+    }
+}
+
 VaultState VaultService::state() const {
     return state_;
 }
@@ -259,6 +562,16 @@ bool VaultService::is_unlocked() const {
     return state_ == VaultState::kUnlocked;
 }
 
+util::CancelToken VaultService::session_token() {
+    if (state_ != VaultState::kUnlocked) {
+        throw std::runtime_error("Vault is locked");
+    }
+    if (session_.cancelled()) {
+        session_ = util::CancelToken();  // First call of a new session
+    }
+    return session_;
+}
+
 const crypto::SecureKey& VaultService::notes_subkey() const {
     if (state_ != VaultState::kUnlocked || !notes_subkey_.has_value()) {
         throw std::runtime_error("Vault is locked");
@@ -280,6 +593,23 @@ const crypto::SecureKey& VaultService::db_subkey() const {
     return *db_subkey_;
 }
 
+storage::ConnectionPool& VaultService::connection_pool() {
+    if (state_ != VaultState::kUnlocked || !db_subkey_.has_value()) {
+        throw std::runtime_error("Vault is locked");
+    }
+    if (!pool_) {
+        pool_ = std::make_unique<storage::ConnectionPool>(vault_path_, *db_subkey_, profile_);
+    }
+    return *pool_;
+}
+
+crypto::SecureKey VaultService::export_key() const {
+    if (state_ != VaultState::kUnlocked || !master_key_.has_value()) {
+        throw std::runtime_error("Vault is locked");
+    }
+    return crypto::CryptoService::derive_subkey(*master_key_, crypto::CryptoService::SUBKEY_EXPORT);
+}
+
 void VaultService::save_settings(const std::string& json_str) {
     if (state_ != VaultState::kUnlocked) {
         throw std::runtime_error("Vault is locked");
@@ -288,7 +618,7 @@ void VaultService::save_settings(const std::string& json_str) {
     std::vector<uint8_t> plaintext(json_str.begin(), json_str.end());
     auto encrypted = crypto::CryptoService::encrypt(plaintext, *settings_subkey_, {});
 
-    ScopedDb db(vault_path_, &*db_subkey_);
+    ScopedDb db(vault_path_, &*db_subkey_, profile_);
 
     // Ensure vault_settings table exists (migration for pre-Phase 4 vaults)
     migrate_schema(db.get());
@@ -316,7 +646,7 @@ std::string VaultService::load_settings() {
         throw std::runtime_error("Vault is locked");
     }
 
-    ScopedDb db(vault_path_, &*db_subkey_);
+    ScopedDb db(vault_path_, &*db_subkey_, profile_);
 
     // Ensure vault_settings table exists
     migrate_schema(db.get());
@@ -359,19 +689,90 @@ std::string VaultService::load_settings() {
     return std::string(plaintext->begin(), plaintext->end());
 }
 
+void VaultService::save_maintenance_log(const std::string& json_str) {
+    if (state_ != VaultState::kUnlocked) {
+        throw std::runtime_error("Vault is locked");
+    }
+
+    std::vector<uint8_t> plaintext(json_str.begin(), json_str.end());
+    auto encrypted = crypto::CryptoService::encrypt(plaintext, *settings_subkey_,
+                                                    kMaintenanceLogAad);
+
+    ScopedDb db(vault_path_, &*db_subkey_, profile_);
+    migrate_schema(db.get());
+
+    exec_sql(db.get(), "BEGIN;");
+    try {
+        exec_sql(db.get(), "DELETE FROM maintenance_log;");
+        ScopedStmt stmt(db.get(),
+            "INSERT INTO maintenance_log (nonce, ciphertext) VALUES (?, ?)");
+        sqlite3_bind_blob(stmt.get(), 1, encrypted.nonce.data(),
+                          static_cast<int>(encrypted.nonce.size()), SQLITE_STATIC);
+        sqlite3_bind_blob(stmt.get(), 2, encrypted.ciphertext.data(),
+                          static_cast<int>(encrypted.ciphertext.size()), SQLITE_STATIC);
+        if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+            throw std::runtime_error(
+                "Failed to save maintenance log: " + std::string(sqlite3_errmsg(db.get())));
+        }
+        exec_sql(db.get(), "COMMIT;");
+    } catch (...) {
+        sqlite3_exec(db.get(), "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+}
+
+std::string VaultService::load_maintenance_log() {
+    if (state_ != VaultState::kUnlocked) {
+        throw std::runtime_error("Vault is locked");
+    }
+
+    ScopedDb db(vault_path_, &*db_subkey_, profile_);
+    migrate_schema(db.get());
+
+    ScopedStmt stmt(db.get(), "SELECT nonce, ciphertext FROM maintenance_log LIMIT 1");
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+        return "";
+    }
+
+    const void* nonce_blob = sqlite3_column_blob(stmt.get(), 0);
+    int nonce_size = sqlite3_column_bytes(stmt.get(), 0);
+    const void* ct_blob = sqlite3_column_blob(stmt.get(), 1);
+    int ct_size = sqlite3_column_bytes(stmt.get(), 1);
+    if (nonce_size != static_cast<int>(crypto::CryptoService::NONCE_BYTES) ||
+        nonce_blob == nullptr || ct_size <= 0 || ct_blob == nullptr) {
+        return "";
+    }
+
+    crypto::CryptoService::EncryptedData enc;
+    std::memcpy(enc.nonce.data(), nonce_blob, crypto::CryptoService::NONCE_BYTES);
+    enc.ciphertext.assign(static_cast<const uint8_t*>(ct_blob),
+                          static_cast<const uint8_t*>(ct_blob) + ct_size);
+
+    auto plaintext = crypto::CryptoService::decrypt(enc, *settings_subkey_, kMaintenanceLogAad);
+    if (!plaintext.has_value()) {
+        return "";
+    }
+    return std::string(plaintext->begin(), plaintext->end());
+}
+
 bool VaultService::change_password(const std::string& current_password,
                                    const std::string& new_password) {
     if (state_ != VaultState::kUnlocked) {
         throw std::runtime_error("Vault is locked");
     }
 
+    // Re-keying needs the only connection to the vault; the pool reopens
+    // on next use with whichever key is current then
+    session_.cancel();
+    pool_.reset();
+
     // Step 1: Verify current password by re-deriving master key
     auto current_derived = crypto::CryptoService::derive_master_key(current_password, salt_);
     auto current_verify = crypto::CryptoService::derive_subkey(
         current_derived.master_key, crypto::CryptoService::SUBKEY_VERIFY);
 
     // Check that the re-derived verify subkey matches by trying to decrypt the token
-    ScopedDb db(vault_path_, &*db_subkey_);
+    ScopedDb db(vault_path_, &*db_subkey_, profile_);
 
     std::array<uint8_t, crypto::CryptoService::NONCE_BYTES> verify_nonce{};
     std::vector<uint8_t> verify_ct;
@@ -404,76 +805,172 @@ bool VaultService::change_password(const std::string& current_password,
     exec_sql(db.get(), "BEGIN EXCLUSIVE TRANSACTION;");
 
     try {
-        // Step 5: Re-encrypt all notes
+        // Step 5: Re-encrypt all notes (a packed note's row holds its pack
+        // reference; the pack itself is re-encrypted in step 5c)
         {
+            migrate_schema(db.get());
+
             ScopedStmt select_stmt(db.get(),
-                "SELECT id, nonce, ciphertext FROM notes");
+                "SELECT id, nonce, ciphertext, alg, pack_id IS NOT NULL FROM notes");
 
             // Collect all notes first (can't UPDATE while iterating SELECT)
-            struct NoteRow {
-                int64_t id;
-                std::array<uint8_t, crypto::CryptoService::NONCE_BYTES> nonce;
-                std::vector<uint8_t> ciphertext;
-            };
-            std::vector<NoteRow> rows;
+            std::vector<int64_t> ids;
+            std::vector<crypto::CryptoService::EncryptedData> records;
+            std::vector<std::vector<uint8_t>> aads;
+            std::vector<bool> packed;
 
             while (sqlite3_step(select_stmt.get()) == SQLITE_ROW) {
-                NoteRow row;
-                row.id = sqlite3_column_int64(select_stmt.get(), 0);
+                int64_t id = sqlite3_column_int64(select_stmt.get(), 0);
+                crypto::CryptoService::EncryptedData record;
 
                 const void* nonce_blob = sqlite3_column_blob(select_stmt.get(), 1);
                 int nonce_size = sqlite3_column_bytes(select_stmt.get(), 1);
                 if (nonce_size != static_cast<int>(crypto::CryptoService::NONCE_BYTES) || !nonce_blob) {
                     throw std::runtime_error("Corrupted note nonce during password change");
                 }
-                std::memcpy(row.nonce.data(), nonce_blob, crypto::CryptoService::NONCE_BYTES);
+                std::memcpy(record.nonce.data(), nonce_blob, crypto::CryptoService::NONCE_BYTES);
 
                 const void* ct_blob = sqlite3_column_blob(select_stmt.get(), 2);
                 int ct_size = sqlite3_column_bytes(select_stmt.get(), 2);
                 if (ct_size <= 0 || !ct_blob) {
                     throw std::runtime_error("Corrupted note ciphertext during password change");
                 }
-                row.ciphertext.assign(
+                record.ciphertext.assign(
                     static_cast<const uint8_t*>(ct_blob),
                     static_cast<const uint8_t*>(ct_blob) + ct_size);
-
-                rows.push_back(std::move(row));
+                record.algorithm = static_cast<crypto::CryptoService::Algorithm>(
+                    sqlite3_column_int(select_stmt.get(), 3));
+
+                bool is_packed = sqlite3_column_int(select_stmt.get(), 4) != 0;
+                ids.push_back(id);
+                records.push_back(std::move(record));
+                aads.push_back(is_packed ? storage::RecordAad::pack_ref(id)
+                                         : storage::RecordAad::note(id));
+                packed.push_back(is_packed);
             }
 
-            // Decrypt with old key, re-encrypt with new key
-            for (const auto& row : rows) {
-                // Build AAD (note_id as 4-byte LE)
-                std::vector<uint8_t> aad(4);
-                uint32_t id32 = static_cast<uint32_t>(row.id);
-                std::memcpy(aad.data(), &id32, 4);
+            // Decrypt with old key, re-encrypt with new key, in bounded
+            // batches so the locked plaintext arena stays small
+            constexpr size_t kBatchRows = 256;
+            ScopedStmt update_stmt(db.get(),
+                "UPDATE notes SET nonce = ?, ciphertext = ?, alg = ? WHERE id = ?");
+
+            for (size_t first = 0; first < records.size(); first += kBatchRows) {
+                size_t n = std::min(kBatchRows, records.size() - first);
+                std::span<const crypto::CryptoService::EncryptedData> batch_records(
+                    records.data() + first, n);
+                std::span<const std::vector<uint8_t>> batch_aads(aads.data() + first, n);
 
                 // Decrypt with old notes subkey
-                crypto::CryptoService::EncryptedData old_enc{row.ciphertext, row.nonce};
-                auto plaintext = crypto::CryptoService::decrypt(old_enc, *notes_subkey_, aad);
-                if (!plaintext.has_value()) {
-                    throw std::runtime_error("Failed to decrypt note " + std::to_string(row.id) +
-                                             " during password change");
+                auto plain = crypto::CryptoService::decrypt_many(
+                    batch_records, *notes_subkey_, batch_aads);
+
+                std::vector<std::span<const uint8_t>> plaintexts;
+                plaintexts.reserve(n);
+                for (size_t i = 0; i < n; ++i) {
+                    if (!plain.ok[i]) {
+                        throw std::runtime_error("Failed to decrypt note " +
+                                                 std::to_string(ids[first + i]) +
+                                                 " during password change");
+                    }
+                    plaintexts.push_back(plain.plaintext(i));
                 }
 
-                // Re-encrypt with new notes subkey (same AAD)
-                auto new_enc = crypto::CryptoService::encrypt(*plaintext, new_notes_subkey, aad);
-
-                // Update row
-                ScopedStmt update_stmt(db.get(),
-                    "UPDATE notes SET nonce = ?, ciphertext = ? WHERE id = ?");
-                sqlite3_bind_blob(update_stmt.get(), 1, new_enc.nonce.data(),
-                                  static_cast<int>(new_enc.nonce.size()), SQLITE_STATIC);
-                sqlite3_bind_blob(update_stmt.get(), 2, new_enc.ciphertext.data(),
-                                  static_cast<int>(new_enc.ciphertext.size()), SQLITE_STATIC);
-                sqlite3_bind_int64(update_stmt.get(), 3, row.id);
-
-                int rc = sqlite3_step(update_stmt.get());
-                if (rc != SQLITE_DONE) {
-                    throw std::runtime_error("Failed to re-encrypt note " + std::to_string(row.id));
+                // Re-encrypt with new notes subkey (same AAD), upgrading to
+                // the preferred algorithm for this machine
+                auto enc = crypto::CryptoService::encrypt_many(
+                    plaintexts, new_notes_subkey, batch_aads,
+                    crypto::CryptoService::preferred_algorithm());
+
+                // Update rows
+                for (size_t i = 0; i < n; ++i) {
+                    auto ct = enc.ciphertext(i);
+                    sqlite3_reset(update_stmt.get());
+                    sqlite3_bind_blob(update_stmt.get(), 1, enc.nonces[i].data(),
+                                      static_cast<int>(enc.nonces[i].size()), SQLITE_STATIC);
+                    sqlite3_bind_blob(update_stmt.get(), 2, ct.data(),
+                                      static_cast<int>(ct.size()), SQLITE_STATIC);
+                    sqlite3_bind_int(update_stmt.get(), 3, static_cast<int>(enc.algorithm));
+                    sqlite3_bind_int64(update_stmt.get(), 4, ids[first + i]);
+
+                    int rc = sqlite3_step(update_stmt.get());
+                    if (rc != SQLITE_DONE) {
+                        throw std::runtime_error("Failed to re-encrypt note " +
+                                                 std::to_string(ids[first + i]));
+                    }
+                }
+
+                // Legacy large bodies: the stream is bound to the record
+                // nonce, so it is re-encrypted along with the record
+                for (size_t i = 0; i < n; ++i) {
+                    if (packed[first + i]) {
+                        continue;
+                    }
+                    restream_note_chunks(db.get(), ids[first + i],
+                                         records[first + i].nonce, enc.nonces[i],
+                                         *notes_subkey_, new_notes_subkey);
                 }
             }
         }
 
+        // Step 5a: Re-encrypt content-defined body chunks (notes subkey). Their
+        // AAD does not involve the record, so records and manifests are
+        // unchanged.
+        reencrypt_records(db.get(), "content_chunks", "note_id, chunk_id",
+            [](sqlite3_stmt* stmt) {
+                return storage::RecordAad::content_chunk(
+                    sqlite3_column_int64(stmt, 4),
+                    static_cast<uint64_t>(sqlite3_column_int64(stmt, 5)));
+            },
+            *notes_subkey_, new_notes_subkey);
+
+        // Step 5b: Re-encrypt compression dictionaries (notes subkey); notes
+        // compressed against one that fails would become unreadable
+        reencrypt_records(db.get(), "compression_dicts", "dict_id",
+            [](sqlite3_stmt* stmt) {
+                return storage::RecordAad::dictionary(
+                    static_cast<uint32_t>(sqlite3_column_int64(stmt, 4)));
+            },
+            *notes_subkey_, new_notes_subkey);
+
+        // Step 5c: Re-encrypt cold-storage packs (notes subkey), one at a
+        // time since each holds many notes
+        reencrypt_records(db.get(), "note_packs", "pack_id",
+            [](sqlite3_stmt* stmt) {
+                return storage::RecordAad::pack(sqlite3_column_int64(stmt, 4));
+            },
+            *notes_subkey_, new_notes_subkey, 1);
+
+        // Step 5d: Re-wrap attachment keys and re-encrypt attachment links
+        // and vault keys (notes subkey); attachment contents are untouched
+        reencrypt_records(db.get(), "attachments", "attachment_id",
+            [](sqlite3_stmt* stmt) {
+                return storage::RecordAad::attachment_key(sqlite3_column_int64(stmt, 4));
+            },
+            *notes_subkey_, new_notes_subkey);
+        reencrypt_records(db.get(), "attachment_refs", "note_id, attachment_id",
+            [](sqlite3_stmt* stmt) {
+                return storage::RecordAad::attachment_link(sqlite3_column_int64(stmt, 4),
+                                                           sqlite3_column_int64(stmt, 5));
+            },
+            *notes_subkey_, new_notes_subkey);
+        reencrypt_records(db.get(), "vault_keys", "purpose",
+            [](sqlite3_stmt* stmt) {
+                const auto* text = sqlite3_column_text(stmt, 4);
+                return storage::RecordAad::vault_key(std::string_view(
+                    reinterpret_cast<const char*>(text), sqlite3_column_bytes(stmt, 4)));
+            },
+            *notes_subkey_, new_notes_subkey);
+
+        // Step 5e: Re-encrypt note revisions (notes subkey); deltas and
+        // keyframes are re-encrypted as stored, still compressed
+        reencrypt_records(db.get(), "note_revisions", "note_id, revision_id",
+            [](sqlite3_stmt* stmt) {
+                return storage::RecordAad::revision(sqlite3_column_int64(stmt, 4),
+                                                    sqlite3_column_int64(stmt, 5));
+            },
+            *notes_subkey_, new_notes_subkey);
+
         // Step 6: Re-encrypt verify token
         {
             exec_sql(db.get(), "DELETE FROM vault_verify;");
@@ -541,6 +1038,10 @@ bool VaultService::change_password(const std::string& current_password,
             }
         }
 
+        // Step 7b: Drop the maintenance log rather than re-encrypt it; it
+        // only holds timings, and every task is simply due again
+        exec_sql(db.get(), "DELETE FROM maintenance_log;");
+
         // Step 8: Update vault_meta with new salt
         {
             exec_sql(db.get(), "DELETE FROM vault_meta;");
@@ -596,6 +1097,9 @@ bool VaultService::change_password(const std::string& current_password,
     settings_subkey_.emplace(std::move(new_settings_subkey));
     db_subkey_.emplace(std::move(new_db_subkey));
 
+    // A PIN-wrapped copy of the old master key must not outlive it
+    disarm_quick_unlock();
+
     return true;
 }
 
@@ -606,6 +1110,14 @@ const std::string& VaultService::vault_path() const {
 // === Private Helpers ===
 
 void VaultService::wipe_keys() {
+    session_.cancel();
+
+    // Connections hold derived keys too; closing them wipes SQLCipher's copies
+    pool_.reset();
+    wipe_key_material();
+}
+
+void VaultService::wipe_key_material() {
     // Resetting optionals triggers SecureBuffer destructor → sodium_memzero
     master_key_.reset();
     notes_subkey_.reset();
@@ -614,6 +1126,41 @@ void VaultService::wipe_keys() {
     db_subkey_.reset();
 }
 
+void VaultService::derive_subkeys_from_master() {
+    db_subkey_.emplace(
+        crypto::CryptoService::derive_subkey(*master_key_, crypto::CryptoService::SUBKEY_DATABASE));
+    verify_subkey_.emplace(
+        crypto::CryptoService::derive_subkey(*master_key_, crypto::CryptoService::SUBKEY_VERIFY));
+    notes_subkey_.emplace(
+        crypto::CryptoService::derive_subkey(*master_key_, crypto::CryptoService::SUBKEY_NOTES));
+    settings_subkey_.emplace(
+        crypto::CryptoService::derive_subkey(*master_key_, crypto::CryptoService::SUBKEY_SETTINGS));
+}
+
+crypto::SecureKey VaultService::derive_pin_key(const std::string& pin, const QuickUnlock& quick) {
+    // Argon2id at interactive cost, so each guess is expensive even with the
+    // secret in hand...
+    crypto::SecureKey stretched(crypto::CryptoService::KEY_BYTES);
+    int rc = crypto_pwhash(
+        stretched.data(), stretched.size(),
+        pin.data(), pin.size(),
+        quick.salt.data(),
+        QUICK_UNLOCK_OPSLIMIT,
+        QUICK_UNLOCK_MEMLIMIT,
+        crypto_pwhash_ALG_ARGON2ID13);
+    if (rc != 0) {
+        throw std::runtime_error("Quick-unlock key derivation failed (out of memory)");
+    }
+
+    // ...and keyed with the per-arming secret, so the wrapped key alone (a
+    // heap dump, swap) gives nothing to brute-force the short PIN against
+    crypto::SecureKey key(crypto::CryptoService::KEY_BYTES);
+    crypto_generichash(key.data(), key.size(),
+                       stretched.data(), stretched.size(),
+                       quick.session_secret.data(), quick.session_secret.size());
+    return key;
+}
+
 void VaultService::create_schema(sqlite3* db) {
     exec_sql(db, R"(
         CREATE TABLE IF NOT EXISTS vault_meta (
@@ -638,16 +1185,143 @@ void VaultService::create_schema(sqlite3* db) {
             nonce       BLOB NOT NULL,
             ciphertext  BLOB NOT NULL,
             created_at  INTEGER NOT NULL,
-            updated_at  INTEGER NOT NULL
+            updated_at  INTEGER NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0,
+            codec       INTEGER NOT NULL DEFAULT 0,
+            pack_id     INTEGER,
+            change_seq  INTEGER
         );
     )");
 
+    exec_sql(db, "CREATE INDEX IF NOT EXISTS idx_notes_pack ON notes(pack_id);");
+    exec_sql(db, "CREATE INDEX IF NOT EXISTS idx_notes_updated ON notes(updated_at);");
+
     exec_sql(db, R"(
         CREATE TABLE IF NOT EXISTS vault_settings (
             nonce      BLOB NOT NULL,
             ciphertext BLOB NOT NULL
         );
     )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS maintenance_log (
+            nonce      BLOB NOT NULL,
+            ciphertext BLOB NOT NULL
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS note_chunks (
+            note_id INTEGER NOT NULL,
+            seq     INTEGER NOT NULL,
+            data    BLOB NOT NULL,
+            PRIMARY KEY (note_id, seq)
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS compression_dicts (
+            dict_id     INTEGER PRIMARY KEY,
+            nonce       BLOB NOT NULL,
+            ciphertext  BLOB NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0,
+            created_at  INTEGER NOT NULL
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS content_chunks (
+            note_id     INTEGER NOT NULL,
+            chunk_id    INTEGER NOT NULL,
+            nonce       BLOB NOT NULL,
+            ciphertext  BLOB NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0,
+            released_by INTEGER,
+            PRIMARY KEY (note_id, chunk_id)
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS note_packs (
+            pack_id     INTEGER PRIMARY KEY AUTOINCREMENT,
+            nonce       BLOB NOT NULL,
+            ciphertext  BLOB NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0,
+            codec       INTEGER NOT NULL DEFAULT 0,
+            note_count  INTEGER NOT NULL,
+            created_at  INTEGER NOT NULL
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS attachments (
+            attachment_id INTEGER PRIMARY KEY AUTOINCREMENT,
+            content_id    BLOB NOT NULL UNIQUE,
+            nonce         BLOB NOT NULL,
+            ciphertext    BLOB NOT NULL,
+            alg           INTEGER NOT NULL DEFAULT 0,
+            header        BLOB NOT NULL,
+            size          INTEGER NOT NULL,
+            chunk_count   INTEGER NOT NULL,
+            created_at    INTEGER NOT NULL
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS attachment_chunks (
+            attachment_id INTEGER NOT NULL,
+            seq           INTEGER NOT NULL,
+            data          BLOB NOT NULL,
+            PRIMARY KEY (attachment_id, seq)
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS attachment_refs (
+            note_id       INTEGER NOT NULL,
+            attachment_id INTEGER NOT NULL,
+            nonce         BLOB NOT NULL,
+            ciphertext    BLOB NOT NULL,
+            alg           INTEGER NOT NULL DEFAULT 0,
+            created_at    INTEGER NOT NULL,
+            PRIMARY KEY (note_id, attachment_id)
+        );
+    )");
+
+    exec_sql(db, "CREATE INDEX IF NOT EXISTS idx_attachment_refs_attachment "
+                 "ON attachment_refs(attachment_id);");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS vault_keys (
+            purpose     TEXT PRIMARY KEY,
+            nonce       BLOB NOT NULL,
+            ciphertext  BLOB NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS note_revisions (
+            note_id     INTEGER NOT NULL,
+            revision_id INTEGER NOT NULL,
+            keyframe    INTEGER NOT NULL,
+            nonce       BLOB NOT NULL,
+            ciphertext  BLOB NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0,
+            codec       INTEGER NOT NULL DEFAULT 0,
+            saved_at    INTEGER NOT NULL,
+            recorded_at INTEGER NOT NULL,
+            PRIMARY KEY (note_id, revision_id)
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS note_changes (
+            seq      INTEGER PRIMARY KEY AUTOINCREMENT,
+            note_id  INTEGER NOT NULL,
+            deleted  INTEGER NOT NULL
+        );
+    )");
 }
 
 void VaultService::migrate_schema(sqlite3* db) {
@@ -658,6 +1332,164 @@ void VaultService::migrate_schema(sqlite3* db) {
             ciphertext BLOB NOT NULL
         );
     )");
+
+    // Encrypted log of idle-time maintenance (MaintenanceScheduler)
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS maintenance_log (
+            nonce      BLOB NOT NULL,
+            ciphertext BLOB NOT NULL
+        );
+    )");
+
+    // Chunked bodies of large notes (none in older vaults)
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS note_chunks (
+            note_id INTEGER NOT NULL,
+            seq     INTEGER NOT NULL,
+            data    BLOB NOT NULL,
+            PRIMARY KEY (note_id, seq)
+        );
+    )");
+
+    // Per-record AEAD identifier; existing rows are XChaCha20-Poly1305 (0)
+    if (!column_exists(db, "notes", "alg")) {
+        exec_sql(db, "ALTER TABLE notes ADD COLUMN alg INTEGER NOT NULL DEFAULT 0;");
+    }
+
+    // Per-record payload codec; existing rows are uncompressed (0)
+    if (!column_exists(db, "notes", "codec")) {
+        exec_sql(db, "ALTER TABLE notes ADD COLUMN codec INTEGER NOT NULL DEFAULT 0;");
+    }
+
+    // Trained zstd dictionaries (encrypted under the notes subkey)
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS compression_dicts (
+            dict_id     INTEGER PRIMARY KEY,
+            nonce       BLOB NOT NULL,
+            ciphertext  BLOB NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0,
+            created_at  INTEGER NOT NULL
+        );
+    )");
+
+    // Content-defined body chunks of large notes
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS content_chunks (
+            note_id     INTEGER NOT NULL,
+            chunk_id    INTEGER NOT NULL,
+            nonce       BLOB NOT NULL,
+            ciphertext  BLOB NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0,
+            released_by INTEGER,
+            PRIMARY KEY (note_id, chunk_id)
+        );
+    )");
+    // Chunks only revisions still reference name the newest such revision
+    if (!column_exists(db, "content_chunks", "released_by")) {
+        exec_sql(db, "ALTER TABLE content_chunks ADD COLUMN released_by INTEGER;");
+    }
+
+    // Cold-storage packs; notes rows name the pack holding their record
+    if (!column_exists(db, "notes", "pack_id")) {
+        exec_sql(db, "ALTER TABLE notes ADD COLUMN pack_id INTEGER;");
+    }
+    exec_sql(db, "CREATE INDEX IF NOT EXISTS idx_notes_pack ON notes(pack_id);");
+
+    // Notes by recency (list, search) without sorting
+    exec_sql(db, "CREATE INDEX IF NOT EXISTS idx_notes_updated ON notes(updated_at);");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS note_packs (
+            pack_id     INTEGER PRIMARY KEY AUTOINCREMENT,
+            nonce       BLOB NOT NULL,
+            ciphertext  BLOB NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0,
+            codec       INTEGER NOT NULL DEFAULT 0,
+            note_count  INTEGER NOT NULL,
+            created_at  INTEGER NOT NULL
+        );
+    )");
+
+    // Encrypted attachments, their links to notes, and wrapped vault-wide keys
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS attachments (
+            attachment_id INTEGER PRIMARY KEY AUTOINCREMENT,
+            content_id    BLOB NOT NULL UNIQUE,
+            nonce         BLOB NOT NULL,
+            ciphertext    BLOB NOT NULL,
+            alg           INTEGER NOT NULL DEFAULT 0,
+            header        BLOB NOT NULL,
+            size          INTEGER NOT NULL,
+            chunk_count   INTEGER NOT NULL,
+            created_at    INTEGER NOT NULL
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS attachment_chunks (
+            attachment_id INTEGER NOT NULL,
+            seq           INTEGER NOT NULL,
+            data          BLOB NOT NULL,
+            PRIMARY KEY (attachment_id, seq)
+        );
+    )");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS attachment_refs (
+            note_id       INTEGER NOT NULL,
+            attachment_id INTEGER NOT NULL,
+            nonce         BLOB NOT NULL,
+            ciphertext    BLOB NOT NULL,
+            alg           INTEGER NOT NULL DEFAULT 0,
+            created_at    INTEGER NOT NULL,
+            PRIMARY KEY (note_id, attachment_id)
+        );
+    )");
+
+    exec_sql(db, "CREATE INDEX IF NOT EXISTS idx_attachment_refs_attachment "
+                 "ON attachment_refs(attachment_id);");
+
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS vault_keys (
+            purpose     TEXT PRIMARY KEY,
+            nonce       BLOB NOT NULL,
+            ciphertext  BLOB NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0
+        );
+    )");
+
+    // Note revision history (reverse deltas and keyframes)
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS note_revisions (
+            note_id     INTEGER NOT NULL,
+            revision_id INTEGER NOT NULL,
+            keyframe    INTEGER NOT NULL,
+            nonce       BLOB NOT NULL,
+            ciphertext  BLOB NOT NULL,
+            alg         INTEGER NOT NULL DEFAULT 0,
+            codec       INTEGER NOT NULL DEFAULT 0,
+            saved_at    INTEGER NOT NULL,
+            recorded_at INTEGER NOT NULL,
+            PRIMARY KEY (note_id, revision_id)
+        );
+    )");
+
+    // Change log for incremental export; every existing note starts with
+    // one entry so the first export includes it
+    exec_sql(db, R"(
+        CREATE TABLE IF NOT EXISTS note_changes (
+            seq      INTEGER PRIMARY KEY AUTOINCREMENT,
+            note_id  INTEGER NOT NULL,
+            deleted  INTEGER NOT NULL
+        );
+    )");
+    if (!column_exists(db, "notes", "change_seq")) {
+        exec_sql(db, "ALTER TABLE notes ADD COLUMN change_seq INTEGER;");
+        exec_sql(db, "INSERT INTO note_changes (note_id, deleted) "
+                     "SELECT id, 0 FROM notes ORDER BY id;");
+        exec_sql(db, "UPDATE notes SET change_seq = "
+                     "(SELECT seq FROM note_changes WHERE note_changes.note_id = notes.id);");
+    }
 }
 
 void VaultService::store_vault_meta(sqlite3* db) {
@@ -763,24 +1595,59 @@ std::string VaultService::salt_path(const std::string& vault_path) {
     return (p.parent_path() / (p.stem().string() + ".salt")).string();
 }
 
+// After the salt, for vaults not in the legacy format: "BXCF" ||
+// cipher_page_size (4) || kdf_iter (4), little-endian. Legacy-format
+// sidecars stay 16 bytes, as older builds wrote them.
+static constexpr char kFormatMagic[4] = {'B', 'X', 'C', 'F'};
+static constexpr size_t kFormatBytes = 4 + 4 + 4;
+
 void VaultService::write_salt_file(const std::array<uint8_t, crypto::CryptoService::SALT_BYTES>& salt) {
     std::ofstream f(salt_path(vault_path_), std::ios::binary | std::ios::trunc);
     if (!f) {
         throw std::runtime_error("Failed to write salt sidecar file");
     }
     f.write(reinterpret_cast<const char*>(salt.data()), salt.size());
+    if (profile_.same_format(storage::ConnectionProfile::legacy_format())) {
+        return;
+    }
+
+    uint8_t format[kFormatBytes];
+    uint32_t page_size = static_cast<uint32_t>(profile_.cipher_page_size);
+    uint32_t kdf_iter = static_cast<uint32_t>(profile_.kdf_iter);
+    std::memcpy(format, kFormatMagic, 4);
+    std::memcpy(format + 4, &page_size, 4);
+    std::memcpy(format + 8, &kdf_iter, 4);
+    f.write(reinterpret_cast<const char*>(format), kFormatBytes);
 }
 
 bool VaultService::read_salt_file(std::array<uint8_t, crypto::CryptoService::SALT_BYTES>& salt) {
     std::ifstream f(salt_path(vault_path_), std::ios::binary);
     if (!f) return false;
     f.read(reinterpret_cast<char*>(salt.data()), salt.size());
-    return f.gcount() == static_cast<std::streamsize>(salt.size());
+    if (f.gcount() != static_cast<std::streamsize>(salt.size())) {
+        return false;
+    }
+
+    auto format = storage::ConnectionProfile::legacy_format();
+    uint8_t stored[kFormatBytes];
+    f.read(reinterpret_cast<char*>(stored), kFormatBytes);
+    if (f.gcount() == static_cast<std::streamsize>(kFormatBytes) &&
+        std::memcmp(stored, kFormatMagic, 4) == 0) {
+        uint32_t page_size = 0, kdf_iter = 0;
+        std::memcpy(&page_size, stored + 4, 4);
+        std::memcpy(&kdf_iter, stored + 8, 4);
+        format.cipher_page_size = static_cast<int>(page_size);
+        format.kdf_iter = static_cast<int>(kdf_iter);
+    }
+    profile_ = profile_.with_format_of(format);
+    return true;
 }
 
 // === Migration from Unencrypted (pre-Phase 5) Vaults ===
 
 bool VaultService::migrate_and_unlock(const std::string& password) {
+    // sqlcipher_export() writes SQLCipher's default format
+    profile_ = profile_.with_format_of(storage::ConnectionProfile::legacy_format());
     std::optional<crypto::SecureKey> db_key;
     auto encrypted_path = vault_path_ + ".encrypted";
     auto backup_path = vault_path_ + ".bak";
@@ -880,7 +1747,7 @@ bool VaultService::migrate_and_unlock(const std::string& password) {
 
     // Verify the encrypted DB opens correctly and migrate schema
     {
-        ScopedDb enc_db(vault_path_, &*db_subkey_);
+        ScopedDb enc_db(vault_path_, &*db_subkey_, profile_);
         migrate_schema(enc_db.get());
     }
 
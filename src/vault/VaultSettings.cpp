@@ -10,6 +10,14 @@ std::string VaultSettings::to_json() const {
     j["auto_lock_minutes"] = auto_lock_minutes;
     j["clipboard_clear_enabled"] = clipboard_clear_enabled;
     j["clipboard_clear_seconds"] = clipboard_clear_seconds;
+    j["quick_unlock_enabled"] = quick_unlock_enabled;
+    j["quick_unlock_minutes"] = quick_unlock_minutes;
+    j["cold_pack_enabled"] = cold_pack_enabled;
+    j["cold_pack_days"] = cold_pack_days;
+    j["revision_keep_days"] = revision_keep_days;
+    j["backup_enabled"] = backup_enabled;
+    j["backup_interval_hours"] = backup_interval_hours;
+    j["backup_keep"] = backup_keep;
     return j.dump();
 }
 
@@ -27,6 +35,30 @@ VaultSettings VaultSettings::from_json(const std::string& json_str) {
         if (j.contains("clipboard_clear_seconds") && j["clipboard_clear_seconds"].is_number_integer()) {
             s.clipboard_clear_seconds = std::clamp(j["clipboard_clear_seconds"].get<int>(), 10, 120);
         }
+        if (j.contains("quick_unlock_enabled") && j["quick_unlock_enabled"].is_boolean()) {
+            s.quick_unlock_enabled = j["quick_unlock_enabled"].get<bool>();
+        }
+        if (j.contains("quick_unlock_minutes") && j["quick_unlock_minutes"].is_number_integer()) {
+            s.quick_unlock_minutes = std::clamp(j["quick_unlock_minutes"].get<int>(), 5, 480);
+        }
+        if (j.contains("cold_pack_enabled") && j["cold_pack_enabled"].is_boolean()) {
+            s.cold_pack_enabled = j["cold_pack_enabled"].get<bool>();
+        }
+        if (j.contains("cold_pack_days") && j["cold_pack_days"].is_number_integer()) {
+            s.cold_pack_days = std::clamp(j["cold_pack_days"].get<int>(), 30, 3650);
+        }
+        if (j.contains("revision_keep_days") && j["revision_keep_days"].is_number_integer()) {
+            s.revision_keep_days = std::clamp(j["revision_keep_days"].get<int>(), 1, 3650);
+        }
+        if (j.contains("backup_enabled") && j["backup_enabled"].is_boolean()) {
+            s.backup_enabled = j["backup_enabled"].get<bool>();
+        }
+        if (j.contains("backup_interval_hours") && j["backup_interval_hours"].is_number_integer()) {
+            s.backup_interval_hours = std::clamp(j["backup_interval_hours"].get<int>(), 1, 168);
+        }
+        if (j.contains("backup_keep") && j["backup_keep"].is_number_integer()) {
+            s.backup_keep = std::clamp(j["backup_keep"].get<int>(), 1, 50);
+        }
     } catch (...) {
         return defaults();
     }
@@ -34,13 +66,21 @@ VaultSettings VaultSettings::from_json(const std::string& json_str) {
 }
 
 VaultSettings VaultSettings::defaults() {
-    return VaultSettings{5, true, 30};
+    return VaultSettings{5, true, 30, false, 60, true, 90, 30, true, 24, 5};
 }
 
 bool VaultSettings::operator==(const VaultSettings& other) const {
     return auto_lock_minutes == other.auto_lock_minutes &&
            clipboard_clear_enabled == other.clipboard_clear_enabled &&
-           clipboard_clear_seconds == other.clipboard_clear_seconds;
+           clipboard_clear_seconds == other.clipboard_clear_seconds &&
+           quick_unlock_enabled == other.quick_unlock_enabled &&
+           quick_unlock_minutes == other.quick_unlock_minutes &&
+           cold_pack_enabled == other.cold_pack_enabled &&
+           cold_pack_days == other.cold_pack_days &&
+           revision_keep_days == other.revision_keep_days &&
+           backup_enabled == other.backup_enabled &&
+           backup_interval_hours == other.backup_interval_hours &&
+           backup_keep == other.backup_keep;
 }
 
 }  // namespace vault
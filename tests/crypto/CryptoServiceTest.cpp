@@ -2,7 +2,9 @@
 #include "bastionx/crypto/CryptoService.h"
 #include "test_vectors.h"
 #include <sodium.h>
+#include <algorithm>
 #include <chrono>
+#include <span>
 
 using namespace bastionx::crypto;
 
@@ -272,6 +274,122 @@ TEST_F(CryptoServiceTest, CiphertextTamperingDetected) {
     EXPECT_FALSE(decrypted.has_value()) << "Decryption of tampered ciphertext should fail";
 }
 
+// ===================================================================
+// Test 11: AES-256-GCM round-trip, tampering and AAD binding
+// ===================================================================
+TEST_F(CryptoServiceTest, Aes256GcmRoundTrip) {
+    if (!CryptoService::aes256gcm_available()) {
+        GTEST_SKIP() << "AES-256-GCM not available on this CPU";
+    }
+
+    const std::vector<uint8_t> plaintext(4096, 0x5A);
+    const std::vector<uint8_t> aad = {0x07, 0x00, 0x00, 0x00};
+
+    auto master = CryptoService::derive_master_key("password", std::nullopt);
+    auto subkey = CryptoService::derive_subkey(master.master_key, 1);
+
+    auto encrypted = CryptoService::encrypt(
+        plaintext, subkey, aad, CryptoService::Algorithm::Aes256Gcm);
+    EXPECT_EQ(CryptoService::Algorithm::Aes256Gcm, encrypted.algorithm);
+    EXPECT_EQ(plaintext.size() + 16, encrypted.ciphertext.size());
+
+    auto decrypted = CryptoService::decrypt(encrypted, subkey, aad);
+    ASSERT_TRUE(decrypted.has_value());
+    EXPECT_EQ(plaintext, *decrypted);
+
+    // AAD is bound
+    EXPECT_FALSE(CryptoService::decrypt(encrypted, subkey, {0x08, 0x00, 0x00, 0x00}).has_value());
+
+    // Nonce bytes feeding the record key are bound too
+    auto wrong_nonce = encrypted;
+    wrong_nonce.nonce[0] ^= 0x01;
+    EXPECT_FALSE(CryptoService::decrypt(wrong_nonce, subkey, aad).has_value());
+
+    // Tampered ciphertext is rejected
+    encrypted.ciphertext[0] ^= 0xFF;
+    EXPECT_FALSE(CryptoService::decrypt(encrypted, subkey, aad).has_value());
+}
+
+// ===================================================================
+// Test 12: A record only decrypts under the algorithm it was written with
+// ===================================================================
+TEST_F(CryptoServiceTest, AlgorithmIdentifierIsHonored) {
+    const std::vector<uint8_t> plaintext = {0x01, 0x02, 0x03, 0x04};
+
+    auto master = CryptoService::derive_master_key("password", std::nullopt);
+    auto subkey = CryptoService::derive_subkey(master.master_key, 1);
+
+    // Default remains XChaCha20-Poly1305 (legacy records, settings, verify token)
+    auto encrypted = CryptoService::encrypt(plaintext, subkey, {});
+    EXPECT_EQ(CryptoService::Algorithm::XChaCha20Poly1305, encrypted.algorithm);
+
+    auto relabeled = encrypted;
+    relabeled.algorithm = CryptoService::Algorithm::Aes256Gcm;
+    EXPECT_FALSE(CryptoService::decrypt(relabeled, subkey, {}).has_value());
+
+    auto unknown = encrypted;
+    unknown.algorithm = static_cast<CryptoService::Algorithm>(0x7F);
+    EXPECT_FALSE(CryptoService::decrypt(unknown, subkey, {}).has_value());
+
+    // Preferred algorithm tracks hardware support
+    EXPECT_EQ(CryptoService::aes256gcm_available(),
+              CryptoService::preferred_algorithm() == CryptoService::Algorithm::Aes256Gcm);
+}
+
+// ===================================================================
+// Test 13: Batch encryption matches per-record semantics
+// ===================================================================
+TEST_F(CryptoServiceTest, BatchRoundTrip) {
+    auto master = CryptoService::derive_master_key("password", std::nullopt);
+    auto subkey = CryptoService::derive_subkey(master.master_key, 1);
+
+    // Mix of sizes, large enough in total to take the parallel path
+    std::vector<std::vector<uint8_t>> plaintexts;
+    std::vector<std::vector<uint8_t>> aads;
+    for (size_t i = 0; i < 64; ++i) {
+        plaintexts.emplace_back(i * 1024 + i, static_cast<uint8_t>(i));
+        aads.push_back({static_cast<uint8_t>(i), 0, 0, 0});
+    }
+    std::vector<std::span<const uint8_t>> views(plaintexts.begin(), plaintexts.end());
+
+    auto batch = CryptoService::encrypt_many(views, subkey, aads);
+    ASSERT_EQ(plaintexts.size(), batch.size());
+
+    // Each record is an ordinary EncryptedData with a distinct nonce
+    std::vector<CryptoService::EncryptedData> records;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto ct = batch.ciphertext(i);
+        records.push_back({{ct.begin(), ct.end()}, batch.nonces[i], batch.algorithm});
+        if (i > 0) {
+            EXPECT_NE(batch.nonces[i - 1], batch.nonces[i]);
+        }
+    }
+
+    auto single = CryptoService::decrypt(records[5], subkey, aads[5]);
+    ASSERT_TRUE(single.has_value());
+    EXPECT_EQ(plaintexts[5], *single);
+
+    // Tamper with one record: only that record fails
+    records[10].ciphertext[0] ^= 0xFF;
+
+    auto decrypted = CryptoService::decrypt_many(records, subkey, aads);
+    ASSERT_EQ(records.size(), decrypted.size());
+    for (size_t i = 0; i < decrypted.size(); ++i) {
+        if (i == 10) {
+            EXPECT_FALSE(decrypted.ok[i]);
+            EXPECT_TRUE(decrypted.plaintext(i).empty());
+            continue;
+        }
+        ASSERT_TRUE(decrypted.ok[i]) << "record " << i;
+        auto pt = decrypted.plaintext(i);
+        EXPECT_TRUE(std::equal(pt.begin(), pt.end(), plaintexts[i].begin(), plaintexts[i].end()));
+    }
+
+    // AAD count must match
+    EXPECT_THROW(CryptoService::decrypt_many(records, subkey, std::span(aads).first(3)),
+                 std::invalid_argument);
+}
+
 // ===================================================================
 // Bonus Test: Performance benchmark for key derivation
 // ===================================================================
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "bastionx/crypto/SecureArena.h"
+#include "bastionx/crypto/SecureMemory.h"
+#include <algorithm>
+#include <vector>
+
+using namespace bastionx::crypto;
+
+// ===================================================================
+// Test 1: Small allocations are served from the slab region
+// ===================================================================
+TEST(SecureArenaTest, SmallAllocationsComeFromRegion) {
+    SecureArena arena(4);
+
+    void* p = arena.allocate(32);
+    ASSERT_NE(nullptr, p);
+    EXPECT_TRUE(arena.owns(p));
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(p) % SecureArena::kMinBlockBytes);
+
+    auto stats = arena.stats();
+    EXPECT_EQ(4 * SecureArena::kSlabBytes, stats.region_bytes);
+    EXPECT_EQ(32u, stats.slab_bytes_in_use);
+    EXPECT_EQ(1u, stats.live_allocations);
+    EXPECT_EQ(0u, stats.fallback_allocations);
+
+    arena.deallocate(p, 32);
+    stats = arena.stats();
+    EXPECT_EQ(0u, stats.slab_bytes_in_use);
+    EXPECT_EQ(0u, stats.live_allocations);
+    EXPECT_EQ(32u, stats.peak_slab_bytes_in_use);
+}
+
+// ===================================================================
+// Test 2: Requests are rounded up to their size class
+// ===================================================================
+TEST(SecureArenaTest, RoundsToSizeClass) {
+    SecureArena arena(4);
+
+    void* p = arena.allocate(33);
+    EXPECT_EQ(64u, arena.stats().slab_bytes_in_use);
+    arena.deallocate(p, 33);
+}
+
+// ===================================================================
+// Test 3: Large allocations fall back to sodium_malloc
+// ===================================================================
+TEST(SecureArenaTest, LargeAllocationsFallBack) {
+    SecureArena arena(4);
+
+    size_t big = SecureArena::kMaxBlockBytes + 1;
+    void* p = arena.allocate(big);
+    ASSERT_NE(nullptr, p);
+    EXPECT_FALSE(arena.owns(p));
+
+    auto stats = arena.stats();
+    EXPECT_EQ(1u, stats.fallback_allocations);
+    EXPECT_GE(stats.fallback_bytes_in_use, big);
+    EXPECT_EQ(stats.region_bytes + stats.fallback_bytes_in_use, stats.locked_bytes());
+
+    arena.deallocate(p, big);
+    EXPECT_EQ(0u, arena.stats().fallback_bytes_in_use);
+}
+
+// ===================================================================
+// Test 4: Exhausted region falls back instead of failing
+// ===================================================================
+TEST(SecureArenaTest, ExhaustedRegionFallsBack) {
+    SecureArena arena(1);
+
+    size_t per_slab = SecureArena::kSlabBytes / SecureArena::kMaxBlockBytes;
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < per_slab + 1; ++i) {
+        blocks.push_back(arena.allocate(SecureArena::kMaxBlockBytes));
+    }
+
+    EXPECT_TRUE(arena.owns(blocks.front()));
+    EXPECT_FALSE(arena.owns(blocks.back()));
+    EXPECT_EQ(1u, arena.stats().fallback_allocations);
+
+    for (void* p : blocks) {
+        arena.deallocate(p, SecureArena::kMaxBlockBytes);
+    }
+    EXPECT_EQ(0u, arena.stats().live_allocations);
+}
+
+// ===================================================================
+// Test 5: Released blocks are wiped and reusable by other size classes
+// ===================================================================
+TEST(SecureArenaTest, ReleasedBlocksAreWipedAndReused) {
+    SecureArena arena(1);
+
+    auto* p = static_cast<unsigned char*>(arena.allocate(64));
+    std::fill_n(p, 64, 0xAB);
+    arena.deallocate(p, 64);
+
+    // The memory is still mapped (inside the region), so it can be inspected
+    EXPECT_TRUE(std::all_of(p, p + 64, [](unsigned char c) { return c == 0; }));
+
+    // The now-empty slab can serve a different size class
+    void* q = arena.allocate(512);
+    EXPECT_TRUE(arena.owns(q));
+    arena.deallocate(q, 512);
+}
+
+// ===================================================================
+// Test 6: Distinct live blocks never overlap
+// ===================================================================
+TEST(SecureArenaTest, LiveBlocksDoNotOverlap) {
+    SecureArena arena(2);
+
+    std::vector<unsigned char*> blocks;
+    for (int i = 0; i < 50; ++i) {
+        auto* p = static_cast<unsigned char*>(arena.allocate(32));
+        std::fill_n(p, 32, static_cast<unsigned char>(i));
+        blocks.push_back(p);
+    }
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(static_cast<unsigned char>(i), blocks[i][0]);
+        EXPECT_EQ(static_cast<unsigned char>(i), blocks[i][31]);
+    }
+    for (auto* p : blocks) {
+        arena.deallocate(p, 32);
+    }
+}
+
+// ===================================================================
+// Test 7: Fallback-only arena still works
+// ===================================================================
+TEST(SecureArenaTest, ZeroSlabArenaUsesFallback) {
+    SecureArena arena(0);
+
+    void* p = arena.allocate(32);
+    ASSERT_NE(nullptr, p);
+    EXPECT_FALSE(arena.owns(p));
+    EXPECT_EQ(0u, arena.stats().region_bytes);
+    arena.deallocate(p, 32);
+}
+
+// ===================================================================
+// Test 8: SecureKey goes through the process-wide arena
+// ===================================================================
+TEST(SecureArenaTest, SecureKeyUsesArena) {
+    auto before = SecureArena::instance().stats();
+    {
+        SecureKey key(32);
+        EXPECT_TRUE(SecureArena::instance().owns(key.data()));
+        EXPECT_EQ(before.live_allocations + 1, SecureArena::instance().stats().live_allocations);
+    }
+    EXPECT_EQ(before.live_allocations, SecureArena::instance().stats().live_allocations);
+
+    // Sodium-backed buffers bypass the arena entirely
+    SecureBuffer<unsigned char, SodiumAllocator> raw(32);
+    EXPECT_FALSE(SecureArena::instance().owns(raw.data()));
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "bastionx/crypto/SecureAllocator.h"
+#include "bastionx/crypto/SecureBufferPool.h"
+#include "bastionx/crypto/CryptoService.h"
+#include <algorithm>
+#include <string>
+
+using namespace bastionx::crypto;
+
+// ===================================================================
+// Test 1: Capacities round up to powers of two
+// ===================================================================
+TEST(SecureBufferPoolTest, CapacityRounding) {
+    EXPECT_EQ(SecureBufferPool::kMinBlockBytes, SecureBufferPool::capacity_for(1));
+    EXPECT_EQ(8192u, SecureBufferPool::capacity_for(4097));
+    EXPECT_EQ(65536u, SecureBufferPool::capacity_for(65536));
+
+    size_t huge = SecureBufferPool::kMaxPooledBlockBytes + 1;
+    EXPECT_EQ(huge, SecureBufferPool::capacity_for(huge));
+}
+
+// ===================================================================
+// Test 2: Released blocks are reused without a fresh allocation
+// ===================================================================
+TEST(SecureBufferPoolTest, ReleasedBlockIsReused) {
+    SecureBufferPool pool;
+
+    void* a = pool.acquire(5000);
+    pool.release(a, 5000);
+    void* b = pool.acquire(6000);  // Same 8 KiB bucket
+
+    EXPECT_EQ(a, b);
+    auto stats = pool.stats();
+    EXPECT_EQ(2u, stats.acquires);
+    EXPECT_EQ(1u, stats.fresh_allocs);
+    EXPECT_EQ(1u, stats.reuse_hits);
+
+    pool.release(b, 6000);
+}
+
+// ===================================================================
+// Test 3: Blocks are wiped before they are handed out again
+// ===================================================================
+TEST(SecureBufferPoolTest, ReleasedBlockIsWiped) {
+    SecureBufferPool pool;
+
+    auto* a = static_cast<unsigned char*>(pool.acquire(5000));
+    std::fill_n(a, 5000, 0x5A);
+    pool.release(a, 5000);
+
+    auto* b = static_cast<unsigned char*>(pool.acquire(5000));
+    ASSERT_EQ(a, b);
+    EXPECT_TRUE(std::all_of(b, b + 5000, [](unsigned char c) { return c == 0; }));
+    pool.release(b, 5000);
+}
+
+// ===================================================================
+// Test 4: Idle budget caps retained memory; trim() empties the pool
+// ===================================================================
+TEST(SecureBufferPoolTest, IdleBudgetAndTrim) {
+    SecureBufferPool pool(8192);
+
+    void* a = pool.acquire(8192);
+    void* b = pool.acquire(8192);
+    pool.release(a, 8192);
+    pool.release(b, 8192);  // Over budget: freed, not retained
+
+    auto stats = pool.stats();
+    EXPECT_EQ(8192u, stats.idle_bytes);
+    EXPECT_EQ(1u, stats.idle_blocks);
+    EXPECT_EQ(0u, stats.live_bytes);
+
+    pool.trim();
+    EXPECT_EQ(0u, pool.stats().idle_bytes);
+    EXPECT_EQ(0u, pool.stats().idle_blocks);
+}
+
+// ===================================================================
+// Test 5: SecureAllocator routes small requests to the arena
+// ===================================================================
+TEST(SecureBufferPoolTest, AllocatorRoutesBySize) {
+    SecureBytes small(64);
+    EXPECT_TRUE(SecureArena::instance().owns(small.data()));
+
+    SecureBytes large(64 * 1024);
+    EXPECT_FALSE(SecureArena::instance().owns(large.data()));
+}
+
+// ===================================================================
+// Test 6: SecureString interoperates with std::string
+// ===================================================================
+TEST(SecureBufferPoolTest, SecureStringConversions) {
+    std::string plain = "a long enough string to defeat small-string optimisation";
+    SecureString s = plain;
+
+    EXPECT_EQ(plain, s);
+    EXPECT_EQ(s, plain);
+    EXPECT_EQ("a long enough string to defeat small-string optimisation", s);
+    EXPECT_EQ(plain, s.str());
+    EXPECT_EQ(std::string_view(plain), s.view());
+    EXPECT_TRUE(SecureArena::instance().owns(s.data()));
+
+    s = std::string("short");
+    EXPECT_EQ("short", s);
+}
+
+// ===================================================================
+// Test 7: decrypt_secure matches decrypt and lands in locked memory
+// ===================================================================
+TEST(SecureBufferPoolTest, DecryptSecureMatchesDecrypt) {
+    SecureKey key(CryptoService::SUBKEY_BYTES);
+    randombytes_buf(key.data(), key.size());
+
+    std::vector<uint8_t> plaintext(10000);
+    randombytes_buf(plaintext.data(), plaintext.size());
+    std::vector<uint8_t> aad = {1, 2, 3, 4};
+
+    auto encrypted = CryptoService::encrypt(plaintext, key, aad);
+    auto secure = CryptoService::decrypt_secure(encrypted, key, aad);
+
+    ASSERT_TRUE(secure.has_value());
+    ASSERT_EQ(plaintext.size(), secure->size());
+    EXPECT_TRUE(std::equal(plaintext.begin(), plaintext.end(), secure->begin()));
+
+    // Tampering is still detected
+    encrypted.ciphertext[0] ^= 0x01;
+    EXPECT_FALSE(CryptoService::decrypt_secure(encrypted, key, aad).has_value());
+
+    // Too-short ciphertext is rejected without touching libsodium
+    CryptoService::EncryptedData truncated{{0x00}, encrypted.nonce};
+    EXPECT_FALSE(CryptoService::decrypt_secure(truncated, key, aad).has_value());
+}
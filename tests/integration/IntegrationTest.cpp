@@ -94,7 +94,7 @@ TEST_F(IntegrationTest, FullLifecycle) {
     EXPECT_EQ("Updated content", updated->body);
 
     // Delete note 1
-    EXPECT_TRUE(repo.delete_note(id1));
+    EXPECT_TRUE(repo.delete_note(id1, vault.notes_subkey()));
     EXPECT_FALSE(repo.read_note(id1, vault.notes_subkey()).has_value());
 
     // List should now have 2
@@ -0,0 +1,406 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/AsyncNotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <sodium.h>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bastionx::storage;
+using namespace bastionx::vault;
+namespace fs = std::filesystem;
+using Kind = AsyncNotesRepository::Kind;
+
+/**
+ * @brief Test fixture for AsyncNotesRepository tests
+ *
+ * Creates a vault and hands its pool's writer to the facade. Callbacks
+ * are collected by a dispatcher and run by the test, the way the GUI
+ * thread's event loop would.
+ */
+class AsyncNotesRepositoryTest : public ::testing::Test {
+protected:
+    std::string temp_dir_;
+    std::string vault_path_;
+    std::unique_ptr<VaultService> vault_;
+
+    std::mutex delivered_mutex_;
+    std::vector<std::function<void()>> delivered_;
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_async_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        vault_path_ = (fs::path(temp_dir_) / "vault.db").string();
+
+        vault_ = std::make_unique<VaultService>(vault_path_);
+        ASSERT_TRUE(vault_->create("test_password"));
+    }
+
+    void TearDown() override {
+        vault_.reset();
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    std::unique_ptr<AsyncNotesRepository> make_async() {
+        return std::make_unique<AsyncNotesRepository>(
+            vault_->connection_pool().writer(), [this](std::function<void()> callback) {
+                std::lock_guard lock(delivered_mutex_);
+                delivered_.push_back(std::move(callback));
+            });
+    }
+
+    // Run delivered callbacks, as the event loop would
+    size_t run_delivered() {
+        std::vector<std::function<void()>> callbacks;
+        {
+            std::lock_guard lock(delivered_mutex_);
+            callbacks.swap(delivered_);
+        }
+        for (auto& callback : callbacks) {
+            callback();
+        }
+        return callbacks.size();
+    }
+
+    Note make_note(const std::string& title) {
+        Note note;
+        note.title = title;
+        note.body = "Body of " + title;
+        return note;
+    }
+};
+
+// ===================================================================
+// Test 1: Requests run in order on the storage thread
+// ===================================================================
+TEST_F(AsyncNotesRepositoryTest, RunsInOrderOffThread) {
+    auto async = make_async();
+    const auto& subkey = vault_->notes_subkey();
+    auto caller = std::this_thread::get_id();
+
+    auto id = async->submit(Kind::kWrite, [&](NotesRepository& repo) {
+        EXPECT_NE(caller, std::this_thread::get_id());
+        return repo.create_note(make_note("First"), subkey);
+    }).get();
+
+    // A save and a read of the same note, queued back to back
+    auto note = make_note("Renamed");
+    note.id = id;
+    async->post(Kind::kWrite, [note, &subkey](NotesRepository& repo) {
+        repo.queue_update(note, subkey);
+    });
+    auto read = async->submit(Kind::kRead, [&](NotesRepository& repo) {
+        return repo.read_note(id, subkey);
+    });
+
+    ASSERT_TRUE(read.get().has_value());
+    async->drain();
+    EXPECT_EQ(0u, async->pending());
+
+    auto again = async->submit(Kind::kRead, [&](NotesRepository& repo) {
+        return repo.read_note(id, subkey);
+    }).get();
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ("Renamed", again->title);
+}
+
+// ===================================================================
+// Test 2: post() delivers results and errors through the dispatcher
+// ===================================================================
+TEST_F(AsyncNotesRepositoryTest, CallbacksGoThroughDispatcher) {
+    auto async = make_async();
+    const auto& subkey = vault_->notes_subkey();
+
+    std::vector<NoteSummary> listed;
+    std::string error;
+    bool saved = false;
+
+    async->post(Kind::kWrite, [&](NotesRepository& repo) {
+        repo.create_note(make_note("A"), subkey);
+    }, [&] { saved = true; });
+    async->post(Kind::kRead, [&](NotesRepository& repo) {
+        return repo.list_notes(subkey);
+    }, [&](std::vector<NoteSummary> summaries) { listed = std::move(summaries); });
+    async->post(Kind::kRead, [](NotesRepository&) -> int {
+        throw std::runtime_error("no such note");
+    }, [](int) { FAIL() << "on_done after a throw"; },
+       [&](const std::string& message) { error = message; });
+
+    async->drain();
+    EXPECT_FALSE(saved);  // Nothing runs until the owner's loop does
+    EXPECT_EQ(3u, run_delivered());
+    EXPECT_TRUE(saved);
+    ASSERT_EQ(1u, listed.size());
+    EXPECT_EQ("A", listed[0].title);
+    EXPECT_EQ("no such note", error);
+
+    // Futures rethrow instead
+    auto failed = async->submit(Kind::kRead, [](NotesRepository&) -> int {
+        throw std::runtime_error("no such note");
+    });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+// ===================================================================
+// Test 3: cancel_reads() drops queued reads, never writes
+// ===================================================================
+TEST_F(AsyncNotesRepositoryTest, CancelDropsOnlyReads) {
+    auto async = make_async();
+    const auto& subkey = vault_->notes_subkey();
+
+    // Hold the storage thread so the rest stays queued
+    std::promise<void> gate;
+    auto gate_future = gate.get_future().share();
+    async->post(Kind::kWrite, [gate_future](NotesRepository&) { gate_future.wait(); });
+
+    bool read_ran = false;
+    auto read = async->submit(Kind::kRead, [&](NotesRepository& repo) {
+        read_ran = true;
+        return repo.list_notes(subkey).size();
+    });
+    auto write = async->submit(Kind::kWrite, [&](NotesRepository& repo) {
+        return repo.create_note(make_note("Kept"), subkey);
+    });
+    async->post(Kind::kRead, [&](NotesRepository&) { read_ran = true; },
+                [] { FAIL() << "cancelled callback delivered"; });
+
+    EXPECT_EQ(2u, async->cancel_reads());
+    gate.set_value();
+
+    EXPECT_THROW(read.get(), std::runtime_error);
+    EXPECT_GT(write.get(), 0);
+    async->drain();
+    run_delivered();
+    EXPECT_FALSE(read_ran);
+}
+
+// ===================================================================
+// Test 4: close() runs queued saves, flushes, and goes quiet
+// ===================================================================
+TEST_F(AsyncNotesRepositoryTest, CloseIsLockBarrier) {
+    auto async = make_async();
+    const auto& subkey = vault_->notes_subkey();
+    auto& writer = vault_->connection_pool().writer();
+
+    auto id = async->submit(Kind::kWrite, [&](NotesRepository& repo) {
+        return repo.create_note(make_note("Draft"), subkey);
+    }).get();
+
+    std::promise<void> gate;
+    auto gate_future = gate.get_future().share();
+    async->post(Kind::kWrite, [gate_future](NotesRepository&) { gate_future.wait(); });
+
+    auto note = make_note("Final");
+    note.id = id;
+    bool list_delivered = false;
+    async->post(Kind::kWrite, [note, &subkey](NotesRepository& repo) {
+        repo.queue_update(note, subkey);
+    });
+    async->post(Kind::kRead, [&](NotesRepository& repo) {
+        return repo.list_notes(subkey);
+    }, [&](std::vector<NoteSummary>) { list_delivered = true; });
+
+    std::thread opener([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        gate.set_value();
+    });
+    async->close();  // Lock: cancels the list, keeps the save
+    opener.join();
+
+    EXPECT_FALSE(async->is_open());
+    EXPECT_EQ(0u, writer.pending_writes());
+    EXPECT_THROW(async->post(Kind::kRead, [](NotesRepository&) {}), std::runtime_error);
+
+    // Callbacks still sitting in the event loop are not run after close()
+    run_delivered();
+    EXPECT_FALSE(list_delivered);
+
+    // The repository is the owner's again
+    auto read = writer.read_note(id, subkey);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ("Final", read->title);
+}
+
+// ===================================================================
+// Test 5: Coroutines await requests and unwind when cancelled
+// ===================================================================
+TEST_F(AsyncNotesRepositoryTest, CoroutineAwaitsRequests) {
+    auto async = make_async();
+    const auto& subkey = vault_->notes_subkey();
+    auto token = vault_->session_token();
+
+    size_t listed = 0;
+    int64_t created = 0;
+    auto flow = [&]() -> bastionx::util::Task {
+        created = co_await async->run(Kind::kWrite, [&](NotesRepository& repo) {
+            return repo.create_note(make_note("Awaited"), subkey);
+        }, token);
+        auto summaries = co_await async->run(Kind::kRead, [&](NotesRepository& repo) {
+            return repo.list_notes(subkey);
+        }, token);
+        listed = summaries.size();
+    };
+    flow();
+
+    async->drain();
+    EXPECT_EQ(0, created);  // Resumed by the owner's loop, not the storage thread
+    run_delivered();
+    EXPECT_GT(created, 0);
+    async->drain();
+    run_delivered();
+    EXPECT_EQ(1u, listed);
+
+    // A cancelled read resumes the coroutine with Cancelled
+    std::promise<void> gate;
+    auto gate_future = gate.get_future().share();
+    async->post(Kind::kWrite, [gate_future](NotesRepository&) { gate_future.wait(); });
+
+    bool cancelled = false;
+    auto cancelled_flow = [&]() -> bastionx::util::Task {
+        try {
+            co_await async->run(Kind::kRead, [&](NotesRepository& repo) {
+                return repo.list_notes(subkey).size();
+            });
+        } catch (const bastionx::util::Cancelled&) {
+            cancelled = true;
+        }
+    };
+    cancelled_flow();
+
+    EXPECT_EQ(1u, async->cancel_reads());
+    gate.set_value();
+    async->drain();
+    run_delivered();
+    EXPECT_TRUE(cancelled);
+}
+
+// ===================================================================
+// Test 6: Prefetches wait for foreground requests and are dropped first
+// ===================================================================
+TEST_F(AsyncNotesRepositoryTest, PrefetchesYieldAndAreBounded) {
+    auto async = make_async();
+    const auto& subkey = vault_->notes_subkey();
+
+    std::promise<void> gate;
+    auto gate_future = gate.get_future().share();
+    async->post(Kind::kWrite, [gate_future](NotesRepository&) { gate_future.wait(); });
+
+    std::vector<std::string> order;
+    async->post(Kind::kPrefetch, [&](NotesRepository&) { order.push_back("prefetch"); });
+    async->post(Kind::kRead, [&](NotesRepository&) { order.push_back("read"); });
+    async->post(Kind::kWrite, [&](NotesRepository& repo) {
+        order.push_back("write");
+        repo.create_note(make_note("Saved"), subkey);
+    });
+    gate.set_value();
+    async->drain();
+    EXPECT_EQ((std::vector<std::string>{"read", "write", "prefetch"}), order);
+
+    // Past the cap the oldest waiting prefetch is dropped
+    std::promise<void> hold;
+    auto hold_future = hold.get_future().share();
+    async->post(Kind::kWrite, [hold_future](NotesRepository&) { hold_future.wait(); });
+    std::vector<std::future<void>> prefetches;
+    for (size_t i = 0; i < AsyncNotesRepository::kMaxQueuedPrefetches + 2; ++i) {
+        prefetches.push_back(async->submit(Kind::kPrefetch, [](NotesRepository&) {}));
+    }
+    EXPECT_THROW(prefetches[0].get(), std::runtime_error);
+    EXPECT_THROW(prefetches[1].get(), std::runtime_error);
+    EXPECT_EQ(AsyncNotesRepository::kMaxQueuedPrefetches, async->cancel_prefetches());
+    hold.set_value();
+    EXPECT_THROW(prefetches.back().get(), std::runtime_error);
+
+    // cancel_reads() drops them too
+    async->post(Kind::kWrite, [](NotesRepository&) {});
+    std::promise<void> hold_again;
+    auto hold_again_future = hold_again.get_future().share();
+    async->post(Kind::kWrite, [hold_again_future](NotesRepository&) { hold_again_future.wait(); });
+    auto dropped = async->submit(Kind::kPrefetch, [](NotesRepository&) {});
+    EXPECT_EQ(1u, async->cancel_reads());
+    hold_again.set_value();
+    EXPECT_THROW(dropped.get(), std::runtime_error);
+    async->drain();
+    EXPECT_EQ(0u, async->pending());
+}
+
+// ===================================================================
+// Test 7: Snapshot searches run on pool readers while the writer writes
+// ===================================================================
+TEST_F(AsyncNotesRepositoryTest, SnapshotFinishesDuringWrite) {
+    auto& pool = vault_->connection_pool();
+    NotesRepository* writer = &pool.writer();
+    AsyncNotesRepository async(pool);
+    const auto& subkey = vault_->notes_subkey();
+
+    auto id = async.submit(Kind::kWrite, [&](NotesRepository& repo) {
+        return repo.create_note(make_note("First"), subkey);
+    }).get();
+
+    // Still in the write-behind queue when the search is queued
+    auto note = make_note("Renamed");
+    note.id = id;
+    async.post(Kind::kWrite, [note, &subkey](NotesRepository& repo) {
+        repo.queue_update(note, subkey);
+    });
+
+    std::promise<void> writing;
+    auto writing_future = writing.get_future().share();
+    std::promise<void> release;
+    auto release_future = release.get_future().share();
+
+    auto search = async.submit(Kind::kSnapshot, [&, writing_future](NotesRepository& repo) {
+        // Only search once the write below holds its transaction
+        EXPECT_EQ(std::future_status::ready,
+                  writing_future.wait_for(std::chrono::seconds(10)));
+        EXPECT_NE(writer, &repo);
+        return repo.search_notes(subkey, "Renamed");
+    });
+    auto write = async.submit(Kind::kWrite, [&, release_future](NotesRepository& repo) {
+        repo.engine().begin();
+        repo.engine().erase(Table::kNotes, RowKey{id});
+        writing.set_value();
+        release_future.wait();
+        repo.engine().rollback();
+    });
+
+    // The search finishes while the writer transaction is still open, and
+    // sees the save queued before it but not the uncommitted delete
+    ASSERT_EQ(std::future_status::ready, search.wait_for(std::chrono::seconds(10)));
+    EXPECT_EQ(std::future_status::timeout, write.wait_for(std::chrono::milliseconds(0)));
+    auto hits = search.get();
+    ASSERT_EQ(1u, hits.size());
+    EXPECT_EQ(id, hits[0].id);
+
+    release.set_value();
+    write.get();
+    async.drain();
+    EXPECT_EQ(0u, async.pending());
+
+    // Cancelled like any other read
+    std::promise<void> hold;
+    auto hold_future = hold.get_future().share();
+    async.post(Kind::kWrite, [hold_future](NotesRepository&) { hold_future.wait(); });
+    auto dropped = async.submit(Kind::kSnapshot, [&](NotesRepository& repo) {
+        return repo.list_notes(subkey).size();
+    });
+    EXPECT_EQ(1u, async.cancel_reads());
+    hold.set_value();
+    EXPECT_THROW(dropped.get(), std::runtime_error);
+    async.close();
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/AttachmentStore.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <sodium.h>
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+using namespace bastionx::storage;
+using namespace bastionx::vault;
+using namespace bastionx::crypto;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Test fixture for AttachmentStore tests
+ *
+ * Creates a vault with one note, then attaches files to it.
+ */
+class AttachmentStoreTest : public ::testing::Test {
+protected:
+    std::string vault_path_;
+    std::string temp_dir_;
+    std::unique_ptr<VaultService> vault_;
+    std::unique_ptr<NotesRepository> repo_;
+    std::unique_ptr<AttachmentStore> store_;
+    int64_t note_id_ = 0;
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_attach_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        vault_path_ = (fs::path(temp_dir_) / "vault.db").string();
+
+        vault_ = std::make_unique<VaultService>(vault_path_);
+        vault_->create("test_password");
+        repo_ = std::make_unique<NotesRepository>(vault_path_, &vault_->db_subkey());
+        store_ = std::make_unique<AttachmentStore>(vault_path_, &vault_->db_subkey());
+
+        Note n;
+        n.title = "With attachments";
+        n.body = "See attached";
+        note_id_ = repo_->create_note(n, subkey());
+    }
+
+    void TearDown() override {
+        store_.reset();
+        repo_.reset();
+        vault_.reset();
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    const SecureKey& subkey() const {
+        return vault_->notes_subkey();
+    }
+
+    // Deterministic, non-repeating test contents
+    static std::string file_contents(size_t size, uint8_t seed) {
+        std::string data(size, '\0');
+        uint32_t x = 0x9E3779B9u * (seed + 1u);
+        for (auto& c : data) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            c = static_cast<char>(x);
+        }
+        return data;
+    }
+
+    std::optional<int64_t> attach(int64_t note_id, const std::string& name,
+                                  const std::string& contents) {
+        std::istringstream in(contents);
+        return store_->attach(note_id, name, "application/octet-stream", in, subkey());
+    }
+
+    // Read back, recording the largest piece the sink was handed
+    std::optional<std::string> read_all(int64_t attachment_id, size_t* max_piece = nullptr) {
+        std::string out;
+        size_t largest = 0;
+        bool ok = store_->read(attachment_id, subkey(), [&](std::span<const uint8_t> piece) {
+            out.append(reinterpret_cast<const char*>(piece.data()), piece.size());
+            largest = std::max(largest, piece.size());
+        });
+        if (max_piece) {
+            *max_piece = largest;
+        }
+        if (!ok) {
+            return std::nullopt;
+        }
+        return out;
+    }
+
+    int64_t count_rows(const std::string& table) {
+        sqlite3* db = nullptr;
+        sqlite3_open(vault_path_.c_str(), &db);
+        sqlite3_key(db, vault_->db_subkey().data(), static_cast<int>(vault_->db_subkey().size()));
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db, ("SELECT COUNT(*) FROM " + table).c_str(), -1, &stmt, nullptr);
+        int64_t count = -1;
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            count = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        return count;
+    }
+};
+
+// ===================================================================
+// Test 1: Multi-chunk file streams in and back out unchanged
+// ===================================================================
+TEST_F(AttachmentStoreTest, StreamingRoundTrip) {
+    // Not a multiple of the chunk size, so the last chunk is partial
+    auto contents = file_contents(3 * AttachmentStore::kChunkBytes + 1234, 1);
+    auto id = attach(note_id_, "photo.jpg", contents);
+    ASSERT_TRUE(id.has_value());
+    EXPECT_EQ(4, count_rows("attachment_chunks"));
+
+    size_t max_piece = 0;
+    auto read = read_all(*id, &max_piece);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_TRUE(*read == contents);
+    EXPECT_LE(max_piece, AttachmentStore::kChunkBytes);
+
+    auto listed = store_->list(note_id_, subkey());
+    ASSERT_EQ(1u, listed.size());
+    EXPECT_EQ(*id, listed[0].attachment_id);
+    EXPECT_EQ("photo.jpg", listed[0].name);
+    EXPECT_EQ("application/octet-stream", listed[0].mime_type);
+    EXPECT_EQ(contents.size(), listed[0].size);
+}
+
+// ===================================================================
+// Test 2: Empty and exact-multiple files round-trip
+// ===================================================================
+TEST_F(AttachmentStoreTest, EmptyAndExactChunkFiles) {
+    auto empty = attach(note_id_, "empty.txt", "");
+    ASSERT_TRUE(empty.has_value());
+    auto read = read_all(*empty);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_TRUE(read->empty());
+
+    auto exact = file_contents(2 * AttachmentStore::kChunkBytes, 2);
+    auto id = attach(note_id_, "exact.bin", exact);
+    ASSERT_TRUE(id.has_value());
+    read = read_all(*id);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_TRUE(*read == exact);
+}
+
+// ===================================================================
+// Test 3: Same contents are stored once and deleted with the last link
+// ===================================================================
+TEST_F(AttachmentStoreTest, DuplicatesStoredOnce) {
+    Note n;
+    n.title = "Second note";
+    int64_t other_note = repo_->create_note(n, subkey());
+
+    auto contents = file_contents(AttachmentStore::kChunkBytes + 10, 3);
+    auto a = attach(note_id_, "report.pdf", contents);
+    auto b = attach(other_note, "copy of report.pdf", contents);
+    ASSERT_TRUE(a.has_value());
+    ASSERT_TRUE(b.has_value());
+    EXPECT_EQ(*a, *b);
+    EXPECT_EQ(1u, store_->attachment_count());
+    EXPECT_EQ(2, count_rows("attachment_chunks"));
+
+    // Names are per note
+    EXPECT_EQ("copy of report.pdf", store_->list(other_note, subkey())[0].name);
+
+    EXPECT_TRUE(store_->detach(note_id_, *a));
+    EXPECT_FALSE(store_->detach(note_id_, *a));
+    EXPECT_EQ(1u, store_->attachment_count());
+    EXPECT_TRUE(read_all(*b).has_value());
+
+    EXPECT_TRUE(store_->detach(other_note, *b));
+    EXPECT_EQ(0u, store_->attachment_count());
+    EXPECT_EQ(0, count_rows("attachment_chunks"));
+}
+
+// ===================================================================
+// Test 4: Tampered or reordered chunks fail the read
+// ===================================================================
+TEST_F(AttachmentStoreTest, TamperedChunksRejected) {
+    auto contents = file_contents(3 * AttachmentStore::kChunkBytes, 4);
+    auto id = attach(note_id_, "data.bin", contents);
+    ASSERT_TRUE(id.has_value());
+
+    auto run = [&](const std::string& sql) {
+        sqlite3* db = nullptr;
+        sqlite3_open(vault_path_.c_str(), &db);
+        sqlite3_key(db, vault_->db_subkey().data(), static_cast<int>(vault_->db_subkey().size()));
+        ASSERT_EQ(SQLITE_OK, sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr));
+        sqlite3_close(db);
+    };
+
+    const std::string swap =
+        "UPDATE attachment_chunks SET seq = -1 WHERE seq = 0;"
+        "UPDATE attachment_chunks SET seq = 0 WHERE seq = 1;"
+        "UPDATE attachment_chunks SET seq = 1 WHERE seq = -1;";
+
+    // Swap chunks 0 and 1
+    run(swap);
+    EXPECT_FALSE(read_all(*id).has_value());
+    run(swap);
+    ASSERT_TRUE(read_all(*id).has_value());
+
+    // Flip a byte of the middle chunk
+    run("UPDATE attachment_chunks SET data = substr(data, 1, 100) || "
+        "CASE WHEN substr(data, 101, 1) = X'00' THEN X'01' ELSE X'00' END || "
+        "substr(data, 102) WHERE seq = 1;");
+    EXPECT_FALSE(read_all(*id).has_value());
+
+    // Truncate: drop the final chunk
+    run("DELETE FROM attachment_chunks WHERE seq = 2;");
+    EXPECT_FALSE(read_all(*id).has_value());
+}
+
+// ===================================================================
+// Test 5: Deleting a note deletes its attachments
+// ===================================================================
+TEST_F(AttachmentStoreTest, DeleteNoteRemovesAttachments) {
+    EXPECT_FALSE(attach(note_id_ + 100, "orphan.bin", "x").has_value());
+
+    auto id = attach(note_id_, "a.bin", file_contents(1000, 5));
+    ASSERT_TRUE(id.has_value());
+    ASSERT_TRUE(repo_->delete_note(note_id_, subkey()));
+
+    EXPECT_EQ(0u, store_->attachment_count());
+    EXPECT_EQ(0, count_rows("attachment_chunks"));
+    EXPECT_EQ(0, count_rows("attachment_refs"));
+    EXPECT_FALSE(read_all(*id).has_value());
+}
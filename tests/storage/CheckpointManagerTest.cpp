@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/CheckpointManager.h"
+#include "bastionx/storage/ConnectionPool.h"
+#include "bastionx/vault/VaultService.h"
+#include <sodium.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using namespace bastionx::storage;
+using namespace bastionx::vault;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Test fixture for CheckpointManager tests
+ *
+ * Creates a vault; notes are written through its pool's writer.
+ */
+class CheckpointManagerTest : public ::testing::Test {
+protected:
+    std::string temp_dir_;
+    std::string vault_path_;
+    std::unique_ptr<VaultService> vault_;
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_checkpoint_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        vault_path_ = (fs::path(temp_dir_) / "vault.db").string();
+
+        vault_ = std::make_unique<VaultService>(vault_path_);
+        ASSERT_TRUE(vault_->create("test_password"));
+    }
+
+    void TearDown() override {
+        vault_.reset();
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    void add_notes(NotesRepository& repo, int count) {
+        for (int i = 0; i < count; ++i) {
+            Note note;
+            note.title = "Note " + std::to_string(i);
+            note.body = std::string(2000, static_cast<char>('a' + i % 26));
+            repo.create_note(note, vault_->notes_subkey());
+        }
+    }
+
+    uint64_t wal_size() {
+        std::error_code ec;
+        auto size = fs::file_size(vault_path_ + "-wal", ec);
+        return ec ? 0 : size;
+    }
+};
+
+// ===================================================================
+// Test 1: An idle checkpoint on a small WAL is passive and is recorded
+// ===================================================================
+TEST_F(CheckpointManagerTest, IdleCheckpointIsPassive) {
+    auto& pool = vault_->connection_pool();
+    auto& checkpoints = pool.checkpoints();
+    add_notes(pool.writer(), 20);
+
+    EXPECT_GT(checkpoints.wal_bytes(), 0u);
+    EXPECT_EQ(checkpoints.wal_bytes(), wal_size());
+    EXPECT_EQ(CheckpointManager::Mode::kPassive, checkpoints.idle_mode());
+
+    auto result = checkpoints.run_idle();
+    EXPECT_EQ(CheckpointManager::Mode::kPassive, result.mode);
+    EXPECT_FALSE(result.busy);
+    EXPECT_GT(result.wal_frames, 0);
+    EXPECT_EQ(result.wal_frames, result.checkpointed_frames);
+    // PASSIVE leaves the file at its size for the next writes to reuse
+    EXPECT_GT(result.wal_bytes_before, 0u);
+    EXPECT_EQ(result.wal_bytes_before, result.wal_bytes_after);
+
+    const auto& stats = checkpoints.stats();
+    EXPECT_EQ(1u, stats.checkpoints);
+    EXPECT_EQ(0u, stats.busy);
+    EXPECT_EQ(result.duration, stats.total);
+    EXPECT_EQ(result.duration, stats.longest);
+    ASSERT_TRUE(stats.last.has_value());
+    EXPECT_EQ(result.wal_frames, stats.last->wal_frames);
+}
+
+// ===================================================================
+// Test 2: A growing WAL escalates idle checkpoints to RESTART, TRUNCATE
+// ===================================================================
+TEST_F(CheckpointManagerTest, LargeWalEscalates) {
+    SqliteEngine engine(vault_path_, &vault_->db_subkey(), vault_->connection_profile());
+    CheckpointManager::Options options;
+    options.restart_bytes = 1;
+    options.truncate_bytes = 256 * 1024;
+    options.auto_checkpoint_pages = 0;
+    CheckpointManager checkpoints(engine, options);
+    NotesRepository repo(std::make_unique<SqliteEngine>(
+        vault_path_, &vault_->db_subkey(), vault_->connection_profile()));
+
+    add_notes(repo, 5);
+    ASSERT_LT(wal_size(), options.truncate_bytes);
+    EXPECT_EQ(CheckpointManager::Mode::kRestart, checkpoints.idle_mode());
+    EXPECT_EQ(CheckpointManager::Mode::kRestart, checkpoints.run_idle().mode);
+
+    add_notes(repo, 200);
+    ASSERT_GE(wal_size(), options.truncate_bytes);
+    auto result = checkpoints.run_idle();
+    EXPECT_EQ(CheckpointManager::Mode::kTruncate, result.mode);
+    EXPECT_FALSE(result.busy);
+    EXPECT_GE(result.wal_bytes_before, options.truncate_bytes);
+    EXPECT_EQ(0u, result.wal_bytes_after);
+    EXPECT_EQ(2u, checkpoints.stats().checkpoints);
+
+    options.restart_bytes = options.truncate_bytes + 1;
+    EXPECT_THROW(CheckpointManager(engine, options), std::invalid_argument);
+}
+
+// ===================================================================
+// Test 3: Locking the vault truncates the WAL
+// ===================================================================
+TEST_F(CheckpointManagerTest, LockTruncatesWal) {
+    add_notes(vault_->connection_pool().writer(), 50);
+    ASSERT_GT(wal_size(), 0u);
+
+    // Another connection keeps the -wal file from being removed on close
+    SqliteEngine other(vault_path_, &vault_->db_subkey(), vault_->connection_profile());
+    vault_->lock();
+    EXPECT_EQ(0u, wal_size());
+
+    // Nothing was lost
+    ASSERT_TRUE(vault_->unlock("test_password"));
+    EXPECT_EQ(50u, vault_->connection_pool().writer()
+                       .list_notes(vault_->notes_subkey()).size());
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/ConnectionPool.h"
+#include "bastionx/vault/VaultService.h"
+#include <sodium.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace bastionx::storage;
+using namespace bastionx::vault;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Test fixture for ConnectionPool tests
+ *
+ * Creates a vault with a few notes; each test uses the vault's own pool.
+ */
+class ConnectionPoolTest : public ::testing::Test {
+protected:
+    std::string temp_dir_;
+    std::string vault_path_;
+    std::unique_ptr<VaultService> vault_;
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_pool_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        vault_path_ = (fs::path(temp_dir_) / "vault.db").string();
+
+        vault_ = std::make_unique<VaultService>(vault_path_);
+        ASSERT_TRUE(vault_->create("test_password"));
+        for (int i = 0; i < 10; ++i) {
+            add_note(i);
+        }
+    }
+
+    void TearDown() override {
+        vault_.reset();
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    int64_t add_note(int i) {
+        Note note;
+        note.title = "Note " + std::to_string(i);
+        note.body = "Body of note " + std::to_string(i);
+        return vault_->connection_pool().writer().create_note(note, vault_->notes_subkey());
+    }
+
+    size_t count(NotesRepository& repo) {
+        return repo.list_notes(vault_->notes_subkey()).size();
+    }
+};
+
+// ===================================================================
+// Test 1: A lease reads one snapshot while the writer saves
+// ===================================================================
+TEST_F(ConnectionPoolTest, LeaseSeesSnapshot) {
+    auto& pool = vault_->connection_pool();
+    EXPECT_EQ(ConnectionPool::DEFAULT_READERS, pool.reader_count());
+    EXPECT_EQ(0u, pool.open_reader_count());  // Readers open on first lease
+    {
+        auto lease = pool.read();
+        EXPECT_EQ(1u, pool.open_reader_count());
+        EXPECT_EQ(10u, count(lease.repo()));
+
+        add_note(10);
+        EXPECT_EQ(11u, count(pool.writer()));
+        EXPECT_EQ(10u, count(lease.repo()));
+
+        // Readers cannot write
+        Note note;
+        note.title = "Through a reader";
+        EXPECT_THROW(lease->create_note(note, vault_->notes_subkey()), std::runtime_error);
+    }
+
+    auto fresh = pool.read();
+    EXPECT_EQ(11u, count(fresh.repo()));
+    EXPECT_EQ(1u, pool.open_reader_count());  // The returned reader is reused
+}
+
+// ===================================================================
+// Test 2: Background searches run alongside autosave writes
+// ===================================================================
+TEST_F(ConnectionPoolTest, ReadsRunAlongsideWrites) {
+    auto& pool = vault_->connection_pool();
+    std::atomic<bool> done{false};
+    std::atomic<int> searches{0};
+    std::atomic<bool> failed{false};
+
+    std::thread searcher([&] {
+        try {
+            while (!done) {
+                auto lease = pool.read();
+                auto before = lease->list_notes(vault_->notes_subkey()).size();
+                auto hits = lease->search_notes(vault_->notes_subkey(), "Body of note");
+                // One snapshot per lease: list and search agree
+                if (hits.size() != before) {
+                    failed = true;
+                }
+                ++searches;
+            }
+        } catch (...) {
+            failed = true;
+        }
+    });
+
+    for (int i = 10; i < 60; ++i) {
+        add_note(i);
+    }
+    while (searches < 5) {
+        std::this_thread::yield();
+    }
+    done = true;
+    searcher.join();
+
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(60u, count(pool.writer()));
+}
+
+// ===================================================================
+// Test 3: All readers busy: try_read() declines, read() waits
+// ===================================================================
+TEST_F(ConnectionPoolTest, ReadWaitsForFreeReader) {
+    ConnectionPool pool(vault_path_, vault_->db_subkey(), vault_->connection_profile(), 1);
+    auto held = std::make_unique<ConnectionPool::ReadLease>(pool.read());
+    EXPECT_FALSE(pool.try_read().has_value());
+
+    std::atomic<bool> got{false};
+    std::thread waiter([&] {
+        auto lease = pool.read();
+        got = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(got);
+    held.reset();
+    waiter.join();
+    EXPECT_TRUE(got);
+    EXPECT_TRUE(pool.try_read().has_value());
+
+    EXPECT_THROW(ConnectionPool(vault_path_, vault_->db_subkey(),
+                                vault_->connection_profile(), 0),
+                 std::invalid_argument);
+}
+
+// ===================================================================
+// Test 4: Locking the vault closes the pool, waking waiting readers
+// ===================================================================
+TEST_F(ConnectionPoolTest, LockClosesPool) {
+    auto& pool = vault_->connection_pool();
+    auto first = std::make_unique<ConnectionPool::ReadLease>(pool.read());
+    auto second = std::make_unique<ConnectionPool::ReadLease>(pool.read());
+
+    std::atomic<bool> rejected{false};
+    std::thread waiter([&] {
+        try {
+            pool.read();
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+    });
+    std::thread holder([&] {
+        // Return the leases once lock() has started waiting for them
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        first.reset();
+        second.reset();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));  // Waiter is blocked
+    vault_->lock();
+    waiter.join();
+    holder.join();
+    EXPECT_TRUE(rejected);
+    EXPECT_THROW(vault_->connection_pool(), std::runtime_error);
+
+    // Unlocking opens a fresh pool
+    ASSERT_TRUE(vault_->unlock("test_password"));
+    auto lease = vault_->connection_pool().read();
+    EXPECT_EQ(10u, count(lease.repo()));
+}
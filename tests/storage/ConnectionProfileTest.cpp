@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/ConnectionProfile.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <sodium.h>
+#include <filesystem>
+#include <string>
+
+using namespace bastionx::storage;
+using namespace bastionx::vault;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Test fixture for ConnectionProfile tests
+ *
+ * Creates a unique temp directory for each test and cleans up after.
+ */
+class ConnectionProfileTest : public ::testing::Test {
+protected:
+    std::string temp_dir_;
+    std::string db_path_;
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_profile_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        db_path_ = (fs::path(temp_dir_) / "vault.db").string();
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    static int64_t pragma(sqlite3* db, const std::string& name) {
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db, ("PRAGMA " + name + ";").c_str(), -1, &stmt, nullptr);
+        int64_t value = -1;
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            value = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+        return value;
+    }
+};
+
+// ===================================================================
+// Test 1: apply() sets each connection setting
+// ===================================================================
+TEST_F(ConnectionProfileTest, AppliesConnectionSettings) {
+    sqlite3* db = nullptr;
+    ASSERT_EQ(SQLITE_OK, sqlite3_open(db_path_.c_str(), &db));
+
+    ConnectionProfile::paranoid().apply(db, false);
+    EXPECT_EQ(2, pragma(db, "synchronous"));
+    EXPECT_EQ(-2 * 1024, pragma(db, "cache_size"));
+    EXPECT_EQ(2, pragma(db, "temp_store"));
+    EXPECT_EQ(1, pragma(db, "secure_delete"));
+    EXPECT_EQ(5000, pragma(db, "busy_timeout"));
+
+    ConnectionProfile::throughput().apply(db, false);
+    EXPECT_EQ(1, pragma(db, "synchronous"));
+    EXPECT_EQ(-32 * 1024, pragma(db, "cache_size"));
+    EXPECT_EQ(0, pragma(db, "secure_delete"));
+
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(db, "PRAGMA journal_mode;", -1, &stmt, nullptr);
+    ASSERT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+    EXPECT_STREQ("wal", reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+}
+
+// ===================================================================
+// Test 2: Notes saved under one preset read back under the others
+// ===================================================================
+TEST_F(ConnectionProfileTest, PresetsShareVaultData) {
+    VaultService vault(db_path_, ConnectionProfile::throughput());
+    ASSERT_TRUE(vault.create("password"));
+    const auto& format = vault.connection_profile();
+
+    int64_t id = 0;
+    {
+        NotesRepository repo(db_path_, &vault.db_subkey(), format);
+        Note note;
+        note.title = "Profiled";
+        note.body = "Saved with the throughput preset";
+        id = repo.create_note(note, vault.notes_subkey());
+    }
+
+    for (const auto& preset : {ConnectionProfile::paranoid(), ConnectionProfile::balanced()}) {
+        NotesRepository repo(db_path_, &vault.db_subkey(), preset.with_format_of(format));
+        auto note = repo.read_note(id, vault.notes_subkey());
+        ASSERT_TRUE(note.has_value());
+        EXPECT_EQ("Profiled", note->title);
+    }
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/ContentChunker.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bastionx::storage;
+
+static std::vector<uint8_t> random_text(size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data(size);
+    for (auto& b : data) {
+        b = static_cast<uint8_t>('a' + rng() % 26);
+    }
+    return data;
+}
+
+// Chunk start offsets for `data`
+static std::vector<size_t> offsets(const std::vector<uint8_t>& data) {
+    std::vector<size_t> starts;
+    size_t offset = 0;
+    for (size_t len : ContentChunker::split(data)) {
+        starts.push_back(offset);
+        offset += len;
+    }
+    return starts;
+}
+
+// ===================================================================
+// Test 1: Chunks cover the input and respect the size bounds
+// ===================================================================
+TEST(ContentChunkerTest, ChunksCoverInputWithinBounds) {
+    EXPECT_TRUE(ContentChunker::split({}).empty());
+
+    auto small = random_text(100, 1);
+    EXPECT_EQ(std::vector<size_t>{100}, ContentChunker::split(small));
+
+    auto data = random_text(2 * 1024 * 1024, 2);
+    auto lengths = ContentChunker::split(data);
+    EXPECT_EQ(data.size(), std::accumulate(lengths.begin(), lengths.end(), size_t{0}));
+    for (size_t i = 0; i + 1 < lengths.size(); ++i) {
+        EXPECT_GE(lengths[i], ContentChunker::kMinChunkBytes);
+        EXPECT_LE(lengths[i], ContentChunker::kMaxChunkBytes);
+    }
+
+    // Average lands near the target, not at either bound
+    size_t average = data.size() / lengths.size();
+    EXPECT_GT(average, ContentChunker::kAvgChunkBytes / 2);
+    EXPECT_LT(average, ContentChunker::kAvgChunkBytes * 2);
+
+    // Incompressible runs with no boundary are cut at the maximum
+    std::vector<uint8_t> zeros(3 * ContentChunker::kMaxChunkBytes, 0);
+    auto zero_lengths = ContentChunker::split(zeros);
+    ASSERT_FALSE(zero_lengths.empty());
+    EXPECT_LE(zero_lengths[0], ContentChunker::kMaxChunkBytes);
+}
+
+// ===================================================================
+// Test 2: An insertion only moves the boundaries next to it
+// ===================================================================
+TEST(ContentChunkerTest, InsertionMovesOnlyNearbyBoundaries) {
+    auto original = random_text(1024 * 1024, 3);
+    auto edited = original;
+    const size_t edit_at = original.size() / 2;
+    edited.insert(edited.begin() + static_cast<std::ptrdiff_t>(edit_at), 'X');
+
+    auto before = offsets(original);
+    auto after = offsets(edited);
+
+    // Boundaries before the edit are identical; those after it are shifted
+    // by one byte. Only the chunk(s) around the edit differ.
+    size_t unchanged = 0;
+    for (size_t start : before) {
+        size_t shifted = start > edit_at ? start + 1 : start;
+        if (std::find(after.begin(), after.end(), shifted) != after.end()) {
+            unchanged++;
+        }
+    }
+    EXPECT_GE(unchanged + 2, before.size());
+    EXPECT_LE(after.size(), before.size() + 2);
+}
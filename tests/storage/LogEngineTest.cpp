@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/LogEngine.h"
+#include <sodium.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace bastionx::storage;
+using namespace bastionx::crypto;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Test fixture for the log-structured engine's own behaviour (the
+ *        shared StorageEngine contract is in StorageEngineTest)
+ */
+class LogEngineTest : public ::testing::Test {
+protected:
+    std::string temp_dir_;
+    std::string log_dir_;
+    SecureKey key_{32};
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_log_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        log_dir_ = (fs::path(temp_dir_) / "vault.log").string();
+        randombytes_buf(key_.data(), key_.size());
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    static LogEngine::Options small_segments() {
+        LogEngine::Options options;
+        options.segment_bytes = 4096;
+        options.background_compaction = false;
+        return options;
+    }
+
+    static Row chunk(uint8_t fill, size_t size = 64) {
+        Row row(Table::kContentChunks);
+        row.set(col::ContentChunks::kNonce, std::vector<uint8_t>(24, fill));
+        row.set(col::ContentChunks::kCiphertext, std::vector<uint8_t>(size, fill));
+        row.set(col::ContentChunks::kAlg, int64_t{1});
+        return row;
+    }
+
+    static int fill_of(LogEngine& engine, const RowKey& key) {
+        auto row = engine.get(Table::kContentChunks, key);
+        return row.has_value() ? row->blob(col::ContentChunks::kCiphertext)[0] : -1;
+    }
+
+    std::vector<fs::path> segment_files(const std::string& dir) const {
+        std::vector<fs::path> files;
+        for (const auto& file : fs::directory_iterator(dir)) {
+            files.push_back(file.path());
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+};
+
+// ===================================================================
+// Test 1: Reopening rebuilds the index from sealed segments
+// ===================================================================
+TEST_F(LogEngineTest, ReopenRebuildsIndex) {
+    {
+        LogEngine engine(log_dir_, key_, small_segments());
+        for (int64_t i = 1; i <= 200; ++i) {
+            engine.put(Table::kContentChunks, RowKey{i % 7, i}, chunk(static_cast<uint8_t>(i)));
+        }
+        for (int64_t i = 1; i <= 200; i += 2) {
+            ASSERT_TRUE(engine.erase(Table::kContentChunks, RowKey{i % 7, i}));
+        }
+        EXPECT_GT(engine.stats().segments, 1u);
+    }
+
+    LogEngine engine(log_dir_, key_, small_segments());
+    for (int64_t i = 1; i <= 200; ++i) {
+        EXPECT_EQ(i % 2 == 0 ? static_cast<int>(i % 256) : -1,
+                  fill_of(engine, RowKey{i % 7, i}));
+    }
+    size_t rows = 0;
+    engine.scan(Table::kContentChunks, KeyRange::prefix(3), [&](const RowKey& key, const Row&) {
+        EXPECT_EQ(3, key.a);
+        ++rows;
+        return true;
+    });
+    EXPECT_GT(rows, 10u);
+}
+
+// ===================================================================
+// Test 2: A torn or uncommitted tail is dropped after a crash
+// ===================================================================
+TEST_F(LogEngineTest, CrashRecoveryDropsUncommittedTail) {
+    std::string crashed = (fs::path(temp_dir_) / "crashed.log").string();
+    {
+        LogEngine engine(log_dir_, key_, small_segments());
+        engine.put(Table::kContentChunks, RowKey{1, 1}, chunk(1));
+        engine.put(Table::kContentChunks, RowKey{1, 2}, chunk(2));
+
+        engine.begin();
+        engine.put(Table::kContentChunks, RowKey{1, 1}, chunk(9));
+        engine.put(Table::kContentChunks, RowKey{1, 3}, chunk(3));
+        engine.commit();
+
+        // Copy the files as a crash would leave them: unsealed, with the
+        // last transaction's commit record cut short
+        fs::copy(log_dir_, crashed);
+        fs::path active = segment_files(crashed).back();
+        fs::resize_file(active, fs::file_size(active) - 10);
+    }
+
+    {
+        LogEngine engine(crashed, key_, small_segments());
+        EXPECT_EQ(1, fill_of(engine, RowKey{1, 1}));
+        EXPECT_EQ(2, fill_of(engine, RowKey{1, 2}));
+        EXPECT_EQ(-1, fill_of(engine, RowKey{1, 3}));
+
+        // Appends continue after the last commit
+        engine.put(Table::kContentChunks, RowKey{1, 4}, chunk(4));
+    }
+
+    LogEngine engine(crashed, key_, small_segments());
+    EXPECT_EQ(1, fill_of(engine, RowKey{1, 1}));
+    EXPECT_EQ(4, fill_of(engine, RowKey{1, 4}));
+}
+
+// ===================================================================
+// Test 3: Compaction reclaims overwritten and erased records
+// ===================================================================
+TEST_F(LogEngineTest, CompactionReclaimsDeadRecords) {
+    {
+        LogEngine engine(log_dir_, key_, small_segments());
+        for (int round = 0; round < 20; ++round) {
+            for (int64_t i = 1; i <= 20; ++i) {
+                engine.put(Table::kContentChunks, RowKey{1, i},
+                           chunk(static_cast<uint8_t>(round * 20 + i)));
+            }
+        }
+        for (int64_t i = 1; i <= 5; ++i) {
+            ASSERT_TRUE(engine.erase(Table::kContentChunks, RowKey{1, i}));
+        }
+
+        auto before = engine.stats();
+        EXPECT_GT(engine.compact(), 0u);
+        auto after = engine.stats();
+        EXPECT_LT(after.disk_bytes, before.disk_bytes / 2);
+        EXPECT_EQ(before.live_bytes, after.live_bytes);
+        EXPECT_EQ(0u, engine.compact());  // Nothing left worth copying
+    }
+
+    // Erased rows stay erased once their markers are compacted away
+    LogEngine engine(log_dir_, key_, small_segments());
+    for (int64_t i = 1; i <= 20; ++i) {
+        EXPECT_EQ(i <= 5 ? -1 : static_cast<int>((19 * 20 + i) % 256),
+                  fill_of(engine, RowKey{1, i}));
+    }
+}
+
+// ===================================================================
+// Test 4: Background compaction keeps an autosave loop's log bounded
+// ===================================================================
+TEST_F(LogEngineTest, BackgroundCompactionBoundsDiskUse) {
+    LogEngine::Options options;
+    options.segment_bytes = 4096;
+    LogEngine engine(log_dir_, key_, options);
+
+    for (int save = 0; save < 2000; ++save) {
+        engine.put(Table::kContentChunks, RowKey{1, save % 4}, chunk(static_cast<uint8_t>(save)));
+    }
+    uint64_t appended = engine.stats().appended_bytes;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (engine.stats().disk_bytes > appended / 4 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_LE(engine.stats().disk_bytes, appended / 4);
+    for (int64_t i = 0; i < 4; ++i) {
+        EXPECT_EQ((1996 + i) % 256, fill_of(engine, RowKey{1, i}));
+    }
+}
+
+// ===================================================================
+// Test 5: Modified or moved records fail authentication
+// ===================================================================
+TEST_F(LogEngineTest, TamperedRecordRejected) {
+    {
+        LogEngine engine(log_dir_, key_, small_segments());
+        engine.put(Table::kContentChunks, RowKey{1, 1}, chunk(1, 512));
+    }
+    fs::path segment = segment_files(log_dir_).front();
+
+    // Flip a byte in the middle of the only put record
+    {
+        std::fstream file(segment, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(400);
+        char byte = 0;
+        file.read(&byte, 1);
+        byte ^= 0x01;
+        file.seekp(400);
+        file.write(&byte, 1);
+    }
+    {
+        LogEngine engine(log_dir_, key_, small_segments());
+        EXPECT_THROW(engine.get(Table::kContentChunks, RowKey{1, 1}), std::runtime_error);
+    }
+
+    // A sealed segment renamed to another ID fails its footer
+    fs::path moved = segment;
+    moved.replace_filename("0000000000000000.bxlog");
+    fs::rename(segment, moved);
+    EXPECT_THROW(LogEngine(log_dir_, key_, small_segments()), std::runtime_error);
+
+    // And the wrong key reads nothing
+    fs::rename(moved, segment);
+    SecureKey wrong(32);
+    randombytes_buf(wrong.data(), wrong.size());
+    EXPECT_THROW(LogEngine(log_dir_, wrong, small_segments()), std::runtime_error);
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/MemoryEngine.h"
+#include "bastionx/storage/NoteCache.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/vault/VaultService.h"
+#include <sodium.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+using namespace bastionx::storage;
+using namespace bastionx::crypto;
+namespace fs = std::filesystem;
+
+static NoteCache::Entry entry_of(size_t bytes, int64_t updated_at = 0) {
+    NoteCache::Entry entry;
+    entry.record.assign(bytes, 0x5A);
+    entry.updated_at = updated_at;
+    return entry;
+}
+
+/**
+ * @brief Test fixture for the note cache in NotesRepository
+ *
+ * Runs the repository on a MemoryEngine with a random notes subkey.
+ */
+class NoteCacheTest : public ::testing::Test {
+protected:
+    SecureKey subkey_{32};
+    std::unique_ptr<NotesRepository> repo_;
+
+    void SetUp() override {
+        randombytes_buf(subkey_.data(), subkey_.size());
+        repo_ = std::make_unique<NotesRepository>(std::make_unique<MemoryEngine>());
+        repo_->set_note_cache_budget(1024 * 1024);
+    }
+
+    int64_t create(const std::string& title, const std::string& body) {
+        Note note;
+        note.title = SecureString(title);
+        note.body = SecureString(body);
+        note.tags = {"cached"};
+        return repo_->create_note(note, subkey_);
+    }
+};
+
+// ===================================================================
+// Test 1: Least recently used entries go first once over budget
+// ===================================================================
+TEST(NoteCacheUnitTest, EvictsLeastRecentlyUsed) {
+    NoteCache cache(4000);
+    EXPECT_TRUE(cache.put(1, entry_of(1000)));
+    EXPECT_TRUE(cache.put(2, entry_of(1000)));
+    EXPECT_TRUE(cache.put(3, entry_of(1000)));
+    ASSERT_NE(nullptr, cache.find(1));  // 1 is now the most recent
+
+    EXPECT_TRUE(cache.put(4, entry_of(1000)));
+    EXPECT_TRUE(cache.put(5, entry_of(1000)));  // Over budget: 2 goes
+    EXPECT_EQ(nullptr, cache.find(2));
+    EXPECT_NE(nullptr, cache.find(1));
+    EXPECT_NE(nullptr, cache.find(5));
+
+    auto stats = cache.stats();
+    EXPECT_EQ(4u, stats.entries);
+    EXPECT_EQ(4000u, stats.bytes);
+    EXPECT_EQ(1u, stats.evictions);
+    EXPECT_EQ(3u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_DOUBLE_EQ(0.75, stats.hit_rate());
+
+    // Records over a quarter of the budget are not cached
+    EXPECT_FALSE(cache.put(6, entry_of(1001)));
+    EXPECT_EQ(nullptr, cache.find(6));
+
+    // Replacing keeps one entry; a smaller budget evicts down to it
+    EXPECT_TRUE(cache.put(5, entry_of(500, 42)));
+    EXPECT_EQ(42, cache.find(5)->updated_at);
+    cache.set_budget(1500);
+    EXPECT_LE(cache.stats().bytes, 1500u);
+    EXPECT_NE(nullptr, cache.find(5));
+
+    cache.set_budget(0);
+    EXPECT_FALSE(cache.enabled());
+    EXPECT_EQ(0u, cache.stats().entries);
+    EXPECT_FALSE(cache.put(7, entry_of(10)));
+}
+
+// ===================================================================
+// Test 2: Reads go through the cache; writes invalidate
+// ===================================================================
+TEST_F(NoteCacheTest, ReadThroughAndInvalidation) {
+    int64_t id = create("Cached", "First body");
+
+    auto first = repo_->read_note(id, subkey_);
+    ASSERT_TRUE(first.has_value());
+    auto again = repo_->read_note(id, subkey_);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ("Cached", again->title);
+    EXPECT_EQ("First body", again->body);
+    EXPECT_EQ(std::vector<std::string>{"cached"}, again->tags);
+    EXPECT_EQ(first->created_at, again->created_at);
+    EXPECT_EQ(first->updated_at, again->updated_at);
+    EXPECT_EQ(id, again->id);
+
+    auto stats = repo_->note_cache_stats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+
+    // Streamed reads are served from it too
+    std::string streamed;
+    auto meta = repo_->read_note_streamed(id, subkey_, [&](std::string_view piece) {
+        streamed.append(piece);
+    });
+    ASSERT_TRUE(meta.has_value());
+    EXPECT_EQ("First body", streamed);
+    EXPECT_TRUE(meta->body.empty());
+    EXPECT_EQ(2u, repo_->note_cache_stats().hits);
+
+    // A queued save is flushed by the next read, which then misses
+    Note edited = *again;
+    edited.body = SecureString("Second body");
+    repo_->queue_update(edited, subkey_);
+    auto after_save = repo_->read_note(id, subkey_);
+    ASSERT_TRUE(after_save.has_value());
+    EXPECT_EQ("Second body", after_save->body);
+    EXPECT_EQ(1u, repo_->note_cache_stats().invalidations);
+
+    ASSERT_TRUE(repo_->delete_note(id, subkey_));
+    EXPECT_FALSE(repo_->read_note(id, subkey_).has_value());
+    EXPECT_EQ(0u, repo_->note_cache_stats().entries);
+}
+
+// ===================================================================
+// Test 3: Another key never sees cached notes; close() wipes
+// ===================================================================
+TEST_F(NoteCacheTest, BoundToKeyAndWipedOnClose) {
+    int64_t id = create("Secret", "Body");
+    ASSERT_TRUE(repo_->read_note(id, subkey_).has_value());
+    EXPECT_EQ(1u, repo_->note_cache_stats().entries);
+
+    SecureKey wrong(32);
+    randombytes_buf(wrong.data(), wrong.size());
+    EXPECT_FALSE(repo_->read_note(id, wrong).has_value());
+    EXPECT_EQ(0u, repo_->note_cache_stats().entries);
+
+    ASSERT_TRUE(repo_->read_note(id, subkey_).has_value());
+    EXPECT_EQ(1u, repo_->note_cache_stats().entries);
+    repo_->close();
+    EXPECT_EQ(0u, repo_->note_cache_stats().entries);
+    EXPECT_EQ(0u, repo_->note_cache_stats().bytes);
+
+    // Chunked bodies are never cached
+    auto big = std::make_unique<NotesRepository>(std::make_unique<MemoryEngine>());
+    big->set_note_cache_budget(64 * 1024 * 1024);
+    Note note;
+    note.title = SecureString("Large");
+    note.body = SecureString(std::string(NotesRepository::kChunkedBodyThresholdBytes, 'x'));
+    int64_t big_id = big->create_note(note, subkey_);
+    ASSERT_TRUE(big->read_note(big_id, subkey_).has_value());
+    EXPECT_EQ(0u, big->note_cache_stats().entries);
+}
+
+// ===================================================================
+// Test 4: The pool's writer caches per its profile; lock wipes it
+// ===================================================================
+TEST(NoteCacheVaultTest, WriterCacheFollowsProfileAndLock) {
+    unsigned char buf[8];
+    randombytes_buf(buf, sizeof(buf));
+    std::string suffix;
+    for (auto b : buf) {
+        char hex[3];
+        snprintf(hex, sizeof(hex), "%02x", b);
+        suffix += hex;
+    }
+    auto dir = fs::temp_directory_path() / ("bastionx_note_cache_test_" + suffix);
+    fs::create_directories(dir);
+    {
+        bastionx::vault::VaultService vault((dir / "vault.db").string());
+        ASSERT_TRUE(vault.create("test_password"));
+        auto& writer = vault.connection_pool().writer();
+        EXPECT_EQ(static_cast<size_t>(ConnectionProfile::balanced().note_cache_kib) * 1024,
+                  writer.note_cache_stats().budget_bytes);
+        EXPECT_EQ(0u, vault.connection_pool().read()->note_cache_stats().budget_bytes);
+
+        Note note;
+        note.title = SecureString("Pooled");
+        int64_t id = writer.create_note(note, vault.notes_subkey());
+        ASSERT_TRUE(writer.read_note(id, vault.notes_subkey()).has_value());
+        ASSERT_TRUE(writer.read_note(id, vault.notes_subkey()).has_value());
+        EXPECT_EQ(1u, writer.note_cache_stats().hits);
+
+        vault.lock();
+        EXPECT_FALSE(vault.is_unlocked());
+        ASSERT_TRUE(vault.unlock("test_password"));
+        EXPECT_EQ(0u, vault.connection_pool().writer().note_cache_stats().entries);
+    }
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+// ===================================================================
+// Test 5: prefetch_note() warms the cache without counting lookups
+// ===================================================================
+TEST_F(NoteCacheTest, PrefetchWarmsCache) {
+    int64_t id = create("Next", "Likely opened next");
+
+    EXPECT_TRUE(repo_->prefetch_note(id, subkey_));
+    EXPECT_TRUE(repo_->prefetch_note(id, subkey_));  // Already cached
+    auto stats = repo_->note_cache_stats();
+    EXPECT_EQ(1u, stats.entries);
+    EXPECT_EQ(0u, stats.hits + stats.misses);
+
+    auto read = repo_->read_note(id, subkey_);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ("Likely opened next", read->body);
+    EXPECT_EQ(1u, repo_->note_cache_stats().hits);
+
+    EXPECT_FALSE(repo_->prefetch_note(id + 100, subkey_));  // No such note
+
+    Note large;
+    large.title = SecureString("Large");
+    large.body = SecureString(std::string(NotesRepository::kChunkedBodyThresholdBytes, 'x'));
+    int64_t large_id = repo_->create_note(large, subkey_);
+    EXPECT_FALSE(repo_->prefetch_note(large_id, subkey_));
+
+    repo_->set_note_cache_budget(0);
+    EXPECT_FALSE(repo_->prefetch_note(id, subkey_));
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/NoteCompressor.h"
+#include <sodium.h>
+#include <string>
+#include <vector>
+
+using namespace bastionx::storage;
+using namespace bastionx::crypto;
+
+static SecureBytes bytes_of(const std::string& s) {
+    return SecureBytes(s.begin(), s.end());
+}
+
+static std::vector<SecureBytes> make_samples(size_t count) {
+    std::vector<SecureBytes> samples;
+    for (size_t i = 0; i < count; ++i) {
+        std::string n = std::to_string(i);
+        samples.push_back(bytes_of(
+            R"({"body":"Shopping list )" + n + R"(: milk, eggs, bread","tags":["home"],"title":"List )" +
+            n + R"(","version":1})"));
+    }
+    return samples;
+}
+
+// ===================================================================
+// Test 1: Round-trip without a dictionary
+// ===================================================================
+TEST(NoteCompressorTest, RoundTripWithoutDictionary) {
+    NoteCompressor compressor;
+    std::string text(4096, 'a');
+    auto input = bytes_of(text);
+
+    auto frame = compressor.compress(input);
+    ASSERT_TRUE(frame.has_value());
+    EXPECT_LT(frame->size(), input.size());
+
+    auto output = compressor.decompress(*frame);
+    ASSERT_TRUE(output.has_value());
+    EXPECT_EQ(input, *output);
+}
+
+// ===================================================================
+// Test 2: Incompressible input is left alone
+// ===================================================================
+TEST(NoteCompressorTest, IncompressibleReturnsNullopt) {
+    NoteCompressor compressor;
+    SecureBytes input(1024);
+    randombytes_buf(input.data(), input.size());
+    EXPECT_FALSE(compressor.compress(input).has_value());
+}
+
+// ===================================================================
+// Test 3: Dictionary frames need the same dictionary to decompress
+// ===================================================================
+TEST(NoteCompressorTest, DictionaryRequiredToDecompress) {
+    auto dictionary = NoteCompressor::train_dictionary(make_samples(500), 4096);
+    uint32_t id = NoteCompressor::dictionary_id(dictionary);
+    ASSERT_NE(0u, id);
+
+    NoteCompressor with_dict;
+    EXPECT_EQ(id, with_dict.add_dictionary(dictionary));
+    EXPECT_EQ(id, with_dict.active_dictionary_id());
+
+    auto input = bytes_of(R"({"body":"Shopping list 9999: milk, eggs","tags":["home"],"title":"List 9999","version":1})");
+    auto frame = with_dict.compress(input);
+    ASSERT_TRUE(frame.has_value());
+
+    auto output = with_dict.decompress(*frame);
+    ASSERT_TRUE(output.has_value());
+    EXPECT_EQ(input, *output);
+
+    NoteCompressor without_dict;
+    EXPECT_FALSE(without_dict.decompress(*frame).has_value());
+}
+
+// ===================================================================
+// Test 4: Malformed frames and non-dictionaries are rejected
+// ===================================================================
+TEST(NoteCompressorTest, MalformedInputRejected) {
+    NoteCompressor compressor;
+    auto garbage = bytes_of("definitely not a zstd frame");
+    EXPECT_FALSE(compressor.decompress(garbage).has_value());
+    EXPECT_THROW(compressor.add_dictionary(garbage), std::invalid_argument);
+    EXPECT_THROW(NoteCompressor::train_dictionary({bytes_of("x")}), std::runtime_error);
+}
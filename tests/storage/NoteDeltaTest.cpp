@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/NoteDelta.h"
+#include <string>
+#include <vector>
+
+using namespace bastionx::storage;
+using namespace bastionx::crypto;
+
+static std::vector<uint8_t> bytes_of(const std::string& s) {
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+static std::string text_of(const SecureBytes& b) {
+    return std::string(b.begin(), b.end());
+}
+
+static std::string paragraph_text(int paragraphs) {
+    std::string text;
+    for (int i = 0; i < paragraphs; ++i) {
+        text += "Paragraph " + std::to_string(i) + ": notes on topic " +
+                std::to_string(i * 7 % 13) + ", with some follow-up items.\n";
+    }
+    return text;
+}
+
+// ===================================================================
+// Test 1: Local edits round-trip in a delta much smaller than the text
+// ===================================================================
+TEST(NoteDeltaTest, EditsRoundTripCompactly) {
+    std::string base = paragraph_text(500);
+
+    std::string edited = base;
+    edited.insert(100, "Inserted near the start. ");
+    edited.erase(edited.size() / 2, 300);
+    edited.replace(edited.size() - 200, 10, "REPLACED!!");
+    edited += "Appended at the end.\n";
+
+    auto b = bytes_of(base);
+    auto t = bytes_of(edited);
+    auto delta = NoteDelta::encode(b, t);
+    EXPECT_LT(delta.size(), 200u);
+
+    auto rebuilt = NoteDelta::apply(b, delta);
+    ASSERT_TRUE(rebuilt.has_value());
+    EXPECT_EQ(edited, text_of(*rebuilt));
+
+    // Moved text is found anywhere in the base
+    std::string moved = base.substr(base.size() / 2) + base.substr(0, base.size() / 2);
+    auto m = bytes_of(moved);
+    auto move_delta = NoteDelta::encode(b, m);
+    EXPECT_LT(move_delta.size(), 128u);
+    auto rebuilt_moved = NoteDelta::apply(b, move_delta);
+    ASSERT_TRUE(rebuilt_moved.has_value());
+    EXPECT_EQ(moved, text_of(*rebuilt_moved));
+}
+
+// ===================================================================
+// Test 2: Short, empty and unrelated inputs round-trip
+// ===================================================================
+TEST(NoteDeltaTest, EdgeCasesRoundTrip) {
+    std::vector<std::pair<std::string, std::string>> cases = {
+        {"", ""},
+        {"", "new text"},
+        {"old text", ""},
+        {"tiny", "tiny!"},
+        {paragraph_text(20), "completely different content that shares nothing"},
+        {paragraph_text(20), paragraph_text(20)},
+    };
+    for (const auto& [base, target] : cases) {
+        auto b = bytes_of(base);
+        auto t = bytes_of(target);
+        auto rebuilt = NoteDelta::apply(b, NoteDelta::encode(b, t));
+        ASSERT_TRUE(rebuilt.has_value());
+        EXPECT_EQ(target, text_of(*rebuilt));
+    }
+}
+
+// ===================================================================
+// Test 3: Malformed deltas, or a delta applied to the wrong base, fail
+// ===================================================================
+TEST(NoteDeltaTest, MalformedDeltasRejected) {
+    auto base = bytes_of(paragraph_text(50));
+    auto target = bytes_of(paragraph_text(50) + "tail");
+    auto delta = NoteDelta::encode(base, target);
+
+    SecureBytes truncated(delta.begin(), delta.end() - 1);
+    EXPECT_FALSE(NoteDelta::apply(base, truncated).has_value());
+
+    SecureBytes wrong_version = delta;
+    wrong_version[0] = NoteDelta::kVersion + 1;
+    EXPECT_FALSE(NoteDelta::apply(base, wrong_version).has_value());
+
+    // Copies reach past the end of a shorter base
+    auto short_base = bytes_of(paragraph_text(10));
+    EXPECT_FALSE(NoteDelta::apply(short_base, delta).has_value());
+
+    EXPECT_FALSE(NoteDelta::apply(base, SecureBytes()).has_value());
+}
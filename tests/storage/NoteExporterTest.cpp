@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/NoteExporter.h"
+#include "bastionx/vault/VaultService.h"
+#include "storage_backends.h"
+#include <sodium.h>
+#include <sqlcipher/sqlite3.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+using namespace bastionx::storage;
+using namespace bastionx::vault;
+using namespace bastionx::crypto;
+namespace fs = std::filesystem;
+using namespace storage_backends;
+
+/**
+ * @brief Test fixture for NoteExporter tests
+ *
+ * Creates a vault and a repository on the chosen backend; archives go to
+ * an "exports" directory in the same temp directory.
+ */
+class NoteExporterTest : public ::testing::TestWithParam<Backend> {
+protected:
+    BackendFixture backend_{GetParam()};
+    std::string temp_dir_;
+    std::string vault_path_;
+    std::string export_dir_;
+    std::unique_ptr<VaultService> vault_;
+    std::unique_ptr<NotesRepository> repo_;
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_export_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        vault_path_ = (fs::path(temp_dir_) / "vault.db").string();
+        export_dir_ = (fs::path(temp_dir_) / "exports").string();
+
+        vault_ = std::make_unique<VaultService>(vault_path_);
+        ASSERT_TRUE(vault_->create("test_password"));
+        open_repo();
+    }
+
+    void TearDown() override {
+        repo_.reset();
+        vault_.reset();
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    void open_repo() {
+        repo_.reset();
+        repo_ = backend_.open_repository(vault_path_, vault_->db_subkey());
+    }
+
+    int64_t add_note(const std::string& title, const std::string& body = "Body") {
+        Note note;
+        note.title = title;
+        note.body = body;
+        note.tags = {"export"};
+        return repo_->create_note(note, vault_->notes_subkey());
+    }
+
+    NoteExporter::Result run_export() {
+        NoteExporter exporter(*repo_, export_dir_);
+        return exporter.export_changes(vault_->notes_subkey(), vault_->export_key());
+    }
+
+    // Entries of an archive by note ID
+    std::map<int64_t, ExportEntry> read(const std::string& archive) {
+        std::map<int64_t, ExportEntry> entries;
+        NoteExporter::read_archive(archive, vault_->export_key(), [&](const ExportEntry& entry) {
+            entries[entry.note_id] = entry;
+        });
+        return entries;
+    }
+};
+
+// ===================================================================
+// Test 1: Each export holds only the changes since the previous one
+// ===================================================================
+TEST_P(NoteExporterTest, ExportsOnlyChangesSinceWatermark) {
+    std::vector<int64_t> ids;
+    for (int i = 0; i < 5; ++i) {
+        ids.push_back(add_note("Note " + std::to_string(i)));
+    }
+
+    auto first = run_export();
+    EXPECT_EQ(5u, first.notes);
+    EXPECT_EQ(0u, first.deletions);
+    EXPECT_EQ(5u, read(first.archive).size());
+
+    // Two saves of one note, a delete and a new note
+    auto note = repo_->read_note(ids[1], vault_->notes_subkey());
+    ASSERT_TRUE(note.has_value());
+    note->body = "Edited once";
+    ASSERT_TRUE(repo_->update_note(*note, vault_->notes_subkey()));
+    note->body = "Edited twice";
+    ASSERT_TRUE(repo_->update_note(*note, vault_->notes_subkey()));
+    ASSERT_TRUE(repo_->delete_note(ids[3], vault_->notes_subkey()));
+    int64_t added = add_note("Added later");
+
+    auto second = run_export();
+    EXPECT_EQ(2u, second.notes);
+    EXPECT_EQ(1u, second.deletions);
+    EXPECT_GT(second.watermark, first.watermark);
+
+    auto entries = read(second.archive);
+    ASSERT_EQ(3u, entries.size());
+    ASSERT_TRUE(entries[ids[1]].note.has_value());
+    EXPECT_EQ("Edited twice", entries[ids[1]].note->body);
+    EXPECT_TRUE(entries[ids[3]].deleted);
+    EXPECT_FALSE(entries[ids[3]].note.has_value());
+    ASSERT_TRUE(entries[added].note.has_value());
+    EXPECT_EQ("Added later", entries[added].note->title);
+
+    // Nothing changed: no archive, watermark unchanged
+    auto third = run_export();
+    EXPECT_TRUE(third.archive.empty());
+    EXPECT_EQ(second.watermark, third.watermark);
+    EXPECT_EQ(2u, NoteExporter(*repo_, export_dir_).archives().size());
+}
+
+// ===================================================================
+// Test 2: Archives carry every field, including chunked bodies
+// ===================================================================
+TEST_P(NoteExporterTest, ArchiveHoldsFullNotes) {
+    std::string body;
+    while (body.size() < NotesRepository::kChunkedBodyThresholdBytes + 1000) {
+        body += "a line of a large note " + std::to_string(body.size()) + "\n";
+    }
+    Note note;
+    note.title = "Große Notiz";
+    note.body = body;
+    note.tags = {"large", "ünïcode"};
+    int64_t id = repo_->create_note(note, vault_->notes_subkey());
+    auto stored = repo_->read_note(id, vault_->notes_subkey());
+    ASSERT_TRUE(stored.has_value());
+
+    auto entries = read(run_export().archive);
+    ASSERT_EQ(1u, entries.size());
+    const auto& exported = entries[id];
+    ASSERT_TRUE(exported.note.has_value());
+    EXPECT_EQ(id, exported.note->id);
+    EXPECT_EQ(note.title, exported.note->title);
+    EXPECT_EQ(body, exported.note->body);
+    EXPECT_EQ(note.tags, exported.note->tags);
+    EXPECT_EQ(stored->created_at, exported.note->created_at);
+    EXPECT_EQ(stored->updated_at, exported.note->updated_at);
+}
+
+// ===================================================================
+// Test 3: Modified, truncated or wrongly keyed archives are rejected
+// ===================================================================
+TEST_P(NoteExporterTest, TamperedArchiveRejected) {
+    for (int i = 0; i < 3; ++i) {
+        add_note("Note " + std::to_string(i), std::string(500, 'x'));
+    }
+    std::string archive = run_export().archive;
+    auto ignore = [](const ExportEntry&) {};
+
+    SecureKey wrong(32);
+    randombytes_buf(wrong.data(), wrong.size());
+    EXPECT_THROW(NoteExporter::read_archive(archive, wrong, ignore), std::runtime_error);
+
+    std::string copy = archive + ".copy";
+    auto damaged = [&](auto&& damage) {
+        fs::copy_file(archive, copy, fs::copy_options::overwrite_existing);
+        damage();
+        EXPECT_THROW(NoteExporter::read_archive(copy, vault_->export_key(), ignore),
+                     std::runtime_error);
+    };
+
+    // A flipped ciphertext byte
+    damaged([&] {
+        std::fstream file(copy, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(200);
+        char byte = 0;
+        file.read(&byte, 1);
+        byte ^= 0x01;
+        file.seekp(200);
+        file.write(&byte, 1);
+    });
+
+    // The final message cut off
+    damaged([&] { fs::resize_file(copy, fs::file_size(copy) - 20); });
+
+    // A header claiming a different range
+    damaged([&] {
+        std::fstream file(copy, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(8);
+        char range = 7;
+        file.write(&range, 1);
+    });
+}
+
+// ===================================================================
+// Test 4: The watermark persists, and an interrupted export is repeated
+// ===================================================================
+TEST_P(NoteExporterTest, WatermarkSurvivesReopen) {
+    add_note("First");
+    auto first = run_export();
+
+    open_repo();
+    EXPECT_EQ(first.watermark, NoteExporter(*repo_, export_dir_).watermark());
+    int64_t second_id = add_note("Second");
+
+    // A crash between archive and watermark leaves the old watermark: the
+    // next export simply writes the same changes again
+    std::string watermark_file = (fs::path(export_dir_) / "watermark").string();
+    auto second = run_export();
+    {
+        std::ofstream rewind(watermark_file, std::ios::trunc);
+        rewind << first.watermark << '\n';
+    }
+    fs::remove(second.archive);
+    auto retried = run_export();
+    EXPECT_EQ(second.archive, retried.archive);
+    EXPECT_EQ(second.watermark, retried.watermark);
+    auto entries = read(retried.archive);
+    ASSERT_EQ(1u, entries.size());
+    EXPECT_EQ(1u, entries.count(second_id));
+
+    EXPECT_EQ(1u, repo_->changes_since(first.watermark).size());
+    EXPECT_TRUE(repo_->changes_since(retried.watermark).empty());
+    EXPECT_EQ(retried.watermark, repo_->last_change_seq());
+}
+
+// ===================================================================
+// Test 5: Vaults from before the change log export every note once
+// ===================================================================
+TEST_P(NoteExporterTest, MigratedVaultExportsAllNotes) {
+    if (GetParam() != Backend::kSqlite) {
+        GTEST_SKIP() << "Schema migration is specific to the SQLite vault";
+    }
+    for (int i = 0; i < 4; ++i) {
+        add_note("Note " + std::to_string(i));
+    }
+
+    repo_.reset();
+    {
+        sqlite3* db = nullptr;
+        sqlite3_open(vault_path_.c_str(), &db);
+        sqlite3_key(db, vault_->db_subkey().data(), static_cast<int>(vault_->db_subkey().size()));
+        ASSERT_EQ(SQLITE_OK, sqlite3_exec(db, "DROP TABLE note_changes;"
+                                              "ALTER TABLE notes DROP COLUMN change_seq;",
+                                          nullptr, nullptr, nullptr));
+        sqlite3_close(db);
+    }
+
+    // Unlock runs the schema migration, which backfills the change log
+    vault_->lock();
+    ASSERT_TRUE(vault_->unlock("test_password"));
+    open_repo();
+
+    auto result = run_export();
+    EXPECT_EQ(4u, result.notes);
+    EXPECT_EQ(4u, read(result.archive).size());
+    EXPECT_TRUE(run_export().archive.empty());
+}
+
+INSTANTIATE_TEST_SUITE_P(Engines, NoteExporterTest,
+                         ::testing::Values(Backend::kSqlite, Backend::kMemory, Backend::kLog),
+                         backend_name);
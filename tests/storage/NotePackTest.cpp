@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/NotePack.h"
+#include <string>
+#include <vector>
+
+using namespace bastionx::storage;
+using namespace bastionx::crypto;
+
+static std::vector<uint8_t> bytes_of(const std::string& s) {
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+// ===================================================================
+// Test 1: Encode/decode round-trip keeps order, IDs and payloads
+// ===================================================================
+TEST(NotePackTest, RoundTrip) {
+    auto a = bytes_of("first record");
+    auto b = bytes_of("");
+    auto c = bytes_of(std::string(5000, 'c'));
+    auto pack = NotePack::encode({{42, a}, {7, b}, {1000000000000, c}});
+
+    auto entries = NotePack::decode(pack);
+    ASSERT_TRUE(entries.has_value());
+    ASSERT_EQ(3u, entries->size());
+    EXPECT_EQ(42, (*entries)[0].note_id);
+    EXPECT_EQ(7, (*entries)[1].note_id);
+    EXPECT_EQ(1000000000000, (*entries)[2].note_id);
+    EXPECT_TRUE(std::equal(a.begin(), a.end(), (*entries)[0].payload.begin(),
+                           (*entries)[0].payload.end()));
+    EXPECT_TRUE((*entries)[1].payload.empty());
+    EXPECT_TRUE(std::equal(c.begin(), c.end(), (*entries)[2].payload.begin(),
+                           (*entries)[2].payload.end()));
+
+    // An empty pack is valid
+    auto empty = NotePack::decode(NotePack::encode({}));
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_TRUE(empty->empty());
+}
+
+// ===================================================================
+// Test 2: Truncated, padded or mislabeled packs are rejected
+// ===================================================================
+TEST(NotePackTest, MalformedPacksRejected) {
+    auto a = bytes_of("record a");
+    auto b = bytes_of("record b");
+    auto pack = NotePack::encode({{1, a}, {2, b}});
+
+    SecureBytes truncated(pack.begin(), pack.end() - 1);
+    EXPECT_FALSE(NotePack::decode(truncated).has_value());
+
+    SecureBytes padded = pack;
+    padded.push_back(0);
+    EXPECT_FALSE(NotePack::decode(padded).has_value());
+
+    SecureBytes wrong_version = pack;
+    wrong_version[0] = NotePack::kVersion + 1;
+    EXPECT_FALSE(NotePack::decode(wrong_version).has_value());
+
+    // Count claiming more entries than the index holds
+    SecureBytes big_count = pack;
+    big_count[4] = 0xFF;
+    EXPECT_FALSE(NotePack::decode(big_count).has_value());
+
+    EXPECT_FALSE(NotePack::decode(SecureBytes(3, 0)).has_value());
+}
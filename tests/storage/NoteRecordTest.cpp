@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/NoteRecord.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace bastionx::storage;
+using namespace bastionx::crypto;
+
+// ===================================================================
+// Test 1: Encode/decode round-trip
+// ===================================================================
+TEST(NoteRecordTest, RoundTrip) {
+    std::string body = "Line one\nLine two with unicode: \xc3\xa9\xe2\x9c\x93";
+    auto record = NoteRecord::encode("Title", {"work", "", "todo"}, body);
+
+    ASSERT_TRUE(NoteRecord::is_binary(record));
+    auto view = NoteRecord::decode(record);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ("Title", view->title);
+    ASSERT_EQ(3u, view->tags.size());
+    EXPECT_EQ("work", view->tags[0]);
+    EXPECT_EQ("", view->tags[1]);
+    EXPECT_EQ("todo", view->tags[2]);
+    EXPECT_EQ(body, view->body);
+    EXPECT_EQ(body, view->preview);
+    EXPECT_EQ(body.size(), view->body_bytes);
+    EXPECT_EQ(0u, view->body_chunks);
+}
+
+// ===================================================================
+// Test 2: Header-only decode needs nothing past the preview
+// ===================================================================
+TEST(NoteRecordTest, HeaderOnlyDecodeIgnoresBody) {
+    std::string body(10000, 'x');
+    body.replace(0, 5, "Start");
+    auto record = NoteRecord::encode("Long", {"big"}, body);
+
+    // Drop most of the body: a full decode fails, header-only still works
+    SecureBytes truncated(record.begin(), record.end() - 9000);
+    EXPECT_FALSE(NoteRecord::decode(truncated).has_value());
+
+    auto view = NoteRecord::decode(truncated, true);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ("Long", view->title);
+    EXPECT_EQ(NoteRecord::kPreviewBytes, view->preview.size());
+    EXPECT_EQ(0u, view->preview.find("Start"));
+    EXPECT_EQ(body.size(), view->body_bytes);
+    EXPECT_TRUE(view->body.empty());
+}
+
+// ===================================================================
+// Test 3: Chunked bodies keep size, preview and manifest in the record
+// ===================================================================
+TEST(NoteRecordTest, ChunkedBodyNotInline) {
+    std::string body(5000, 'b');
+    std::vector<NoteRecord::ChunkRef> chunks(2);
+    chunks[0].chunk_id = 7;
+    chunks[0].size = 3000;
+    chunks[0].hash.fill(0xAA);
+    chunks[1].chunk_id = 9;
+    chunks[1].size = 2000;
+    chunks[1].hash.fill(0xBB);
+
+    auto record = NoteRecord::encode("Chunked", {}, body, chunks);
+    EXPECT_EQ(NoteRecord::kHeaderBytes + 7 + NoteRecord::kPreviewBytes +
+                  2 * NoteRecord::kChunkRefBytes, record.size());
+
+    auto view = NoteRecord::decode(record);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(2u, view->body_chunks);
+    EXPECT_EQ(body.size(), view->body_bytes);
+    EXPECT_TRUE(view->body.empty());
+    EXPECT_EQ(body.substr(0, NoteRecord::kPreviewBytes), view->preview);
+    ASSERT_EQ(2u, view->chunks.size());
+    EXPECT_EQ(9u, view->chunks[1].chunk_id);
+    EXPECT_EQ(2000u, view->chunks[1].size);
+    EXPECT_EQ(chunks[1].hash, view->chunks[1].hash);
+
+    // Header-only decode skips the manifest
+    auto header = NoteRecord::decode(record, true);
+    ASSERT_TRUE(header.has_value());
+    EXPECT_TRUE(header->chunks.empty());
+
+    // Chunk sizes must cover the body exactly
+    chunks[1].size = 1999;
+    EXPECT_THROW(NoteRecord::encode("Chunked", {}, body, chunks), std::invalid_argument);
+}
+
+// ===================================================================
+// Test 4: Malformed records and JSON payloads are rejected
+// ===================================================================
+TEST(NoteRecordTest, MalformedRejected) {
+    auto record = NoteRecord::encode("Title", {"tag"}, "Body");
+
+    // Version-1 JSON is not this format
+    std::string json = R"({"body":"","tags":[],"title":"","version":1})";
+    SecureBytes json_bytes(json.begin(), json.end());
+    EXPECT_FALSE(NoteRecord::is_binary(json_bytes));
+    EXPECT_FALSE(NoteRecord::decode(json_bytes).has_value());
+
+    // Shorter than the header
+    SecureBytes short_record(record.begin(), record.begin() + NoteRecord::kHeaderBytes - 1);
+    EXPECT_FALSE(NoteRecord::decode(short_record, true).has_value());
+
+    // Trailing garbage after the inline body
+    SecureBytes padded = record;
+    padded.push_back(0);
+    EXPECT_FALSE(NoteRecord::decode(padded).has_value());
+
+    // Title length past the end of the record
+    SecureBytes bad_title = record;
+    bad_title[4] = 0xFF;
+    EXPECT_FALSE(NoteRecord::decode(bad_title, true).has_value());
+
+    // Tag count that does not match the tags section
+    SecureBytes bad_tags = record;
+    bad_tags[2] = 2;
+    EXPECT_FALSE(NoteRecord::decode(bad_tags, true).has_value());
+
+    // Chunked flag without a chunk count, or unknown flags
+    SecureBytes bad_flags = record;
+    bad_flags[1] = NoteRecord::kFlagChunked;
+    EXPECT_FALSE(NoteRecord::decode(bad_flags).has_value());
+    bad_flags[1] = 0x80;
+    EXPECT_FALSE(NoteRecord::decode(bad_flags).has_value());
+}
+
+// ===================================================================
+// Test 5: The preview never ends inside a UTF-8 sequence
+// ===================================================================
+TEST(NoteRecordTest, PreviewEndsOnCodePoint) {
+    // 127 ASCII bytes, then a 3-byte character straddling the 128-byte cut
+    std::string body(127, 'a');
+    body += "\xe2\x9c\x93";
+    body += std::string(100, 'b');
+    auto record = NoteRecord::encode("T", {}, body);
+    auto view = NoteRecord::decode(record, true);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(std::string(127, 'a'), view->preview);
+
+    // A character ending exactly at the cut is kept
+    std::string exact(126, 'a');
+    exact += "\xc3\xa9";
+    exact += "tail";
+    record = NoteRecord::encode("T", {}, exact);
+    view = NoteRecord::decode(record, true);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(exact.substr(0, 128), view->preview);
+
+    // 4-byte characters throughout: the preview is whole characters
+    std::string emoji;
+    for (int i = 0; i < 40; ++i) {
+        emoji += "\xf0\x9f\x94\x92";
+    }
+    record = NoteRecord::encode("T", {}, emoji);
+    view = NoteRecord::decode(record, true);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(emoji.substr(0, 128), view->preview);
+    emoji.insert(0, "x");
+    record = NoteRecord::encode("T", {}, emoji);
+    view = NoteRecord::decode(record, true);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(emoji.substr(0, 125), view->preview);
+}
@@ -1,23 +1,28 @@
 #include <gtest/gtest.h>
 #include "bastionx/storage/NotesRepository.h"
+#include "bastionx/crypto/SecretStream.h"
 #include "bastionx/vault/VaultService.h"
+#include "storage_backends.h"
 #include <sodium.h>
 #include <filesystem>
 #include <thread>
 #include <chrono>
+#include <cstring>
 
 using namespace bastionx::storage;
 using namespace bastionx::vault;
 using namespace bastionx::crypto;
 namespace fs = std::filesystem;
+using namespace storage_backends;
 
 /**
  * @brief Test fixture for NotesRepository tests
  *
  * Creates a vault with VaultService, then tests NotesRepository against it.
  */
-class NotesRepositoryTest : public ::testing::Test {
+class NotesRepositoryTest : public ::testing::TestWithParam<Backend> {
 protected:
+    BackendFixture backend_{GetParam()};
     std::string vault_path_;
     std::string temp_dir_;
     std::unique_ptr<VaultService> vault_;
@@ -43,7 +48,7 @@ protected:
         vault_->create("test_password");
 
         // Open repository with database encryption key
-        repo_ = std::make_unique<NotesRepository>(vault_path_, &vault_->db_subkey());
+        open_repo();
     }
 
     void TearDown() override {
@@ -57,6 +62,27 @@ protected:
         return vault_->notes_subkey();
     }
 
+    // (Re)open the repository on this test's backend
+    void open_repo() {
+        repo_.reset();  // One engine per vault at a time
+        repo_ = backend_.open_repository(vault_path_, vault_->db_subkey());
+    }
+
+    StorageEngine& engine() {
+        return repo_->engine();
+    }
+
+    // Replace a note's stored record as an older build would have written it
+    void rewrite_record(int64_t id, const CryptoService::EncryptedData& record) {
+        auto row = engine().get(Table::kNotes, RowKey{id});
+        ASSERT_TRUE(row.has_value());
+        row->set(col::Notes::kNonce, record.nonce);
+        row->set(col::Notes::kCiphertext, record.ciphertext);
+        row->set(col::Notes::kAlg, int64_t{0});
+        row->set(col::Notes::kCodec, int64_t{0});
+        engine().put(Table::kNotes, RowKey{id}, *row);
+    }
+
     static Note make_note(const std::string& title, const std::string& body,
                           const std::vector<std::string>& tags = {}) {
         Note n;
@@ -70,7 +96,7 @@ protected:
 // ===================================================================
 // Test 1: Create note
 // ===================================================================
-TEST_F(NotesRepositoryTest, CreateNote) {
+TEST_P(NotesRepositoryTest, CreateNote) {
     auto note = make_note("Test Title", "Test Body");
     int64_t id = repo_->create_note(note, subkey());
 
@@ -80,7 +106,7 @@ TEST_F(NotesRepositoryTest, CreateNote) {
 // ===================================================================
 // Test 2: Read note by ID (round-trip)
 // ===================================================================
-TEST_F(NotesRepositoryTest, ReadNoteById) {
+TEST_P(NotesRepositoryTest, ReadNoteById) {
     auto note = make_note("My Title", "My Body", {"tag1", "tag2"});
     int64_t id = repo_->create_note(note, subkey());
 
@@ -99,7 +125,7 @@ TEST_F(NotesRepositoryTest, ReadNoteById) {
 // ===================================================================
 // Test 3: Read nonexistent note
 // ===================================================================
-TEST_F(NotesRepositoryTest, ReadNonexistentNote) {
+TEST_P(NotesRepositoryTest, ReadNonexistentNote) {
     auto read = repo_->read_note(99999, subkey());
     EXPECT_FALSE(read.has_value());
 }
@@ -107,7 +133,7 @@ TEST_F(NotesRepositoryTest, ReadNonexistentNote) {
 // ===================================================================
 // Test 4: List notes
 // ===================================================================
-TEST_F(NotesRepositoryTest, ListNotes) {
+TEST_P(NotesRepositoryTest, ListNotes) {
     repo_->create_note(make_note("Note 1", "Body 1"), subkey());
     repo_->create_note(make_note("Note 2", "Body 2"), subkey());
     repo_->create_note(make_note("Note 3", "Body 3"), subkey());
@@ -128,7 +154,7 @@ TEST_F(NotesRepositoryTest, ListNotes) {
 // ===================================================================
 // Test 5: List notes on empty DB
 // ===================================================================
-TEST_F(NotesRepositoryTest, ListNotesEmpty) {
+TEST_P(NotesRepositoryTest, ListNotesEmpty) {
     auto summaries = repo_->list_notes(subkey());
     EXPECT_TRUE(summaries.empty());
 }
@@ -136,7 +162,7 @@ TEST_F(NotesRepositoryTest, ListNotesEmpty) {
 // ===================================================================
 // Test 6: List notes order (most recent first)
 // ===================================================================
-TEST_F(NotesRepositoryTest, ListNotesOrder) {
+TEST_P(NotesRepositoryTest, ListNotesOrder) {
     int64_t id1 = repo_->create_note(make_note("First", ""), subkey());
     (void)repo_->create_note(make_note("Second", ""), subkey());
     (void)repo_->create_note(make_note("Third", ""), subkey());
@@ -160,7 +186,7 @@ TEST_F(NotesRepositoryTest, ListNotesOrder) {
 // ===================================================================
 // Test 7: Update note
 // ===================================================================
-TEST_F(NotesRepositoryTest, UpdateNote) {
+TEST_P(NotesRepositoryTest, UpdateNote) {
     auto note = make_note("Original", "Original body");
     int64_t id = repo_->create_note(note, subkey());
 
@@ -188,7 +214,7 @@ TEST_F(NotesRepositoryTest, UpdateNote) {
 // ===================================================================
 // Test 8: Update nonexistent note
 // ===================================================================
-TEST_F(NotesRepositoryTest, UpdateNonexistentNote) {
+TEST_P(NotesRepositoryTest, UpdateNonexistentNote) {
     Note note;
     note.id = 99999;
     note.title = "Ghost";
@@ -200,9 +226,9 @@ TEST_F(NotesRepositoryTest, UpdateNonexistentNote) {
 // ===================================================================
 // Test 9: Delete note
 // ===================================================================
-TEST_F(NotesRepositoryTest, DeleteNote) {
+TEST_P(NotesRepositoryTest, DeleteNote) {
     int64_t id = repo_->create_note(make_note("To Delete", ""), subkey());
-    EXPECT_TRUE(repo_->delete_note(id));
+    EXPECT_TRUE(repo_->delete_note(id, subkey()));
 
     // Verify deleted
     EXPECT_FALSE(repo_->read_note(id, subkey()).has_value());
@@ -211,14 +237,14 @@ TEST_F(NotesRepositoryTest, DeleteNote) {
 // ===================================================================
 // Test 10: Delete nonexistent note
 // ===================================================================
-TEST_F(NotesRepositoryTest, DeleteNonexistentNote) {
-    EXPECT_FALSE(repo_->delete_note(99999));
+TEST_P(NotesRepositoryTest, DeleteNonexistentNote) {
+    EXPECT_FALSE(repo_->delete_note(99999, subkey()));
 }
 
 // ===================================================================
 // Test 11: Note with all fields survives round-trip
 // ===================================================================
-TEST_F(NotesRepositoryTest, NoteWithAllFields) {
+TEST_P(NotesRepositoryTest, NoteWithAllFields) {
     auto note = make_note(
         "Full Note",
         "This is the body with multiple lines.\nLine 2.\nLine 3.",
@@ -239,7 +265,7 @@ TEST_F(NotesRepositoryTest, NoteWithAllFields) {
 // ===================================================================
 // Test 12: Note with empty fields
 // ===================================================================
-TEST_F(NotesRepositoryTest, NoteWithEmptyFields) {
+TEST_P(NotesRepositoryTest, NoteWithEmptyFields) {
     auto note = make_note("", "", {});
     int64_t id = repo_->create_note(note, subkey());
 
@@ -253,7 +279,7 @@ TEST_F(NotesRepositoryTest, NoteWithEmptyFields) {
 // ===================================================================
 // Test 13: Note with Unicode content
 // ===================================================================
-TEST_F(NotesRepositoryTest, NoteWithUnicodeContent) {
+TEST_P(NotesRepositoryTest, NoteWithUnicodeContent) {
     // UTF-8 encoded strings (Japanese title, Russian body, mixed tags)
     std::string jp_title = "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x82\xbf\xe3\x82\xa4\xe3\x83\x88\xe3\x83\xab";
     std::string ru_body = "\xd0\xa1\xd0\xbe\xd0\xb4\xd0\xb5\xd1\x80\xd0\xb6\xd0\xb8\xd0\xbc\xd0\xbe\xd0\xb5 \xd0\xbd\xd0\xb0 \xd1\x80\xd1\x83\xd1\x81\xd1\x81\xd0\xba\xd0\xbe\xd0\xbc \xd1\x8f\xd0\xb7\xd1\x8b\xd0\xba\xd0\xb5 \xf0\x9f\x94\x90";
@@ -274,7 +300,7 @@ TEST_F(NotesRepositoryTest, NoteWithUnicodeContent) {
 // ===================================================================
 // Test 14: Wrong key cannot decrypt
 // ===================================================================
-TEST_F(NotesRepositoryTest, WrongKeyCannotDecrypt) {
+TEST_P(NotesRepositoryTest, WrongKeyCannotDecrypt) {
     int64_t id = repo_->create_note(make_note("Secret", "Secret body"), subkey());
 
     // Derive a different key
@@ -290,26 +316,15 @@ TEST_F(NotesRepositoryTest, WrongKeyCannotDecrypt) {
 // ===================================================================
 // Test 15: Fresh nonce on update
 // ===================================================================
-TEST_F(NotesRepositoryTest, FreshNonceOnUpdate) {
+TEST_P(NotesRepositoryTest, FreshNonceOnUpdate) {
     auto note = make_note("Original", "Body");
     int64_t id = repo_->create_note(note, subkey());
 
-    // Read original nonce from DB directly (must key with SQLCipher)
-    sqlite3* db = nullptr;
-    sqlite3_open(vault_path_.c_str(), &db);
-    sqlite3_key(db, vault_->db_subkey().data(), static_cast<int>(vault_->db_subkey().size()));
-
+    // Read the stored nonce straight from the engine
     auto get_nonce = [&](int64_t note_id) -> std::vector<uint8_t> {
-        sqlite3_stmt* stmt = nullptr;
-        sqlite3_prepare_v2(db, "SELECT nonce FROM notes WHERE id = ?", -1, &stmt, nullptr);
-        sqlite3_bind_int64(stmt, 1, note_id);
-        sqlite3_step(stmt);
-        const void* blob = sqlite3_column_blob(stmt, 0);
-        int size = sqlite3_column_bytes(stmt, 0);
-        std::vector<uint8_t> nonce(static_cast<const uint8_t*>(blob),
-                                   static_cast<const uint8_t*>(blob) + size);
-        sqlite3_finalize(stmt);
-        return nonce;
+        auto row = engine().get(Table::kNotes, RowKey{note_id}, {col::Notes::kNonce});
+        auto nonce = row->blob(col::Notes::kNonce);
+        return std::vector<uint8_t>(nonce.begin(), nonce.end());
     };
 
     auto nonce_before = get_nonce(id);
@@ -321,8 +336,979 @@ TEST_F(NotesRepositoryTest, FreshNonceOnUpdate) {
 
     auto nonce_after = get_nonce(id);
 
-    sqlite3_close(db);
-
     // Nonces should be different (fresh random nonce per encryption)
     EXPECT_NE(nonce_before, nonce_after);
 }
+
+// ===================================================================
+// Test 16: Pre-algorithm-column vaults migrate and legacy records still read
+// ===================================================================
+TEST_P(NotesRepositoryTest, LegacyXChaChaRecordReadableAfterMigration) {
+    if (GetParam() != Backend::kSqlite) {
+        GTEST_SKIP() << "Schema migration is specific to the SQLite vault";
+    }
+    int64_t id = repo_->create_note(make_note("Placeholder", "Body"), subkey());
+
+    // Rewrite the row as an old build would have: XChaCha20-Poly1305, no alg
+    // or codec column
+    const std::string legacy_json =
+        R"({"body":"Old body","tags":["old"],"title":"Legacy","version":1})";
+    std::vector<uint8_t> aad(4);
+    uint32_t id32 = static_cast<uint32_t>(id);
+    std::memcpy(aad.data(), &id32, 4);
+    auto legacy = CryptoService::encrypt(
+        std::vector<uint8_t>(legacy_json.begin(), legacy_json.end()), subkey(), aad,
+        CryptoService::Algorithm::XChaCha20Poly1305);
+
+    repo_.reset();
+    {
+        sqlite3* db = nullptr;
+        sqlite3_open(vault_path_.c_str(), &db);
+        sqlite3_key(db, vault_->db_subkey().data(), static_cast<int>(vault_->db_subkey().size()));
+
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db, "UPDATE notes SET nonce = ?, ciphertext = ? WHERE id = ?",
+                           -1, &stmt, nullptr);
+        sqlite3_bind_blob(stmt, 1, legacy.nonce.data(), static_cast<int>(legacy.nonce.size()),
+                          SQLITE_STATIC);
+        sqlite3_bind_blob(stmt, 2, legacy.ciphertext.data(),
+                          static_cast<int>(legacy.ciphertext.size()), SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 3, id);
+        ASSERT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+        sqlite3_finalize(stmt);
+
+        ASSERT_EQ(SQLITE_OK, sqlite3_exec(db, "ALTER TABLE notes DROP COLUMN alg;"
+                                              "ALTER TABLE notes DROP COLUMN codec;"
+                                              "DROP INDEX idx_notes_pack;"
+                                              "ALTER TABLE notes DROP COLUMN pack_id;",
+                                          nullptr, nullptr, nullptr));
+        sqlite3_close(db);
+    }
+
+    // Unlock runs the schema migration
+    vault_->lock();
+    ASSERT_TRUE(vault_->unlock("test_password"));
+    open_repo();
+
+    auto read = repo_->read_note(id, subkey());
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ("Legacy", read->title);
+    EXPECT_EQ("Old body", read->body);
+
+    // Rewriting upgrades the record to the preferred algorithm
+    read->body = "New body";
+    ASSERT_TRUE(repo_->update_note(*read, subkey()));
+    auto reread = repo_->read_note(id, subkey());
+    ASSERT_TRUE(reread.has_value());
+    EXPECT_EQ("New body", reread->body);
+}
+
+// ===================================================================
+// Test 17: Large bodies are stored chunked and read back intact
+// ===================================================================
+TEST_P(NotesRepositoryTest, LargeNoteChunkedRoundTrip) {
+    // Not a multiple of the chunk size, so the last chunk is partial
+    std::string body;
+    for (size_t i = 0; body.size() < NotesRepository::kChunkedBodyThresholdBytes + 1000; ++i) {
+        body += "line " + std::to_string(i) + " of a very large note\n";
+    }
+    body += "needle-at-the-end";
+
+    int64_t id = repo_->create_note(make_note("Big", body, {"large"}), subkey());
+
+    auto read = repo_->read_note(id, subkey());
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ("Big", read->title);
+    EXPECT_TRUE(read->body.view() == body);
+    ASSERT_EQ(1u, read->tags.size());
+
+    // Streamed read delivers the same bytes one chunk at a time
+    std::string streamed;
+    size_t pieces = 0;
+    auto meta = repo_->read_note_streamed(id, subkey(), [&](std::string_view piece) {
+        EXPECT_LE(piece.size(), NotesRepository::kBodyChunkBytes);
+        streamed.append(piece);
+        pieces++;
+    });
+    ASSERT_TRUE(meta.has_value());
+    EXPECT_TRUE(meta->body.empty());
+    EXPECT_EQ(body, streamed);
+    EXPECT_GT(pieces, 1u);
+
+    // List shows a preview; search reaches the last chunk
+    auto summaries = repo_->list_notes(subkey());
+    ASSERT_EQ(1u, summaries.size());
+    EXPECT_EQ(0u, summaries[0].preview.find("line 0 of a very large note"));
+    EXPECT_EQ(1u, repo_->search_notes(subkey(), "needle-at-the-end").size());
+
+    // Shrinking below the threshold moves the body back inline
+    read->body = "small now";
+    ASSERT_TRUE(repo_->update_note(*read, subkey()));
+    auto small = repo_->read_note(id, subkey());
+    ASSERT_TRUE(small.has_value());
+    EXPECT_EQ("small now", small->body);
+}
+
+// ===================================================================
+// Test 18: Dropped, swapped or stale chunks are detected
+// ===================================================================
+TEST_P(NotesRepositoryTest, TamperedChunksRejected) {
+    std::string body;
+    for (size_t i = 0; body.size() < NotesRepository::kChunkedBodyThresholdBytes; ++i) {
+        body += "entry " + std::to_string(i) + ": nothing to report today\n";
+    }
+    int64_t id = repo_->create_note(make_note("Big", body), subkey());
+    ASSERT_TRUE(repo_->read_note(id, subkey()).has_value());
+
+    // Move a chunk row to another chunk ID
+    auto move_chunk = [&](int64_t from, int64_t to) {
+        auto row = engine().get(Table::kContentChunks, RowKey{id, from});
+        ASSERT_TRUE(row.has_value());
+        engine().erase(Table::kContentChunks, RowKey{id, from});
+        engine().put(Table::kContentChunks, RowKey{id, to}, *row);
+    };
+
+    // Swap chunks 1 and 2
+    move_chunk(1, -1);
+    move_chunk(2, 1);
+    move_chunk(-1, 2);
+    EXPECT_FALSE(repo_->read_note(id, subkey()).has_value());
+
+    // Restore order, then hide the last chunk
+    move_chunk(1, -1);
+    move_chunk(2, 1);
+    move_chunk(-1, 2);
+    ASSERT_TRUE(repo_->read_note(id, subkey()).has_value());
+    int64_t last = 0;
+    engine().scan(Table::kContentChunks, KeyRange::prefix(id), [&](const RowKey& key, const Row&) {
+        last = key.b;
+        return false;
+    }, Projection::none(), ScanOrder::kDescending);
+    move_chunk(last, -1);
+    EXPECT_FALSE(repo_->read_note(id, subkey()).has_value());
+    move_chunk(-1, last);
+    ASSERT_TRUE(repo_->read_note(id, subkey()).has_value());
+
+    // A validly encrypted row for chunk 1 (e.g. left over from an earlier
+    // version) with other content fails the manifest hash
+    auto chunk = engine().get(Table::kContentChunks, RowKey{id, 1});
+    ASSERT_TRUE(chunk.has_value());
+    size_t chunk_size = chunk->blob(col::ContentChunks::kCiphertext).size() - 16;
+    std::vector<uint8_t> aad(12, 0);
+    uint32_t id32 = static_cast<uint32_t>(id);
+    std::memcpy(aad.data(), &id32, 4);
+    aad[4] = 1;
+    auto stale = CryptoService::encrypt(std::vector<uint8_t>(chunk_size, 'z'), subkey(), aad);
+    chunk->set(col::ContentChunks::kNonce, stale.nonce);
+    chunk->set(col::ContentChunks::kCiphertext, stale.ciphertext);
+    chunk->set(col::ContentChunks::kAlg, int64_t{0});
+    engine().put(Table::kContentChunks, RowKey{id, 1}, *chunk);
+    EXPECT_FALSE(repo_->read_note(id, subkey()).has_value());
+
+    // Deleting the note removes its chunks
+    EXPECT_TRUE(repo_->delete_note(id, subkey()));
+    EXPECT_EQ(0u, repo_->storage_stats().chunk_bytes);
+}
+
+// ===================================================================
+// Test 19: Payloads are compressed before encryption
+// ===================================================================
+TEST_P(NotesRepositoryTest, CompressedRecordRoundTrip) {
+    std::string body;
+    for (int i = 0; i < 200; ++i) {
+        body += "- [ ] repeat this checklist item " + std::to_string(i % 10) + "\n";
+    }
+
+    repo_->set_compression_enabled(false);
+    int64_t raw_id = repo_->create_note(make_note("Checklist", body, {"todo"}), subkey());
+    uint64_t raw_bytes = repo_->storage_stats().record_bytes;
+
+    repo_->set_compression_enabled(true);
+    int64_t id = repo_->create_note(make_note("Checklist", body, {"todo"}), subkey());
+    uint64_t compressed_bytes = repo_->storage_stats().record_bytes - raw_bytes;
+    EXPECT_LT(compressed_bytes * 4, raw_bytes);
+
+    // Both codecs read back identically
+    for (int64_t note_id : {raw_id, id}) {
+        auto note = repo_->read_note(note_id, subkey());
+        ASSERT_TRUE(note.has_value());
+        EXPECT_EQ(body, note->body);
+        EXPECT_EQ(std::vector<std::string>{"todo"}, note->tags);
+    }
+    EXPECT_EQ(2u, repo_->search_notes(subkey(), "checklist item 9").size());
+}
+
+// ===================================================================
+// Test 20: Trained dictionary shrinks small notes and reloads from the vault
+// ===================================================================
+TEST_P(NotesRepositoryTest, CompressionDictionaryTrainedAndPersisted) {
+    // Too few notes: nothing is trained
+    repo_->create_note(make_note("Lonely", "just one"), subkey());
+    EXPECT_FALSE(repo_->ensure_compression_dictionary(subkey()));
+
+    const size_t count = NotesRepository::kDictionaryMinNotes * 4;
+    for (size_t i = 0; i < count; ++i) {
+        std::string n = std::to_string(i);
+        repo_->create_note(make_note(
+            "Daily log " + n,
+            "Weather: cloudy. Mood: fine. Worked on ticket BX-" + n +
+            " and reviewed pull requests. Tomorrow: follow up on BX-" + n + ".",
+            {"journal", "daily"}), subkey());
+    }
+    uint64_t before = repo_->storage_stats().record_bytes;
+
+    ASSERT_TRUE(repo_->ensure_compression_dictionary(subkey()));
+    EXPECT_FALSE(repo_->ensure_compression_dictionary(subkey()));  // Already trained
+    uint64_t after = repo_->storage_stats().record_bytes;
+    EXPECT_LT(after * 2, before);
+
+    // A fresh repository loads the (encrypted) dictionary to read the notes
+    repo_.reset();
+    open_repo();
+    auto summaries = repo_->list_notes(subkey());
+    EXPECT_EQ(count + 1, summaries.size());
+    auto hits = repo_->search_notes(subkey(), "follow up on BX-42.");
+    ASSERT_EQ(1u, hits.size());
+    EXPECT_EQ("Daily log 42", hits[0].title);
+
+    // New writes use the dictionary too
+    int64_t id = repo_->create_note(make_note("Daily log new", "Weather: sunny."), subkey());
+    auto note = repo_->read_note(id, subkey());
+    ASSERT_TRUE(note.has_value());
+    EXPECT_EQ("Weather: sunny.", note->body);
+}
+
+// ===================================================================
+// Test 21: A record compressed against a missing dictionary is not readable
+// ===================================================================
+TEST_P(NotesRepositoryTest, MissingDictionaryRejected) {
+    for (size_t i = 0; i < NotesRepository::kDictionaryMinNotes; ++i) {
+        repo_->create_note(make_note("Entry " + std::to_string(i),
+                                     "shared boilerplate text for every entry " + std::to_string(i)),
+                           subkey());
+    }
+    ASSERT_TRUE(repo_->train_compression_dictionary(subkey()));
+
+    engine().erase_range(Table::kCompressionDicts, KeyRange::all());
+
+    repo_.reset();
+    open_repo();
+    EXPECT_TRUE(repo_->list_notes(subkey()).empty());
+}
+
+// ===================================================================
+// Test 22: Version-1 JSON records read back and become binary when rewritten
+// ===================================================================
+TEST_P(NotesRepositoryTest, JsonRecordConvertedOnRewrite) {
+    repo_->set_compression_enabled(false);  // Stored plaintext is the record itself
+    int64_t id = repo_->create_note(make_note("Placeholder", "Body"), subkey());
+
+    std::vector<uint8_t> aad(4);
+    uint32_t id32 = static_cast<uint32_t>(id);
+    std::memcpy(aad.data(), &id32, 4);
+
+    // First plaintext byte of the stored record
+    auto stored_version = [&]() -> int {
+        auto row = engine().get(Table::kNotes, RowKey{id});
+        if (!row.has_value()) {
+            return -1;
+        }
+        CryptoService::EncryptedData enc;
+        auto nonce = row->blob(col::Notes::kNonce);
+        auto ct = row->blob(col::Notes::kCiphertext);
+        std::memcpy(enc.nonce.data(), nonce.data(), enc.nonce.size());
+        enc.ciphertext.assign(ct.begin(), ct.end());
+        enc.algorithm = static_cast<CryptoService::Algorithm>(row->integer(col::Notes::kAlg));
+        auto plain = CryptoService::decrypt(enc, subkey(), aad);
+        if (!plain.has_value() || plain->empty()) {
+            return -1;
+        }
+        return (*plain)[0];
+    };
+    EXPECT_EQ(2, stored_version());
+
+    // Rewrite the row as a version-1 (JSON) build would have
+    const std::string legacy_json =
+        R"({"body":"Old body","tags":["old"],"title":"Legacy","version":1})";
+    auto legacy = CryptoService::encrypt(
+        std::vector<uint8_t>(legacy_json.begin(), legacy_json.end()), subkey(), aad,
+        CryptoService::Algorithm::XChaCha20Poly1305);
+    rewrite_record(id, legacy);
+    EXPECT_EQ('{', stored_version());
+
+    auto summaries = repo_->list_notes(subkey());
+    ASSERT_EQ(1u, summaries.size());
+    EXPECT_EQ("Legacy", summaries[0].title);
+    EXPECT_EQ("Old body", summaries[0].preview);
+
+    // Reading leaves the record alone; rewriting converts it
+    auto read = repo_->read_note(id, subkey());
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ("Old body", read->body);
+    EXPECT_EQ(std::vector<std::string>{"old"}, read->tags);
+    EXPECT_EQ('{', stored_version());
+
+    ASSERT_TRUE(repo_->update_note(*read, subkey()));
+    EXPECT_EQ(2, stored_version());
+    auto reread = repo_->read_note(id, subkey());
+    ASSERT_TRUE(reread.has_value());
+    EXPECT_EQ("Legacy", reread->title);
+    EXPECT_EQ("Old body", reread->body);
+    EXPECT_EQ(std::vector<std::string>{"old"}, reread->tags);
+}
+
+// ===================================================================
+// Test 23: Editing a large note writes only the chunks that changed
+// ===================================================================
+TEST_P(NotesRepositoryTest, LargeNoteEditRewritesChangedChunksOnly) {
+    std::string body;
+    for (size_t i = 0; body.size() < 1024 * 1024; ++i) {
+        body += "Day " + std::to_string(i) + ": " + std::to_string(i * 7919 % 10007) +
+                " steps, slept " + std::to_string(i % 9) + "h\n";
+    }
+    int64_t id = repo_->create_note(make_note("Journal", body), subkey());
+
+    // Chunk rows with an ID above `above`
+    auto count_chunks = [&](int64_t above) {
+        int64_t count = 0;
+        engine().scan(Table::kContentChunks, KeyRange::prefix(id),
+            [&](const RowKey& key, const Row&) {
+                count += key.b > above ? 1 : 0;
+                return true;
+            }, Projection::none());
+        return count;
+    };
+
+    int64_t chunks = count_chunks(0);
+    int64_t max_id = 0;
+    engine().scan(Table::kContentChunks, KeyRange::prefix(id), [&](const RowKey& key, const Row&) {
+        max_id = key.b;
+        return false;
+    }, Projection::none(), ScanOrder::kDescending);
+    EXPECT_GT(chunks, 16);
+
+    // One-character edit in the middle
+    auto note = repo_->read_note(id, subkey());
+    ASSERT_TRUE(note.has_value());
+    body.insert(body.size() / 2, "!");
+    note->body = body;
+    ASSERT_TRUE(repo_->update_note(*note, subkey()));
+
+    int64_t written = count_chunks(max_id);
+    EXPECT_GE(written, 1);
+    EXPECT_LE(written, 2);
+    EXPECT_LE(std::abs(count_chunks(0) - chunks), 1);
+
+    auto read = repo_->read_note(id, subkey());
+    ASSERT_TRUE(read.has_value());
+    EXPECT_TRUE(read->body.view() == body);
+}
+
+// ===================================================================
+// Test 24: Bodies stored as a legacy secretstream read back and move to
+// content-defined chunks on the next save
+// ===================================================================
+TEST_P(NotesRepositoryTest, LegacyStreamedBodyConvertedOnSave) {
+    int64_t id = repo_->create_note(make_note("Placeholder", "Body"), subkey());
+
+    std::string body(200 * 1024, 'q');
+    body.replace(0, 5, "Start");
+    body.replace(body.size() - 3, 3, "End");
+    const size_t stream_chunk = 64 * 1024;
+    const size_t stream_chunks = (body.size() + stream_chunk - 1) / stream_chunk;
+
+    // Record and body stream as the previous format wrote them
+    const std::string legacy_json =
+        R"({"body":"","body_bytes":)" + std::to_string(body.size()) +
+        R"(,"body_chunks":)" + std::to_string(stream_chunks) +
+        R"(,"tags":[],"title":"Streamed","version":1})";
+    std::vector<uint8_t> aad(4);
+    uint32_t id32 = static_cast<uint32_t>(id);
+    std::memcpy(aad.data(), &id32, 4);
+    auto record = CryptoService::encrypt(
+        std::vector<uint8_t>(legacy_json.begin(), legacy_json.end()), subkey(), aad);
+
+    std::vector<uint8_t> chunk_aad = aad;
+    chunk_aad.insert(chunk_aad.end(), record.nonce.begin(), record.nonce.end());
+
+    rewrite_record(id, record);
+    {
+        SecretStreamWriter writer(subkey());
+        auto insert = [&](int64_t seq, std::span<const uint8_t> data) {
+            Row row(Table::kNoteChunks);
+            row.set(col::NoteChunks::kData, data);
+            engine().put(Table::kNoteChunks, RowKey{id, seq}, row);
+        };
+        insert(0, writer.header());
+        std::vector<uint8_t> ciphertext;
+        for (size_t i = 0; i < stream_chunks; ++i) {
+            std::string_view piece = std::string_view(body).substr(i * stream_chunk, stream_chunk);
+            writer.push(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(piece.data()),
+                                                 piece.size()),
+                        chunk_aad, i + 1 == stream_chunks, ciphertext);
+            insert(static_cast<int64_t>(i + 1), ciphertext);
+        }
+    }
+
+    auto read = repo_->read_note(id, subkey());
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ("Streamed", read->title);
+    EXPECT_TRUE(read->body.view() == body);
+    auto summaries = repo_->list_notes(subkey());
+    ASSERT_EQ(1u, summaries.size());
+    EXPECT_EQ(0u, summaries[0].preview.find("Start"));
+
+    // Saving replaces the stream with content-defined chunks
+    uint64_t stream_bytes = repo_->storage_stats().chunk_bytes;
+    ASSERT_TRUE(repo_->update_note(*read, subkey()));
+    auto reread = repo_->read_note(id, subkey());
+    ASSERT_TRUE(reread.has_value());
+    EXPECT_TRUE(reread->body.view() == body);
+    EXPECT_NE(stream_bytes, repo_->storage_stats().chunk_bytes);
+
+    EXPECT_EQ(0u, engine().usage(Table::kNoteChunks, col::NoteChunks::kData).rows);
+    EXPECT_GT(engine().usage(Table::kContentChunks, col::ContentChunks::kCiphertext).rows, 0u);
+}
+
+// Move notes' updated_at back by `days` (notes are only packed once cold)
+static void age_notes(StorageEngine& engine, int64_t days) {
+    std::vector<std::pair<RowKey, Row>> rows;
+    engine.scan(Table::kNotes, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+        rows.emplace_back(key, row);
+        return true;
+    });
+    for (auto& [key, row] : rows) {
+        row.set(col::Notes::kUpdatedAt, row.integer(col::Notes::kUpdatedAt) - days * 86400);
+        engine.put(Table::kNotes, key, row);
+    }
+}
+
+// ===================================================================
+// Test 25: Cold notes are packed and still read, list and search
+// ===================================================================
+TEST_P(NotesRepositoryTest, ColdNotesPackedAndReadable) {
+    std::vector<int64_t> old_ids;
+    for (int i = 0; i < 20; ++i) {
+        old_ids.push_back(repo_->create_note(
+            make_note("Old " + std::to_string(i), "archived body " + std::to_string(i),
+                      {"archive"}), subkey()));
+    }
+    std::string big(NotesRepository::kChunkedBodyThresholdBytes + 10, 'b');
+    int64_t big_id = repo_->create_note(make_note("Big", big), subkey());
+    age_notes(engine(), 200);
+    int64_t fresh_id = repo_->create_note(make_note("Fresh", "current body"), subkey());
+
+    // Chunked and recent notes stay hot
+    EXPECT_EQ(20u, repo_->pack_cold_notes(subkey(), std::chrono::hours(24 * 90)));
+    auto stats = repo_->storage_stats();
+    EXPECT_EQ(20u, stats.packed_note_count);
+    EXPECT_EQ(1u, stats.pack_count);
+    EXPECT_GT(stats.pack_bytes, 0u);
+    EXPECT_EQ(0u, repo_->pack_cold_notes(subkey(), std::chrono::hours(24 * 90)));
+
+    // Read through a fresh connection (empty pack cache) and the warm one
+    open_repo();
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < 20; ++i) {
+            auto note = repo_->read_note(old_ids[i], subkey());
+            ASSERT_TRUE(note.has_value());
+            EXPECT_EQ("Old " + std::to_string(i), note->title);
+            EXPECT_EQ("archived body " + std::to_string(i), note->body);
+            EXPECT_EQ(std::vector<std::string>{"archive"}, note->tags);
+        }
+    }
+    ASSERT_TRUE(repo_->read_note(big_id, subkey()).has_value());
+
+    auto summaries = repo_->list_notes(subkey());
+    ASSERT_EQ(22u, summaries.size());
+    EXPECT_EQ(fresh_id, summaries[0].id);
+    EXPECT_EQ(20u, repo_->search_notes(subkey(), "ARCHIVED").size());
+    EXPECT_EQ(1u, repo_->search_notes(subkey(), "body 13").size());
+}
+
+// ===================================================================
+// Test 26: Saving a packed note unpacks it and rewrites its pack; small
+// packs are repacked and empty ones removed
+// ===================================================================
+TEST_P(NotesRepositoryTest, PackedNotesMoveBackWhenEdited) {
+    std::vector<int64_t> ids;
+    for (int i = 0; i < 20; ++i) {
+        ids.push_back(repo_->create_note(
+            make_note("Note " + std::to_string(i), "body " + std::to_string(i)), subkey()));
+    }
+    age_notes(engine(), 365);
+    ASSERT_EQ(20u, repo_->pack_cold_notes(subkey(), std::chrono::hours(24 * 90)));
+
+    auto note = repo_->read_note(ids[0], subkey());
+    ASSERT_TRUE(note.has_value());
+    note->body = "edited body";
+    ASSERT_TRUE(repo_->update_note(*note, subkey()));
+    auto stats = repo_->storage_stats();
+    EXPECT_EQ(19u, stats.packed_note_count);
+    EXPECT_EQ(1u, stats.pack_count);
+    auto reread = repo_->read_note(ids[0], subkey());
+    ASSERT_TRUE(reread.has_value());
+    EXPECT_EQ("edited body", reread->body);
+    EXPECT_EQ(ids[0], repo_->list_notes(subkey())[0].id);
+
+    // A pack shrunk below kPackMinNotes waits for more cold notes to join
+    for (int i = 1; i <= 12; ++i) {
+        auto n = repo_->read_note(ids[i], subkey());
+        ASSERT_TRUE(n.has_value());
+        ASSERT_TRUE(repo_->update_note(*n, subkey()));
+    }
+    EXPECT_EQ(7u, repo_->storage_stats().packed_note_count);
+    EXPECT_EQ(0u, repo_->pack_cold_notes(subkey(), std::chrono::hours(24 * 90)));
+    age_notes(engine(), 365);
+    EXPECT_EQ(20u, repo_->pack_cold_notes(subkey(), std::chrono::hours(24 * 90)));
+    stats = repo_->storage_stats();
+    EXPECT_EQ(20u, stats.packed_note_count);
+    EXPECT_EQ(1u, stats.pack_count);
+    for (int i = 1; i < 20; ++i) {
+        auto n = repo_->read_note(ids[i], subkey());
+        ASSERT_TRUE(n.has_value());
+        EXPECT_EQ("body " + std::to_string(i), n->body);
+    }
+
+    // Deleting the last packed note removes the pack
+    for (int i = 1; i < 20; ++i) {
+        ASSERT_TRUE(repo_->delete_note(ids[i], subkey()));
+    }
+    EXPECT_EQ(1u, repo_->storage_stats().pack_count);
+    ASSERT_TRUE(repo_->delete_note(ids[0], subkey()));
+    stats = repo_->storage_stats();
+    EXPECT_EQ(0u, stats.packed_note_count);
+    EXPECT_EQ(0u, stats.pack_count);
+    EXPECT_TRUE(repo_->list_notes(subkey()).empty());
+}
+
+// ===================================================================
+// Test 27: Tampered or renumbered packs are rejected
+// ===================================================================
+TEST_P(NotesRepositoryTest, TamperedPackRejected) {
+    for (int i = 0; i < 10; ++i) {
+        repo_->create_note(make_note("Packed " + std::to_string(i), "secret"), subkey());
+    }
+    age_notes(engine(), 365);
+    ASSERT_EQ(10u, repo_->pack_cold_notes(subkey(), std::chrono::hours(24 * 90)));
+    int64_t hot_id = repo_->create_note(make_note("Hot", "still here"), subkey());
+    repo_.reset();
+
+    // Move every pack (and the notes pointing at it) `delta` IDs along
+    auto renumber = [&](int64_t delta) {
+        auto engine = backend_.open_engine(vault_path_, vault_->db_subkey());
+        std::vector<std::pair<RowKey, Row>> packs;
+        engine->scan(Table::kNotePacks, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+            packs.emplace_back(key, row);
+            return true;
+        });
+        engine->erase_range(Table::kNotePacks, KeyRange::all());
+        for (const auto& [key, row] : packs) {
+            engine->put(Table::kNotePacks, RowKey{key.a + delta}, row);
+        }
+        std::vector<std::pair<RowKey, Row>> notes;
+        engine->scan(Table::kNotes, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+            if (!row.is_null(col::Notes::kPackId)) {
+                notes.emplace_back(key, row);
+            }
+            return true;
+        });
+        for (auto& [key, row] : notes) {
+            row.set(col::Notes::kPackId, row.integer(col::Notes::kPackId) + delta);
+            engine->put(Table::kNotes, key, row);
+        }
+    };
+
+    // A pack moved to another ID fails authentication (AAD binds the ID)
+    renumber(100);
+    open_repo();
+    auto summaries = repo_->list_notes(subkey());
+    ASSERT_EQ(1u, summaries.size());
+    EXPECT_EQ(hot_id, summaries[0].id);
+    repo_.reset();
+
+    // Flipped ciphertext byte
+    renumber(-100);
+    open_repo();
+    ASSERT_EQ(11u, repo_->list_notes(subkey()).size());
+    repo_.reset();
+    {
+        auto engine = backend_.open_engine(vault_path_, vault_->db_subkey());
+        std::vector<std::pair<RowKey, Row>> packs;
+        engine->scan(Table::kNotePacks, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+            packs.emplace_back(key, row);
+            return true;
+        });
+        for (auto& [key, row] : packs) {
+            auto ct = row.blob(col::NotePacks::kCiphertext);
+            std::vector<uint8_t> flipped(ct.begin(), ct.end());
+            flipped[0] ^= 0x01;
+            row.set(col::NotePacks::kCiphertext, std::move(flipped));
+            engine->put(Table::kNotePacks, key, row);
+        }
+    }
+    open_repo();
+    EXPECT_EQ(1u, repo_->list_notes(subkey()).size());
+    EXPECT_FALSE(repo_->read_note(1, subkey()).has_value());
+}
+
+// Move every revision's timestamps `seconds` into the past
+static void age_revisions(StorageEngine& engine, int64_t seconds) {
+    std::vector<std::pair<RowKey, Row>> rows;
+    engine.scan(Table::kNoteRevisions, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+        rows.emplace_back(key, row);
+        return true;
+    });
+    for (auto& [key, row] : rows) {
+        row.set(col::NoteRevisions::kRecordedAt,
+                row.integer(col::NoteRevisions::kRecordedAt) - seconds);
+        row.set(col::NoteRevisions::kSavedAt, row.integer(col::NoteRevisions::kSavedAt) - seconds);
+        engine.put(Table::kNoteRevisions, key, row);
+    }
+}
+
+// ===================================================================
+// Test 28: Every recorded version rebuilds exactly, and can be restored
+// ===================================================================
+TEST_P(NotesRepositoryTest, RevisionsRebuildEveryVersion) {
+    std::vector<std::string> bodies;
+    std::string body;
+    for (int line = 0; line < 200; ++line) {
+        body += "Line " + std::to_string(line) + " of a long-lived note\n";
+    }
+    bodies.push_back(body);
+    auto note = make_note("Title 0", body, {"draft"});
+    note.id = repo_->create_note(note, subkey());
+
+    // Edits spread over time, so none are coalesced
+    constexpr int kEdits = 40;
+    for (int i = 1; i <= kEdits; ++i) {
+        age_revisions(engine(), 3600);
+        body.insert(body.size() / (i % 3 + 2), "edit " + std::to_string(i) + "\n");
+        bodies.push_back(body);
+        note.title = "Title " + std::to_string(i);
+        note.body = body;
+        ASSERT_TRUE(repo_->update_note(note, subkey()));
+    }
+
+    auto revisions = repo_->list_revisions(note.id);
+    ASSERT_EQ(static_cast<size_t>(kEdits), revisions.size());
+    EXPECT_EQ(kEdits, revisions.front().revision_id);
+    size_t keyframes = 0;
+    for (const auto& revision : revisions) {
+        keyframes += revision.keyframe ? 1 : 0;
+    }
+    EXPECT_EQ(3u, keyframes);  // Revisions 1, 17 and 33
+
+    // Revision N holds version N - 1; deltas are far smaller than the note
+    auto stats = repo_->storage_stats();
+    EXPECT_LT(stats.revision_bytes, bodies.back().size() * 6);
+    for (const auto& revision : revisions) {
+        auto version = repo_->read_revision(note.id, revision.revision_id, subkey());
+        ASSERT_TRUE(version.has_value()) << revision.revision_id;
+        size_t n = static_cast<size_t>(revision.revision_id - 1);
+        EXPECT_EQ("Title " + std::to_string(n), version->title);
+        EXPECT_TRUE(version->body.view() == bodies[n]) << revision.revision_id;
+        ASSERT_EQ(1u, version->tags.size());
+    }
+    EXPECT_FALSE(repo_->read_revision(note.id, kEdits + 1, subkey()).has_value());
+
+    // Restoring makes the old version current and keeps the replaced one
+    age_revisions(engine(), 3600);
+    ASSERT_TRUE(repo_->restore_revision(note.id, 5, subkey()));
+    auto current = repo_->read_note(note.id, subkey());
+    ASSERT_TRUE(current.has_value());
+    EXPECT_TRUE(current->body.view() == bodies[4]);
+    auto replaced = repo_->read_revision(note.id, kEdits + 1, subkey());
+    ASSERT_TRUE(replaced.has_value());
+    EXPECT_TRUE(replaced->body.view() == bodies.back());
+}
+
+// ===================================================================
+// Test 29: Saves in quick succession fold into the newest revision
+// ===================================================================
+TEST_P(NotesRepositoryTest, AutosaveBurstCoalesced) {
+    auto note = make_note("Draft", "version 0 " + std::string(300, 'a'));
+    note.id = repo_->create_note(note, subkey());
+
+    auto save = [&](int version) {
+        note.body = "version " + std::to_string(version) + " " + std::string(300, 'a');
+        ASSERT_TRUE(repo_->update_note(note, subkey()));
+    };
+    for (int v = 1; v <= 5; ++v) {
+        save(v);
+    }
+    ASSERT_EQ(1u, repo_->list_revisions(note.id).size());
+
+    // Unchanged content records nothing
+    ASSERT_TRUE(repo_->update_note(note, subkey()));
+    ASSERT_EQ(1u, repo_->list_revisions(note.id).size());
+
+    age_revisions(engine(), NotesRepository::kRevisionCoalesceSeconds);
+    save(6);
+    save(7);  // Rebases revision 2 onto version 7; version 6 is dropped
+
+    auto revisions = repo_->list_revisions(note.id);
+    ASSERT_EQ(2u, revisions.size());
+    auto second = repo_->read_revision(note.id, 2, subkey());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(0u, second->body.view().find("version 5 "));
+    auto first = repo_->read_revision(note.id, 1, subkey());
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(0u, first->body.view().find("version 0 "));
+}
+
+// ===================================================================
+// Test 30: Retention policy bounds history; deleting a note drops it
+// ===================================================================
+TEST_P(NotesRepositoryTest, RevisionRetentionPolicy) {
+    NotesRepository::RevisionPolicy policy;
+    policy.max_revisions = 5;
+    repo_->set_revision_policy(policy);
+
+    auto note = make_note("Kept", "body 0");
+    note.id = repo_->create_note(note, subkey());
+    for (int i = 1; i <= 12; ++i) {
+        age_revisions(engine(), 3600);
+        note.body = "body " + std::to_string(i);
+        ASSERT_TRUE(repo_->update_note(note, subkey()));
+    }
+
+    // The newest five remain, and still rebuild without the pruned ones
+    auto revisions = repo_->list_revisions(note.id);
+    ASSERT_EQ(5u, revisions.size());
+    EXPECT_EQ(8, revisions.back().revision_id);
+    auto oldest = repo_->read_revision(note.id, 8, subkey());
+    ASSERT_TRUE(oldest.has_value());
+    EXPECT_EQ("body 7", oldest->body);
+
+    // Age limit applies vault-wide on prune_revisions()
+    policy.max_age = std::chrono::hours(24);
+    repo_->set_revision_policy(policy);
+    EXPECT_EQ(0u, repo_->prune_revisions());
+    age_revisions(engine(), 2 * 86400);
+    EXPECT_EQ(5u, repo_->prune_revisions());
+
+    // Disabled: nothing new is recorded
+    policy.enabled = false;
+    repo_->set_revision_policy(policy);
+    note.body = "body 13";
+    ASSERT_TRUE(repo_->update_note(note, subkey()));
+    EXPECT_TRUE(repo_->list_revisions(note.id).empty());
+
+    policy.enabled = true;
+    repo_->set_revision_policy(policy);
+    note.body = "body 14";
+    ASSERT_TRUE(repo_->update_note(note, subkey()));
+    ASSERT_EQ(1u, repo_->list_revisions(note.id).size());
+    ASSERT_TRUE(repo_->delete_note(note.id, subkey()));
+    EXPECT_EQ(0u, repo_->storage_stats().revision_count);
+}
+
+// ===================================================================
+// Test 31: Queued saves of many notes are written together, newest wins
+// ===================================================================
+TEST_P(NotesRepositoryTest, WriteBehindSavesGrouped) {
+    std::vector<Note> notes;
+    for (int i = 0; i < 3; ++i) {
+        auto note = make_note("Tab " + std::to_string(i), "original");
+        note.id = repo_->create_note(note, subkey());
+        notes.push_back(note);
+    }
+    int64_t before = repo_->last_change_seq();
+    auto change_seq = [&] {
+        auto row = engine().get(Table::kNotes, RowKey{notes[0].id});
+        return row.has_value() ? row->integer(col::Notes::kChangeSeq) : -1;
+    };
+    int64_t first_seq = change_seq();
+
+    for (int round = 1; round <= 3; ++round) {
+        for (auto& note : notes) {
+            note.body = "edit " + std::to_string(round);
+            repo_->queue_update(note, subkey());
+        }
+    }
+    EXPECT_EQ(3u, repo_->pending_writes());
+
+    EXPECT_EQ(first_seq, change_seq());  // Nothing reached storage yet
+
+    // Reading through the repository flushes first
+    auto read = repo_->read_note(notes[1].id, subkey());
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ("edit 3", read->body.str());
+    EXPECT_EQ(0u, repo_->pending_writes());
+
+    // One write (and one revision) per note, however often it was saved
+    EXPECT_EQ(3u, repo_->changes_since(before).size());
+    for (const auto& note : notes) {
+        EXPECT_EQ(1u, repo_->list_revisions(note.id).size());
+    }
+    EXPECT_EQ(0u, repo_->flush_writes());
+}
+
+// ===================================================================
+// Test 32: flush_writes() skips deleted notes; closing flushes the queue
+// ===================================================================
+TEST_P(NotesRepositoryTest, WriteBehindFlushBarrier) {
+    auto note = make_note("Open tab", "v1");
+    note.id = repo_->create_note(note, subkey());
+
+    auto gone = make_note("Deleted elsewhere", "x");
+    gone.id = note.id + 1000;
+    repo_->queue_update(gone, subkey());
+    note.body = "v2";
+    repo_->queue_update(note, subkey());
+    EXPECT_EQ(1u, repo_->flush_writes());
+    EXPECT_FALSE(repo_->read_note(gone.id, subkey()).has_value());
+
+    note.body = "v3";
+    repo_->queue_update(note, subkey());
+    open_repo();  // Closes the previous repository
+    auto read = repo_->read_note(note.id, subkey());
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ("v3", read->body.str());
+}
+
+// ===================================================================
+// Test 33: Notes leaving a pack leave no copy behind, and a row cannot
+// be pointed at an older pack
+// ===================================================================
+TEST_P(NotesRepositoryTest, PackRewrittenWhenNotesLeave) {
+    std::vector<int64_t> ids;
+    for (int i = 0; i < 10; ++i) {
+        ids.push_back(repo_->create_note(
+            make_note("Packed " + std::to_string(i), "body " + std::to_string(i)), subkey()));
+    }
+    age_notes(engine(), 365);
+    ASSERT_EQ(10u, repo_->pack_cold_notes(subkey(), std::chrono::hours(24 * 90)));
+
+    auto packs = [&] {
+        std::vector<std::pair<RowKey, Row>> rows;
+        engine().scan(Table::kNotePacks, KeyRange::all(), [&](const RowKey& key, const Row& row) {
+            rows.emplace_back(key, row);
+            return true;
+        });
+        return rows;
+    };
+    auto original = packs();
+    ASSERT_EQ(1u, original.size());
+
+    // Deleted and edited notes are dropped from the pack, not just unlinked
+    ASSERT_TRUE(repo_->delete_note(ids[0], subkey()));
+    auto n = repo_->read_note(ids[1], subkey());
+    ASSERT_TRUE(n.has_value());
+    ASSERT_TRUE(repo_->update_note(*n, subkey()));
+    auto current = packs();
+    ASSERT_EQ(1u, current.size());
+    EXPECT_NE(original[0].first.a, current[0].first.a);
+    EXPECT_EQ(8, current[0].second.integer(col::NotePacks::kNoteCount));
+    for (int i = 2; i < 10; ++i) {
+        auto packed = repo_->read_note(ids[i], subkey());
+        ASSERT_TRUE(packed.has_value());
+        EXPECT_EQ("body " + std::to_string(i), packed->body);
+    }
+
+    // Restore the original pack and point a note back at it
+    repo_.reset();
+    {
+        auto restored = backend_.open_engine(vault_path_, vault_->db_subkey());
+        restored->put(Table::kNotePacks, original[0].first, original[0].second);
+        auto row = restored->get(Table::kNotes, RowKey{ids[2]});
+        ASSERT_TRUE(row.has_value());
+        row->set(col::Notes::kPackId, original[0].first.a);
+        restored->put(Table::kNotes, RowKey{ids[2]}, *row);
+    }
+    open_repo();
+    EXPECT_FALSE(repo_->read_note(ids[2], subkey()).has_value());
+    EXPECT_TRUE(repo_->read_note(ids[3], subkey()).has_value());
+}
+
+// ===================================================================
+// Test 34: Revisions of chunked notes keep the manifest, and the chunk
+// rows they need stay until they are pruned
+// ===================================================================
+TEST_P(NotesRepositoryTest, ChunkedRevisionsKeptByManifest) {
+    std::string original;
+    for (size_t i = 0; original.size() < 2 * NotesRepository::kChunkedBodyThresholdBytes; ++i) {
+        original += "line " + std::to_string(i) + " of a very large note\n";
+    }
+    auto note = make_note("Big", original);
+    note.id = repo_->create_note(note, subkey());
+
+    auto chunk_rows = [&](bool released) {
+        size_t rows = 0;
+        engine().scan(Table::kContentChunks, KeyRange::prefix(note.id),
+            [&](const RowKey&, const Row& row) {
+                rows += row.is_null(col::ContentChunks::kReleasedBy) != released ? 1 : 0;
+                return true;
+            }, {col::ContentChunks::kReleasedBy});
+        return rows;
+    };
+    ASSERT_EQ(0u, chunk_rows(true));
+
+    // The revision is a manifest, not a copy of the body
+    age_revisions(engine(), 3600);
+    std::string edited = original;
+    edited.insert(edited.size() / 2, "an edit in the middle\n");
+    note.body = edited;
+    ASSERT_TRUE(repo_->update_note(note, subkey()));
+    auto revisions = repo_->list_revisions(note.id);
+    ASSERT_EQ(1u, revisions.size());
+    EXPECT_LT(revisions[0].stored_bytes, original.size() / 16);
+    size_t held = chunk_rows(true);
+    EXPECT_GT(held, 0u);
+
+    // A coalesced save drops the chunks only the dropped version used
+    std::string again = edited;
+    again.insert(again.size() / 2, "a second edit\n");
+    note.body = again;
+    ASSERT_TRUE(repo_->update_note(note, subkey()));
+    ASSERT_EQ(1u, repo_->list_revisions(note.id).size());
+    EXPECT_EQ(held, chunk_rows(true));
+    auto first = repo_->read_revision(note.id, 1, subkey());
+    ASSERT_TRUE(first.has_value());
+    EXPECT_TRUE(first->body.view() == original);
+
+    // Shrinking to an inline body hands every chunk to the new revision
+    age_revisions(engine(), 3600);
+    note.body = "short now";
+    ASSERT_TRUE(repo_->update_note(note, subkey()));
+    EXPECT_EQ(0u, chunk_rows(false));
+    auto second = repo_->read_revision(note.id, 2, subkey());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_TRUE(second->body.view() == again);
+
+    // Pruning the revisions drops their chunks
+    NotesRepository::RevisionPolicy policy;
+    policy.max_age = std::chrono::hours(24);
+    repo_->set_revision_policy(policy);
+    age_revisions(engine(), 2 * 86400);
+    EXPECT_EQ(2u, repo_->prune_revisions());
+    EXPECT_EQ(0u, chunk_rows(true));
+    EXPECT_EQ("short now", repo_->read_note(note.id, subkey())->body);
+}
+
+// ===================================================================
+// Test 35: read_note_if_inline() reads small notes and skips chunked ones
+// ===================================================================
+TEST_P(NotesRepositoryTest, ReadNoteIfInlineSkipsChunkedBodies) {
+    int64_t small_id = repo_->create_note(make_note("Small", "short body"), subkey());
+    std::string large(NotesRepository::kChunkedBodyThresholdBytes + 1, 'L');
+    int64_t large_id = repo_->create_note(make_note("Large", large), subkey());
+
+    auto small = repo_->read_note_if_inline(small_id, subkey());
+    ASSERT_TRUE(small.has_value());
+    EXPECT_EQ("Small", small->title);
+    EXPECT_EQ("short body", small->body);
+
+    EXPECT_FALSE(repo_->read_note_if_inline(large_id, subkey()).has_value());
+    EXPECT_FALSE(repo_->read_note_if_inline(large_id + 100, subkey()).has_value());
+
+    auto read = repo_->read_note(large_id, subkey());
+    ASSERT_TRUE(read.has_value());
+    EXPECT_TRUE(read->body.view() == large);
+}
+
+INSTANTIATE_TEST_SUITE_P(Engines, NotesRepositoryTest,
+                         ::testing::Values(Backend::kSqlite, Backend::kMemory, Backend::kLog),
+                         backend_name);
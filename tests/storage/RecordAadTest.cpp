@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/RecordAad.h"
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace bastionx::storage;
+
+static std::vector<uint8_t> bytes(const std::string& text) {
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+// ===================================================================
+// Test 1: Formats are pinned (they are persisted in every vault)
+// ===================================================================
+TEST(RecordAadTest, FormatsArePinned) {
+    EXPECT_EQ((std::vector<uint8_t>{0x2A, 0, 0, 0}), RecordAad::note(42));
+
+    std::array<uint8_t, bastionx::crypto::CryptoService::NONCE_BYTES> nonce{};
+    nonce.fill(0xEE);
+    auto stream = RecordAad::stream_chunk(42, nonce);
+    ASSERT_EQ(4u + nonce.size(), stream.size());
+    EXPECT_EQ(0x2A, stream[0]);
+    EXPECT_EQ(0xEE, stream.back());
+
+    EXPECT_EQ((std::vector<uint8_t>{0x2A, 0, 0, 0, 7, 0, 0, 0, 0, 0, 0, 0}),
+              RecordAad::content_chunk(42, 7));
+
+    auto dict = bytes("BXDICTv1");
+    dict.insert(dict.end(), {3, 0, 0, 0});
+    EXPECT_EQ(dict, RecordAad::dictionary(3));
+
+    auto pack = bytes("BXPACKv1");
+    pack.insert(pack.end(), {5, 0, 0, 0, 0, 0, 0, 0});
+    EXPECT_EQ(pack, RecordAad::pack(5));
+
+    auto ref = bytes("BXPREFv1");
+    ref.insert(ref.end(), {42, 0, 0, 0, 0, 0, 0, 0});
+    EXPECT_EQ(ref, RecordAad::pack_ref(42));
+
+    auto revision = bytes("BXREVSv1");
+    revision.insert(revision.end(), {42, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0});
+    EXPECT_EQ(revision, RecordAad::revision(42, 9));
+
+    auto key = bytes("BXAKEYv1");
+    key.insert(key.end(), {6, 0, 0, 0, 0, 0, 0, 0});
+    EXPECT_EQ(key, RecordAad::attachment_key(6));
+
+    auto link = bytes("BXAREFv1");
+    link.insert(link.end(), {42, 0, 0, 0, 0, 0, 0, 0, 6, 0, 0, 0, 0, 0, 0, 0});
+    EXPECT_EQ(link, RecordAad::attachment_link(42, 6));
+
+    EXPECT_EQ((std::vector<uint8_t>{6, 0, 0, 0, 0, 0, 0, 0}), RecordAad::attachment_chunk(6));
+    EXPECT_EQ(bytes("BXVKEYv1content"), RecordAad::vault_key("content"));
+}
+
+// ===================================================================
+// Test 2: Record kinds never share an AAD for the same IDs
+// ===================================================================
+TEST(RecordAadTest, KindsAreDistinct) {
+    std::set<std::vector<uint8_t>> seen = {
+        RecordAad::note(1),
+        RecordAad::content_chunk(1, 1),
+        RecordAad::dictionary(1),
+        RecordAad::pack(1),
+        RecordAad::pack_ref(1),
+        RecordAad::revision(1, 1),
+        RecordAad::attachment_key(1),
+        RecordAad::attachment_link(1, 1),
+        RecordAad::attachment_chunk(1),
+        RecordAad::vault_key("1"),
+    };
+    EXPECT_EQ(10u, seen.size());
+}
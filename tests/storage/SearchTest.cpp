@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "bastionx/storage/NotesRepository.h"
 #include "bastionx/vault/VaultService.h"
+#include "storage_backends.h"
 #include <sodium.h>
 #include <filesystem>
 #include <thread>
@@ -10,9 +11,11 @@ using namespace bastionx::storage;
 using namespace bastionx::vault;
 using namespace bastionx::crypto;
 namespace fs = std::filesystem;
+using namespace storage_backends;
 
-class SearchTest : public ::testing::Test {
+class SearchTest : public ::testing::TestWithParam<Backend> {
 protected:
+    BackendFixture backend_{GetParam()};
     std::string temp_dir_;
     std::string vault_path_;
     std::unique_ptr<VaultService> vault_;
@@ -35,7 +38,7 @@ protected:
         vault_ = std::make_unique<VaultService>(vault_path_);
         vault_->create("test_password");
 
-        repo_ = std::make_unique<NotesRepository>(vault_path_, &vault_->db_subkey());
+        open_repo();
     }
 
     void TearDown() override {
@@ -47,6 +50,11 @@ protected:
 
     const SecureKey& subkey() const { return vault_->notes_subkey(); }
 
+    void open_repo() {
+        repo_.reset();  // One engine per vault at a time
+        repo_ = backend_.open_repository(vault_path_, vault_->db_subkey());
+    }
+
     static Note make_note(const std::string& title, const std::string& body,
                           const std::vector<std::string>& tags = {}) {
         Note n;
@@ -57,7 +65,7 @@ protected:
     }
 };
 
-TEST_F(SearchTest, SearchByTitleCaseInsensitive) {
+TEST_P(SearchTest, SearchByTitleCaseInsensitive) {
     repo_->create_note(make_note("Meeting Notes", "discussed budgets"), subkey());
     repo_->create_note(make_note("Shopping List", "milk eggs bread"), subkey());
 
@@ -66,7 +74,7 @@ TEST_F(SearchTest, SearchByTitleCaseInsensitive) {
     EXPECT_EQ(results[0].title, "Meeting Notes");
 }
 
-TEST_F(SearchTest, SearchByBodySubstring) {
+TEST_P(SearchTest, SearchByBodySubstring) {
     repo_->create_note(make_note("Note A", "the quick brown fox jumps"), subkey());
     repo_->create_note(make_note("Note B", "lazy dog sleeping"), subkey());
 
@@ -75,7 +83,7 @@ TEST_F(SearchTest, SearchByBodySubstring) {
     EXPECT_EQ(results[0].title, "Note A");
 }
 
-TEST_F(SearchTest, SearchByTag) {
+TEST_P(SearchTest, SearchByTag) {
     repo_->create_note(make_note("Work", "some content", {"project", "urgent"}), subkey());
     repo_->create_note(make_note("Personal", "other content", {"home"}), subkey());
 
@@ -84,25 +92,25 @@ TEST_F(SearchTest, SearchByTag) {
     EXPECT_EQ(results[0].title, "Work");
 }
 
-TEST_F(SearchTest, EmptyQueryReturnsEmpty) {
+TEST_P(SearchTest, EmptyQueryReturnsEmpty) {
     repo_->create_note(make_note("Test", "content"), subkey());
     auto results = repo_->search_notes(subkey(), "");
     EXPECT_TRUE(results.empty());
 }
 
-TEST_F(SearchTest, SingleCharQueryReturnsEmpty) {
+TEST_P(SearchTest, SingleCharQueryReturnsEmpty) {
     repo_->create_note(make_note("Test", "content"), subkey());
     auto results = repo_->search_notes(subkey(), "x");
     EXPECT_TRUE(results.empty());
 }
 
-TEST_F(SearchTest, NoMatchReturnsEmpty) {
+TEST_P(SearchTest, NoMatchReturnsEmpty) {
     repo_->create_note(make_note("Hello", "world"), subkey());
     auto results = repo_->search_notes(subkey(), "zzzzz");
     EXPECT_TRUE(results.empty());
 }
 
-TEST_F(SearchTest, MultipleMatchesSortedByUpdatedAt) {
+TEST_P(SearchTest, MultipleMatchesSortedByUpdatedAt) {
     repo_->create_note(make_note("Alpha notes", "alpha content"), subkey());
     std::this_thread::sleep_for(std::chrono::seconds(1));
     repo_->create_note(make_note("Beta notes", "more alpha here"), subkey());
@@ -114,15 +122,15 @@ TEST_F(SearchTest, MultipleMatchesSortedByUpdatedAt) {
     EXPECT_EQ(results[1].title, "Alpha notes");
 }
 
-TEST_F(SearchTest, DeletedNoteNotReturned) {
+TEST_P(SearchTest, DeletedNoteNotReturned) {
     auto id = repo_->create_note(make_note("Delete Me", "findable text"), subkey());
-    repo_->delete_note(id);
+    repo_->delete_note(id, subkey());
 
     auto results = repo_->search_notes(subkey(), "findable");
     EXPECT_TRUE(results.empty());
 }
 
-TEST_F(SearchTest, BodySnippetContainsContext) {
+TEST_P(SearchTest, BodySnippetContainsContext) {
     std::string long_body = "Lorem ipsum dolor sit amet, consectetur adipiscing elit. "
                             "The secret keyword is hidden deep inside this long note body. "
                             "Sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.";
@@ -134,10 +142,14 @@ TEST_F(SearchTest, BodySnippetContainsContext) {
     EXPECT_NE(results[0].preview.find("secret keyword"), std::string::npos);
 }
 
-TEST_F(SearchTest, TagSearchCaseInsensitive) {
+TEST_P(SearchTest, TagSearchCaseInsensitive) {
     repo_->create_note(make_note("Tagged", "body", {"ImportantTag"}), subkey());
 
     auto results = repo_->search_notes(subkey(), "importanttag");
     ASSERT_EQ(results.size(), 1);
     EXPECT_EQ(results[0].title, "Tagged");
 }
+
+INSTANTIATE_TEST_SUITE_P(Engines, SearchTest,
+                         ::testing::Values(Backend::kSqlite, Backend::kMemory, Backend::kLog),
+                         backend_name);
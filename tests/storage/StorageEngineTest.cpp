@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include "bastionx/storage/StorageEngine.h"
+#include "bastionx/vault/VaultService.h"
+#include "storage_backends.h"
+#include <sodium.h>
+#include <filesystem>
+
+using namespace bastionx::storage;
+using namespace bastionx::vault;
+namespace fs = std::filesystem;
+using namespace storage_backends;
+
+/**
+ * @brief Behaviour every StorageEngine must share, checked on each backend
+ */
+class StorageEngineTest : public ::testing::TestWithParam<Backend> {
+protected:
+    BackendFixture backend_{GetParam()};
+    std::string temp_dir_;
+    std::string vault_path_;
+    std::unique_ptr<VaultService> vault_;
+    std::unique_ptr<StorageEngine> engine_;
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_engine_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        vault_path_ = (fs::path(temp_dir_) / "vault.db").string();
+
+        vault_ = std::make_unique<VaultService>(vault_path_);
+        vault_->create("test_password");
+        engine_ = backend_.open_engine(vault_path_, vault_->db_subkey());
+    }
+
+    void TearDown() override {
+        engine_.reset();
+        vault_.reset();
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    static Row chunk(uint8_t fill, size_t size = 8) {
+        Row row(Table::kContentChunks);
+        row.set(col::ContentChunks::kNonce, std::vector<uint8_t>(24, fill));
+        row.set(col::ContentChunks::kCiphertext, std::vector<uint8_t>(size, fill));
+        row.set(col::ContentChunks::kAlg, int64_t{1});
+        return row;
+    }
+
+    std::vector<RowKey> keys(Table table, const KeyRange& range,
+                             ScanOrder order = ScanOrder::kAscending) {
+        std::vector<RowKey> found;
+        engine_->scan(table, range, [&](const RowKey& key, const Row&) {
+            found.push_back(key);
+            return true;
+        }, Projection::none(), order);
+        return found;
+    }
+};
+
+// ===================================================================
+// Test 1: put inserts or replaces a row; get and erase find it by key
+// ===================================================================
+TEST_P(StorageEngineTest, PutGetEraseRoundTrip) {
+    EXPECT_FALSE(engine_->get(Table::kContentChunks, RowKey{1, 1}).has_value());
+
+    engine_->put(Table::kContentChunks, RowKey{1, 1}, chunk(0xaa));
+    auto row = engine_->get(Table::kContentChunks, RowKey{1, 1});
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(8u, row->blob(col::ContentChunks::kCiphertext).size());
+    EXPECT_EQ(0xaa, row->blob(col::ContentChunks::kCiphertext)[0]);
+    EXPECT_EQ(1, row->integer(col::ContentChunks::kAlg));
+
+    // Upsert replaces every column
+    engine_->put(Table::kContentChunks, RowKey{1, 1}, chunk(0xbb, 3));
+    row = engine_->get(Table::kContentChunks, RowKey{1, 1});
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(3u, row->blob(col::ContentChunks::kCiphertext).size());
+    EXPECT_EQ(0xbb, row->blob(col::ContentChunks::kNonce)[0]);
+
+    // Empty blobs stay blobs, not nulls
+    Row empty = chunk(0);
+    empty.set(col::ContentChunks::kCiphertext, std::vector<uint8_t>());
+    engine_->put(Table::kContentChunks, RowKey{1, 2}, empty);
+    row = engine_->get(Table::kContentChunks, RowKey{1, 2});
+    ASSERT_TRUE(row.has_value());
+    EXPECT_FALSE(row->is_null(col::ContentChunks::kCiphertext));
+    EXPECT_TRUE(row->blob(col::ContentChunks::kCiphertext).empty());
+
+    EXPECT_TRUE(engine_->erase(Table::kContentChunks, RowKey{1, 1}));
+    EXPECT_FALSE(engine_->erase(Table::kContentChunks, RowKey{1, 1}));
+    EXPECT_FALSE(engine_->get(Table::kContentChunks, RowKey{1, 1}).has_value());
+    EXPECT_EQ(1u, engine_->usage(Table::kContentChunks, col::ContentChunks::kCiphertext).rows);
+}
+
+// ===================================================================
+// Test 2: Scans walk key order in either direction over an inclusive range
+// ===================================================================
+TEST_P(StorageEngineTest, RangeScansInKeyOrder) {
+    for (int64_t note : {2, 1, 3}) {
+        for (int64_t id : {5, -1, 2}) {
+            engine_->put(Table::kContentChunks, RowKey{note, id}, chunk(static_cast<uint8_t>(id)));
+        }
+    }
+
+    auto found = keys(Table::kContentChunks, KeyRange::prefix(2));
+    ASSERT_EQ(3u, found.size());
+    EXPECT_EQ((RowKey{2, -1}), found[0]);
+    EXPECT_EQ((RowKey{2, 5}), found[2]);
+
+    found = keys(Table::kContentChunks, KeyRange{{1, 2}, {3, -1}}, ScanOrder::kDescending);
+    ASSERT_EQ(6u, found.size());
+    EXPECT_EQ((RowKey{3, -1}), found.front());
+    EXPECT_EQ((RowKey{1, 2}), found.back());
+
+    EXPECT_TRUE(keys(Table::kContentChunks, KeyRange{{3, 0}, {1, 0}}).empty());
+
+    // Projected columns only; the visitor stops the scan
+    size_t visited = 0;
+    engine_->scan(Table::kContentChunks, KeyRange::all(), [&](const RowKey&, const Row& row) {
+        EXPECT_TRUE(row.is_null(col::ContentChunks::kNonce));
+        EXPECT_EQ(1, row.integer(col::ContentChunks::kAlg));
+        return ++visited < 4;
+    }, {col::ContentChunks::kAlg});
+    EXPECT_EQ(4u, visited);
+
+    EXPECT_EQ(3u, engine_->erase_range(Table::kContentChunks, KeyRange::prefix(1)));
+    EXPECT_EQ(6u, keys(Table::kContentChunks, KeyRange::all()).size());
+}
+
+// ===================================================================
+// Test 3: Rolling back restores every row written in the transaction
+// ===================================================================
+TEST_P(StorageEngineTest, RollbackUndoesWrites) {
+    engine_->put(Table::kContentChunks, RowKey{1, 1}, chunk(1));
+    engine_->put(Table::kContentChunks, RowKey{1, 2}, chunk(2));
+
+    engine_->begin();
+    engine_->put(Table::kContentChunks, RowKey{1, 1}, chunk(9));
+    engine_->erase(Table::kContentChunks, RowKey{1, 2});
+    engine_->put(Table::kContentChunks, RowKey{1, 3}, chunk(3));
+    engine_->rollback();
+
+    auto row = engine_->get(Table::kContentChunks, RowKey{1, 1});
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(1, row->blob(col::ContentChunks::kCiphertext)[0]);
+    EXPECT_TRUE(engine_->get(Table::kContentChunks, RowKey{1, 2}).has_value());
+    EXPECT_FALSE(engine_->get(Table::kContentChunks, RowKey{1, 3}).has_value());
+
+    engine_->begin();
+    engine_->erase_range(Table::kContentChunks, KeyRange::all());
+    engine_->commit();
+    EXPECT_TRUE(keys(Table::kContentChunks, KeyRange::all()).empty());
+}
+
+// ===================================================================
+// Test 4: Assigned IDs are never reused, even after the newest is deleted
+// ===================================================================
+TEST_P(StorageEngineTest, InsertAssignsFreshIds) {
+    Row pack(Table::kNotePacks);
+    pack.set(col::NotePacks::kNonce, std::vector<uint8_t>(24, 0));
+    pack.set(col::NotePacks::kCiphertext, std::vector<uint8_t>(1, 0));
+    pack.set(col::NotePacks::kAlg, int64_t{0});
+    pack.set(col::NotePacks::kCodec, int64_t{0});
+    pack.set(col::NotePacks::kNoteCount, int64_t{2});
+    pack.set(col::NotePacks::kCreatedAt, int64_t{0});
+
+    int64_t first = engine_->insert(Table::kNotePacks, pack);
+    int64_t second = engine_->insert(Table::kNotePacks, pack);
+    EXPECT_GT(second, first);
+    ASSERT_TRUE(engine_->erase(Table::kNotePacks, RowKey{second}));
+    EXPECT_GT(engine_->insert(Table::kNotePacks, pack), second);
+
+    EXPECT_EQ(2u, engine_->count_matching(Table::kNotePacks, col::NotePacks::kNoteCount, 2));
+    EXPECT_THROW(engine_->insert(Table::kContentChunks, chunk(0)), std::invalid_argument);
+
+    engine_->close();
+    EXPECT_FALSE(engine_->is_open());
+    EXPECT_THROW(engine_->get(Table::kNotePacks, RowKey{first}), std::runtime_error);
+}
+
+// ===================================================================
+// Test 5: Indexed queries order by a column and select by the second key
+// ===================================================================
+TEST_P(StorageEngineTest, ColumnOrderAndSubkeyQueries) {
+    auto with_alg = [&](const RowKey& key, int64_t alg) {
+        Row row = chunk(static_cast<uint8_t>(key.b));
+        row.set(col::ContentChunks::kAlg, alg);
+        engine_->put(Table::kContentChunks, key, row);
+    };
+    with_alg(RowKey{2, 7}, 5);
+    with_alg(RowKey{1, 7}, 3);
+    with_alg(RowKey{3, 4}, 5);
+    with_alg(RowKey{1, 4}, 9);
+
+    auto by_alg = [&](ScanOrder order) {
+        std::vector<RowKey> found;
+        engine_->scan_by(Table::kContentChunks, col::ContentChunks::kAlg,
+            [&](const RowKey& key, const Row& row) {
+                EXPECT_TRUE(row.is_null(col::ContentChunks::kCiphertext));
+                found.push_back(key);
+                return true;
+            }, {col::ContentChunks::kAlg}, order);
+        return found;
+    };
+    // Ties stay in ascending key order in both directions
+    EXPECT_EQ((std::vector<RowKey>{{1, 7}, {2, 7}, {3, 4}, {1, 4}}), by_alg(ScanOrder::kAscending));
+    EXPECT_EQ((std::vector<RowKey>{{1, 4}, {2, 7}, {3, 4}, {1, 7}}), by_alg(ScanOrder::kDescending));
+
+    size_t visited = 0;
+    engine_->scan_by(Table::kContentChunks, col::ContentChunks::kAlg,
+        [&](const RowKey&, const Row& row) {
+            EXPECT_FALSE(row.is_null(col::ContentChunks::kNonce));
+            return ++visited < 2;
+        });
+    EXPECT_EQ(2u, visited);
+
+    std::vector<RowKey> found;
+    engine_->scan_subkey(Table::kContentChunks, 7, [&](const RowKey& key, const Row&) {
+        found.push_back(key);
+        return true;
+    }, Projection::none());
+    EXPECT_EQ((std::vector<RowKey>{{1, 7}, {2, 7}}), found);
+
+    EXPECT_THROW(engine_->scan_subkey(Table::kNotePacks, 1,
+                                      [](const RowKey&, const Row&) { return true; }),
+                 std::invalid_argument);
+}
+
+INSTANTIATE_TEST_SUITE_P(Engines, StorageEngineTest,
+                         ::testing::Values(Backend::kSqlite, Backend::kMemory, Backend::kLog),
+                         backend_name);
@@ -0,0 +1,80 @@
+#ifndef BASTIONX_TESTS_STORAGE_STORAGE_BACKENDS_H
+#define BASTIONX_TESTS_STORAGE_STORAGE_BACKENDS_H
+
+#include "bastionx/crypto/SecureMemory.h"
+#include "bastionx/storage/LogEngine.h"
+#include "bastionx/storage/MemoryEngine.h"
+#include "bastionx/storage/NotesRepository.h"
+#include "bastionx/storage/SqliteEngine.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+/**
+ * @file storage_backends.h
+ * @brief Runs repository tests against every StorageEngine
+ *
+ * Suites parameterized on Backend open their repository through a
+ * BackendFixture, so the same test body checks the SQLite vault, the
+ * in-memory engine and the log-structured engine. The memory backend keeps
+ * one Store per fixture and the log backend a directory next to the vault,
+ * so a reopened repository sees what the previous one wrote.
+ */
+
+namespace storage_backends {
+
+enum class Backend {
+    kSqlite,
+    kMemory,
+    kLog,
+};
+
+inline std::string backend_name(const ::testing::TestParamInfo<Backend>& info) {
+    switch (info.param) {
+        case Backend::kSqlite: return "Sqlite";
+        case Backend::kMemory: return "Memory";
+        case Backend::kLog: return "Log";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Opens engines for one test on the chosen backend
+ */
+class BackendFixture {
+public:
+    explicit BackendFixture(Backend backend) : backend_(backend) {}
+
+    Backend backend() const { return backend_; }
+
+    /// Engine over the vault at `path` (SQLite), the fixture's store
+    /// (memory) or the log directory `path`.log
+    std::unique_ptr<bastionx::storage::StorageEngine> open_engine(
+        const std::string& path, const bastionx::crypto::SecureKey& db_key)
+    {
+        switch (backend_) {
+            case Backend::kSqlite:
+                return std::make_unique<bastionx::storage::SqliteEngine>(path, &db_key);
+            case Backend::kMemory:
+                return std::make_unique<bastionx::storage::MemoryEngine>(store_);
+            case Backend::kLog:
+                return std::make_unique<bastionx::storage::LogEngine>(path + ".log", db_key);
+        }
+        return nullptr;
+    }
+
+    std::unique_ptr<bastionx::storage::NotesRepository> open_repository(
+        const std::string& path, const bastionx::crypto::SecureKey& db_key)
+    {
+        return std::make_unique<bastionx::storage::NotesRepository>(open_engine(path, db_key));
+    }
+
+private:
+    Backend backend_;
+    std::shared_ptr<bastionx::storage::MemoryEngine::Store> store_ =
+        std::make_shared<bastionx::storage::MemoryEngine::Store>();
+};
+
+}  // namespace storage_backends
+
+#endif  // BASTIONX_TESTS_STORAGE_STORAGE_BACKENDS_H
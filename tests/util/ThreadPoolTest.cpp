@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "bastionx/util/ThreadPool.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace bastionx::util;
+
+// ===================================================================
+// Test 1: Every task runs exactly once
+// ===================================================================
+TEST(ThreadPoolTest, RunsEveryTaskOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(1000);
+
+    pool.parallel_for(hits.size(), [&](size_t i) { hits[i]++; });
+
+    for (const auto& h : hits) {
+        EXPECT_EQ(1, h.load());
+    }
+}
+
+// ===================================================================
+// Test 2: Zero and single task batches
+// ===================================================================
+TEST(ThreadPoolTest, EmptyAndSingleTask) {
+    ThreadPool pool(2);
+    int calls = 0;
+
+    pool.parallel_for(0, [&](size_t) { calls++; });
+    EXPECT_EQ(0, calls);
+
+    pool.parallel_for(1, [&](size_t) { calls++; });
+    EXPECT_EQ(1, calls);
+}
+
+// ===================================================================
+// Test 3: First exception is rethrown to the caller
+// ===================================================================
+TEST(ThreadPoolTest, ExceptionPropagates) {
+    ThreadPool pool(3);
+
+    EXPECT_THROW(
+        pool.parallel_for(64, [](size_t i) {
+            if (i == 17) throw std::runtime_error("task failed");
+        }),
+        std::runtime_error);
+
+    // Pool remains usable afterwards
+    std::atomic<int> count{0};
+    pool.parallel_for(10, [&](size_t) { count++; });
+    EXPECT_EQ(10, count.load());
+}
+
+// ===================================================================
+// Test 4: Nested parallel_for does not deadlock a saturated pool
+// ===================================================================
+TEST(ThreadPoolTest, NestedParallelForCompletes) {
+    ThreadPool pool(1);
+    std::atomic<int> count{0};
+
+    pool.parallel_for(4, [&](size_t) {
+        pool.parallel_for(4, [&](size_t) { count++; });
+    });
+
+    EXPECT_EQ(16, count.load());
+}
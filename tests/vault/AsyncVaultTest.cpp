@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "bastionx/vault/AsyncVault.h"
+#include "bastionx/vault/VaultService.h"
+#include <sodium.h>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bastionx;
+using namespace bastionx::vault;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Test fixture for AsyncVault and the coroutine types
+ *
+ * Creates a locked vault. The dispatcher collects resumptions and pump()
+ * runs them on the test thread, the way the Qt event loop would.
+ */
+class AsyncVaultTest : public ::testing::Test {
+protected:
+    std::string temp_dir_;
+    std::string vault_path_;
+    std::unique_ptr<VaultService> vault_;
+
+    std::mutex delivered_mutex_;
+    std::vector<std::function<void()>> delivered_;
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_async_vault_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        vault_path_ = (fs::path(temp_dir_) / "vault.db").string();
+
+        vault_ = std::make_unique<VaultService>(vault_path_);
+        ASSERT_TRUE(vault_->create("test_password"));
+        vault_->save_settings("{\"auto_lock_minutes\":7}");
+        vault_->lock();
+    }
+
+    void TearDown() override {
+        vault_.reset();
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    util::Dispatcher dispatcher() {
+        return [this](std::function<void()> callback) {
+            std::lock_guard lock(delivered_mutex_);
+            delivered_.push_back(std::move(callback));
+        };
+    }
+
+    // Run resumptions on this thread until `done` holds (or 10 s pass)
+    bool pump(const std::function<bool()>& done) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!done() && std::chrono::steady_clock::now() < deadline) {
+            std::vector<std::function<void()>> callbacks;
+            {
+                std::lock_guard lock(delivered_mutex_);
+                callbacks.swap(delivered_);
+            }
+            for (auto& callback : callbacks) {
+                callback();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return done();
+    }
+};
+
+// Sets a flag when the coroutine frame holding it is destroyed
+struct FrameGuard {
+    bool& destroyed;
+    ~FrameGuard() { destroyed = true; }
+};
+
+// ===================================================================
+// Test 1: Unlock and settings run on a worker, resume on the owner
+// ===================================================================
+TEST_F(AsyncVaultTest, UnlockFlowResumesOnOwner) {
+    AsyncVault async(*vault_, dispatcher());
+    auto owner = std::this_thread::get_id();
+
+    bool wrong = true;
+    bool ok = false;
+    std::string settings;
+    bool finished = false;
+
+    auto flow = [&]() -> util::Task {
+        wrong = co_await async.unlock("not_the_password");
+        EXPECT_EQ(owner, std::this_thread::get_id());
+        ok = co_await async.unlock("test_password");
+        settings = co_await async.load_settings();
+        EXPECT_EQ(owner, std::this_thread::get_id());
+        finished = true;
+    };
+    flow();
+
+    EXPECT_FALSE(finished);  // Suspended until the owner's loop resumes it
+    ASSERT_TRUE(pump([&] { return finished; }));
+    EXPECT_FALSE(wrong);
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(vault_->is_unlocked());
+    EXPECT_EQ("{\"auto_lock_minutes\":7}", settings);
+}
+
+// ===================================================================
+// Test 2: Locking the vault cancels the session's coroutines
+// ===================================================================
+TEST_F(AsyncVaultTest, LockCancelsSession) {
+    ASSERT_TRUE(vault_->unlock("test_password"));
+    auto token = vault_->session_token();
+    EXPECT_FALSE(token.cancelled());
+
+    // A session coroutine waiting on a worker while the vault locks
+    std::promise<void> gate;
+    auto gate_future = gate.get_future().share();
+    bool destroyed = false;
+    bool carried_on = false;
+    auto flow = [&]() -> util::Task {
+        FrameGuard guard{destroyed};
+        co_await util::run_async([gate_future] { gate_future.wait(); }, dispatcher(), token);
+        carried_on = true;
+    };
+    flow();
+
+    vault_->lock();
+    EXPECT_TRUE(token.cancelled());
+    gate.set_value();
+
+    ASSERT_TRUE(pump([&] { return destroyed; }));  // Unwound through Cancelled
+    EXPECT_FALSE(carried_on);
+
+    // Awaiting on a cancelled token does not start the work at all
+    bool ran = false;
+    destroyed = false;
+    auto late = [&]() -> util::Task {
+        FrameGuard guard{destroyed};
+        co_await util::run_async([&] { ran = true; }, dispatcher(), token);
+        carried_on = true;
+    };
+    late();
+    EXPECT_TRUE(destroyed);
+    EXPECT_FALSE(ran);
+    EXPECT_FALSE(carried_on);
+
+    // The next session gets a fresh token
+    ASSERT_TRUE(vault_->unlock("test_password"));
+    EXPECT_FALSE(vault_->session_token().cancelled());
+}
+
+// ===================================================================
+// Test 3: Errors surface at co_await
+// ===================================================================
+TEST_F(AsyncVaultTest, ErrorsRethrownAtAwait) {
+    AsyncVault async(*vault_, dispatcher());
+
+    std::string error;
+    bool finished = false;
+    auto flow = [&]() -> util::Task {
+        try {
+            co_await async.load_settings();  // Still locked
+        } catch (const util::Cancelled&) {
+            error = "cancelled";
+        } catch (const std::runtime_error& e) {
+            error = e.what();
+        }
+        finished = true;
+    };
+    flow();
+
+    ASSERT_TRUE(pump([&] { return finished; }));
+    EXPECT_EQ("Vault is locked", error);
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include "bastionx/vault/MaintenanceScheduler.h"
+#include "bastionx/vault/VaultService.h"
+#include "bastionx/storage/NotesRepository.h"
+#include <sodium.h>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace bastionx::vault;
+using namespace bastionx::storage;
+namespace fs = std::filesystem;
+using std::chrono::hours;
+using std::chrono::milliseconds;
+
+/**
+ * @brief Test fixture for MaintenanceScheduler tests
+ *
+ * Creates a vault with a few notes in a unique temp directory.
+ */
+class MaintenanceSchedulerTest : public ::testing::Test {
+protected:
+    std::string temp_dir_;
+    std::string vault_path_;
+    std::unique_ptr<VaultService> vault_;
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_maintenance_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        vault_path_ = (fs::path(temp_dir_) / "vault.db").string();
+
+        vault_ = std::make_unique<VaultService>(vault_path_);
+        ASSERT_TRUE(vault_->create("test_password"));
+    }
+
+    void TearDown() override {
+        vault_.reset();
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    std::vector<int64_t> add_notes(int count) {
+        NotesRepository repo(vault_path_, &vault_->db_subkey());
+        std::vector<int64_t> ids;
+        for (int i = 0; i < count; ++i) {
+            Note note;
+            note.title = "Note " + std::to_string(i);
+            note.body = std::string(4000, static_cast<char>('a' + i % 26));
+            ids.push_back(repo.create_note(note, vault_->notes_subkey()));
+        }
+        return ids;
+    }
+
+    int64_t pragma(const std::string& name) {
+        sqlite3* db = nullptr;
+        sqlite3_open(vault_path_.c_str(), &db);
+        const auto& key = vault_->db_subkey();
+        sqlite3_key(db, key.data(), static_cast<int>(key.size()));
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db, ("PRAGMA " + name + ";").c_str(), -1, &stmt, nullptr);
+        int64_t value = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int64(stmt, 0) : -1;
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        return value;
+    }
+
+    // Run slices of no budget (one step each) until nothing is due
+    int run_all(MaintenanceScheduler& scheduler) {
+        int slices = 1;
+        while (scheduler.run_slice(milliseconds(0))) {
+            ++slices;
+        }
+        return slices;
+    }
+};
+
+// ===================================================================
+// Test 1: Default tasks run step by step and leave the vault tidy
+// ===================================================================
+TEST_F(MaintenanceSchedulerTest, DefaultTasksRunInSlices) {
+    EXPECT_EQ(2, pragma("auto_vacuum"));  // New vaults: INCREMENTAL
+
+    auto ids = add_notes(100);
+    {
+        NotesRepository repo(vault_path_, &vault_->db_subkey());
+        for (size_t i = 0; i < 80; ++i) {
+            repo.delete_note(ids[i], vault_->notes_subkey());
+        }
+    }
+
+    MaintenanceScheduler scheduler(*vault_);
+    std::vector<std::string> expected{"optimize", "analyze", "incremental_vacuum", "quick_check"};
+    EXPECT_EQ(expected, scheduler.due());
+
+    // ANALYZE and quick_check take one step per table
+    EXPECT_GT(run_all(scheduler), 10);
+    EXPECT_TRUE(scheduler.due().empty());
+    EXPECT_FALSE(scheduler.run_slice());
+
+    ASSERT_EQ(4u, scheduler.log().size());
+    for (const auto& entry : scheduler.log()) {
+        EXPECT_TRUE(entry.ok) << entry.task << ": " << entry.error;
+        EXPECT_EQ(1u, entry.runs);
+        EXPECT_GT(entry.last_run.time_since_epoch().count(), 0);
+    }
+    EXPECT_EQ(0, pragma("freelist_count"));
+}
+
+// ===================================================================
+// Test 2: A task interrupted between slices resumes at its next step
+// ===================================================================
+TEST_F(MaintenanceSchedulerTest, TaskResumesAcrossSlices) {
+    std::vector<size_t> steps;
+    MaintenanceScheduler scheduler(*vault_, {
+        {"three_steps", hours(1), [&](sqlite3*, size_t step) {
+            steps.push_back(step);
+            return step == 2;
+        }},
+    });
+
+    EXPECT_TRUE(scheduler.run_slice(milliseconds(0)));
+    EXPECT_TRUE(scheduler.log().empty());  // Not finished, not logged
+
+    // The user typed; the next idle period picks up where it stopped
+    EXPECT_TRUE(scheduler.run_slice(milliseconds(0)));
+    EXPECT_FALSE(scheduler.run_slice(milliseconds(0)));
+    EXPECT_EQ((std::vector<size_t>{0, 1, 2}), steps);
+
+    ASSERT_EQ(1u, scheduler.log().size());
+    EXPECT_EQ("three_steps", scheduler.log()[0].task);
+    EXPECT_EQ(1u, scheduler.log()[0].runs);
+
+    EXPECT_THROW(MaintenanceScheduler(*vault_, {{"never", hours(0), nullptr}}),
+                 std::invalid_argument);
+}
+
+// ===================================================================
+// Test 3: A failing task is logged and does not stop the others
+// ===================================================================
+TEST_F(MaintenanceSchedulerTest, FailureIsLogged) {
+    bool ran_after = false;
+    MaintenanceScheduler scheduler(*vault_, {
+        {"broken", hours(1), [](sqlite3*, size_t) -> bool {
+            throw std::runtime_error("disk on fire");
+        }},
+        {"after", hours(1), [&](sqlite3*, size_t) {
+            ran_after = true;
+            return true;
+        }},
+    });
+
+    run_all(scheduler);
+    EXPECT_TRUE(ran_after);
+    ASSERT_EQ(2u, scheduler.log().size());
+    EXPECT_FALSE(scheduler.log()[0].ok);
+    EXPECT_EQ("disk on fire", scheduler.log()[0].error);
+    EXPECT_TRUE(scheduler.log()[1].ok);
+    EXPECT_TRUE(scheduler.due().empty());  // Retried at its next interval
+}
+
+// ===================================================================
+// Test 4: The log is kept in the vault across locks, not across re-keys
+// ===================================================================
+TEST_F(MaintenanceSchedulerTest, LogPersistsInVault) {
+    {
+        MaintenanceScheduler scheduler(*vault_);
+        run_all(scheduler);
+    }
+
+    vault_->lock();
+    EXPECT_THROW(vault_->load_maintenance_log(), std::runtime_error);
+    ASSERT_TRUE(vault_->unlock("test_password"));
+
+    {
+        MaintenanceScheduler scheduler(*vault_);
+        EXPECT_TRUE(scheduler.due().empty());
+        ASSERT_EQ(4u, scheduler.log().size());
+        EXPECT_EQ("optimize", scheduler.log()[0].task);
+    }
+
+    // The settings blob is untouched by the log and vice versa
+    vault_->save_settings("{}");
+    EXPECT_EQ("{}", vault_->load_settings());
+    EXPECT_NE(std::string::npos, vault_->load_maintenance_log().find("quick_check"));
+
+    ASSERT_TRUE(vault_->change_password("test_password", "new_password"));
+    MaintenanceScheduler scheduler(*vault_);
+    EXPECT_EQ(4u, scheduler.due().size());
+}
+
+// ===================================================================
+// Test 5: Background runs finish due work; destruction interrupts a step
+// ===================================================================
+TEST_F(MaintenanceSchedulerTest, BackgroundRunIsInterruptible) {
+    {
+        MaintenanceScheduler scheduler(*vault_);
+        scheduler.resume();
+        for (int i = 0; i < 1000 && scheduler.running(); ++i) {
+            std::this_thread::sleep_for(milliseconds(10));
+        }
+        EXPECT_FALSE(scheduler.running());
+        EXPECT_TRUE(scheduler.due().empty());
+        EXPECT_EQ(4u, scheduler.log().size());
+    }
+
+    std::atomic<bool> started{false};
+    auto endless = [&](sqlite3* db, size_t) -> bool {
+        started = true;
+        int rc = sqlite3_exec(db, "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c) "
+                                  "SELECT count(*) FROM c;", nullptr, nullptr, nullptr);
+        throw std::runtime_error("step ended: " + std::to_string(rc));
+    };
+    {
+        MaintenanceScheduler scheduler(*vault_, {{"endless", hours(1), endless}});
+        scheduler.resume();
+        while (!started) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    }  // Interrupted here rather than hanging
+
+    // Not logged as a failure: it is still due
+    MaintenanceScheduler scheduler(*vault_, {{"endless", hours(1), endless}});
+    EXPECT_EQ(std::vector<std::string>{"endless"}, scheduler.due());
+    for (const auto& entry : scheduler.log()) {
+        EXPECT_NE("endless", entry.task);
+    }
+}
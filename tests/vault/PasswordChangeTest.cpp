@@ -1,8 +1,12 @@
 #include <gtest/gtest.h>
 #include "bastionx/vault/VaultService.h"
 #include "bastionx/storage/NotesRepository.h"
+#include "bastionx/storage/AttachmentStore.h"
+#include "bastionx/crypto/SecretStream.h"
 #include <sodium.h>
+#include <cstring>
 #include <filesystem>
+#include <sstream>
 #include <string>
 
 using namespace bastionx::vault;
@@ -188,3 +192,248 @@ TEST_F(PasswordChangeTest, ThrowsWhenLocked) {
 
     EXPECT_THROW(vault.change_password("password", "new_pw"), std::runtime_error);
 }
+
+// ===================================================================
+// Test 8: Chunked (large) note bodies survive password change
+// ===================================================================
+TEST_F(PasswordChangeTest, ChunkedNoteSurvivesPasswordChange) {
+    VaultService vault(vault_path_);
+    vault.create("old_pw");
+
+    std::string body(NotesRepository::kChunkedBodyThresholdBytes + 12345, 'x');
+    body.replace(body.size() - 6, 6, "ENDING");
+
+    int64_t id = 0;
+    {
+        NotesRepository repo(vault_path_, &vault.db_subkey());
+        Note n;
+        n.title = "Big Note";
+        n.body = body;
+        id = repo.create_note(n, vault.notes_subkey());
+    }
+
+    ASSERT_TRUE(vault.change_password("old_pw", "new_pw"));
+    vault.lock();
+    ASSERT_TRUE(vault.unlock("new_pw"));
+
+    NotesRepository repo(vault_path_, &vault.db_subkey());
+    auto note = repo.read_note(id, vault.notes_subkey());
+    ASSERT_TRUE(note.has_value());
+    EXPECT_EQ("Big Note", note->title);
+    EXPECT_EQ(body.size(), note->body.size());
+    EXPECT_TRUE(note->body.view() == body);
+}
+
+// ===================================================================
+// Test 9: Compression dictionary survives password change
+// ===================================================================
+TEST_F(PasswordChangeTest, CompressionDictionarySurvivesPasswordChange) {
+    VaultService vault(vault_path_);
+    vault.create("old_pw");
+
+    {
+        NotesRepository repo(vault_path_, &vault.db_subkey());
+        for (size_t i = 0; i < NotesRepository::kDictionaryMinNotes * 2; ++i) {
+            Note n;
+            n.title = "Meeting notes " + std::to_string(i);
+            n.body = "## Agenda\n- status update for project " + std::to_string(i % 7) +
+                     "\n- action items and owners\n- next review date " + std::to_string(i);
+            n.tags = {"work", "meeting"};
+            repo.create_note(n, vault.notes_subkey());
+        }
+        ASSERT_TRUE(repo.ensure_compression_dictionary(vault.notes_subkey()));
+    }
+
+    ASSERT_TRUE(vault.change_password("old_pw", "new_pw"));
+    vault.lock();
+    ASSERT_TRUE(vault.unlock("new_pw"));
+
+    NotesRepository repo(vault_path_, &vault.db_subkey());
+    auto summaries = repo.list_notes(vault.notes_subkey());
+    EXPECT_EQ(NotesRepository::kDictionaryMinNotes * 2, summaries.size());
+    EXPECT_EQ(1u, repo.search_notes(vault.notes_subkey(), "review date 17").size());
+}
+
+// ===================================================================
+// Test 10: Cold-storage packs survive password change
+// ===================================================================
+TEST_F(PasswordChangeTest, PackedNotesSurvivePasswordChange) {
+    VaultService vault(vault_path_);
+    vault.create("old_pw");
+
+    {
+        NotesRepository repo(vault_path_, &vault.db_subkey());
+        for (size_t i = 0; i < NotesRepository::kPackMinNotes; ++i) {
+            Note n;
+            n.title = "Archived " + std::to_string(i);
+            n.body = "old body " + std::to_string(i);
+            repo.create_note(n, vault.notes_subkey());
+        }
+        // Every note counts as cold with a negative age threshold
+        ASSERT_EQ(NotesRepository::kPackMinNotes,
+                  repo.pack_cold_notes(vault.notes_subkey(), std::chrono::seconds(-60)));
+    }
+
+    ASSERT_TRUE(vault.change_password("old_pw", "new_pw"));
+    vault.lock();
+    ASSERT_TRUE(vault.unlock("new_pw"));
+
+    NotesRepository repo(vault_path_, &vault.db_subkey());
+    EXPECT_EQ(1u, repo.storage_stats().pack_count);
+    auto summaries = repo.list_notes(vault.notes_subkey());
+    EXPECT_EQ(NotesRepository::kPackMinNotes, summaries.size());
+    EXPECT_EQ(1u, repo.search_notes(vault.notes_subkey(), "old body 3").size());
+}
+
+// ===================================================================
+// Test 11: Attachments survive password change and still deduplicate
+// ===================================================================
+TEST_F(PasswordChangeTest, AttachmentsSurvivePasswordChange) {
+    VaultService vault(vault_path_);
+    vault.create("old_pw");
+
+    std::string contents(AttachmentStore::kChunkBytes + 500, 'a');
+    contents.replace(contents.size() - 3, 3, "END");
+
+    int64_t note_id = 0;
+    int64_t attachment_id = 0;
+    {
+        NotesRepository repo(vault_path_, &vault.db_subkey());
+        Note n;
+        n.title = "Has a file";
+        note_id = repo.create_note(n, vault.notes_subkey());
+
+        AttachmentStore store(vault_path_, &vault.db_subkey());
+        std::istringstream in(contents);
+        auto id = store.attach(note_id, "file.txt", "text/plain", in, vault.notes_subkey());
+        ASSERT_TRUE(id.has_value());
+        attachment_id = *id;
+    }
+
+    ASSERT_TRUE(vault.change_password("old_pw", "new_pw"));
+    vault.lock();
+    ASSERT_TRUE(vault.unlock("new_pw"));
+
+    AttachmentStore store(vault_path_, &vault.db_subkey());
+    auto listed = store.list(note_id, vault.notes_subkey());
+    ASSERT_EQ(1u, listed.size());
+    EXPECT_EQ("file.txt", listed[0].name);
+
+    std::string read;
+    ASSERT_TRUE(store.read(attachment_id, vault.notes_subkey(), [&](std::span<const uint8_t> piece) {
+        read.append(reinterpret_cast<const char*>(piece.data()), piece.size());
+    }));
+    EXPECT_TRUE(read == contents);
+
+    // The content ID key was re-wrapped, so identical contents still match
+    std::istringstream again(contents);
+    EXPECT_EQ(attachment_id,
+              store.attach(note_id, "again.txt", "text/plain", again, vault.notes_subkey()));
+    EXPECT_EQ(1u, store.attachment_count());
+}
+
+// ===================================================================
+// Test 12: Note revisions survive password change
+// ===================================================================
+TEST_F(PasswordChangeTest, RevisionsSurvivePasswordChange) {
+    VaultService vault(vault_path_);
+    vault.create("old_pw");
+
+    int64_t id = 0;
+    {
+        NotesRepository repo(vault_path_, &vault.db_subkey());
+        Note n;
+        n.title = "Evolving";
+        n.body = "first draft";
+        id = repo.create_note(n, vault.notes_subkey());
+        n.id = id;
+        n.body = "second draft";
+        ASSERT_TRUE(repo.update_note(n, vault.notes_subkey()));
+    }
+
+    ASSERT_TRUE(vault.change_password("old_pw", "new_pw"));
+    vault.lock();
+    ASSERT_TRUE(vault.unlock("new_pw"));
+
+    NotesRepository repo(vault_path_, &vault.db_subkey());
+    ASSERT_EQ(1u, repo.list_revisions(id).size());
+    auto first = repo.read_revision(id, 1, vault.notes_subkey());
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ("first draft", first->body);
+}
+
+// ===================================================================
+// Test 13: Bodies stored as a legacy secretstream survive password change
+// ===================================================================
+TEST_F(PasswordChangeTest, LegacyStreamedBodySurvivesPasswordChange) {
+    VaultService vault(vault_path_);
+    vault.create("old_pw");
+
+    std::string body(150 * 1024, 's');
+    body.replace(body.size() - 6, 6, "ENDING");
+    const size_t stream_chunk = 64 * 1024;
+    const size_t stream_chunks = (body.size() + stream_chunk - 1) / stream_chunk;
+
+    int64_t id = 0;
+    {
+        NotesRepository repo(vault_path_, &vault.db_subkey());
+        Note n;
+        n.title = "Placeholder";
+        n.body = "Body";
+        id = repo.create_note(n, vault.notes_subkey());
+
+        // Record and body stream as the chunked-secretstream format wrote
+        // them: the stream is keyed with the notes subkey itself
+        const std::string legacy_json =
+            R"({"body":"","body_bytes":)" + std::to_string(body.size()) +
+            R"(,"body_chunks":)" + std::to_string(stream_chunks) +
+            R"(,"tags":[],"title":"Streamed","version":1})";
+        std::vector<uint8_t> aad(4);
+        uint32_t id32 = static_cast<uint32_t>(id);
+        std::memcpy(aad.data(), &id32, 4);
+        auto record = CryptoService::encrypt(
+            std::vector<uint8_t>(legacy_json.begin(), legacy_json.end()),
+            vault.notes_subkey(), aad);
+        std::vector<uint8_t> chunk_aad = aad;
+        chunk_aad.insert(chunk_aad.end(), record.nonce.begin(), record.nonce.end());
+
+        auto& engine = repo.engine();
+        auto row = engine.get(Table::kNotes, RowKey{id});
+        ASSERT_TRUE(row.has_value());
+        row->set(col::Notes::kNonce, record.nonce);
+        row->set(col::Notes::kCiphertext, record.ciphertext);
+        row->set(col::Notes::kAlg, int64_t{0});
+        row->set(col::Notes::kCodec, int64_t{0});
+        engine.put(Table::kNotes, RowKey{id}, *row);
+
+        SecretStreamWriter writer(vault.notes_subkey());
+        auto insert = [&](int64_t seq, std::span<const uint8_t> data) {
+            Row chunk(Table::kNoteChunks);
+            chunk.set(col::NoteChunks::kData, data);
+            engine.put(Table::kNoteChunks, RowKey{id, seq}, chunk);
+        };
+        insert(0, writer.header());
+        std::vector<uint8_t> ciphertext;
+        for (size_t i = 0; i < stream_chunks; ++i) {
+            std::string_view piece = std::string_view(body).substr(i * stream_chunk, stream_chunk);
+            writer.push(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(piece.data()),
+                                                 piece.size()),
+                        chunk_aad, i + 1 == stream_chunks, ciphertext);
+            insert(static_cast<int64_t>(i + 1), ciphertext);
+        }
+
+        auto before = repo.read_note(id, vault.notes_subkey());
+        ASSERT_TRUE(before.has_value());
+        EXPECT_TRUE(before->body.view() == body);
+    }
+
+    ASSERT_TRUE(vault.change_password("old_pw", "new_pw"));
+    vault.lock();
+    ASSERT_TRUE(vault.unlock("new_pw"));
+
+    NotesRepository repo(vault_path_, &vault.db_subkey());
+    auto note = repo.read_note(id, vault.notes_subkey());
+    ASSERT_TRUE(note.has_value());
+    EXPECT_EQ("Streamed", note->title);
+    EXPECT_TRUE(note->body.view() == body);
+}
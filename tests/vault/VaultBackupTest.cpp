@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include "bastionx/vault/VaultBackup.h"
+#include "bastionx/vault/VaultService.h"
+#include "bastionx/storage/NotesRepository.h"
+#include <sodium.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using namespace bastionx::vault;
+using namespace bastionx::storage;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Test fixture for VaultBackup tests
+ *
+ * Creates a vault with a few notes in a unique temp directory; snapshots
+ * go to its default "backups" directory.
+ */
+class VaultBackupTest : public ::testing::Test {
+protected:
+    std::string temp_dir_;
+    std::string vault_path_;
+    std::string backup_dir_;
+    std::unique_ptr<VaultService> vault_;
+    std::unique_ptr<NotesRepository> repo_;
+
+    void SetUp() override {
+        unsigned char buf[8];
+        randombytes_buf(buf, sizeof(buf));
+        std::string suffix;
+        for (auto b : buf) {
+            char hex[3];
+            snprintf(hex, sizeof(hex), "%02x", b);
+            suffix += hex;
+        }
+
+        temp_dir_ = (fs::temp_directory_path() / ("bastionx_backup_test_" + suffix)).string();
+        fs::create_directories(temp_dir_);
+        vault_path_ = (fs::path(temp_dir_) / "vault.db").string();
+        backup_dir_ = VaultBackup::default_backup_dir(vault_path_);
+
+        vault_ = std::make_unique<VaultService>(vault_path_);
+        ASSERT_TRUE(vault_->create("test_password"));
+        repo_ = std::make_unique<NotesRepository>(vault_path_, &vault_->db_subkey());
+        for (int i = 0; i < 20; ++i) {
+            add_note(i);
+        }
+    }
+
+    void TearDown() override {
+        repo_.reset();
+        vault_.reset();
+        std::error_code ec;
+        fs::remove_all(temp_dir_, ec);
+    }
+
+    void add_note(int i) {
+        Note note;
+        note.title = "Note " + std::to_string(i);
+        note.body = std::string(2000, static_cast<char>('a' + i % 26));
+        repo_->create_note(note, vault_->notes_subkey());
+    }
+
+    // Run a backup to the end, one page per step
+    static void run(VaultBackup& backup, const bastionx::crypto::SecureKey& key) {
+        backup.start(key);
+        while (backup.step(1) != VaultBackup::StepResult::kDone) {
+        }
+    }
+
+    // Notes in a snapshot, opened the way a restored vault would be
+    static size_t notes_in(const std::string& snapshot) {
+        VaultService restored(snapshot);
+        if (!restored.unlock("test_password")) {
+            return 0;
+        }
+        NotesRepository repo(snapshot, &restored.db_subkey());
+        return repo.list_notes(restored.notes_subkey()).size();
+    }
+};
+
+// ===================================================================
+// Test 1: A snapshot opens with the vault password
+// ===================================================================
+TEST_F(VaultBackupTest, SnapshotOpensWithPassword) {
+    VaultBackup backup(vault_path_, backup_dir_, 3);
+    EXPECT_TRUE(backup.snapshots().empty());
+
+    backup.start(vault_->db_subkey());
+    EXPECT_TRUE(backup.in_progress());
+    ASSERT_EQ(VaultBackup::StepResult::kMore, backup.step(1));
+    EXPECT_GT(backup.progress(), 0.0);
+    EXPECT_LT(backup.progress(), 1.0);
+    while (backup.step(1) != VaultBackup::StepResult::kDone) {
+    }
+    EXPECT_FALSE(backup.in_progress());
+
+    auto snapshots = backup.snapshots();
+    ASSERT_EQ(1u, snapshots.size());
+    EXPECT_TRUE(fs::exists(VaultService::salt_path(snapshots[0].path)));
+    EXPECT_EQ(20u, notes_in(snapshots[0].path));
+}
+
+// ===================================================================
+// Test 2: Saves during a backup do not reach the snapshot
+// ===================================================================
+TEST_F(VaultBackupTest, SnapshotIsConsistentDuringWrites) {
+    VaultBackup backup(vault_path_, backup_dir_, 3);
+    backup.start(vault_->db_subkey());
+    ASSERT_EQ(VaultBackup::StepResult::kMore, backup.step(1));
+
+    // Foreground saves keep working between steps
+    for (int i = 20; i < 30; ++i) {
+        add_note(i);
+        ASSERT_NE(VaultBackup::StepResult::kBusy, backup.step(1));
+    }
+    while (backup.step(1) != VaultBackup::StepResult::kDone) {
+    }
+
+    EXPECT_EQ(30u, repo_->list_notes(vault_->notes_subkey()).size());
+    EXPECT_EQ(20u, notes_in(backup.snapshots().back().path));
+}
+
+// ===================================================================
+// Test 3: Only the newest snapshots are kept
+// ===================================================================
+TEST_F(VaultBackupTest, PrunesOldSnapshots) {
+    VaultBackup backup(vault_path_, backup_dir_, 2);
+    run(backup, vault_->db_subkey());
+    auto first = backup.snapshots();
+    add_note(20);
+    run(backup, vault_->db_subkey());
+    add_note(21);
+    run(backup, vault_->db_subkey());
+
+    auto snapshots = backup.snapshots();
+    ASSERT_EQ(2u, snapshots.size());
+    EXPECT_LT(snapshots[0].created, snapshots[1].created);
+    EXPECT_FALSE(fs::exists(first[0].path));
+    EXPECT_FALSE(fs::exists(VaultService::salt_path(first[0].path)));
+    EXPECT_EQ(22u, notes_in(snapshots[1].path));
+
+    EXPECT_THROW(VaultBackup(vault_path_, backup_dir_, 0), std::invalid_argument);
+}
+
+// ===================================================================
+// Test 4: Cancelling leaves no partial snapshot
+// ===================================================================
+TEST_F(VaultBackupTest, CancelRemovesPartialFile) {
+    {
+        VaultBackup backup(vault_path_, backup_dir_, 3);
+        backup.start(vault_->db_subkey());
+        backup.step(1);
+        EXPECT_THROW(backup.start(vault_->db_subkey()), std::runtime_error);
+        backup.cancel();
+        EXPECT_FALSE(backup.in_progress());
+        EXPECT_THROW(backup.step(), std::runtime_error);
+
+        backup.start(vault_->db_subkey());
+        backup.step(1);
+        // Destroyed mid-backup
+    }
+
+    size_t files = 0;
+    for (const auto& entry : fs::directory_iterator(backup_dir_)) {
+        (void)entry;
+        ++files;
+    }
+    EXPECT_EQ(0u, files);
+}
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 #include "bastionx/vault/VaultService.h"
 #include <sodium.h>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <string>
+#include <vector>
 
 using namespace bastionx::vault;
 using namespace bastionx::crypto;
@@ -325,3 +328,180 @@ TEST_F(VaultServiceTest, SettingsOverwrittenOnResave) {
     std::string loaded = vault.load_settings();
     EXPECT_EQ(R"({"auto_lock_minutes":20})", loaded);
 }
+
+// ===================================================================
+// Test 19: Quick relock round-trip restores the same subkeys
+// ===================================================================
+TEST_F(VaultServiceTest, QuickUnlockRestoresKeys) {
+    VaultService vault(vault_path_);
+    vault.create("password");
+
+    std::vector<uint8_t> notes_key(vault.notes_subkey().data(),
+                                   vault.notes_subkey().data() + vault.notes_subkey().size());
+
+    vault.arm_quick_unlock("1234", std::chrono::minutes(10));
+    vault.quick_lock();
+
+    EXPECT_EQ(VaultState::kLocked, vault.state());
+    EXPECT_THROW(vault.notes_subkey(), std::runtime_error);
+    EXPECT_TRUE(vault.quick_unlock_available());
+
+    EXPECT_TRUE(vault.quick_unlock("1234"));
+    EXPECT_TRUE(vault.is_unlocked());
+    EXPECT_EQ(0, std::memcmp(notes_key.data(), vault.notes_subkey().data(), notes_key.size()));
+
+    // Still armed for the next auto-lock
+    vault.quick_lock();
+    EXPECT_TRUE(vault.quick_unlock("1234"));
+    EXPECT_NO_THROW(vault.load_settings());
+}
+
+// ===================================================================
+// Test 20: Wrong PINs exhaust the attempts and destroy the wrapped key
+// ===================================================================
+TEST_F(VaultServiceTest, QuickUnlockAttemptLimit) {
+    VaultService vault(vault_path_);
+    vault.create("password");
+    vault.arm_quick_unlock("1234", std::chrono::minutes(10), 3);
+    vault.quick_lock();
+
+    EXPECT_FALSE(vault.quick_unlock("0000"));
+    EXPECT_FALSE(vault.quick_unlock("1111"));
+    EXPECT_TRUE(vault.quick_unlock_available());
+    EXPECT_FALSE(vault.quick_unlock("2222"));
+
+    EXPECT_FALSE(vault.quick_unlock_available());
+    EXPECT_FALSE(vault.quick_unlock("1234"));
+    EXPECT_EQ(VaultState::kLocked, vault.state());
+
+    // Master password still works
+    EXPECT_TRUE(vault.unlock("password"));
+}
+
+// ===================================================================
+// Test 21: A successful PIN resets the wrong-attempt counter
+// ===================================================================
+TEST_F(VaultServiceTest, QuickUnlockSuccessResetsAttempts) {
+    VaultService vault(vault_path_);
+    vault.create("password");
+    vault.arm_quick_unlock("1234", std::chrono::minutes(10), 2);
+
+    vault.quick_lock();
+    EXPECT_FALSE(vault.quick_unlock("0000"));
+    EXPECT_TRUE(vault.quick_unlock("1234"));
+
+    vault.quick_lock();
+    EXPECT_FALSE(vault.quick_unlock("0000"));
+    EXPECT_TRUE(vault.quick_unlock_available());
+    EXPECT_TRUE(vault.quick_unlock("1234"));
+}
+
+// ===================================================================
+// Test 22: Expired wrapped key is wiped; quick_lock falls back to lock
+// ===================================================================
+TEST_F(VaultServiceTest, QuickUnlockExpires) {
+    VaultService vault(vault_path_);
+    vault.create("password");
+    vault.arm_quick_unlock("1234", std::chrono::seconds(0));
+
+    EXPECT_FALSE(vault.quick_unlock_available());
+    vault.quick_lock();
+    EXPECT_EQ(VaultState::kLocked, vault.state());
+    EXPECT_FALSE(vault.quick_unlock("1234"));
+}
+
+// ===================================================================
+// Test 23: Full lock and password change destroy the wrapped key
+// ===================================================================
+TEST_F(VaultServiceTest, QuickUnlockDisarmedByLockAndPasswordChange) {
+    VaultService vault(vault_path_);
+    vault.create("password");
+
+    vault.arm_quick_unlock("1234", std::chrono::minutes(10));
+    vault.lock();
+    EXPECT_FALSE(vault.quick_unlock_available());
+    EXPECT_FALSE(vault.quick_unlock("1234"));
+
+    EXPECT_TRUE(vault.unlock("password"));
+    vault.arm_quick_unlock("1234", std::chrono::minutes(10));
+    EXPECT_TRUE(vault.change_password("password", "new_password"));
+    EXPECT_FALSE(vault.quick_unlock_available());
+}
+
+// ===================================================================
+// Test 24: Arming requires an unlocked vault and a long-enough PIN
+// ===================================================================
+TEST_F(VaultServiceTest, QuickUnlockArmValidation) {
+    VaultService vault(vault_path_);
+    vault.create("password");
+
+    EXPECT_THROW(vault.arm_quick_unlock("12", std::chrono::minutes(10)), std::invalid_argument);
+    EXPECT_THROW(vault.arm_quick_unlock("1234", std::chrono::minutes(10), 0), std::invalid_argument);
+
+    vault.lock();
+    EXPECT_THROW(vault.arm_quick_unlock("1234", std::chrono::minutes(10)), std::runtime_error);
+}
+
+// ===================================================================
+// Test 25: A vault keeps the file format it was created with
+// ===================================================================
+TEST_F(VaultServiceTest, FileFormatSurvivesOtherPresets) {
+    using bastionx::storage::ConnectionProfile;
+    auto throughput = ConnectionProfile::throughput();
+    {
+        VaultService vault(vault_path_, throughput);
+        ASSERT_TRUE(vault.create("password"));
+        EXPECT_TRUE(vault.connection_profile().same_format(throughput));
+    }
+
+    // Opened with another preset: its connection settings, the vault's format
+    VaultService vault(vault_path_, ConnectionProfile::paranoid());
+    ASSERT_TRUE(vault.unlock("password"));
+    EXPECT_TRUE(vault.connection_profile().same_format(throughput));
+    EXPECT_TRUE(vault.connection_profile().secure_delete);
+
+    // Password changes rewrite the sidecar without losing it
+    ASSERT_TRUE(vault.change_password("password", "new_password"));
+    VaultService reopened(vault_path_);
+    ASSERT_TRUE(reopened.unlock("new_password"));
+    EXPECT_TRUE(reopened.connection_profile().same_format(throughput));
+
+    // Default vaults keep the 16-byte sidecar older builds wrote
+    std::string default_path = (fs::path(temp_dir_) / "default.db").string();
+    VaultService balanced(default_path);
+    ASSERT_TRUE(balanced.create("password"));
+    EXPECT_EQ(CryptoService::SALT_BYTES, fs::file_size(VaultService::salt_path(default_path)));
+}
+
+// ===================================================================
+// Test 26: Quick relock keeps the pool open, with its caches wiped
+// ===================================================================
+TEST_F(VaultServiceTest, QuickLockKeepsConnectionPool) {
+    VaultService vault(vault_path_);
+    ASSERT_TRUE(vault.create("password"));
+    bastionx::storage::Note note;
+    note.title = "Kept";
+    note.body = "Cached body";
+    auto& pool = vault.connection_pool();
+    auto id = pool.writer().create_note(note, vault.notes_subkey());
+    ASSERT_TRUE(pool.writer().read_note(id, vault.notes_subkey()).has_value());
+    EXPECT_EQ(1u, pool.writer().note_cache_stats().entries);
+
+    vault.arm_quick_unlock("1234", std::chrono::minutes(10));
+    vault.quick_lock();
+    EXPECT_THROW(vault.connection_pool(), std::runtime_error);
+    EXPECT_EQ(0u, pool.writer().note_cache_stats().entries);  // Nothing decrypted kept
+
+    // Unlocking again needs no new connections
+    ASSERT_TRUE(vault.quick_unlock("1234"));
+    EXPECT_EQ(&pool, &vault.connection_pool());
+    auto read = pool.writer().read_note(id, vault.notes_subkey());
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ("Cached body", read->body);
+
+    // Once the wrapped key goes, so does the pool; a password unlock opens a new one
+    vault.quick_lock();
+    vault.disarm_quick_unlock();
+    ASSERT_TRUE(vault.unlock("password"));
+    EXPECT_EQ(1u, vault.connection_pool().writer().list_notes(vault.notes_subkey()).size());
+}
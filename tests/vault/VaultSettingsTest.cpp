@@ -8,6 +8,14 @@ TEST(VaultSettingsTest, DefaultsAreCorrect) {
     EXPECT_EQ(s.auto_lock_minutes, 5);
     EXPECT_TRUE(s.clipboard_clear_enabled);
     EXPECT_EQ(s.clipboard_clear_seconds, 30);
+    EXPECT_FALSE(s.quick_unlock_enabled);
+    EXPECT_EQ(s.quick_unlock_minutes, 60);
+    EXPECT_TRUE(s.cold_pack_enabled);
+    EXPECT_EQ(s.cold_pack_days, 90);
+    EXPECT_EQ(s.revision_keep_days, 30);
+    EXPECT_TRUE(s.backup_enabled);
+    EXPECT_EQ(s.backup_interval_hours, 24);
+    EXPECT_EQ(s.backup_keep, 5);
 }
 
 TEST(VaultSettingsTest, RoundTrip) {
@@ -15,6 +23,14 @@ TEST(VaultSettingsTest, RoundTrip) {
     original.auto_lock_minutes = 10;
     original.clipboard_clear_enabled = false;
     original.clipboard_clear_seconds = 60;
+    original.quick_unlock_enabled = true;
+    original.quick_unlock_minutes = 120;
+    original.cold_pack_enabled = false;
+    original.cold_pack_days = 365;
+    original.revision_keep_days = 7;
+    original.backup_enabled = false;
+    original.backup_interval_hours = 6;
+    original.backup_keep = 10;
 
     std::string json = original.to_json();
     VaultSettings restored = VaultSettings::from_json(json);
@@ -45,6 +61,27 @@ TEST(VaultSettingsTest, ClampsOutOfRangeValues) {
     // clipboard_clear_seconds above max
     s = VaultSettings::from_json(R"({"clipboard_clear_seconds":500})");
     EXPECT_EQ(s.clipboard_clear_seconds, 120);
+
+    // quick_unlock_minutes outside 5-480
+    s = VaultSettings::from_json(R"({"quick_unlock_minutes":1})");
+    EXPECT_EQ(s.quick_unlock_minutes, 5);
+    s = VaultSettings::from_json(R"({"quick_unlock_minutes":10000})");
+    EXPECT_EQ(s.quick_unlock_minutes, 480);
+
+    // cold_pack_days outside 30-3650
+    s = VaultSettings::from_json(R"({"cold_pack_days":1})");
+    EXPECT_EQ(s.cold_pack_days, 30);
+    s = VaultSettings::from_json(R"({"cold_pack_days":99999})");
+    EXPECT_EQ(s.cold_pack_days, 3650);
+
+    // revision_keep_days outside 1-3650
+    s = VaultSettings::from_json(R"({"revision_keep_days":0})");
+    EXPECT_EQ(s.revision_keep_days, 1);
+
+    // backup_interval_hours outside 1-168, backup_keep outside 1-50
+    s = VaultSettings::from_json(R"({"backup_interval_hours":0,"backup_keep":500})");
+    EXPECT_EQ(s.backup_interval_hours, 1);
+    EXPECT_EQ(s.backup_keep, 50);
 }
 
 TEST(VaultSettingsTest, InvalidJsonReturnsDefaults) {